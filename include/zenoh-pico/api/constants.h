@@ -174,8 +174,25 @@ typedef enum { Z_RELIABILITY_BEST_EFFORT = 1, Z_RELIABILITY_RELIABLE = 0 } z_rel
  *     Z_REPLY_TAG_DATA: Tag identifying that the reply contains some data.
  *     Z_REPLY_TAG_FINAL: Tag identifying that the reply does not contain any data and that there will be no more
  *         replies for this query.
+ *     Z_REPLY_TAG_ERROR: Tag identifying that the reply contains an error, e.g. the query timed out.
  */
-typedef enum { Z_REPLY_TAG_DATA = 0, Z_REPLY_TAG_FINAL = 1 } z_reply_tag_t;
+typedef enum { Z_REPLY_TAG_DATA = 0, Z_REPLY_TAG_FINAL = 1, Z_REPLY_TAG_ERROR = 2 } z_reply_tag_t;
+
+/**
+ * Sample ring policy values, applied when a sample is received while the ring is full.
+ *
+ * Enumerators:
+ *     Z_SAMPLE_RING_POLICY_DROP_OLDEST: The oldest sample in the ring is dropped to make room for the received one.
+ *     Z_SAMPLE_RING_POLICY_DROP_NEWEST: The received sample is dropped.
+ *     Z_SAMPLE_RING_POLICY_BLOCK: The network task waits until the application makes room. In single-thread builds
+ *         the received sample is dropped, as the application cannot receive while the network is being read.
+ */
+typedef enum {
+    Z_SAMPLE_RING_POLICY_DROP_OLDEST = 0,
+    Z_SAMPLE_RING_POLICY_DROP_NEWEST = 1,
+    Z_SAMPLE_RING_POLICY_BLOCK = 2
+} z_sample_ring_policy_t;
+#define Z_SAMPLE_RING_POLICY_DEFAULT Z_SAMPLE_RING_POLICY_DROP_OLDEST
 
 /**
  * Congestion control values.
@@ -0,0 +1,71 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef INCLUDE_ZENOH_PICO_API_HANDLERS_H
+#define INCLUDE_ZENOH_PICO_API_HANDLERS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/api/constants.h"
+#include "zenoh-pico/collections/atomic.h"
+#include "zenoh-pico/collections/element.h"
+#include "zenoh-pico/collections/ring.h"
+#include "zenoh-pico/net/memory.h"
+#include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/system/platform.h"
+
+/*------------------ Sample ring handler ------------------*/
+static inline size_t _z_sample_size(_z_sample_t *s) {
+    (void)(s);
+    return sizeof(_z_sample_t);
+}
+_Z_ELEM_DEFINE(_z_sample, _z_sample_t, _z_sample_size, _z_sample_clear, _z_sample_copy)
+_Z_RING_DEFINE(_z_sample, _z_sample_t)
+
+/**
+ * A bounded FIFO of samples between a subscriber callback, running on the network task, and the application.
+ *
+ * The samples go through a lock-free single-producer single-consumer ring. The mutex and the condition variable are
+ * only used to park a side that has to wait, the ``_rx_waiting`` and ``_tx_waiting`` flags tell the other side to
+ * wake it up. The handler is shared by the closure and the application, it is freed once both released it.
+ */
+typedef struct {
+    _z_sample_ring_t _ring;
+    z_sample_ring_policy_t _policy;
+    _z_atomic(unsigned int) _refs;
+    _z_atomic(_Bool) _closed;
+#if Z_FEATURE_MULTI_THREAD == 1
+    _z_atomic(_Bool) _rx_waiting;
+    _z_atomic(_Bool) _tx_waiting;
+    zp_mutex_t _mutex;
+    zp_condvar_t _cv;
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+} _z_sample_ring_handler_t;
+
+int8_t _z_sample_ring_handler_init(_z_sample_ring_handler_t *h, size_t capacity, z_sample_ring_policy_t policy);
+void _z_sample_ring_handler_clear(_z_sample_ring_handler_t *h);
+void _z_sample_ring_handler_close(_z_sample_ring_handler_t *h);
+
+// Reference counting, releasing a reference also closes the ring
+_z_sample_ring_handler_t *_z_sample_ring_handler_acquire(_z_sample_ring_handler_t *h);
+void _z_sample_ring_handler_release(_z_sample_ring_handler_t **h);
+
+// Producer side, the sample is copied into the ring
+void _z_sample_ring_handler_send(_z_sample_ring_handler_t *h, const _z_sample_t *sample);
+
+// Consumer side, ``*sample`` is NULL if the ring is empty and ``block`` is false
+int8_t _z_sample_ring_handler_recv(_z_sample_ring_handler_t *h, _z_sample_t **sample, _Bool block);
+
+#endif /* INCLUDE_ZENOH_PICO_API_HANDLERS_H */
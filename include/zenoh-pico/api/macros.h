@@ -23,6 +23,19 @@
 
 // clang-format off
 
+// The matching listeners only exist with the matching feature, their entries are left out of the generics otherwise
+#if Z_FEATURE_MATCHING == 1
+#define _Z_GENERIC_MATCHING_LISTENER_DROP z_owned_matching_listener_t * : z_matching_listener_drop,
+#define _Z_GENERIC_MATCHING_LISTENER_NULL z_owned_matching_listener_t * : z_matching_listener_null,
+#define _Z_GENERIC_MATCHING_LISTENER_CHECK z_owned_matching_listener_t : z_matching_listener_check,
+#define _Z_GENERIC_MATCHING_LISTENER_MOVE z_owned_matching_listener_t : z_matching_listener_move,
+#else
+#define _Z_GENERIC_MATCHING_LISTENER_DROP
+#define _Z_GENERIC_MATCHING_LISTENER_NULL
+#define _Z_GENERIC_MATCHING_LISTENER_CHECK
+#define _Z_GENERIC_MATCHING_LISTENER_MOVE
+#endif
+
 /**
  * Defines a generic function for loaning any of the ``z_owned_X_t`` types.
  *
@@ -43,7 +56,9 @@
                   z_owned_reply_t : z_reply_loan,                     \
                   z_owned_hello_t : z_hello_loan,                     \
                   z_owned_str_t : z_str_loan,                         \
-                  z_owned_str_array_t : z_str_array_loan              \
+                  z_owned_str_array_t : z_str_array_loan,             \
+                  z_owned_sample_t : z_sample_loan,                   \
+                  z_owned_payload_t : z_payload_loan                  \
             )(&x)
 /**
  * Defines a generic function for dropping any of the ``z_owned_X_t`` types.
@@ -59,16 +74,21 @@
                   z_owned_subscriber_t * : z_subscriber_drop,                       \
                   z_owned_pull_subscriber_t * : z_pull_subscriber_drop,             \
                   z_owned_publisher_t * : z_publisher_drop,                         \
+                  _Z_GENERIC_MATCHING_LISTENER_DROP                                 \
                   z_owned_queryable_t * : z_queryable_drop,                         \
                   z_owned_reply_t * : z_reply_drop,                                 \
                   z_owned_hello_t * : z_hello_drop,                                 \
                   z_owned_str_t * : z_str_drop,                                     \
                   z_owned_str_array_t * : z_str_array_drop,                         \
+                  z_owned_sample_t * : z_sample_drop,                               \
+                  z_owned_payload_t * : z_payload_drop,                             \
+                  z_owned_sample_ring_t * : z_sample_ring_drop,                     \
                   z_owned_closure_sample_t * : z_closure_sample_drop,               \
                   z_owned_closure_query_t * : z_closure_query_drop,                 \
                   z_owned_closure_reply_t * : z_closure_reply_drop,                 \
                   z_owned_closure_hello_t * : z_closure_hello_drop,                 \
-                  z_owned_closure_zid_t * : z_closure_zid_drop                      \
+                  z_owned_closure_zid_t * : z_closure_zid_drop,                     \
+                  z_owned_closure_matching_status_t * : z_closure_matching_status_drop \
             )(x)
 
 /**
@@ -80,6 +100,7 @@
 #define z_null(x) (*x = _Generic((x), \
                   z_owned_session_t * : z_session_null,                             \
                   z_owned_publisher_t * : z_publisher_null,                         \
+                  _Z_GENERIC_MATCHING_LISTENER_NULL                                 \
                   z_owned_keyexpr_t * : z_keyexpr_null,                             \
                   z_owned_config_t * : z_config_null,                               \
                   z_owned_scouting_config_t * : z_scouting_config_null,             \
@@ -89,11 +110,15 @@
                   z_owned_reply_t * : z_reply_null,                                 \
                   z_owned_hello_t * : z_hello_null,                                 \
                   z_owned_str_t * : z_str_null,                                     \
+                  z_owned_sample_t * : z_sample_null,                               \
+                  z_owned_payload_t * : z_payload_null,                             \
+                  z_owned_sample_ring_t * : z_sample_ring_null,                     \
                   z_owned_closure_sample_t * : z_closure_sample_null,               \
                   z_owned_closure_query_t * : z_closure_query_null,                 \
                   z_owned_closure_reply_t * : z_closure_reply_null,                 \
                   z_owned_closure_hello_t * : z_closure_hello_null,                 \
-                  z_owned_closure_zid_t * : z_closure_zid_null                      \
+                  z_owned_closure_zid_t * : z_closure_zid_null,                     \
+                  z_owned_closure_matching_status_t * : z_closure_matching_status_null \
             )())
 /**
  * Defines a generic function for checking the validity of any of the ``z_owned_X_t`` types.
@@ -115,11 +140,15 @@
                   z_owned_subscriber_t : z_subscriber_check,           \
                   z_owned_pull_subscriber_t : z_pull_subscriber_check, \
                   z_owned_publisher_t : z_publisher_check,             \
+                  _Z_GENERIC_MATCHING_LISTENER_CHECK                   \
                   z_owned_queryable_t : z_queryable_check,             \
                   z_owned_reply_t : z_reply_check,                     \
                   z_owned_hello_t : z_hello_check,                     \
                   z_owned_str_t : z_str_check,                         \
                   z_owned_str_array_t : z_str_array_check,             \
+                  z_owned_sample_t : z_sample_check,                   \
+                  z_owned_payload_t : z_payload_check,                 \
+                  z_owned_sample_ring_t : z_sample_ring_check,         \
                   z_bytes_t : z_bytes_check                            \
             )(&x)
 
@@ -134,7 +163,8 @@
                   z_owned_closure_query_t : z_closure_query_call,   \
                   z_owned_closure_reply_t : z_closure_reply_call,   \
                   z_owned_closure_hello_t : z_closure_hello_call,   \
-                  z_owned_closure_zid_t : z_closure_zid_call        \
+                  z_owned_closure_zid_t : z_closure_zid_call,       \
+                  z_owned_closure_matching_status_t : z_closure_matching_status_call \
             ) (&x, __VA_ARGS__)
 
 /**
@@ -154,16 +184,21 @@
                   z_owned_subscriber_t : z_subscriber_move,           \
                   z_owned_pull_subscriber_t : z_pull_subscriber_move, \
                   z_owned_publisher_t : z_publisher_move,             \
+                  _Z_GENERIC_MATCHING_LISTENER_MOVE                   \
                   z_owned_queryable_t : z_queryable_move,             \
                   z_owned_reply_t : z_reply_move,                     \
                   z_owned_hello_t : z_hello_move,                     \
                   z_owned_str_t : z_str_move,                         \
                   z_owned_str_array_t : z_str_array_move,             \
+                  z_owned_sample_t : z_sample_move,                   \
+                  z_owned_payload_t : z_payload_move,                 \
+                  z_owned_sample_ring_t : z_sample_ring_move,         \
                   z_owned_closure_sample_t : z_closure_sample_move,   \
                   z_owned_closure_query_t : z_closure_query_move,     \
                   z_owned_closure_reply_t : z_closure_reply_move,     \
                   z_owned_closure_hello_t : z_closure_hello_move,     \
-                  z_owned_closure_zid_t  : z_closure_zid_move         \
+                  z_owned_closure_zid_t  : z_closure_zid_move,        \
+                  z_owned_closure_matching_status_t : z_closure_matching_status_move \
             )(&x)
 
 /**
@@ -186,7 +221,9 @@
                   z_owned_reply_t : z_reply_clone,                     \
                   z_owned_hello_t : z_hello_clone,                     \
                   z_owned_str_t : z_str_clone,                         \
-                  z_owned_str_array_t : z_str_array_clone              \
+                  z_owned_str_array_t : z_str_array_clone,             \
+                  z_owned_sample_t : z_sample_clone,                   \
+                  z_owned_payload_t : z_payload_clone                  \
             )(&x)
 
 /**
@@ -198,6 +235,7 @@
 #define z_null(x) (*x = _Generic((x), \
                   z_owned_session_t * : z_session_null,                             \
                   z_owned_publisher_t * : z_publisher_null,                         \
+                  _Z_GENERIC_MATCHING_LISTENER_NULL                                 \
                   z_owned_keyexpr_t * : z_keyexpr_null,                             \
                   z_owned_config_t * : z_config_null,                               \
                   z_owned_scouting_config_t * : z_scouting_config_null,             \
@@ -207,11 +245,15 @@
                   z_owned_reply_t * : z_reply_null,                                 \
                   z_owned_hello_t * : z_hello_null,                                 \
                   z_owned_str_t * : z_str_null,                                     \
+                  z_owned_sample_t * : z_sample_null,                               \
+                  z_owned_payload_t * : z_payload_null,                             \
+                  z_owned_sample_ring_t * : z_sample_ring_null,                     \
                   z_owned_closure_sample_t * : z_closure_sample_null,               \
                   z_owned_closure_query_t * : z_closure_query_null,                 \
                   z_owned_closure_reply_t * : z_closure_reply_null,                 \
                   z_owned_closure_hello_t * : z_closure_hello_null,                 \
-                  z_owned_closure_zid_t * : z_closure_zid_null                      \
+                  z_owned_closure_zid_t * : z_closure_zid_null,                     \
+                  z_owned_closure_matching_status_t * : z_closure_matching_status_null \
             )())
 
 // clang-format on
@@ -245,6 +287,8 @@ template<> struct zenoh_loan_type<z_owned_publisher_t>{ typedef z_publisher_t ty
 template<> struct zenoh_loan_type<z_owned_pull_subscriber_t>{ typedef z_pull_subscriber_t type; };
 template<> struct zenoh_loan_type<z_owned_hello_t>{ typedef z_hello_t type; };
 template<> struct zenoh_loan_type<z_owned_str_t>{  typedef const char* type; };
+template<> struct zenoh_loan_type<z_owned_sample_t>{ typedef z_sample_t type; };
+template<> struct zenoh_loan_type<z_owned_payload_t>{ typedef z_bytes_t type; };
 
 template<> inline z_session_t z_loan(const z_owned_session_t& x) { return z_session_loan(&x); }
 template<> inline z_keyexpr_t z_loan(const z_owned_keyexpr_t& x) { return z_keyexpr_loan(&x); }
@@ -253,6 +297,8 @@ template<> inline z_publisher_t z_loan(const z_owned_publisher_t& x) { return z_
 template<> inline z_pull_subscriber_t z_loan(const z_owned_pull_subscriber_t& x) { return z_pull_subscriber_loan(&x); }
 template<> inline z_hello_t z_loan(const z_owned_hello_t& x) { return z_hello_loan(&x); }
 template<> inline const char* z_loan(const z_owned_str_t& x) { return z_str_loan(&x); }
+template<> inline z_sample_t z_loan(const z_owned_sample_t& x) { return z_sample_loan(&x); }
+template<> inline z_bytes_t z_loan(const z_owned_payload_t& x) { return z_payload_loan(&x); }
 
 template<class T> struct zenoh_drop_type { typedef T type; };
 template<class T> inline typename zenoh_drop_type<T>::type z_drop(T*);
@@ -268,11 +314,18 @@ template<> struct zenoh_drop_type<z_owned_queryable_t> { typedef int8_t type; };
 template<> struct zenoh_drop_type<z_owned_reply_t> { typedef void type; };
 template<> struct zenoh_drop_type<z_owned_hello_t> { typedef void type; };
 template<> struct zenoh_drop_type<z_owned_str_t> { typedef void type; };
+template<> struct zenoh_drop_type<z_owned_sample_t> { typedef void type; };
+template<> struct zenoh_drop_type<z_owned_payload_t> { typedef void type; };
+template<> struct zenoh_drop_type<z_owned_sample_ring_t> { typedef void type; };
 template<> struct zenoh_drop_type<z_owned_closure_sample_t> { typedef void type; };
 template<> struct zenoh_drop_type<z_owned_closure_query_t> { typedef void type; };
 template<> struct zenoh_drop_type<z_owned_closure_reply_t> { typedef void type; };
 template<> struct zenoh_drop_type<z_owned_closure_hello_t> { typedef void type; };
 template<> struct zenoh_drop_type<z_owned_closure_zid_t> { typedef void type; };
+#if Z_FEATURE_MATCHING == 1
+template<> struct zenoh_drop_type<z_owned_matching_listener_t> { typedef void type; };
+#endif
+template<> struct zenoh_drop_type<z_owned_closure_matching_status_t> { typedef void type; };
 
 template<> inline int8_t z_drop(z_owned_session_t* v) { return z_close(v); }
 template<> inline int8_t z_drop(z_owned_publisher_t* v) { return z_undeclare_publisher(v); }
@@ -285,11 +338,18 @@ template<> inline int8_t z_drop(z_owned_queryable_t* v) { return z_undeclare_que
 template<> inline void z_drop(z_owned_reply_t* v) { z_reply_drop(v); }
 template<> inline void z_drop(z_owned_hello_t* v) { z_hello_drop(v); }
 template<> inline void z_drop(z_owned_str_t* v) { z_str_drop(v); }
+template<> inline void z_drop(z_owned_sample_t* v) { z_sample_drop(v); }
+template<> inline void z_drop(z_owned_payload_t* v) { z_payload_drop(v); }
+template<> inline void z_drop(z_owned_sample_ring_t* v) { z_sample_ring_drop(v); }
 template<> inline void z_drop(z_owned_closure_sample_t* v) { z_closure_sample_drop(v); }
 template<> inline void z_drop(z_owned_closure_query_t* v) { z_closure_query_drop(v); }
 template<> inline void z_drop(z_owned_closure_reply_t* v) { z_closure_reply_drop(v); }
 template<> inline void z_drop(z_owned_closure_hello_t* v) { z_closure_hello_drop(v); }
 template<> inline void z_drop(z_owned_closure_zid_t* v) { z_closure_zid_drop(v); }
+#if Z_FEATURE_MATCHING == 1
+template<> inline void z_drop(z_owned_matching_listener_t* v) { z_matching_listener_drop(v); }
+#endif
+template<> inline void z_drop(z_owned_closure_matching_status_t* v) { z_closure_matching_status_drop(v); }
 
 inline void z_null(z_owned_session_t& v) { v = z_session_null(); }
 inline void z_null(z_owned_publisher_t& v) { v = z_publisher_null(); }
@@ -302,11 +362,18 @@ inline void z_null(z_owned_queryable_t& v) { v = z_queryable_null(); }
 inline void z_null(z_owned_reply_t& v) { v = z_reply_null(); }
 inline void z_null(z_owned_hello_t& v) { v = z_hello_null(); }
 inline void z_null(z_owned_str_t& v) { v = z_str_null(); }
+inline void z_null(z_owned_sample_t& v) { v = z_sample_null(); }
+inline void z_null(z_owned_payload_t& v) { v = z_payload_null(); }
+inline void z_null(z_owned_sample_ring_t& v) { v = z_sample_ring_null(); }
 inline void z_null(z_owned_closure_sample_t& v) { v = z_closure_sample_null(); }
 inline void z_null(z_owned_closure_query_t& v) { v = z_closure_query_null(); }
 inline void z_null(z_owned_closure_reply_t& v) { v = z_closure_reply_null(); }
 inline void z_null(z_owned_closure_hello_t& v) { v = z_closure_hello_null(); }
 inline void z_null(z_owned_closure_zid_t& v) { v = z_closure_zid_null(); }
+#if Z_FEATURE_MATCHING == 1
+inline void z_null(z_owned_matching_listener_t& v) { v = z_matching_listener_null(); }
+#endif
+inline void z_null(z_owned_closure_matching_status_t& v) { v = z_closure_matching_status_null(); }
 
 inline bool z_check(const z_owned_session_t& v) { return z_session_check(&v); }
 inline bool z_check(const z_owned_publisher_t& v) { return z_publisher_check(&v); }
@@ -321,6 +388,12 @@ inline bool z_check(const z_owned_queryable_t& v) { return z_queryable_check(&v)
 inline bool z_check(const z_owned_reply_t& v) { return z_reply_check(&v); }
 inline bool z_check(const z_owned_hello_t& v) { return z_hello_check(&v); }
 inline bool z_check(const z_owned_str_t& v) { return z_str_check(&v); }
+inline bool z_check(const z_owned_sample_t& v) { return z_sample_check(&v); }
+inline bool z_check(const z_owned_payload_t& v) { return z_payload_check(&v); }
+inline bool z_check(const z_owned_sample_ring_t& v) { return z_sample_ring_check(&v); }
+#if Z_FEATURE_MATCHING == 1
+inline bool z_check(const z_owned_matching_listener_t& v) { return z_matching_listener_check(&v); }
+#endif
 
 inline void z_call(const z_owned_closure_sample_t &closure, const z_sample_t *sample) 
     { z_closure_sample_call(&closure, sample); }
@@ -332,6 +405,8 @@ inline void z_call(const z_owned_closure_hello_t &closure, z_owned_hello_t *hell
     { z_closure_hello_call(&closure, hello); }
 inline void z_call(const z_owned_closure_zid_t &closure, const z_id_t *zid)
     { z_closure_zid_call(&closure, zid); }
+inline void z_call(const z_owned_closure_matching_status_t &closure, const z_matching_status_t *status)
+    { z_closure_matching_status_call(&closure, status); }
 // clang-format on
 
 #define _z_closure_overloader(callback, dropper, ctx, ...) \
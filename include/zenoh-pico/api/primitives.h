@@ -670,6 +670,30 @@ z_owned_closure_hello_t z_closure_hello(z_owned_hello_handler_t call, _z_dropper
  */
 z_owned_closure_zid_t z_closure_zid(z_id_handler_t call, _z_dropper_handler_t drop, void *context);
 
+/**
+ * Return a new matching status closure.
+ * It consists on a structure that contains all the elements for stateful, memory-leak-free callbacks.
+ *
+ * Like all ``z_owned_X_t``, an instance will be destroyed by any function which takes a mutable pointer to said
+ * instance, as this implies the instance's inners were moved. To make this fact more obvious when reading your code,
+ * consider using ``z_move(val)`` instead of ``&val`` as the argument. After a ``z_move``, ``val`` will still exist, but
+ * will no longer be valid. The destructors are double-drop-safe, but other functions will still trust that your ``val``
+ * is valid.
+ *
+ * To check if ``val`` is still valid, you may use ``z_closure_matching_status_check(&val)`` or ``z_check(val)`` if your
+ * compiler supports ``_Generic``, which will return ``true`` if ``val`` is valid, or ``false`` otherwise.
+ *
+ * Parameters:
+ *   call: the typical callback function. ``context`` will be passed as its last argument.
+ *   drop: allows the callback's state to be freed. ``context`` will be passed as its last argument.
+ *   context: a pointer to an arbitrary state.
+ *
+ * Returns:
+ *   Returns a new matching status closure.
+ */
+z_owned_closure_matching_status_t z_closure_matching_status(_z_matching_status_handler_t call,
+                                                            _z_dropper_handler_t drop, void *context);
+
 /**************** Loans ****************/
 #define _OWNED_FUNCTIONS(type, ownedtype, name)    \
     _Bool z_##name##_check(const ownedtype *name); \
@@ -687,10 +711,15 @@ _OWNED_FUNCTIONS(z_session_t, z_owned_session_t, session)
 _OWNED_FUNCTIONS(z_subscriber_t, z_owned_subscriber_t, subscriber)
 _OWNED_FUNCTIONS(z_pull_subscriber_t, z_owned_pull_subscriber_t, pull_subscriber)
 _OWNED_FUNCTIONS(z_publisher_t, z_owned_publisher_t, publisher)
+#if Z_FEATURE_MATCHING == 1
+_OWNED_FUNCTIONS(z_matching_listener_t, z_owned_matching_listener_t, matching_listener)
+#endif
 _OWNED_FUNCTIONS(z_queryable_t, z_owned_queryable_t, queryable)
 _OWNED_FUNCTIONS(z_hello_t, z_owned_hello_t, hello)
 _OWNED_FUNCTIONS(z_reply_t, z_owned_reply_t, reply)
 _OWNED_FUNCTIONS(z_str_array_t, z_owned_str_array_t, str_array)
+_OWNED_FUNCTIONS(z_sample_t, z_owned_sample_t, sample)
+_OWNED_FUNCTIONS(z_bytes_t, z_owned_payload_t, payload)
 
 #define _OWNED_FUNCTIONS_CLOSURE(ownedtype, name) \
     _Bool z_##name##_check(const ownedtype *val); \
@@ -703,6 +732,85 @@ _OWNED_FUNCTIONS_CLOSURE(z_owned_closure_query_t, closure_query)
 _OWNED_FUNCTIONS_CLOSURE(z_owned_closure_reply_t, closure_reply)
 _OWNED_FUNCTIONS_CLOSURE(z_owned_closure_hello_t, closure_hello)
 _OWNED_FUNCTIONS_CLOSURE(z_owned_closure_zid_t, closure_zid)
+_OWNED_FUNCTIONS_CLOSURE(z_owned_closure_matching_status_t, closure_matching_status)
+
+/************* Sample ring **************/
+/**
+ * Builds a :c:type:`z_sample_ring_options_t` with default values.
+ *
+ * Returns:
+ *   Returns a new sample ring options object.
+ */
+z_sample_ring_options_t z_sample_ring_options_default(void);
+
+/**
+ * Creates a new sample ring and the sample closure feeding it.
+ *
+ * The closure is meant to be moved into :c:func:`z_declare_subscriber` or :c:func:`z_declare_pull_subscriber`. The
+ * ring stays valid after the subscriber is undeclared, until the samples left in it are received.
+ *
+ * Parameters:
+ *   callback: An uninitialized :c:type:`z_owned_closure_sample_t` that will be set to the closure feeding the ring.
+ *   ring: An uninitialized :c:type:`z_owned_sample_ring_t` that will be set to the new ring.
+ *   options: The options to apply to the ring. If ``NULL``, the default options are applied.
+ *
+ * Returns:
+ *   Returns ``0`` if the ring is created, or a ``negative value`` otherwise.
+ */
+int8_t z_sample_ring_new(z_owned_closure_sample_t *callback, z_owned_sample_ring_t *ring,
+                         const z_sample_ring_options_t *options);
+
+/**
+ * Receives the oldest sample of a ring, waiting for one if the ring is empty.
+ *
+ * In single-thread builds the samples are only received by ``zp_read``, so this function does not wait and behaves as
+ * :c:func:`z_sample_ring_try_recv`.
+ *
+ * Parameters:
+ *   ring: Pointer to a :c:type:`z_owned_sample_ring_t` to receive from.
+ *   sample: An uninitialized :c:type:`z_owned_sample_t` that will be set to the received sample.
+ *
+ * Returns:
+ *   Returns ``0`` if a sample is received, or a ``negative value`` if the ring is closed, i.e. its closure has been
+ *   dropped, and empty.
+ */
+int8_t z_sample_ring_recv(const z_owned_sample_ring_t *ring, z_owned_sample_t *sample);
+
+/**
+ * Receives the oldest sample of a ring, without waiting.
+ *
+ * Parameters:
+ *   ring: Pointer to a :c:type:`z_owned_sample_ring_t` to receive from.
+ *   sample: An uninitialized :c:type:`z_owned_sample_t` that will be set to the received sample, or to a null sample
+ *     if the ring is empty.
+ *
+ * Returns:
+ *   Returns ``0`` if the ring is open or still holds samples, or a ``negative value`` if the ring is closed and empty.
+ */
+int8_t z_sample_ring_try_recv(const z_owned_sample_ring_t *ring, z_owned_sample_t *sample);
+
+_Bool z_sample_ring_check(const z_owned_sample_ring_t *ring);
+z_owned_sample_ring_t *z_sample_ring_move(z_owned_sample_ring_t *ring);
+void z_sample_ring_drop(z_owned_sample_ring_t *ring);
+z_owned_sample_ring_t z_sample_ring_null(void);
+
+/************* Payload **************/
+/**
+ * Takes an owned reference to the payload of a sample, that stays valid once the sample callback returned.
+ *
+ * A payload of at least ``Z_RX_POOL_RETAIN_MIN_SIZE`` bytes is not copied if it was received in a single batch: the
+ * reference keeps the RX buffer of the batch from being reused until it is dropped, and the transport meanwhile reads
+ * into another buffer of its pool. Smaller payloads, as well as the payloads of fragmented messages and of local
+ * publications, are copied.
+ *
+ * Parameters:
+ *   sample: Pointer to the :c:type:`z_sample_t` the sample callback is called with.
+ *   payload: An uninitialized :c:type:`z_owned_payload_t` that will be set to the payload.
+ *
+ * Returns:
+ *   Returns ``0`` if the payload is retained, or a ``negative value`` otherwise.
+ */
+int8_t z_sample_payload_retain(const z_sample_t *sample, z_owned_payload_t *payload);
 
 /************* Primitives **************/
 /**
@@ -934,6 +1042,58 @@ int8_t z_publisher_put(const z_publisher_t pub, const uint8_t *payload, size_t l
  *   Returns ``0`` if the delete operation is successful, or a ``negative value`` otherwise.
  */
 int8_t z_publisher_delete(const z_publisher_t pub, const z_publisher_delete_options_t *options);
+
+#if Z_FEATURE_MATCHING == 1
+/**
+ * Gets the matching status of a publisher, i.e. whether remote subscribers matching its keyexpr are known.
+ *
+ * Publications are only sent on the network while the publisher is matching, the local subscriptions
+ * are triggered regardless.
+ *
+ * Parameters:
+ *   pub: A loaned instance of :c:type:`z_publisher_t` to get the matching status of.
+ *   status: The :c:type:`z_matching_status_t` to fill with the matching status of the publisher.
+ *
+ * Returns:
+ *   Returns ``0`` if the operation is successful, or a ``negative value`` otherwise.
+ */
+int8_t z_publisher_get_matching_status(const z_publisher_t pub, z_matching_status_t *status);
+
+/**
+ * Declares a matching listener for the given publisher, notified each time its matching status changes.
+ * The callback is called right away if remote subscribers matching the publisher are already known.
+ *
+ * Like all ``z_owned_X_t``, an instance will be destroyed by any function which takes a mutable pointer to said
+ * instance, as this implies the instance's inners were moved. To make this fact more obvious when reading your code,
+ * consider using ``z_move(val)`` instead of ``&val`` as the argument. After a ``z_move``, ``val`` will still exist, but
+ * will no longer be valid. The destructors are double-drop-safe, but other functions will still trust that your ``val``
+ * is valid.
+ *
+ * To check if ``val`` is still valid, you may use ``z_matching_listener_check(&val)`` or ``z_check(val)`` if your
+ * compiler supports ``_Generic``, which will return ``true`` if ``val`` is valid, or ``false`` otherwise.
+ *
+ * Parameters:
+ *   pub: A loaned instance of :c:type:`z_publisher_t` to listen the matching status of.
+ *   callback: A moved instance of :c:type:`z_owned_closure_matching_status_t` for the matching status changes.
+ *
+ * Returns:
+ *   A :c:type:`z_owned_matching_listener_t` with either a valid matching listener or a failing matching listener.
+ *   Should the matching listener be invalid, ``z_check(val)`` ing the returned value will return ``false``.
+ */
+z_owned_matching_listener_t z_publisher_declare_matching_listener(z_publisher_t pub,
+                                                                  z_owned_closure_matching_status_t *callback);
+
+/**
+ * Undeclare the matching listener generated by a call to :c:func:`z_publisher_declare_matching_listener`.
+ *
+ * Parameters:
+ *   listener: A moved instance of :c:type:`z_owned_matching_listener_t` to undeclare.
+ *
+ * Returns:
+ *   Returns ``0`` if the undeclare matching listener operation is successful, or a ``negative value`` otherwise.
+ */
+int8_t z_undeclare_matching_listener(z_owned_matching_listener_t *listener);
+#endif
 #endif
 
 #if Z_FEATURE_QUERY == 1
@@ -1096,6 +1256,10 @@ z_owned_keyexpr_t z_keyexpr_new(const char *name);
  * This numerical id is used on the network to save bandwidth and ease the retrieval of the concerned resource
  * in the routing tables.
  *
+ * Over multicast transports, the declaration is repeated along with the ``Join`` messages, so that peers joining
+ * later also learn the numerical id. The messages keep the full key expression until the declaration has been
+ * repeated since the last peer joined.
+ *
  * Like most ``z_owned_X_t`` types, you may obtain an instance of :c:type:`z_owned_keyexpr_t` by loaning it using
  * ``z_keyexpr_loan(&val)``. The ``z_loan(val)`` macro, available if your compiler supports C11's ``_Generic``, is
  * equivalent to writing ``z_keyexpr_loan(&val)``.
@@ -1341,6 +1505,46 @@ int8_t zp_start_lease_task(z_session_t zs, const zp_task_lease_options_t *option
  */
 int8_t zp_stop_lease_task(z_session_t zs);
 
+/**
+ * Constructs the default values for the session TX task.
+ *
+ * Returns:
+ *   Returns the constructed :c:type:`zp_task_tx_options_t`.
+ */
+zp_task_tx_options_t zp_task_tx_options_default(void);
+
+/**
+ * Start a separate task to send the network messages.
+ *
+ * Publications and queries are then only encoded by the calling thread and pushed in a bounded queue, never waiting
+ * on the socket. The task drains the queue into batches. Once the queue holds ``Z_TX_QUEUE_HIGH_WATERMARK`` bytes,
+ * the messages are dropped or their publishers blocked, according to their congestion control, until the task drains
+ * the queue down to ``Z_TX_QUEUE_LOW_WATERMARK`` bytes.
+ * Note that the task can be implemented in form of thread, process, etc. and its implementation is platform-dependent.
+ *
+ * Parameters:
+ *   zs: A loaned instance of the the :c:type:`z_session_t` where to start the TX task.
+ *   options: The options to apply when starting the TX task. If ``NULL`` is passed, the default options will be
+ * applied.
+ *
+ * Returns:
+ *   Returns ``0`` if the TX task started successfully, or a ``negative value`` otherwise.
+ */
+int8_t zp_start_tx_task(z_session_t zs, const zp_task_tx_options_t *options);
+
+/**
+ * Stop the TX task, once it has sent the queued messages.
+ *
+ * This may result in stopping a thread or a process depending on the target platform.
+ *
+ * Parameters:
+ *   zs: A loaned instance of the the :c:type:`z_session_t` where to stop the TX task.
+ *
+ * Returns:
+ *   Returns ``0`` if the TX task stopped successfully, or a ``negative value`` otherwise.
+ */
+int8_t zp_stop_tx_task(z_session_t zs);
+
 /************* Single Thread helpers **************/
 /**
  * Constructs the default values for the reading procedure.
@@ -1386,6 +1590,29 @@ zp_send_keep_alive_options_t zp_send_keep_alive_options_default(void);
  */
 int8_t zp_send_keep_alive(z_session_t zs, const zp_send_keep_alive_options_t *options);
 
+/**
+ * Constructs the default values for flushing the batched messages.
+ *
+ * Returns:
+ *   Returns the constructed :c:type:`zp_flush_options_t`.
+ */
+zp_flush_options_t zp_flush_options_default(void);
+
+/**
+ * Flushes the network messages batched on the session transport.
+ *
+ * When ``Z_FEATURE_BATCHING`` is enabled, network messages are appended to the current frame until it is full,
+ * it lingers for more than ``Z_BATCH_LINGER_TIME`` milliseconds, or this function is called.
+ *
+ * Parameters:
+ *   zs: A loaned instance of the the :c:type:`z_session_t` whose batched messages are flushed.
+ *   options: The options to apply to the flush. If ``NULL`` is passed, the default options will be applied.
+ *
+ * Returns:
+ *   Returns ``0`` if the batched messages were sent successfully, or a ``negative value`` otherwise.
+ */
+int8_t zp_flush(z_session_t zs, const zp_flush_options_t *options);
+
 /**
  * Constructs the default values for sending the join.
  *
@@ -1409,6 +1636,112 @@ zp_send_join_options_t zp_send_join_options_default(void);
  */
 int8_t zp_send_join(z_session_t zs, const zp_send_join_options_t *options);
 
+#if Z_FEATURE_MEMORY_POOL == 1
+/************* Memory pool **************/
+/**
+ * Gets the usage statistics of a size class of the memory pool.
+ *
+ * The blocks of the class ``cls`` are ``Z_MEMORY_POOL_BLOCK_SIZE << cls`` bytes, and there are
+ * ``Z_MEMORY_POOL_CLASSES`` classes. The allocations larger than the largest class, or made while all the blocks of
+ * their class are used, are served by the platform allocator. A steady state without new fallbacks is thus free of
+ * platform allocations, and the high watermarks help sizing ``Z_MEMORY_POOL_BLOCKS``.
+ *
+ * Parameters:
+ *   cls: The index of the size class.
+ *   stats: A pointer to the :c:type:`zp_memory_pool_stats_t` to fill.
+ *
+ * Returns:
+ *   Returns ``0`` if the statistics were retrieved successfully, or a ``negative value`` if the class does not exist.
+ */
+int8_t zp_memory_pool_stats(size_t cls, zp_memory_pool_stats_t *stats);
+#endif
+
+#if Z_FEATURE_STATS == 1
+/************* Statistics **************/
+/**
+ * Gets a snapshot of the statistics counters of a session, summed over its transports.
+ *
+ * The counters are updated with relaxed atomic operations as the messages are sent and received, so they are read
+ * one by one and may not be consistent with each other while the session is active. They are only reset when the
+ * session or the transport is created, the rates are obtained from the differences between two snapshots.
+ *
+ * Parameters:
+ *   zs: A loaned instance of the the :c:type:`z_session_t` to get the statistics of.
+ *   stats: A pointer to the :c:type:`zp_stats_t` to fill.
+ *
+ * Returns:
+ *   Returns ``0`` if the statistics were retrieved successfully.
+ */
+int8_t zp_stats_get(z_session_t zs, zp_stats_t *stats);
+#endif
+
+#if Z_FEATURE_REACTOR == 1
+/************* Reactor **************/
+/**
+ * Initializes a reactor.
+ *
+ * Parameters:
+ *   reactor: A pointer to the :c:type:`zp_reactor_t` to initialize.
+ *
+ * Returns:
+ *   Returns ``0`` if the reactor was initialized successfully, or a ``negative value`` otherwise.
+ */
+int8_t zp_reactor_init(zp_reactor_t *reactor);
+
+/**
+ * Frees a reactor. All its sessions must have been removed, and no thread may be running it.
+ *
+ * Parameters:
+ *   reactor: A pointer to the :c:type:`zp_reactor_t` to free.
+ */
+void zp_reactor_free(zp_reactor_t *reactor);
+
+/**
+ * Adds a session to a reactor, which then reads from it and keeps its lease alive.
+ *
+ * The session must not run read nor lease tasks, see :c:func:`zp_start_read_task` and
+ * :c:func:`zp_start_lease_task`. Only the sessions over TCP and UDP links can be added.
+ *
+ * Parameters:
+ *   reactor: A pointer to the :c:type:`zp_reactor_t` to add the session to.
+ *   zs: The :c:type:`z_session_t` to add.
+ *
+ * Returns:
+ *   Returns ``0`` if the session was added successfully, or a ``negative value`` otherwise.
+ */
+int8_t zp_reactor_add(zp_reactor_t *reactor, z_session_t zs);
+
+/**
+ * Removes a session from a reactor, waiting for the threads reading from it. It must be called before closing the
+ * session, and not from one of its callbacks. A session whose lease expired is no longer driven by the reactor, but it
+ * still has to be removed.
+ *
+ * Parameters:
+ *   reactor: A pointer to the :c:type:`zp_reactor_t` to remove the session from.
+ *   zs: The :c:type:`z_session_t` to remove.
+ *
+ * Returns:
+ *   Returns ``0`` if the session was removed successfully, or a ``negative value`` if it was not in the reactor.
+ */
+int8_t zp_reactor_remove(zp_reactor_t *reactor, z_session_t zs);
+
+/**
+ * Waits up to ``timeout_ms`` milliseconds for sessions to read from or to keep alive, and handles them.
+ *
+ * The callbacks of the sessions run in the calling thread. Several threads may run the same reactor, a session is
+ * read by one of them at a time. A waiting thread only considers the lease of the sessions added meanwhile once its
+ * wait returns.
+ *
+ * Parameters:
+ *   reactor: A pointer to the :c:type:`zp_reactor_t` to run.
+ *   timeout_ms: The longest time to wait for, in milliseconds.
+ *
+ * Returns:
+ *   Returns ``0`` if the reactor ran successfully, or a ``negative value`` otherwise.
+ */
+int8_t zp_reactor_run(zp_reactor_t *reactor, uint32_t timeout_ms);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
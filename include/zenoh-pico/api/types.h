@@ -15,11 +15,15 @@
 #ifndef INCLUDE_ZENOH_PICO_API_TYPES_H
 #define INCLUDE_ZENOH_PICO_API_TYPES_H
 
+#include "zenoh-pico/api/handlers.h"
 #include "zenoh-pico/net/publish.h"
 #include "zenoh-pico/net/query.h"
+#include "zenoh-pico/net/reactor.h"
 #include "zenoh-pico/net/session.h"
 #include "zenoh-pico/net/subscribe.h"
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/transport/common/rx_pool.h"
+#include "zenoh-pico/utils/pool.h"
 
 #ifdef __cplusplus
 extern "C" {
@@ -172,6 +176,19 @@ typedef struct {
 } z_publisher_t;
 _OWNED_TYPE_PTR(_z_publisher_t, publisher)
 
+/**
+ * Represents a Zenoh Matching Listener entity, notified when the remote subscribers matching a publisher come and go.
+ *
+ * Operations over :c:type:`z_matching_listener_t` must be done using the provided functions:
+ *
+ *   - :c:func:`z_publisher_declare_matching_listener`
+ *   - :c:func:`z_undeclare_matching_listener`
+ */
+typedef struct {
+    _z_matching_listener_t *_val;
+} z_matching_listener_t;
+_OWNED_TYPE_PTR(_z_matching_listener_t, matching_listener)
+
 /**
  * Represents a Zenoh Queryable entity.
  *
@@ -331,11 +348,13 @@ typedef struct {
  *   z_query_target_t target: The queryables that should be targeted by this get.
  *   z_query_consolidation_t consolidation: The replies consolidation strategy to apply on replies.
  *   z_value_t value: The payload to include in the query.
+ *   uint32_t timeout_ms: The time in milliseconds after which the query expires with an error reply, 0 means never.
  */
 typedef struct {
     z_value_t value;
     z_query_consolidation_t consolidation;
     z_query_target_t target;
+    uint32_t timeout_ms;
 } z_get_options_t;
 
 /**
@@ -362,6 +381,69 @@ typedef struct {
 #endif
 } zp_task_lease_options_t;
 
+/**
+ * Represents the set of options that can be applied to the TX task,
+ * whenever issued via :c:func:`zp_start_tx_task`.
+ */
+typedef struct {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_task_attr_t *task_attributes;
+#else
+    uint8_t __dummy;  // Just to avoid empty structures that might cause undefined behavior
+#endif
+} zp_task_tx_options_t;
+
+#if Z_FEATURE_MEMORY_POOL == 1
+/**
+ * Represents the usage statistics of a size class of the memory pool, as returned by :c:func:`zp_memory_pool_stats`.
+ *
+ * Members:
+ *   size_t block_size: The size of the blocks of the class.
+ *   size_t blocks: The number of blocks of the class.
+ *   size_t used: The number of blocks currently allocated.
+ *   size_t high_watermark: The highest number of blocks allocated at the same time.
+ *   size_t fallbacks: The number of allocations served by the platform allocator because no block was left.
+ */
+typedef _z_pool_stats_t zp_memory_pool_stats_t;
+#endif
+
+#if Z_FEATURE_STATS == 1
+/**
+ * Represents a snapshot of the statistics counters of a session and of its transports, as returned by
+ * :c:func:`zp_stats_get`. The counters wrap around on overflow.
+ *
+ * Members:
+ *   size_t tx_n_msgs: The number of network messages sent.
+ *   size_t tx_bytes: The number of bytes written to the links.
+ *   size_t tx_batches: The number of batches written to the links, including the fragments and keep alives.
+ *   size_t tx_fragments: The number of fragments written to the links.
+ *   size_t tx_keep_alives: The number of keep alives sent.
+ *   size_t tx_congestion_drops: The number of network messages dropped by the congestion control.
+ *   size_t rx_n_msgs: The number of network messages received.
+ *   size_t rx_bytes: The number of bytes read from the links.
+ *   size_t rx_batches: The number of batches read from the links, including the fragments and keep alives.
+ *   size_t rx_fragments: The number of fragments received.
+ *   size_t rx_keep_alives: The number of keep alives received.
+ *   size_t rx_out_of_order_drops: The number of frames dropped because their sequence number is out of order.
+ *   size_t rx_reassembly_drops: The number of fragmented messages dropped because they exceed Z_FRAG_MAX_SIZE.
+ *   size_t rx_declares: The number of declarations handled by the session.
+ *   size_t rx_pushes: The number of pushes handled by the session.
+ *   size_t rx_requests: The number of requests handled by the session.
+ *   size_t rx_responses: The number of responses handled by the session.
+ *   size_t rx_response_finals: The number of final responses handled by the session.
+ *   size_t rx_errors: The number of network messages the session failed to handle.
+ */
+typedef _z_stats_t zp_stats_t;
+#endif
+
+#if Z_FEATURE_REACTOR == 1
+/**
+ * Represents a reactor, that drives the reads and the leases of many sessions from the threads calling
+ * :c:func:`zp_reactor_run`, instead of a read and a lease task per session.
+ */
+typedef _z_reactor_t zp_reactor_t;
+#endif
+
 /**
  * Represents the set of options that can be applied to the read operation,
  * whenever issued via :c:func:`zp_read`.
@@ -378,6 +460,14 @@ typedef struct {
     uint8_t __dummy;  // Just to avoid empty structures that might cause undefined behavior
 } zp_send_keep_alive_options_t;
 
+/**
+ * Represents the set of options that can be applied to the flush of batched messages,
+ * whenever issued via :c:func:`zp_flush`.
+ */
+typedef struct {
+    uint8_t __dummy;  // Just to avoid empty structures that might cause undefined behavior
+} zp_flush_options_t;
+
 /**
  * Represents the set of options that can be applied to the join send,
  * whenever issued via :c:func:`zp_send_join`.
@@ -400,6 +490,14 @@ typedef struct {
  */
 typedef _z_sample_t z_sample_t;
 
+/**
+ * Represents the matching status of a publisher.
+ *
+ * Members:
+ *   _Bool matching: ``true`` if at least one remote subscriber matches the keyexpr of the publisher.
+ */
+typedef _z_matching_status_t z_matching_status_t;
+
 /**
  * Represents the content of a `hello` message returned by a zenoh entity as a reply to a `scout` message.
  *
@@ -465,6 +563,42 @@ typedef struct {
 
 void z_closure_sample_call(const z_owned_closure_sample_t *closure, const z_sample_t *sample);
 
+/**
+ * Represents an owned data sample, e.g. received from a :c:type:`z_owned_sample_ring_t`.
+ */
+_OWNED_TYPE_PTR(z_sample_t, sample)
+
+/**
+ * Represents an owned payload of a sample, taken with :c:func:`z_sample_payload_retain`.
+ *
+ * The payload stays valid once the sample callback returned, it can be kept or handed over to another thread. It is
+ * accessed as a :c:type:`z_bytes_t` with :c:func:`z_payload_loan`.
+ */
+_OWNED_TYPE_PTR(_z_rx_payload_t, payload)
+
+/**
+ * Represents a bounded FIFO of samples, decoupling the application processing from the network task.
+ *
+ * The ring is filled by the :c:type:`z_owned_closure_sample_t` returned by :c:func:`z_sample_ring_new`, which copies
+ * each sample it is called with. The application drains it with :c:func:`z_sample_ring_recv` or
+ * :c:func:`z_sample_ring_try_recv`. The ring is a lock-free single-producer single-consumer queue, so it must be
+ * drained by a single thread at a time.
+ */
+_OWNED_TYPE_PTR(_z_sample_ring_handler_t, sample_ring)
+
+/**
+ * Represents the set of options that can be applied to a sample ring, whenever created via
+ * :c:func:`z_sample_ring_new`.
+ *
+ * Members:
+ *   size_t capacity: The maximum number of samples held by the ring.
+ *   z_sample_ring_policy_t policy: What to do with a sample received while the ring is full.
+ */
+typedef struct {
+    size_t capacity;
+    z_sample_ring_policy_t policy;
+} z_sample_ring_options_t;
+
 /**
  * Represents the query callback closure.
  *
@@ -546,6 +680,26 @@ typedef struct {
 
 void z_closure_zid_call(const z_owned_closure_zid_t *closure, const z_id_t *id);
 
+/**
+ * Represents the matching status callback closure.
+ *
+ * A closure is a structure that contains all the elements for stateful, memory-leak-free callbacks.
+ *
+ * Members:
+ *   _z_matching_status_handler_t call: `void (*_z_matching_status_handler_t)(const z_matching_status_t *status, void
+ * *arg)` is the callback function.
+ *   _z_dropper_handler_t drop: `void *drop(void*)` allows the callback's state to be freed.
+ *   void *context: a pointer to an arbitrary state.
+ */
+typedef struct {
+    void *context;
+    _z_matching_status_handler_t call;
+    _z_dropper_handler_t drop;
+} z_owned_closure_matching_status_t;
+
+void z_closure_matching_status_call(const z_owned_closure_matching_status_t *closure,
+                                    const z_matching_status_t *status);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,80 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_COLLECTIONS_ATOMIC_H
+#define ZENOH_PICO_COLLECTIONS_ATOMIC_H
+
+#include <stdbool.h>
+#include <stddef.h>
+
+#if ZENOH_C_STANDARD != 99
+
+#ifndef __cplusplus
+#include <stdatomic.h>
+#define _z_atomic(X) _Atomic(X)
+#define _z_atomic_load_explicit atomic_load_explicit
+#define _z_atomic_store_explicit atomic_store_explicit
+#define _z_atomic_fetch_add_explicit atomic_fetch_add_explicit
+#define _z_atomic_fetch_sub_explicit atomic_fetch_sub_explicit
+#define _z_atomic_compare_exchange_strong_explicit atomic_compare_exchange_strong_explicit
+#define _z_atomic_thread_fence atomic_thread_fence
+#define _z_memory_order_acquire memory_order_acquire
+#define _z_memory_order_release memory_order_release
+#define _z_memory_order_acq_rel memory_order_acq_rel
+#define _z_memory_order_seq_cst memory_order_seq_cst
+#define _z_memory_order_relaxed memory_order_relaxed
+#else
+#include <atomic>
+#define _z_atomic(X) std::atomic<X>
+#define _z_atomic_load_explicit std::atomic_load_explicit
+#define _z_atomic_store_explicit std::atomic_store_explicit
+#define _z_atomic_fetch_add_explicit std::atomic_fetch_add_explicit
+#define _z_atomic_fetch_sub_explicit std::atomic_fetch_sub_explicit
+#define _z_atomic_compare_exchange_strong_explicit std::atomic_compare_exchange_strong_explicit
+#define _z_atomic_thread_fence std::atomic_thread_fence
+#define _z_memory_order_acquire std::memory_order_acquire
+#define _z_memory_order_release std::memory_order_release
+#define _z_memory_order_acq_rel std::memory_order_acq_rel
+#define _z_memory_order_seq_cst std::memory_order_seq_cst
+#define _z_memory_order_relaxed std::memory_order_relaxed
+#endif  // __cplusplus
+
+#else
+// C99 has no atomics, as for the shared pointers the operations are plain accesses to volatile values.
+// They are only safe to use from a single thread.
+#define _z_atomic(X) volatile X
+#define _z_atomic_load_explicit(p, o) (*(p))
+#define _z_atomic_store_explicit(p, v, o) (*(p) = (v))
+#define _z_atomic_fetch_add_explicit(p, v, o) ((*(p) += (v)) - (v))
+#define _z_atomic_fetch_sub_explicit(p, v, o) ((*(p) -= (v)) + (v))
+#define _z_atomic_compare_exchange_strong_explicit(p, e, d, s, f) __z_atomic_size_compare_exchange(p, e, d)
+#define _z_atomic_thread_fence(o) ((void)(o))
+#define _z_memory_order_acquire 0
+#define _z_memory_order_release 0
+#define _z_memory_order_acq_rel 0
+#define _z_memory_order_seq_cst 0
+#define _z_memory_order_relaxed 0
+
+static inline _Bool __z_atomic_size_compare_exchange(volatile size_t *p, size_t *expected, size_t desired) {
+    _Bool ret = (*p == *expected);
+    if (ret == true) {
+        *p = desired;
+    } else {
+        *expected = *p;
+    }
+    return ret;
+}
+#endif  // ZENOH_C_STANDARD != 99
+
+#endif /* ZENOH_PICO_COLLECTIONS_ATOMIC_H */
@@ -0,0 +1,76 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_COLLECTIONS_MPSC_H
+#define ZENOH_PICO_COLLECTIONS_MPSC_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/collections/atomic.h"
+#include "zenoh-pico/collections/element.h"
+
+/*-------- Multi-producer single-consumer queue --------*/
+/**
+ * A bounded lock-free FIFO, safe to use concurrently by any number of producer threads and one consumer thread.
+ *
+ * Each slot carries a sequence number telling whether it is free for the producer of a given index or ready for the
+ * consumer. Producers reserve an index with a compare-and-swap on the write index, then publish the element by
+ * updating the slot sequence number, so a slow producer never blocks the others.
+ *
+ *  Members:
+ *   _z_mpsc_slot_t *_slots: The slots, their number is the capacity rounded up to a power of two.
+ *   size_t _mask: The number of slots minus one, the indexes keep increasing and are masked on access.
+ *   _z_atomic(size_t) _r_idx: The index of the next element to be pulled, only written by the consumer.
+ *   _z_atomic(size_t) _w_idx: The index of the next slot to be reserved by a producer.
+ */
+typedef struct {
+    _z_atomic(size_t) _seq;
+    void *_val;
+} _z_mpsc_slot_t;
+
+typedef struct {
+    _z_mpsc_slot_t *_slots;
+    size_t _mask;
+    _z_atomic(size_t) _r_idx;
+    _z_atomic(size_t) _w_idx;
+} _z_mpsc_t;
+
+int8_t _z_mpsc_init(_z_mpsc_t *q, size_t capacity);
+
+size_t _z_mpsc_capacity(const _z_mpsc_t *q);
+size_t _z_mpsc_len(const _z_mpsc_t *q);
+_Bool _z_mpsc_is_empty(const _z_mpsc_t *q);
+
+// Producer side: return NULL on success, otherwise the element that is left to the caller
+void *_z_mpsc_push(_z_mpsc_t *q, void *e);
+
+// Consumer side: return NULL if the queue is empty, can_pull tells whether the next element is published
+void *_z_mpsc_pull(_z_mpsc_t *q);
+_Bool _z_mpsc_can_pull(const _z_mpsc_t *q);
+
+void _z_mpsc_clear(_z_mpsc_t *q, z_element_free_f f);
+
+#define _Z_MPSC_DEFINE(name, type)                                                                                  \
+    typedef _z_mpsc_t name##_mpsc_t;                                                                                \
+    static inline int8_t name##_mpsc_init(name##_mpsc_t *q, size_t capacity) { return _z_mpsc_init(q, capacity); } \
+    static inline size_t name##_mpsc_capacity(const name##_mpsc_t *q) { return _z_mpsc_capacity(q); }              \
+    static inline size_t name##_mpsc_len(const name##_mpsc_t *q) { return _z_mpsc_len(q); }                        \
+    static inline _Bool name##_mpsc_is_empty(const name##_mpsc_t *q) { return _z_mpsc_is_empty(q); }               \
+    static inline type *name##_mpsc_push(name##_mpsc_t *q, type *e) { return (type *)_z_mpsc_push(q, (void *)e); } \
+    static inline type *name##_mpsc_pull(name##_mpsc_t *q) { return (type *)_z_mpsc_pull(q); }                     \
+    static inline _Bool name##_mpsc_can_pull(const name##_mpsc_t *q) { return _z_mpsc_can_pull(q); }               \
+    static inline void name##_mpsc_clear(name##_mpsc_t *q) { _z_mpsc_clear(q, name##_elem_free); }
+
+#endif /* ZENOH_PICO_COLLECTIONS_MPSC_H */
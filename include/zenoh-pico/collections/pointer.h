@@ -18,45 +18,32 @@
 #include <stdbool.h>
 #include <stdint.h>
 
-#if ZENOH_C_STANDARD != 99
+#include "zenoh-pico/collections/atomic.h"
 
-#ifndef __cplusplus
-#include <stdatomic.h>
-#define _z_atomic(X) _Atomic X
-#define _z_atomic_store_explicit atomic_store_explicit
-#define _z_atomic_fetch_add_explicit atomic_fetch_add_explicit
-#define _z_atomic_fetch_sub_explicit atomic_fetch_sub_explicit
-#define _z_memory_order_acquire memory_order_acquire
-#define _z_memory_order_release memory_order_release
-#define _z_memory_order_relaxed memory_order_relaxed
-#else
-#include <atomic>
-#define _z_atomic(X) std::atomic<X>
-#define _z_atomic_store_explicit std::atomic_store_explicit
-#define _z_atomic_fetch_add_explicit std::atomic_fetch_add_explicit
-#define _z_atomic_fetch_sub_explicit std::atomic_fetch_sub_explicit
-#define _z_memory_order_acquire std::memory_order_acquire
-#define _z_memory_order_release std::memory_order_release
-#define _z_memory_order_relaxed std::memory_order_relaxed
-#endif  // __cplusplus
+#if ZENOH_C_STANDARD != 99
 
 /*------------------ Internal Array Macros ------------------*/
+// The value and its counter are allocated in a single block, the value first so that the block is freed through ptr
 #define _Z_POINTER_DEFINE(name, type)                                                           \
     typedef struct {                                                                            \
         type##_t *ptr;                                                                          \
         _z_atomic(unsigned int) * _cnt;                                                         \
     } name##_sptr_t;                                                                            \
+    typedef struct {                                                                            \
+        type##_t _val;                                                                          \
+        _z_atomic(unsigned int) _cnt;                                                           \
+    } name##_sptr_block_t;                                                                      \
     static inline name##_sptr_t name##_sptr_new(type##_t val) {                                 \
         name##_sptr_t p;                                                                        \
-        p.ptr = (type##_t *)zp_malloc(sizeof(type##_t));                                        \
-        if (p.ptr != NULL) {                                                                    \
-            p._cnt = (_z_atomic(unsigned int) *)zp_malloc(sizeof(_z_atomic(unsigned int) *));   \
-            if (p._cnt != NULL) {                                                               \
-                *p.ptr = val;                                                                   \
-                _z_atomic_store_explicit(p._cnt, 1, _z_memory_order_relaxed);                   \
-            } else {                                                                            \
-                zp_free(p.ptr);                                                                 \
-            }                                                                                   \
+        name##_sptr_block_t *b = (name##_sptr_block_t *)zp_malloc(sizeof(name##_sptr_block_t)); \
+        if (b != NULL) {                                                                        \
+            b->_val = val;                                                                      \
+            _z_atomic_store_explicit(&b->_cnt, 1, _z_memory_order_relaxed);                     \
+            p.ptr = &b->_val;                                                                   \
+            p._cnt = &b->_cnt;                                                                  \
+        } else {                                                                                \
+            p.ptr = NULL;                                                                       \
+            p._cnt = NULL;                                                                      \
         }                                                                                       \
         return p;                                                                               \
     }                                                                                           \
@@ -85,11 +72,10 @@
             unsigned int c = _z_atomic_fetch_sub_explicit(p->_cnt, 1, _z_memory_order_release); \
             dropped = c == 1;                                                                   \
             if (dropped == true) {                                                              \
-                atomic_thread_fence(_z_memory_order_acquire);                                   \
+                _z_atomic_thread_fence(_z_memory_order_acquire);                                \
                 if (p->ptr != NULL) {                                                           \
                     type##_clear(p->ptr);                                                       \
                     zp_free(p->ptr);                                                            \
-                    zp_free((void *)p->_cnt);                                                   \
                 }                                                                               \
             }                                                                                   \
         }                                                                                       \
@@ -97,22 +83,27 @@
     }
 #else
 /*------------------ Internal Array Macros ------------------*/
+// The value and its counter are allocated in a single block, the value first so that the block is freed through ptr
 #define _Z_POINTER_DEFINE(name, type)                                                           \
     typedef struct {                                                                            \
         type##_t *ptr;                                                                          \
         volatile uint8_t *_cnt;                                                                 \
     } name##_sptr_t;                                                                            \
+    typedef struct {                                                                            \
+        type##_t _val;                                                                          \
+        volatile uint8_t _cnt;                                                                  \
+    } name##_sptr_block_t;                                                                      \
     static inline name##_sptr_t name##_sptr_new(type##_t val) {                                 \
         name##_sptr_t p;                                                                        \
-        p.ptr = (type##_t *)zp_malloc(sizeof(type##_t));                                        \
-        if (p.ptr != NULL) {                                                                    \
-            p._cnt = (uint8_t *)zp_malloc(sizeof(uint8_t));                                     \
-            if (p._cnt != NULL) {                                                               \
-                *p.ptr = val;                                                                   \
-                *p._cnt = 1;                                                                    \
-            } else {                                                                            \
-                zp_free(p.ptr);                                                                 \
-            }                                                                                   \
+        name##_sptr_block_t *b = (name##_sptr_block_t *)zp_malloc(sizeof(name##_sptr_block_t)); \
+        if (b != NULL) {                                                                        \
+            b->_val = val;                                                                      \
+            b->_cnt = 1;                                                                        \
+            p.ptr = &b->_val;                                                                   \
+            p._cnt = &b->_cnt;                                                                  \
+        } else {                                                                                \
+            p.ptr = NULL;                                                                       \
+            p._cnt = NULL;                                                                      \
         }                                                                                       \
         return p;                                                                               \
     }                                                                                           \
@@ -144,7 +135,6 @@
                 if (p->ptr != NULL) {                                                           \
                     type##_clear(p->ptr);                                                       \
                     zp_free(p->ptr);                                                            \
-                    zp_free((void *)p->_cnt);                                                   \
                 }                                                                               \
             }                                                                                   \
         }                                                                                       \
@@ -0,0 +1,79 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_COLLECTIONS_RING_H
+#define ZENOH_PICO_COLLECTIONS_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/collections/atomic.h"
+#include "zenoh-pico/collections/element.h"
+
+/*-------- Single-producer single-consumer ring --------*/
+/**
+ * A bounded lock-free FIFO, safe to use concurrently by one producer and one consumer thread.
+ *
+ * The producer is the only writer of the write index. The read index is advanced with a compare-and-swap, so that the
+ * producer can also evict the oldest element when the ring is full: whichever of the two wins the swap owns the
+ * element.
+ *
+ *  Members:
+ *   _z_atomic(_z_ring_val_t) *_vals: The slots, their number is the capacity rounded up to a power of two.
+ *   size_t _capacity: The maximum number of elements in the ring.
+ *   size_t _mask: The number of slots minus one, the indexes keep increasing and are masked on access.
+ *   _z_atomic(size_t) _r_idx: The index of the next element to be pulled.
+ *   _z_atomic(size_t) _w_idx: The index of the next element to be pushed.
+ */
+typedef void *_z_ring_val_t;
+
+typedef struct {
+    _z_atomic(_z_ring_val_t) * _vals;
+    size_t _capacity;
+    size_t _mask;
+    _z_atomic(size_t) _r_idx;
+    _z_atomic(size_t) _w_idx;
+} _z_ring_t;
+
+int8_t _z_ring_init(_z_ring_t *r, size_t capacity);
+
+size_t _z_ring_capacity(const _z_ring_t *r);
+size_t _z_ring_len(const _z_ring_t *r);
+_Bool _z_ring_is_empty(const _z_ring_t *r);
+_Bool _z_ring_is_full(const _z_ring_t *r);
+
+// Producer side: return NULL on success, otherwise the element that is left to the caller
+void *_z_ring_push(_z_ring_t *r, void *e);
+void *_z_ring_push_force(_z_ring_t *r, void *e);
+
+// Consumer side: return NULL if the ring is empty
+void *_z_ring_pull(_z_ring_t *r);
+
+void _z_ring_clear(_z_ring_t *r, z_element_free_f f);
+
+#define _Z_RING_DEFINE(name, type)                                                                                  \
+    typedef _z_ring_t name##_ring_t;                                                                                \
+    static inline int8_t name##_ring_init(name##_ring_t *r, size_t capacity) { return _z_ring_init(r, capacity); } \
+    static inline size_t name##_ring_capacity(const name##_ring_t *r) { return _z_ring_capacity(r); }              \
+    static inline size_t name##_ring_len(const name##_ring_t *r) { return _z_ring_len(r); }                        \
+    static inline _Bool name##_ring_is_empty(const name##_ring_t *r) { return _z_ring_is_empty(r); }               \
+    static inline _Bool name##_ring_is_full(const name##_ring_t *r) { return _z_ring_is_full(r); }                 \
+    static inline type *name##_ring_push(name##_ring_t *r, type *e) { return (type *)_z_ring_push(r, (void *)e); } \
+    static inline type *name##_ring_push_force(name##_ring_t *r, type *e) {                                        \
+        return (type *)_z_ring_push_force(r, (void *)e);                                                           \
+    }                                                                                                               \
+    static inline type *name##_ring_pull(name##_ring_t *r) { return (type *)_z_ring_pull(r); }                     \
+    static inline void name##_ring_clear(name##_ring_t *r) { _z_ring_clear(r, name##_elem_free); }
+
+#endif /* ZENOH_PICO_COLLECTIONS_RING_H */
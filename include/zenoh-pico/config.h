@@ -30,9 +30,11 @@
  * The locator of a peer to connect to.
  * Accepted values : `<locator>` (ex: `"tcp/10.10.10.10:7447"`).
  * Default value : None.
- * Multiple values are not accepted in zenoh-pico.
+ * Multiple values, separated by Z_CONFIG_LOCATORS_SEPARATOR, are only accepted when Z_FEATURE_MULTI_TRANSPORT is
+ * enabled.
  */
 #define Z_CONFIG_CONNECT_KEY 0x41
+#define Z_CONFIG_LOCATORS_SEPARATOR ','
 
 /**
  * A locator to listen on.
@@ -225,6 +227,89 @@
 #define Z_FEATURE_RAWETH_TRANSPORT 0
 #endif
 
+/**
+ * Enable automatic batching of network messages on unicast transports.
+ */
+#ifndef Z_FEATURE_BATCHING
+#define Z_FEATURE_BATCHING 0
+#endif
+
+/**
+ * Enable tracking of the remote subscribers, so that publishers skip the samples nobody is subscribed to and report
+ * their matching status. Requires the remote nodes to declare their subscribers to this node.
+ */
+#ifndef Z_FEATURE_MATCHING
+#define Z_FEATURE_MATCHING 0
+#endif
+
+/**
+ * Enable one transmission lane per priority, each with its own sequence numbers, when the remote node supports QoS.
+ * Fragmented messages can then be interleaved with messages of other priorities. The defragmentation buffers are
+ * also kept per priority.
+ */
+#ifndef Z_FEATURE_PRIORITY_LANES
+#define Z_FEATURE_PRIORITY_LANES 0
+#endif
+
+/**
+ * Enable the memory pool: the small allocations are served from statically allocated blocks of a few size classes,
+ * instead of the platform allocator. The allocations the pool cannot serve fall back to the platform allocator.
+ */
+#ifndef Z_FEATURE_MEMORY_POOL
+#define Z_FEATURE_MEMORY_POOL 0
+#endif
+
+/**
+ * Enable the reactor: a few threads wait on the sockets and the lease deadlines of many sessions, and read or run the
+ * lease of whichever session is ready, instead of each session running its own read and lease tasks. Requires epoll.
+ */
+#ifndef Z_FEATURE_REACTOR
+#define Z_FEATURE_REACTOR 0
+#endif
+
+/**
+ * Enable batched datagram I/O on the UDP links: the read and TX tasks move several datagrams per system call, with
+ * recvmmsg and sendmmsg. Only available on Linux.
+ */
+#ifndef Z_FEATURE_UDP_BATCH_IO
+#define Z_FEATURE_UDP_BATCH_IO 0
+#endif
+
+/**
+ * Enable selective-repeat reliability on the unreliable links: the reliable frames and fragments are kept for
+ * retransmission, and the receivers reorder them and request the missing ones with NACK messages.
+ */
+#ifndef Z_FEATURE_RELIABILITY
+#define Z_FEATURE_RELIABILITY 0
+#endif
+
+/**
+ * Enable several transports per session, one per connect locator, e.g. to a router over TCP and to peers over UDP
+ * multicast, or to two routers. The declarations are sent on all of them, so that a standby transport takes over the
+ * traffic of a failed one right away, the responses go back on the transport of their request, and each other message
+ * goes to the first transport suiting its reliability. Samples are not deduplicated: two routers of the same network
+ * both forward the publications matching a subscriber, which then receives them once per router.
+ */
+#ifndef Z_FEATURE_MULTI_TRANSPORT
+#define Z_FEATURE_MULTI_TRANSPORT 0
+#endif
+
+/**
+ * Enable the statistics counters of the transports and of the session, e.g. the messages and bytes sent and received
+ * or the messages dropped, read with zp_stats_get. They are relaxed atomic counters, that wrap around on overflow.
+ */
+#ifndef Z_FEATURE_STATS
+#define Z_FEATURE_STATS 0
+#endif
+
+/**
+ * Enable the vector instructions of the target, SSE2, AVX2 or NEON, to split the key expressions in chunks and to
+ * look for their wildcards when matching and canonizing them. The scalar code is used on the other targets.
+ */
+#ifndef Z_FEATURE_SIMD
+#define Z_FEATURE_SIMD 1
+#endif
+
 /*------------------ Compile-time configuration properties ------------------*/
 /**
  * Default length for Zenoh ID. Maximum size is 16 bytes.
@@ -274,6 +359,21 @@
 #define Z_CONFIG_SOCKET_TIMEOUT 100
 #endif
 
+/**
+ * Default get timeout in milliseconds, a pending query is expired if no final reply is received in time.
+ * 0 means the pending queries never expire, a timeout has to be set on each get to opt in.
+ */
+#ifndef Z_GET_TIMEOUT_DEFAULT
+#define Z_GET_TIMEOUT_DEFAULT 0
+#endif
+
+/**
+ * Default number of samples a sample ring handler can hold.
+ */
+#ifndef Z_SAMPLE_RING_CAPACITY_DEFAULT
+#define Z_SAMPLE_RING_CAPACITY_DEFAULT 16
+#endif
+
 #ifndef Z_SN_RESOLUTION
 #define Z_SN_RESOLUTION 0x02
 #endif
@@ -302,6 +402,13 @@
 #define Z_BATCH_MULTICAST_SIZE 8192
 #endif
 
+/**
+ * Default maximum time in milliseconds a batch can linger before being flushed.
+ */
+#ifndef Z_BATCH_LINGER_TIME
+#define Z_BATCH_LINGER_TIME 5
+#endif
+
 /**
  * Default maximum size for fragmented messages.
  */
@@ -309,6 +416,127 @@
 #define Z_FRAG_MAX_SIZE 300000
 #endif
 
+/**
+ * Maximum number of messages in the queue of the TX task.
+ */
+#ifndef Z_TX_QUEUE_SIZE
+#define Z_TX_QUEUE_SIZE 256
+#endif
+
+/**
+ * Number of queued bytes from which the queue of the TX task is congested. The messages are then dropped or their
+ * publishers blocked, according to their congestion control, until the queue is drained down to the low watermark.
+ */
+#ifndef Z_TX_QUEUE_HIGH_WATERMARK
+#define Z_TX_QUEUE_HIGH_WATERMARK 131072
+#endif
+
+/**
+ * Number of queued bytes down to which the queue of the TX task must be drained to end a congestion.
+ */
+#ifndef Z_TX_QUEUE_LOW_WATERMARK
+#define Z_TX_QUEUE_LOW_WATERMARK 32768
+#endif
+
+/**
+ * Block size of the smallest size class of the memory pool, the size doubles with each following class.
+ */
+#ifndef Z_MEMORY_POOL_BLOCK_SIZE
+#define Z_MEMORY_POOL_BLOCK_SIZE 16
+#endif
+
+/**
+ * Number of size classes of the memory pool, the default ones serve the allocations of up to 512 bytes.
+ */
+#ifndef Z_MEMORY_POOL_CLASSES
+#define Z_MEMORY_POOL_CLASSES 6
+#endif
+
+/**
+ * Number of blocks of each size class of the memory pool, at most 65535.
+ */
+#ifndef Z_MEMORY_POOL_BLOCKS
+#define Z_MEMORY_POOL_BLOCKS 32
+#endif
+
+/**
+ * Number of RX batches a transport keeps for reuse, besides the one it reads into. A batch stays in use while a
+ * retained payload references it, the transport then reads into another one.
+ */
+#ifndef Z_RX_POOL_SIZE
+#define Z_RX_POOL_SIZE 4
+#endif
+
+/**
+ * Minimum size of a payload to be retained without copy, smaller payloads are copied when retained so that they do
+ * not keep a whole batch in use.
+ */
+#ifndef Z_RX_POOL_RETAIN_MIN_SIZE
+#define Z_RX_POOL_RETAIN_MIN_SIZE 256
+#endif
+
+/**
+ * Maximum number of ready sessions a reactor thread handles per wake up.
+ */
+#ifndef Z_REACTOR_EVENTS
+#define Z_REACTOR_EVENTS 16
+#endif
+
+/**
+ * Maximum number of datagrams moved by a single system call, when Z_FEATURE_UDP_BATCH_IO is enabled.
+ */
+#ifndef Z_UDP_BATCH_IO_SIZE
+#define Z_UDP_BATCH_IO_SIZE 8
+#endif
+
+/**
+ * Size of the RX slot of each datagram of a batch, when Z_FEATURE_UDP_BATCH_IO is enabled. The RX buffers of the UDP
+ * transports then hold Z_UDP_BATCH_IO_SIZE slots, and the larger datagrams are dropped.
+ */
+#ifndef Z_UDP_BATCH_IO_SLOT_SIZE
+#define Z_UDP_BATCH_IO_SLOT_SIZE 8192
+#endif
+
+/**
+ * Number of reliable frames and fragments kept for retransmission per lane, when Z_FEATURE_RELIABILITY is enabled.
+ * The oldest one is dropped once the window is full.
+ */
+#ifndef Z_RELIABILITY_WINDOW_SIZE
+#define Z_RELIABILITY_WINDOW_SIZE 32
+#endif
+
+/**
+ * Number of reliable frames and fragments buffered per lane after a missing one, when Z_FEATURE_RELIABILITY is
+ * enabled. The missing ones are given up once it is full. At most 64.
+ */
+#ifndef Z_RELIABILITY_REORDER_SIZE
+#define Z_RELIABILITY_REORDER_SIZE 16
+#endif
+
+/**
+ * Time in milliseconds after which the unacknowledged reliable frames and fragments of a unicast transport are sent
+ * again, when Z_FEATURE_RELIABILITY is enabled.
+ */
+#ifndef Z_RELIABILITY_RTO
+#define Z_RELIABILITY_RTO 200
+#endif
+
+/**
+ * Maximum number of transports of a session, when Z_FEATURE_MULTI_TRANSPORT is enabled. The locators beyond it are
+ * ignored.
+ */
+#ifndef Z_TRANSPORTS_MAX
+#define Z_TRANSPORTS_MAX 3
+#endif
+
+/**
+ * Stripe the best effort messages of data priority across the transports of a session, in turn, when
+ * Z_FEATURE_MULTI_TRANSPORT is enabled. Otherwise they go to the first transport suiting them, like the other messages.
+ */
+#ifndef Z_TRANSPORTS_STRIPING
+#define Z_TRANSPORTS_STRIPING 0
+#endif
+
 /**
  * Default "nop" instruction
  */
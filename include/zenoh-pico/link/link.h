@@ -94,8 +94,13 @@ typedef int8_t (*_z_f_link_listen)(struct _z_link_t *self);
 typedef void (*_z_f_link_close)(struct _z_link_t *self);
 typedef size_t (*_z_f_link_write)(const struct _z_link_t *self, const uint8_t *ptr, size_t len);
 typedef size_t (*_z_f_link_write_all)(const struct _z_link_t *self, const uint8_t *ptr, size_t len);
+typedef size_t (*_z_f_link_write_vec)(const struct _z_link_t *self, const _z_bytes_t *bufs, size_t count);
 typedef size_t (*_z_f_link_read)(const struct _z_link_t *self, uint8_t *ptr, size_t len, _z_bytes_t *addr);
 typedef size_t (*_z_f_link_read_exact)(const struct _z_link_t *self, uint8_t *ptr, size_t len, _z_bytes_t *addr);
+typedef size_t (*_z_f_link_write_batch)(const struct _z_link_t *self, const _z_bytes_t *bufs, size_t count);
+typedef size_t (*_z_f_link_read_batch)(const struct _z_link_t *self, uint8_t *ptr, size_t stride, size_t count,
+                                       size_t *lens, _z_bytes_t *addrs);
+typedef const _z_sys_net_socket_t *(*_z_f_link_rx_socket)(const struct _z_link_t *self);
 typedef void (*_z_f_link_free)(struct _z_link_t *self);
 
 typedef struct _z_link_t {
@@ -127,21 +132,53 @@ typedef struct _z_link_t {
     _z_f_link_close _close_f;
     _z_f_link_write _write_f;
     _z_f_link_write_all _write_all_f;
+    _z_f_link_write_vec _write_vec_f;  // Optional, gathers up to _Z_LINK_WRITE_VEC_MAX buffers in a single write
     _z_f_link_read _read_f;
     _z_f_link_read_exact _read_exact_f;
+    _z_f_link_write_batch _write_batch_f;  // Optional, sends up to _Z_LINK_BATCH_MAX datagrams in a single write
+    _z_f_link_read_batch _read_batch_f;    // Optional, receives up to _Z_LINK_BATCH_MAX datagrams in a single read
+    _z_f_link_rx_socket _rx_socket_f;  // Optional, the socket the link reads from, to wait for it with other ones
     _z_f_link_free _free_f;
 
     uint16_t _mtu;
     _z_link_capabilities_t _cap;
 } _z_link_t;
 
+#ifdef _Z_SYS_NET_SEND_VEC_MAX
+#define _Z_LINK_WRITE_VEC_MAX _Z_SYS_NET_SEND_VEC_MAX
+#else
+#define _Z_LINK_WRITE_VEC_MAX 0
+#endif
+
+#ifdef _Z_SYS_NET_BATCH_MAX
+#define _Z_LINK_BATCH_MAX _Z_SYS_NET_BATCH_MAX
+#else
+#define _Z_LINK_BATCH_MAX 1
+#endif
+
 void _z_link_clear(_z_link_t *zl);
 void _z_link_free(_z_link_t **zl);
 int8_t _z_open_link(_z_link_t *zl, const char *locator);
 int8_t _z_listen_link(_z_link_t *zl, const char *locator);
 
+size_t _z_link_write_vec_max(const _z_link_t *zl);
 int8_t _z_link_send_wbuf(const _z_link_t *zl, const _z_wbuf_t *wbf);
 size_t _z_link_recv_zbuf(const _z_link_t *zl, _z_zbuf_t *zbf, _z_bytes_t *addr);
 size_t _z_link_recv_exact_zbuf(const _z_link_t *zl, _z_zbuf_t *zbf, size_t len, _z_bytes_t *addr);
 
+// The number of datagrams moved by a single batched read or write, 1 if the link does not batch them
+size_t _z_link_batch_max(const _z_link_t *zl);
+/**
+ * Sends count single-slice wbufs, one datagram each, in as few writes as the link allows.
+ */
+int8_t _z_link_send_wbufs(const _z_link_t *zl, const _z_wbuf_t *wbfs, size_t count);
+/**
+ * Receives up to _z_link_batch_max datagrams in a single read. The zbuf is reset and split in slots of
+ * Z_UDP_BATCH_IO_SLOT_SIZE bytes, the datagram i is held at i * Z_UDP_BATCH_IO_SLOT_SIZE and its length is lens[i],
+ * 0 if it must be skipped. The address of its sender is written in addrs[i] if addrs is not NULL.
+ *
+ * Returns the number of slots filled, or SIZE_MAX on error.
+ */
+size_t _z_link_recv_batch_zbuf(const _z_link_t *zl, _z_zbuf_t *zbf, size_t *lens, _z_bytes_t *addrs);
+
 #endif /* ZENOH_PICO_LINK_H */
@@ -24,6 +24,7 @@
  *     sample: The :c:type:`_z_sample_t` to free.
  */
 void _z_sample_move(_z_sample_t *dst, _z_sample_t *src);
+void _z_sample_copy(_z_sample_t *dst, const _z_sample_t *src);
 void _z_sample_clear(_z_sample_t *sample);
 void _z_sample_free(_z_sample_t **sample);
 
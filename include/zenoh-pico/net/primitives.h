@@ -120,6 +120,52 @@ int8_t _z_undeclare_publisher(_z_publisher_t *pub);
 int8_t _z_write(_z_session_t *zn, const _z_keyexpr_t keyexpr, const uint8_t *payload, const size_t len,
                 const _z_encoding_t encoding, const z_sample_kind_t kind, const z_congestion_control_t cong_ctrl,
                 z_priority_t priority);
+
+/**
+ * Write data with a :c:type:`_z_publisher_t`.
+ *
+ * With the default encoding, the message is framed from the header pre-encoded when the publisher was declared,
+ * only the payload is encoded.
+ *
+ * Parameters:
+ *     pub: The publisher to write with. The caller keeps its ownership.
+ *     payload: The value to write.
+ *     len: The length of the value to write.
+ *     encoding: The encoding of the payload. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int8_t _z_publisher_write(const _z_publisher_t *pub, const uint8_t *payload, const size_t len,
+                          const _z_encoding_t encoding);
+
+#if Z_FEATURE_MATCHING == 1
+/**
+ * Declare a :c:type:`_z_matching_listener_t` notified whenever the existence of remote subscribers
+ * matching the key of a publisher changes.
+ *
+ * Parameters:
+ *     pub: The publisher to listen the matching status of. The caller keeps its ownership.
+ *     callback: The callback function that will be called each time the matching status changes.
+ *     dropper: The callback function that will be called on upon undeclaration of the listener.
+ *     arg: A pointer that will be passed to the **callback** on each call.
+ *
+ * Returns:
+ *    The created :c:type:`_z_matching_listener_t` or null if the declaration failed.
+ */
+_z_matching_listener_t *_z_declare_matching_listener(_z_publisher_t *pub, _z_matching_status_handler_t callback,
+                                                     _z_drop_handler_t dropper, void *arg);
+
+/**
+ * Undeclare a :c:type:`_z_matching_listener_t`.
+ *
+ * Parameters:
+ *     listener: The :c:type:`_z_matching_listener_t` to undeclare. The callee releases the
+ *               listener upon successful return.
+ * Returns:
+ *    0 if success, or a negative value identifying the error.
+ */
+int8_t _z_undeclare_matching_listener(_z_matching_listener_t *listener);
+#endif
 #endif
 
 #if Z_FEATURE_SUBSCRIPTION == 1
@@ -221,14 +267,15 @@ int8_t _z_send_reply(const z_query_t *query, const _z_keyexpr_t keyexpr, const _
  *     target: The kind of queryables that should be target of this query.
  *     consolidation: The kind of consolidation that should be applied on replies.
  *     value: The payload of the query.
+ *     timeout_ms: The time after which the query expires with an error reply, 0 means it never expires.
  *     callback: The callback function that will be called on reception of replies for this query.
  *     arg_call: A pointer that will be passed to the **callback** on each call.
  *     dropper: The callback function that will be called on upon completion of the callback.
  *     arg_drop: A pointer that will be passed to the **dropper** on each call.
  */
 int8_t _z_query(_z_session_t *zn, _z_keyexpr_t keyexpr, const char *parameters, const z_query_target_t target,
-                const z_consolidation_mode_t consolidation, const _z_value_t value, _z_reply_handler_t callback,
-                void *arg_call, _z_drop_handler_t dropper, void *arg_drop);
+                const z_consolidation_mode_t consolidation, const _z_value_t value, uint32_t timeout_ms,
+                _z_reply_handler_t callback, void *arg_call, _z_drop_handler_t dropper, void *arg_drop);
 #endif
 
 #endif /* ZENOH_PICO_PRIMITIVES_NETAPI_H */
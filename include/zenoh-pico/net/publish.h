@@ -27,11 +27,30 @@ typedef struct {
     _z_session_t *_zn;
     z_congestion_control_t _congestion_control;
     z_priority_t _priority;
+    _z_bytes_t _prefix;  // The PUT of this publisher encoded up to its payload, for the default encoding
+#if Z_FEATURE_MATCHING == 1
+    // Cached matching status, valid as long as _matching_gen equals the generation of the session
+    size_t _matching_gen;
+    _Bool _matching;
+#endif
 } _z_publisher_t;
 
+/**
+ * Return type when declaring a matching listener.
+ */
+typedef struct {
+    uint32_t _entity_id;
+    _z_session_t *_zn;
+} _z_matching_listener_t;
+
 #if Z_FEATURE_PUBLICATION == 1
 void _z_publisher_clear(_z_publisher_t *pub);
 void _z_publisher_free(_z_publisher_t **pub);
 #endif
 
+#if Z_FEATURE_MATCHING == 1
+void _z_matching_listener_clear(_z_matching_listener_t *listener);
+void _z_matching_listener_free(_z_matching_listener_t **listener);
+#endif
+
 #endif /* INCLUDE_ZENOH_PICO_NET_PUBLISH_H */
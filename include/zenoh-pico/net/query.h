@@ -26,7 +26,8 @@ typedef struct {
     _z_value_t _value;
     _z_keyexpr_t _key;
     uint32_t _request_id;
-    void *_zn;  // FIXME: _z_session_t *zn;
+    uint16_t _mapping;  // The mapping of the querier, the replies go back on its transport
+    void *_zn;          // FIXME: _z_session_t *zn;
     char *_parameters;
     _Bool _anyke;
 } z_query_t;
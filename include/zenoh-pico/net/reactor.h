@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_REACTOR_NETAPI_H
+#define ZENOH_PICO_REACTOR_NETAPI_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/config.h"
+#include "zenoh-pico/net/session.h"
+#include "zenoh-pico/system/platform.h"
+
+#if Z_FEATURE_REACTOR == 1
+
+#ifndef _Z_SYS_NET_POLL
+#error "The reactor relies on epoll, it is only available on Linux"
+#endif
+
+#define _Z_REACTOR_DEFAULT_CAPACITY 8
+#define _Z_REACTOR_NO_TIMER SIZE_MAX
+
+/**
+ * A transport of a session driven by a reactor, a session has one entry per transport.
+ *
+ * Members:
+ *   _session: the session, the reactor does not own it
+ *   _tp: the transport of the session the entry reads from and steps
+ *   _socket: the socket the link of the transport reads from
+ *   _deadline: the next lease step of the transport, in milliseconds since the creation of the reactor
+ *   _timer_idx: the position in the timers heap, _Z_REACTOR_NO_TIMER while its lease step runs or once expired
+ *   _busy: the number of threads reading from or stepping the transport
+ *   _removed: whether the session has been removed, the entry is only freed once no thread may still refer to it
+ *   _expired: whether the lease of the transport expired, it is no longer read nor stepped
+ *   _next: the next entry waiting to be freed
+ */
+typedef struct _z_reactor_entry_t {
+    _z_session_t *_session;
+    _z_transport_t *_tp;
+    const _z_sys_net_socket_t *_socket;
+    unsigned long _deadline;
+    size_t _timer_idx;
+    size_t _busy;
+    _Bool _removed;
+    _Bool _expired;
+    struct _z_reactor_entry_t *_next;
+} _z_reactor_entry_t;
+
+/**
+ * Drives the reads and the leases of many sessions from a single wait set, instead of a read and a lease task per
+ * session.
+ *
+ * The readable sockets are reported once, to a single thread, then re-armed once the batches they brought have been
+ * decoded. The lease steps of the sessions are ordered by deadline in a binary min-heap, and run by the thread that
+ * finds them due when its wait returns. Several threads may run the same reactor.
+ *
+ * Members:
+ *   _poll: the wait set of the sockets of the sessions
+ *   _epoch: the origin of the deadlines
+ *   _entries: the sessions of the reactor, in no particular order
+ *   _len: the number of sessions of the reactor
+ *   _timers: the min-heap of the sessions whose lease step is pending, ordered by deadline
+ *   _timers_len: the number of sessions in the heap
+ *   _capacity: the number of sessions the arrays can hold without reallocation
+ *   _graveyard: the removed entries still visible to a running thread
+ *   _running: the number of threads running the reactor
+ */
+typedef struct {
+    _z_sys_net_poll_t _poll;
+    zp_clock_t _epoch;
+    _z_reactor_entry_t **_entries;
+    size_t _len;
+    _z_reactor_entry_t **_timers;
+    size_t _timers_len;
+    size_t _capacity;
+    _z_reactor_entry_t *_graveyard;
+    size_t _running;
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_t _mutex;
+    zp_condvar_t _cv;
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+} _z_reactor_t;
+
+int8_t _z_reactor_init(_z_reactor_t *r);
+// All the sessions must have been removed
+void _z_reactor_clear(_z_reactor_t *r);
+
+/**
+ * Adds a session to a reactor. Its link must expose the socket it reads from, and it must not run read nor lease tasks.
+ * Its first lease step is due immediately, it runs once the waits in progress return.
+ */
+int8_t _z_reactor_add(_z_reactor_t *r, _z_session_t *zn);
+
+/**
+ * Removes a session from a reactor, waiting for the threads reading from it or stepping it. It must not be called from
+ * a callback of the session. A session whose lease expired stays in the reactor until removed.
+ */
+int8_t _z_reactor_remove(_z_reactor_t *r, _z_session_t *zn);
+
+/**
+ * Waits up to timeout milliseconds for readable sessions or due lease steps, and handles them.
+ */
+int8_t _z_reactor_run(_z_reactor_t *r, uint32_t timeout);
+
+#endif  // Z_FEATURE_REACTOR == 1
+
+#endif /* ZENOH_PICO_REACTOR_NETAPI_H */
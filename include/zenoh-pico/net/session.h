@@ -21,8 +21,10 @@
 #include "zenoh-pico/collections/list.h"
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/session/keyexpr_index.h"
 #include "zenoh-pico/session/session.h"
 #include "zenoh-pico/utils/config.h"
+#include "zenoh-pico/utils/stats.h"
 
 /**
  * A zenoh-net session.
@@ -32,8 +34,14 @@ typedef struct {
     zp_mutex_t _mutex_inner;
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    // Zenoh-pico is considering a single transport per session.
+    // Zenoh-pico is considering a single transport per session, unless Z_FEATURE_MULTI_TRANSPORT is enabled.
     _z_transport_t _tp;
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    // The transports opened on the next connect locators, _tp is the first transport of the session
+    _z_transport_t _tp_others[Z_TRANSPORTS_MAX - 1];
+    size_t _tp_others_len;
+    size_t _tp_stripe;  // The turn of the striped messages, updated without lock as any transport will do
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
 
     // Zenoh PID
     _z_id_t _local_zid;
@@ -46,22 +54,40 @@ typedef struct {
     _z_zint_t _interest_id;
 
     // Session declarations
-    _z_resource_list_t *_local_resources;
-    _z_resource_list_t *_remote_resources;
+    _z_resource_table_t _local_resources;
+    _z_resource_table_t _remote_resources;
+    size_t _resources_gen;  // Changes whenever a multicast peer joins, the local resources are then announced again
 
     // Session subscriptions
 #if Z_FEATURE_SUBSCRIPTION == 1
     _z_subscription_sptr_list_t *_local_subscriptions;
+    _z_keyexpr_index_t _local_subscriptions_index;
+#endif
+#if Z_FEATURE_SUBSCRIPTION == 1 || Z_FEATURE_MATCHING == 1
     _z_subscription_sptr_list_t *_remote_subscriptions;
+    _z_keyexpr_index_t _remote_subscriptions_index;
+#endif
+
+    // Session matching listeners, the generation changes whenever the remote subscriptions change
+#if Z_FEATURE_MATCHING == 1
+    _z_matching_sptr_list_t *_matching_listeners;
+    size_t _matching_gen;
 #endif
 
     // Session queryables
 #if Z_FEATURE_QUERYABLE == 1
     _z_questionable_sptr_list_t *_local_questionable;
+    _z_keyexpr_index_t _local_questionable_index;
 #endif
 #if Z_FEATURE_QUERY == 1
-    _z_pending_query_list_t *_pending_queries;
+    _z_pending_query_table_t _pending_queries;
+    zp_clock_t _query_clock;  // Reference of the pending query deadlines
 #endif
+
+#if Z_FEATURE_STATS == 1
+    // The counters of the network messages handled by the session, the transports keep their own ones
+    _z_session_stats_t _stats;
+#endif  // Z_FEATURE_STATS == 1
 } _z_session_t;
 
 /**
@@ -118,6 +144,16 @@ int8_t _zp_read(_z_session_t *z);
  */
 int8_t _zp_send_keep_alive(_z_session_t *z);
 
+/**
+ * Flush the network messages batched on the transport, if any.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int8_t _zp_flush(_z_session_t *z);
+
 /**
  * Send a Join message.
  *
@@ -178,6 +214,30 @@ int8_t _zp_start_lease_task(_z_session_t *z, zp_task_attr_t *attr);
  *     ``0`` in case of success, ``-1`` in case of failure.
  */
 int8_t _zp_stop_lease_task(_z_session_t *z);
+
+/**
+ * Start a separate task to send the network messages. The publishers then only
+ * encode their messages and push them in a bounded queue, that the task drains
+ * into batches written on the socket. The congestion control of the messages
+ * applies to the depth of this queue.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int8_t _zp_start_tx_task(_z_session_t *z, zp_task_attr_t *attr);
+
+/**
+ * Stop the TX task, once it has sent the queued messages. The network messages
+ * are then sent directly by the publishers again.
+ *
+ * Parameters:
+ *     session: The zenoh-net session. The caller keeps its ownership.
+ * Returns:
+ *     ``0`` in case of success, ``-1`` in case of failure.
+ */
+int8_t _zp_stop_tx_task(_z_session_t *z);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
 #endif /* INCLUDE_ZENOH_PICO_NET_SESSION_H */
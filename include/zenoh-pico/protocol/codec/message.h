@@ -38,6 +38,8 @@ int8_t _z_ack_decode(_z_msg_ack_t *ack, _z_zbuf_t *zbf, uint8_t header);
 
 int8_t _z_push_body_encode(_z_wbuf_t *wbf, const _z_push_body_t *pshb);
 int8_t _z_push_body_decode(_z_push_body_t *body, _z_zbuf_t *zbf, uint8_t header);
+// Encodes the body up to its payload, excluded
+int8_t _z_push_body_prefix_encode(_z_wbuf_t *wbf, const _z_push_body_t *pshb);
 
 int8_t _z_put_encode(_z_wbuf_t *wbf, const _z_msg_put_t *put);
 int8_t _z_put_decode(_z_msg_put_t *put, _z_zbuf_t *zbf, uint8_t header);
@@ -20,6 +20,8 @@
 #include "zenoh-pico/protocol/definitions/network.h"
 #include "zenoh-pico/protocol/iobuf.h"
 int8_t _z_push_encode(_z_wbuf_t *wbf, const _z_n_msg_push_t *msg);
+// Encodes the message up to the payload of its body, excluded
+int8_t _z_push_prefix_encode(_z_wbuf_t *wbf, const _z_n_msg_push_t *msg);
 int8_t _z_push_decode(_z_n_msg_push_t *msg, _z_zbuf_t *zbf, uint8_t header);
 int8_t _z_request_encode(_z_wbuf_t *wbf, const _z_n_msg_request_t *msg);
 int8_t _z_request_decode(_z_n_msg_request_t *msg, _z_zbuf_t *zbf, uint8_t header);
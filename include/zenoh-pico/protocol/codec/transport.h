@@ -42,10 +42,24 @@ int8_t _z_keep_alive_decode(_z_t_msg_keep_alive_t *msg, _z_zbuf_t *zbf, uint8_t
 
 int8_t _z_frame_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_frame_t *msg);
 int8_t _z_frame_decode(_z_t_msg_frame_t *msg, _z_zbuf_t *zbf, uint8_t header);
+int8_t _z_frame_header_decode(_z_t_msg_frame_t *msg, _z_zbuf_t *zbf, uint8_t header);
+/**
+ * Decodes the next network message of a frame decoded with _z_frame_header_decode, without any allocation for the
+ * message itself. ``end`` is set to true, and ``nm`` left untouched, once the frame has no more messages.
+ */
+int8_t _z_frame_decode_next(_z_t_msg_frame_t *msg, _z_network_message_t *nm, _Bool *end);
 
 int8_t _z_fragment_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_fragment_t *msg);
 int8_t _z_fragment_decode(_z_t_msg_fragment_t *msg, _z_zbuf_t *zbf, uint8_t header);
 
+int8_t _z_ack_nack_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_ack_nack_t *msg);
+int8_t _z_ack_nack_decode(_z_t_msg_ack_nack_t *msg, _z_zbuf_t *zbf, uint8_t header);
+
 int8_t _z_transport_message_encode(_z_wbuf_t *wbf, const _z_transport_message_t *msg);
 int8_t _z_transport_message_decode(_z_transport_message_t *msg, _z_zbuf_t *zbf);
+/**
+ * Same as _z_transport_message_decode, except that the network messages of a frame are left in ``zbf`` to be decoded
+ * one by one with _z_frame_decode_next. ``zbf`` must outlive the decoded message.
+ */
+int8_t _z_transport_message_decode_stream(_z_transport_message_t *msg, _z_zbuf_t *zbf);
 #endif /* INCLUDE_ZENOH_PICO_PROTOCOL_CODEC_TRANSPORT_H */
@@ -83,12 +83,19 @@ _Bool _z_timestamp_check(const _z_timestamp_t *stamp);
  *     - 0: local mapping.
  *     - 0x7fff (MAX): unknown remote mapping.
  *     - x: the mapping associated with the x-th peer.
+ *     - 0x7fff - i: the mapping of the i-th unicast transport of a session, counted from 0, when
+ *       Z_FEATURE_MULTI_TRANSPORT is enabled. The peers are then only given the ids below them.
  */
 typedef struct {
     uint16_t _val;
 } _z_mapping_t;
 #define _Z_KEYEXPR_MAPPING_LOCAL 0
 #define _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE 0x7fff
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+#define _Z_KEYEXPR_MAPPING_PEER_END (_Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE - (Z_TRANSPORTS_MAX - 1))
+#else
+#define _Z_KEYEXPR_MAPPING_PEER_END _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE
+#endif
 
 /**
  * A zenoh-net resource key.
@@ -152,6 +159,9 @@ _z_keyexpr_t _z_rname(const char *rname);
  */
 _z_keyexpr_t _z_rid_with_suffix(uint16_t rid, const char *suffix);
 
+// Forward declaration, the RX batches are defined with the transports
+typedef struct _z_rx_batch_t _z_rx_batch_t;
+
 /**
  * A zenoh-net data sample.
  *
@@ -161,6 +171,8 @@ _z_keyexpr_t _z_rid_with_suffix(uint16_t rid, const char *suffix);
  *   _z_keyexpr_t key: The resource key of this data sample.
  *   _z_bytes_t value: The value of this data sample.
  *   _z_encoding_t encoding: The encoding for the value of this data sample.
+ *   _z_rx_batch_t *_batch: The RX batch the payload may lie in, borrowed for the time of the callback. NULL if the
+ *     sample was not received by a transport, or is a copy.
  */
 typedef struct {
     _z_keyexpr_t keyexpr;
@@ -168,6 +180,7 @@ typedef struct {
     _z_timestamp_t timestamp;
     _z_encoding_t encoding;
     z_sample_kind_t kind;
+    _z_rx_batch_t *_batch;
 } _z_sample_t;
 
 /**
@@ -65,6 +65,7 @@ typedef struct {
 #define _z_n_qos_make(express, nodrop, priority) \
     (_z_n_qos_t) { ._val = (((express) << 4) | ((nodrop) << 3) | (priority)) }
 #define _Z_N_QOS_DEFAULT _z_n_qos_make(0, 0, 5)
+#define _z_n_qos_get_priority(qos) ((uint8_t)((qos)._val & 0x07))
 
 // RESPONSE FINAL message flags:
 //      Z Extensions       if Z==1 then Zenoh extensions are present
@@ -170,6 +171,8 @@ typedef struct {
     _z_timestamp_t _timestamp;
     _z_n_qos_t _qos;
     _z_push_body_t _body;
+    // If not empty, the aliased encoding of the message up to its payload, the other fields are then only read locally
+    _z_bytes_t _prefix;
 } _z_n_msg_push_t;
 void _z_n_msg_push_clear(_z_n_msg_push_t *msg);
 
@@ -227,6 +230,7 @@ inline static void _z_msg_free(_z_zenoh_message_t **msg) { _z_n_msg_free(msg); }
 _Z_ELEM_DEFINE(_z_network_message, _z_network_message_t, _z_noop_size, _z_n_msg_clear, _z_noop_copy)
 _Z_VEC_DEFINE(_z_network_message, _z_network_message_t)
 
+_z_n_qos_t _z_n_msg_get_qos(const _z_network_message_t *msg);
 void _z_msg_fix_mapping(_z_zenoh_message_t *msg, uint16_t mapping);
 _z_network_message_t _z_msg_make_pull(_z_keyexpr_t key, _z_zint_t pull_id);
 _z_network_message_t _z_msg_make_query(_Z_MOVE(_z_keyexpr_t) key, _Z_MOVE(_z_bytes_t) parameters, _z_zint_t qid,
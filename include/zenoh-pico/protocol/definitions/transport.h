@@ -20,6 +20,7 @@
 
 #include "zenoh-pico/link/endpoint.h"
 #include "zenoh-pico/protocol/definitions/network.h"
+#include "zenoh-pico/protocol/iobuf.h"
 
 #define _Z_MID_SCOUT 0x01
 #define _Z_MID_HELLO 0x02
@@ -33,6 +34,7 @@
 #define _Z_MID_T_FRAME 0x05
 #define _Z_MID_T_FRAGMENT 0x06
 #define _Z_MID_T_JOIN 0x07
+#define _Z_MID_T_ACK_NACK 0x08
 
 /*=============================*/
 /*        Message flags        */
@@ -87,6 +89,13 @@
 //      Z Extensions       if Z==1 then Zenoh extensions are present
 #define _Z_FLAG_T_CLOSE_S 0x20  // 1 << 5
 
+// AckNack message flags:
+//      N Nack             if N==1 then the message is a NACK with a mask of missing SNs, otherwise an ACK
+//      I ZenohID          if I==1 then the ZenohID of the node asked to retransmit is present
+//      Z Extensions       if Z==1 then Zenoh extensions are present
+#define _Z_FLAG_T_ACK_NACK_N 0x20  // 1 << 5
+#define _Z_FLAG_T_ACK_NACK_I 0x40  // 1 << 6
+
 /*=============================*/
 /*     Transport Messages      */
 /*=============================*/
@@ -211,6 +220,9 @@ void _z_s_msg_hello_clear(_z_s_msg_hello_t *msg);
 // (***) if Q==1 then 8 sequence numbers are present: one for each priority.
 //       if Q==0 then only one sequence number is present.
 //
+// The reliability extension (unit, id 0x0A) is present if the sender repairs its reliable conduits, i.e. it keeps its
+// reliable frames and fragments for retransmission and answers the AckNack messages.
+//
 typedef struct {
     _z_zint_t _reliable;
     _z_zint_t _best_effort;
@@ -231,6 +243,7 @@ typedef struct {
     uint8_t _req_id_res;
     uint8_t _seq_num_res;
     uint8_t _version;
+    _Bool _ext_reliability;
 } _z_t_msg_join_t;
 void _z_t_msg_join_clear(_z_t_msg_join_t *msg);
 
@@ -303,6 +316,12 @@ void _z_t_msg_join_clear(_z_t_msg_join_t *msg);
 //
 // ($) Batch Size. It indicates the maximum size of a batch the sender of the
 //
+// The QoS extension (unit, id 0x01) is present if the sender supports one conduit per priority. QoS is used only if
+// both the InitSyn and the InitAck carry it.
+//
+// The reliability extension (unit, id 0x0A) is present if the sender supports the AckNack messages. The reliable
+// conduits are repaired only if both the InitSyn and the InitAck carry it, and the link is not reliable.
+//
 typedef struct {
     _z_id_t _zid;
     _z_bytes_t _cookie;
@@ -311,6 +330,8 @@ typedef struct {
     uint8_t _req_id_res;
     uint8_t _seq_num_res;
     uint8_t _version;
+    _Bool _ext_qos;
+    _Bool _ext_reliability;
 } _z_t_msg_init_t;
 void _z_t_msg_init_clear(_z_t_msg_init_t *msg);
 
@@ -443,9 +464,16 @@ void _z_t_msg_keep_alive_clear(_z_t_msg_keep_alive_t *msg);
 //
 // - if R==1 then the FRAME is sent on the reliable channel, best-effort otherwise.
 //
+// The QoS extension (zint, mandatory, id 0x01) carries the priority of the conduit the FRAME is sent on, it is only
+// present if QoS has been negotiated and the priority is not the default one.
+//
+// When decoded with _z_transport_message_decode_stream, the network messages are not collected in _messages but
+// are left in the decoding buffer referenced by _payload, to be decoded one by one with _z_frame_decode_next.
 typedef struct {
     _z_network_message_vec_t _messages;
+    _z_zbuf_t *_payload;
     _z_zint_t _sn;
+    _z_n_qos_t _ext_qos;
 } _z_t_msg_frame_t;
 void _z_t_msg_frame_clear(_z_t_msg_frame_t *msg);
 
@@ -471,14 +499,52 @@ void _z_t_msg_frame_clear(_z_t_msg_frame_t *msg);
 // ~      [u8]     ~
 // +---------------+
 //
+// The QoS extension is the same as the one of the FRAME message.
+//
 typedef struct {
     _z_bytes_t _payload;
     _z_zint_t _sn;
+    _z_n_qos_t _ext_qos;
 } _z_t_msg_fragment_t;
 void _z_t_msg_fragment_clear(_z_t_msg_fragment_t *msg);
 
 #define _Z_FRAGMENT_HEADER_SIZE 12
 
+/*------------------ AckNack Message ------------------*/
+// The ACK_NACK message is sent on the unreliable links by the receiver of a reliable conduit, to let the sender
+// release the frames and fragments it kept for retransmission, or to ask it to retransmit the missing ones.
+//
+// Flags:
+// - N: Nack           if N==1 then the message is a NACK, otherwise an ACK
+// - I: ZenohID        if I==1 then the ZenohID of the node asked to retransmit is present
+// - Z: Extensions     if Z==1 then zenoh extensions will follow.
+//
+//  7 6 5 4 3 2 1 0
+// +-+-+-+-+-+-+-+-+
+// |Z|I|N| ACKNACK |
+// +-+-+-+---------+
+// %    seq num    % -- ACK: all the SNs up to this one included have been received
+// +---------------+    NACK: the first missing SN
+// %     mask      % if Flag(N)==1 -- bit i is set if the SN seq_num+1+i is missing as well
+// +---------------+
+// |zid_len|x|x|x|x| if Flag(I)==1
+// +-------+-------+
+// ~      [u8]     ~ if Flag(I)==1 -- ZenohID of the node asked to retransmit
+// +---------------+
+// ~ [AckNackExts] ~ if Flag(Z)==1
+// +---------------+
+//
+// The QoS extension is the same as the one of the FRAME message, it selects the conduit of the SNs. On multicast
+// links, a NACK is only answered by the node whose ZenohID it carries, and no ACK is sent.
+//
+typedef struct {
+    _z_id_t _zid;
+    _z_zint_t _sn;
+    _z_zint_t _mask;
+    _z_n_qos_t _ext_qos;
+} _z_t_msg_ack_nack_t;
+void _z_t_msg_ack_nack_clear(_z_t_msg_ack_nack_t *msg);
+
 /*------------------ Transport Message ------------------*/
 typedef union {
     _z_t_msg_join_t _join;
@@ -488,6 +554,7 @@ typedef union {
     _z_t_msg_keep_alive_t _keep_alive;
     _z_t_msg_frame_t _frame;
     _z_t_msg_fragment_t _fragment;
+    _z_t_msg_ack_nack_t _ack_nack;
 } _z_transport_body_t;
 
 typedef struct {
@@ -505,10 +572,16 @@ _z_transport_message_t _z_t_msg_make_open_syn(_z_zint_t lease, _z_zint_t initial
 _z_transport_message_t _z_t_msg_make_open_ack(_z_zint_t lease, _z_zint_t initial_sn);
 _z_transport_message_t _z_t_msg_make_close(uint8_t reason, _Bool link_only);
 _z_transport_message_t _z_t_msg_make_keep_alive(void);
-_z_transport_message_t _z_t_msg_make_frame(_z_zint_t sn, _z_network_message_vec_t messages, _Bool is_reliable);
-_z_transport_message_t _z_t_msg_make_frame_header(_z_zint_t sn, _Bool is_reliable);
-_z_transport_message_t _z_t_msg_make_fragment_header(_z_zint_t sn, _Bool is_reliable, _Bool is_last);
-_z_transport_message_t _z_t_msg_make_fragment(_z_zint_t sn, _z_bytes_t messages, _Bool is_reliable, _Bool is_last);
+_z_transport_message_t _z_t_msg_make_frame(_z_zint_t sn, _z_network_message_vec_t messages, _Bool is_reliable,
+                                           _z_n_qos_t qos);
+_z_transport_message_t _z_t_msg_make_frame_header(_z_zint_t sn, _Bool is_reliable, _z_n_qos_t qos);
+_z_transport_message_t _z_t_msg_make_fragment_header(_z_zint_t sn, _Bool is_reliable, _Bool is_last,
+                                                     _z_n_qos_t qos);
+_z_transport_message_t _z_t_msg_make_fragment(_z_zint_t sn, _z_bytes_t messages, _Bool is_reliable, _Bool is_last,
+                                              _z_n_qos_t qos);
+_z_transport_message_t _z_t_msg_make_ack(_z_zint_t sn, _z_n_qos_t qos);
+// The ZenohID is only carried if it is not empty
+_z_transport_message_t _z_t_msg_make_nack(_z_zint_t sn, _z_zint_t mask, _z_id_t zid, _z_n_qos_t qos);
 
 /*------------------ Copy ------------------*/
 void _z_t_msg_copy(_z_transport_message_t *clone, _z_transport_message_t *msg);
@@ -518,6 +591,7 @@ void _z_t_msg_copy_open(_z_t_msg_open_t *clone, _z_t_msg_open_t *msg);
 void _z_t_msg_copy_close(_z_t_msg_close_t *clone, _z_t_msg_close_t *msg);
 void _z_t_msg_copy_keep_alive(_z_t_msg_keep_alive_t *clone, _z_t_msg_keep_alive_t *msg);
 void _z_t_msg_copy_frame(_z_t_msg_frame_t *clone, _z_t_msg_frame_t *msg);
+void _z_t_msg_copy_ack_nack(_z_t_msg_ack_nack_t *clone, _z_t_msg_ack_nack_t *msg);
 
 typedef union {
     _z_s_msg_scout_t _scout;
@@ -123,10 +123,40 @@ size_t _z_wbuf_len_iosli(const _z_wbuf_t *wbf);
 
 _z_zbuf_t _z_wbuf_to_zbuf(const _z_wbuf_t *wbf);
 int8_t _z_wbuf_siphon(_z_wbuf_t *dst, _z_wbuf_t *src, size_t length);
+/// Moves `length` bytes from `src` to `dst` without copying them, `src` must outlive the content of `dst`
+int8_t _z_wbuf_siphon_ref(_z_wbuf_t *dst, _z_wbuf_t *src, size_t length);
 
 void _z_wbuf_copy(_z_wbuf_t *dst, const _z_wbuf_t *src);
 void _z_wbuf_reset(_z_wbuf_t *wbf);
 void _z_wbuf_clear(_z_wbuf_t *wbf);
 void _z_wbuf_free(_z_wbuf_t **wbf);
 
+/*------------------ DBuf ------------------*/
+/**
+ * A contiguous defragmentation buffer. Fragments are appended at their final position, so the reassembled
+ * message can be decoded in place without being copied again. An expandable buffer grows geometrically and
+ * keeps its capacity across messages, a non-expandable one is preallocated at its maximum size.
+ */
+typedef struct {
+    _z_iosli_t _ios;
+    size_t _max;
+    _Bool _is_expandable;
+    _Bool _is_overflow;
+} _z_dbuf_t;
+
+_z_dbuf_t _z_dbuf_make(size_t capacity, size_t max, _Bool is_expandable);
+
+size_t _z_dbuf_capacity(const _z_dbuf_t *dbf);
+size_t _z_dbuf_len(const _z_dbuf_t *dbf);
+_Bool _z_dbuf_is_overflow(const _z_dbuf_t *dbf);
+
+/// Appends a fragment, the buffer is marked as overflowed if the message would exceed its maximum size
+int8_t _z_dbuf_write_bytes(_z_dbuf_t *dbf, const uint8_t *bs, size_t length);
+/// Constructs a _borrowing_ reader on the reassembled message
+_z_zbuf_t _z_dbuf_as_zbuf(const _z_dbuf_t *dbf);
+
+void _z_dbuf_copy(_z_dbuf_t *dst, const _z_dbuf_t *src);
+void _z_dbuf_reset(_z_dbuf_t *dbf);
+void _z_dbuf_clear(_z_dbuf_t *dbf);
+
 #endif /* ZENOH_PICO_PROTOCOL_IOBUF_H */
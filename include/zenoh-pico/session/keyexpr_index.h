@@ -0,0 +1,78 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_SESSION_KEYEXPR_INDEX_H
+#define ZENOH_PICO_SESSION_KEYEXPR_INDEX_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#define _Z_KEYEXPR_INDEX_DEFAULT_CAPACITY 16
+#define _Z_KEYEXPR_INDEX_MATCH_INLINE_SIZE 8  // Number of matches collected without allocation
+
+/**
+ * An entry of a key expression index.
+ *
+ * Members:
+ *   _next: the next entry in the same bucket (or in the wildcard side-table)
+ *   _key: the key expression of the entry, owned by the indexed value
+ *   _len: the length of the key expression
+ *   _hash: the hash of the key expression
+ *   _val: the indexed value
+ */
+typedef struct _z_keyexpr_index_entry_t {
+    struct _z_keyexpr_index_entry_t *_next;
+    const char *_key;
+    size_t _len;
+    size_t _hash;
+    void *_val;
+} _z_keyexpr_index_entry_t;
+
+/**
+ * An index of values by key expression.
+ *
+ * Key expressions without wildcards are stored in a hash table where they are matched by equality,
+ * while key expressions containing ``*``, ``**`` or ``$*`` are stored in a side-table where they are matched
+ * by intersection.
+ *
+ * Members:
+ *   _buckets: the hash table of the non-wild key expressions
+ *   _wild: the side-table of the wild key expressions
+ *   _capacity: the number of buckets of the hash table
+ *   _len: the number of non-wild key expressions in the hash table
+ */
+typedef struct {
+    _z_keyexpr_index_entry_t **_buckets;
+    _z_keyexpr_index_entry_t *_wild;
+    size_t _capacity;
+    size_t _len;
+} _z_keyexpr_index_t;
+
+/**
+ * The callback invoked for each value matching a key expression. Returning ``false`` stops the iteration.
+ */
+typedef _Bool (*_z_keyexpr_index_visit_f)(void *val, void *arg);
+
+void _z_keyexpr_index_init(_z_keyexpr_index_t *idx);
+_Bool _z_keyexpr_is_wild(const char *key, size_t len);
+
+int8_t _z_keyexpr_index_insert(_z_keyexpr_index_t *idx, const char *key, void *val);
+void _z_keyexpr_index_remove(_z_keyexpr_index_t *idx, const char *key, const void *val);
+size_t _z_keyexpr_index_match(const _z_keyexpr_index_t *idx, const char *key, size_t len,
+                              _z_keyexpr_index_visit_f visit, void *arg);
+
+void _z_keyexpr_index_clear(_z_keyexpr_index_t *idx);
+
+#endif /* ZENOH_PICO_SESSION_KEYEXPR_INDEX_H */
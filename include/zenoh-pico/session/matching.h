@@ -0,0 +1,36 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_SESSION_MATCHING_H
+#define ZENOH_PICO_SESSION_MATCHING_H
+
+#include "zenoh-pico/net/publish.h"
+#include "zenoh-pico/net/session.h"
+#include "zenoh-pico/protocol/definitions/declarations.h"
+
+#if Z_FEATURE_MATCHING == 1
+/*------------------ Remote subscriptions ------------------*/
+int8_t _z_register_remote_subscription(_z_session_t *zn, uint16_t mapping, const _z_decl_subscriber_t *decl);
+void _z_unregister_remote_subscription(_z_session_t *zn, uint16_t mapping, uint32_t id);
+void _z_unregister_remote_subscriptions_for_peer(_z_session_t *zn, uint16_t mapping);
+
+/*------------------ Matching ------------------*/
+_Bool _z_publisher_is_matching(_z_publisher_t *pub);
+_z_matching_sptr_t *_z_get_matching_by_id(_z_session_t *zn, const _z_zint_t id);
+_z_matching_sptr_t *_z_register_matching(_z_session_t *zn, _z_matching_t *m);
+void _z_unregister_matching(_z_session_t *zn, _z_matching_sptr_t *m);
+void _z_flush_matching(_z_session_t *zn);
+#endif
+
+#endif /* ZENOH_PICO_SESSION_MATCHING_H */
@@ -24,13 +24,29 @@ _z_zint_t _z_get_query_id(_z_session_t *zn);
 
 _z_pending_query_t *_z_get_pending_query_by_id(_z_session_t *zn, const _z_zint_t id);
 
-int8_t _z_register_pending_query(_z_session_t *zn, _z_pending_query_t *pq);
+/**
+ * Register a pending query. A ``timeout_ms`` of 0 means the query never expires, otherwise the query is expired by
+ * :c:func:`_z_process_query_timeouts` once the timeout elapsed without a final reply.
+ */
+int8_t _z_register_pending_query(_z_session_t *zn, _z_pending_query_t *pq, uint32_t timeout_ms);
 int8_t _z_trigger_query_reply_partial(_z_session_t *zn, _z_zint_t reply_context, const _z_keyexpr_t keyexpr,
                                       const _z_bytes_t payload, const _z_encoding_t encoding, const _z_zint_t kind,
                                       const _z_timestamp_t timestamp);
 int8_t _z_trigger_query_reply_final(_z_session_t *zn, _z_zint_t id);
 void _z_unregister_pending_query(_z_session_t *zn, _z_pending_query_t *pq);
 void _z_flush_pending_queries(_z_session_t *zn);
+
+/*------------------ Query timeouts ------------------*/
+/**
+ * Expire the pending queries whose deadline has passed: each of them receives an error reply and is then dropped,
+ * as if a final reply had been received. Driven by the lease task, or by ``zp_read`` in single-thread builds.
+ */
+void _z_process_query_timeouts(_z_session_t *zn);
+
+/**
+ * Return the time in milliseconds until the next pending query deadline, bounded by ``interval``.
+ */
+_z_zint_t _z_get_next_query_timeout(_z_session_t *zn, _z_zint_t interval);
 #endif
 
 #endif /* ZENOH_PICO_SESSION_QUERY_H */
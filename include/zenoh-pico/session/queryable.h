@@ -28,7 +28,8 @@ _z_questionable_sptr_t *_z_get_questionable_by_id(_z_session_t *zn, const _z_zin
 _z_questionable_sptr_list_t *_z_get_questionable_by_key(_z_session_t *zn, const _z_keyexpr_t key);
 
 _z_questionable_sptr_t *_z_register_questionable(_z_session_t *zn, _z_questionable_t *q);
-int8_t _z_trigger_queryables(_z_session_t *zn, const _z_msg_query_t *query, const _z_keyexpr_t q_key, uint32_t qid);
+int8_t _z_trigger_queryables(_z_session_t *zn, const _z_msg_query_t *query, const _z_keyexpr_t q_key, uint32_t qid,
+                             uint16_t mapping);
 void _z_unregister_questionable(_z_session_t *zn, _z_questionable_sptr_t *q);
 void _z_flush_questionables(_z_session_t *zn);
 #endif
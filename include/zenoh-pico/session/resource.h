@@ -30,10 +30,21 @@ _z_keyexpr_t _z_get_expanded_key_from_key(_z_session_t *zn, const _z_keyexpr_t *
 int16_t _z_register_resource(_z_session_t *zn, const _z_keyexpr_t key, uint16_t id, uint16_t register_to_mapping);
 void _z_unregister_resource(_z_session_t *zn, uint16_t id, uint16_t mapping);
 void _z_unregister_resources_for_peer(_z_session_t *zn, uint16_t mapping);
+/**
+ * Returns the key expression to send a message with. A local resource id is only used once its declaration has been
+ * repeated to the multicast peers, the expanded key is used before. The returned key expression must be cleared.
+ */
+_z_keyexpr_t _z_get_wire_key_from_key(_z_session_t *zn, const _z_keyexpr_t *keyexpr);
+// A new multicast peer may not know the local resources, their ids are not used until they are declared again
+void _z_reset_resource_declarations(_z_session_t *zn);
+// Sends again the declarations of all the local resources, so that late-joining multicast peers learn their ids
+int8_t _z_send_resource_declarations(_z_session_t *zn, _z_transport_multicast_t *ztm);
 void _z_flush_resources(_z_session_t *zn);
 
 _z_keyexpr_t __unsafe_z_get_expanded_key_from_key(_z_session_t *zn, const _z_keyexpr_t *keyexpr);
 _z_resource_t *__unsafe_z_get_resource_by_id(_z_session_t *zn, uint16_t mapping, _z_zint_t id);
 _z_resource_t *__unsafe_z_get_resource_matching_key(_z_session_t *zn, const _z_keyexpr_t *keyexpr);
+_z_resource_t *__unsafe_z_get_cached_resource(_z_session_t *zn, const _z_keyexpr_t *keyexpr);
+void __unsafe_z_clear_resources_cache(_z_session_t *zn);
 
 #endif /* INCLUDE_ZENOH_PICO_SESSION_RESOURCE_H */
@@ -25,6 +25,7 @@
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/net/query.h"
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/protocol/keyexpr.h"
 #include "zenoh-pico/transport/manager.h"
 
 /**
@@ -60,7 +61,7 @@ _Z_ARRAY_DEFINE(_z_reply_data, _z_reply_data_t)
  * Members:
  *   _z_reply_t_Tag tag: Indicates if the reply contains data or if it's a FINAL reply.
  *   _z_reply_data_t data: The reply data if :c:member:`_z_reply_t.tag` equals
- * :c:member:`_z_reply_t_Tag.Z_REPLY_TAG_DATA`.
+ * :c:member:`_z_reply_t_Tag.Z_REPLY_TAG_DATA`, or the error if it equals :c:member:`_z_reply_t_Tag.Z_REPLY_TAG_ERROR`.
  *
  */
 typedef struct {
@@ -70,19 +71,6 @@ typedef struct {
 void _z_reply_clear(_z_reply_t *src);
 void _z_reply_free(_z_reply_t **hello);
 
-typedef struct {
-    _z_keyexpr_t _key;
-    uint16_t _id;
-    uint16_t _refcount;
-} _z_resource_t;
-
-_Bool _z_resource_eq(const _z_resource_t *one, const _z_resource_t *two);
-void _z_resource_clear(_z_resource_t *res);
-void _z_resource_free(_z_resource_t **res);
-
-_Z_ELEM_DEFINE(_z_resource, _z_resource_t, _z_noop_size, _z_resource_clear, _z_noop_copy)
-_Z_LIST_DEFINE(_z_resource, _z_resource_t)
-
 /**
  * The callback signature of the functions handling data messages.
  */
@@ -111,6 +99,37 @@ typedef struct {
     uint32_t _id;
 } _z_publication_t;
 
+/**
+ * The matching status of a publisher.
+ *
+ * Members:
+ *   _Bool matching: ``true`` if at least one remote subscriber matches the key expression of the publisher.
+ */
+typedef struct {
+    _Bool matching;
+} _z_matching_status_t;
+
+/**
+ * The callback signature of the functions handling matching status changes.
+ */
+typedef void (*_z_matching_status_handler_t)(const _z_matching_status_t *status, void *arg);
+
+typedef struct {
+    _z_keyexpr_t _key;
+    uint32_t _id;
+    _z_matching_status_handler_t _callback;
+    _z_drop_handler_t _dropper;
+    void *_arg;
+    _Bool _matching;
+} _z_matching_t;
+
+_Bool _z_matching_eq(const _z_matching_t *one, const _z_matching_t *two);
+void _z_matching_clear(_z_matching_t *matching);
+
+_Z_POINTER_DEFINE(_z_matching, _z_matching)
+_Z_ELEM_DEFINE(_z_matching_sptr, _z_matching_sptr_t, _z_noop_size, _z_matching_sptr_drop, _z_noop_copy)
+_Z_LIST_DEFINE(_z_matching_sptr, _z_matching_sptr_t)
+
 /**
  * The callback signature of the functions handling query messages.
  */
@@ -133,6 +152,68 @@ _Z_ELEM_DEFINE(_z_questionable, _z_questionable_t, _z_noop_size, _z_questionable
 _Z_ELEM_DEFINE(_z_questionable_sptr, _z_questionable_sptr_t, _z_noop_size, _z_questionable_sptr_drop, _z_noop_copy)
 _Z_LIST_DEFINE(_z_questionable_sptr, _z_questionable_sptr_t)
 
+_Z_POINTER_DEFINE(_z_keyexpr, _z_keyexpr)
+
+typedef struct {
+    _z_keyexpr_t _key;
+    uint16_t _id;
+    uint16_t _refcount;
+    _Bool _announced;  // For a local resource, whether its declaration was repeated since the last peer joined
+
+    // Cache of the resolved key expression and of its matching local subscriptions, they are
+    // invalidated whenever a resource or a subscription is (un)registered in the session
+    _z_keyexpr_sptr_t _expanded;
+#if Z_FEATURE_SUBSCRIPTION == 1
+    _z_subscription_sptr_t **_subs;
+    size_t _subs_len;
+    _Bool _subs_cached;
+#endif
+} _z_resource_t;
+
+_Bool _z_resource_eq(const _z_resource_t *one, const _z_resource_t *two);
+void _z_resource_clear(_z_resource_t *res);
+void _z_resource_free(_z_resource_t **res);
+void _z_resource_clear_cache(_z_resource_t *res);
+
+_Z_ELEM_DEFINE(_z_resource, _z_resource_t, _z_noop_size, _z_resource_clear, _z_noop_copy)
+_Z_LIST_DEFINE(_z_resource, _z_resource_t)
+
+#define _Z_RESOURCE_TABLE_DEFAULT_CAPACITY 16
+
+/**
+ * A slot of a :c:type:`_z_resource_table_t`.
+ *
+ * Members:
+ *   _hash: the hash of the key the resource is stored under
+ *   _res: the resource, or NULL if the slot is empty
+ */
+typedef struct {
+    size_t _hash;
+    _z_resource_t *_res;
+} _z_resource_slot_t;
+
+/**
+ * A flat open-addressing hash table of resources, using linear probing.
+ *
+ * Resources are indexed both by (mapping, id) and by (mapping, prefix id, suffix). The id slots store the
+ * (mapping, id) pair itself as hash, so lookups by id never dereference a resource that does not match.
+ *
+ * Members:
+ *   _by_id: the slots indexed by (mapping, id)
+ *   _by_key: the slots indexed by (mapping, prefix id, suffix)
+ *   _capacity: the number of slots of each index, always a power of two
+ *   _len: the number of resources in the table
+ */
+typedef struct {
+    _z_resource_slot_t *_by_id;
+    _z_resource_slot_t *_by_key;
+    size_t _capacity;
+    size_t _len;
+} _z_resource_table_t;
+
+void _z_resource_table_init(_z_resource_table_t *table);
+void _z_resource_table_clear(_z_resource_table_t *table);
+
 typedef struct {
     _z_reply_t _reply;
     _z_timestamp_t _tstamp;
@@ -162,6 +243,9 @@ typedef struct {
     z_query_target_t _target;
     z_consolidation_mode_t _consolidation;
     _Bool _anykey;
+    _Bool _in_callback;       // Set while a reply callback runs outside of the session mutex, delays the expiry
+    unsigned long _deadline;  // Expressed in milliseconds since the creation of the session
+    size_t _timeout_idx;      // Position in the timeouts heap, _Z_PENDING_QUERY_NO_TIMEOUT if it never expires
 } _z_pending_query_t;
 
 _Bool _z_pending_query_eq(const _z_pending_query_t *one, const _z_pending_query_t *two);
@@ -170,6 +254,35 @@ void _z_pending_query_clear(_z_pending_query_t *res);
 _Z_ELEM_DEFINE(_z_pending_query, _z_pending_query_t, _z_noop_size, _z_pending_query_clear, _z_noop_copy)
 _Z_LIST_DEFINE(_z_pending_query, _z_pending_query_t)
 
+#define _Z_PENDING_QUERY_TABLE_DEFAULT_CAPACITY 8
+#define _Z_PENDING_QUERY_NO_TIMEOUT SIZE_MAX
+
+/**
+ * The pending queries of a session, indexed by query id and ordered by deadline.
+ *
+ * Query ids are allocated sequentially, so they are used as their own hash in a flat open-addressing table with
+ * linear probing. The queries that may expire are also kept in a binary min-heap ordered by deadline.
+ *
+ * Members:
+ *   _by_id: the slots of the table indexed by query id, NULL if the slot is empty. The table owns the queries.
+ *   _capacity: the number of slots of the table, always a power of two
+ *   _len: the number of pending queries
+ *   _timeouts: the min-heap of the pending queries that may expire
+ *   _timeouts_len: the number of pending queries in the heap
+ *   _timeouts_capacity: the number of pending queries the heap can hold without reallocation
+ */
+typedef struct {
+    _z_pending_query_t **_by_id;
+    size_t _capacity;
+    size_t _len;
+    _z_pending_query_t **_timeouts;
+    size_t _timeouts_len;
+    size_t _timeouts_capacity;
+} _z_pending_query_table_t;
+
+void _z_pending_query_table_init(_z_pending_query_table_t *table);
+void _z_pending_query_table_clear(_z_pending_query_table_t *table);
+
 typedef struct {
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_t _mutex;
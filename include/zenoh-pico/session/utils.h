@@ -27,12 +27,28 @@ _z_hello_list_t *_z_scout_inner(const z_what_t what, _z_id_t id, const char *loc
                                 const _Bool exit_on_first);
 
 int8_t _z_session_init(_z_session_t *zn, _z_id_t *zid);
+// The transports of the session, the first one being _tp
+size_t _z_session_transports_len(const _z_session_t *zn);
+_z_transport_t *_z_session_transport(_z_session_t *zn, size_t i);
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+// Opens another transport on the given locator, Z_TRANSPORTS_MAX at most
+int8_t _z_session_open_transport(_z_session_t *zn, char *locator, z_whatami_t mode);
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+#if Z_FEATURE_STATS == 1
+// Takes a snapshot of the counters of the session and of its transports
+void _z_session_stats(_z_session_t *zn, _z_stats_t *stats);
+#endif  // Z_FEATURE_STATS == 1
 int8_t _z_session_close(_z_session_t *zn, uint8_t reason);
 void _z_session_clear(_z_session_t *zn);
 void _z_session_free(_z_session_t **zn);
 
-int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *z_msg, uint16_t local_peer_id);
-int8_t _z_send_n_msg(_z_session_t *zn, _z_network_message_t *n_msg, z_reliability_t reliability,
+// The payloads of the message may lie in the RX batch, NULL if the message was not decoded from a transport batch
+int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *z_msg, uint16_t local_peer_id,
+                                 _z_rx_batch_t *batch);
+int8_t _z_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg, z_reliability_t reliability,
                      z_congestion_control_t cong_ctrl);
+// Sends the message back on the transport of the remote node with the given mapping, e.g. the responses to its requests
+int8_t _z_send_n_msg_to(_z_session_t *zn, uint16_t mapping, const _z_network_message_t *n_msg,
+                        z_reliability_t reliability, z_congestion_control_t cong_ctrl);
 
 #endif /* INCLUDE_ZENOH_PICO_SESSION_UTILS_H */
@@ -17,6 +17,7 @@
 
 #include <stdint.h>
 
+#include "zenoh-pico/collections/bytes.h"
 #include "zenoh-pico/collections/string.h"
 #include "zenoh-pico/system/platform.h"
 
@@ -40,6 +41,18 @@ size_t _z_read_exact_udp_unicast(const _z_sys_net_socket_t sock, uint8_t *ptr, s
 size_t _z_read_udp_unicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_t len);
 size_t _z_send_udp_unicast(const _z_sys_net_socket_t sock, const uint8_t *ptr, size_t len,
                            const _z_sys_net_endpoint_t rep);
+#ifdef _Z_SYS_NET_SEND_VEC_MAX
+size_t _z_send_vec_udp_unicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                               const _z_sys_net_endpoint_t rep);
+#endif
+#ifdef _Z_SYS_NET_BATCH_MAX
+// Up to count datagrams are received in slots of stride bytes from ptr, their lengths are 0 if they were dropped
+size_t _z_read_batch_udp_unicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_t stride, size_t count,
+                                 size_t *lens);
+// Each buffer is sent as a datagram, returns the number of datagrams sent
+size_t _z_send_batch_udp_unicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                                 const _z_sys_net_endpoint_t rep);
+#endif
 
 // Multicast
 int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoint_t rep, _z_sys_net_endpoint_t *lep,
@@ -54,6 +67,16 @@ size_t _z_read_udp_multicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_
                              _z_bytes_t *ep);
 size_t _z_send_udp_multicast(const _z_sys_net_socket_t sock, const uint8_t *ptr, size_t len,
                              const _z_sys_net_endpoint_t rep);
+#ifdef _Z_SYS_NET_SEND_VEC_MAX
+size_t _z_send_vec_udp_multicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                                 const _z_sys_net_endpoint_t rep);
+#endif
+#ifdef _Z_SYS_NET_BATCH_MAX
+size_t _z_read_batch_udp_multicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_t stride, size_t count,
+                                   size_t *lens, const _z_sys_net_endpoint_t lep, _z_bytes_t *addrs);
+size_t _z_send_batch_udp_multicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                                   const _z_sys_net_endpoint_t rep);
+#endif
 #endif
 
 #endif /* ZENOH_PICO_SYSTEM_LINK_UDP_H */
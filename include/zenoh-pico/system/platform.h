@@ -54,10 +54,16 @@ uint64_t zp_random_u64(void);
 void zp_random_fill(void *buf, size_t len);
 
 /*------------------ Memory ------------------*/
+// Served by the memory pool when enabled, by the platform allocator otherwise
 void *zp_malloc(size_t size);
 void *zp_realloc(void *ptr, size_t size);
 void zp_free(void *ptr);
 
+// Platform allocator
+void *zp_sys_malloc(size_t size);
+void *zp_sys_realloc(void *ptr, size_t size);
+void zp_sys_free(void *ptr);
+
 #if Z_FEATURE_MULTI_THREAD == 1
 /*------------------ Thread ------------------*/
 int8_t zp_task_init(zp_task_t *task, zp_task_attr_t *attr, void *(*fun)(void *), void *arg);
@@ -99,6 +105,30 @@ unsigned long zp_time_elapsed_us(zp_time_t *time);
 unsigned long zp_time_elapsed_ms(zp_time_t *time);
 unsigned long zp_time_elapsed_s(zp_time_t *time);
 
+#ifdef _Z_SYS_NET_POLL
+/*------------------ Poll ------------------*/
+/**
+ * A socket reported by :c:func:`_z_poll_wait`.
+ *
+ *  Members:
+ *   void *arg: The argument the socket was registered with.
+ *   _Bool hangup: Whether the peer closed the connection or the socket failed.
+ */
+typedef struct {
+    void *arg;
+    _Bool hangup;
+} _z_sys_net_poll_event_t;
+
+int8_t _z_poll_init(_z_sys_net_poll_t *poll);
+void _z_poll_clear(_z_sys_net_poll_t *poll);
+// The socket is reported once when readable, then it must be re-armed to be reported again
+int8_t _z_poll_add(_z_sys_net_poll_t *poll, const _z_sys_net_socket_t *sock, void *arg);
+int8_t _z_poll_rearm(_z_sys_net_poll_t *poll, const _z_sys_net_socket_t *sock, void *arg);
+int8_t _z_poll_remove(_z_sys_net_poll_t *poll, const _z_sys_net_socket_t *sock);
+// Waits up to timeout milliseconds for readable sockets, returns the number of events written
+size_t _z_poll_wait(_z_sys_net_poll_t *poll, _z_sys_net_poll_event_t *events, size_t max, uint32_t timeout);
+#endif
+
 #ifdef __cplusplus
 }
 #endif
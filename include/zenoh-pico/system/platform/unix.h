@@ -31,6 +31,15 @@ typedef pthread_mutex_t zp_mutex_t;
 typedef pthread_cond_t zp_condvar_t;
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+// Vectored sends are supported, gathering up to this number of buffers in a single system call
+#define _Z_SYS_NET_SEND_VEC_MAX 16
+
+#if defined(ZENOH_LINUX) && Z_FEATURE_UDP_BATCH_IO == 1 && \
+    (Z_FEATURE_LINK_UDP_UNICAST == 1 || Z_FEATURE_LINK_UDP_MULTICAST == 1)
+// Datagrams are moved in batches, up to this number in a single system call
+#define _Z_SYS_NET_BATCH_MAX Z_UDP_BATCH_IO_SIZE
+#endif
+
 typedef struct timespec zp_clock_t;
 typedef struct timeval zp_time_t;
 
@@ -43,6 +52,16 @@ typedef struct {
     };
 } _z_sys_net_socket_t;
 
+#if defined(ZENOH_LINUX) && (Z_FEATURE_LINK_TCP == 1 || Z_FEATURE_LINK_UDP_MULTICAST == 1 || \
+                              Z_FEATURE_LINK_UDP_UNICAST == 1 || Z_FEATURE_RAWETH_TRANSPORT == 1)
+// Sockets can be waited for together, with epoll
+#define _Z_SYS_NET_POLL
+
+typedef struct {
+    int _fd;
+} _z_sys_net_poll_t;
+#endif
+
 typedef struct {
     union {
 #if Z_FEATURE_LINK_TCP == 1 || Z_FEATURE_LINK_UDP_MULTICAST == 1 || Z_FEATURE_LINK_UDP_UNICAST == 1
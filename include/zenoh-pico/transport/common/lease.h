@@ -19,5 +19,8 @@
 
 int8_t _z_send_join(_z_transport_t *zt);
 int8_t _z_send_keep_alive(_z_transport_t *zt);
+// Drive the lease of a transport without lease task, see _zp_unicast_lease_step and _zp_multicast_lease_step
+void _z_lease_start(_z_transport_t *zt);
+int8_t _z_lease_step(_z_transport_t *zt, _z_zint_t *interval);
 
 #endif /* ZENOH_PICO_TRANSPORT_LEASE_H */
@@ -18,6 +18,8 @@
 #include "zenoh-pico/transport/transport.h"
 
 int8_t _z_read(_z_transport_t *zt);
+// Whether the RX buffer already holds a whole batch, that _z_read decodes without reading the link
+_Bool _z_read_pending(const _z_transport_t *zt);
 void *_zp_read_task(void *zt_arg);  // The argument is void* to avoid incompatible pointer types in tasks
 
 #endif /* ZENOH_PICO_TRANSPORT_READ_H */
@@ -0,0 +1,163 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TRANSPORT_RELIABILITY_H
+#define ZENOH_PICO_TRANSPORT_RELIABILITY_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/config.h"
+#include "zenoh-pico/link/link.h"
+#include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/protocol/definitions/transport.h"
+#include "zenoh-pico/protocol/iobuf.h"
+
+#if Z_FEATURE_RELIABILITY == 1
+
+#if Z_RELIABILITY_WINDOW_SIZE < 1
+#error "Z_RELIABILITY_WINDOW_SIZE must be at least 1"
+#endif
+#if (Z_RELIABILITY_REORDER_SIZE < 1) || (Z_RELIABILITY_REORDER_SIZE > 64)
+#error "Z_RELIABILITY_REORDER_SIZE must be between 1 and 64"
+#endif
+
+// Number of reliable frames and fragments a unicast receiver delivers before acknowledging them
+#define _Z_RELIABILITY_ACK_THRESHOLD ((Z_RELIABILITY_WINDOW_SIZE + 1) / 2)
+
+/*------------------ TX ------------------*/
+/**
+ * A reliable frame or fragment kept for retransmission, as it was sent on the link.
+ *
+ *  Members:
+ *   uint8_t *_buf: The bytes sent on the link, kept allocated once the slot is released.
+ *   size_t _len: The number of bytes sent on the link.
+ *   size_t _capacity: The size of the buffer.
+ *   _z_zint_t _sn: The SN of the frame or fragment.
+ *   _z_zint_t _sent: The time of its last transmission, in milliseconds on the lease clock of the transport.
+ *   _Bool _is_used: Whether the slot holds a frame or fragment not acknowledged yet.
+ */
+typedef struct {
+    uint8_t *_buf;
+    size_t _len;
+    size_t _capacity;
+    _z_zint_t _sn;
+    _z_zint_t _sent;
+    _Bool _is_used;
+} _z_reliability_slot_t;
+
+/**
+ * The retransmission window of the reliable conduit of a lane.
+ *
+ * The frames and fragments are indexed by SN modulo the size of the window, so that it holds the last
+ * Z_RELIABILITY_WINDOW_SIZE ones: once full, the oldest one is evicted and can no longer be retransmitted.
+ */
+typedef struct {
+    _z_reliability_slot_t _slots[Z_RELIABILITY_WINDOW_SIZE];
+} _z_reliability_window_t;
+
+// Makes num empty windows, NULL if they cannot be allocated
+_z_reliability_window_t *_z_reliability_windows_make(size_t num);
+void _z_reliability_windows_free(_z_reliability_window_t **windows, size_t num);
+
+/**
+ * Keeps a copy of a finalized batch if it holds a reliable frame or fragment, the other batches are ignored.
+ */
+int8_t _z_reliability_window_push(_z_reliability_window_t *w, const _z_wbuf_t *wbf, uint8_t link_flow,
+                                  _z_zint_t now);
+// Releases the frames and fragments up to the given SN included
+void _z_reliability_window_ack(_z_reliability_window_t *w, _z_zint_t sn_res, _z_zint_t sn);
+/**
+ * Retransmits the frame or fragment of the given SN, and the ones whose bit is set in the mask: bit i stands for
+ * the SN sn + 1 + i. The ones that already left the window are skipped.
+ */
+int8_t _z_reliability_window_resend(_z_reliability_window_t *w, const _z_link_t *zl, _z_zint_t sn_res, _z_zint_t sn,
+                                    _z_zint_t mask, _z_zint_t now);
+// Retransmits the frames and fragments that have not been acknowledged for rto milliseconds
+int8_t _z_reliability_window_resend_expired(_z_reliability_window_t *w, const _z_link_t *zl, _z_zint_t now,
+                                            _z_zint_t rto);
+
+/*------------------ RX ------------------*/
+/**
+ * A reliable frame or fragment received after a missing one, with a copy of the bytes that follow its header.
+ *
+ *  Members:
+ *   uint8_t *_buf: The network messages of the frame, or the payload of the fragment.
+ *   size_t _len: The number of bytes of the buffer.
+ *   _z_zint_t _sn: The SN of the frame or fragment.
+ *   _z_n_qos_t _qos: The QoS extension of the frame or fragment.
+ *   uint8_t _header: The header of the frame or fragment.
+ *   _Bool _is_used: Whether the slot holds a frame or fragment.
+ */
+typedef struct {
+    uint8_t *_buf;
+    size_t _len;
+    _z_zint_t _sn;
+    _z_n_qos_t _qos;
+    uint8_t _header;
+    _Bool _is_used;
+} _z_reliability_pending_t;
+
+/**
+ * The reorder buffer of the reliable conduit of a remote node.
+ *
+ * The frames and fragments received after a missing one are indexed by SN modulo the size of the buffer, until the
+ * missing ones are retransmitted. The missing ones are given up once a frame or fragment does not fit in the buffer.
+ *
+ *  Members:
+ *   _z_reliability_pending_t _slots[Z_RELIABILITY_REORDER_SIZE]: The buffered frames and fragments.
+ *   size_t _len: The number of buffered frames and fragments.
+ *   _z_zint_t _high: The highest buffered SN, valid if _len is not 0.
+ *   size_t _unacked: The number of frames and fragments received since the last acknowledgment.
+ */
+typedef struct {
+    _z_reliability_pending_t _slots[Z_RELIABILITY_REORDER_SIZE];
+    size_t _len;
+    _z_zint_t _high;
+    size_t _unacked;
+} _z_reliability_reorder_t;
+
+// Makes num empty reorder buffers, NULL if they cannot be allocated
+_z_reliability_reorder_t *_z_reliability_reorders_make(size_t num);
+void _z_reliability_reorders_free(_z_reliability_reorder_t **reorders, size_t num);
+// Drops the buffered frames and fragments
+void _z_reliability_reorder_reset(_z_reliability_reorder_t *r);
+
+/**
+ * Delivers a frame or fragment to the transport. The message is NULL to report that missing frames or fragments have
+ * been given up. A buffered frame or fragment is delivered from a copy, is_copy is then true.
+ */
+typedef int8_t (*_z_reliability_deliver_f)(void *arg, _z_transport_message_t *t_msg, _Bool is_copy);
+
+/**
+ * Delivers a reliable frame or fragment in SN order, last being the SN of the last delivered one. A message received
+ * after a missing one is buffered, and the missing ones are returned in sn and mask, as for a NACK, when it opens a
+ * new gap. A duplicate is dropped. The messages that are not delivered right away are consumed from the RX buffer.
+ *
+ * Returns whether a NACK has to be sent.
+ */
+_Bool _z_reliability_reorder_recv(_z_reliability_reorder_t *r, _z_zint_t sn_res, _z_zint_t *last,
+                                  _z_transport_message_t *t_msg, _z_reliability_deliver_f deliver, void *arg,
+                                  _z_zint_t *sn, _z_zint_t *mask);
+/**
+ * Returns whether frames or fragments are missing up to the given SN included, their SNs are then returned in sn
+ * and mask, as for a NACK.
+ */
+_Bool _z_reliability_reorder_missing(const _z_reliability_reorder_t *r, _z_zint_t sn_res, _z_zint_t last,
+                                     _z_zint_t upto, _z_zint_t *sn, _z_zint_t *mask);
+
+#endif  // Z_FEATURE_RELIABILITY == 1
+
+#endif /* ZENOH_PICO_TRANSPORT_RELIABILITY_H */
@@ -0,0 +1,107 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TRANSPORT_RX_POOL_H
+#define ZENOH_PICO_TRANSPORT_RX_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/collections/atomic.h"
+#include "zenoh-pico/config.h"
+#include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/protocol/iobuf.h"
+
+#if Z_RX_POOL_SIZE < 1
+#error "Z_RX_POOL_SIZE must be at least 1"
+#endif
+
+typedef struct _z_rx_pool_t _z_rx_pool_t;
+
+/**
+ * A reference counted buffer the transport reads its batches into.
+ *
+ * The transport holds a reference on the batch it reads into, and each retained payload holds another one. A batch
+ * is only written by the transport, and only while it holds its sole reference.
+ *
+ *  Members:
+ *   uint8_t *_buf: The buffer, allocated on the first use of the batch.
+ *   size_t _capacity: The size of the buffer.
+ *   _z_atomic(unsigned int) _cnt: The number of references, a batch of the pool without reference is free.
+ *   _z_rx_pool_t *_pool: The pool of the batch, NULL if it was allocated because the pool was exhausted.
+ */
+struct _z_rx_batch_t {
+    uint8_t *_buf;
+    size_t _capacity;
+    _z_atomic(unsigned int) _cnt;
+    _z_rx_pool_t *_pool;
+};
+
+/**
+ * The RX batches of a transport.
+ *
+ * The pool is owned by its transport and by the batches in use, so the retained payloads stay valid once the
+ * transport is closed. When the batches of the pool are all retained, the transport reads into batches allocated on
+ * demand, which are freed with their last reference.
+ *
+ *  Members:
+ *   _z_rx_batch_t _batches[Z_RX_POOL_SIZE]: The batches of the pool.
+ *   size_t _capacity: The size of the batches.
+ *   _z_atomic(unsigned int) _cnt: The number of references, one for the transport and one per batch in use.
+ */
+struct _z_rx_pool_t {
+    _z_rx_batch_t _batches[Z_RX_POOL_SIZE];
+    size_t _capacity;
+    _z_atomic(unsigned int) _cnt;
+};
+
+_z_rx_pool_t *_z_rx_pool_new(size_t capacity);
+// Drops the reference of the transport, the pool is freed once none of its batches is used anymore
+void _z_rx_pool_release(_z_rx_pool_t **pool);
+// Creates the pool of a transport and the batch it first reads into with the zbuf
+int8_t _z_rx_pool_open(_z_rx_pool_t **pool, _z_rx_batch_t **batch, _z_zbuf_t *zbf, size_t capacity);
+// Drops the batch the transport reads into and the reference of the transport on the pool
+void _z_rx_pool_close(_z_rx_pool_t **pool, _z_rx_batch_t **batch, _z_zbuf_t *zbf);
+// Returns a batch with a single reference, NULL if it could not be allocated. To be called by the transport only.
+_z_rx_batch_t *_z_rx_pool_acquire(_z_rx_pool_t *pool);
+// Makes sure that the zbuf reads into a batch that is not retained, moving the bytes yet to read into a free batch
+// otherwise. Must be called by the transport before reading into the zbuf.
+int8_t _z_rx_pool_renew(_z_rx_pool_t *pool, _z_rx_batch_t **batch, _z_zbuf_t *zbf);
+
+_z_zbuf_t _z_rx_batch_as_zbuf(const _z_rx_batch_t *batch);
+_Bool _z_rx_batch_contains(const _z_rx_batch_t *batch, const uint8_t *start, size_t len);
+_Bool _z_rx_batch_is_retained(const _z_rx_batch_t *batch);
+_z_rx_batch_t *_z_rx_batch_clone(_z_rx_batch_t *batch);
+void _z_rx_batch_drop(_z_rx_batch_t **batch);
+
+/**
+ * A payload owning its bytes, either by retaining the batch they were received in or by a copy.
+ *
+ *  Members:
+ *   _z_bytes_t _bytes: The payload, aliasing the batch if any.
+ *   _z_rx_batch_t *_batch: The retained batch, NULL if the payload was copied.
+ */
+typedef struct {
+    _z_bytes_t _bytes;
+    _z_rx_batch_t *_batch;
+} _z_rx_payload_t;
+
+// Retains the batch if the payload is large enough and lies in it, copies the payload otherwise
+int8_t _z_rx_payload_retain(_z_rx_payload_t *dst, const _z_bytes_t *payload, _z_rx_batch_t *batch);
+void _z_rx_payload_copy(_z_rx_payload_t *dst, const _z_rx_payload_t *src);
+void _z_rx_payload_clear(_z_rx_payload_t *payload);
+void _z_rx_payload_free(_z_rx_payload_t **payload);
+
+#endif /* ZENOH_PICO_TRANSPORT_RX_POOL_H */
@@ -0,0 +1,56 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TRANSPORT_RX_STREAM_H
+#define ZENOH_PICO_TRANSPORT_RX_STREAM_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/collections/bytes.h"
+#include "zenoh-pico/link/link.h"
+#include "zenoh-pico/protocol/iobuf.h"
+
+/**
+ * The reassembly cursor of the batches received on a stream link.
+ *
+ * The RX buffer is used as a ring: the link is read at the write position until the end of the buffer, and the
+ * bytes of a partial batch are only moved back to the start of the buffer when the batch would not fit before its
+ * end. A batch is decoded in place, so it is always kept contiguous. The length prefix of a batch is parsed once,
+ * then the cursor waits for its remaining bytes.
+ *
+ *  Members:
+ *   size_t _len: The length of the batch being received, valid if _has_len is true.
+ *   _Bool _has_len: Whether the length prefix of the batch being received has been parsed.
+ */
+typedef struct {
+    size_t _len;
+    _Bool _has_len;
+} _z_rx_stream_t;
+
+void _z_rx_stream_reset(_z_rx_stream_t *rxs);
+/**
+ * Receives from a stream link until a whole batch is available at the read position of the zbuf. The link is read
+ * at most once per call.
+ *
+ * Returns _Z_RES_OK with the length of the batch, whose prefix has been consumed, or
+ * _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES if the link did not provide the whole batch yet. In this case the bytes received
+ * so far are kept and the call must be repeated. The address of the sender is only read with the length prefix.
+ */
+int8_t _z_rx_stream_recv(_z_rx_stream_t *rxs, const _z_link_t *link, _z_zbuf_t *zbf, _z_bytes_t *addr, size_t *len);
+// Whether a whole batch is already in the zbuf, i.e. the next receive does not read the link
+_Bool _z_rx_stream_ready(const _z_rx_stream_t *rxs, const _z_zbuf_t *zbf);
+
+#endif /* ZENOH_PICO_TRANSPORT_RX_STREAM_H */
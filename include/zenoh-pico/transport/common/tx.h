@@ -23,10 +23,17 @@ void __unsafe_z_prepare_wbuf(_z_wbuf_t *buf, uint8_t link_flow_capability);
 void __unsafe_z_finalize_wbuf(_z_wbuf_t *buf, uint8_t link_flow_capability);
 /*This function is unsafe because it operates in potentially concurrent
         data.*Make sure that the following mutexes are locked before calling this function : *-ztu->mutex_tx */
-int8_t __unsafe_z_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, z_reliability_t reliability, size_t sn);
+// Up to max_refs slices of src are referenced by dst instead of being copied, dst must be sent before src is cleared
+int8_t __unsafe_z_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, z_reliability_t reliability, size_t sn,
+                                           _z_n_qos_t qos, size_t max_refs);
+
+// Makes a buffer of the given capacity for each datagram of a batched write, NULL if the link does not batch them
+_z_wbuf_t *_z_tx_slots_make(const _z_link_t *zl, size_t capacity);
+void _z_tx_slots_free(_z_wbuf_t **slots, const _z_link_t *zl);
 
 /*------------------ Transmission and Reception helpers ------------------*/
 int8_t _z_send_t_msg(_z_transport_t *zt, const _z_transport_message_t *t_msg);
+int8_t _z_flush(_z_transport_t *zt);
 int8_t _z_link_send_t_msg(const _z_link_t *zl, const _z_transport_message_t *t_msg);
 
 #endif /* ZENOH_PICO_TRANSPORT_TX_H */
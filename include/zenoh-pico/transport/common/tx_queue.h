@@ -0,0 +1,104 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TRANSPORT_TX_QUEUE_H
+#define ZENOH_PICO_TRANSPORT_TX_QUEUE_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/api/constants.h"
+#include "zenoh-pico/collections/atomic.h"
+#include "zenoh-pico/collections/mpsc.h"
+#include "zenoh-pico/config.h"
+#include "zenoh-pico/protocol/definitions/network.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/utils/stats.h"
+
+#if Z_FEATURE_MULTI_THREAD == 1
+/**
+ * A network message encoded by a publisher, waiting to be framed and sent by the TX task.
+ *
+ *  Members:
+ *   uint8_t *_buf: The encoded message, allocated together with the entry.
+ *   size_t _len: The length of the encoded message.
+ *   z_reliability_t _reliability: The reliability of the frame to send the message in.
+ *   uint8_t _lane: The transmission lane of the message.
+ */
+typedef struct {
+    uint8_t *_buf;
+    size_t _len;
+    z_reliability_t _reliability;
+    uint8_t _lane;
+} _z_tx_entry_t;
+
+void _z_tx_entry_free(_z_tx_entry_t **e);
+
+static inline void _z_tx_entry_elem_free(void **e) { _z_tx_entry_free((_z_tx_entry_t **)e); }
+_Z_MPSC_DEFINE(_z_tx_entry, _z_tx_entry_t)
+
+/**
+ * The queue of the messages to be sent by the TX task.
+ *
+ * The queue is congested once it holds Z_TX_QUEUE_HIGH_WATERMARK bytes, or Z_TX_QUEUE_SIZE messages, and stays so
+ * until the TX task drained it below Z_TX_QUEUE_LOW_WATERMARK bytes. Meanwhile the messages are dropped or their
+ * publishers are blocked, according to their congestion control.
+ *
+ *  Members:
+ *   _z_tx_entry_mpsc_t _entries: The messages, pushed by the publishers and pulled by the TX task.
+ *   _z_atomic(size_t) _bytes: The number of encoded bytes in the queue.
+ *   _z_atomic(_Bool) _congested: Whether the queue is congested.
+ *   _z_atomic(_Bool) _closed: Whether the queue is closed, messages are then no longer accepted.
+ *   _z_atomic(_Bool) _task_waiting: Whether the TX task waits for messages.
+ *   _z_atomic(size_t) _pushing: The number of publishers pushing a message, the TX task only stops once it is zero.
+ *   size_t _blocked: The number of blocked publishers, protected by _mutex.
+ *   zp_mutex_t _mutex: The mutex to wait on the condition variables.
+ *   zp_condvar_t _cv_task: Signaled when a message is pushed while the TX task waits.
+ *   zp_condvar_t _cv_producers: Signaled when the congestion is over.
+ *   _z_transport_stats_t *_stats: The statistics of the transport, NULL until its TX task starts.
+ */
+typedef struct {
+    _z_tx_entry_mpsc_t _entries;
+    _z_atomic(size_t) _bytes;
+    _z_atomic(_Bool) _congested;
+    _z_atomic(_Bool) _closed;
+    _z_atomic(_Bool) _task_waiting;
+    _z_atomic(size_t) _pushing;
+    size_t _blocked;
+    zp_mutex_t _mutex;
+    zp_condvar_t _cv_task;
+    zp_condvar_t _cv_producers;
+#if Z_FEATURE_STATS == 1
+    _z_transport_stats_t *_stats;
+#endif  // Z_FEATURE_STATS == 1
+} _z_tx_queue_t;
+
+void _z_tx_queue_null(_z_tx_queue_t *q);
+int8_t _z_tx_queue_open(_z_tx_queue_t *q);
+void _z_tx_queue_close(_z_tx_queue_t *q);
+_Bool _z_tx_queue_is_closed(const _z_tx_queue_t *q);
+void _z_tx_queue_clear(_z_tx_queue_t *q);
+
+// Publisher side: a dropped message is not an error, _Z_ERR_CONNECTION_CLOSED is returned if the queue is closed
+int8_t _z_tx_queue_push(_z_tx_queue_t *q, const _z_network_message_t *n_msg, z_reliability_t reliability,
+                        uint8_t lane, z_congestion_control_t cong_ctrl);
+
+// TX task side: pull returns NULL if the queue is empty, wait returns once a message can be pulled or the queue is
+// closed with no publisher pushing, and is_done tells whether the queue is closed and all its messages were pulled
+_z_tx_entry_t *_z_tx_queue_pull(_z_tx_queue_t *q);
+void _z_tx_queue_wait(_z_tx_queue_t *q);
+_Bool _z_tx_queue_is_done(const _z_tx_queue_t *q);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+#endif /* ZENOH_PICO_TRANSPORT_TX_QUEUE_H */
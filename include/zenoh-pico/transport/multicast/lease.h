@@ -17,8 +17,14 @@
 
 #include "zenoh-pico/transport/transport.h"
 
+// Returns the current time in milliseconds, on the clock of the lease deadlines of the peers
+_z_zint_t _zp_multicast_lease_now(_z_transport_multicast_t *ztm);
 int8_t _zp_multicast_send_join(_z_transport_multicast_t *ztm);
 int8_t _zp_multicast_send_keep_alive(_z_transport_multicast_t *ztm);
+// Starts the lease procedure of the transport, which is then run by _zp_multicast_lease_step
+void _zp_multicast_lease_start(_z_transport_multicast_t *ztm);
+// Runs the due lease duties of the transport and returns the milliseconds until the next ones in interval
+int8_t _zp_multicast_lease_step(_z_transport_multicast_t *ztm, _z_zint_t *interval);
 int8_t _zp_multicast_stop_lease_task(_z_transport_multicast_t *ztm);
 void *_zp_multicast_lease_task(void *ztm_arg);  // The argument is void* to avoid incompatible pointer types in tasks
 
@@ -18,8 +18,20 @@
 #include "zenoh-pico/net/session.h"
 #include "zenoh-pico/transport/transport.h"
 
-int8_t _z_multicast_send_n_msg(_z_session_t *zn, const _z_network_message_t *z_msg, z_reliability_t reliability,
-                               z_congestion_control_t cong_ctrl);
+int8_t _z_multicast_send_n_msg(_z_transport_multicast_t *ztm, const _z_network_message_t *z_msg,
+                               z_reliability_t reliability, z_congestion_control_t cong_ctrl);
 int8_t _z_multicast_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport_message_t *t_msg);
+// Sends messages of the same priority packed in as few frames as possible, blocking on congestion
+int8_t _z_multicast_send_n_batch(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msgs, size_t len,
+                                 z_reliability_t reliability);
+
+int8_t _zp_multicast_stop_tx_task(_z_transport_multicast_t *ztm);
+void *_zp_multicast_tx_task(void *ztm_arg);  // The argument is void* to avoid incompatible pointer types in tasks
+
+#if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_MULTICAST_TRANSPORT == 1
+int8_t _zp_multicast_start_tx_task(_z_transport_multicast_t *ztm, zp_task_attr_t *attr, zp_task_t *task);
+#else
+int8_t _zp_multicast_start_tx_task(_z_transport_multicast_t *ztm, void *attr, void *task);
+#endif /* Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_MULTICAST_TRANSPORT == 1 */
 
 #endif /* ZENOH_PICO_MULTICAST_TX_H */
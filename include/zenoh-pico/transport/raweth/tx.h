@@ -19,8 +19,8 @@
 #include "zenoh-pico/transport/transport.h"
 
 int8_t _z_raweth_link_send_t_msg(const _z_link_t *zl, const _z_transport_message_t *t_msg);
-int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *z_msg, z_reliability_t reliability,
-                            z_congestion_control_t cong_ctrl);
+int8_t _z_raweth_send_n_msg(_z_transport_multicast_t *ztm, const _z_network_message_t *z_msg,
+                            z_reliability_t reliability, z_congestion_control_t cong_ctrl);
 int8_t _z_raweth_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport_message_t *t_msg);
 
 #endif /* ZENOH_PICO_RAWETH_TX_H */
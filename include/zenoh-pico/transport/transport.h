@@ -24,20 +24,39 @@
 #include "zenoh-pico/link/link.h"
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/protocol/definitions/transport.h"
+#include "zenoh-pico/transport/common/reliability.h"
+#include "zenoh-pico/transport/common/rx_pool.h"
+#include "zenoh-pico/transport/common/rx_stream.h"
+#include "zenoh-pico/transport/common/tx_queue.h"
+#include "zenoh-pico/utils/stats.h"
+
+// Number of priority lanes of a transport, QoS conduits are mapped on the first lane if they are not enabled
+#if Z_FEATURE_PRIORITY_LANES == 1
+#define _Z_TRANSPORT_LANES_NUM Z_PRIORITIES_NUM
+#else
+#define _Z_TRANSPORT_LANES_NUM 1
+#endif
+#define _Z_TRANSPORT_LANE(conduit) (((conduit) < _Z_TRANSPORT_LANES_NUM) ? (conduit) : 0)
 
 typedef struct {
-    // Defragmentation buffers
-    _z_wbuf_t _dbuf_reliable;
-    _z_wbuf_t _dbuf_best_effort;
+    // Defragmentation buffers, one per lane
+    _z_dbuf_t _dbuf_reliable[_Z_TRANSPORT_LANES_NUM];
+    _z_dbuf_t _dbuf_best_effort[_Z_TRANSPORT_LANES_NUM];
 
     _z_id_t _remote_zid;
     _z_bytes_t _remote_addr;
     _z_conduit_sn_list_t _sn_rx_sns;
 
+#if Z_FEATURE_RELIABILITY == 1
+    // Reorder buffers, one per QoS conduit, NULL if the peer does not retransmit its reliable messages
+    _z_reliability_reorder_t *_rx_reorder;
+#endif  // Z_FEATURE_RELIABILITY == 1
+
     // SN numbers
     _z_zint_t _sn_res;
     volatile _z_zint_t _lease;
-    volatile _z_zint_t _next_lease;
+    _z_zint_t _lease_deadline;  // In milliseconds since the transport was created
+    size_t _lease_idx;          // The position of the entry in the lease heap of its peer table
 
     uint16_t _peer_id;
     volatile _Bool _received;
@@ -49,9 +68,55 @@ void _z_transport_peer_entry_copy(_z_transport_peer_entry_t *dst, const _z_trans
 _Bool _z_transport_peer_entry_eq(const _z_transport_peer_entry_t *left, const _z_transport_peer_entry_t *right);
 _Z_ELEM_DEFINE(_z_transport_peer_entry, _z_transport_peer_entry_t, _z_transport_peer_entry_size,
                _z_transport_peer_entry_clear, _z_transport_peer_entry_copy)
-_Z_LIST_DEFINE(_z_transport_peer_entry, _z_transport_peer_entry_t)
-_z_transport_peer_entry_list_t *_z_transport_peer_entry_list_insert(_z_transport_peer_entry_list_t *root,
-                                                                    _z_transport_peer_entry_t *entry);
+
+#define _Z_TRANSPORT_PEER_TABLE_DEFAULT_CAPACITY 8
+
+/**
+ * A slot of a :c:type:`_z_transport_peer_table_t`.
+ *
+ * Members:
+ *   _hash: the hash of the remote address of the peer
+ *   _entry: the peer, or NULL if the slot is empty
+ */
+typedef struct {
+    size_t _hash;
+    _z_transport_peer_entry_t *_entry;
+} _z_transport_peer_slot_t;
+
+/**
+ * The peers of a multicast transport, owning their entries.
+ *
+ * Peers are indexed by remote address in a flat open-addressing hash table, using linear probing. They are also kept
+ * in a binary min-heap ordered by lease deadline, so that the lease task only visits the peers whose lease expired.
+ * The heap is a dense array of all the peers, it is the one to iterate over.
+ *
+ * Members:
+ *   _by_addr: the slots indexed by remote address
+ *   _by_lease: the binary min-heap of the peers, ordered by lease deadline
+ *   _capacity: the number of slots, always a power of two, and of entries the heap can hold
+ *   _len: the number of peers in the table
+ *   _next_peer_id: the peer id to allocate next, ids are only reused once they wrap around
+ */
+typedef struct {
+    _z_transport_peer_slot_t *_by_addr;
+    _z_transport_peer_entry_t **_by_lease;
+    size_t _capacity;
+    size_t _len;
+    uint16_t _next_peer_id;
+} _z_transport_peer_table_t;
+
+void _z_transport_peer_table_init(_z_transport_peer_table_t *table);
+void _z_transport_peer_table_clear(_z_transport_peer_table_t *table);
+_z_transport_peer_entry_t *_z_transport_peer_table_get(const _z_transport_peer_table_t *table,
+                                                       const _z_bytes_t *remote_addr);
+// Allocates a peer id to the entry and takes its ownership, the entry must have its lease deadline set
+int8_t _z_transport_peer_table_insert(_z_transport_peer_table_t *table, _z_transport_peer_entry_t *entry);
+// Removes and frees the entry
+void _z_transport_peer_table_remove(_z_transport_peer_table_t *table, _z_transport_peer_entry_t *entry);
+// Returns the peer with the earliest lease deadline, or NULL if the table is empty
+_z_transport_peer_entry_t *_z_transport_peer_table_next_lease(const _z_transport_peer_table_t *table);
+void _z_transport_peer_table_renew_lease(_z_transport_peer_table_t *table, _z_transport_peer_entry_t *entry,
+                                         _z_zint_t deadline);
 
 // Forward declaration to be used in _zp_f_send_tmsg*
 typedef struct _z_transport_multicast_t _z_transport_multicast_t;
@@ -62,38 +127,83 @@ typedef struct {
     // Session associated to the transport
 
 #if Z_FEATURE_MULTI_THREAD == 1
-    // TX and RX mutexes
+    // TX and RX mutexes, the TX mutex is only held for a single batch or fragment
     zp_mutex_t _mutex_rx;
     zp_mutex_t _mutex_tx;
+
+    // Lane mutexes, held for a whole network message so that a fragmented message only blocks its own lane
+    zp_mutex_t _mutex_lanes[_Z_TRANSPORT_LANES_NUM];
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     _z_link_t _link;
 
     // Buffers
-    _z_wbuf_t _dbuf_reliable;     // Defragmentation buffer
-    _z_wbuf_t _dbuf_best_effort;  // Defragmentation buffer
+    _z_dbuf_t _dbuf_reliable[_Z_TRANSPORT_LANES_NUM];     // Defragmentation buffers
+    _z_dbuf_t _dbuf_best_effort[_Z_TRANSPORT_LANES_NUM];  // Defragmentation buffers
     _z_wbuf_t _wbuf;
-    _z_zbuf_t _zbuf;
+    _z_zbuf_t _zbuf;  // Reads into _rx_batch
+    _z_rx_pool_t *_rx_pool;
+    _z_rx_batch_t *_rx_batch;
+    _z_rx_stream_t _rx_stream;  // Reassembly of the batches received on stream links
 
     _z_id_t _remote_zid;
 
-    // SN numbers
+    // SN numbers, one pair per QoS conduit if QoS has been negotiated
     _z_zint_t _sn_res;
-    _z_zint_t _sn_tx_reliable;
-    _z_zint_t _sn_tx_best_effort;
-    _z_zint_t _sn_rx_reliable;
-    _z_zint_t _sn_rx_best_effort;
+    _z_conduit_sn_list_t _sn_tx_sns;
+    _z_conduit_sn_list_t _sn_rx_sns;
     volatile _z_zint_t _lease;
 
+#if Z_FEATURE_RELIABILITY == 1
+    // Retransmission windows, one per lane, and reorder buffers, one per QoS conduit. NULL if the link is reliable
+    // or if reliability has not been negotiated.
+    _z_reliability_window_t *_tx_window;
+    _z_reliability_reorder_t *_rx_reorder;
+#endif  // Z_FEATURE_RELIABILITY == 1
+
+    // Lease deadlines, in milliseconds since _lease_epoch
+    zp_clock_t _lease_epoch;
+    _z_zint_t _next_lease;
+    _z_zint_t _next_keep_alive;
+
     void *_session;
 
+#if Z_FEATURE_BATCHING == 1
+    // Batching state of the frame currently being built in _wbuf
+    size_t _batch_count;
+    z_reliability_t _batch_reliability;
+    uint8_t _batch_lane;
+    zp_clock_t _batch_time;
+    // The lease step flushes the expired batches, a batch is only held if the next step runs before it expires
+    _Bool _batch_active;    // Messages were sent since the previous lease step
+    _z_zint_t _batch_wake;  // The time of the next lease step, on the lease clock, 0 if no step is scheduled
+#endif  // Z_FEATURE_BATCHING == 1
+
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_task_t *_read_task;
     zp_task_t *_lease_task;
+    zp_task_t *_tx_task;
     volatile _Bool _read_task_running;
     volatile _Bool _lease_task_running;
+    volatile _Bool _tx_task_running;
+
+    // Network messages handed over to the TX task, only used while it is running
+    _z_tx_queue_t _tx_queue;
+    // The frames the TX task sends in a single batched write, NULL if the link does not batch datagrams
+    _z_wbuf_t *_tx_slots;
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    // The mapping of the resources declared by the remote node, distinct for each unicast transport of the session
+    uint16_t _mapping;
+    // Set once the transport has been closed by either side or has expired, the session then uses its other ones
+    volatile _Bool _is_down;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+
+#if Z_FEATURE_STATS == 1
+    _z_transport_stats_t _stats;
+#endif  // Z_FEATURE_STATS == 1
+
     volatile _Bool _received;
     volatile _Bool _transmitted;
 } _z_transport_unicast_t;
@@ -107,24 +217,37 @@ typedef struct _z_transport_multicast_t {
     zp_mutex_t _mutex_rx;
     zp_mutex_t _mutex_tx;
 
-    // Peer list mutex
+    // Peer table mutex
     zp_mutex_t _mutex_peer;
+
+    // Lane mutexes, held for a whole network message so that a fragmented message only blocks its own lane
+    zp_mutex_t _mutex_lanes[_Z_TRANSPORT_LANES_NUM];
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     _z_link_t _link;
 
     // TX and RX buffers
     _z_wbuf_t _wbuf;
-    _z_zbuf_t _zbuf;
+    _z_zbuf_t _zbuf;  // Reads into _rx_batch
+    _z_rx_pool_t *_rx_pool;
+    _z_rx_batch_t *_rx_batch;
+    _z_rx_stream_t _rx_stream;  // Reassembly of the batches received on stream links
 
-    // SN initial numbers
+    // SN initial numbers, one pair per QoS conduit if QoS is announced
     _z_zint_t _sn_res;
-    _z_zint_t _sn_tx_reliable;
-    _z_zint_t _sn_tx_best_effort;
+    _z_conduit_sn_list_t _sn_tx_sns;
     volatile _z_zint_t _lease;
 
+#if Z_FEATURE_RELIABILITY == 1
+    // Retransmission windows, one per lane, NULL if the link is reliable
+    _z_reliability_window_t *_tx_window;
+#endif  // Z_FEATURE_RELIABILITY == 1
+
     // Known valid peers
-    _z_transport_peer_entry_list_t *_peers;
+    _z_transport_peer_table_t _peers;
+    zp_clock_t _lease_epoch;  // The reference of the lease deadlines of the peers and the transport
+    _z_zint_t _next_keep_alive;
+    _z_zint_t _next_join;
 
     // T message send function
     _zp_f_send_tmsg _send_f;
@@ -132,10 +255,21 @@ typedef struct _z_transport_multicast_t {
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_task_t *_read_task;
     zp_task_t *_lease_task;
+    zp_task_t *_tx_task;
     volatile _Bool _read_task_running;
     volatile _Bool _lease_task_running;
+    volatile _Bool _tx_task_running;
+
+    // Network messages handed over to the TX task, only used while it is running
+    _z_tx_queue_t _tx_queue;
+    // The frames the TX task sends in a single batched write, NULL if the link does not batch datagrams
+    _z_wbuf_t *_tx_slots;
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+#if Z_FEATURE_STATS == 1
+    _z_transport_stats_t _stats;
+#endif  // Z_FEATURE_STATS == 1
+
     volatile _Bool _transmitted;
 } _z_transport_multicast_t;
 
@@ -167,6 +301,7 @@ typedef struct {
     uint8_t _req_id_res;
     uint8_t _seq_num_res;
     _Bool _is_qos;
+    _Bool _is_reliability;
 } _z_transport_unicast_establish_param_t;
 
 typedef struct {
@@ -176,6 +311,9 @@ typedef struct {
 
 int8_t _z_transport_close(_z_transport_t *zt, uint8_t reason);
 void _z_transport_clear(_z_transport_t *zt);
+const _z_link_t *_z_transport_link(const _z_transport_t *zt);
+// Whether the transport can still carry messages, a unicast transport is down once closed or expired
+_Bool _z_transport_is_up(const _z_transport_t *zt);
 void _z_transport_free(_z_transport_t **zt);
 
 #endif /* INCLUDE_ZENOH_PICO_TRANSPORT_TRANSPORT_H */
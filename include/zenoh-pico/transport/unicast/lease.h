@@ -18,6 +18,11 @@
 #include "zenoh-pico/transport/transport.h"
 
 int8_t _zp_unicast_send_keep_alive(_z_transport_unicast_t *ztu);
+// Starts the lease procedure of the transport, which is then run by _zp_unicast_lease_step
+void _zp_unicast_lease_start(_z_transport_unicast_t *ztu);
+// Runs the due lease duties of the transport and returns the milliseconds until the next ones in interval. Returns
+// _Z_ERR_CONNECTION_CLOSED once the lease expired and the transport was closed.
+int8_t _zp_unicast_lease_step(_z_transport_unicast_t *ztu, _z_zint_t *interval);
 int8_t _zp_unicast_stop_lease_task(_z_transport_t *zt);
 void *_zp_unicast_lease_task(void *ztu_arg);  // The argument is void* to avoid incompatible pointer types in tasks
 
@@ -18,8 +18,23 @@
 #include "zenoh-pico/net/session.h"
 #include "zenoh-pico/transport/transport.h"
 
-int8_t _z_unicast_send_n_msg(_z_session_t *zn, const _z_network_message_t *z_msg, z_reliability_t reliability,
-                             z_congestion_control_t cong_ctrl);
+int8_t _z_unicast_send_n_msg(_z_transport_unicast_t *ztu, const _z_network_message_t *z_msg,
+                             z_reliability_t reliability, z_congestion_control_t cong_ctrl);
 int8_t _z_unicast_send_t_msg(_z_transport_unicast_t *ztu, const _z_transport_message_t *t_msg);
+int8_t _z_unicast_flush(_z_transport_unicast_t *ztu);
+// Flush the expired batch and shorten the interval to the next lease step, if needed, to flush the next ones in time
+int8_t _z_unicast_batch_step(_z_transport_unicast_t *ztu, _z_zint_t now, _z_zint_t *interval);
+#if Z_FEATURE_BATCHING == 1
+int8_t __unsafe_z_unicast_flush(_z_transport_unicast_t *ztu);
+#endif  // Z_FEATURE_BATCHING == 1
+
+int8_t _zp_unicast_stop_tx_task(_z_transport_t *zt);
+void *_zp_unicast_tx_task(void *ztu_arg);  // The argument is void* to avoid incompatible pointer types in tasks
+
+#if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
+int8_t _zp_unicast_start_tx_task(_z_transport_t *zt, zp_task_attr_t *attr, zp_task_t *task);
+#else
+int8_t _zp_unicast_start_tx_task(_z_transport_t *zt, void *attr, void *task);
+#endif /* Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1 */
 
 #endif /* ZENOH_PICO_TRANSPORT_LINK_TX_H */
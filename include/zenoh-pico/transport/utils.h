@@ -19,6 +19,7 @@
 
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/protocol/definitions/transport.h"
+#include "zenoh-pico/transport/transport.h"
 
 /*------------------ SN helpers ------------------*/
 _z_zint_t _z_sn_max(uint8_t bits);
@@ -28,7 +29,19 @@ _Bool _z_sn_precedes(const _z_zint_t sn_resolution, const _z_zint_t sn_left, con
 _z_zint_t _z_sn_increment(const _z_zint_t sn_resolution, const _z_zint_t sn);
 _z_zint_t _z_sn_decrement(const _z_zint_t sn_resolution, const _z_zint_t sn);
 
+void _z_conduit_sn_list_init(_z_conduit_sn_list_t *sns, _Bool is_qos, _z_zint_t sn);
 void _z_conduit_sn_list_copy(_z_conduit_sn_list_t *dst, const _z_conduit_sn_list_t *src);
 void _z_conduit_sn_list_decrement(const _z_zint_t sn_resolution, _z_conduit_sn_list_t *sns);
+/**
+ * Returns the index of the conduit the messages of the given priority are sent on, that is the priority itself if
+ * QoS is enabled and 0 otherwise.
+ */
+uint8_t _z_conduit_sn_list_index(const _z_conduit_sn_list_t *sns, uint8_t priority);
+
+/*------------------ Lane helpers ------------------*/
+#if Z_FEATURE_MULTI_THREAD == 1
+int8_t _z_transport_lanes_mutex_init(zp_mutex_t *mutexes);
+void _z_transport_lanes_mutex_free(zp_mutex_t *mutexes);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
 
 #endif /* ZENOH_PICO_TRANSPORT_UTILS_H */
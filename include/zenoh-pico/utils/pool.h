@@ -0,0 +1,62 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_UTILS_POOL_H
+#define ZENOH_PICO_UTILS_POOL_H
+
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/config.h"
+
+#if Z_FEATURE_MEMORY_POOL == 1
+#if (Z_MEMORY_POOL_BLOCK_SIZE % 8) != 0
+#error "Z_MEMORY_POOL_BLOCK_SIZE must be a multiple of 8"
+#endif
+#if (Z_MEMORY_POOL_BLOCKS == 0) || (Z_MEMORY_POOL_BLOCKS > 65535)
+#error "Z_MEMORY_POOL_BLOCKS must be between 1 and 65535"
+#endif
+#if ZENOH_C_STANDARD == 99 && Z_FEATURE_MULTI_THREAD == 1
+#error "The memory pool relies on atomics, it requires C11 with Z_FEATURE_MULTI_THREAD"
+#endif
+
+/**
+ * The usage statistics of a size class of the memory pool.
+ *
+ *  Members:
+ *   size_t block_size: The size of the blocks of the class.
+ *   size_t blocks: The number of blocks of the class.
+ *   size_t used: The number of blocks currently allocated.
+ *   size_t high_watermark: The highest number of blocks allocated at the same time.
+ *   size_t fallbacks: The number of allocations served by the platform allocator because no block was left.
+ */
+typedef struct {
+    size_t block_size;
+    size_t blocks;
+    size_t used;
+    size_t high_watermark;
+    size_t fallbacks;
+} _z_pool_stats_t;
+
+// Returns NULL if the size is larger than the largest class, or if no block of its class is left
+void *_z_pool_malloc(size_t size);
+// Returns false if the pointer was not allocated from the pool
+_Bool _z_pool_free(void *ptr);
+// Returns 0 if the pointer was not allocated from the pool
+size_t _z_pool_block_size(const void *ptr);
+int8_t _z_pool_stats(size_t cls, _z_pool_stats_t *stats);
+#endif  // Z_FEATURE_MEMORY_POOL == 1
+
+#endif /* ZENOH_PICO_UTILS_POOL_H */
@@ -0,0 +1,82 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_UTILS_SIMD_H
+#define ZENOH_PICO_UTILS_SIMD_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/config.h"
+
+/**
+ * The vector instructions used to scan strings by blocks of _Z_SIMD_WIDTH bytes, selected at build time from the
+ * target of the compiler. _Z_SIMD_WIDTH is not defined when there are none, and the callers fall back to their scalar
+ * code.
+ *
+ * The comparison of a block with a character gives a mask of _Z_SIMD_MASK_BITS bits per byte, the bits of the first
+ * byte being the lowest ones. The blocks are loaded unaligned, and must be fully within the scanned string.
+ */
+#if Z_FEATURE_SIMD == 1 && defined(__GNUC__)
+#if defined(__AVX2__)
+#include <immintrin.h>
+#define _Z_SIMD_WIDTH 32
+#define _Z_SIMD_MASK_BITS 1
+typedef __m256i _z_simd_t;
+
+static inline _z_simd_t _z_simd_load(const char *ptr) { return _mm256_loadu_si256((const __m256i *)ptr); }
+static inline uint64_t _z_simd_match(_z_simd_t block, char c) {
+    return (uint64_t)(uint32_t)_mm256_movemask_epi8(_mm256_cmpeq_epi8(block, _mm256_set1_epi8(c)));
+}
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#define _Z_SIMD_WIDTH 16
+#define _Z_SIMD_MASK_BITS 1
+typedef __m128i _z_simd_t;
+
+static inline _z_simd_t _z_simd_load(const char *ptr) { return _mm_loadu_si128((const __m128i *)ptr); }
+static inline uint64_t _z_simd_match(_z_simd_t block, char c) {
+    return (uint64_t)(uint32_t)_mm_movemask_epi8(_mm_cmpeq_epi8(block, _mm_set1_epi8(c)));
+}
+#elif defined(__ARM_NEON)
+#include <arm_neon.h>
+#define _Z_SIMD_WIDTH 16
+#define _Z_SIMD_MASK_BITS 4
+typedef uint8x16_t _z_simd_t;
+
+static inline _z_simd_t _z_simd_load(const char *ptr) { return vld1q_u8((const uint8_t *)ptr); }
+// NEON has no movemask, the comparison is narrowed to a nibble per byte instead
+static inline uint64_t _z_simd_match(_z_simd_t block, char c) {
+    uint8x16_t eq = vceqq_u8(block, vdupq_n_u8((uint8_t)c));
+    return vget_lane_u64(vreinterpret_u64_u8(vshrn_n_u16(vreinterpretq_u16_u8(eq), 4)), 0);
+}
+#endif
+#endif  // Z_FEATURE_SIMD == 1 && defined(__GNUC__)
+
+#ifdef _Z_SIMD_WIDTH
+// The index of the first byte set in a non-zero mask
+static inline size_t _z_simd_first(uint64_t mask) { return (size_t)__builtin_ctzll(mask) / _Z_SIMD_MASK_BITS; }
+// The index of the last byte set in a non-zero mask
+static inline size_t _z_simd_last(uint64_t mask) { return (size_t)(63 - __builtin_clzll(mask)) / _Z_SIMD_MASK_BITS; }
+// The number of bytes set in a mask
+static inline size_t _z_simd_count(uint64_t mask) { return (size_t)__builtin_popcountll(mask) / _Z_SIMD_MASK_BITS; }
+// The bytes set in a mask that are followed by a byte set in the same block
+static inline uint64_t _z_simd_pairs(uint64_t mask) { return mask & (mask >> _Z_SIMD_MASK_BITS); }
+// Whether the last byte of a block is set in a mask
+static inline _Bool _z_simd_is_last_set(uint64_t mask) {
+    return ((mask >> ((_Z_SIMD_WIDTH - 1) * _Z_SIMD_MASK_BITS)) & (uint64_t)1) != (uint64_t)0;
+}
+#endif
+
+#endif /* ZENOH_PICO_UTILS_SIMD_H */
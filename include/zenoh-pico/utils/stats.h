@@ -0,0 +1,134 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_UTILS_STATS_H
+#define ZENOH_PICO_UTILS_STATS_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#include "zenoh-pico/collections/atomic.h"
+#include "zenoh-pico/config.h"
+
+/**
+ * The counters of a transport. The messages are network messages, the batches are the frames, fragments and
+ * transport messages written to or read from the link, and the bytes are the ones of the batches.
+ */
+typedef enum {
+    _Z_STATS_TX_N_MSGS = 0,
+    _Z_STATS_TX_BYTES = 1,
+    _Z_STATS_TX_BATCHES = 2,
+    _Z_STATS_TX_FRAGMENTS = 3,
+    _Z_STATS_TX_KEEP_ALIVES = 4,
+    _Z_STATS_TX_CONGESTION_DROPS = 5,
+    _Z_STATS_RX_N_MSGS = 6,
+    _Z_STATS_RX_BYTES = 7,
+    _Z_STATS_RX_BATCHES = 8,
+    _Z_STATS_RX_FRAGMENTS = 9,
+    _Z_STATS_RX_KEEP_ALIVES = 10,
+    _Z_STATS_RX_OUT_OF_ORDER_DROPS = 11,
+    _Z_STATS_RX_REASSEMBLY_DROPS = 12,
+    _Z_STATS_TRANSPORT_NUM = 13,
+} _z_stats_transport_counter_t;
+
+/**
+ * The counters of a session, on the network messages it handled.
+ */
+typedef enum {
+    _Z_STATS_RX_DECLARES = 0,
+    _Z_STATS_RX_PUSHES = 1,
+    _Z_STATS_RX_REQUESTS = 2,
+    _Z_STATS_RX_RESPONSES = 3,
+    _Z_STATS_RX_RESPONSE_FINALS = 4,
+    _Z_STATS_RX_ERRORS = 5,
+    _Z_STATS_SESSION_NUM = 6,
+} _z_stats_session_counter_t;
+
+typedef struct {
+    _z_atomic(size_t) _counters[_Z_STATS_TRANSPORT_NUM];
+} _z_transport_stats_t;
+
+typedef struct {
+    _z_atomic(size_t) _counters[_Z_STATS_SESSION_NUM];
+} _z_session_stats_t;
+
+/**
+ * A snapshot of the counters of a session, summed over its transports. The counters are read one by one, they are
+ * not consistent with each other while messages are being sent or received, and wrap around on overflow.
+ *
+ *  Members:
+ *   size_t tx_n_msgs: The number of network messages sent.
+ *   size_t tx_bytes: The number of bytes written to the links.
+ *   size_t tx_batches: The number of batches written to the links, including the fragments and keep alives.
+ *   size_t tx_fragments: The number of fragments written to the links.
+ *   size_t tx_keep_alives: The number of keep alives sent.
+ *   size_t tx_congestion_drops: The number of network messages dropped by the congestion control.
+ *   size_t rx_n_msgs: The number of network messages received.
+ *   size_t rx_bytes: The number of bytes read from the links.
+ *   size_t rx_batches: The number of batches read from the links, including the fragments and keep alives.
+ *   size_t rx_fragments: The number of fragments received.
+ *   size_t rx_keep_alives: The number of keep alives received.
+ *   size_t rx_out_of_order_drops: The number of frames dropped because their sequence number is out of order.
+ *   size_t rx_reassembly_drops: The number of fragmented messages dropped because they exceed Z_FRAG_MAX_SIZE.
+ *   size_t rx_declares: The number of declarations handled by the session.
+ *   size_t rx_pushes: The number of pushes handled by the session.
+ *   size_t rx_requests: The number of requests handled by the session.
+ *   size_t rx_responses: The number of responses handled by the session.
+ *   size_t rx_response_finals: The number of final responses handled by the session.
+ *   size_t rx_errors: The number of network messages the session failed to handle.
+ */
+typedef struct {
+    size_t tx_n_msgs;
+    size_t tx_bytes;
+    size_t tx_batches;
+    size_t tx_fragments;
+    size_t tx_keep_alives;
+    size_t tx_congestion_drops;
+    size_t rx_n_msgs;
+    size_t rx_bytes;
+    size_t rx_batches;
+    size_t rx_fragments;
+    size_t rx_keep_alives;
+    size_t rx_out_of_order_drops;
+    size_t rx_reassembly_drops;
+    size_t rx_declares;
+    size_t rx_pushes;
+    size_t rx_requests;
+    size_t rx_responses;
+    size_t rx_response_finals;
+    size_t rx_errors;
+} _z_stats_t;
+
+#if Z_FEATURE_STATS == 1
+void _z_transport_stats_reset(_z_transport_stats_t *stats);
+void _z_session_stats_reset(_z_session_stats_t *stats);
+// Adds the counters of a transport to the snapshot
+void _z_transport_stats_read(const _z_transport_stats_t *stats, _z_stats_t *snapshot);
+// Sets the counters of a session in the snapshot
+void _z_session_stats_read(const _z_session_stats_t *stats, _z_stats_t *snapshot);
+
+#define _Z_STATS_ADD(stats, counter, n) \
+    ((void)_z_atomic_fetch_add_explicit(&(stats)->_counters[counter], (size_t)(n), _z_memory_order_relaxed))
+#else
+// The counters do not exist, their arguments are not even evaluated
+#define _Z_STATS_ADD(stats, counter, n) ((void)0)
+#endif  // Z_FEATURE_STATS == 1
+#define _Z_STATS_INC(stats, counter) _Z_STATS_ADD(stats, counter, 1)
+// A batch of len bytes written to or read from the link
+#define _Z_STATS_TX_BATCH(stats, len) \
+    (_Z_STATS_INC(stats, _Z_STATS_TX_BATCHES), _Z_STATS_ADD(stats, _Z_STATS_TX_BYTES, len))
+#define _Z_STATS_RX_BATCH(stats, len) \
+    (_Z_STATS_INC(stats, _Z_STATS_RX_BATCHES), _Z_STATS_ADD(stats, _Z_STATS_RX_BYTES, len))
+
+#endif /* ZENOH_PICO_UTILS_STATS_H */
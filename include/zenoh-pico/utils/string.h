@@ -44,6 +44,22 @@ char const *_z_rstrstr(const char *haystack_start, const char *haystack_end, con
  */
 char const *_z_strstr(char const *haystack_start, char const *haystack_end, const char *needle_start);
 
+/**
+ * A non-null-terminated string equivalent of libc's `strchr`, vectorized when Z_FEATURE_SIMD is enabled.
+ *
+ * Returns NULL if the character is not found.
+ * If found, the return pointer will point to its first occurrence within the string.
+ */
+char const *_z_bstrchr(_z_str_se_t s, char c);
+
+/**
+ * The reverse equivalent of `_z_bstrchr`.
+ *
+ * Returns NULL if the character is not found.
+ * If found, the return pointer will point to its last occurrence within the string.
+ */
+char const *_z_rbstrchr(_z_str_se_t s, char c);
+
 char const *_z_strstr_skipneedle(char const *haystack_start, char const *haystack_end, const char *needle_start);
 char const *_z_bstrstr_skipneedle(_z_str_se_t haystack, _z_str_se_t needle);
 
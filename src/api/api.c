@@ -29,6 +29,7 @@
 #include "zenoh-pico/net/session.h"
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/matching.h"
 #include "zenoh-pico/session/queryable.h"
 #include "zenoh-pico/session/resource.h"
 #include "zenoh-pico/session/subscription.h"
@@ -339,6 +340,13 @@ void z_closure_zid_call(const z_owned_closure_zid_t *closure, const z_id_t *id)
     }
 }
 
+void z_closure_matching_status_call(const z_owned_closure_matching_status_t *closure,
+                                    const z_matching_status_t *status) {
+    if (closure->call) {
+        (closure->call)(status, closure->context);
+    }
+}
+
 /**************** Loans ****************/
 #define OWNED_FUNCTIONS_PTR_INTERNAL(type, ownedtype, name, f_free, f_copy)      \
     _Bool z_##name##_check(const ownedtype *val) { return val->_value != NULL; } \
@@ -423,6 +431,7 @@ void z_session_drop(z_owned_session_t *val) { z_close(val); }
 
 OWNED_FUNCTIONS_PTR_INTERNAL(z_keyexpr_t, z_owned_keyexpr_t, keyexpr, _z_keyexpr_free, _z_keyexpr_copy)
 OWNED_FUNCTIONS_PTR_INTERNAL(z_hello_t, z_owned_hello_t, hello, _z_hello_free, _z_owner_noop_copy)
+OWNED_FUNCTIONS_PTR_INTERNAL(z_sample_t, z_owned_sample_t, sample, _z_sample_free, _z_sample_copy)
 OWNED_FUNCTIONS_PTR_INTERNAL(z_str_array_t, z_owned_str_array_t, str_array, _z_str_array_free, _z_owner_noop_copy)
 
 #define OWNED_FUNCTIONS_CLOSURE(ownedtype, name)                               \
@@ -465,7 +474,104 @@ OWNED_FUNCTIONS_CLOSURE(z_owned_closure_sample_t, closure_sample)
 OWNED_FUNCTIONS_CLOSURE(z_owned_closure_query_t, closure_query)
 OWNED_FUNCTIONS_CLOSURE(z_owned_closure_reply_t, closure_reply)
 OWNED_FUNCTIONS_CLOSURE(z_owned_closure_hello_t, closure_hello)
+z_owned_closure_matching_status_t z_closure_matching_status(_z_matching_status_handler_t call,
+                                                            _z_dropper_handler_t drop, void *context) {
+    return (z_owned_closure_matching_status_t){.call = call, .drop = drop, .context = context};
+}
+
 OWNED_FUNCTIONS_CLOSURE(z_owned_closure_zid_t, closure_zid)
+OWNED_FUNCTIONS_CLOSURE(z_owned_closure_matching_status_t, closure_matching_status)
+
+/************* Sample ring **************/
+static void __z_sample_ring_call(const _z_sample_t *sample, void *ctx) {
+    _z_sample_ring_handler_send((_z_sample_ring_handler_t *)ctx, sample);
+}
+
+static void __z_sample_ring_drop(void *ctx) {
+    _z_sample_ring_handler_t *h = (_z_sample_ring_handler_t *)ctx;
+    _z_sample_ring_handler_release(&h);
+}
+
+z_sample_ring_options_t z_sample_ring_options_default(void) {
+    return (z_sample_ring_options_t){.capacity = Z_SAMPLE_RING_CAPACITY_DEFAULT,
+                                     .policy = Z_SAMPLE_RING_POLICY_DEFAULT};
+}
+
+int8_t z_sample_ring_new(z_owned_closure_sample_t *callback, z_owned_sample_ring_t *ring,
+                         const z_sample_ring_options_t *options) {
+    z_sample_ring_options_t opt = (options == NULL) ? z_sample_ring_options_default() : *options;
+    *callback = z_closure_sample_null();
+    *ring = z_sample_ring_null();
+
+    _z_sample_ring_handler_t *h = (_z_sample_ring_handler_t *)zp_malloc(sizeof(_z_sample_ring_handler_t));
+    if (h == NULL) {
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    int8_t ret = _z_sample_ring_handler_init(h, opt.capacity, opt.policy);
+    if (ret != _Z_RES_OK) {
+        zp_free(h);
+        return ret;
+    }
+
+    // The closure and the ring share the handler, which is freed once both are dropped
+    ring->_value = h;
+    *callback = z_closure_sample(__z_sample_ring_call, __z_sample_ring_drop, _z_sample_ring_handler_acquire(h));
+
+    return _Z_RES_OK;
+}
+
+int8_t z_sample_ring_recv(const z_owned_sample_ring_t *ring, z_owned_sample_t *sample) {
+    return _z_sample_ring_handler_recv(ring->_value, &sample->_value, true);
+}
+
+int8_t z_sample_ring_try_recv(const z_owned_sample_ring_t *ring, z_owned_sample_t *sample) {
+    return _z_sample_ring_handler_recv(ring->_value, &sample->_value, false);
+}
+
+_Bool z_sample_ring_check(const z_owned_sample_ring_t *ring) { return ring->_value != NULL; }
+
+z_owned_sample_ring_t *z_sample_ring_move(z_owned_sample_ring_t *ring) { return ring; }
+
+void z_sample_ring_drop(z_owned_sample_ring_t *ring) { _z_sample_ring_handler_release(&ring->_value); }
+
+z_owned_sample_ring_t z_sample_ring_null(void) { return (z_owned_sample_ring_t){._value = NULL}; }
+
+/************* Payload **************/
+int8_t z_sample_payload_retain(const z_sample_t *sample, z_owned_payload_t *payload) {
+    int8_t ret = _Z_RES_OK;
+    payload->_value = (_z_rx_payload_t *)zp_malloc(sizeof(_z_rx_payload_t));
+    if (payload->_value != NULL) {
+        ret = _z_rx_payload_retain(payload->_value, &sample->payload, sample->_batch);
+        if (ret != _Z_RES_OK) {
+            zp_free(payload->_value);
+            payload->_value = NULL;
+        }
+    } else {
+        ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    return ret;
+}
+
+_Bool z_payload_check(const z_owned_payload_t *payload) { return payload->_value != NULL; }
+
+z_bytes_t z_payload_loan(const z_owned_payload_t *payload) {
+    return _z_bytes_wrap(payload->_value->_bytes.start, payload->_value->_bytes.len);
+}
+
+z_owned_payload_t *z_payload_move(z_owned_payload_t *payload) { return payload; }
+
+z_owned_payload_t z_payload_clone(z_owned_payload_t *payload) {
+    z_owned_payload_t ret;
+    ret._value = (_z_rx_payload_t *)zp_malloc(sizeof(_z_rx_payload_t));
+    if (ret._value != NULL) {
+        _z_rx_payload_copy(ret._value, payload->_value);
+    }
+    return ret;
+}
+
+void z_payload_drop(z_owned_payload_t *payload) { _z_rx_payload_free(&payload->_value); }
+
+z_owned_payload_t z_payload_null(void) { return (z_owned_payload_t){._value = NULL}; }
 
 /************* Primitives **************/
 typedef struct __z_hello_handler_wrapper_t {
@@ -554,13 +660,16 @@ int8_t z_close(z_owned_session_t *zs) {
 
 int8_t z_info_peers_zid(const z_session_t zs, z_owned_closure_zid_t *callback) {
     // Call transport function
-    switch (zs._val->_tp._type) {
-        case _Z_TRANSPORT_MULTICAST_TYPE:
-        case _Z_TRANSPORT_RAWETH_TYPE:
-            _zp_multicast_fetch_zid(&zs._val->_tp, callback);
-            break;
-        default:
-            break;
+    for (size_t i = 0; i < _z_session_transports_len(zs._val); i++) {
+        const _z_transport_t *zt = _z_session_transport(zs._val, i);
+        switch (zt->_type) {
+            case _Z_TRANSPORT_MULTICAST_TYPE:
+            case _Z_TRANSPORT_RAWETH_TYPE:
+                _zp_multicast_fetch_zid(zt, callback);
+                break;
+            default:
+                break;
+        }
     }
     // Note and clear context
     void *ctx = callback->context;
@@ -574,12 +683,15 @@ int8_t z_info_peers_zid(const z_session_t zs, z_owned_closure_zid_t *callback) {
 
 int8_t z_info_routers_zid(const z_session_t zs, z_owned_closure_zid_t *callback) {
     // Call transport function
-    switch (zs._val->_tp._type) {
-        case _Z_TRANSPORT_UNICAST_TYPE:
-            _zp_unicast_fetch_zid(&zs._val->_tp, callback);
-            break;
-        default:
-            break;
+    for (size_t i = 0; i < _z_session_transports_len(zs._val); i++) {
+        const _z_transport_t *zt = _z_session_transport(zs._val, i);
+        switch (zt->_type) {
+            case _Z_TRANSPORT_UNICAST_TYPE:
+                _zp_unicast_fetch_zid(zt, callback);
+                break;
+            default:
+                break;
+        }
     }
     // Note and clear context
     void *ctx = callback->context;
@@ -648,15 +760,10 @@ z_publisher_options_t z_publisher_options_default(void) {
 z_owned_publisher_t z_declare_publisher(z_session_t zs, z_keyexpr_t keyexpr, const z_publisher_options_t *options) {
     z_keyexpr_t key = keyexpr;
 
-    // TODO: Currently, if resource declarations are done over multicast transports, the current protocol definition
-    //       lacks a way to convey them to later-joining nodes. Thus, in the current version automatic
-    //       resource declarations are only performed on unicast transports.
-    if (zs._val->_tp._type == _Z_TRANSPORT_UNICAST_TYPE) {
-        _z_resource_t *r = _z_get_resource_by_key(zs._val, &keyexpr);
-        if (r == NULL) {
-            uint16_t id = _z_declare_resource(zs._val, keyexpr);
-            key = _z_rid_with_suffix(id, NULL);
-        }
+    _z_resource_t *r = _z_get_resource_by_key(zs._val, &keyexpr);
+    if (r == NULL) {
+        uint16_t id = _z_declare_resource(zs._val, keyexpr);
+        key = _z_rid_with_suffix(id, NULL);
     }
 
     z_publisher_options_t opt = z_publisher_options_default();
@@ -694,8 +801,13 @@ int8_t z_publisher_put(const z_publisher_t pub, const uint8_t *payload, size_t l
         opt.encoding = options->encoding;
     }
 
-    ret = _z_write(pub._val->_zn, pub._val->_key, payload, len, opt.encoding, Z_SAMPLE_KIND_PUT,
-                   pub._val->_congestion_control, pub._val->_priority);
+#if Z_FEATURE_MATCHING == 1
+    // Nothing is sent on the network when no remote subscriber is interested in the publication
+    if (_z_publisher_is_matching(pub._val) == true)
+#endif
+    {
+        ret = _z_publisher_write(pub._val, payload, len, opt.encoding);
+    }
 
     // Trigger local subscriptions
     _z_trigger_local_subscriptions(pub._val->_zn, pub._val->_key, payload, len);
@@ -705,6 +817,11 @@ int8_t z_publisher_put(const z_publisher_t pub, const uint8_t *payload, size_t l
 
 int8_t z_publisher_delete(const z_publisher_t pub, const z_publisher_delete_options_t *options) {
     (void)(options);
+#if Z_FEATURE_MATCHING == 1
+    if (_z_publisher_is_matching(pub._val) == false) {
+        return _Z_RES_OK;
+    }
+#endif
     return _z_write(pub._val->_zn, pub._val->_key, NULL, 0, z_encoding_default(), Z_SAMPLE_KIND_DELETE,
                     pub._val->_congestion_control, pub._val->_priority);
 }
@@ -716,6 +833,35 @@ z_owned_keyexpr_t z_publisher_keyexpr(z_publisher_t publisher) {
     }
     return ret;
 }
+
+#if Z_FEATURE_MATCHING == 1
+OWNED_FUNCTIONS_PTR_COMMON(z_matching_listener_t, z_owned_matching_listener_t, matching_listener)
+OWNED_FUNCTIONS_PTR_CLONE(z_matching_listener_t, z_owned_matching_listener_t, matching_listener, _z_owner_noop_copy)
+void z_matching_listener_drop(z_owned_matching_listener_t *val) { z_undeclare_matching_listener(val); }
+
+int8_t z_publisher_get_matching_status(const z_publisher_t pub, z_matching_status_t *status) {
+    status->matching = _z_publisher_is_matching(pub._val);
+    return _Z_RES_OK;
+}
+
+z_owned_matching_listener_t z_publisher_declare_matching_listener(z_publisher_t pub,
+                                                                  z_owned_closure_matching_status_t *callback) {
+    void *ctx = callback->context;
+    callback->context = NULL;
+
+    return (z_owned_matching_listener_t){
+        ._value = _z_declare_matching_listener(pub._val, callback->call, callback->drop, ctx)};
+}
+
+int8_t z_undeclare_matching_listener(z_owned_matching_listener_t *listener) {
+    int8_t ret = _Z_RES_OK;
+
+    ret = _z_undeclare_matching_listener(listener->_value);
+    _z_matching_listener_free(&listener->_value);
+
+    return ret;
+}
+#endif
 #endif
 
 #if Z_FEATURE_QUERY == 1
@@ -724,7 +870,8 @@ OWNED_FUNCTIONS_PTR_INTERNAL(z_reply_t, z_owned_reply_t, reply, _z_reply_free, _
 z_get_options_t z_get_options_default(void) {
     return (z_get_options_t){.target = z_query_target_default(),
                              .consolidation = z_query_consolidation_default(),
-                             .value = {.encoding = z_encoding_default(), .payload = _z_bytes_empty()}};
+                             .value = {.encoding = z_encoding_default(), .payload = _z_bytes_empty()},
+                             .timeout_ms = Z_GET_TIMEOUT_DEFAULT};
 }
 
 typedef struct __z_reply_handler_wrapper_t {
@@ -751,6 +898,7 @@ int8_t z_get(z_session_t zs, z_keyexpr_t keyexpr, const char *parameters, z_owne
         opt.consolidation = options->consolidation;
         opt.target = options->target;
         opt.value = options->value;
+        opt.timeout_ms = options->timeout_ms;
     }
 
     if (opt.consolidation.mode == Z_CONSOLIDATION_MODE_AUTO) {
@@ -771,23 +919,22 @@ int8_t z_get(z_session_t zs, z_keyexpr_t keyexpr, const char *parameters, z_owne
         wrapped_ctx->ctx = ctx;
     }
 
-    ret = _z_query(zs._val, keyexpr, parameters, opt.target, opt.consolidation.mode, opt.value, __z_reply_handler,
-                   wrapped_ctx, callback->drop, ctx);
+    ret = _z_query(zs._val, keyexpr, parameters, opt.target, opt.consolidation.mode, opt.value, opt.timeout_ms,
+                   __z_reply_handler, wrapped_ctx, callback->drop, ctx);
     return ret;
 }
 
-_Bool z_reply_is_ok(const z_owned_reply_t *reply) {
-    (void)(reply);
-    // For the moment always return TRUE.
-    // The support for reply errors will come in the next release.
-    return true;
-}
+_Bool z_reply_is_ok(const z_owned_reply_t *reply) { return reply->_value->_tag != Z_REPLY_TAG_ERROR; }
 
 z_sample_t z_reply_ok(const z_owned_reply_t *reply) { return reply->_value->data.sample; }
 
 z_value_t z_reply_err(const z_owned_reply_t *reply) {
-    (void)(reply);
-    return (z_value_t){.payload = _z_bytes_empty(), .encoding = z_encoding_default()};
+    z_value_t err = {.payload = _z_bytes_empty(), .encoding = z_encoding_default()};
+    if (reply->_value->_tag == Z_REPLY_TAG_ERROR) {
+        err.payload = reply->_value->data.sample.payload;
+        err.encoding = reply->_value->data.sample.encoding;
+    }
+    return err;
 }
 #endif
 
@@ -807,15 +954,10 @@ z_owned_queryable_t z_declare_queryable(z_session_t zs, z_keyexpr_t keyexpr, z_o
 
     z_keyexpr_t key = keyexpr;
 
-    // TODO: Currently, if resource declarations are done over multicast transports, the current protocol definition
-    //       lacks a way to convey them to later-joining nodes. Thus, in the current version automatic
-    //       resource declarations are only performed on unicast transports.
-    if (zs._val->_tp._type == _Z_TRANSPORT_UNICAST_TYPE) {
-        _z_resource_t *r = _z_get_resource_by_key(zs._val, &keyexpr);
-        if (r == NULL) {
-            uint16_t id = _z_declare_resource(zs._val, keyexpr);
-            key = _z_rid_with_suffix(id, NULL);
-        }
+    _z_resource_t *r = _z_get_resource_by_key(zs._val, &keyexpr);
+    if (r == NULL) {
+        uint16_t id = _z_declare_resource(zs._val, keyexpr);
+        key = _z_rid_with_suffix(id, NULL);
     }
 
     z_queryable_options_t opt = z_queryable_options_default();
@@ -910,32 +1052,27 @@ z_owned_subscriber_t z_declare_subscriber(z_session_t zs, z_keyexpr_t keyexpr, z
     char *suffix = NULL;
 
     z_keyexpr_t key = keyexpr;
-    // TODO: Currently, if resource declarations are done over multicast transports, the current protocol definition
-    //       lacks a way to convey them to later-joining nodes. Thus, in the current version automatic
-    //       resource declarations are only performed on unicast transports.
-    if (zs._val->_tp._type == _Z_TRANSPORT_UNICAST_TYPE) {
-        _z_resource_t *r = _z_get_resource_by_key(zs._val, &keyexpr);
-        if (r == NULL) {
-            char *wild = strpbrk(keyexpr._suffix, "*$");
-            _Bool do_keydecl = true;
-            if (wild != NULL && wild != keyexpr._suffix) {
-                wild -= 1;
-                size_t len = wild - keyexpr._suffix;
-                suffix = zp_malloc(len + 1);
-                if (suffix != NULL) {
-                    memcpy(suffix, keyexpr._suffix, len);
-                    suffix[len] = 0;
-                    keyexpr._suffix = suffix;
-                    _z_keyexpr_set_owns_suffix(&keyexpr, false);
-                } else {
-                    do_keydecl = false;
-                }
-            }
-            if (do_keydecl) {
-                uint16_t id = _z_declare_resource(zs._val, keyexpr);
-                key = _z_rid_with_suffix(id, wild);
+    _z_resource_t *r = _z_get_resource_by_key(zs._val, &keyexpr);
+    if (r == NULL) {
+        char *wild = strpbrk(keyexpr._suffix, "*$");
+        _Bool do_keydecl = true;
+        if (wild != NULL && wild != keyexpr._suffix) {
+            wild -= 1;
+            size_t len = wild - keyexpr._suffix;
+            suffix = zp_malloc(len + 1);
+            if (suffix != NULL) {
+                memcpy(suffix, keyexpr._suffix, len);
+                suffix[len] = 0;
+                keyexpr._suffix = suffix;
+                _z_keyexpr_set_owns_suffix(&keyexpr, false);
+            } else {
+                do_keydecl = false;
             }
         }
+        if (do_keydecl) {
+            uint16_t id = _z_declare_resource(zs._val, keyexpr);
+            key = _z_rid_with_suffix(id, wild);
+        }
     }
 
     _z_subinfo_t subinfo = _z_subinfo_push_default();
@@ -1084,6 +1221,39 @@ int8_t zp_stop_lease_task(z_session_t zs) {
 #endif
 }
 
+zp_task_tx_options_t zp_task_tx_options_default(void) {
+    return (zp_task_tx_options_t) {
+#if Z_FEATURE_MULTI_THREAD == 1
+        .task_attributes = NULL
+#else
+        .__dummy = 0
+#endif
+    };
+}
+
+int8_t zp_start_tx_task(z_session_t zs, const zp_task_tx_options_t *options) {
+    (void)(options);
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_task_tx_options_t opt = zp_task_tx_options_default();
+    if (options != NULL) {
+        opt.task_attributes = options->task_attributes;
+    }
+    return _zp_start_tx_task(zs._val, opt.task_attributes);
+#else
+    (void)(zs);
+    return -1;
+#endif
+}
+
+int8_t zp_stop_tx_task(z_session_t zs) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    return _zp_stop_tx_task(zs._val);
+#else
+    (void)(zs);
+    return -1;
+#endif
+}
+
 zp_read_options_t zp_read_options_default(void) { return (zp_read_options_t){.__dummy = 0}; }
 
 int8_t zp_read(z_session_t zs, const zp_read_options_t *options) {
@@ -1100,9 +1270,39 @@ int8_t zp_send_keep_alive(z_session_t zs, const zp_send_keep_alive_options_t *op
     return _zp_send_keep_alive(zs._val);
 }
 
+zp_flush_options_t zp_flush_options_default(void) { return (zp_flush_options_t){.__dummy = 0}; }
+
+int8_t zp_flush(z_session_t zs, const zp_flush_options_t *options) {
+    (void)(options);
+    return _zp_flush(zs._val);
+}
+
 zp_send_join_options_t zp_send_join_options_default(void) { return (zp_send_join_options_t){.__dummy = 0}; }
 
 int8_t zp_send_join(z_session_t zs, const zp_send_join_options_t *options) {
     (void)(options);
     return _zp_send_join(zs._val);
 }
+
+#if Z_FEATURE_MEMORY_POOL == 1
+int8_t zp_memory_pool_stats(size_t cls, zp_memory_pool_stats_t *stats) { return _z_pool_stats(cls, stats); }
+#endif
+
+#if Z_FEATURE_STATS == 1
+int8_t zp_stats_get(z_session_t zs, zp_stats_t *stats) {
+    _z_session_stats(zs._val, stats);
+    return _Z_RES_OK;
+}
+#endif
+
+#if Z_FEATURE_REACTOR == 1
+int8_t zp_reactor_init(zp_reactor_t *reactor) { return _z_reactor_init(reactor); }
+
+void zp_reactor_free(zp_reactor_t *reactor) { _z_reactor_clear(reactor); }
+
+int8_t zp_reactor_add(zp_reactor_t *reactor, z_session_t zs) { return _z_reactor_add(reactor, zs._val); }
+
+int8_t zp_reactor_remove(zp_reactor_t *reactor, z_session_t zs) { return _z_reactor_remove(reactor, zs._val); }
+
+int8_t zp_reactor_run(zp_reactor_t *reactor, uint32_t timeout_ms) { return _z_reactor_run(reactor, timeout_ms); }
+#endif
@@ -0,0 +1,178 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/api/handlers.h"
+
+#include <stddef.h>
+
+#include "zenoh-pico/utils/logging.h"
+#include "zenoh-pico/utils/result.h"
+
+/*------------------ Sample ring handler ------------------*/
+int8_t _z_sample_ring_handler_init(_z_sample_ring_handler_t *h, size_t capacity, z_sample_ring_policy_t policy) {
+    int8_t ret = _z_sample_ring_init(&h->_ring, capacity);
+    h->_policy = policy;
+    _z_atomic_store_explicit(&h->_refs, 1U, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&h->_closed, false, _z_memory_order_relaxed);
+#if Z_FEATURE_MULTI_THREAD == 1
+    _z_atomic_store_explicit(&h->_rx_waiting, false, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&h->_tx_waiting, false, _z_memory_order_relaxed);
+    if (ret == _Z_RES_OK) {
+        ret = zp_mutex_init(&h->_mutex);
+        if (ret == _Z_RES_OK) {
+            ret = zp_condvar_init(&h->_cv);
+            if (ret != _Z_RES_OK) {
+                zp_mutex_free(&h->_mutex);
+            }
+        }
+        if (ret != _Z_RES_OK) {
+            _z_sample_ring_clear(&h->_ring);
+        }
+    }
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    return ret;
+}
+
+void _z_sample_ring_handler_clear(_z_sample_ring_handler_t *h) {
+    _z_sample_ring_clear(&h->_ring);
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_condvar_free(&h->_cv);
+    zp_mutex_free(&h->_mutex);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+static void __z_sample_ring_handler_wake(_z_sample_ring_handler_t *h, _z_atomic(_Bool) * waiting) {
+    // Pairs with the fence of the waiting side: either it sees the ring update, or we see it waiting
+    _z_atomic_thread_fence(_z_memory_order_seq_cst);
+    if (_z_atomic_load_explicit(waiting, _z_memory_order_relaxed) == true) {
+        zp_mutex_lock(&h->_mutex);
+        zp_condvar_signal(&h->_cv);
+        zp_mutex_unlock(&h->_mutex);
+    }
+}
+
+static void __z_sample_ring_handler_wait(_z_sample_ring_handler_t *h, _z_atomic(_Bool) * waiting, _Bool for_data) {
+    zp_mutex_lock(&h->_mutex);
+    _z_atomic_store_explicit(waiting, true, _z_memory_order_relaxed);
+    _z_atomic_thread_fence(_z_memory_order_seq_cst);
+    // Check again under the mutex, a wake up can only be signaled once we wait on the condition variable
+    _Bool ready = (for_data == true) ? (_z_sample_ring_is_empty(&h->_ring) == false)
+                                     : (_z_sample_ring_is_full(&h->_ring) == false);
+    if ((ready == false) && (_z_atomic_load_explicit(&h->_closed, _z_memory_order_acquire) == false)) {
+        zp_condvar_wait(&h->_cv, &h->_mutex);
+    }
+    _z_atomic_store_explicit(waiting, false, _z_memory_order_relaxed);
+    zp_mutex_unlock(&h->_mutex);
+}
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+void _z_sample_ring_handler_close(_z_sample_ring_handler_t *h) {
+    _z_atomic_store_explicit(&h->_closed, true, _z_memory_order_release);
+#if Z_FEATURE_MULTI_THREAD == 1
+    // Only one side may be waiting at a time, the ring cannot be both empty and full
+    zp_mutex_lock(&h->_mutex);
+    zp_condvar_signal(&h->_cv);
+    zp_mutex_unlock(&h->_mutex);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+_z_sample_ring_handler_t *_z_sample_ring_handler_acquire(_z_sample_ring_handler_t *h) {
+    _z_atomic_fetch_add_explicit(&h->_refs, 1U, _z_memory_order_relaxed);
+    return h;
+}
+
+void _z_sample_ring_handler_release(_z_sample_ring_handler_t **h) {
+    _z_sample_ring_handler_t *ptr = *h;
+
+    if (ptr != NULL) {
+        _z_sample_ring_handler_close(ptr);
+        if (_z_atomic_fetch_sub_explicit(&ptr->_refs, 1U, _z_memory_order_release) == 1U) {
+            _z_atomic_thread_fence(_z_memory_order_acquire);
+            _z_sample_ring_handler_clear(ptr);
+            zp_free(ptr);
+        }
+        *h = NULL;
+    }
+}
+
+void _z_sample_ring_handler_send(_z_sample_ring_handler_t *h, const _z_sample_t *sample) {
+    if (_z_atomic_load_explicit(&h->_closed, _z_memory_order_acquire) == true) {
+        return;
+    }
+
+    _z_sample_t *s = (_z_sample_t *)_z_sample_elem_clone(sample);
+    if (s == NULL) {
+        _Z_ERROR("Failed to copy a sample into the ring handler");
+        return;
+    }
+
+    switch (h->_policy) {
+        case Z_SAMPLE_RING_POLICY_DROP_OLDEST: {
+            s = _z_sample_ring_push_force(&h->_ring, s);
+        } break;
+
+        case Z_SAMPLE_RING_POLICY_BLOCK: {
+            s = _z_sample_ring_push(&h->_ring, s);
+#if Z_FEATURE_MULTI_THREAD == 1
+            while ((s != NULL) && (_z_atomic_load_explicit(&h->_closed, _z_memory_order_acquire) == false)) {
+                __z_sample_ring_handler_wait(h, &h->_tx_waiting, false);
+                s = _z_sample_ring_push(&h->_ring, s);
+            }
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+        } break;
+
+        case Z_SAMPLE_RING_POLICY_DROP_NEWEST:
+        default: {
+            s = _z_sample_ring_push(&h->_ring, s);
+        } break;
+    }
+
+    // Free either the evicted or the rejected sample
+    _z_sample_elem_free((void **)&s);
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    __z_sample_ring_handler_wake(h, &h->_rx_waiting);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+int8_t _z_sample_ring_handler_recv(_z_sample_ring_handler_t *h, _z_sample_t **sample, _Bool block) {
+    *sample = _z_sample_ring_pull(&h->_ring);
+#if Z_FEATURE_MULTI_THREAD == 1
+    while ((*sample == NULL) && (block == true) &&
+           (_z_atomic_load_explicit(&h->_closed, _z_memory_order_acquire) == false)) {
+        __z_sample_ring_handler_wait(h, &h->_rx_waiting, true);
+        *sample = _z_sample_ring_pull(&h->_ring);
+    }
+#else
+    _ZP_UNUSED(block);  // The samples are pushed by zp_read, in the same thread
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (*sample != NULL) {
+#if Z_FEATURE_MULTI_THREAD == 1
+        __z_sample_ring_handler_wake(h, &h->_tx_waiting);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+        return _Z_RES_OK;
+    }
+
+    // Drain the samples received before the ring was closed
+    if (_z_atomic_load_explicit(&h->_closed, _z_memory_order_acquire) == true) {
+        *sample = _z_sample_ring_pull(&h->_ring);
+        if (*sample == NULL) {
+            return _Z_ERR_CONNECTION_CLOSED;
+        }
+    }
+    return _Z_RES_OK;
+}
@@ -78,10 +78,15 @@ void _z_bytes_free(_z_bytes_t **bs) {
 }
 
 void _z_bytes_copy(_z_bytes_t *dst, const _z_bytes_t *src) {
-    int8_t ret =
-        _z_bytes_init(dst, src->len);  // FIXME: it should check if dst is already initialized. Otherwise it will leak
-    if (ret == _Z_RES_OK) {
-        (void)memcpy((uint8_t *)dst->start, src->start, src->len);
+    // An empty payload has nothing to copy, and may not even have a start
+    if ((src->len == (size_t)0) || (src->start == NULL)) {
+        *dst = _z_bytes_empty();
+    } else {
+        int8_t ret = _z_bytes_init(
+            dst, src->len);  // FIXME: it should check if dst is already initialized. Otherwise it will leak
+        if (ret == _Z_RES_OK) {
+            (void)memcpy((uint8_t *)dst->start, src->start, src->len);
+        }
     }
 }
 
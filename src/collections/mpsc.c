@@ -0,0 +1,120 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/collections/mpsc.h"
+
+#include <stddef.h>
+
+#include "zenoh-pico/utils/result.h"
+
+/*-------- Multi-producer single-consumer queue --------*/
+int8_t _z_mpsc_init(_z_mpsc_t *q, size_t capacity) {
+    q->_slots = NULL;
+    q->_mask = 0;
+    _z_atomic_store_explicit(&q->_r_idx, (size_t)0, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&q->_w_idx, (size_t)0, _z_memory_order_relaxed);
+    if (capacity == (size_t)0) {
+        return _Z_ERR_GENERIC;
+    }
+
+    // A single slot could be reserved again by a producer before the consumer pulled it, at least two are needed
+    size_t slots = 2;
+    while (slots < capacity) {
+        slots = slots << 1;
+    }
+    q->_slots = (_z_mpsc_slot_t *)zp_malloc(slots * sizeof(_z_mpsc_slot_t));
+    if (q->_slots == NULL) {
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < slots; i++) {
+        // The slot i is free for the producer of the index i
+        _z_atomic_store_explicit(&q->_slots[i]._seq, i, _z_memory_order_relaxed);
+        q->_slots[i]._val = NULL;
+    }
+    q->_mask = slots - (size_t)1;
+
+    return _Z_RES_OK;
+}
+
+size_t _z_mpsc_capacity(const _z_mpsc_t *q) { return (q->_slots != NULL) ? q->_mask + (size_t)1 : (size_t)0; }
+
+size_t _z_mpsc_len(const _z_mpsc_t *q) {
+    size_t rd = _z_atomic_load_explicit((_z_atomic(size_t) *)&q->_r_idx, _z_memory_order_acquire);
+    size_t w = _z_atomic_load_explicit((_z_atomic(size_t) *)&q->_w_idx, _z_memory_order_acquire);
+    // The reserved slots are counted even if their element is not published yet
+    return w - rd;
+}
+
+_Bool _z_mpsc_is_empty(const _z_mpsc_t *q) { return _z_mpsc_len(q) == (size_t)0; }
+
+void *_z_mpsc_push(_z_mpsc_t *q, void *e) {
+    _z_mpsc_slot_t *slot = NULL;
+
+    size_t w = _z_atomic_load_explicit(&q->_w_idx, _z_memory_order_relaxed);
+    while (slot == NULL) {
+        _z_mpsc_slot_t *s = &q->_slots[w & q->_mask];
+        size_t seq = _z_atomic_load_explicit(&s->_seq, _z_memory_order_acquire);
+        if (seq == w) {
+            // The slot is free, reserve it unless another producer does first, w is then reloaded
+            if (_z_atomic_compare_exchange_strong_explicit(&q->_w_idx, &w, w + (size_t)1, _z_memory_order_relaxed,
+                                                           _z_memory_order_relaxed) == true) {
+                slot = s;
+            }
+        } else if ((ptrdiff_t)(seq - w) < 0) {
+            // The slot still holds the element of the previous round, the queue is full
+            return e;
+        } else {
+            // Another producer reserved this index in the meantime
+            w = _z_atomic_load_explicit(&q->_w_idx, _z_memory_order_relaxed);
+        }
+    }
+
+    slot->_val = e;
+    _z_atomic_store_explicit(&slot->_seq, w + (size_t)1, _z_memory_order_release);  // Publish the element
+    return NULL;
+}
+
+void *_z_mpsc_pull(_z_mpsc_t *q) {
+    size_t rd = _z_atomic_load_explicit(&q->_r_idx, _z_memory_order_relaxed);  // Only written by the consumer
+    _z_mpsc_slot_t *s = &q->_slots[rd & q->_mask];
+    if (_z_atomic_load_explicit(&s->_seq, _z_memory_order_acquire) != rd + (size_t)1) {
+        // Either empty, or the producer of this index has not published its element yet
+        return NULL;
+    }
+
+    void *e = s->_val;
+    s->_val = NULL;
+    _z_atomic_store_explicit(&q->_r_idx, rd + (size_t)1, _z_memory_order_release);
+    // Free the slot for the producer of the next round
+    _z_atomic_store_explicit(&s->_seq, rd + q->_mask + (size_t)1, _z_memory_order_release);
+    return e;
+}
+
+_Bool _z_mpsc_can_pull(const _z_mpsc_t *q) {
+    size_t rd = _z_atomic_load_explicit((_z_atomic(size_t) *)&q->_r_idx, _z_memory_order_relaxed);
+    _z_mpsc_slot_t *s = &q->_slots[rd & q->_mask];
+    return _z_atomic_load_explicit(&s->_seq, _z_memory_order_acquire) == rd + (size_t)1;
+}
+
+void _z_mpsc_clear(_z_mpsc_t *q, z_element_free_f f) {
+    if (q->_slots != NULL) {
+        void *e = _z_mpsc_pull(q);
+        while (e != NULL) {
+            f(&e);
+            e = _z_mpsc_pull(q);
+        }
+        zp_free(q->_slots);
+    }
+    (void)_z_mpsc_init(q, 0);
+}
@@ -0,0 +1,118 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/collections/ring.h"
+
+#include <stddef.h>
+
+#include "zenoh-pico/utils/result.h"
+
+/*-------- Single-producer single-consumer ring --------*/
+int8_t _z_ring_init(_z_ring_t *r, size_t capacity) {
+    r->_vals = NULL;
+    r->_capacity = 0;
+    r->_mask = 0;
+    _z_atomic_store_explicit(&r->_r_idx, (size_t)0, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&r->_w_idx, (size_t)0, _z_memory_order_relaxed);
+    if (capacity == (size_t)0) {
+        return _Z_ERR_GENERIC;
+    }
+
+    // The slots are a power of two, so that masking the indexes stays consistent when they wrap around
+    size_t slots = 1;
+    while (slots < capacity) {
+        slots = slots << 1;
+    }
+    r->_vals = (_z_atomic(_z_ring_val_t) *)zp_malloc(slots * sizeof(_z_atomic(_z_ring_val_t)));
+    if (r->_vals == NULL) {
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    for (size_t i = 0; i < slots; i++) {
+        _z_atomic_store_explicit(&r->_vals[i], NULL, _z_memory_order_relaxed);
+    }
+    r->_capacity = capacity;
+    r->_mask = slots - (size_t)1;
+
+    return _Z_RES_OK;
+}
+
+size_t _z_ring_capacity(const _z_ring_t *r) { return r->_capacity; }
+
+size_t _z_ring_len(const _z_ring_t *r) {
+    size_t rd = _z_atomic_load_explicit((_z_atomic(size_t) *)&r->_r_idx, _z_memory_order_acquire);
+    size_t w = _z_atomic_load_explicit((_z_atomic(size_t) *)&r->_w_idx, _z_memory_order_acquire);
+    return w - rd;
+}
+
+_Bool _z_ring_is_empty(const _z_ring_t *r) { return _z_ring_len(r) == (size_t)0; }
+
+_Bool _z_ring_is_full(const _z_ring_t *r) { return _z_ring_len(r) >= r->_capacity; }
+
+void *_z_ring_push(_z_ring_t *r, void *e) {
+    size_t w = _z_atomic_load_explicit(&r->_w_idx, _z_memory_order_relaxed);  // Only written by the producer
+    size_t rd = _z_atomic_load_explicit(&r->_r_idx, _z_memory_order_acquire);
+    if ((w - rd) >= r->_capacity) {
+        return e;
+    }
+
+    _z_atomic_store_explicit(&r->_vals[w & r->_mask], e, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&r->_w_idx, w + (size_t)1, _z_memory_order_release);
+    return NULL;
+}
+
+void *_z_ring_push_force(_z_ring_t *r, void *e) {
+    void *evicted = NULL;
+
+    size_t w = _z_atomic_load_explicit(&r->_w_idx, _z_memory_order_relaxed);  // Only written by the producer
+    size_t rd = _z_atomic_load_explicit(&r->_r_idx, _z_memory_order_acquire);
+    while ((w - rd) >= r->_capacity) {
+        // Evict the oldest element, unless the consumer pulls it first
+        void *oldest = _z_atomic_load_explicit(&r->_vals[rd & r->_mask], _z_memory_order_relaxed);
+        if (_z_atomic_compare_exchange_strong_explicit(&r->_r_idx, &rd, rd + (size_t)1, _z_memory_order_acq_rel,
+                                                       _z_memory_order_acquire) == true) {
+            evicted = oldest;
+            break;
+        }
+    }
+
+    _z_atomic_store_explicit(&r->_vals[w & r->_mask], e, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&r->_w_idx, w + (size_t)1, _z_memory_order_release);
+    return evicted;
+}
+
+void *_z_ring_pull(_z_ring_t *r) {
+    size_t rd = _z_atomic_load_explicit(&r->_r_idx, _z_memory_order_acquire);
+    for (;;) {
+        size_t w = _z_atomic_load_explicit(&r->_w_idx, _z_memory_order_acquire);
+        if (rd == w) {
+            return NULL;
+        }
+        void *e = _z_atomic_load_explicit(&r->_vals[rd & r->_mask], _z_memory_order_relaxed);
+        // A failed swap means the producer evicted the element, rd is then reloaded with the current read index
+        if (_z_atomic_compare_exchange_strong_explicit(&r->_r_idx, &rd, rd + (size_t)1, _z_memory_order_acq_rel,
+                                                       _z_memory_order_acquire) == true) {
+            return e;
+        }
+    }
+}
+
+void _z_ring_clear(_z_ring_t *r, z_element_free_f f) {
+    void *e = _z_ring_pull(r);
+    while (e != NULL) {
+        f(&e);
+        e = _z_ring_pull(r);
+    }
+    zp_free((void *)r->_vals);
+    (void)_z_ring_init(r, 0);
+}
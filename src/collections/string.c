@@ -126,6 +126,16 @@ char *_z_str_clone(const char *src) {
 
 _Bool _z_str_eq(const char *left, const char *right) { return strcmp(left, right) == 0; }
 
+size_t _z_str_hash(const char *src, size_t len) {
+    // FNV-1a
+    size_t hash = (size_t)2166136261U;
+    for (size_t i = 0; i < len; i++) {
+        hash = hash ^ (size_t)(uint8_t)src[i];
+        hash = hash * (size_t)16777619U;
+    }
+    return hash;
+}
+
 /*-------- str_array --------*/
 void _z_str_array_init(_z_str_array_t *sa, size_t len) {
     char **val = (char **)&sa->val;
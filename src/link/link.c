@@ -147,6 +147,111 @@ size_t _z_link_recv_exact_zbuf(const _z_link_t *link, _z_zbuf_t *zbf, size_t len
     return rb;
 }
 
+size_t _z_link_batch_max(const _z_link_t *link) {
+    return ((link->_write_batch_f != NULL) && (link->_read_batch_f != NULL)) ? (size_t)_Z_LINK_BATCH_MAX : (size_t)1;
+}
+
+size_t _z_link_recv_batch_zbuf(const _z_link_t *link, _z_zbuf_t *zbf, size_t *lens, _z_bytes_t *addrs) {
+    size_t rn = SIZE_MAX;
+#if _Z_LINK_BATCH_MAX > 1
+    _z_zbuf_reset(zbf);
+    size_t count = _z_zbuf_capacity(zbf) / (size_t)Z_UDP_BATCH_IO_SLOT_SIZE;
+    if (count > (size_t)_Z_LINK_BATCH_MAX) {
+        count = _Z_LINK_BATCH_MAX;
+    }
+    if ((link->_read_batch_f != NULL) && (count > (size_t)0)) {
+        rn = link->_read_batch_f(link, _z_zbuf_get_wptr(zbf), Z_UDP_BATCH_IO_SLOT_SIZE, count, lens, addrs);
+        if (rn != SIZE_MAX) {
+            _z_zbuf_set_wpos(zbf, rn * (size_t)Z_UDP_BATCH_IO_SLOT_SIZE);
+        }
+    }
+#else
+    _ZP_UNUSED(link);
+    _ZP_UNUSED(zbf);
+    _ZP_UNUSED(lens);
+    _ZP_UNUSED(addrs);
+#endif
+    return rn;
+}
+
+int8_t _z_link_send_wbufs(const _z_link_t *link, const _z_wbuf_t *wbfs, size_t count) {
+    int8_t ret = _Z_RES_OK;
+
+#if _Z_LINK_BATCH_MAX > 1
+    _Bool batched = (link->_write_batch_f != NULL) && (count > (size_t)1) && (count <= (size_t)_Z_LINK_BATCH_MAX);
+    _z_bytes_t bufs[_Z_LINK_BATCH_MAX];
+    for (size_t i = 0; (i < count) && (batched == true); i++) {
+        if (_z_wbuf_len_iosli(&wbfs[i]) == (size_t)1) {
+            bufs[i] = _z_iosli_to_bytes(_z_wbuf_get_iosli(&wbfs[i], 0));
+        } else {
+            batched = false;
+        }
+    }
+    if (batched == true) {
+        // A write may send part of the datagrams, in which case the remaining ones are sent again
+        size_t first = 0;
+        while (first < count) {
+            size_t wn = link->_write_batch_f(link, &bufs[first], count - first);
+            if ((wn == SIZE_MAX) || (wn == (size_t)0)) {
+                ret = _Z_ERR_TRANSPORT_TX_FAILED;
+                break;
+            }
+            first = first + wn;
+        }
+    } else
+#endif
+    {
+        for (size_t i = 0; (i < count) && (ret == _Z_RES_OK); i++) {
+            ret = _z_link_send_wbuf(link, &wbfs[i]);
+        }
+    }
+
+    return ret;
+}
+
+size_t _z_link_write_vec_max(const _z_link_t *link) {
+    return (link->_write_vec_f != NULL) ? (size_t)_Z_LINK_WRITE_VEC_MAX : (size_t)0;
+}
+
+#if _Z_LINK_WRITE_VEC_MAX > 0
+static int8_t __z_link_send_wbuf_vec(const _z_link_t *link, const _z_wbuf_t *wbf, _Bool link_is_streamed) {
+    int8_t ret = _Z_RES_OK;
+
+    _z_bytes_t bufs[_Z_LINK_WRITE_VEC_MAX];
+    size_t count = 0;
+    size_t len = 0;
+    for (size_t i = 0; i < _z_wbuf_len_iosli(wbf); i++) {
+        _z_bytes_t bs = _z_iosli_to_bytes(_z_wbuf_get_iosli(wbf, i));
+        if (bs.len > (size_t)0) {
+            bufs[count] = bs;
+            count = count + (size_t)1;
+            len = len + bs.len;
+        }
+    }
+
+    // Streams may accept part of the data, in which case the remaining buffers are sent again
+    size_t first = 0;
+    while ((ret == _Z_RES_OK) && (len > (size_t)0)) {
+        size_t wb = link->_write_vec_f(link, &bufs[first], count - first);
+        if ((wb == SIZE_MAX) || ((link_is_streamed == false) && (wb != len))) {
+            ret = _Z_ERR_TRANSPORT_TX_FAILED;
+            break;
+        }
+        len = len - wb;
+        while ((wb > (size_t)0) && (wb >= bufs[first].len)) {
+            wb = wb - bufs[first].len;
+            first = first + (size_t)1;
+        }
+        if (wb > (size_t)0) {
+            bufs[first].start = bufs[first].start + wb;
+            bufs[first].len = bufs[first].len - wb;
+        }
+    }
+
+    return ret;
+}
+#endif
+
 int8_t _z_link_send_wbuf(const _z_link_t *link, const _z_wbuf_t *wbf) {
     int8_t ret = _Z_RES_OK;
     _Bool link_is_streamed = false;
@@ -160,22 +265,31 @@ int8_t _z_link_send_wbuf(const _z_link_t *link, const _z_wbuf_t *wbf) {
             link_is_streamed = false;
             break;
     }
-    for (size_t i = 0; (i < _z_wbuf_len_iosli(wbf)) && (ret == _Z_RES_OK); i++) {
-        _z_bytes_t bs = _z_iosli_to_bytes(_z_wbuf_get_iosli(wbf, i));
-        size_t n = bs.len;
-        do {
-            size_t wb = link->_write_f(link, bs.start, n);
-            if (wb == SIZE_MAX) {
-                ret = _Z_ERR_TRANSPORT_TX_FAILED;
-                break;
-            }
-            if (link_is_streamed && wb != n) {
-                ret = _Z_ERR_TRANSPORT_TX_FAILED;
-                break;
-            }
-            n = n - wb;
-            bs.start = bs.start + (bs.len - n);
-        } while (n > (size_t)0);
+
+#if _Z_LINK_WRITE_VEC_MAX > 0
+    // Send all the slices of a multi-slice buffer in a single write
+    if ((_z_wbuf_len_iosli(wbf) > (size_t)1) && (_z_wbuf_len_iosli(wbf) <= _z_link_write_vec_max(link))) {
+        ret = __z_link_send_wbuf_vec(link, wbf, link_is_streamed);
+    } else
+#endif
+    {
+        for (size_t i = 0; (i < _z_wbuf_len_iosli(wbf)) && (ret == _Z_RES_OK); i++) {
+            _z_bytes_t bs = _z_iosli_to_bytes(_z_wbuf_get_iosli(wbf, i));
+            size_t n = bs.len;
+            do {
+                size_t wb = link->_write_f(link, bs.start, n);
+                if (wb == SIZE_MAX) {
+                    ret = _Z_ERR_TRANSPORT_TX_FAILED;
+                    break;
+                }
+                if (link_is_streamed && wb != n) {
+                    ret = _Z_ERR_TRANSPORT_TX_FAILED;
+                    break;
+                }
+                n = n - wb;
+                bs.start = bs.start + (bs.len - n);
+            } while (n > (size_t)0);
+        }
     }
 
     return ret;
@@ -155,6 +155,12 @@ size_t _z_f_link_write_all_udp_multicast(const _z_link_t *self, const uint8_t *p
     return _z_send_udp_multicast(self->_socket._udp._msock, ptr, len, self->_socket._udp._rep);
 }
 
+#ifdef _Z_SYS_NET_SEND_VEC_MAX
+size_t _z_f_link_write_vec_udp_multicast(const _z_link_t *self, const _z_bytes_t *bufs, size_t count) {
+    return _z_send_vec_udp_multicast(self->_socket._udp._msock, bufs, count, self->_socket._udp._rep);
+}
+#endif
+
 size_t _z_f_link_read_udp_multicast(const _z_link_t *self, uint8_t *ptr, size_t len, _z_bytes_t *addr) {
     return _z_read_udp_multicast(self->_socket._udp._sock, ptr, len, self->_socket._udp._lep, addr);
 }
@@ -163,6 +169,20 @@ size_t _z_f_link_read_exact_udp_multicast(const _z_link_t *self, uint8_t *ptr, s
     return _z_read_exact_udp_multicast(self->_socket._udp._sock, ptr, len, self->_socket._udp._lep, addr);
 }
 
+#ifdef _Z_SYS_NET_BATCH_MAX
+size_t _z_f_link_write_batch_udp_multicast(const _z_link_t *self, const _z_bytes_t *bufs, size_t count) {
+    return _z_send_batch_udp_multicast(self->_socket._udp._msock, bufs, count, self->_socket._udp._rep);
+}
+
+size_t _z_f_link_read_batch_udp_multicast(const _z_link_t *self, uint8_t *ptr, size_t stride, size_t count,
+                                          size_t *lens, _z_bytes_t *addrs) {
+    return _z_read_batch_udp_multicast(self->_socket._udp._sock, ptr, stride, count, lens, self->_socket._udp._lep,
+                                       addrs);
+}
+#endif
+
+const _z_sys_net_socket_t *_z_f_link_rx_socket_udp_multicast(const _z_link_t *self) { return &self->_socket._udp._sock; }
+
 uint16_t _z_get_link_mtu_udp_multicast(void) {
     // @TODO: the return value should change depending on the target platform.
     return 1450;
@@ -192,8 +212,21 @@ int8_t _z_new_link_udp_multicast(_z_link_t *zl, _z_endpoint_t endpoint) {
 
     zl->_write_f = _z_f_link_write_udp_multicast;
     zl->_write_all_f = _z_f_link_write_all_udp_multicast;
+#ifdef _Z_SYS_NET_SEND_VEC_MAX
+    zl->_write_vec_f = _z_f_link_write_vec_udp_multicast;
+#else
+    zl->_write_vec_f = NULL;
+#endif
     zl->_read_f = _z_f_link_read_udp_multicast;
     zl->_read_exact_f = _z_f_link_read_exact_udp_multicast;
+#ifdef _Z_SYS_NET_BATCH_MAX
+    zl->_write_batch_f = _z_f_link_write_batch_udp_multicast;
+    zl->_read_batch_f = _z_f_link_read_batch_udp_multicast;
+#else
+    zl->_write_batch_f = NULL;
+    zl->_read_batch_f = NULL;
+#endif
+    zl->_rx_socket_f = _z_f_link_rx_socket_udp_multicast;
 
     return ret;
 }
@@ -16,6 +16,7 @@
 #include <stddef.h>
 
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/protocol/keyexpr.h"
 
 void _z_sample_move(_z_sample_t *dst, _z_sample_t *src) {
     dst->keyexpr._id = src->keyexpr._id;          // FIXME: call the z_keyexpr_move
@@ -29,6 +30,19 @@ void _z_sample_move(_z_sample_t *dst, _z_sample_t *src) {
 
     dst->timestamp.time = src->timestamp.time;  // FIXME: call the z_timestamp_move
     dst->timestamp.id = src->timestamp.id;      // FIXME: call the z_timestamp_move
+
+    dst->_batch = src->_batch;
+    src->_batch = NULL;
+}
+
+void _z_sample_copy(_z_sample_t *dst, const _z_sample_t *src) {
+    _z_keyexpr_copy(&dst->keyexpr, &src->keyexpr);
+    _z_bytes_copy(&dst->payload, &src->payload);
+    dst->encoding.prefix = src->encoding.prefix;                  // FIXME: call the z_encoding_copy
+    _z_bytes_copy(&dst->encoding.suffix, &src->encoding.suffix);  // FIXME: call the z_encoding_copy
+    dst->timestamp = src->timestamp;
+    dst->kind = src->kind;
+    dst->_batch = NULL;  // The payload was copied, it no longer lies in the batch
 }
 
 void _z_sample_clear(_z_sample_t *sample) {
@@ -36,6 +50,7 @@ void _z_sample_clear(_z_sample_t *sample) {
     _z_bytes_clear(&sample->payload);
     _z_bytes_clear(&sample->encoding.suffix);  // FIXME: call the z_encoding_clear
     _z_timestamp_clear(&sample->timestamp);
+    sample->_batch = NULL;
 }
 
 void _z_sample_free(_z_sample_t **sample) {
@@ -22,10 +22,13 @@
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/net/logger.h"
 #include "zenoh-pico/net/memory.h"
+#include "zenoh-pico/protocol/codec/network.h"
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/protocol/definitions/declarations.h"
 #include "zenoh-pico/protocol/definitions/network.h"
+#include "zenoh-pico/protocol/iobuf.h"
 #include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/matching.h"
 #include "zenoh-pico/session/query.h"
 #include "zenoh-pico/session/queryable.h"
 #include "zenoh-pico/session/resource.h"
@@ -54,21 +57,19 @@ void _z_scout(const z_what_t what, const _z_id_t zid, const char *locator, const
 uint16_t _z_declare_resource(_z_session_t *zn, _z_keyexpr_t keyexpr) {
     uint16_t ret = Z_RESOURCE_ID_NONE;
 
-    if (zn->_tp._type ==
-        _Z_TRANSPORT_UNICAST_TYPE) {  // FIXME: remove when resource declaration is implemented for multicast transport
-        uint16_t id = _z_register_resource(zn, keyexpr, 0, _Z_KEYEXPR_MAPPING_LOCAL);
-        if (id != 0) {
-            // Build the declare message to send on the wire
-            _z_keyexpr_t alias = _z_keyexpr_alias(keyexpr);
-            _z_declaration_t declaration = _z_make_decl_keyexpr(id, &alias);
-            _z_network_message_t n_msg = _z_n_msg_make_declare(declaration);
-            if (_z_send_n_msg(zn, &n_msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) == _Z_RES_OK) {
-                ret = id;
-            } else {
-                _z_unregister_resource(zn, id, _Z_KEYEXPR_MAPPING_LOCAL);
-            }
-            _z_n_msg_clear(&n_msg);
+    // Multicast peers joining later learn the declaration as it is repeated along with the join messages
+    uint16_t id = _z_register_resource(zn, keyexpr, 0, _Z_KEYEXPR_MAPPING_LOCAL);
+    if (id != 0) {
+        // Build the declare message to send on the wire
+        _z_keyexpr_t alias = _z_keyexpr_alias(keyexpr);
+        _z_declaration_t declaration = _z_make_decl_keyexpr(id, &alias);
+        _z_network_message_t n_msg = _z_n_msg_make_declare(declaration);
+        if (_z_send_n_msg(zn, &n_msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) == _Z_RES_OK) {
+            ret = id;
+        } else {
+            _z_unregister_resource(zn, id, _Z_KEYEXPR_MAPPING_LOCAL);
         }
+        _z_n_msg_clear(&n_msg);
     }
 
     return ret;
@@ -97,39 +98,13 @@ int8_t _z_undeclare_resource(_z_session_t *zn, uint16_t rid) {
 }
 
 #if Z_FEATURE_PUBLICATION == 1
-/*------------------  Publisher Declaration ------------------*/
-_z_publisher_t *_z_declare_publisher(_z_session_t *zn, _z_keyexpr_t keyexpr, z_congestion_control_t congestion_control,
-                                     z_priority_t priority) {
-    _z_publisher_t *ret = (_z_publisher_t *)zp_malloc(sizeof(_z_publisher_t));
-    if (ret != NULL) {
-        ret->_zn = zn;
-        ret->_key = _z_keyexpr_duplicate(keyexpr);
-        ret->_id = _z_get_entity_id(zn);
-        ret->_congestion_control = congestion_control;
-        ret->_priority = priority;
-    }
-
-    return ret;
+static _z_encoding_t __z_write_default_encoding(void) {
+    return (_z_encoding_t){.prefix = Z_ENCODING_PREFIX_DEFAULT, .suffix = _z_bytes_empty()};
 }
 
-int8_t _z_undeclare_publisher(_z_publisher_t *pub) {
-    int8_t ret = _Z_RES_OK;
-
-    if (pub != NULL) {
-        // Build the declare message to send on the wire
-        _z_undeclare_resource(pub->_zn, pub->_key._id);
-    } else {
-        ret = _Z_ERR_ENTITY_UNKNOWN;
-    }
-
-    return ret;
-}
-
-/*------------------ Write ------------------*/
-int8_t _z_write(_z_session_t *zn, const _z_keyexpr_t keyexpr, const uint8_t *payload, const size_t len,
-                const _z_encoding_t encoding, const z_sample_kind_t kind, const z_congestion_control_t cong_ctrl,
-                z_priority_t priority) {
-    int8_t ret = _Z_RES_OK;
+static _z_network_message_t __z_write_n_msg(const _z_keyexpr_t keyexpr, const uint8_t *payload, const size_t len,
+                                            const _z_encoding_t encoding, const z_sample_kind_t kind,
+                                            const z_congestion_control_t cong_ctrl, z_priority_t priority) {
     _z_network_message_t msg;
     switch (kind) {
         case Z_SAMPLE_KIND_PUT:
@@ -165,16 +140,150 @@ int8_t _z_write(_z_session_t *zn, const _z_keyexpr_t keyexpr, const uint8_t *pay
             };
             break;
     }
+    return msg;
+}
+
+static _z_bytes_t __z_push_prefix_make(const _z_n_msg_push_t *push) {
+    _z_bytes_t ret = _z_bytes_empty();
+
+    // The header, key, extensions and body header only exceed this by the length of the key suffix
+    size_t capacity = (size_t)64 + ((push->_key._suffix != NULL) ? strlen(push->_key._suffix) : (size_t)0);
+    _z_wbuf_t wbf = _z_wbuf_make(capacity, false);
+    if (_z_push_prefix_encode(&wbf, push) == _Z_RES_OK) {
+        ret = _z_bytes_make(_z_wbuf_len(&wbf));
+        if (ret.start != NULL) {
+            _z_iosli_t *ios = _z_wbuf_get_iosli(&wbf, 0);
+            (void)memcpy((uint8_t *)ret.start, ios->_buf, ret.len);
+        }
+    }
+    _z_wbuf_clear(&wbf);
+
+    return ret;
+}
+
+/*------------------  Publisher Declaration ------------------*/
+_z_publisher_t *_z_declare_publisher(_z_session_t *zn, _z_keyexpr_t keyexpr, z_congestion_control_t congestion_control,
+                                     z_priority_t priority) {
+    _z_publisher_t *ret = (_z_publisher_t *)zp_malloc(sizeof(_z_publisher_t));
+    if (ret != NULL) {
+        ret->_zn = zn;
+        ret->_key = _z_keyexpr_duplicate(keyexpr);
+        ret->_id = _z_get_entity_id(zn);
+        ret->_congestion_control = congestion_control;
+        ret->_priority = priority;
+#if Z_FEATURE_MATCHING == 1
+        ret->_matching_gen = 0;  // Never a session generation, the status is computed on the first write
+        ret->_matching = true;
+#endif
+        // A failure only leaves the prefix empty, the puts are then fully encoded
+        _z_network_message_t msg = __z_write_n_msg(ret->_key, NULL, 0, __z_write_default_encoding(), Z_SAMPLE_KIND_PUT,
+                                                   congestion_control, priority);
+        ret->_prefix = __z_push_prefix_make(&msg._body._push);
+    }
+
+    return ret;
+}
+
+int8_t _z_undeclare_publisher(_z_publisher_t *pub) {
+    int8_t ret = _Z_RES_OK;
+
+    if (pub != NULL) {
+        // Build the declare message to send on the wire
+        _z_undeclare_resource(pub->_zn, pub->_key._id);
+    } else {
+        ret = _Z_ERR_ENTITY_UNKNOWN;
+    }
+
+    return ret;
+}
+
+/*------------------ Write ------------------*/
+int8_t _z_write(_z_session_t *zn, const _z_keyexpr_t keyexpr, const uint8_t *payload, const size_t len,
+                const _z_encoding_t encoding, const z_sample_kind_t kind, const z_congestion_control_t cong_ctrl,
+                z_priority_t priority) {
+    int8_t ret = _Z_RES_OK;
+    _z_keyexpr_t key = _z_get_wire_key_from_key(zn, &keyexpr);
+    _z_network_message_t msg = __z_write_n_msg(key, payload, len, encoding, kind, cong_ctrl, priority);
 
     if (_z_send_n_msg(zn, &msg, Z_RELIABILITY_RELIABLE, cong_ctrl) != _Z_RES_OK) {
         ret = _Z_ERR_TRANSPORT_TX_FAILED;
     }
 
     // Freeing z_msg is unnecessary, as all of its components are aliased
+    _z_keyexpr_clear(&key);
+
+    return ret;
+}
+
+int8_t _z_publisher_write(const _z_publisher_t *pub, const uint8_t *payload, const size_t len,
+                          const _z_encoding_t encoding) {
+    int8_t ret = _Z_RES_OK;
+    _z_keyexpr_t key = _z_get_wire_key_from_key(pub->_zn, &pub->_key);
+    _z_network_message_t msg =
+        __z_write_n_msg(key, payload, len, encoding, Z_SAMPLE_KIND_PUT, pub->_congestion_control, pub->_priority);
+    // The prefix holds the default encoding and the declared key, any other one is encoded with the message
+    if ((encoding.prefix == Z_ENCODING_PREFIX_DEFAULT) && (_z_bytes_is_empty(&encoding.suffix) == true) &&
+        (key._suffix == pub->_key._suffix)) {
+        msg._body._push._prefix = _z_bytes_wrap(pub->_prefix.start, pub->_prefix.len);
+    }
+
+    if (_z_send_n_msg(pub->_zn, &msg, Z_RELIABILITY_RELIABLE, pub->_congestion_control) != _Z_RES_OK) {
+        ret = _Z_ERR_TRANSPORT_TX_FAILED;
+    }
+    _z_keyexpr_clear(&key);
+
+    return ret;
+}
+
+#if Z_FEATURE_MATCHING == 1
+/*------------------ Matching Listener Declaration ------------------*/
+_z_matching_listener_t *_z_declare_matching_listener(_z_publisher_t *pub, _z_matching_status_handler_t callback,
+                                                     _z_drop_handler_t dropper, void *arg) {
+    _z_matching_t m;
+    m._id = _z_get_entity_id(pub->_zn);
+    m._key = _z_get_expanded_key_from_key(pub->_zn, &pub->_key);
+    m._callback = callback;
+    m._dropper = dropper;
+    m._arg = arg;
+    m._matching = false;
+
+    _z_matching_listener_t *ret = (_z_matching_listener_t *)zp_malloc(sizeof(_z_matching_listener_t));
+    if (ret != NULL) {
+        ret->_zn = pub->_zn;
+        ret->_entity_id = (uint32_t)m._id;
+
+        // This a pointer to the entry stored at session-level, do not drop it by the end of this function
+        _z_matching_sptr_t *sp_m = _z_register_matching(pub->_zn, &m);
+        if (sp_m == NULL) {
+            _z_matching_clear(&m);
+            _z_matching_listener_free(&ret);
+        }
+    } else {
+        _z_matching_clear(&m);
+    }
+
+    return ret;
+}
+
+int8_t _z_undeclare_matching_listener(_z_matching_listener_t *listener) {
+    int8_t ret = _Z_RES_OK;
+
+    if (listener != NULL) {
+        _z_matching_sptr_t *m = _z_get_matching_by_id(listener->_zn, listener->_entity_id);
+        if (m != NULL) {
+            // Matching listeners are local only, nothing is sent on the wire
+            _z_unregister_matching(listener->_zn, m);
+        } else {
+            ret = _Z_ERR_ENTITY_UNKNOWN;
+        }
+    } else {
+        ret = _Z_ERR_ENTITY_UNKNOWN;
+    }
 
     return ret;
 }
 #endif
+#endif
 
 #if Z_FEATURE_SUBSCRIPTION == 1
 /*------------------ Subscriber Declaration ------------------*/
@@ -349,7 +458,7 @@ int8_t _z_send_reply(const z_query_t *query, _z_keyexpr_t keyexpr, const _z_valu
     if (ret == _Z_RES_OK) {
         // Build the reply context decorator. This is NOT the final reply.
         _z_id_t zid = ((_z_session_t *)query->_zn)->_local_zid;
-        _z_keyexpr_t ke = _z_keyexpr_alias(keyexpr);
+        _z_keyexpr_t ke = _z_get_wire_key_from_key(query->_zn, &keyexpr);
         _z_zenoh_message_t z_msg = {
             ._tag = _Z_N_RESPONSE,
             ._body._response =
@@ -367,11 +476,13 @@ int8_t _z_send_reply(const z_query_t *query, _z_keyexpr_t keyexpr, const _z_valu
                 },
         };
 
-        if (_z_send_n_msg(query->_zn, &z_msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) != _Z_RES_OK) {
+        if (_z_send_n_msg_to(query->_zn, query->_mapping, &z_msg, Z_RELIABILITY_RELIABLE,
+                             Z_CONGESTION_CONTROL_BLOCK) != _Z_RES_OK) {
             ret = _Z_ERR_TRANSPORT_TX_FAILED;
         }
 
-        // Freeing z_msg is unnecessary, as all of its components are aliased
+        // Freeing z_msg is unnecessary, as all of its components but the key are aliased
+        _z_keyexpr_clear(&ke);
     }
 
     return ret;
@@ -381,8 +492,8 @@ int8_t _z_send_reply(const z_query_t *query, _z_keyexpr_t keyexpr, const _z_valu
 #if Z_FEATURE_QUERY == 1
 /*------------------ Query ------------------*/
 int8_t _z_query(_z_session_t *zn, _z_keyexpr_t keyexpr, const char *parameters, const z_query_target_t target,
-                const z_consolidation_mode_t consolidation, _z_value_t value, _z_reply_handler_t callback,
-                void *arg_call, _z_drop_handler_t dropper, void *arg_drop) {
+                const z_consolidation_mode_t consolidation, _z_value_t value, uint32_t timeout_ms,
+                _z_reply_handler_t callback, void *arg_call, _z_drop_handler_t dropper, void *arg_drop) {
     int8_t ret = _Z_RES_OK;
 
     // Create the pending query object
@@ -400,17 +511,20 @@ int8_t _z_query(_z_session_t *zn, _z_keyexpr_t keyexpr, const char *parameters,
         pq->_call_arg = arg_call;
         pq->_drop_arg = arg_drop;
 
-        ret = _z_register_pending_query(zn, pq);  // Add the pending query to the current session
+        ret = _z_register_pending_query(zn, pq, timeout_ms);  // Add the pending query to the current session
         if (ret == _Z_RES_OK) {
             _z_bytes_t params = _z_bytes_wrap((uint8_t *)pq->_parameters, strlen(pq->_parameters));
-            _z_zenoh_message_t z_msg = _z_msg_make_query(&keyexpr, &params, pq->_id, pq->_consolidation, &value);
+            _z_keyexpr_t key = _z_get_wire_key_from_key(zn, &keyexpr);
+            _z_zenoh_message_t z_msg = _z_msg_make_query(&key, &params, pq->_id, pq->_consolidation, &value);
 
             if (_z_send_n_msg(zn, &z_msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) != _Z_RES_OK) {
                 _z_unregister_pending_query(zn, pq);
                 ret = _Z_ERR_TRANSPORT_TX_FAILED;
             }
+            _z_keyexpr_clear(&z_msg._body._request._key);  // The message took the key
         } else {
             _z_pending_query_clear(pq);
+            zp_free(pq);
         }
     }
 
@@ -17,7 +17,10 @@
 #include <stddef.h>
 
 #if Z_FEATURE_PUBLICATION == 1
-void _z_publisher_clear(_z_publisher_t *pub) { _z_keyexpr_clear(&pub->_key); }
+void _z_publisher_clear(_z_publisher_t *pub) {
+    _z_keyexpr_clear(&pub->_key);
+    _z_bytes_clear(&pub->_prefix);
+}
 
 void _z_publisher_free(_z_publisher_t **pub) {
     _z_publisher_t *ptr = *pub;
@@ -30,3 +33,21 @@ void _z_publisher_free(_z_publisher_t **pub) {
     }
 }
 #endif
+
+#if Z_FEATURE_MATCHING == 1
+void _z_matching_listener_clear(_z_matching_listener_t *listener) {
+    // Nothing to clear
+    (void)(listener);
+}
+
+void _z_matching_listener_free(_z_matching_listener_t **listener) {
+    _z_matching_listener_t *ptr = *listener;
+
+    if (ptr != NULL) {
+        _z_matching_listener_clear(ptr);
+
+        zp_free(ptr);
+        *listener = NULL;
+    }
+}
+#endif
@@ -0,0 +1,424 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/net/reactor.h"
+
+#include <stddef.h>
+#include <string.h>
+
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/common/lease.h"
+#include "zenoh-pico/transport/common/read.h"
+#include "zenoh-pico/utils/logging.h"
+#include "zenoh-pico/utils/result.h"
+
+#if Z_FEATURE_REACTOR == 1
+
+static inline void __z_reactor_lock(_z_reactor_t *r) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&r->_mutex);
+#else
+    _ZP_UNUSED(r);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+static inline void __z_reactor_unlock(_z_reactor_t *r) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&r->_mutex);
+#else
+    _ZP_UNUSED(r);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+static inline void __z_reactor_signal(_z_reactor_t *r) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_condvar_signal(&r->_cv);
+#else
+    _ZP_UNUSED(r);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+static void __z_reactor_free_graveyard(_z_reactor_t *r) {
+    while (r->_graveyard != NULL) {
+        _z_reactor_entry_t *entry = r->_graveyard;
+        r->_graveyard = entry->_next;
+        zp_free(entry);
+    }
+}
+
+/*------------------ Timers ------------------*/
+static inline _Bool __z_deadline_before(unsigned long a, unsigned long b) {
+    return (long)(a - b) < 0;  // Robust to the wrap-around of the clock
+}
+
+static void __z_reactor_timers_set(_z_reactor_t *r, size_t i, _z_reactor_entry_t *entry) {
+    r->_timers[i] = entry;
+    entry->_timer_idx = i;
+}
+
+static void __z_reactor_timers_sift_up(_z_reactor_t *r, size_t i) {
+    _z_reactor_entry_t *entry = r->_timers[i];
+    while (i > (size_t)0) {
+        size_t parent = (i - (size_t)1) / (size_t)2;
+        if (__z_deadline_before(entry->_deadline, r->_timers[parent]->_deadline) == false) {
+            break;
+        }
+        __z_reactor_timers_set(r, i, r->_timers[parent]);
+        i = parent;
+    }
+    __z_reactor_timers_set(r, i, entry);
+}
+
+static void __z_reactor_timers_sift_down(_z_reactor_t *r, size_t i) {
+    _z_reactor_entry_t *entry = r->_timers[i];
+    while (true) {
+        size_t child = (i * (size_t)2) + (size_t)1;
+        if (child >= r->_timers_len) {
+            break;
+        }
+        if (((child + (size_t)1) < r->_timers_len) &&
+            (__z_deadline_before(r->_timers[child + (size_t)1]->_deadline, r->_timers[child]->_deadline) == true)) {
+            child = child + (size_t)1;
+        }
+        if (__z_deadline_before(r->_timers[child]->_deadline, entry->_deadline) == false) {
+            break;
+        }
+        __z_reactor_timers_set(r, i, r->_timers[child]);
+        i = child;
+    }
+    __z_reactor_timers_set(r, i, entry);
+}
+
+// The heap never holds more entries than the reactor, so it never grows here
+static void __z_reactor_timers_push(_z_reactor_t *r, _z_reactor_entry_t *entry) {
+    __z_reactor_timers_set(r, r->_timers_len, entry);
+    r->_timers_len = r->_timers_len + (size_t)1;
+    __z_reactor_timers_sift_up(r, entry->_timer_idx);
+}
+
+static void __z_reactor_timers_remove(_z_reactor_t *r, _z_reactor_entry_t *entry) {
+    size_t i = entry->_timer_idx;
+    if (i == _Z_REACTOR_NO_TIMER) {
+        return;
+    }
+    entry->_timer_idx = _Z_REACTOR_NO_TIMER;
+
+    // Move the last entry in the hole and restore the heap property
+    r->_timers_len = r->_timers_len - (size_t)1;
+    if (i < r->_timers_len) {
+        __z_reactor_timers_set(r, i, r->_timers[r->_timers_len]);
+        __z_reactor_timers_sift_up(r, i);
+        __z_reactor_timers_sift_down(r, r->_timers[i]->_timer_idx);
+    }
+}
+
+/*------------------ Reactor ------------------*/
+int8_t _z_reactor_init(_z_reactor_t *r) {
+    (void)memset(r, 0, sizeof(_z_reactor_t));
+    r->_epoch = zp_clock_now();
+
+    int8_t ret = _z_poll_init(&r->_poll);
+#if Z_FEATURE_MULTI_THREAD == 1
+    if (ret == _Z_RES_OK) {
+        ret = zp_mutex_init(&r->_mutex);
+        if (ret == _Z_RES_OK) {
+            ret = zp_condvar_init(&r->_cv);
+            if (ret != _Z_RES_OK) {
+                zp_mutex_free(&r->_mutex);
+            }
+        }
+        if (ret != _Z_RES_OK) {
+            _z_poll_clear(&r->_poll);
+        }
+    }
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    return ret;
+}
+
+void _z_reactor_clear(_z_reactor_t *r) {
+    for (size_t i = 0; i < r->_len; i++) {
+        zp_free(r->_entries[i]);
+    }
+    __z_reactor_free_graveyard(r);
+    zp_free(r->_entries);
+    zp_free(r->_timers);
+    r->_entries = NULL;
+    r->_timers = NULL;
+    r->_len = 0;
+    r->_timers_len = 0;
+    r->_capacity = 0;
+    _z_poll_clear(&r->_poll);
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_condvar_free(&r->_cv);
+    zp_mutex_free(&r->_mutex);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+static int8_t __z_reactor_grow(_z_reactor_t *r) {
+    int8_t ret = _Z_RES_OK;
+    size_t capacity = (r->_capacity == (size_t)0) ? (size_t)_Z_REACTOR_DEFAULT_CAPACITY : r->_capacity * (size_t)2;
+    _z_reactor_entry_t **entries = (_z_reactor_entry_t **)zp_malloc(capacity * sizeof(_z_reactor_entry_t *));
+    _z_reactor_entry_t **timers = (_z_reactor_entry_t **)zp_malloc(capacity * sizeof(_z_reactor_entry_t *));
+    if ((entries != NULL) && (timers != NULL)) {
+        if (r->_len > (size_t)0) {
+            (void)memcpy(entries, r->_entries, r->_len * sizeof(_z_reactor_entry_t *));
+        }
+        if (r->_timers_len > (size_t)0) {
+            (void)memcpy(timers, r->_timers, r->_timers_len * sizeof(_z_reactor_entry_t *));
+        }
+        zp_free(r->_entries);
+        zp_free(r->_timers);
+        r->_entries = entries;
+        r->_timers = timers;
+        r->_capacity = capacity;
+    } else {
+        zp_free(entries);
+        zp_free(timers);
+        ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    return ret;
+}
+
+static size_t __z_reactor_find(const _z_reactor_t *r, const _z_session_t *zn) {
+    size_t ret = SIZE_MAX;
+    for (size_t i = 0; i < r->_len; i++) {
+        if (r->_entries[i]->_session == zn) {
+            ret = i;
+            break;
+        }
+    }
+    return ret;
+}
+
+int8_t _z_reactor_add(_z_reactor_t *r, _z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+
+    // Only the links exposing their socket can be waited for with the other ones
+    size_t len = _z_session_transports_len(zn);
+    for (size_t i = 0; (i < len) && (ret == _Z_RES_OK); i++) {
+        const _z_link_t *link = _z_transport_link(_z_session_transport(zn, i));
+        if ((link == NULL) || (link->_rx_socket_f == NULL)) {
+            ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+        }
+    }
+
+    // One entry per transport of the session
+    _z_reactor_entry_t *entries[Z_TRANSPORTS_MAX];
+    size_t n = 0;
+    while ((ret == _Z_RES_OK) && (n < len)) {
+        _z_reactor_entry_t *entry = (_z_reactor_entry_t *)zp_malloc(sizeof(_z_reactor_entry_t));
+        if (entry != NULL) {
+            (void)memset(entry, 0, sizeof(_z_reactor_entry_t));
+            entry->_session = zn;
+            entry->_tp = _z_session_transport(zn, n);
+            const _z_link_t *link = _z_transport_link(entry->_tp);
+            entry->_socket = link->_rx_socket_f(link);
+            entry->_timer_idx = _Z_REACTOR_NO_TIMER;
+            entries[n] = entry;
+            n = n + (size_t)1;
+        } else {
+            ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+        }
+    }
+
+    if (ret == _Z_RES_OK) {
+        __z_reactor_lock(r);
+        if (__z_reactor_find(r, zn) != SIZE_MAX) {
+            ret = _Z_ERR_GENERIC;
+        }
+        size_t added = 0;
+        while ((ret == _Z_RES_OK) && (added < n)) {
+            if (r->_len == r->_capacity) {
+                ret = __z_reactor_grow(r);
+            }
+            if (ret == _Z_RES_OK) {
+                ret = _z_poll_add(&r->_poll, entries[added]->_socket, entries[added]);
+            }
+            if (ret == _Z_RES_OK) {
+                r->_entries[r->_len] = entries[added];
+                r->_len = r->_len + (size_t)1;
+                added = added + (size_t)1;
+            }
+        }
+        if (ret == _Z_RES_OK) {
+            // The first lease steps are due immediately, they set the following deadlines
+            for (size_t i = 0; i < n; i++) {
+                _z_lease_start(entries[i]->_tp);
+                entries[i]->_deadline = zp_clock_elapsed_ms(&r->_epoch);
+                __z_reactor_timers_push(r, entries[i]);
+            }
+        } else {
+            // The entries added so far are the last ones
+            for (size_t i = 0; i < added; i++) {
+                (void)_z_poll_remove(&r->_poll, entries[i]->_socket);
+            }
+            r->_len = r->_len - added;
+        }
+        __z_reactor_unlock(r);
+    }
+
+    if (ret != _Z_RES_OK) {
+        for (size_t i = 0; i < n; i++) {
+            zp_free(entries[i]);
+        }
+    }
+
+    return ret;
+}
+
+// Removes the i-th entry, the lock is held
+static void __z_reactor_remove_entry(_z_reactor_t *r, size_t i) {
+    _z_reactor_entry_t *entry = r->_entries[i];
+    entry->_removed = true;
+    if (entry->_expired == false) {
+        (void)_z_poll_remove(&r->_poll, entry->_socket);
+    }
+    __z_reactor_timers_remove(r, entry);
+    r->_len = r->_len - (size_t)1;
+    r->_entries[i] = r->_entries[r->_len];
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    // The session must not be used by the reactor anymore once it returns
+    while (entry->_busy > (size_t)0) {
+        zp_condvar_wait(&r->_cv, &r->_mutex);
+    }
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    // A running thread may still hold an event of the entry, it is freed once they all returned
+    if (r->_running > (size_t)0) {
+        entry->_next = r->_graveyard;
+        r->_graveyard = entry;
+    } else {
+        zp_free(entry);
+    }
+}
+
+int8_t _z_reactor_remove(_z_reactor_t *r, _z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+
+    __z_reactor_lock(r);
+    size_t i = __z_reactor_find(r, zn);
+    if (i == SIZE_MAX) {
+        ret = _Z_ERR_GENERIC;
+    }
+    // One entry per transport of the session
+    while (i != SIZE_MAX) {
+        __z_reactor_remove_entry(r, i);
+        i = __z_reactor_find(r, zn);
+    }
+    __z_reactor_unlock(r);
+
+    return ret;
+}
+
+static void __z_reactor_read(_z_reactor_t *r, const _z_sys_net_poll_event_t *event) {
+    _z_reactor_entry_t *entry = (_z_reactor_entry_t *)event->arg;
+
+    __z_reactor_lock(r);
+    _Bool active = (entry->_removed == false) && (entry->_expired == false);
+    if (active == true) {
+        entry->_busy = entry->_busy + (size_t)1;
+    }
+    __z_reactor_unlock(r);
+
+    if (active == true) {
+        // The socket is only reported again once re-armed, so decode all the batches it brought
+        int8_t ret = _z_read(entry->_tp);
+        while ((ret == _Z_RES_OK) && (_z_read_pending(entry->_tp) == true)) {
+            ret = _z_read(entry->_tp);
+        }
+
+        __z_reactor_lock(r);
+        entry->_busy = entry->_busy - (size_t)1;
+        if ((entry->_removed == false) && (entry->_expired == false)) {
+            if (event->hangup == false) {
+                (void)_z_poll_rearm(&r->_poll, entry->_socket, entry);
+            } else {
+                // Nothing more will be read, the lease of the session expires
+                _Z_INFO("Reactor stops reading from a transport whose link hung up");
+            }
+        }
+        __z_reactor_signal(r);
+        __z_reactor_unlock(r);
+    }
+}
+
+static void __z_reactor_step(_z_reactor_t *r) {
+    __z_reactor_lock(r);
+    unsigned long now = zp_clock_elapsed_ms(&r->_epoch);
+    while ((r->_timers_len > (size_t)0) && (__z_deadline_before(now, r->_timers[0]->_deadline) == false)) {
+        _z_reactor_entry_t *entry = r->_timers[0];
+        __z_reactor_timers_remove(r, entry);
+        entry->_busy = entry->_busy + (size_t)1;
+        __z_reactor_unlock(r);
+
+        _z_zint_t interval = 0;
+        int8_t ret = _z_lease_step(entry->_tp, &interval);
+
+        __z_reactor_lock(r);
+        entry->_busy = entry->_busy - (size_t)1;
+        if (entry->_removed == false) {
+            if (ret != _Z_RES_OK) {
+                _Z_INFO("Reactor stops driving a transport whose lease expired");
+                entry->_expired = true;
+                (void)_z_poll_remove(&r->_poll, entry->_socket);
+            } else {
+                // At least a millisecond later, so that a session is not stepped twice by the same run
+                if (interval == (_z_zint_t)0) {
+                    interval = 1;
+                }
+                entry->_deadline = zp_clock_elapsed_ms(&r->_epoch) + (unsigned long)interval;
+                __z_reactor_timers_push(r, entry);
+            }
+        }
+        __z_reactor_signal(r);
+    }
+    __z_reactor_unlock(r);
+}
+
+int8_t _z_reactor_run(_z_reactor_t *r, uint32_t timeout) {
+    _z_sys_net_poll_event_t events[Z_REACTOR_EVENTS];
+
+    // Wait no longer than the next lease step
+    __z_reactor_lock(r);
+    r->_running = r->_running + (size_t)1;
+    uint32_t wait = timeout;
+    if (r->_timers_len > (size_t)0) {
+        unsigned long now = zp_clock_elapsed_ms(&r->_epoch);
+        unsigned long deadline = r->_timers[0]->_deadline;
+        if (__z_deadline_before(now, deadline) == false) {
+            wait = 0;
+        } else if ((deadline - now) < (unsigned long)wait) {
+            wait = (uint32_t)(deadline - now);
+        }
+    }
+    __z_reactor_unlock(r);
+
+    size_t n = _z_poll_wait(&r->_poll, events, Z_REACTOR_EVENTS, wait);
+    for (size_t i = 0; i < n; i++) {
+        __z_reactor_read(r, &events[i]);
+    }
+    __z_reactor_step(r);
+
+    __z_reactor_lock(r);
+    r->_running = r->_running - (size_t)1;
+    if (r->_running == (size_t)0) {
+        __z_reactor_free_graveyard(r);
+    }
+    __z_reactor_unlock(r);
+
+    return _Z_RES_OK;
+}
+
+#endif  // Z_FEATURE_REACTOR == 1
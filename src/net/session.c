@@ -23,17 +23,21 @@
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/net/memory.h"
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/session/query.h"
 #include "zenoh-pico/session/utils.h"
 #include "zenoh-pico/transport/common/lease.h"
 #include "zenoh-pico/transport/common/read.h"
+#include "zenoh-pico/transport/common/tx.h"
 #include "zenoh-pico/transport/multicast.h"
 #include "zenoh-pico/transport/multicast/lease.h"
 #include "zenoh-pico/transport/multicast/read.h"
+#include "zenoh-pico/transport/multicast/tx.h"
 #include "zenoh-pico/transport/raweth/read.h"
 #include "zenoh-pico/transport/transport.h"
 #include "zenoh-pico/transport/unicast.h"
 #include "zenoh-pico/transport/unicast/lease.h"
 #include "zenoh-pico/transport/unicast/read.h"
+#include "zenoh-pico/transport/unicast/tx.h"
 #include "zenoh-pico/utils/logging.h"
 #include "zenoh-pico/utils/uuid.h"
 
@@ -55,6 +59,46 @@ int8_t __z_open_inner(_z_session_t *zn, char *locator, z_whatami_t mode) {
     return ret;
 }
 
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+// Splits the configured locators, the empty ones are skipped
+static _z_str_array_t __z_split_locators(const char *str) {
+    size_t len = 1;
+    for (const char *p = strchr(str, Z_CONFIG_LOCATORS_SEPARATOR); p != NULL;
+         p = strchr(p + 1, Z_CONFIG_LOCATORS_SEPARATOR)) {
+        len = len + (size_t)1;
+    }
+
+    _z_str_array_t locators = _z_str_array_empty();
+    _z_str_array_init(&locators, len);
+    size_t n = 0;
+    const char *start = str;
+    for (size_t i = 0; (i < locators.len) && (start != NULL); i++) {
+        const char *end = strchr(start, Z_CONFIG_LOCATORS_SEPARATOR);
+        size_t size = (end != NULL) ? (size_t)(end - start) : strlen(start);
+        if (size > (size_t)0) {
+            char *locator = (char *)zp_malloc(size + (size_t)1);
+            if (locator != NULL) {
+                _z_str_n_copy(locator, start, size + (size_t)1);
+                locators.val[n] = locator;
+                n = n + (size_t)1;
+            }
+        }
+        start = (end != NULL) ? (end + 1) : NULL;
+    }
+    locators.len = n;
+    return locators;
+}
+
+// Opens the other transports of the session on the next locators, the session stays open without them
+static void __z_open_others(_z_session_t *zn, const _z_str_array_t *locators, size_t first, z_whatami_t mode) {
+    for (size_t i = first; i < locators->len; i++) {
+        if (_z_session_open_transport(zn, locators->val[i], mode) != _Z_RES_OK) {
+            _Z_INFO("Unable to open a transport on %s", locators->val[i]);
+        }
+    }
+}
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+
 int8_t _z_open(_z_session_t *zn, _z_config_t *config) {
     int8_t ret = _Z_RES_OK;
 
@@ -66,6 +110,9 @@ int8_t _z_open(_z_session_t *zn, _z_config_t *config) {
 
     if (config != NULL) {
         _z_str_array_t locators = _z_str_array_empty();
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+        _Bool is_scouted = false;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
         char *connect = _z_config_get(config, Z_CONFIG_CONNECT_KEY);
         char *listen = _z_config_get(config, Z_CONFIG_LISTEN_KEY);
         if (connect == NULL && listen == NULL) {  // Scout if peer is not configured
@@ -89,6 +136,9 @@ int8_t _z_open(_z_session_t *zn, _z_config_t *config) {
 
             // Scout and return upon the first result
             _z_hello_list_t *hellos = _z_scout_inner(what, zid, mcast_locator, timeout, true);
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+            is_scouted = true;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
             if (hellos != NULL) {
                 _z_hello_t *hello = _z_hello_list_head(hellos);
                 _z_str_array_copy(&locators, &hello->locators);
@@ -104,8 +154,12 @@ int8_t _z_open(_z_session_t *zn, _z_config_t *config) {
                     return _Z_ERR_GENERIC;
                 }
             }
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+            locators = __z_split_locators(_z_config_get(config, key));
+#else
             locators = _z_str_array_make(1);
             locators.val[0] = _z_str_clone(_z_config_get(config, key));
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
         }
 
         ret = _Z_ERR_SCOUT_NO_RESULTS;
@@ -132,6 +186,12 @@ int8_t _z_open(_z_session_t *zn, _z_config_t *config) {
             if (ret == _Z_RES_OK) {
                 ret = __z_open_inner(zn, locator, mode);
                 if (ret == _Z_RES_OK) {
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+                    // The scouted locators are alternatives to reach the same node, the configured ones are not
+                    if (is_scouted == false) {
+                        __z_open_others(zn, &locators, i + (size_t)1, mode);
+                    }
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
                     break;
                 }
             } else {
@@ -156,30 +216,84 @@ _z_config_t *_z_info(const _z_session_t *zn) {
         _z_bytes_t local_zid = _z_bytes_wrap(zn->_local_zid.id, _z_id_len(zn->_local_zid));
         _zp_config_insert(ps, Z_INFO_PID_KEY, _z_string_from_bytes(&local_zid));
 
-        switch (zn->_tp._type) {
-            case _Z_TRANSPORT_UNICAST_TYPE:
-                _zp_unicast_info_session(&zn->_tp, ps);
-                break;
-            case _Z_TRANSPORT_MULTICAST_TYPE:
-            case _Z_TRANSPORT_RAWETH_TYPE:
-                _zp_multicast_info_session(&zn->_tp, ps);
-                break;
-            default:
-                break;
+        for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+            const _z_transport_t *zt = _z_session_transport((_z_session_t *)zn, i);
+            switch (zt->_type) {
+                case _Z_TRANSPORT_UNICAST_TYPE:
+                    _zp_unicast_info_session(zt, ps);
+                    break;
+                case _Z_TRANSPORT_MULTICAST_TYPE:
+                case _Z_TRANSPORT_RAWETH_TYPE:
+                    _zp_multicast_info_session(zt, ps);
+                    break;
+                default:
+                    break;
+            }
         }
     }
 
     return ps;
 }
 
-int8_t _zp_read(_z_session_t *zn) { return _z_read(&zn->_tp); }
+int8_t _zp_read(_z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        _z_transport_t *zt = _z_session_transport(zn, i);
+        if (_z_transport_is_up(zt) == true) {
+            int8_t res = _z_read(zt);
+            if (ret == _Z_RES_OK) {
+                ret = res;
+            }
+        }
+    }
+#if Z_FEATURE_QUERY == 1
+    // Without a lease task the pending queries are expired on each read
+    _z_process_query_timeouts(zn);
+#endif  // Z_FEATURE_QUERY == 1
+    return ret;
+}
 
-int8_t _zp_send_keep_alive(_z_session_t *zn) { return _z_send_keep_alive(&zn->_tp); }
+int8_t _zp_send_keep_alive(_z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        _z_transport_t *zt = _z_session_transport(zn, i);
+        if (_z_transport_is_up(zt) == true) {
+            int8_t res = _z_send_keep_alive(zt);
+            if (ret == _Z_RES_OK) {
+                ret = res;
+            }
+        }
+    }
+    return ret;
+}
 
-int8_t _zp_send_join(_z_session_t *zn) { return _z_send_join(&zn->_tp); }
+int8_t _zp_flush(_z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        _z_transport_t *zt = _z_session_transport(zn, i);
+        if (_z_transport_is_up(zt) == true) {
+            int8_t res = _z_flush(zt);
+            if (ret == _Z_RES_OK) {
+                ret = res;
+            }
+        }
+    }
+    return ret;
+}
+
+int8_t _zp_send_join(_z_session_t *zn) {
+    // Joins only apply to the multicast transports, there is at most one
+    _z_transport_t *zt = &zn->_tp;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        if (_z_session_transport(zn, i)->_type != _Z_TRANSPORT_UNICAST_TYPE) {
+            zt = _z_session_transport(zn, i);
+        }
+    }
+    return _z_send_join(zt);
+}
 
 #if Z_FEATURE_MULTI_THREAD == 1
-int8_t _zp_start_read_task(_z_session_t *zn, zp_task_attr_t *attr) {
+static int8_t __zp_start_read_task(_z_transport_t *zt, zp_task_attr_t *attr) {
     int8_t ret = _Z_RES_OK;
     // Allocate task
     zp_task_t *task = (zp_task_t *)zp_malloc(sizeof(zp_task_t));
@@ -187,15 +301,15 @@ int8_t _zp_start_read_task(_z_session_t *zn, zp_task_attr_t *attr) {
         ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
     }
     // Call transport function
-    switch (zn->_tp._type) {
+    switch (zt->_type) {
         case _Z_TRANSPORT_UNICAST_TYPE:
-            ret = _zp_unicast_start_read_task(&zn->_tp, attr, task);
+            ret = _zp_unicast_start_read_task(zt, attr, task);
             break;
         case _Z_TRANSPORT_MULTICAST_TYPE:
-            ret = _zp_multicast_start_read_task(&zn->_tp, attr, task);
+            ret = _zp_multicast_start_read_task(zt, attr, task);
             break;
         case _Z_TRANSPORT_RAWETH_TYPE:
-            ret = _zp_raweth_start_read_task(&zn->_tp, attr, task);
+            ret = _zp_raweth_start_read_task(zt, attr, task);
             break;
         default:
             ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
@@ -208,7 +322,7 @@ int8_t _zp_start_read_task(_z_session_t *zn, zp_task_attr_t *attr) {
     return ret;
 }
 
-int8_t _zp_start_lease_task(_z_session_t *zn, zp_task_attr_t *attr) {
+static int8_t __zp_start_lease_task(_z_transport_t *zt, zp_task_attr_t *attr) {
     int8_t ret = _Z_RES_OK;
     // Allocate task
     zp_task_t *task = (zp_task_t *)zp_malloc(sizeof(zp_task_t));
@@ -216,15 +330,15 @@ int8_t _zp_start_lease_task(_z_session_t *zn, zp_task_attr_t *attr) {
         ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
     }
     // Call transport function
-    switch (zn->_tp._type) {
+    switch (zt->_type) {
         case _Z_TRANSPORT_UNICAST_TYPE:
-            ret = _zp_unicast_start_lease_task(&zn->_tp, attr, task);
+            ret = _zp_unicast_start_lease_task(zt, attr, task);
             break;
         case _Z_TRANSPORT_MULTICAST_TYPE:
-            ret = _zp_multicast_start_lease_task(&zn->_tp._transport._multicast, attr, task);
+            ret = _zp_multicast_start_lease_task(&zt->_transport._multicast, attr, task);
             break;
         case _Z_TRANSPORT_RAWETH_TYPE:
-            ret = _zp_multicast_start_lease_task(&zn->_tp._transport._raweth, attr, task);
+            ret = _zp_multicast_start_lease_task(&zt->_transport._raweth, attr, task);
             break;
         default:
             ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
@@ -237,18 +351,18 @@ int8_t _zp_start_lease_task(_z_session_t *zn, zp_task_attr_t *attr) {
     return ret;
 }
 
-int8_t _zp_stop_read_task(_z_session_t *zn) {
+static int8_t __zp_stop_read_task(_z_transport_t *zt) {
     int8_t ret = _Z_RES_OK;
     // Call transport function
-    switch (zn->_tp._type) {
+    switch (zt->_type) {
         case _Z_TRANSPORT_UNICAST_TYPE:
-            ret = _zp_unicast_stop_read_task(&zn->_tp);
+            ret = _zp_unicast_stop_read_task(zt);
             break;
         case _Z_TRANSPORT_MULTICAST_TYPE:
-            ret = _zp_multicast_stop_read_task(&zn->_tp);
+            ret = _zp_multicast_stop_read_task(zt);
             break;
         case _Z_TRANSPORT_RAWETH_TYPE:
-            ret = _zp_raweth_stop_read_task(&zn->_tp);
+            ret = _zp_raweth_stop_read_task(zt);
             break;
         default:
             ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
@@ -257,18 +371,63 @@ int8_t _zp_stop_read_task(_z_session_t *zn) {
     return ret;
 }
 
-int8_t _zp_stop_lease_task(_z_session_t *zn) {
+static int8_t __zp_stop_lease_task(_z_transport_t *zt) {
     int8_t ret = _Z_RES_OK;
     // Call transport function
-    switch (zn->_tp._type) {
+    switch (zt->_type) {
         case _Z_TRANSPORT_UNICAST_TYPE:
-            ret = _zp_unicast_stop_lease_task(&zn->_tp);
+            ret = _zp_unicast_stop_lease_task(zt);
             break;
         case _Z_TRANSPORT_MULTICAST_TYPE:
-            ret = _zp_multicast_stop_lease_task(&zn->_tp._transport._multicast);
+            ret = _zp_multicast_stop_lease_task(&zt->_transport._multicast);
             break;
         case _Z_TRANSPORT_RAWETH_TYPE:
-            ret = _zp_multicast_stop_lease_task(&zn->_tp._transport._raweth);
+            ret = _zp_multicast_stop_lease_task(&zt->_transport._raweth);
+            break;
+        default:
+            ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+            break;
+    }
+    return ret;
+}
+
+static int8_t __zp_start_tx_task(_z_transport_t *zt, zp_task_attr_t *attr) {
+    int8_t ret = _Z_RES_OK;
+    // Allocate task
+    zp_task_t *task = (zp_task_t *)zp_malloc(sizeof(zp_task_t));
+    if (task == NULL) {
+        ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    // Call transport function
+    if (ret == _Z_RES_OK) {
+        switch (zt->_type) {
+            case _Z_TRANSPORT_UNICAST_TYPE:
+                ret = _zp_unicast_start_tx_task(zt, attr, task);
+                break;
+            case _Z_TRANSPORT_MULTICAST_TYPE:
+                ret = _zp_multicast_start_tx_task(&zt->_transport._multicast, attr, task);
+                break;
+            default:
+                ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+                break;
+        }
+    }
+    // Free task if operation failed
+    if (ret != _Z_RES_OK) {
+        zp_free(task);
+    }
+    return ret;
+}
+
+static int8_t __zp_stop_tx_task(_z_transport_t *zt) {
+    int8_t ret = _Z_RES_OK;
+    // Call transport function
+    switch (zt->_type) {
+        case _Z_TRANSPORT_UNICAST_TYPE:
+            ret = _zp_unicast_stop_tx_task(zt);
+            break;
+        case _Z_TRANSPORT_MULTICAST_TYPE:
+            ret = _zp_multicast_stop_tx_task(&zt->_transport._multicast);
             break;
         default:
             ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
@@ -276,4 +435,62 @@ int8_t _zp_stop_lease_task(_z_session_t *zn) {
     }
     return ret;
 }
+
+// Each transport of the session runs its own tasks, the first failure is returned
+int8_t _zp_start_read_task(_z_session_t *zn, zp_task_attr_t *attr) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; (i < _z_session_transports_len(zn)) && (ret == _Z_RES_OK); i++) {
+        ret = __zp_start_read_task(_z_session_transport(zn, i), attr);
+    }
+    return ret;
+}
+
+int8_t _zp_start_lease_task(_z_session_t *zn, zp_task_attr_t *attr) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; (i < _z_session_transports_len(zn)) && (ret == _Z_RES_OK); i++) {
+        ret = __zp_start_lease_task(_z_session_transport(zn, i), attr);
+    }
+    return ret;
+}
+
+int8_t _zp_stop_read_task(_z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        int8_t res = __zp_stop_read_task(_z_session_transport(zn, i));
+        if (ret == _Z_RES_OK) {
+            ret = res;
+        }
+    }
+    return ret;
+}
+
+int8_t _zp_stop_lease_task(_z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        int8_t res = __zp_stop_lease_task(_z_session_transport(zn, i));
+        if (ret == _Z_RES_OK) {
+            ret = res;
+        }
+    }
+    return ret;
+}
+
+int8_t _zp_start_tx_task(_z_session_t *zn, zp_task_attr_t *attr) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; (i < _z_session_transports_len(zn)) && (ret == _Z_RES_OK); i++) {
+        ret = __zp_start_tx_task(_z_session_transport(zn, i), attr);
+    }
+    return ret;
+}
+
+int8_t _zp_stop_tx_task(_z_session_t *zn) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        int8_t res = __zp_stop_tx_task(_z_session_transport(zn, i));
+        if (ret == _Z_RES_OK) {
+            ret = res;
+        }
+    }
+    return ret;
+}
 #endif  // Z_FEATURE_MULTI_THREAD == 1
@@ -243,9 +243,7 @@ int8_t _z_source_info_encode_ext(_z_wbuf_t *wbf, const _z_source_info_t *info) {
 }
 
 /*------------------ Push Body Field ------------------*/
-int8_t _z_push_body_encode(_z_wbuf_t *wbf, const _z_push_body_t *pshb) {
-    (void)(wbf);
-    (void)(pshb);
+int8_t _z_push_body_prefix_encode(_z_wbuf_t *wbf, const _z_push_body_t *pshb) {
     int8_t ret = _Z_RES_OK;
     uint8_t header = pshb->_is_put ? _Z_MID_Z_PUT : _Z_MID_Z_DEL;
     _Bool has_source_info = _z_id_check(pshb->_body._put._commons._source_info._id) ||
@@ -285,6 +283,11 @@ int8_t _z_push_body_encode(_z_wbuf_t *wbf, const _z_push_body_t *pshb) {
         ret |= _z_source_info_encode_ext(wbf, &pshb->_body._put._commons._source_info);
     }
 
+    return ret;
+}
+
+int8_t _z_push_body_encode(_z_wbuf_t *wbf, const _z_push_body_t *pshb) {
+    int8_t ret = _z_push_body_prefix_encode(wbf, pshb);
     if ((ret == _Z_RES_OK) && pshb->_is_put) {
         ret = _z_bytes_encode(wbf, &pshb->_body._put._payload);
     }
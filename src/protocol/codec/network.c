@@ -36,7 +36,7 @@
 
 /*------------------ Push Message ------------------*/
 
-int8_t _z_push_encode(_z_wbuf_t *wbf, const _z_n_msg_push_t *msg) {
+int8_t _z_push_prefix_encode(_z_wbuf_t *wbf, const _z_n_msg_push_t *msg) {
     uint8_t header = _Z_MID_N_PUSH | (_z_keyexpr_is_local(&msg->_key) ? _Z_FLAG_N_REQUEST_M : 0);
     _Bool has_suffix = _z_keyexpr_has_suffix(msg->_key);
     _Bool has_qos_ext = msg->_qos._val != _Z_N_QOS_DEFAULT._val;
@@ -60,7 +60,21 @@ int8_t _z_push_encode(_z_wbuf_t *wbf, const _z_n_msg_push_t *msg) {
         _Z_RETURN_IF_ERR(_z_timestamp_encode_ext(wbf, &msg->_timestamp));
     }
 
-    _Z_RETURN_IF_ERR(_z_push_body_encode(wbf, &msg->_body));
+    _Z_RETURN_IF_ERR(_z_push_body_prefix_encode(wbf, &msg->_body));
+
+    return _Z_RES_OK;
+}
+
+int8_t _z_push_encode(_z_wbuf_t *wbf, const _z_n_msg_push_t *msg) {
+    if (_z_bytes_is_empty(&msg->_prefix) == false) {
+        // Everything up to the payload was encoded beforehand
+        _Z_RETURN_IF_ERR(_z_wbuf_write_bytes(wbf, msg->_prefix.start, 0, msg->_prefix.len));
+    } else {
+        _Z_RETURN_IF_ERR(_z_push_prefix_encode(wbf, msg));
+    }
+    if (msg->_body._is_put == true) {
+        _Z_RETURN_IF_ERR(_z_bytes_encode(wbf, &msg->_body._body._put._payload));
+    }
 
     return _Z_RES_OK;
 }
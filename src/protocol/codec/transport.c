@@ -57,7 +57,11 @@ int8_t _z_join_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_join_t *msg
     _Z_RETURN_IF_ERR(_z_zint_encode(wbf, msg->_next_sn._val._plain._best_effort));
     if (msg->_next_sn._is_qos) {
         if (_Z_HAS_FLAG(header, _Z_FLAG_T_Z)) {
-            _Z_RETURN_IF_ERR(_z_uint8_encode(wbf, _Z_MSG_EXT_ENC_ZBUF | _Z_MSG_EXT_FLAG_M | 1));
+            uint8_t ext = _Z_MSG_EXT_ENC_ZBUF | _Z_MSG_EXT_FLAG_M | 1;
+            if (msg->_ext_reliability == true) {
+                ext |= _Z_MSG_EXT_FLAG_Z;  // The reliability extension follows
+            }
+            _Z_RETURN_IF_ERR(_z_uint8_encode(wbf, ext));
             size_t len = 0;
             for (uint8_t i = 0; (i < Z_PRIORITIES_NUM) && (ret == _Z_RES_OK); i++) {
                 len += _z_zint_len(msg->_next_sn._val._qos[i]._reliable) +
@@ -73,6 +77,14 @@ int8_t _z_join_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_join_t *msg
             ret |= _Z_ERR_MESSAGE_SERIALIZATION_FAILED;
         }
     }
+    if ((ret == _Z_RES_OK) && (msg->_ext_reliability == true)) {
+        if (_Z_HAS_FLAG(header, _Z_FLAG_T_Z)) {
+            _Z_RETURN_IF_ERR(_z_uint8_encode(wbf, _Z_MSG_EXT_ENC_UNIT | 0x0A));  // RELIABILITY: (enc=unit)(id=0x0A)
+        } else {
+            _Z_DEBUG("Attempted to serialize reliability extension, but the header extension flag was unset");
+            ret |= _Z_ERR_MESSAGE_SERIALIZATION_FAILED;
+        }
+    }
 
     return ret;
 }
@@ -88,6 +100,9 @@ int8_t _z_join_decode_ext(_z_msg_ext_t *extension, void *ctx) {
             ret |= _z_zint_decode(&msg->_next_sn._val._qos[i]._reliable, &zbf);
             ret |= _z_zint_decode(&msg->_next_sn._val._qos[i]._best_effort, &zbf);
         }
+    } else if (_Z_EXT_FULL_ID(extension->_header) ==
+               (_Z_MSG_EXT_ENC_UNIT | 0x0A)) {  // RELIABILITY: (enc=unit)(id=0x0A)
+        msg->_ext_reliability = true;
     } else if (_Z_MSG_EXT_IS_MANDATORY(extension->_header)) {
         ret = _Z_ERR_MESSAGE_EXTENSION_MANDATORY_AND_UNKNOWN;
     }
@@ -171,6 +186,36 @@ int8_t _z_init_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_init_t *msg
         _Z_RETURN_IF_ERR(_z_bytes_encode(wbf, &msg->_cookie))
     }
 
+    if (_Z_HAS_FLAG(header, _Z_FLAG_T_Z) == true) {
+        if (msg->_ext_qos == true) {
+            uint8_t ext = _Z_MSG_EXT_ENC_UNIT | 0x01;  // QOS: (enc=unit)(id=1)
+            if (msg->_ext_reliability == true) {
+                ext |= _Z_MSG_EXT_FLAG_Z;  // The reliability extension follows
+            }
+            _Z_RETURN_IF_ERR(_z_uint8_encode(wbf, ext))
+        }
+        if (msg->_ext_reliability == true) {
+            _Z_RETURN_IF_ERR(_z_uint8_encode(wbf, _Z_MSG_EXT_ENC_UNIT | 0x0A))  // RELIABILITY: (enc=unit)(id=0x0A)
+        }
+        if ((msg->_ext_qos == false) && (msg->_ext_reliability == false)) {
+            ret = _Z_ERR_MESSAGE_SERIALIZATION_FAILED;
+        }
+    }
+
+    return ret;
+}
+
+int8_t _z_init_decode_ext(_z_msg_ext_t *extension, void *ctx) {
+    int8_t ret = _Z_RES_OK;
+    _z_t_msg_init_t *msg = (_z_t_msg_init_t *)ctx;
+    if (_Z_EXT_FULL_ID(extension->_header) == (_Z_MSG_EXT_ENC_UNIT | 0x01)) {  // QOS: (enc=unit)(id=1)
+        msg->_ext_qos = true;
+    } else if (_Z_EXT_FULL_ID(extension->_header) ==
+               (_Z_MSG_EXT_ENC_UNIT | 0x0A)) {  // RELIABILITY: (enc=unit)(id=0x0A)
+        msg->_ext_reliability = true;
+    } else if (_Z_MSG_EXT_IS_MANDATORY(extension->_header)) {
+        ret = _Z_ERR_MESSAGE_EXTENSION_MANDATORY_AND_UNKNOWN;
+    }
     return ret;
 }
 
@@ -214,7 +259,7 @@ int8_t _z_init_decode(_z_t_msg_init_t *msg, _z_zbuf_t *zbf, uint8_t header) {
     }
 
     if ((ret == _Z_RES_OK) && (_Z_HAS_FLAG(header, _Z_FLAG_T_Z) == true)) {
-        ret |= _z_msg_ext_skip_non_mandatories(zbf, 0x01);
+        ret |= _z_msg_ext_decode_iter(zbf, _z_init_decode_ext, msg);
     }
 
     return ret;
@@ -318,6 +363,28 @@ int8_t _z_keep_alive_decode(_z_t_msg_keep_alive_t *msg, _z_zbuf_t *zbf, uint8_t
 }
 
 /*------------------ Frame Message ------------------*/
+// The QoS extension of the frame and fragment messages only carries the priority of the conduit
+int8_t _z_t_msg_ext_qos_encode(_z_wbuf_t *wbf, _z_n_qos_t qos) {
+    _Z_RETURN_IF_ERR(_z_uint8_encode(wbf, _Z_MSG_EXT_ENC_ZINT | _Z_MSG_EXT_FLAG_M | 0x01))
+    return _z_zint_encode(wbf, qos._val);
+}
+
+int8_t _z_t_msg_ext_qos_decode(_z_msg_ext_t *extension, void *ctx) {
+    int8_t ret = _Z_RES_OK;
+    _z_n_qos_t *qos = (_z_n_qos_t *)ctx;
+    if (_Z_EXT_FULL_ID(extension->_header) ==
+        (_Z_MSG_EXT_ENC_ZINT | _Z_MSG_EXT_FLAG_M | 0x01)) {  // QOS: (enc=zint)(mandatory=true)(id=1)
+        if (extension->_body._zint._val <= UINT8_MAX) {
+            qos->_val = (uint8_t)extension->_body._zint._val;
+        } else {
+            ret = _Z_ERR_MESSAGE_DESERIALIZATION_FAILED;
+        }
+    } else if (_Z_MSG_EXT_IS_MANDATORY(extension->_header)) {
+        ret = _Z_ERR_MESSAGE_EXTENSION_MANDATORY_AND_UNKNOWN;
+    }
+    return ret;
+}
+
 
 int8_t _z_frame_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_frame_t *msg) {
     int8_t ret = _Z_RES_OK;
@@ -325,7 +392,7 @@ int8_t _z_frame_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_frame_t *m
     _Z_RETURN_IF_ERR(_z_zint_encode(wbf, msg->_sn))
 
     if (_Z_HAS_FLAG(header, _Z_FLAG_T_Z)) {
-        ret = _Z_ERR_MESSAGE_SERIALIZATION_FAILED;
+        _Z_RETURN_IF_ERR(_z_t_msg_ext_qos_encode(wbf, msg->_ext_qos))
     }
     if (ret == _Z_RES_OK) {
         size_t len = _z_network_message_vec_len(&msg->_messages);
@@ -337,37 +404,71 @@ int8_t _z_frame_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_frame_t *m
     return ret;
 }
 
-int8_t _z_frame_decode(_z_t_msg_frame_t *msg, _z_zbuf_t *zbf, uint8_t header) {
+int8_t _z_frame_header_decode(_z_t_msg_frame_t *msg, _z_zbuf_t *zbf, uint8_t header) {
     int8_t ret = _Z_RES_OK;
     *msg = (_z_t_msg_frame_t){0};
+    msg->_ext_qos = _Z_N_QOS_DEFAULT;
 
     ret |= _z_zint_decode(&msg->_sn, zbf);
     if ((ret == _Z_RES_OK) && (_Z_HAS_FLAG(header, _Z_FLAG_T_Z) == true)) {
-        ret |= _z_msg_ext_skip_non_mandatories(zbf, 0x04);
+        ret |= _z_msg_ext_decode_iter(zbf, _z_t_msg_ext_qos_decode, &msg->_ext_qos);
+    }
+    if (ret == _Z_RES_OK) {
+        msg->_payload = zbf;
     }
+    return ret;
+}
+
+int8_t _z_frame_decode_next(_z_t_msg_frame_t *msg, _z_network_message_t *nm, _Bool *end) {
+    int8_t ret = _Z_RES_OK;
+    *end = true;
+
+    _z_zbuf_t *zbf = msg->_payload;
+    if ((zbf != NULL) && (_z_zbuf_len(zbf) > 0)) {
+        // Mark the reading position of the iobfer
+        size_t r_pos = _z_zbuf_get_rpos(zbf);
+        ret |= _z_network_message_decode(nm, zbf);
+        if (ret == _Z_RES_OK) {
+            *end = false;
+        } else {
+            _z_zbuf_set_rpos(zbf, r_pos);  // Restore the reading position of the iobfer
+
+            // FIXME: Check for the return error, since not all of them means a decoding error
+            //        in this particular case. As of now, we roll-back the reading position
+            //        and return to the Zenoh transport-level decoder.
+            //        https://github.com/eclipse-zenoh/zenoh-pico/pull/132#discussion_r1045593602
+            if ((ret & _Z_ERR_MESSAGE_ZENOH_UNKNOWN) == _Z_ERR_MESSAGE_ZENOH_UNKNOWN) {
+                ret = _Z_RES_OK;
+            }
+        }
+    }
+    if (*end == true) {
+        msg->_payload = NULL;
+    }
+    return ret;
+}
+
+int8_t _z_frame_decode(_z_t_msg_frame_t *msg, _z_zbuf_t *zbf, uint8_t header) {
+    int8_t ret = _z_frame_header_decode(msg, zbf, header);
     if (ret == _Z_RES_OK) {
         msg->_messages = _z_network_message_vec_make(_ZENOH_PICO_FRAME_MESSAGES_VEC_SIZE);
-        while (_z_zbuf_len(zbf) > 0) {
-            // Mark the reading position of the iobfer
-            size_t r_pos = _z_zbuf_get_rpos(zbf);
+        _Bool end = false;
+        while (ret == _Z_RES_OK) {
             _z_network_message_t *nm = (_z_network_message_t *)zp_malloc(sizeof(_z_network_message_t));
-            ret |= _z_network_message_decode(nm, zbf);
-            if (ret == _Z_RES_OK) {
-                _z_network_message_vec_append(&msg->_messages, nm);
-            } else {
+            if (nm == NULL) {
+                ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+                break;
+            }
+            ret |= _z_frame_decode_next(msg, nm, &end);
+            if (ret != _Z_RES_OK) {
                 _z_n_msg_free(&nm);
-
-                _z_zbuf_set_rpos(zbf, r_pos);  // Restore the reading position of the iobfer
-
-                // FIXME: Check for the return error, since not all of them means a decoding error
-                //        in this particular case. As of now, we roll-back the reading position
-                //        and return to the Zenoh transport-level decoder.
-                //        https://github.com/eclipse-zenoh/zenoh-pico/pull/132#discussion_r1045593602
-                if ((ret & _Z_ERR_MESSAGE_ZENOH_UNKNOWN) == _Z_ERR_MESSAGE_ZENOH_UNKNOWN) {
-                    ret = _Z_RES_OK;
-                }
                 break;
             }
+            if (end == true) {
+                zp_free(nm);
+                break;
+            }
+            _z_network_message_vec_append(&msg->_messages, nm);
         }
     }
     return ret;
@@ -379,7 +480,7 @@ int8_t _z_fragment_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_fragmen
     _Z_DEBUG("Encoding _Z_TRANSPORT_FRAGMENT");
     _Z_RETURN_IF_ERR(_z_zint_encode(wbf, msg->_sn))
     if (_Z_HAS_FLAG(header, _Z_FLAG_T_Z)) {
-        ret = _Z_ERR_MESSAGE_SERIALIZATION_FAILED;
+        _Z_RETURN_IF_ERR(_z_t_msg_ext_qos_encode(wbf, msg->_ext_qos))
     }
     if (ret == _Z_RES_OK && _z_bytes_check(msg->_payload)) {
         _Z_RETURN_IF_ERR(_z_wbuf_write_bytes(wbf, msg->_payload.start, 0, msg->_payload.len));
@@ -391,21 +492,70 @@ int8_t _z_fragment_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_fragmen
 int8_t _z_fragment_decode(_z_t_msg_fragment_t *msg, _z_zbuf_t *zbf, uint8_t header) {
     int8_t ret = _Z_RES_OK;
     *msg = (_z_t_msg_fragment_t){0};
+    msg->_ext_qos = _Z_N_QOS_DEFAULT;
 
     _Z_DEBUG("Decoding _Z_TRANSPORT_FRAGMENT");
     ret |= _z_zint_decode(&msg->_sn, zbf);
 
     if ((ret == _Z_RES_OK) && (_Z_HAS_FLAG(header, _Z_FLAG_T_Z) == true)) {
-        ret |= _z_msg_ext_skip_non_mandatories(zbf, 0x05);
+        ret |= _z_msg_ext_decode_iter(zbf, _z_t_msg_ext_qos_decode, &msg->_ext_qos);
     }
 
-    _z_bytes_t bytes = _z_bytes_wrap((uint8_t *)_z_zbuf_start(zbf), _z_zbuf_len(zbf));
-    _z_bytes_copy(&msg->_payload, &bytes);
+    // The payload borrows the decoding buffer, it is copied once into the defragmentation buffer
+    msg->_payload = _z_bytes_wrap((uint8_t *)_z_zbuf_start(zbf), _z_zbuf_len(zbf));
     zbf->_ios._r_pos = zbf->_ios._w_pos;
 
     return ret;
 }
 
+/*------------------ AckNack Message ------------------*/
+int8_t _z_ack_nack_encode(_z_wbuf_t *wbf, uint8_t header, const _z_t_msg_ack_nack_t *msg) {
+    int8_t ret = _Z_RES_OK;
+    _Z_DEBUG("Encoding _Z_MID_T_ACK_NACK");
+
+    _Z_RETURN_IF_ERR(_z_zint_encode(wbf, msg->_sn))
+    if (_Z_HAS_FLAG(header, _Z_FLAG_T_ACK_NACK_N) == true) {
+        _Z_RETURN_IF_ERR(_z_zint_encode(wbf, msg->_mask))
+    }
+    if (_Z_HAS_FLAG(header, _Z_FLAG_T_ACK_NACK_I) == true) {
+        uint8_t zidlen = _z_id_len(msg->_zid);
+        _Z_RETURN_IF_ERR(_z_uint8_encode(wbf, ((zidlen - 1) & 0x0F) << 4))
+        _Z_RETURN_IF_ERR(_z_wbuf_write_bytes(wbf, msg->_zid.id, 0, zidlen))
+    }
+    if (_Z_HAS_FLAG(header, _Z_FLAG_T_Z) == true) {
+        _Z_RETURN_IF_ERR(_z_t_msg_ext_qos_encode(wbf, msg->_ext_qos))
+    }
+
+    return ret;
+}
+
+int8_t _z_ack_nack_decode(_z_t_msg_ack_nack_t *msg, _z_zbuf_t *zbf, uint8_t header) {
+    _Z_DEBUG("Decoding _Z_MID_T_ACK_NACK");
+    int8_t ret = _Z_RES_OK;
+    *msg = (_z_t_msg_ack_nack_t){0};
+    msg->_ext_qos = _Z_N_QOS_DEFAULT;
+
+    ret |= _z_zint_decode(&msg->_sn, zbf);
+    if ((ret == _Z_RES_OK) && (_Z_HAS_FLAG(header, _Z_FLAG_T_ACK_NACK_N) == true)) {
+        ret |= _z_zint_decode(&msg->_mask, zbf);
+    }
+    if ((ret == _Z_RES_OK) && (_Z_HAS_FLAG(header, _Z_FLAG_T_ACK_NACK_I) == true)) {
+        uint8_t cbyte = 0;
+        ret |= _z_uint8_decode(&cbyte, zbf);
+        uint8_t zidlen = ((cbyte & 0xF0) >> 4) + 1;
+        if ((ret == _Z_RES_OK) && (_z_zbuf_len(zbf) >= zidlen)) {
+            _z_zbuf_read_bytes(zbf, msg->_zid.id, 0, zidlen);
+        } else {
+            ret = _Z_ERR_MESSAGE_DESERIALIZATION_FAILED;
+        }
+    }
+    if ((ret == _Z_RES_OK) && (_Z_HAS_FLAG(header, _Z_FLAG_T_Z) == true)) {
+        ret |= _z_msg_ext_decode_iter(zbf, _z_t_msg_ext_qos_decode, &msg->_ext_qos);
+    }
+
+    return ret;
+}
+
 /*------------------ Transport Extensions Message ------------------*/
 int8_t _z_extensions_encode(_z_wbuf_t *wbf, uint8_t header, const _z_msg_ext_vec_t *v_ext) {
     (void)(header);
@@ -462,6 +612,9 @@ int8_t _z_transport_message_encode(_z_wbuf_t *wbf, const _z_transport_message_t
         case _Z_MID_T_CLOSE: {
             ret |= _z_close_encode(wbf, msg->_header, &msg->_body._close);
         } break;
+        case _Z_MID_T_ACK_NACK: {
+            ret |= _z_ack_nack_encode(wbf, msg->_header, &msg->_body._ack_nack);
+        } break;
         default: {
             _Z_DEBUG("WARNING: Trying to encode session message with unknown ID(%d)", _Z_MID(msg->_header));
             ret |= _Z_ERR_MESSAGE_TRANSPORT_UNKNOWN;
@@ -471,7 +624,7 @@ int8_t _z_transport_message_encode(_z_wbuf_t *wbf, const _z_transport_message_t
     return ret;
 }
 
-int8_t _z_transport_message_decode(_z_transport_message_t *msg, _z_zbuf_t *zbf) {
+static int8_t __z_transport_message_decode(_z_transport_message_t *msg, _z_zbuf_t *zbf, _Bool stream) {
     int8_t ret = _Z_RES_OK;
 
     ret |= _z_uint8_decode(&msg->_header, zbf);  // Decode the header
@@ -479,7 +632,11 @@ int8_t _z_transport_message_decode(_z_transport_message_t *msg, _z_zbuf_t *zbf)
         uint8_t mid = _Z_MID(msg->_header);
         switch (mid) {
             case _Z_MID_T_FRAME: {
-                ret |= _z_frame_decode(&msg->_body._frame, zbf, msg->_header);
+                if (stream == true) {
+                    ret |= _z_frame_header_decode(&msg->_body._frame, zbf, msg->_header);
+                } else {
+                    ret |= _z_frame_decode(&msg->_body._frame, zbf, msg->_header);
+                }
             } break;
             case _Z_MID_T_FRAGMENT: {
                 ret |= _z_fragment_decode(&msg->_body._fragment, zbf, msg->_header);
@@ -499,6 +656,9 @@ int8_t _z_transport_message_decode(_z_transport_message_t *msg, _z_zbuf_t *zbf)
             case _Z_MID_T_CLOSE: {
                 ret |= _z_close_decode(&msg->_body._close, zbf, msg->_header);
             } break;
+            case _Z_MID_T_ACK_NACK: {
+                ret |= _z_ack_nack_decode(&msg->_body._ack_nack, zbf, msg->_header);
+            } break;
             default: {
                 _Z_DEBUG("WARNING: Trying to decode session message with unknown ID(0x%x) (header=0x%x)", mid,
                          msg->_header);
@@ -511,3 +671,11 @@ int8_t _z_transport_message_decode(_z_transport_message_t *msg, _z_zbuf_t *zbf)
 
     return ret;
 }
+
+int8_t _z_transport_message_decode(_z_transport_message_t *msg, _z_zbuf_t *zbf) {
+    return __z_transport_message_decode(msg, zbf, false);
+}
+
+int8_t _z_transport_message_decode_stream(_z_transport_message_t *msg, _z_zbuf_t *zbf) {
+    return __z_transport_message_decode(msg, zbf, true);
+}
@@ -252,6 +252,27 @@ _z_network_message_t _z_n_msg_make_ack(_z_zint_t rid, _Z_MOVE(_z_keyexpr_t) key)
             },
     };
 }
+_z_n_qos_t _z_n_msg_get_qos(const _z_network_message_t *msg) {
+    _z_n_qos_t qos = _Z_N_QOS_DEFAULT;
+    switch (msg->_tag) {
+        case _Z_N_DECLARE: {
+            qos = msg->_body._declare._ext_qos;
+        } break;
+        case _Z_N_PUSH: {
+            qos = msg->_body._push._qos;
+        } break;
+        case _Z_N_REQUEST: {
+            qos = msg->_body._request._ext_qos;
+        } break;
+        case _Z_N_RESPONSE: {
+            qos = msg->_body._response._ext_qos;
+        } break;
+        default:
+            break;
+    }
+    return qos;
+}
+
 void _z_msg_fix_mapping(_z_zenoh_message_t *msg, uint16_t mapping) {
     switch (msg->_tag) {
         case _Z_N_DECLARE: {
@@ -38,6 +38,8 @@ void _z_t_msg_frame_clear(_z_t_msg_frame_t *msg) { _z_network_message_vec_clear(
 
 void _z_t_msg_fragment_clear(_z_t_msg_fragment_t *msg) { _z_bytes_clear(&msg->_payload); }
 
+void _z_t_msg_ack_nack_clear(_z_t_msg_ack_nack_t *msg) { (void)(msg); }
+
 void _z_t_msg_clear(_z_transport_message_t *msg) {
     uint8_t mid = _Z_MID(msg->_header);
     switch (mid) {
@@ -69,6 +71,10 @@ void _z_t_msg_clear(_z_transport_message_t *msg) {
             _z_t_msg_fragment_clear(&msg->_body._fragment);
         } break;
 
+        case _Z_MID_T_ACK_NACK: {
+            _z_t_msg_ack_nack_clear(&msg->_body._ack_nack);
+        } break;
+
         default: {
             _Z_DEBUG("WARNING: Trying to clear transport message with unknown ID(%d)", mid);
         } break;
@@ -89,6 +95,7 @@ _z_transport_message_t _z_t_msg_make_join(z_whatami_t whatami, _z_zint_t lease,
     msg._body._join._batch_size = Z_BATCH_MULTICAST_SIZE;
     msg._body._join._next_sn = next_sn;
     msg._body._join._zid = zid;
+    msg._body._join._ext_reliability = false;
 
     if ((lease % 1000) == 0) {
         _Z_SET_FLAG(msg._header, _Z_FLAG_T_JOIN_T);
@@ -125,6 +132,13 @@ _z_transport_message_t _z_t_msg_make_init_syn(z_whatami_t whatami, _z_id_t zid)
         _Z_SET_FLAG(msg._header, _Z_FLAG_T_INIT_S);
     }
 
+    // Announce one conduit per priority, and the repair of the reliable conduits
+    msg._body._init._ext_qos = (Z_FEATURE_PRIORITY_LANES == 1);
+    msg._body._init._ext_reliability = (Z_FEATURE_RELIABILITY == 1);
+    if ((msg._body._init._ext_qos == true) || (msg._body._init._ext_reliability == true)) {
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
+    }
+
     return msg;
 }
 
@@ -147,6 +161,13 @@ _z_transport_message_t _z_t_msg_make_init_ack(z_whatami_t whatami, _z_id_t zid,
         _Z_SET_FLAG(msg._header, _Z_FLAG_T_INIT_S);
     }
 
+    // Announce one conduit per priority, and the repair of the reliable conduits
+    msg._body._init._ext_qos = (Z_FEATURE_PRIORITY_LANES == 1);
+    msg._body._init._ext_reliability = (Z_FEATURE_RELIABILITY == 1);
+    if ((msg._body._init._ext_qos == true) || (msg._body._init._ext_reliability == true)) {
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
+    }
+
     return msg;
 }
 
@@ -203,7 +224,8 @@ _z_transport_message_t _z_t_msg_make_keep_alive(void) {
     return msg;
 }
 
-_z_transport_message_t _z_t_msg_make_frame(_z_zint_t sn, _z_network_message_vec_t messages, _Bool is_reliable) {
+_z_transport_message_t _z_t_msg_make_frame(_z_zint_t sn, _z_network_message_vec_t messages, _Bool is_reliable,
+                                           _z_n_qos_t qos) {
     _z_transport_message_t msg;
     msg._header = _Z_MID_T_FRAME;
 
@@ -212,13 +234,19 @@ _z_transport_message_t _z_t_msg_make_frame(_z_zint_t sn, _z_network_message_vec_
         _Z_SET_FLAG(msg._header, _Z_FLAG_T_FRAME_R);
     }
 
+    msg._body._frame._ext_qos = qos;
+    if (qos._val != _Z_N_QOS_DEFAULT._val) {
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
+    }
+
     msg._body._frame._messages = messages;
+    msg._body._frame._payload = NULL;
 
     return msg;
 }
 
 /*------------------ Frame Message ------------------*/
-_z_transport_message_t _z_t_msg_make_frame_header(_z_zint_t sn, _Bool is_reliable) {
+_z_transport_message_t _z_t_msg_make_frame_header(_z_zint_t sn, _Bool is_reliable, _z_n_qos_t qos) {
     _z_transport_message_t msg;
     msg._header = _Z_MID_T_FRAME;
 
@@ -227,16 +255,24 @@ _z_transport_message_t _z_t_msg_make_frame_header(_z_zint_t sn, _Bool is_reliabl
         _Z_SET_FLAG(msg._header, _Z_FLAG_T_FRAME_R);
     }
 
+    msg._body._frame._ext_qos = qos;
+    if (qos._val != _Z_N_QOS_DEFAULT._val) {
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
+    }
+
     msg._body._frame._messages = _z_network_message_vec_make(0);
+    msg._body._frame._payload = NULL;
 
     return msg;
 }
 
 /*------------------ Fragment Message ------------------*/
-_z_transport_message_t _z_t_msg_make_fragment_header(_z_zint_t sn, _Bool is_reliable, _Bool is_last) {
-    return _z_t_msg_make_fragment(sn, _z_bytes_empty(), is_reliable, is_last);
+_z_transport_message_t _z_t_msg_make_fragment_header(_z_zint_t sn, _Bool is_reliable, _Bool is_last,
+                                                     _z_n_qos_t qos) {
+    return _z_t_msg_make_fragment(sn, _z_bytes_empty(), is_reliable, is_last, qos);
 }
-_z_transport_message_t _z_t_msg_make_fragment(_z_zint_t sn, _z_bytes_t payload, _Bool is_reliable, _Bool is_last) {
+_z_transport_message_t _z_t_msg_make_fragment(_z_zint_t sn, _z_bytes_t payload, _Bool is_reliable, _Bool is_last,
+                                              _z_n_qos_t qos) {
     _z_transport_message_t msg;
     msg._header = _Z_MID_T_FRAGMENT;
     if (is_last == false) {
@@ -249,11 +285,47 @@ _z_transport_message_t _z_t_msg_make_fragment(_z_zint_t sn, _z_bytes_t payload,
     msg._body._fragment._sn = sn;
     msg._body._fragment._payload = payload;
 
+    msg._body._fragment._ext_qos = qos;
+    if (qos._val != _Z_N_QOS_DEFAULT._val) {
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
+    }
+
+    return msg;
+}
+
+/*------------------ AckNack Message ------------------*/
+_z_transport_message_t _z_t_msg_make_ack(_z_zint_t sn, _z_n_qos_t qos) {
+    _z_transport_message_t msg;
+    msg._header = _Z_MID_T_ACK_NACK;
+
+    msg._body._ack_nack._sn = sn;
+    msg._body._ack_nack._mask = 0;
+    msg._body._ack_nack._zid = _z_id_empty();
+
+    msg._body._ack_nack._ext_qos = qos;
+    if (qos._val != _Z_N_QOS_DEFAULT._val) {
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
+    }
+
+    return msg;
+}
+
+_z_transport_message_t _z_t_msg_make_nack(_z_zint_t sn, _z_zint_t mask, _z_id_t zid, _z_n_qos_t qos) {
+    _z_transport_message_t msg = _z_t_msg_make_ack(sn, qos);
+    _Z_SET_FLAG(msg._header, _Z_FLAG_T_ACK_NACK_N);
+
+    msg._body._ack_nack._mask = mask;
+    msg._body._ack_nack._zid = zid;
+    if (_z_id_check(zid) == true) {
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_ACK_NACK_I);
+    }
+
     return msg;
 }
 
 void _z_t_msg_copy_fragment(_z_t_msg_fragment_t *clone, _z_t_msg_fragment_t *msg) {
     _z_bytes_copy(&clone->_payload, &msg->_payload);
+    clone->_ext_qos = msg->_ext_qos;
 }
 
 void _z_t_msg_copy_join(_z_t_msg_join_t *clone, _z_t_msg_join_t *msg) {
@@ -264,6 +336,7 @@ void _z_t_msg_copy_join(_z_t_msg_join_t *clone, _z_t_msg_join_t *msg) {
     clone->_req_id_res = msg->_req_id_res;
     clone->_batch_size = msg->_batch_size;
     clone->_next_sn = msg->_next_sn;
+    clone->_ext_reliability = msg->_ext_reliability;
     memcpy(clone->_zid.id, msg->_zid.id, 16);
 }
 
@@ -273,6 +346,8 @@ void _z_t_msg_copy_init(_z_t_msg_init_t *clone, _z_t_msg_init_t *msg) {
     clone->_seq_num_res = msg->_seq_num_res;
     clone->_req_id_res = msg->_req_id_res;
     clone->_batch_size = msg->_batch_size;
+    clone->_ext_qos = msg->_ext_qos;
+    clone->_ext_reliability = msg->_ext_reliability;
     memcpy(clone->_zid.id, msg->_zid.id, 16);
     _z_bytes_copy(&clone->_cookie, &msg->_cookie);
 }
@@ -292,9 +367,13 @@ void _z_t_msg_copy_keep_alive(_z_t_msg_keep_alive_t *clone, _z_t_msg_keep_alive_
 
 void _z_t_msg_copy_frame(_z_t_msg_frame_t *clone, _z_t_msg_frame_t *msg) {
     clone->_sn = msg->_sn;
+    clone->_ext_qos = msg->_ext_qos;
     _z_network_message_vec_copy(&clone->_messages, &msg->_messages);
+    clone->_payload = NULL;
 }
 
+void _z_t_msg_copy_ack_nack(_z_t_msg_ack_nack_t *clone, _z_t_msg_ack_nack_t *msg) { *clone = *msg; }
+
 /*------------------ Transport Message ------------------*/
 void _z_t_msg_copy(_z_transport_message_t *clone, _z_transport_message_t *msg) {
     clone->_header = msg->_header;
@@ -329,6 +408,10 @@ void _z_t_msg_copy(_z_transport_message_t *clone, _z_transport_message_t *msg) {
             _z_t_msg_copy_fragment(&clone->_body._fragment, &msg->_body._fragment);
         } break;
 
+        case _Z_MID_T_ACK_NACK: {
+            _z_t_msg_copy_ack_nack(&clone->_body._ack_nack, &msg->_body._ack_nack);
+        } break;
+
         default: {
             _Z_DEBUG("WARNING: Trying to copy transport message with unknown ID(%d)", mid);
         } break;
@@ -528,6 +528,39 @@ int8_t _z_wbuf_siphon(_z_wbuf_t *dst, _z_wbuf_t *src, size_t length) {
     return ret;
 }
 
+int8_t _z_wbuf_siphon_ref(_z_wbuf_t *dst, _z_wbuf_t *src, size_t length) {
+    int8_t ret = _Z_RES_OK;
+
+    size_t llength = length;
+    while ((ret == _Z_RES_OK) && (llength > (size_t)0)) {
+        assert(src->_r_idx <= src->_w_idx);
+        _z_iosli_t *ios = _z_wbuf_get_iosli(src, src->_r_idx);
+        size_t readable = _z_iosli_readable(ios);
+        if (readable > (size_t)0) {
+            // Append a borrowing slice on the readable bytes, it is dropped on the next reset of dst
+            size_t to_read = (readable <= llength) ? readable : llength;
+            _z_iosli_t wios = _z_iosli_wrap(_z_ptr_u8_offset(ios->_buf, ios->_r_pos), to_read, 0, to_read);
+            _z_iosli_t *pios = _z_iosli_clone(&wios);
+            size_t n = _z_wbuf_len_iosli(dst);
+            if (pios != NULL) {
+                _z_iosli_vec_append(&dst->_ioss, pios);
+            }
+            if (_z_wbuf_len_iosli(dst) == n) {
+                zp_free(pios);
+                ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+            } else {
+                dst->_w_idx = n;
+                ios->_r_pos = ios->_r_pos + to_read;
+                llength = llength - to_read;
+            }
+        } else {
+            src->_r_idx = src->_r_idx + (size_t)1;
+        }
+    }
+
+    return ret;
+}
+
 void _z_wbuf_copy(_z_wbuf_t *dst, const _z_wbuf_t *src) {
     dst->_capacity = src->_capacity;
     dst->_r_idx = src->_r_idx;
@@ -540,11 +573,11 @@ void _z_wbuf_reset(_z_wbuf_t *wbf) {
     wbf->_r_idx = 0;
     wbf->_w_idx = 0;
 
-    // Reset to default iosli allocation
-    for (size_t i = 0; i < _z_iosli_vec_len(&wbf->_ioss); i++) {
-        _z_iosli_t *ios = _z_wbuf_get_iosli(wbf, i);
+    // Reset to default iosli allocation, iterating backwards as borrowing slices are removed
+    for (size_t i = _z_iosli_vec_len(&wbf->_ioss); i > (size_t)0; i--) {
+        _z_iosli_t *ios = _z_wbuf_get_iosli(wbf, i - (size_t)1);
         if (ios->_is_alloc == false) {
-            _z_iosli_vec_remove(&wbf->_ioss, i);
+            _z_iosli_vec_remove(&wbf->_ioss, i - (size_t)1);
         } else {
             _z_iosli_reset(ios);
         }
@@ -563,3 +596,91 @@ void _z_wbuf_free(_z_wbuf_t **wbf) {
         *wbf = NULL;
     }
 }
+
+/*------------------ DBuf ------------------*/
+_z_dbuf_t _z_dbuf_make(size_t capacity, size_t max, _Bool is_expandable) {
+    _z_dbuf_t dbf;
+    if (capacity > (size_t)0) {
+        dbf._ios = _z_iosli_make(capacity);
+    } else {
+        dbf._ios = _z_iosli_wrap(NULL, 0, 0, 0);
+    }
+    dbf._max = max;
+    dbf._is_expandable = is_expandable;
+    dbf._is_overflow = false;
+    return dbf;
+}
+
+size_t _z_dbuf_capacity(const _z_dbuf_t *dbf) { return dbf->_ios._capacity; }
+
+size_t _z_dbuf_len(const _z_dbuf_t *dbf) { return _z_iosli_readable(&dbf->_ios); }
+
+_Bool _z_dbuf_is_overflow(const _z_dbuf_t *dbf) { return dbf->_is_overflow; }
+
+static int8_t __z_dbuf_reserve(_z_dbuf_t *dbf, size_t length) {
+    size_t capacity = dbf->_ios._capacity * (size_t)2;
+    if (capacity < Z_IOSLICE_SIZE) {
+        capacity = Z_IOSLICE_SIZE;
+    }
+    if (capacity < length) {
+        capacity = length;
+    }
+    if (capacity > dbf->_max) {
+        capacity = dbf->_max;
+    }
+
+    // The data written so far is moved at most once per doubling of the capacity
+    uint8_t *buf = (uint8_t *)zp_realloc((dbf->_ios._is_alloc == true) ? dbf->_ios._buf : NULL, capacity);
+    if (buf == NULL) {
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    dbf->_ios._buf = buf;
+    dbf->_ios._capacity = capacity;
+    dbf->_ios._is_alloc = true;
+    return _Z_RES_OK;
+}
+
+int8_t _z_dbuf_write_bytes(_z_dbuf_t *dbf, const uint8_t *bs, size_t length) {
+    int8_t ret = _Z_RES_OK;
+
+    size_t len = _z_dbuf_len(dbf) + length;
+    if ((dbf->_is_overflow == true) || (len > dbf->_max)) {
+        ret = _Z_ERR_TRANSPORT_NO_SPACE;
+    } else if (len > dbf->_ios._capacity) {
+        ret = (dbf->_is_expandable == true) ? __z_dbuf_reserve(dbf, len) : _Z_ERR_TRANSPORT_NO_SPACE;
+    } else {
+        // Enough space left
+    }
+
+    if (ret == _Z_RES_OK) {
+        _z_iosli_write_bytes(&dbf->_ios, bs, 0, length);
+    } else {
+        // The rest of the message is discarded until the buffer is reset
+        dbf->_is_overflow = true;
+    }
+
+    return ret;
+}
+
+_z_zbuf_t _z_dbuf_as_zbuf(const _z_dbuf_t *dbf) {
+    _z_zbuf_t zbf;
+    zbf._ios = _z_iosli_wrap(dbf->_ios._buf, dbf->_ios._capacity, dbf->_ios._r_pos, dbf->_ios._w_pos);
+    return zbf;
+}
+
+void _z_dbuf_copy(_z_dbuf_t *dst, const _z_dbuf_t *src) {
+    _z_iosli_copy(&dst->_ios, &src->_ios);
+    dst->_max = src->_max;
+    dst->_is_expandable = src->_is_expandable;
+    dst->_is_overflow = src->_is_overflow;
+}
+
+void _z_dbuf_reset(_z_dbuf_t *dbf) {
+    _z_iosli_reset(&dbf->_ios);
+    dbf->_is_overflow = false;
+}
+
+void _z_dbuf_clear(_z_dbuf_t *dbf) {
+    _z_iosli_clear(&dbf->_ios);
+    *dbf = _z_dbuf_make(0, dbf->_max, dbf->_is_expandable);
+}
@@ -20,6 +20,7 @@
 
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/utils/pointers.h"
+#include "zenoh-pico/utils/simd.h"
 #include "zenoh-pico/utils/string.h"
 
 _z_keyexpr_t _z_rname(const char *rname) { return _z_rid_with_suffix(0, rname); }
@@ -84,6 +85,30 @@ _z_keyexpr_t _z_keyexpr_alias(_z_keyexpr_t src) {
 }
 
 /*------------------ Canonize helpers ------------------*/
+// Whether a chunk contains one of the characters checked by the canonization, most chunks are verbatim
+static _Bool __zp_ke_chunk_has_specials(const char *start, const char *end) {
+    _Bool result = false;
+    size_t len = (start < end) ? (size_t)(end - start) : (size_t)0;
+    size_t i = 0;
+#ifdef _Z_SIMD_WIDTH
+    for (; (result == false) && ((len - i) >= (size_t)_Z_SIMD_WIDTH); i = i + (size_t)_Z_SIMD_WIDTH) {
+        _z_simd_t block = _z_simd_load(&start[i]);
+        result = ((_z_simd_match(block, '*') | _z_simd_match(block, '$') | _z_simd_match(block, '#') |
+                   _z_simd_match(block, '?')) != (uint64_t)0);
+    }
+#endif
+    for (; (result == false) && (i < len); i++) {
+        result = ((start[i] == '*') || (start[i] == '$') || (start[i] == '#') || (start[i] == '?'));
+    }
+    return result;
+}
+
+// The next '/' of a key expression, or NULL
+static char *__zp_ke_next_slash(char *reader, const char *end) {
+    char const *slash = _z_bstrchr((_z_str_se_t){.start = reader, .end = end}, '/');
+    return (slash != NULL) ? &reader[slash - reader] : NULL;
+}
+
 zp_keyexpr_canon_status_t __zp_canon_prefix(const char *start, size_t *len) {
     zp_keyexpr_canon_status_t ret = Z_KEYEXPR_CANON_SUCCESS;
 
@@ -93,7 +118,7 @@ zp_keyexpr_canon_status_t __zp_canon_prefix(const char *start, size_t *len) {
     char const *next_slash;
 
     do {
-        next_slash = strchr(chunk_start, '/');
+        next_slash = _z_bstrchr((_z_str_se_t){.start = chunk_start, .end = end}, '/');
         const char *chunk_end = next_slash ? next_slash : end;
         size_t chunk_len = _z_ptr_char_diff(chunk_end, chunk_start);
         switch (chunk_len) {
@@ -102,12 +127,14 @@ zp_keyexpr_canon_status_t __zp_canon_prefix(const char *start, size_t *len) {
             } break;
 
             case 1: {
-                if (in_big_wild && (chunk_start[0] == '*')) {
-                    *len = _z_ptr_char_diff(chunk_start, start) - (size_t)3;
-                    ret = Z_KEYEXPR_CANON_SINGLE_STAR_AFTER_DOUBLE_STAR;
-                } else {
-                    chunk_start = _z_cptr_char_offset(chunk_end, 1);
-                    continue;
+                if (chunk_start[0] == '*') {
+                    if (in_big_wild) {
+                        *len = _z_ptr_char_diff(chunk_start, start) - (size_t)3;
+                        ret = Z_KEYEXPR_CANON_SINGLE_STAR_AFTER_DOUBLE_STAR;
+                    } else {
+                        chunk_start = _z_cptr_char_offset(chunk_end, 1);
+                        continue;
+                    }
                 }
             } break;
 
@@ -138,7 +165,9 @@ zp_keyexpr_canon_status_t __zp_canon_prefix(const char *start, size_t *len) {
         }
 
         unsigned char in_dollar = 0;
-        for (char const *c = chunk_start; (c < chunk_end) && (ret == Z_KEYEXPR_CANON_SUCCESS);
+        // A verbatim chunk is valid as is
+        const char *scan_end = (__zp_ke_chunk_has_specials(chunk_start, chunk_end) == true) ? chunk_end : chunk_start;
+        for (char const *c = chunk_start; (c < scan_end) && (ret == Z_KEYEXPR_CANON_SUCCESS);
              c = _z_cptr_char_offset(c, 1)) {
             switch (c[0]) {
                 case '#':
@@ -194,7 +223,9 @@ zp_keyexpr_canon_status_t __zp_canon_prefix(const char *start, size_t *len) {
 void __zp_singleify(char *start, size_t *len, const char *needle) {
     const char *end = _z_cptr_char_offset(start, *len);
     _Bool right_after_needle = false;
-    char *reader = start;
+    // Nothing is to be done before the first character of the needle, most key expressions do not even contain it
+    char const *first = _z_bstrchr((_z_str_se_t){.start = start, .end = end}, needle[0]);
+    char *reader = (first != NULL) ? &start[first - start] : &start[end - start];
 
     while (reader < end) {
         size_t pos = _z_str_startswith(reader, needle);
@@ -238,7 +269,8 @@ void __zp_ke_write_chunk(char **writer, const char *chunk, size_t len, const cha
         writer[0] = _z_ptr_char_offset(writer[0], 1);
     }
 
-    (void)memcpy(writer[0], chunk, len);
+    // The chunks are moved within the key expression being canonized
+    (void)memmove(writer[0], chunk, len);
     writer[0] = _z_ptr_char_offset(writer[0], len);
 }
 
@@ -251,6 +283,27 @@ int8_t _zp_ke_wildness(_z_str_se_t ke, size_t *n_segments) {
     const char *end = ke.end;
     int8_t result = 0;
     char prev_char = 0;
+#ifdef _Z_SIMD_WIDTH
+    while ((start < end) && ((size_t)(end - start) >= (size_t)_Z_SIMD_WIDTH)) {
+        _z_simd_t block = _z_simd_load(start);
+        uint64_t stars = _z_simd_match(block, '*');
+        if (stars != (uint64_t)0) {
+            result = result | (int8_t)_ZP_WILDNESS_ANY;
+            // A "**" within the block, or across the previous one
+            if ((_z_simd_pairs(stars) != (uint64_t)0) ||
+                ((prev_char == '*') && ((stars & (uint64_t)1) != (uint64_t)0))) {
+                result = result | (int8_t)_ZP_WILDNESS_SUPERCHUNKS;
+            }
+        }
+        if (_z_simd_match(block, '$') != (uint64_t)0) {
+            result = result | (int8_t)_ZP_WILDNESS_SUBCHUNK_DSL;
+        }
+        *n_segments = *n_segments + _z_simd_count(_z_simd_match(block, '/'));
+        // Only a star matters in the previous character
+        prev_char = (_z_simd_is_last_set(stars) == true) ? '*' : (char)0;
+        start = &start[_Z_SIMD_WIDTH];
+    }
+#endif
     for (char const *c = start; c < end; c = _z_cptr_char_offset(c, 1)) {
         switch (c[0]) {
             case '*': {
@@ -292,7 +345,7 @@ _Bool _z_ke_chunk_includes_nodsl(_z_str_se_t l, _z_str_se_t r) {
     _Bool result = ((llen == (size_t)1) && (l.start[0] == '*') &&
                     (((_z_ptr_char_diff(r.end, r.start) == 2) && (r.start[0] == '*') && (r.start[1] == '*')) == false));
     if ((result == false) && (llen == _z_ptr_char_diff(r.end, r.start))) {
-        result = strncmp(l.start, r.start, llen) == 0;
+        result = memcmp(l.start, r.start, llen) == 0;
     }
 
     return result;
@@ -343,7 +396,7 @@ _Bool _z_ke_chunk_intersect_nodsl(_z_str_se_t l, _z_str_se_t r) {
     _Bool result = ((l.start[0] == '*') || (r.start[0] == '*'));
     if (result == false) {
         size_t lclen = _z_ptr_char_diff(l.end, l.start);
-        result = ((lclen == _z_ptr_char_diff(r.end, r.start)) && (strncmp(l.start, r.start, lclen) == 0));
+        result = ((lclen == _z_ptr_char_diff(r.end, r.start)) && (memcmp(l.start, r.start, lclen) == 0));
     }
 
     return result;
@@ -498,14 +551,15 @@ _Bool _z_ke_intersect_rhassuperchunks(_z_str_se_t l, _z_str_se_t r, _z_ke_chunk_
 
 /*------------------ Zenoh-Core helpers ------------------*/
 _Bool _z_keyexpr_includes(const char *lstart, const size_t llen, const char *rstart, const size_t rlen) {
-    _Bool result = ((llen == rlen) && (strncmp(lstart, rstart, llen) == 0));
+    _Bool result = ((llen == rlen) && (memcmp(lstart, rstart, llen) == 0));
     if (result == false) {
         _z_str_se_t l = {.start = lstart, .end = _z_cptr_char_offset(lstart, llen)};
         _z_str_se_t r = {.start = rstart, .end = _z_cptr_char_offset(rstart, rlen)};
         size_t ln_chunks = (size_t)0;
         size_t rn_chunks = (size_t)0;
         int8_t lwildness = _zp_ke_wildness(l, &ln_chunks);
-        int8_t rwildness = _zp_ke_wildness(r, &rn_chunks);
+        // A verbatim key expression only includes itself, r does not even need to be scanned
+        int8_t rwildness = (lwildness != (int8_t)0) ? _zp_ke_wildness(r, &rn_chunks) : (int8_t)0;
         int8_t wildness = lwildness | rwildness;
         _z_ke_chunk_matcher chunk_intersector =
             ((wildness & (int8_t)_ZP_WILDNESS_SUBCHUNK_DSL) == (int8_t)_ZP_WILDNESS_SUBCHUNK_DSL)
@@ -581,7 +635,8 @@ _Bool _z_keyexpr_includes(const char *lstart, const size_t llen, const char *rst
                     h = _z_splitstr_next(&haystack);
                 }
             }
-        } else if (((rwildness & (int8_t)_ZP_WILDNESS_SUPERCHUNKS) == 0) && (ln_chunks == rn_chunks)) {
+        } else if ((lwildness != (int8_t)0) && ((rwildness & (int8_t)_ZP_WILDNESS_SUPERCHUNKS) == 0) &&
+                   (ln_chunks == rn_chunks)) {
             _z_splitstr_t lchunks = {.s = l, .delimiter = _Z_DELIMITER};
             _z_splitstr_t rchunks = {.s = r, .delimiter = _Z_DELIMITER};
             _z_str_se_t lchunk = _z_splitstr_next(&lchunks);
@@ -593,8 +648,8 @@ _Bool _z_keyexpr_includes(const char *lstart, const size_t llen, const char *rst
                 rchunk = _z_splitstr_next(&rchunks);
             }
         } else {
-            // If l doesn't have superchunks, but r does, or they have different chunk counts, non-inclusion is
-            // guaranteed
+            // If l is verbatim, or doesn't have superchunks but r does, or they have different chunk counts,
+            // non-inclusion is guaranteed
         }
     }
 
@@ -602,7 +657,7 @@ _Bool _z_keyexpr_includes(const char *lstart, const size_t llen, const char *rst
 }
 
 _Bool _z_keyexpr_intersects(const char *lstart, const size_t llen, const char *rstart, const size_t rlen) {
-    _Bool result = ((llen == rlen) && (strncmp(lstart, rstart, llen) == 0));
+    _Bool result = ((llen == rlen) && (memcmp(lstart, rstart, llen) == 0));
     if (result == false) {
         _z_str_se_t l = {.start = lstart, .end = _z_cptr_char_offset(lstart, llen)};
         _z_str_se_t r = {.start = rstart, .end = _z_cptr_char_offset(rstart, rlen)};
@@ -697,7 +752,7 @@ zp_keyexpr_canon_status_t _z_keyexpr_canonize(char *start, size_t *len) {
         char *reader = _z_ptr_char_offset(start, canon_len);
         const char *write_start = reader;
         char *writer = reader;
-        char *next_slash = strchr(reader, '/');
+        char *next_slash = __zp_ke_next_slash(reader, end);
         char const *chunk_end = (next_slash != NULL) ? next_slash : end;
 
         _Bool in_big_wild = false;
@@ -716,7 +771,7 @@ zp_keyexpr_canon_status_t _z_keyexpr_canonize(char *start, size_t *len) {
 
         while (next_slash != NULL) {
             reader = _z_ptr_char_offset(next_slash, 1);
-            next_slash = strchr(reader, '/');
+            next_slash = __zp_ke_next_slash(reader, end);
             chunk_end = next_slash ? next_slash : end;
             switch (_z_ptr_char_diff(chunk_end, reader)) {
                 case 0: {
@@ -749,7 +804,10 @@ zp_keyexpr_canon_status_t _z_keyexpr_canonize(char *start, size_t *len) {
             }
 
             unsigned char in_dollar = 0;
-            for (char const *c = reader; (c < end) && (ret == Z_KEYEXPR_CANON_SUCCESS); c = _z_cptr_char_offset(c, 1)) {
+            // A verbatim chunk is valid as is, the following chunks are checked on their own
+            const char *scan_end = (__zp_ke_chunk_has_specials(reader, chunk_end) == true) ? chunk_end : reader;
+            for (char const *c = reader; (c < scan_end) && (ret == Z_KEYEXPR_CANON_SUCCESS);
+                 c = _z_cptr_char_offset(c, 1)) {
                 switch (*c) {
                     case '#':
                     case '?': {
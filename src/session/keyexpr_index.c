@@ -0,0 +1,180 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/session/keyexpr_index.h"
+
+#include <string.h>
+
+#include "zenoh-pico/collections/string.h"
+#include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/utils/result.h"
+
+static void __z_keyexpr_index_rehash(_z_keyexpr_index_t *idx, size_t capacity) {
+    _z_keyexpr_index_entry_t **buckets =
+        (_z_keyexpr_index_entry_t **)zp_malloc(capacity * sizeof(_z_keyexpr_index_entry_t *));
+    if (buckets != NULL) {
+        (void)memset(buckets, 0, capacity * sizeof(_z_keyexpr_index_entry_t *));
+        // Move the entries to the new buckets, no reallocation of the entries is needed
+        for (size_t i = 0; (idx->_buckets != NULL) && (i < idx->_capacity); i++) {
+            _z_keyexpr_index_entry_t *e = idx->_buckets[i];
+            while (e != NULL) {
+                _z_keyexpr_index_entry_t *next = e->_next;
+                size_t b = e->_hash % capacity;
+                e->_next = buckets[b];
+                buckets[b] = e;
+                e = next;
+            }
+        }
+        zp_free(idx->_buckets);
+        idx->_buckets = buckets;
+        idx->_capacity = capacity;
+    }
+}
+
+void _z_keyexpr_index_init(_z_keyexpr_index_t *idx) {
+    idx->_buckets = NULL;
+    idx->_wild = NULL;
+    idx->_capacity = 0;
+    idx->_len = 0;
+}
+
+_Bool _z_keyexpr_is_wild(const char *key, size_t len) {
+    // Both `*`, `**` and `$*` contain a star
+    return memchr(key, '*', len) != NULL;
+}
+
+int8_t _z_keyexpr_index_insert(_z_keyexpr_index_t *idx, const char *key, void *val) {
+    _z_keyexpr_index_entry_t *e = (_z_keyexpr_index_entry_t *)zp_malloc(sizeof(_z_keyexpr_index_entry_t));
+    if (e == NULL) {
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    e->_key = key;
+    e->_len = strlen(key);
+    e->_hash = _z_str_hash(key, e->_len);
+    e->_val = val;
+
+    if (_z_keyexpr_is_wild(key, e->_len) == true) {
+        e->_next = idx->_wild;
+        idx->_wild = e;
+    } else {
+        if (idx->_buckets == NULL) {
+            __z_keyexpr_index_rehash(idx, _Z_KEYEXPR_INDEX_DEFAULT_CAPACITY);
+        } else if (idx->_len >= idx->_capacity) {
+            // Keep the load factor below 1, the index is left untouched if the allocation fails
+            __z_keyexpr_index_rehash(idx, idx->_capacity * (size_t)2);
+        }
+        if (idx->_buckets == NULL) {
+            zp_free(e);
+            return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+        }
+        size_t b = e->_hash % idx->_capacity;
+        e->_next = idx->_buckets[b];
+        idx->_buckets[b] = e;
+        idx->_len = idx->_len + (size_t)1;
+    }
+
+    return _Z_RES_OK;
+}
+
+void _z_keyexpr_index_remove(_z_keyexpr_index_t *idx, const char *key, const void *val) {
+    size_t len = strlen(key);
+    _Bool is_wild = _z_keyexpr_is_wild(key, len);
+    _z_keyexpr_index_entry_t **prev = NULL;
+    if (is_wild == true) {
+        prev = &idx->_wild;
+    } else if (idx->_buckets != NULL) {
+        prev = &idx->_buckets[_z_str_hash(key, len) % idx->_capacity];
+    } else {
+        // The key has never been indexed
+    }
+
+    while ((prev != NULL) && (*prev != NULL)) {
+        _z_keyexpr_index_entry_t *e = *prev;
+        if (e->_val == val) {
+            *prev = e->_next;
+            zp_free(e);
+            if (is_wild == false) {
+                idx->_len = idx->_len - (size_t)1;
+            }
+            break;
+        }
+        prev = &e->_next;
+    }
+}
+
+size_t _z_keyexpr_index_match(const _z_keyexpr_index_t *idx, const char *key, size_t len,
+                              _z_keyexpr_index_visit_f visit, void *arg) {
+    size_t n = 0;
+    _Bool keep_going = true;
+
+    if (_z_keyexpr_is_wild(key, len) == false) {
+        // Non-wild keys only intersect with equal keys, a single bucket needs to be checked
+        if (idx->_buckets != NULL) {
+            size_t hash = _z_str_hash(key, len);
+            _z_keyexpr_index_entry_t *e = idx->_buckets[hash % idx->_capacity];
+            while ((keep_going == true) && (e != NULL)) {
+                if ((e->_hash == hash) && (e->_len == len) && (memcmp(e->_key, key, len) == 0)) {
+                    n = n + (size_t)1;
+                    keep_going = visit(e->_val, arg);
+                }
+                e = e->_next;
+            }
+        }
+    } else {
+        // Wild keys may intersect with any non-wild key
+        for (size_t i = 0; (keep_going == true) && (idx->_buckets != NULL) && (i < idx->_capacity); i++) {
+            _z_keyexpr_index_entry_t *e = idx->_buckets[i];
+            while ((keep_going == true) && (e != NULL)) {
+                if (_z_keyexpr_intersects(e->_key, e->_len, key, len) == true) {
+                    n = n + (size_t)1;
+                    keep_going = visit(e->_val, arg);
+                }
+                e = e->_next;
+            }
+        }
+    }
+
+    _z_keyexpr_index_entry_t *e = idx->_wild;
+    while ((keep_going == true) && (e != NULL)) {
+        if (_z_keyexpr_intersects(e->_key, e->_len, key, len) == true) {
+            n = n + (size_t)1;
+            keep_going = visit(e->_val, arg);
+        }
+        e = e->_next;
+    }
+
+    return n;
+}
+
+void _z_keyexpr_index_clear(_z_keyexpr_index_t *idx) {
+    for (size_t i = 0; (idx->_buckets != NULL) && (i < idx->_capacity); i++) {
+        _z_keyexpr_index_entry_t *e = idx->_buckets[i];
+        while (e != NULL) {
+            _z_keyexpr_index_entry_t *next = e->_next;
+            zp_free(e);
+            e = next;
+        }
+    }
+    zp_free(idx->_buckets);
+
+    _z_keyexpr_index_entry_t *e = idx->_wild;
+    while (e != NULL) {
+        _z_keyexpr_index_entry_t *next = e->_next;
+        zp_free(e);
+        e = next;
+    }
+
+    _z_keyexpr_index_init(idx);
+}
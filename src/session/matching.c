@@ -0,0 +1,341 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/session/matching.h"
+
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+#include "zenoh-pico/config.h"
+#include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/session.h"
+#include "zenoh-pico/utils/logging.h"
+
+#if Z_FEATURE_MATCHING == 1
+_Bool _z_matching_eq(const _z_matching_t *other, const _z_matching_t *this) { return this->_id == other->_id; }
+
+void _z_matching_clear(_z_matching_t *matching) {
+    if (matching->_dropper != NULL) {
+        matching->_dropper(matching->_arg);
+    }
+    _z_keyexpr_clear(&matching->_key);
+}
+
+static _Bool __z_matching_any(void *val, void *arg) {
+    _ZP_UNUSED(val);
+    _ZP_UNUSED(arg);
+    return false;  // Stop at the first match
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ */
+static _Bool __unsafe_z_is_matching(_z_session_t *zn, const char *key) {
+    return _z_keyexpr_index_match(&zn->_remote_subscriptions_index, key, strlen(key), __z_matching_any, NULL) >
+           (size_t)0;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ */
+static _z_subscription_sptr_t *__unsafe_z_get_remote_subscription(_z_session_t *zn, uint16_t mapping, uint32_t id) {
+    _z_subscription_sptr_t *ret = NULL;
+
+    _z_subscription_sptr_list_t *xs = zn->_remote_subscriptions;
+    while (xs != NULL) {
+        _z_subscription_sptr_t *sub = _z_subscription_sptr_list_head(xs);
+        if ((sub->ptr->_id == id) && (_z_keyexpr_mapping_id(&sub->ptr->_key) == mapping)) {
+            ret = sub;
+            break;
+        }
+
+        xs = _z_subscription_sptr_list_tail(xs);
+    }
+
+    return ret;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ *
+ * Invalidates the matching status cached by the publishers and returns the matching listeners whose status changed,
+ * to be notified with :c:func:`__z_notify_matching` once the mutex is released.
+ */
+static _z_matching_sptr_list_t *__unsafe_z_update_matching(_z_session_t *zn) {
+    _z_matching_sptr_list_t *changed = NULL;
+    zn->_matching_gen = zn->_matching_gen + (size_t)1;
+
+    _z_matching_sptr_list_t *xs = zn->_matching_listeners;
+    while (xs != NULL) {
+        _z_matching_sptr_t *m = _z_matching_sptr_list_head(xs);
+        _Bool matching = __unsafe_z_is_matching(zn, m->ptr->_key._suffix);
+        if (matching != m->ptr->_matching) {
+            m->ptr->_matching = matching;
+            changed = _z_matching_sptr_list_push(changed, _z_matching_sptr_clone_as_ptr(m));
+        }
+
+        xs = _z_matching_sptr_list_tail(xs);
+    }
+
+    return changed;
+}
+
+static void __z_notify_matching(_z_matching_sptr_list_t *changed) {
+    _z_matching_sptr_list_t *xs = changed;
+    while (xs != NULL) {
+        _z_matching_sptr_t *m = _z_matching_sptr_list_head(xs);
+        _z_matching_status_t status = {.matching = m->ptr->_matching};
+        m->ptr->_callback(&status, m->ptr->_arg);
+
+        xs = _z_matching_sptr_list_tail(xs);
+    }
+    _z_matching_sptr_list_free(&changed);
+}
+
+/*------------------ Remote subscriptions ------------------*/
+int8_t _z_register_remote_subscription(_z_session_t *zn, uint16_t mapping, const _z_decl_subscriber_t *decl) {
+    int8_t ret = _Z_RES_OK;
+    _z_matching_sptr_list_t *changed = NULL;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (__unsafe_z_get_remote_subscription(zn, mapping, decl->_id) == NULL) {  // Declarations may be repeated
+        _z_subscription_t s;
+        (void)memset(&s, 0, sizeof(_z_subscription_t));
+        s._id = decl->_id;
+        s._key = __unsafe_z_get_expanded_key_from_key(zn, &decl->_keyexpr);
+        s._info.reliability = (decl->_ext_subinfo._reliable == true) ? Z_RELIABILITY_RELIABLE : Z_RELIABILITY_BEST_EFFORT;
+        s._info.mode = (decl->_ext_subinfo._pull_mode == true) ? Z_SUBMODE_PULL : Z_SUBMODE_PUSH;
+        if (s._key._suffix != NULL) {
+            _Z_DEBUG(">>> Allocating remote sub decl for (%ju:%s) on mapping 0x%x", (uintmax_t)s._id, s._key._suffix,
+                     mapping);
+            // The mapping identifies the declaring peer, the subscription id is only unique per peer
+            _z_keyexpr_set_mapping(&s._key, mapping);
+            _z_subscription_sptr_t *sub = (_z_subscription_sptr_t *)zp_malloc(sizeof(_z_subscription_sptr_t));
+            if (sub != NULL) {
+                *sub = _z_subscription_sptr_new(s);
+                if (sub->ptr == NULL) {
+                    _z_keyexpr_clear(&s._key);
+                    zp_free(sub);
+                    ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+                } else if (_z_keyexpr_index_insert(&zn->_remote_subscriptions_index, sub->ptr->_key._suffix, sub) ==
+                           _Z_RES_OK) {
+                    zn->_remote_subscriptions = _z_subscription_sptr_list_push(zn->_remote_subscriptions, sub);
+                    changed = __unsafe_z_update_matching(zn);
+                } else {
+                    _z_subscription_sptr_drop(sub);
+                    zp_free(sub);
+                    ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+                }
+            } else {
+                _z_keyexpr_clear(&s._key);
+                ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+            }
+        } else {
+            ret = _Z_ERR_KEYEXPR_UNKNOWN;
+        }
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    __z_notify_matching(changed);
+
+    return ret;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ */
+static void __unsafe_z_unregister_remote_subscription(_z_session_t *zn, _z_subscription_sptr_t *sub) {
+    _z_keyexpr_index_remove(&zn->_remote_subscriptions_index, sub->ptr->_key._suffix, sub);
+    zn->_remote_subscriptions =
+        _z_subscription_sptr_list_drop_filter(zn->_remote_subscriptions, _z_subscription_sptr_eq, sub);
+}
+
+void _z_unregister_remote_subscription(_z_session_t *zn, uint16_t mapping, uint32_t id) {
+    _z_matching_sptr_list_t *changed = NULL;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    _z_subscription_sptr_t *sub = __unsafe_z_get_remote_subscription(zn, mapping, id);
+    if (sub != NULL) {
+        __unsafe_z_unregister_remote_subscription(zn, sub);
+        changed = __unsafe_z_update_matching(zn);
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    __z_notify_matching(changed);
+}
+
+void _z_unregister_remote_subscriptions_for_peer(_z_session_t *zn, uint16_t mapping) {
+    _z_matching_sptr_list_t *changed = NULL;
+    _Bool removed = false;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    _z_subscription_sptr_list_t *xs = zn->_remote_subscriptions;
+    while (xs != NULL) {
+        _z_subscription_sptr_t *sub = _z_subscription_sptr_list_head(xs);
+        xs = _z_subscription_sptr_list_tail(xs);  // Move forward before the entry is dropped
+        if (_z_keyexpr_mapping_id(&sub->ptr->_key) == mapping) {
+            __unsafe_z_unregister_remote_subscription(zn, sub);
+            removed = true;
+        }
+    }
+    if (removed == true) {
+        changed = __unsafe_z_update_matching(zn);
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    __z_notify_matching(changed);
+}
+
+/*------------------ Matching ------------------*/
+_Bool _z_publisher_is_matching(_z_publisher_t *pub) {
+    _z_session_t *zn = pub->_zn;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (pub->_matching_gen != zn->_matching_gen) {  // The remote subscriptions changed since the last check
+        _z_keyexpr_t key = __unsafe_z_get_expanded_key_from_key(zn, &pub->_key);
+        if (key._suffix != NULL) {
+            pub->_matching = __unsafe_z_is_matching(zn, key._suffix);
+            pub->_matching_gen = zn->_matching_gen;
+            _z_keyexpr_clear(&key);
+        } else {
+            pub->_matching = true;  // Do not suppress writes for keys that cannot be resolved
+        }
+    }
+    _Bool ret = pub->_matching;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    return ret;
+}
+
+_z_matching_sptr_t *_z_get_matching_by_id(_z_session_t *zn, const _z_zint_t id) {
+    _z_matching_sptr_t *ret = NULL;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    _z_matching_sptr_list_t *xs = zn->_matching_listeners;
+    while (xs != NULL) {
+        _z_matching_sptr_t *m = _z_matching_sptr_list_head(xs);
+        if (m->ptr->_id == id) {
+            ret = m;
+            break;
+        }
+
+        xs = _z_matching_sptr_list_tail(xs);
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    return ret;
+}
+
+_z_matching_sptr_t *_z_register_matching(_z_session_t *zn, _z_matching_t *m) {
+    _Z_DEBUG(">>> Allocating matching listener for (%ju:%s)", (uintmax_t)m->_key._id, m->_key._suffix);
+    _z_matching_sptr_t *ret = NULL;
+    _z_matching_sptr_list_t *changed = NULL;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (m->_key._suffix != NULL) {
+        ret = (_z_matching_sptr_t *)zp_malloc(sizeof(_z_matching_sptr_t));
+        if (ret != NULL) {
+            *ret = _z_matching_sptr_new(*m);
+            if (ret->ptr != NULL) {
+                ret->ptr->_matching = __unsafe_z_is_matching(zn, ret->ptr->_key._suffix);
+                zn->_matching_listeners = _z_matching_sptr_list_push(zn->_matching_listeners, ret);
+                if (ret->ptr->_matching == true) {  // Report the subscribers that are already known
+                    changed = _z_matching_sptr_list_push(changed, _z_matching_sptr_clone_as_ptr(ret));
+                }
+            } else {
+                zp_free(ret);
+                ret = NULL;
+            }
+        }
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    __z_notify_matching(changed);
+
+    return ret;
+}
+
+void _z_unregister_matching(_z_session_t *zn, _z_matching_sptr_t *m) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    zn->_matching_listeners = _z_matching_sptr_list_drop_filter(zn->_matching_listeners, _z_matching_sptr_eq, m);
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+void _z_flush_matching(_z_session_t *zn) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    _z_matching_sptr_list_free(&zn->_matching_listeners);
+    _z_keyexpr_index_clear(&zn->_remote_subscriptions_index);
+    _z_subscription_sptr_list_free(&zn->_remote_subscriptions);
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+#endif  // Z_FEATURE_MATCHING == 1
@@ -21,7 +21,7 @@
 #include "zenoh-pico/session/subscription.h"
 #include "zenoh-pico/utils/logging.h"
 
-int8_t _z_trigger_push(_z_session_t *zn, _z_n_msg_push_t *push) {
+int8_t _z_trigger_push(_z_session_t *zn, _z_n_msg_push_t *push, _z_rx_batch_t *batch) {
     int8_t ret = _Z_RES_OK;
 
     // TODO check body to know where to dispatch
@@ -29,7 +29,9 @@ int8_t _z_trigger_push(_z_session_t *zn, _z_n_msg_push_t *push) {
     _z_encoding_t encoding = push->_body._is_put ? push->_body._body._put._encoding : z_encoding_default();
     int kind = push->_body._is_put ? Z_SAMPLE_KIND_PUT : Z_SAMPLE_KIND_DELETE;
 #if Z_FEATURE_SUBSCRIPTION == 1
-    ret = _z_trigger_subscriptions(zn, push->_key, payload, encoding, kind, push->_timestamp);
+    ret = _z_trigger_subscriptions(zn, push->_key, payload, encoding, kind, push->_timestamp, batch);
+#else
+    _ZP_UNUSED(batch);
 #endif
     return ret;
 }
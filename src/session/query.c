@@ -15,7 +15,9 @@
 #include "zenoh-pico/session/query.h"
 
 #include <stddef.h>
+#include <string.h>
 
+#include "zenoh-pico/api/constants.h"
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/net/memory.h"
 #include "zenoh-pico/protocol/keyexpr.h"
@@ -72,34 +74,212 @@ void _z_pending_query_clear(_z_pending_query_t *pen_qry) {
 
 _Bool _z_pending_query_eq(const _z_pending_query_t *one, const _z_pending_query_t *two) { return one->_id == two->_id; }
 
-/*------------------ Query ------------------*/
-_z_zint_t _z_get_query_id(_z_session_t *zn) { return zn->_query_id++; }
+/*------------------ Pending query table ------------------*/
+static inline size_t __z_pending_query_slot_index(_z_zint_t id, size_t capacity) {
+    return (size_t)id & (capacity - (size_t)1);  // Query ids are sequential, they are spread evenly as they are
+}
+
+static void __z_pending_query_slots_put(_z_pending_query_t **slots, size_t capacity, _z_pending_query_t *pen_qry) {
+    size_t i = __z_pending_query_slot_index(pen_qry->_id, capacity);
+    while (slots[i] != NULL) {
+        i = (i + (size_t)1) & (capacity - (size_t)1);
+    }
+    slots[i] = pen_qry;
+}
+
+static int8_t __z_pending_query_table_resize(_z_pending_query_table_t *table, size_t capacity) {
+    _z_pending_query_t **by_id = (_z_pending_query_t **)zp_malloc(capacity * sizeof(_z_pending_query_t *));
+    if (by_id == NULL) {
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    (void)memset(by_id, 0, capacity * sizeof(_z_pending_query_t *));
+
+    for (size_t i = 0; i < table->_capacity; i++) {
+        if (table->_by_id[i] != NULL) {
+            __z_pending_query_slots_put(by_id, capacity, table->_by_id[i]);
+        }
+    }
+
+    zp_free(table->_by_id);
+    table->_by_id = by_id;
+    table->_capacity = capacity;
+    return _Z_RES_OK;
+}
+
+void _z_pending_query_table_init(_z_pending_query_table_t *table) {
+    table->_by_id = NULL;
+    table->_capacity = 0;
+    table->_len = 0;
+    table->_timeouts = NULL;
+    table->_timeouts_len = 0;
+    table->_timeouts_capacity = 0;
+}
+
+void _z_pending_query_table_clear(_z_pending_query_table_t *table) {
+    for (size_t i = 0; i < table->_capacity; i++) {
+        if (table->_by_id[i] != NULL) {
+            _z_pending_query_clear(table->_by_id[i]);
+            zp_free(table->_by_id[i]);
+        }
+    }
+    zp_free(table->_by_id);
+    zp_free(table->_timeouts);
+    _z_pending_query_table_init(table);
+}
+
+static _z_pending_query_t *__z_pending_query_table_get(const _z_pending_query_table_t *table, _z_zint_t id) {
+    if (table->_len == (size_t)0) {
+        return NULL;
+    }
+    size_t i = __z_pending_query_slot_index(id, table->_capacity);
+    while (table->_by_id[i] != NULL) {
+        if (table->_by_id[i]->_id == id) {
+            return table->_by_id[i];
+        }
+        i = (i + (size_t)1) & (table->_capacity - (size_t)1);
+    }
+    return NULL;
+}
+
+static int8_t __z_pending_query_table_insert(_z_pending_query_table_t *table, _z_pending_query_t *pen_qry) {
+    // Keep the load factor below 3/4
+    if (((table->_len + (size_t)1) * (size_t)4) > (table->_capacity * (size_t)3)) {
+        size_t capacity = (table->_capacity == (size_t)0) ? (size_t)_Z_PENDING_QUERY_TABLE_DEFAULT_CAPACITY
+                                                          : table->_capacity * (size_t)2;
+        int8_t ret = __z_pending_query_table_resize(table, capacity);
+        if (ret != _Z_RES_OK) {
+            return ret;
+        }
+    }
+
+    __z_pending_query_slots_put(table->_by_id, table->_capacity, pen_qry);
+    table->_len = table->_len + (size_t)1;
+    return _Z_RES_OK;
+}
+
+/*------------------ Pending query timeouts ------------------*/
+static inline _Bool __z_deadline_before(unsigned long a, unsigned long b) {
+    return (long)(a - b) < 0;  // Robust to the wrap-around of the clock
+}
 
-_z_pending_query_t *__z_get_pending_query_by_id(_z_pending_query_list_t *pqls, const _z_zint_t id) {
-    _z_pending_query_t *ret = NULL;
+static void __z_pending_query_timeouts_set(_z_pending_query_table_t *table, size_t i, _z_pending_query_t *pen_qry) {
+    table->_timeouts[i] = pen_qry;
+    pen_qry->_timeout_idx = i;
+}
 
-    _z_pending_query_list_t *xs = pqls;
-    while (xs != NULL) {
-        _z_pending_query_t *pql = _z_pending_query_list_head(xs);
-        if (pql->_id == id) {
-            ret = pql;
+static void __z_pending_query_timeouts_sift_up(_z_pending_query_table_t *table, size_t i) {
+    _z_pending_query_t *pen_qry = table->_timeouts[i];
+    while (i > (size_t)0) {
+        size_t parent = (i - (size_t)1) / (size_t)2;
+        if (__z_deadline_before(pen_qry->_deadline, table->_timeouts[parent]->_deadline) == false) {
             break;
         }
+        __z_pending_query_timeouts_set(table, i, table->_timeouts[parent]);
+        i = parent;
+    }
+    __z_pending_query_timeouts_set(table, i, pen_qry);
+}
 
-        xs = _z_pending_query_list_tail(xs);
+static void __z_pending_query_timeouts_sift_down(_z_pending_query_table_t *table, size_t i) {
+    _z_pending_query_t *pen_qry = table->_timeouts[i];
+    while (true) {
+        size_t child = (i * (size_t)2) + (size_t)1;
+        if (child >= table->_timeouts_len) {
+            break;
+        }
+        if (((child + (size_t)1) < table->_timeouts_len) &&
+            (__z_deadline_before(table->_timeouts[child + (size_t)1]->_deadline, table->_timeouts[child]->_deadline) ==
+             true)) {
+            child = child + (size_t)1;
+        }
+        if (__z_deadline_before(table->_timeouts[child]->_deadline, pen_qry->_deadline) == false) {
+            break;
+        }
+        __z_pending_query_timeouts_set(table, i, table->_timeouts[child]);
+        i = child;
     }
+    __z_pending_query_timeouts_set(table, i, pen_qry);
+}
 
-    return ret;
+static int8_t __z_pending_query_timeouts_push(_z_pending_query_table_t *table, _z_pending_query_t *pen_qry) {
+    if (table->_timeouts_len == table->_timeouts_capacity) {
+        size_t capacity = (table->_timeouts_capacity == (size_t)0) ? (size_t)_Z_PENDING_QUERY_TABLE_DEFAULT_CAPACITY
+                                                                   : table->_timeouts_capacity * (size_t)2;
+        _z_pending_query_t **timeouts =
+            (_z_pending_query_t **)zp_malloc(capacity * sizeof(_z_pending_query_t *));
+        if (timeouts == NULL) {
+            return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+        }
+        if (table->_timeouts_len > (size_t)0) {
+            (void)memcpy(timeouts, table->_timeouts, table->_timeouts_len * sizeof(_z_pending_query_t *));
+        }
+        zp_free(table->_timeouts);
+        table->_timeouts = timeouts;
+        table->_timeouts_capacity = capacity;
+    }
+
+    __z_pending_query_timeouts_set(table, table->_timeouts_len, pen_qry);
+    table->_timeouts_len = table->_timeouts_len + (size_t)1;
+    __z_pending_query_timeouts_sift_up(table, pen_qry->_timeout_idx);
+    return _Z_RES_OK;
 }
 
+static void __z_pending_query_timeouts_remove(_z_pending_query_table_t *table, _z_pending_query_t *pen_qry) {
+    size_t i = pen_qry->_timeout_idx;
+    if (i == _Z_PENDING_QUERY_NO_TIMEOUT) {
+        return;
+    }
+    pen_qry->_timeout_idx = _Z_PENDING_QUERY_NO_TIMEOUT;
+
+    // Move the last query in the hole and restore the heap property
+    table->_timeouts_len = table->_timeouts_len - (size_t)1;
+    if (i < table->_timeouts_len) {
+        __z_pending_query_timeouts_set(table, i, table->_timeouts[table->_timeouts_len]);
+        __z_pending_query_timeouts_sift_up(table, i);
+        __z_pending_query_timeouts_sift_down(table, table->_timeouts[i]->_timeout_idx);
+    }
+}
+
+static void __z_pending_query_table_remove(_z_pending_query_table_t *table, _z_pending_query_t *pen_qry) {
+    size_t mask = table->_capacity - (size_t)1;
+    size_t i = __z_pending_query_slot_index(pen_qry->_id, table->_capacity);
+    while ((table->_by_id[i] != NULL) && (table->_by_id[i] != pen_qry)) {
+        i = (i + (size_t)1) & mask;
+    }
+    if (table->_by_id[i] == NULL) {
+        return;
+    }
+
+    // Shift back the following entries of the cluster to keep the probing sequences unbroken
+    size_t j = i;
+    while (true) {
+        j = (j + (size_t)1) & mask;
+        if (table->_by_id[j] == NULL) {
+            break;
+        }
+        size_t k = __z_pending_query_slot_index(table->_by_id[j]->_id, table->_capacity);
+        _Bool in_place = (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j));
+        if (in_place == false) {
+            table->_by_id[i] = table->_by_id[j];
+            i = j;
+        }
+    }
+    table->_by_id[i] = NULL;
+    table->_len = table->_len - (size_t)1;
+
+    __z_pending_query_timeouts_remove(table, pen_qry);
+}
+
+/*------------------ Query ------------------*/
+_z_zint_t _z_get_query_id(_z_session_t *zn) { return zn->_query_id++; }
+
 /**
  * This function is unsafe because it operates in potentially concurrent data.
  * Make sure that the following mutexes are locked before calling this function:
  *  - zn->_mutex_inner
  */
 _z_pending_query_t *__unsafe__z_get_pending_query_by_id(_z_session_t *zn, const _z_zint_t id) {
-    _z_pending_query_list_t *pqls = zn->_pending_queries;
-    return __z_get_pending_query_by_id(pqls, id);
+    return __z_pending_query_table_get(&zn->_pending_queries, id);
 }
 
 _z_pending_query_t *_z_get_pending_query_by_id(_z_session_t *zn, const _z_zint_t id) {
@@ -115,7 +295,7 @@ _z_pending_query_t *_z_get_pending_query_by_id(_z_session_t *zn, const _z_zint_t
     return pql;
 }
 
-int8_t _z_register_pending_query(_z_session_t *zn, _z_pending_query_t *pen_qry) {
+int8_t _z_register_pending_query(_z_session_t *zn, _z_pending_query_t *pen_qry, uint32_t timeout_ms) {
     int8_t ret = _Z_RES_OK;
 
     _Z_DEBUG(">>> Allocating query for (%ju:%s,%s)", (uintmax_t)pen_qry->_key._id, pen_qry->_key._suffix,
@@ -127,7 +307,16 @@ int8_t _z_register_pending_query(_z_session_t *zn, _z_pending_query_t *pen_qry)
 
     _z_pending_query_t *pql = __unsafe__z_get_pending_query_by_id(zn, pen_qry->_id);
     if (pql == NULL) {  // Register query only if a pending one with the same ID does not exist
-        zn->_pending_queries = _z_pending_query_list_push(zn->_pending_queries, pen_qry);
+        pen_qry->_in_callback = false;
+        pen_qry->_timeout_idx = _Z_PENDING_QUERY_NO_TIMEOUT;
+        ret = __z_pending_query_table_insert(&zn->_pending_queries, pen_qry);
+        if ((ret == _Z_RES_OK) && (timeout_ms > (uint32_t)0)) {
+            pen_qry->_deadline = zp_clock_elapsed_ms(&zn->_query_clock) + (unsigned long)timeout_ms;
+            ret = __z_pending_query_timeouts_push(&zn->_pending_queries, pen_qry);
+            if (ret != _Z_RES_OK) {
+                __z_pending_query_table_remove(&zn->_pending_queries, pen_qry);
+            }
+        }
     } else {
         ret = _Z_ERR_ENTITY_DECLARATION_FAILED;
     }
@@ -170,6 +359,7 @@ int8_t _z_trigger_query_reply_partial(_z_session_t *zn, const _z_zint_t id, cons
     _z_bytes_copy(&reply.data.sample.encoding.suffix, &encoding.suffix);
     reply.data.sample.kind = kind;
     reply.data.sample.timestamp = _z_timestamp_duplicate(&timestamp);
+    reply.data.sample._batch = NULL;
 
     // Verify if this is a newer reply, free the old one in case it is
     if ((ret == _Z_RES_OK) && ((pen_qry->_consolidation == Z_CONSOLIDATION_MODE_LATEST) ||
@@ -216,13 +406,26 @@ int8_t _z_trigger_query_reply_partial(_z_session_t *zn, const _z_zint_t id, cons
         }
     }
 
+    _Bool trigger = (ret == _Z_RES_OK) && (pen_qry->_consolidation != Z_CONSOLIDATION_MODE_LATEST);
+    if (trigger == true) {
+        pen_qry->_in_callback = true;  // The query cannot expire while its callback runs
+    }
+
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     // Trigger the user callback
-    if ((ret == _Z_RES_OK) && (pen_qry->_consolidation != Z_CONSOLIDATION_MODE_LATEST)) {
+    if (trigger == true) {
         pen_qry->_callback(_z_reply_alloc_and_move(&reply), pen_qry->_call_arg);
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+        pen_qry->_in_callback = false;
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
     }
 
     if (ret != _Z_RES_OK) {
@@ -257,14 +460,19 @@ int8_t _z_trigger_query_reply_final(_z_session_t *zn, _z_zint_t id) {
     }
 
     if (ret == _Z_RES_OK) {
-        // Dropping a pending query triggers the dropper callback that is now the equivalent to a reply with the FINAL
-        zn->_pending_queries = _z_pending_query_list_drop_filter(zn->_pending_queries, _z_pending_query_eq, pen_qry);
+        __z_pending_query_table_remove(&zn->_pending_queries, pen_qry);
     }
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+    if (ret == _Z_RES_OK) {
+        // Dropping a pending query triggers the dropper callback that is now the equivalent to a reply with the FINAL
+        _z_pending_query_clear(pen_qry);
+        zp_free(pen_qry);
+    }
+
     return ret;
 }
 
@@ -273,11 +481,108 @@ void _z_unregister_pending_query(_z_session_t *zn, _z_pending_query_t *pen_qry)
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    zn->_pending_queries = _z_pending_query_list_drop_filter(zn->_pending_queries, _z_pending_query_eq, pen_qry);
+    _Bool found = __unsafe__z_get_pending_query_by_id(zn, pen_qry->_id) == pen_qry;
+    if (found == true) {
+        __z_pending_query_table_remove(&zn->_pending_queries, pen_qry);
+    }
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (found == true) {
+        _z_pending_query_clear(pen_qry);
+        zp_free(pen_qry);
+    }
+}
+
+static void __z_trigger_query_timeout(_z_session_t *zn, _z_pending_query_t *pen_qry) {
+    _Z_INFO("Query %ju on %s timed out", (uintmax_t)pen_qry->_id, pen_qry->_key._suffix);
+
+    // Deliver the replies held for consolidation, they are the latest ones received before the expiry
+    while (pen_qry->_pending_replies != NULL) {
+        _z_pending_reply_t *pen_rep = _z_pending_reply_list_head(pen_qry->_pending_replies);
+        if (pen_qry->_consolidation == Z_CONSOLIDATION_MODE_LATEST) {
+            pen_qry->_callback(_z_reply_alloc_and_move(&pen_rep->_reply), pen_qry->_call_arg);
+        }
+        pen_qry->_pending_replies = _z_pending_reply_list_pop(pen_qry->_pending_replies, NULL);
+    }
+
+    // Notify the timeout as an error reply
+    _z_reply_t reply;
+    (void)memset(&reply, 0, sizeof(_z_reply_t));
+    reply._tag = Z_REPLY_TAG_ERROR;
+    reply.data.replier_id = zn->_local_zid;
+    reply.data.sample.keyexpr = _z_keyexpr_duplicate(pen_qry->_key);
+    reply.data.sample.payload = _z_bytes_wrap((const uint8_t *)"Timeout", (size_t)7);
+    reply.data.sample.encoding.prefix = Z_ENCODING_PREFIX_TEXT_PLAIN;
+    reply.data.sample.kind = Z_SAMPLE_KIND_PUT;
+    pen_qry->_callback(_z_reply_alloc_and_move(&reply), pen_qry->_call_arg);
+
+    // Dropping the pending query triggers the dropper callback, as a FINAL reply would
+    _z_pending_query_clear(pen_qry);
+    zp_free(pen_qry);
+}
+
+void _z_process_query_timeouts(_z_session_t *zn) {
+    // Expired queries are popped one at a time, the user callbacks are triggered out of the session mutex
+    for (;;) {
+        _z_pending_query_t *pen_qry = NULL;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+        _z_pending_query_table_t *table = &zn->_pending_queries;
+        if (table->_timeouts_len > (size_t)0) {
+            _z_pending_query_t *top = table->_timeouts[0];
+            unsigned long now = zp_clock_elapsed_ms(&zn->_query_clock);
+            // A query whose callback is running is postponed, so that it does not hold back the later expiries
+            while ((__z_deadline_before(now, top->_deadline) == false) && (top->_in_callback == true)) {
+                top->_deadline = now + (unsigned long)1;
+                __z_pending_query_timeouts_sift_down(table, 0);
+                top = table->_timeouts[0];
+            }
+            if (__z_deadline_before(now, top->_deadline) == false) {
+                __z_pending_query_table_remove(table, top);
+                pen_qry = top;
+            }
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+        if (pen_qry == NULL) {
+            break;
+        }
+        __z_trigger_query_timeout(zn, pen_qry);
+    }
+}
+
+_z_zint_t _z_get_next_query_timeout(_z_session_t *zn, _z_zint_t interval) {
+    _z_zint_t ret = interval;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    _z_pending_query_table_t *table = &zn->_pending_queries;
+    if (table->_timeouts_len > (size_t)0) {
+        unsigned long now = zp_clock_elapsed_ms(&zn->_query_clock);
+        unsigned long deadline = table->_timeouts[0]->_deadline;
+        // Never return 0, an expired query is processed on the next wake up
+        _z_zint_t left = (__z_deadline_before(now, deadline) == true) ? (_z_zint_t)(deadline - now) : (_z_zint_t)1;
+        if (left < ret) {
+            ret = left;
+        }
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    return ret;
 }
 
 void _z_flush_pending_queries(_z_session_t *zn) {
@@ -285,7 +590,7 @@ void _z_flush_pending_queries(_z_session_t *zn) {
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    _z_pending_query_list_free(&zn->_pending_queries);
+    _z_pending_query_table_clear(&zn->_pending_queries);
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&zn->_mutex_inner);
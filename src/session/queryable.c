@@ -52,21 +52,59 @@ _z_questionable_sptr_t *__z_get_questionable_by_id(_z_questionable_sptr_list_t *
     return ret;
 }
 
-_z_questionable_sptr_list_t *__z_get_questionable_by_key(_z_questionable_sptr_list_t *qles, const _z_keyexpr_t key) {
-    _z_questionable_sptr_list_t *ret = NULL;
+typedef struct {
+    _z_questionable_sptr_t *_vals;
+    _z_questionable_sptr_t *_inline;
+    size_t _len;
+    size_t _capacity;
+} __z_questionable_matches_t;
+
+static void __z_questionable_matches_init(__z_questionable_matches_t *m, _z_questionable_sptr_t *vals,
+                                          size_t capacity) {
+    m->_vals = vals;
+    m->_inline = vals;
+    m->_len = 0;
+    m->_capacity = capacity;
+}
 
-    _z_questionable_sptr_list_t *xs = qles;
-    while (xs != NULL) {
-        _z_questionable_sptr_t *qle = _z_questionable_sptr_list_head(xs);
-        if (_z_keyexpr_intersects(qle->ptr->_key._suffix, strlen(qle->ptr->_key._suffix), key._suffix,
-                                  strlen(key._suffix)) == true) {
-            ret = _z_questionable_sptr_list_push(ret, _z_questionable_sptr_clone_as_ptr(qle));
-        }
+static void __z_questionable_matches_clear(__z_questionable_matches_t *m) {
+    for (size_t i = 0; i < m->_len; i++) {
+        _z_questionable_sptr_drop(&m->_vals[i]);
+    }
+    if (m->_vals != m->_inline) {
+        zp_free(m->_vals);
+    }
+    __z_questionable_matches_init(m, m->_inline, 0);
+}
 
-        xs = _z_questionable_sptr_list_tail(xs);
+static _Bool __z_questionable_matches_push(void *val, void *arg) {
+    __z_questionable_matches_t *m = (__z_questionable_matches_t *)arg;
+    if (m->_len == m->_capacity) {
+        // Only spill on the heap when the inline storage is exhausted
+        size_t capacity = (m->_capacity == 0) ? (size_t)_Z_KEYEXPR_INDEX_MATCH_INLINE_SIZE : m->_capacity * (size_t)2;
+        _z_questionable_sptr_t *vals = (_z_questionable_sptr_t *)zp_malloc(capacity * sizeof(_z_questionable_sptr_t));
+        if (vals == NULL) {
+            _Z_ERROR("Failed to allocate the matching queryables");
+            return false;
+        }
+        if (m->_len > 0) {
+            (void)memcpy(vals, m->_vals, m->_len * sizeof(_z_questionable_sptr_t));
+        }
+        if (m->_vals != m->_inline) {
+            zp_free(m->_vals);
+        }
+        m->_vals = vals;
+        m->_capacity = capacity;
     }
+    m->_vals[m->_len] = _z_questionable_sptr_clone((_z_questionable_sptr_t *)val);
+    m->_len = m->_len + (size_t)1;
+    return true;
+}
 
-    return ret;
+static _Bool __z_questionable_list_push(void *val, void *arg) {
+    _z_questionable_sptr_list_t **ret = (_z_questionable_sptr_list_t **)arg;
+    *ret = _z_questionable_sptr_list_push(*ret, _z_questionable_sptr_clone_as_ptr((_z_questionable_sptr_t *)val));
+    return true;
 }
 
 /**
@@ -85,8 +123,10 @@ _z_questionable_sptr_t *__unsafe_z_get_questionable_by_id(_z_session_t *zn, cons
  *  - zn->_mutex_inner
  */
 _z_questionable_sptr_list_t *__unsafe_z_get_questionable_by_key(_z_session_t *zn, const _z_keyexpr_t key) {
-    _z_questionable_sptr_list_t *qles = zn->_local_questionable;
-    return __z_get_questionable_by_key(qles, key);
+    _z_questionable_sptr_list_t *ret = NULL;
+    (void)_z_keyexpr_index_match(&zn->_local_questionable_index, key._suffix, strlen(key._suffix),
+                                 __z_questionable_list_push, &ret);
+    return ret;
 }
 
 _z_questionable_sptr_t *_z_get_questionable_by_id(_z_session_t *zn, const _z_zint_t id) {
@@ -108,8 +148,12 @@ _z_questionable_sptr_list_t *_z_get_questionable_by_key(_z_session_t *zn, const
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+    _z_questionable_sptr_list_t *qles = NULL;
     _z_keyexpr_t key = __unsafe_z_get_expanded_key_from_key(zn, keyexpr);
-    _z_questionable_sptr_list_t *qles = __unsafe_z_get_questionable_by_key(zn, key);
+    if (key._suffix != NULL) {
+        qles = __unsafe_z_get_questionable_by_key(zn, key);
+        _z_keyexpr_clear(&key);
+    }
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&zn->_mutex_inner);
@@ -129,7 +173,15 @@ _z_questionable_sptr_t *_z_register_questionable(_z_session_t *zn, _z_questionab
     ret = (_z_questionable_sptr_t *)zp_malloc(sizeof(_z_questionable_sptr_t));
     if (ret != NULL) {
         *ret = _z_questionable_sptr_new(*q);
-        zn->_local_questionable = _z_questionable_sptr_list_push(zn->_local_questionable, ret);
+        if ((ret->ptr->_key._suffix != NULL) &&
+            (_z_keyexpr_index_insert(&zn->_local_questionable_index, ret->ptr->_key._suffix, ret) == _Z_RES_OK)) {
+            zn->_local_questionable = _z_questionable_sptr_list_push(zn->_local_questionable, ret);
+        } else {
+            // The caller keeps the ownership of the queryable, only release the shared pointer storage
+            zp_free(ret->ptr);  // The counter is allocated together with the value
+            zp_free(ret);
+            ret = NULL;
+        }
     }
 
 #if Z_FEATURE_MULTI_THREAD == 1
@@ -139,16 +191,31 @@ _z_questionable_sptr_t *_z_register_questionable(_z_session_t *zn, _z_questionab
     return ret;
 }
 
-int8_t _z_trigger_queryables(_z_session_t *zn, const _z_msg_query_t *query, const _z_keyexpr_t q_key, uint32_t qid) {
+int8_t _z_trigger_queryables(_z_session_t *zn, const _z_msg_query_t *query, const _z_keyexpr_t q_key, uint32_t qid,
+                             uint16_t mapping) {
     int8_t ret = _Z_RES_OK;
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    _z_keyexpr_t key = __unsafe_z_get_expanded_key_from_key(zn, &q_key);
+    _z_keyexpr_sptr_t cached_key = {.ptr = NULL, ._cnt = NULL};
+    _z_keyexpr_t key;
+    _z_resource_t *res = __unsafe_z_get_cached_resource(zn, &q_key);
+    if (res != NULL) {
+        // The key refers to a declared resource, resolve it from the cache without building any string
+        cached_key = _z_keyexpr_sptr_clone(&res->_expanded);
+        key = _z_keyexpr_alias(*cached_key.ptr);
+    } else {
+        key = __unsafe_z_get_expanded_key_from_key(zn, &q_key);
+    }
     if (key._suffix != NULL) {
-        _z_questionable_sptr_list_t *qles = __unsafe_z_get_questionable_by_key(zn, key);
+        // Collect the matching queryables, the inline storage avoids any allocation in most cases
+        _z_questionable_sptr_t inline_qles[_Z_KEYEXPR_INDEX_MATCH_INLINE_SIZE];
+        __z_questionable_matches_t qles;
+        __z_questionable_matches_init(&qles, inline_qles, _Z_KEYEXPR_INDEX_MATCH_INLINE_SIZE);
+        (void)_z_keyexpr_index_match(&zn->_local_questionable_index, key._suffix, strlen(key._suffix),
+                                     __z_questionable_matches_push, &qles);
 
 #if Z_FEATURE_MULTI_THREAD == 1
         zp_mutex_unlock(&zn->_mutex_inner);
@@ -158,6 +225,7 @@ int8_t _z_trigger_queryables(_z_session_t *zn, const _z_msg_query_t *query, cons
         z_query_t q;
         q._zn = zn;
         q._request_id = qid;
+        q._mapping = mapping;
         q._key = key;
 #if defined(__STDC_NO_VLA__) || ((__STDC_VERSION__ < 201000L) && (defined(_WIN32) || defined(WIN32)))
         char *params = zp_malloc(query->_parameters.len + 1);
@@ -170,15 +238,16 @@ int8_t _z_trigger_queryables(_z_session_t *zn, const _z_msg_query_t *query, cons
         q._value.encoding = query->_ext_value.encoding;
         q._value.payload = query->_ext_value.payload;
         q._anyke = (strstr(q._parameters, Z_SELECTOR_QUERY_MATCH) == NULL) ? false : true;
-        _z_questionable_sptr_list_t *xs = qles;
-        while (xs != NULL) {
-            _z_questionable_sptr_t *qle = _z_questionable_sptr_list_head(xs);
+        for (size_t i = 0; i < qles._len; i++) {
+            _z_questionable_sptr_t *qle = &qles._vals[i];
             qle->ptr->_callback(&q, qle->ptr->_arg);
-            xs = _z_questionable_sptr_list_tail(xs);
         }
 
         _z_keyexpr_clear(&key);
-        _z_questionable_sptr_list_free(&qles);
+        __z_questionable_matches_clear(&qles);
+        if (cached_key._cnt != NULL) {
+            _z_keyexpr_sptr_drop(&cached_key);
+        }
 #if defined(__STDC_NO_VLA__) || ((__STDC_VERSION__ < 201000L) && (defined(_WIN32) || defined(WIN32)))
         zp_free(params);
 #endif
@@ -186,7 +255,7 @@ int8_t _z_trigger_queryables(_z_session_t *zn, const _z_msg_query_t *query, cons
         // Send the final reply
         // Create the final reply
         _z_zenoh_message_t z_msg = _z_n_msg_make_response_final(q._request_id);
-        if (_z_send_n_msg(zn, &z_msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) != _Z_RES_OK) {
+        if (_z_send_n_msg_to(zn, mapping, &z_msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) != _Z_RES_OK) {
             ret = _Z_ERR_TRANSPORT_TX_FAILED;
         }
         _z_msg_clear(&z_msg);
@@ -206,6 +275,11 @@ void _z_unregister_questionable(_z_session_t *zn, _z_questionable_sptr_t *qle) {
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+    _z_questionable_sptr_t *entry = __unsafe_z_get_questionable_by_id(zn, qle->ptr->_id);
+    if (entry != NULL) {
+        _z_keyexpr_index_remove(&zn->_local_questionable_index, entry->ptr->_key._suffix, entry);
+    }
+
     zn->_local_questionable =
         _z_questionable_sptr_list_drop_filter(zn->_local_questionable, _z_questionable_sptr_eq, qle);
 
@@ -219,6 +293,7 @@ void _z_flush_questionables(_z_session_t *zn) {
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+    _z_keyexpr_index_clear(&zn->_local_questionable_index);
     _z_questionable_sptr_list_free(&zn->_local_questionable);
 
 #if Z_FEATURE_MULTI_THREAD == 1
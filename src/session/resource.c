@@ -16,18 +16,41 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "zenoh-pico/api/types.h"
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/protocol/definitions/declarations.h"
+#include "zenoh-pico/protocol/definitions/network.h"
 #include "zenoh-pico/protocol/keyexpr.h"
 #include "zenoh-pico/session/session.h"
+#include "zenoh-pico/session/utils.h"
 #include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/transport/multicast/tx.h"
+#include "zenoh-pico/transport/raweth/tx.h"
 #include "zenoh-pico/utils/logging.h"
 
 _Bool _z_resource_eq(const _z_resource_t *other, const _z_resource_t *this) { return this->_id == other->_id; }
 
-void _z_resource_clear(_z_resource_t *res) { _z_keyexpr_clear(&res->_key); }
+void _z_resource_clear(_z_resource_t *res) {
+    _z_resource_clear_cache(res);
+    _z_keyexpr_clear(&res->_key);
+}
+
+void _z_resource_clear_cache(_z_resource_t *res) {
+    if (res->_expanded._cnt != NULL) {
+        _z_keyexpr_sptr_drop(&res->_expanded);
+    }
+    res->_expanded.ptr = NULL;
+    res->_expanded._cnt = NULL;
+#if Z_FEATURE_SUBSCRIPTION == 1
+    zp_free(res->_subs);
+    res->_subs = NULL;
+    res->_subs_len = 0;
+    res->_subs_cached = false;
+#endif
+}
 
 void _z_resource_free(_z_resource_t **res) {
     _z_resource_t *ptr = *res;
@@ -45,44 +68,173 @@ uint32_t _z_get_entity_id(_z_session_t *zn) { return zn->_entity_id++; }
 
 uint16_t _z_get_resource_id(_z_session_t *zn) { return zn->_resource_id++; }
 
-/*------------------ Resource ------------------*/
-_z_resource_t *__z_get_resource_by_id(_z_resource_list_t *rl, uint16_t mapping, const _z_zint_t id) {
-    _z_resource_t *ret = NULL;
-
-    _z_resource_list_t *xs = rl;
-    while (xs != NULL) {
-        _z_resource_t *r = _z_resource_list_head(xs);
-        if (r->_id == id && _z_keyexpr_mapping_id(&r->_key) == mapping) {
-            ret = r;
+/*------------------ Resource table ------------------*/
+static inline size_t __z_resource_id_hash(uint16_t mapping, uint16_t id) { return ((size_t)mapping << 16) | id; }
+
+static size_t __z_resource_key_hash(uint16_t mapping, uint16_t id, const char *suffix) {
+    size_t hash = (suffix != NULL) ? _z_str_hash(suffix, strlen(suffix)) : 0;
+    return hash ^ (__z_resource_id_hash(mapping, id) * (size_t)2654435761U);
+}
+
+static inline size_t __z_resource_slot_index(size_t hash, size_t capacity) {
+    return (hash ^ (hash >> 16)) & (capacity - (size_t)1);
+}
+
+static void __z_resource_slots_put(_z_resource_slot_t *slots, size_t capacity, size_t hash, _z_resource_t *res) {
+    size_t i = __z_resource_slot_index(hash, capacity);
+    while (slots[i]._res != NULL) {
+        i = (i + (size_t)1) & (capacity - (size_t)1);
+    }
+    slots[i]._hash = hash;
+    slots[i]._res = res;
+}
+
+static void __z_resource_slots_remove(_z_resource_slot_t *slots, size_t capacity, size_t hash,
+                                      const _z_resource_t *res) {
+    size_t mask = capacity - (size_t)1;
+    size_t i = __z_resource_slot_index(hash, capacity);
+    while ((slots[i]._res != NULL) && (slots[i]._res != res)) {
+        i = (i + (size_t)1) & mask;
+    }
+    if (slots[i]._res == NULL) {
+        return;
+    }
+
+    // Shift back the following entries of the cluster to keep the probing sequences unbroken
+    size_t j = i;
+    while (true) {
+        j = (j + (size_t)1) & mask;
+        if (slots[j]._res == NULL) {
             break;
         }
+        size_t k = __z_resource_slot_index(slots[j]._hash, capacity);
+        _Bool in_place = (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j));
+        if (in_place == false) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i]._hash = 0;
+    slots[i]._res = NULL;
+}
 
-        xs = _z_resource_list_tail(xs);
+static int8_t __z_resource_table_resize(_z_resource_table_t *table, size_t capacity) {
+    size_t len = capacity * sizeof(_z_resource_slot_t);
+    _z_resource_slot_t *by_id = (_z_resource_slot_t *)zp_malloc(len);
+    _z_resource_slot_t *by_key = (_z_resource_slot_t *)zp_malloc(len);
+    if ((by_id == NULL) || (by_key == NULL)) {
+        zp_free(by_id);
+        zp_free(by_key);
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
     }
+    (void)memset(by_id, 0, len);
+    (void)memset(by_key, 0, len);
 
-    return ret;
+    for (size_t i = 0; i < table->_capacity; i++) {
+        if (table->_by_id[i]._res != NULL) {
+            __z_resource_slots_put(by_id, capacity, table->_by_id[i]._hash, table->_by_id[i]._res);
+        }
+        if (table->_by_key[i]._res != NULL) {
+            __z_resource_slots_put(by_key, capacity, table->_by_key[i]._hash, table->_by_key[i]._res);
+        }
+    }
+
+    zp_free(table->_by_id);
+    zp_free(table->_by_key);
+    table->_by_id = by_id;
+    table->_by_key = by_key;
+    table->_capacity = capacity;
+    return _Z_RES_OK;
 }
 
-_z_resource_t *__z_get_resource_by_key(_z_resource_list_t *rl, const _z_keyexpr_t *keyexpr) {
-    _z_resource_t *ret = NULL;
-    uint16_t mapping = _z_keyexpr_mapping_id(keyexpr);
+void _z_resource_table_init(_z_resource_table_t *table) {
+    table->_by_id = NULL;
+    table->_by_key = NULL;
+    table->_capacity = 0;
+    table->_len = 0;
+}
+
+void _z_resource_table_clear(_z_resource_table_t *table) {
+    for (size_t i = 0; i < table->_capacity; i++) {
+        _z_resource_free(&table->_by_id[i]._res);
+    }
+    zp_free(table->_by_id);
+    zp_free(table->_by_key);
+    _z_resource_table_init(table);
+}
+
+static _z_resource_t *__z_resource_table_get_by_id(const _z_resource_table_t *table, uint16_t mapping,
+                                                   _z_zint_t id) {
+    if ((table->_len == (size_t)0) || (id > (_z_zint_t)UINT16_MAX)) {
+        return NULL;
+    }
+    size_t hash = __z_resource_id_hash(mapping, (uint16_t)id);
+    size_t i = __z_resource_slot_index(hash, table->_capacity);
+    while (table->_by_id[i]._res != NULL) {
+        if (table->_by_id[i]._hash == hash) {
+            return table->_by_id[i]._res;
+        }
+        i = (i + (size_t)1) & (table->_capacity - (size_t)1);
+    }
+    return NULL;
+}
 
-    _z_resource_list_t *xs = rl;
-    while (xs != NULL) {
-        _z_resource_t *r = _z_resource_list_head(xs);
-        if ((r->_key._id == keyexpr->_id) && _z_keyexpr_mapping_id(&r->_key) == mapping &&
+static _z_resource_t *__z_resource_table_get_by_key(const _z_resource_table_t *table, const _z_keyexpr_t *keyexpr) {
+    if (table->_len == (size_t)0) {
+        return NULL;
+    }
+    uint16_t mapping = _z_keyexpr_mapping_id(keyexpr);
+    size_t hash = __z_resource_key_hash(mapping, keyexpr->_id, keyexpr->_suffix);
+    size_t i = __z_resource_slot_index(hash, table->_capacity);
+    while (table->_by_key[i]._res != NULL) {
+        _z_resource_t *r = table->_by_key[i]._res;
+        if ((table->_by_key[i]._hash == hash) && (r->_key._id == keyexpr->_id) &&
+            (_z_keyexpr_mapping_id(&r->_key) == mapping) && (keyexpr->_suffix != NULL) &&
             (_z_str_eq(r->_key._suffix, keyexpr->_suffix) == true)) {
-            ret = r;
-            break;
+            return r;
         }
+        i = (i + (size_t)1) & (table->_capacity - (size_t)1);
+    }
+    return NULL;
+}
+
+static void __z_resource_table_remove(_z_resource_table_t *table, const _z_resource_t *res) {
+    uint16_t mapping = _z_keyexpr_mapping_id(&res->_key);
+    __z_resource_slots_remove(table->_by_id, table->_capacity, __z_resource_id_hash(mapping, res->_id), res);
+    __z_resource_slots_remove(table->_by_key, table->_capacity,
+                              __z_resource_key_hash(mapping, res->_key._id, res->_key._suffix), res);
+    table->_len = table->_len - (size_t)1;
+}
 
-        xs = _z_resource_list_tail(xs);
+static int8_t __z_resource_table_insert(_z_resource_table_t *table, _z_resource_t *res) {
+    uint16_t mapping = _z_keyexpr_mapping_id(&res->_key);
+
+    // A redeclaration of the same id replaces the previous resource
+    _z_resource_t *old = __z_resource_table_get_by_id(table, mapping, res->_id);
+    if (old != NULL) {
+        __z_resource_table_remove(table, old);
+        _z_resource_free(&old);
     }
 
-    return ret;
+    // Keep the load factor below 3/4
+    if (((table->_len + (size_t)1) * (size_t)4) > (table->_capacity * (size_t)3)) {
+        size_t capacity = (table->_capacity == (size_t)0) ? (size_t)_Z_RESOURCE_TABLE_DEFAULT_CAPACITY
+                                                          : table->_capacity * (size_t)2;
+        int8_t ret = __z_resource_table_resize(table, capacity);
+        if (ret != _Z_RES_OK) {
+            return ret;
+        }
+    }
+
+    __z_resource_slots_put(table->_by_id, table->_capacity, __z_resource_id_hash(mapping, res->_id), res);
+    __z_resource_slots_put(table->_by_key, table->_capacity,
+                           __z_resource_key_hash(mapping, res->_key._id, res->_key._suffix), res);
+    table->_len = table->_len + (size_t)1;
+    return _Z_RES_OK;
 }
 
-_z_keyexpr_t __z_get_expanded_key_from_key(_z_resource_list_t *xs, const _z_keyexpr_t *keyexpr) {
+/*------------------ Resource ------------------*/
+_z_keyexpr_t __z_get_expanded_key_from_key(const _z_resource_table_t *table, const _z_keyexpr_t *keyexpr) {
     _z_keyexpr_t ret = {._id = Z_RESOURCE_ID_NONE, ._suffix = NULL, ._mapping = _z_keyexpr_mapping(0, true)};
 
     // Need to build the complete resource name, by recursively look at RIDs
@@ -102,7 +254,7 @@ _z_keyexpr_t __z_get_expanded_key_from_key(_z_resource_list_t *xs, const _z_keye
     _z_zint_t id = keyexpr->_id;
     uint16_t mapping = _z_keyexpr_mapping_id(keyexpr);
     while (id != Z_RESOURCE_ID_NONE) {
-        _z_resource_t *res = __z_get_resource_by_id(xs, mapping, id);
+        _z_resource_t *res = __z_resource_table_get_by_id(table, mapping, id);
         if (res == NULL) {
             len = 0;
             break;
@@ -149,8 +301,8 @@ _z_keyexpr_t __z_get_expanded_key_from_key(_z_resource_list_t *xs, const _z_keye
  *  - zn->_mutex_inner
  */
 _z_resource_t *__unsafe_z_get_resource_by_id(_z_session_t *zn, uint16_t mapping, _z_zint_t id) {
-    _z_resource_list_t *decls = (mapping == _Z_KEYEXPR_MAPPING_LOCAL) ? zn->_local_resources : zn->_remote_resources;
-    return __z_get_resource_by_id(decls, mapping, id);
+    _z_resource_table_t *decls = (mapping == _Z_KEYEXPR_MAPPING_LOCAL) ? &zn->_local_resources : &zn->_remote_resources;
+    return __z_resource_table_get_by_id(decls, mapping, id);
 }
 
 /**
@@ -159,8 +311,8 @@ _z_resource_t *__unsafe_z_get_resource_by_id(_z_session_t *zn, uint16_t mapping,
  *  - zn->_mutex_inner
  */
 _z_resource_t *__unsafe_z_get_resource_by_key(_z_session_t *zn, const _z_keyexpr_t *keyexpr) {
-    _z_resource_list_t *decls = _z_keyexpr_is_local(keyexpr) ? zn->_local_resources : zn->_remote_resources;
-    return __z_get_resource_by_key(decls, keyexpr);
+    _z_resource_table_t *decls = _z_keyexpr_is_local(keyexpr) ? &zn->_local_resources : &zn->_remote_resources;
+    return __z_resource_table_get_by_key(decls, keyexpr);
 }
 
 /**
@@ -169,10 +321,57 @@ _z_resource_t *__unsafe_z_get_resource_by_key(_z_session_t *zn, const _z_keyexpr
  *  - zn->_mutex_inner
  */
 _z_keyexpr_t __unsafe_z_get_expanded_key_from_key(_z_session_t *zn, const _z_keyexpr_t *keyexpr) {
-    _z_resource_list_t *decls = _z_keyexpr_is_local(keyexpr) ? zn->_local_resources : zn->_remote_resources;
+    _z_resource_table_t *decls = _z_keyexpr_is_local(keyexpr) ? &zn->_local_resources : &zn->_remote_resources;
     return __z_get_expanded_key_from_key(decls, keyexpr);
 }
 
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ */
+void __unsafe_z_clear_resources_cache(_z_session_t *zn) {
+    for (size_t i = 0; i < zn->_local_resources._capacity; i++) {
+        if (zn->_local_resources._by_id[i]._res != NULL) {
+            _z_resource_clear_cache(zn->_local_resources._by_id[i]._res);
+        }
+    }
+    for (size_t i = 0; i < zn->_remote_resources._capacity; i++) {
+        if (zn->_remote_resources._by_id[i]._res != NULL) {
+            _z_resource_clear_cache(zn->_remote_resources._by_id[i]._res);
+        }
+    }
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ *
+ * Returns the resource a key expression without suffix refers to, with its expanded key cached, or NULL if the
+ * key expression cannot be resolved through the cache.
+ */
+_z_resource_t *__unsafe_z_get_cached_resource(_z_session_t *zn, const _z_keyexpr_t *keyexpr) {
+    if ((keyexpr->_id == Z_RESOURCE_ID_NONE) || (_z_keyexpr_has_suffix(*keyexpr) == true)) {
+        return NULL;
+    }
+    _z_resource_t *res = __unsafe_z_get_resource_by_id(zn, _z_keyexpr_mapping_id(keyexpr), keyexpr->_id);
+    if ((res != NULL) && (res->_expanded.ptr == NULL)) {
+        _z_keyexpr_t key = __unsafe_z_get_expanded_key_from_key(zn, keyexpr);
+        if (key._suffix == NULL) {
+            return NULL;
+        }
+        res->_expanded = _z_keyexpr_sptr_new(key);
+        if ((res->_expanded.ptr == NULL) || (res->_expanded._cnt == NULL)) {
+            _z_keyexpr_clear(&key);
+            res->_expanded.ptr = NULL;
+            res->_expanded._cnt = NULL;
+            return NULL;
+        }
+    }
+    return res;
+}
+
 _z_resource_t *_z_get_resource_by_id(_z_session_t *zn, uint16_t mapping, _z_zint_t rid) {
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_lock(&zn->_mutex_inner);
@@ -217,6 +416,28 @@ _z_keyexpr_t _z_get_expanded_key_from_key(_z_session_t *zn, const _z_keyexpr_t *
     return res;
 }
 
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ *
+ * Returns true if the id is already declared in the mapping for the same key expression.
+ */
+static _Bool __unsafe_z_resource_is_declared(_z_session_t *zn, const _z_keyexpr_t *key, uint16_t id,
+                                             uint16_t mapping) {
+    _Bool ret = false;
+    _z_resource_t *res = __unsafe_z_get_resource_by_id(zn, mapping, id);
+    if (res != NULL) {
+        _z_keyexpr_t declared = __unsafe_z_get_expanded_key_from_key(zn, &res->_key);
+        _z_keyexpr_t expanded = __unsafe_z_get_expanded_key_from_key(zn, key);
+        ret = (declared._suffix != NULL) && (expanded._suffix != NULL) &&
+              (_z_str_eq(declared._suffix, expanded._suffix) == true);
+        _z_keyexpr_clear(&declared);
+        _z_keyexpr_clear(&expanded);
+    }
+    return ret;
+}
+
 /// Returns the ID of the registered keyexpr. Returns 0 if registration failed.
 int16_t _z_register_resource(_z_session_t *zn, _z_keyexpr_t key, uint16_t id, uint16_t register_to_mapping) {
     int16_t ret = Z_RESOURCE_ID_NONE;
@@ -228,29 +449,61 @@ int16_t _z_register_resource(_z_session_t *zn, _z_keyexpr_t key, uint16_t id, ui
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    if (key._id != Z_RESOURCE_ID_NONE) {
-        if (parent_mapping == mapping) {
-            _z_resource_t *parent = __unsafe_z_get_resource_by_id(zn, parent_mapping, key._id);
-            parent->_refcount++;
-        } else {
-            key = __unsafe_z_get_expanded_key_from_key(zn, &key);
+    if ((id != Z_RESOURCE_ID_NONE) && (__unsafe_z_resource_is_declared(zn, &key, id, mapping) == true)) {
+        // Multicast peers periodically repeat their declarations, leave the resource and the caches untouched
+        ret = (int16_t)id;
+    } else {
+        __unsafe_z_clear_resources_cache(zn);  // Declarations may change how keys are resolved
+
+        _Bool resolved = true;  // The parent may be unknown, e.g. if its declaration was lost
+        _z_resource_t *parent = NULL;
+        if (key._id != Z_RESOURCE_ID_NONE) {
+            if (parent_mapping == mapping) {
+                parent = __unsafe_z_get_resource_by_id(zn, parent_mapping, key._id);
+                resolved = (parent != NULL);
+            } else {
+                key = __unsafe_z_get_expanded_key_from_key(zn, &key);
+            }
         }
-    }
-    ret = key._id;
-    if ((key._suffix != NULL)) {
-        _z_resource_t *res = zp_malloc(sizeof(_z_resource_t));
-        if (res == NULL) {
+        ret = key._id;
+        if (resolved == false) {
             ret = Z_RESOURCE_ID_NONE;
+        } else if (key._suffix == NULL) {
+            // The key is the parent itself, which is referenced once more
+            if (parent != NULL) {
+                parent->_refcount++;
+            }
         } else {
-            res->_refcount = 1;
-            res->_key = _z_keyexpr_to_owned(key);
-            ret = id == Z_RESOURCE_ID_NONE ? _z_get_resource_id(zn) : id;
-            res->_id = ret;
-            // Register the resource
-            if (mapping == _Z_KEYEXPR_MAPPING_LOCAL) {
-                zn->_local_resources = _z_resource_list_push(zn->_local_resources, res);
+            _z_resource_t *res = zp_malloc(sizeof(_z_resource_t));
+            if (res == NULL) {
+                ret = Z_RESOURCE_ID_NONE;
             } else {
-                zn->_remote_resources = _z_resource_list_push(zn->_remote_resources, res);
+                res->_refcount = 1;
+                res->_announced = false;
+                res->_key = _z_keyexpr_to_owned(key);
+                res->_expanded.ptr = NULL;
+                res->_expanded._cnt = NULL;
+#if Z_FEATURE_SUBSCRIPTION == 1
+                res->_subs = NULL;
+                res->_subs_len = 0;
+                res->_subs_cached = false;
+#endif
+                ret = id == Z_RESOURCE_ID_NONE ? _z_get_resource_id(zn) : id;
+                res->_id = ret;
+                // Register the resource
+                _z_resource_table_t *decls =
+                    (mapping == _Z_KEYEXPR_MAPPING_LOCAL) ? &zn->_local_resources : &zn->_remote_resources;
+                if (__z_resource_table_insert(decls, res) != _Z_RES_OK) {
+                    _z_resource_free(&res);
+                    ret = Z_RESOURCE_ID_NONE;
+                } else if (parent != NULL) {
+                    // Only reference the parent once registered, it is looked up again as the insertion replaces
+                    // a previous declaration of the same id
+                    parent = __unsafe_z_get_resource_by_id(zn, parent_mapping, key._id);
+                    if ((parent != NULL) && (parent != res)) {
+                        parent->_refcount++;
+                    }
+                }
             }
         }
     }
@@ -268,25 +521,22 @@ void _z_unregister_resource(_z_session_t *zn, uint16_t id, uint16_t mapping) {
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
-    _z_resource_list_t **parent_mut = is_local ? &zn->_local_resources : &zn->_remote_resources;
+    __unsafe_z_clear_resources_cache(zn);  // Declarations may change how keys are resolved
+    _z_resource_table_t *decls = is_local ? &zn->_local_resources : &zn->_remote_resources;
     while (id != 0) {
-        _z_resource_list_t *parent = *parent_mut;
-        while (parent != NULL) {
-            _z_resource_t *head = _z_resource_list_head(parent);
-            if (head && head->_id == id && _z_keyexpr_mapping_id(&head->_key) == mapping) {
-                head->_refcount--;
-                if (head->_refcount == 0) {
-                    *parent_mut = _z_resource_list_pop(parent, &head);
-                    id = head->_key._id;
-                    mapping = _z_keyexpr_mapping_id(&head->_key);
-                    _z_resource_free(&head);
-                } else {
-                    id = 0;
-                }
-                break;
-            }
-            parent_mut = &parent->_tail;
-            parent = *parent_mut;
+        _z_resource_t *res = __z_resource_table_get_by_id(decls, mapping, id);
+        if (res == NULL) {
+            break;
+        }
+        res->_refcount--;
+        if (res->_refcount == 0) {
+            // Release the resource and its reference on the parent resource
+            __z_resource_table_remove(decls, res);
+            id = res->_key._id;
+            mapping = _z_keyexpr_mapping_id(&res->_key);
+            _z_resource_free(&res);
+        } else {
+            id = 0;
         }
     }
 #if Z_FEATURE_MULTI_THREAD == 1
@@ -294,30 +544,164 @@ void _z_unregister_resource(_z_session_t *zn, uint16_t id, uint16_t mapping) {
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 }
 
-_Bool _z_unregister_resource_for_peer_filter(const _z_resource_t *candidate, const _z_resource_t *ctx) {
-    uint16_t mapping = ctx->_id;
-    return _z_keyexpr_mapping_id(&candidate->_key) == mapping;
-}
 void _z_unregister_resources_for_peer(_z_session_t *zn, uint16_t mapping) {
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
-    _z_resource_t ctx = {._id = mapping, ._refcount = 0, ._key = {0}};
-    zn->_remote_resources =
-        _z_resource_list_drop_filter(zn->_remote_resources, _z_unregister_resource_for_peer_filter, &ctx);
+    __unsafe_z_clear_resources_cache(zn);  // Declarations may change how keys are resolved
+    _z_resource_table_t *decls = &zn->_remote_resources;
+    size_t i = 0;
+    while (i < decls->_capacity) {
+        _z_resource_t *res = decls->_by_id[i]._res;
+        if ((res != NULL) && (_z_keyexpr_mapping_id(&res->_key) == mapping)) {
+            // Removing shifts back the following entries into this slot, so check it again
+            __z_resource_table_remove(decls, res);
+            _z_resource_free(&res);
+        } else {
+            i = i + (size_t)1;
+        }
+    }
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 }
 
+// Whether some transports of the session are multicast ones, whose peers may not have learned the declarations yet
+static _Bool __z_session_has_multicast(_z_session_t *zn) {
+    _Bool ret = false;
+    for (size_t i = 0; (i < _z_session_transports_len(zn)) && (ret == false); i++) {
+        _z_transport_t *zt = _z_session_transport(zn, i);
+        ret = (zt->_type == _Z_TRANSPORT_MULTICAST_TYPE) || (zt->_type == _Z_TRANSPORT_RAWETH_TYPE);
+    }
+    return ret;
+}
+
+_z_keyexpr_t _z_get_wire_key_from_key(_z_session_t *zn, const _z_keyexpr_t *keyexpr) {
+    _z_keyexpr_t ret = _z_keyexpr_alias(*keyexpr);
+
+    if ((keyexpr->_id != Z_RESOURCE_ID_NONE) && (_z_keyexpr_mapping_id(keyexpr) == _Z_KEYEXPR_MAPPING_LOCAL) &&
+        (__z_session_has_multicast(zn) == true)) {
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+        _z_resource_t *res = __unsafe_z_get_resource_by_id(zn, _Z_KEYEXPR_MAPPING_LOCAL, keyexpr->_id);
+        if ((res != NULL) && (res->_announced == false)) {
+            _z_keyexpr_t expanded = __unsafe_z_get_expanded_key_from_key(zn, keyexpr);
+            if (expanded._suffix != NULL) {
+                ret = expanded;
+            }
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    }
+
+    return ret;
+}
+
+void _z_reset_resource_declarations(_z_session_t *zn) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    // The declarations being sent may not reach the new peer, they do not announce the resources anymore
+    zn->_resources_gen = zn->_resources_gen + (size_t)1;
+    for (size_t i = 0; i < zn->_local_resources._capacity; i++) {
+        _z_resource_t *res = zn->_local_resources._by_id[i]._res;
+        if (res != NULL) {
+            res->_announced = false;
+        }
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+}
+
+int8_t _z_send_resource_declarations(_z_session_t *zn, _z_transport_multicast_t *ztm) {
+    int8_t ret = _Z_RES_OK;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    // Build the declarations under the lock, they are sent once it is released
+    size_t gen = zn->_resources_gen;
+    size_t len = 0;
+    _z_network_message_t *n_msgs = NULL;
+    if (zn->_local_resources._len > (size_t)0) {
+        n_msgs = (_z_network_message_t *)zp_malloc(zn->_local_resources._len * sizeof(_z_network_message_t));
+        if (n_msgs != NULL) {
+            for (size_t i = 0; i < zn->_local_resources._capacity; i++) {
+                _z_resource_t *res = zn->_local_resources._by_id[i]._res;
+                if (res != NULL) {
+                    // Declare the expanded key, the receivers then do not depend on the order of the declarations
+                    _z_keyexpr_t key = __unsafe_z_get_expanded_key_from_key(zn, &res->_key);
+                    if (key._suffix != NULL) {
+                        n_msgs[len] = _z_n_msg_make_declare(_z_make_decl_keyexpr(res->_id, &key));
+                        len = len + (size_t)1;
+                    }
+                }
+            }
+        } else {
+            ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+        }
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (len > (size_t)0) {
+        if (ztm->_link._cap._transport == Z_LINK_CAP_TRANSPORT_RAWETH) {
+            // Raw ethernet frames are addressed according to their message, they are sent one by one
+            for (size_t i = 0; (i < len) && (ret == _Z_RES_OK); i++) {
+                ret = _z_raweth_send_n_msg(ztm, &n_msgs[i], Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK);
+            }
+        } else {
+            ret = _z_multicast_send_n_batch(ztm, n_msgs, len, Z_RELIABILITY_RELIABLE);
+        }
+    }
+
+    if (ret == _Z_RES_OK) {
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+        // The ids can be used on the wire, unless a peer joined while the declarations were sent
+        if (gen == zn->_resources_gen) {
+            for (size_t i = 0; i < len; i++) {
+                uint16_t id = n_msgs[i]._body._declare._decl._body._decl_kexpr._id;
+                _z_resource_t *res = __unsafe_z_get_resource_by_id(zn, _Z_KEYEXPR_MAPPING_LOCAL, id);
+                if (res != NULL) {
+                    res->_announced = true;
+                }
+            }
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&zn->_mutex_inner);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    }
+
+    for (size_t i = 0; i < len; i++) {
+        _z_n_msg_clear(&n_msgs[i]);
+    }
+    zp_free(n_msgs);
+
+    return ret;
+}
+
 void _z_flush_resources(_z_session_t *zn) {
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    _z_resource_list_free(&zn->_local_resources);
-    _z_resource_list_free(&zn->_remote_resources);
+    _z_resource_table_clear(&zn->_local_resources);
+    _z_resource_table_clear(&zn->_remote_resources);
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&zn->_mutex_inner);
@@ -24,6 +24,7 @@
 #include "zenoh-pico/protocol/definitions/message.h"
 #include "zenoh-pico/protocol/definitions/network.h"
 #include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/matching.h"
 #include "zenoh-pico/session/push.h"
 #include "zenoh-pico/session/queryable.h"
 #include "zenoh-pico/session/reply.h"
@@ -34,12 +35,14 @@
 #include "zenoh-pico/utils/logging.h"
 
 /*------------------ Handle message ------------------*/
-int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *msg, uint16_t local_peer_id) {
+int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *msg, uint16_t local_peer_id,
+                                 _z_rx_batch_t *batch) {
     int8_t ret = _Z_RES_OK;
 
     switch (msg->_tag) {
         case _Z_N_DECLARE: {
             _Z_DEBUG("Handling _Z_N_DECLARE");
+            _Z_STATS_INC(&zn->_stats, _Z_STATS_RX_DECLARES);
             _z_n_msg_declare_t decl = msg->_body._declare;
             switch (decl._decl._tag) {
                 case _Z_DECL_KEXPR: {
@@ -52,10 +55,19 @@ int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *msg, uint
                     _z_unregister_resource(zn, decl._decl._body._undecl_kexpr._id, local_peer_id);
                 } break;
                 case _Z_DECL_SUBSCRIBER: {
-                    // TODO: add support or explicitly discard
+#if Z_FEATURE_MATCHING == 1
+                    // A subscriber on an unknown key only disables write suppression for it, it is not an error
+                    if (_z_register_remote_subscription(zn, local_peer_id, &decl._decl._body._decl_subscriber) !=
+                        _Z_RES_OK) {
+                        _Z_DEBUG("Failed to register the remote subscriber %ju",
+                                 (uintmax_t)decl._decl._body._decl_subscriber._id);
+                    }
+#endif
                 } break;
                 case _Z_UNDECL_SUBSCRIBER: {
-                    // TODO: add support or explicitly discard
+#if Z_FEATURE_MATCHING == 1
+                    _z_unregister_remote_subscription(zn, local_peer_id, decl._decl._body._undecl_subscriber._id);
+#endif
                 } break;
                 case _Z_DECL_QUERYABLE: {
                     // TODO: add support or explicitly discard
@@ -82,17 +94,19 @@ int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *msg, uint
         } break;
         case _Z_N_PUSH: {
             _Z_DEBUG("Handling _Z_N_PUSH");
+            _Z_STATS_INC(&zn->_stats, _Z_STATS_RX_PUSHES);
             _z_n_msg_push_t *push = &msg->_body._push;
-            ret = _z_trigger_push(zn, push);
+            ret = _z_trigger_push(zn, push, batch);
         } break;
         case _Z_N_REQUEST: {
             _Z_DEBUG("Handling _Z_N_REQUEST");
+            _Z_STATS_INC(&zn->_stats, _Z_STATS_RX_REQUESTS);
             _z_n_msg_request_t req = msg->_body._request;
             switch (req._tag) {
                 case _Z_REQUEST_QUERY: {
 #if Z_FEATURE_QUERYABLE == 1
                     _z_msg_query_t *query = &req._body._query;
-                    ret = _z_trigger_queryables(zn, query, req._key, (uint32_t)req._rid);
+                    ret = _z_trigger_queryables(zn, query, req._key, (uint32_t)req._rid, local_peer_id);
 #else
                     _Z_DEBUG("_Z_REQUEST_QUERY dropped, queryables not supported");
 #endif
@@ -101,26 +115,30 @@ int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *msg, uint
                     _z_msg_put_t put = req._body._put;
 #if Z_FEATURE_SUBSCRIPTION == 1
                     ret = _z_trigger_subscriptions(zn, req._key, put._payload, put._encoding, Z_SAMPLE_KIND_PUT,
-                                                   put._commons._timestamp);
+                                                   put._commons._timestamp, batch);
 #endif
                     if (ret == _Z_RES_OK) {
                         _z_network_message_t ack = _z_n_msg_make_ack(req._rid, &req._key);
-                        ret = _z_send_n_msg(zn, &ack, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK);
+                        ret = _z_send_n_msg_to(zn, local_peer_id, &ack, Z_RELIABILITY_RELIABLE,
+                                               Z_CONGESTION_CONTROL_BLOCK);
                         _z_network_message_t final = _z_n_msg_make_response_final(req._rid);
-                        ret |= _z_send_n_msg(zn, &final, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK);
+                        ret |= _z_send_n_msg_to(zn, local_peer_id, &final, Z_RELIABILITY_RELIABLE,
+                                                Z_CONGESTION_CONTROL_BLOCK);
                     }
                 } break;
                 case _Z_REQUEST_DEL: {
                     _z_msg_del_t del = req._body._del;
 #if Z_FEATURE_SUBSCRIPTION == 1
                     ret = _z_trigger_subscriptions(zn, req._key, _z_bytes_empty(), z_encoding_default(),
-                                                   Z_SAMPLE_KIND_DELETE, del._commons._timestamp);
+                                                   Z_SAMPLE_KIND_DELETE, del._commons._timestamp, NULL);
 #endif
                     if (ret == _Z_RES_OK) {
                         _z_network_message_t ack = _z_n_msg_make_ack(req._rid, &req._key);
-                        ret = _z_send_n_msg(zn, &ack, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK);
+                        ret = _z_send_n_msg_to(zn, local_peer_id, &ack, Z_RELIABILITY_RELIABLE,
+                                               Z_CONGESTION_CONTROL_BLOCK);
                         _z_network_message_t final = _z_n_msg_make_response_final(req._rid);
-                        ret |= _z_send_n_msg(zn, &final, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK);
+                        ret |= _z_send_n_msg_to(zn, local_peer_id, &final, Z_RELIABILITY_RELIABLE,
+                                                Z_CONGESTION_CONTROL_BLOCK);
                     }
                 } break;
                 case _Z_REQUEST_PULL: {
@@ -130,6 +148,7 @@ int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *msg, uint
         } break;
         case _Z_N_RESPONSE: {
             _Z_DEBUG("Handling _Z_N_RESPONSE");
+            _Z_STATS_INC(&zn->_stats, _Z_STATS_RX_RESPONSES);
             _z_n_msg_response_t response = msg->_body._response;
             switch (response._tag) {
                 case _Z_RESPONSE_BODY_REPLY: {
@@ -150,23 +169,27 @@ int8_t _z_handle_network_message(_z_session_t *zn, _z_zenoh_message_t *msg, uint
                     _z_msg_put_t put = response._body._put;
 #if Z_FEATURE_SUBSCRIPTION == 1
                     ret = _z_trigger_subscriptions(zn, response._key, put._payload, put._encoding, Z_SAMPLE_KIND_PUT,
-                                                   put._commons._timestamp);
+                                                   put._commons._timestamp, batch);
 #endif
                 } break;
                 case _Z_RESPONSE_BODY_DEL: {
                     _z_msg_del_t del = response._body._del;
 #if Z_FEATURE_SUBSCRIPTION == 1
                     ret = _z_trigger_subscriptions(zn, response._key, _z_bytes_empty(), z_encoding_default(),
-                                                   Z_SAMPLE_KIND_DELETE, del._commons._timestamp);
+                                                   Z_SAMPLE_KIND_DELETE, del._commons._timestamp, NULL);
 #endif
                 } break;
             }
         } break;
         case _Z_N_RESPONSE_FINAL: {
             _Z_DEBUG("Handling _Z_N_RESPONSE_FINAL");
+            _Z_STATS_INC(&zn->_stats, _Z_STATS_RX_RESPONSE_FINALS);
             ret = _z_trigger_reply_final(zn, &msg->_body._response_final);
         } break;
     }
+    if (ret != _Z_RES_OK) {
+        _Z_STATS_INC(&zn->_stats, _Z_STATS_RX_ERRORS);
+    }
     _z_msg_clear(msg);
     return ret;
 }
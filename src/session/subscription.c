@@ -16,6 +16,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/core.h"
@@ -24,7 +25,7 @@
 #include "zenoh-pico/session/session.h"
 #include "zenoh-pico/utils/logging.h"
 
-#if Z_FEATURE_SUBSCRIPTION == 1
+#if Z_FEATURE_SUBSCRIPTION == 1 || Z_FEATURE_MATCHING == 1
 _Bool _z_subscription_eq(const _z_subscription_t *other, const _z_subscription_t *this) {
     return this->_id == other->_id;
 }
@@ -35,6 +36,9 @@ void _z_subscription_clear(_z_subscription_t *sub) {
     }
     _z_keyexpr_clear(&sub->_key);
 }
+#endif
+
+#if Z_FEATURE_SUBSCRIPTION == 1
 
 /*------------------ Pull ------------------*/
 _z_zint_t _z_get_pull_id(_z_session_t *zn) { return zn->_pull_id++; }
@@ -56,21 +60,103 @@ _z_subscription_sptr_t *__z_get_subscription_by_id(_z_subscription_sptr_list_t *
     return ret;
 }
 
-_z_subscription_sptr_list_t *__z_get_subscriptions_by_key(_z_subscription_sptr_list_t *subs, const _z_keyexpr_t key) {
-    _z_subscription_sptr_list_t *ret = NULL;
+typedef struct {
+    _z_subscription_sptr_t *_vals;
+    _z_subscription_sptr_t *_inline;
+    size_t _len;
+    size_t _capacity;
+} __z_subscription_matches_t;
+
+static void __z_subscription_matches_init(__z_subscription_matches_t *m, _z_subscription_sptr_t *vals,
+                                          size_t capacity) {
+    m->_vals = vals;
+    m->_inline = vals;
+    m->_len = 0;
+    m->_capacity = capacity;
+}
 
-    _z_subscription_sptr_list_t *xs = subs;
-    while (xs != NULL) {
-        _z_subscription_sptr_t *sub = _z_subscription_sptr_list_head(xs);
-        if (_z_keyexpr_intersects(sub->ptr->_key._suffix, strlen(sub->ptr->_key._suffix), key._suffix,
-                                  strlen(key._suffix)) == true) {
-            ret = _z_subscription_sptr_list_push(ret, _z_subscription_sptr_clone_as_ptr(sub));
+static void __z_subscription_matches_clear(__z_subscription_matches_t *m) {
+    for (size_t i = 0; i < m->_len; i++) {
+        _z_subscription_sptr_drop(&m->_vals[i]);
+    }
+    if (m->_vals != m->_inline) {
+        zp_free(m->_vals);
+    }
+    __z_subscription_matches_init(m, m->_inline, 0);
+}
+
+static _Bool __z_subscription_matches_push(void *val, void *arg) {
+    __z_subscription_matches_t *m = (__z_subscription_matches_t *)arg;
+    if (m->_len == m->_capacity) {
+        // Only spill on the heap when the inline storage is exhausted
+        size_t capacity = (m->_capacity == 0) ? (size_t)_Z_KEYEXPR_INDEX_MATCH_INLINE_SIZE : m->_capacity * (size_t)2;
+        _z_subscription_sptr_t *vals = (_z_subscription_sptr_t *)zp_malloc(capacity * sizeof(_z_subscription_sptr_t));
+        if (vals == NULL) {
+            _Z_ERROR("Failed to allocate the matching subscriptions");
+            return false;
+        }
+        if (m->_len > 0) {
+            (void)memcpy(vals, m->_vals, m->_len * sizeof(_z_subscription_sptr_t));
+        }
+        if (m->_vals != m->_inline) {
+            zp_free(m->_vals);
         }
+        m->_vals = vals;
+        m->_capacity = capacity;
+    }
+    m->_vals[m->_len] = _z_subscription_sptr_clone((_z_subscription_sptr_t *)val);
+    m->_len = m->_len + (size_t)1;
+    return true;
+}
 
-        xs = _z_subscription_sptr_list_tail(xs);
+static _Bool __z_subscription_list_push(void *val, void *arg) {
+    _z_subscription_sptr_list_t **ret = (_z_subscription_sptr_list_t **)arg;
+    *ret = _z_subscription_sptr_list_push(*ret, _z_subscription_sptr_clone_as_ptr((_z_subscription_sptr_t *)val));
+    return true;
+}
+
+static _Bool __z_subscription_any(void *val, void *arg) {
+    _ZP_UNUSED(val);
+    _ZP_UNUSED(arg);
+    return false;  // Stop at the first match
+}
+
+static _Bool __z_subscription_count(void *val, void *arg) {
+    _ZP_UNUSED(val);
+    _ZP_UNUSED(arg);
+    return true;
+}
+
+static _Bool __z_subscription_resource_push(void *val, void *arg) {
+    _z_resource_t *res = (_z_resource_t *)arg;
+    res->_subs[res->_subs_len] = (_z_subscription_sptr_t *)val;
+    res->_subs_len = res->_subs_len + (size_t)1;
+    return true;
+}
+
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - zn->_mutex_inner
+ */
+static _Bool __unsafe_z_cache_resource_subscriptions(_z_session_t *zn, _z_resource_t *res, const _z_keyexpr_t *key) {
+    size_t len = strlen(key->_suffix);
+    size_t n = _z_keyexpr_index_match(&zn->_local_subscriptions_index, key->_suffix, len, __z_subscription_count, NULL);
+    if (n > (size_t)0) {
+        res->_subs = (_z_subscription_sptr_t **)zp_malloc(n * sizeof(_z_subscription_sptr_t *));
+        if (res->_subs == NULL) {
+            return false;
+        }
+        res->_subs_len = 0;
+        (void)_z_keyexpr_index_match(&zn->_local_subscriptions_index, key->_suffix, len,
+                                     __z_subscription_resource_push, res);
     }
+    res->_subs_cached = true;
+    return true;
+}
 
-    return ret;
+static _z_keyexpr_index_t *__z_get_subscriptions_index(_z_session_t *zn, uint8_t is_local) {
+    return (is_local == _Z_RESOURCE_IS_LOCAL) ? &zn->_local_subscriptions_index : &zn->_remote_subscriptions_index;
 }
 
 /**
@@ -91,9 +177,10 @@ _z_subscription_sptr_t *__unsafe_z_get_subscription_by_id(_z_session_t *zn, uint
  */
 _z_subscription_sptr_list_t *__unsafe_z_get_subscriptions_by_key(_z_session_t *zn, uint8_t is_local,
                                                                  const _z_keyexpr_t key) {
-    _z_subscription_sptr_list_t *subs =
-        (is_local == _Z_RESOURCE_IS_LOCAL) ? zn->_local_subscriptions : zn->_remote_subscriptions;
-    return __z_get_subscriptions_by_key(subs, key);
+    _z_subscription_sptr_list_t *ret = NULL;
+    (void)_z_keyexpr_index_match(__z_get_subscriptions_index(zn, is_local), key._suffix, strlen(key._suffix),
+                                 __z_subscription_list_push, &ret);
+    return ret;
 }
 
 _z_subscription_sptr_t *_z_get_subscription_by_id(_z_session_t *zn, uint8_t is_local, const _z_zint_t id) {
@@ -132,15 +219,25 @@ _z_subscription_sptr_t *_z_register_subscription(_z_session_t *zn, uint8_t is_lo
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    _z_subscription_sptr_list_t *subs = __unsafe_z_get_subscriptions_by_key(zn, is_local, s->_key);
-    if (subs == NULL) {  // A subscription for this name does not yet exists
+    _z_keyexpr_index_t *idx = __z_get_subscriptions_index(zn, is_local);
+    if ((s->_key._suffix != NULL) &&
+        (_z_keyexpr_index_match(idx, s->_key._suffix, strlen(s->_key._suffix), __z_subscription_any, NULL) ==
+         (size_t)0)) {  // A subscription for this name does not yet exists
         ret = (_z_subscription_sptr_t *)zp_malloc(sizeof(_z_subscription_sptr_t));
         if (ret != NULL) {
             *ret = _z_subscription_sptr_new(*s);
-            if (is_local == _Z_RESOURCE_IS_LOCAL) {
-                zn->_local_subscriptions = _z_subscription_sptr_list_push(zn->_local_subscriptions, ret);
+            if (_z_keyexpr_index_insert(idx, ret->ptr->_key._suffix, ret) == _Z_RES_OK) {
+                __unsafe_z_clear_resources_cache(zn);  // The cached match sets are no longer valid
+                if (is_local == _Z_RESOURCE_IS_LOCAL) {
+                    zn->_local_subscriptions = _z_subscription_sptr_list_push(zn->_local_subscriptions, ret);
+                } else {
+                    zn->_remote_subscriptions = _z_subscription_sptr_list_push(zn->_remote_subscriptions, ret);
+                }
             } else {
-                zn->_remote_subscriptions = _z_subscription_sptr_list_push(zn->_remote_subscriptions, ret);
+                // The caller keeps the ownership of the subscription, only release the shared pointer storage
+                zp_free(ret->ptr);  // The counter is allocated together with the value
+                zp_free(ret);
+                ret = NULL;
             }
         }
     }
@@ -156,12 +253,13 @@ void _z_trigger_local_subscriptions(_z_session_t *zn, const _z_keyexpr_t keyexpr
                                     _z_zint_t payload_len) {
     _z_encoding_t encoding = {.prefix = Z_ENCODING_PREFIX_DEFAULT, .suffix = _z_bytes_wrap(NULL, 0)};
     int8_t ret = _z_trigger_subscriptions(zn, keyexpr, _z_bytes_wrap(payload, payload_len), encoding, Z_SAMPLE_KIND_PUT,
-                                          _z_timestamp_null());
+                                          _z_timestamp_null(), NULL);
     (void)ret;
 }
 
 int8_t _z_trigger_subscriptions(_z_session_t *zn, const _z_keyexpr_t keyexpr, const _z_bytes_t payload,
-                                const _z_encoding_t encoding, const _z_zint_t kind, const _z_timestamp_t timestamp) {
+                                const _z_encoding_t encoding, const _z_zint_t kind, const _z_timestamp_t timestamp,
+                                _z_rx_batch_t *batch) {
     int8_t ret = _Z_RES_OK;
 
 #if Z_FEATURE_MULTI_THREAD == 1
@@ -169,10 +267,33 @@ int8_t _z_trigger_subscriptions(_z_session_t *zn, const _z_keyexpr_t keyexpr, co
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     _Z_DEBUG("Resolving %d - %s on mapping 0x%x", keyexpr._id, keyexpr._suffix, _z_keyexpr_mapping_id(&keyexpr));
-    _z_keyexpr_t key = __unsafe_z_get_expanded_key_from_key(zn, &keyexpr);
+    _z_keyexpr_sptr_t cached_key = {.ptr = NULL, ._cnt = NULL};
+    _z_keyexpr_t key;
+    _z_resource_t *res = __unsafe_z_get_cached_resource(zn, &keyexpr);
+    if (res != NULL) {
+        // The key refers to a declared resource, resolve it from the cache without building any string
+        cached_key = _z_keyexpr_sptr_clone(&res->_expanded);
+        key = _z_keyexpr_alias(*cached_key.ptr);
+    } else {
+        key = __unsafe_z_get_expanded_key_from_key(zn, &keyexpr);
+    }
     _Z_DEBUG("Triggering subs for %d - %s", key._id, key._suffix);
     if (key._suffix != NULL) {
-        _z_subscription_sptr_list_t *subs = __unsafe_z_get_subscriptions_by_key(zn, _Z_RESOURCE_IS_LOCAL, key);
+        // Collect the matching subscriptions, the inline storage avoids any allocation in most cases
+        _z_subscription_sptr_t inline_subs[_Z_KEYEXPR_INDEX_MATCH_INLINE_SIZE];
+        __z_subscription_matches_t subs;
+        __z_subscription_matches_init(&subs, inline_subs, _Z_KEYEXPR_INDEX_MATCH_INLINE_SIZE);
+        if ((res != NULL) &&
+            ((res->_subs_cached == true) || (__unsafe_z_cache_resource_subscriptions(zn, res, &key) == true))) {
+            for (size_t i = 0; i < res->_subs_len; i++) {
+                if (__z_subscription_matches_push(res->_subs[i], &subs) == false) {
+                    break;
+                }
+            }
+        } else {
+            (void)_z_keyexpr_index_match(&zn->_local_subscriptions_index, key._suffix, strlen(key._suffix),
+                                         __z_subscription_matches_push, &subs);
+        }
 
 #if Z_FEATURE_MULTI_THREAD == 1
         zp_mutex_unlock(&zn->_mutex_inner);
@@ -185,16 +306,18 @@ int8_t _z_trigger_subscriptions(_z_session_t *zn, const _z_keyexpr_t keyexpr, co
         s.encoding = encoding;
         s.kind = kind;
         s.timestamp = timestamp;
-        _z_subscription_sptr_list_t *xs = subs;
-        _Z_DEBUG("Triggering %ju subs", (uintmax_t)_z_subscription_sptr_list_len(xs));
-        while (xs != NULL) {
-            _z_subscription_sptr_t *sub = _z_subscription_sptr_list_head(xs);
+        s._batch = batch;
+        _Z_DEBUG("Triggering %ju subs", (uintmax_t)subs._len);
+        for (size_t i = 0; i < subs._len; i++) {
+            _z_subscription_sptr_t *sub = &subs._vals[i];
             sub->ptr->_callback(&s, sub->ptr->_arg);
-            xs = _z_subscription_sptr_list_tail(xs);
         }
 
         _z_keyexpr_clear(&key);
-        _z_subscription_sptr_list_free(&subs);
+        __z_subscription_matches_clear(&subs);
+        if (cached_key._cnt != NULL) {
+            _z_keyexpr_sptr_drop(&cached_key);
+        }
     } else {
 #if Z_FEATURE_MULTI_THREAD == 1
         zp_mutex_unlock(&zn->_mutex_inner);
@@ -210,6 +333,12 @@ void _z_unregister_subscription(_z_session_t *zn, uint8_t is_local, _z_subscript
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+    _z_subscription_sptr_t *entry = __unsafe_z_get_subscription_by_id(zn, is_local, sub->ptr->_id);
+    if ((entry != NULL) && (entry->ptr->_key._suffix != NULL)) {
+        _z_keyexpr_index_remove(__z_get_subscriptions_index(zn, is_local), entry->ptr->_key._suffix, entry);
+    }
+    __unsafe_z_clear_resources_cache(zn);  // The cached match sets are no longer valid
+
     if (is_local == _Z_RESOURCE_IS_LOCAL) {
         zn->_local_subscriptions =
             _z_subscription_sptr_list_drop_filter(zn->_local_subscriptions, _z_subscription_sptr_eq, sub);
@@ -228,6 +357,9 @@ void _z_flush_subscriptions(_z_session_t *zn) {
     zp_mutex_lock(&zn->_mutex_inner);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+    __unsafe_z_clear_resources_cache(zn);
+    _z_keyexpr_index_clear(&zn->_local_subscriptions_index);
+    _z_keyexpr_index_clear(&zn->_remote_subscriptions_index);
     _z_subscription_sptr_list_free(&zn->_local_subscriptions);
     _z_subscription_sptr_list_free(&zn->_remote_subscriptions);
 
@@ -14,24 +14,25 @@
 
 #include "zenoh-pico/transport/multicast/tx.h"
 
+#include "zenoh-pico/session/utils.h"
 #include "zenoh-pico/transport/raweth/tx.h"
 #include "zenoh-pico/transport/unicast/tx.h"
 #include "zenoh-pico/utils/logging.h"
 
-int8_t _z_send_n_msg(_z_session_t *zn, const _z_network_message_t *z_msg, z_reliability_t reliability,
-                     z_congestion_control_t cong_ctrl) {
+// Sends a network message on a single transport of the session
+static int8_t __z_transport_send_n_msg(_z_transport_t *zt, const _z_network_message_t *z_msg,
+                                       z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
     int8_t ret = _Z_RES_OK;
-    _Z_DEBUG(">> send network message");
     // Call transport function
-    switch (zn->_tp._type) {
+    switch (zt->_type) {
         case _Z_TRANSPORT_UNICAST_TYPE:
-            ret = _z_unicast_send_n_msg(zn, z_msg, reliability, cong_ctrl);
+            ret = _z_unicast_send_n_msg(&zt->_transport._unicast, z_msg, reliability, cong_ctrl);
             break;
         case _Z_TRANSPORT_MULTICAST_TYPE:
-            ret = _z_multicast_send_n_msg(zn, z_msg, reliability, cong_ctrl);
+            ret = _z_multicast_send_n_msg(&zt->_transport._multicast, z_msg, reliability, cong_ctrl);
             break;
         case _Z_TRANSPORT_RAWETH_TYPE:
-            ret = _z_raweth_send_n_msg(zn, z_msg, reliability, cong_ctrl);
+            ret = _z_raweth_send_n_msg(&zt->_transport._raweth, z_msg, reliability, cong_ctrl);
             break;
         default:
             ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
@@ -39,3 +40,128 @@ int8_t _z_send_n_msg(_z_session_t *zn, const _z_network_message_t *z_msg, z_reli
     }
     return ret;
 }
+
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+/**
+ * Whether the message is sent on every transport: the declarations keep the other transports ready to take over the
+ * traffic. The responses only go back on the transport of their request, see _z_send_n_msg_to.
+ */
+static _Bool __z_n_msg_is_broadcast(const _z_network_message_t *z_msg) { return z_msg->_tag == _Z_N_DECLARE; }
+
+/**
+ * The transport of the remote node with the given mapping. Each unicast transport has its own mapping, while the peers
+ * of the multicast transport, at most one per session, are numbered below those of the unicast transports.
+ */
+static _z_transport_t *__z_session_transport_of(_z_session_t *zn, uint16_t mapping) {
+    _z_transport_t *ret = NULL;
+    for (size_t i = 0; (i < _z_session_transports_len(zn)) && (ret == NULL); i++) {
+        _z_transport_t *zt = _z_session_transport(zn, i);
+        if (zt->_type == _Z_TRANSPORT_UNICAST_TYPE) {
+            if (zt->_transport._unicast._mapping == mapping) {
+                ret = zt;
+            }
+        } else if (mapping < (uint16_t)_Z_KEYEXPR_MAPPING_PEER_END) {
+            ret = zt;
+        }
+    }
+    return ret;
+}
+
+// Whether the transport delivers the messages as reliably as requested, and not more than needed
+static _Bool __z_transport_suits(const _z_transport_t *zt, z_reliability_t reliability) {
+    _Bool is_reliable = (_z_transport_link(zt)->_cap._is_reliable == true);
+#if Z_FEATURE_RELIABILITY == 1
+    // The messages lost on the link are retransmitted
+    if (zt->_type == _Z_TRANSPORT_UNICAST_TYPE) {
+        is_reliable = is_reliable || (zt->_transport._unicast._tx_window != NULL);
+    } else if (zt->_type == _Z_TRANSPORT_MULTICAST_TYPE) {
+        is_reliable = is_reliable || (zt->_transport._multicast._tx_window != NULL);
+    }
+#endif  // Z_FEATURE_RELIABILITY == 1
+    return is_reliable == (reliability == Z_RELIABILITY_RELIABLE);
+}
+
+static int8_t __z_send_n_msg_all(_z_session_t *zn, const _z_network_message_t *z_msg, z_reliability_t reliability,
+                                 z_congestion_control_t cong_ctrl) {
+    int8_t ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+    _Bool sent = false;
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        _z_transport_t *zt = _z_session_transport(zn, i);
+        if (_z_transport_is_up(zt) == true) {
+            ret = __z_transport_send_n_msg(zt, z_msg, reliability, cong_ctrl);
+            sent = sent || (ret == _Z_RES_OK);
+        }
+    }
+    // The message only has to reach one of them
+    return (sent == true) ? _Z_RES_OK : ret;
+}
+
+/**
+ * Sends the message on the first transport that suits its reliability, or on the first one up if none does. A failed
+ * transport is skipped for the next one. The best effort data can also be striped across the transports in turn.
+ */
+static int8_t __z_send_n_msg_one(_z_session_t *zn, const _z_network_message_t *z_msg, z_reliability_t reliability,
+                                 z_congestion_control_t cong_ctrl) {
+    int8_t ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+    size_t len = _z_session_transports_len(zn);
+    size_t first = 0;
+    _Bool striped = false;
+#if Z_TRANSPORTS_STRIPING == 1
+    // The interactive and real time messages keep to a single transport
+    if ((reliability == Z_RELIABILITY_BEST_EFFORT) &&
+        (_z_n_qos_get_priority(_z_n_msg_get_qos(z_msg)) >= Z_PRIORITY_DATA_HIGH)) {
+        first = zn->_tp_stripe % len;
+        zn->_tp_stripe = first + (size_t)1;
+        striped = true;
+    }
+#endif  // Z_TRANSPORTS_STRIPING == 1
+
+    // The transports that suit the message are tried first, then the others, a striped message takes any of them
+    _Bool sent = false;
+    uint8_t passes = (striped == true) ? (uint8_t)1 : (uint8_t)2;
+    for (uint8_t pass = 0; (pass < passes) && (sent == false); pass++) {
+        for (size_t j = 0; (j < len) && (sent == false); j++) {
+            _z_transport_t *zt = _z_session_transport(zn, (first + j) % len);
+            if ((_z_transport_is_up(zt) == true) &&
+                ((striped == true) || (__z_transport_suits(zt, reliability) == (pass == (uint8_t)0)))) {
+                ret = __z_transport_send_n_msg(zt, z_msg, reliability, cong_ctrl);
+                sent = (ret == _Z_RES_OK);
+            }
+        }
+    }
+    return ret;
+}
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+
+int8_t _z_send_n_msg(_z_session_t *zn, const _z_network_message_t *z_msg, z_reliability_t reliability,
+                     z_congestion_control_t cong_ctrl) {
+    _Z_DEBUG(">> send network message");
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    int8_t ret = _Z_RES_OK;
+    if (__z_n_msg_is_broadcast(z_msg) == true) {
+        ret = __z_send_n_msg_all(zn, z_msg, reliability, cong_ctrl);
+    } else {
+        ret = __z_send_n_msg_one(zn, z_msg, reliability, cong_ctrl);
+    }
+    return ret;
+#else
+    return __z_transport_send_n_msg(&zn->_tp, z_msg, reliability, cong_ctrl);
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+}
+
+int8_t _z_send_n_msg_to(_z_session_t *zn, uint16_t mapping, const _z_network_message_t *z_msg,
+                        z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
+    _Z_DEBUG(">> send network message to a remote node");
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    // The ids of the requests are only meaningful on their transport, another node could take the response for its own
+    int8_t ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+    _z_transport_t *zt = __z_session_transport_of(zn, mapping);
+    if ((zt != NULL) && (_z_transport_is_up(zt) == true)) {
+        ret = __z_transport_send_n_msg(zt, z_msg, reliability, cong_ctrl);
+    }
+    return ret;
+#else
+    _ZP_UNUSED(mapping);
+    return __z_transport_send_n_msg(&zn->_tp, z_msg, reliability, cong_ctrl);
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+}
@@ -15,13 +15,17 @@
 #include "zenoh-pico/session/utils.h"
 
 #include <stddef.h>
+#include <string.h>
 
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/session/matching.h"
 #include "zenoh-pico/session/query.h"
 #include "zenoh-pico/session/queryable.h"
 #include "zenoh-pico/session/resource.h"
 #include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/transport/manager.h"
+#include "zenoh-pico/utils/logging.h"
 
 /*------------------ clone helpers ------------------*/
 _z_timestamp_t _z_timestamp_duplicate(const _z_timestamp_t *tstamp) {
@@ -49,6 +53,23 @@ int8_t _z_session_generate_zid(_z_id_t *bs, uint8_t size) {
 }
 
 /*------------------ Init/Free/Close session ------------------*/
+// Notes the session in the transport, it hands the received messages over to it
+static void __z_session_attach_transport(_z_session_t *zn, _z_transport_t *zt) {
+    switch (zt->_type) {
+        case _Z_TRANSPORT_UNICAST_TYPE:
+            zt->_transport._unicast._session = zn;
+            break;
+        case _Z_TRANSPORT_MULTICAST_TYPE:
+            zt->_transport._multicast._session = zn;
+            break;
+        case _Z_TRANSPORT_RAWETH_TYPE:
+            zt->_transport._raweth._session = zn;
+            break;
+        default:
+            break;
+    }
+}
+
 int8_t _z_session_init(_z_session_t *zn, _z_id_t *zid) {
     int8_t ret = _Z_RES_OK;
 
@@ -59,18 +80,32 @@ int8_t _z_session_init(_z_session_t *zn, _z_id_t *zid) {
     zn->_pull_id = 1;
 
     // Initialize the data structs
-    zn->_local_resources = NULL;
-    zn->_remote_resources = NULL;
+    _z_resource_table_init(&zn->_local_resources);
+    _z_resource_table_init(&zn->_remote_resources);
+    zn->_resources_gen = 0;
 #if Z_FEATURE_SUBSCRIPTION == 1
     zn->_local_subscriptions = NULL;
+    _z_keyexpr_index_init(&zn->_local_subscriptions_index);
+#endif
+#if Z_FEATURE_SUBSCRIPTION == 1 || Z_FEATURE_MATCHING == 1
     zn->_remote_subscriptions = NULL;
+    _z_keyexpr_index_init(&zn->_remote_subscriptions_index);
+#endif
+#if Z_FEATURE_MATCHING == 1
+    zn->_matching_listeners = NULL;
+    zn->_matching_gen = 1;
 #endif
 #if Z_FEATURE_QUERYABLE == 1
     zn->_local_questionable = NULL;
+    _z_keyexpr_index_init(&zn->_local_questionable_index);
 #endif
 #if Z_FEATURE_QUERY == 1
-    zn->_pending_queries = NULL;
+    _z_pending_query_table_init(&zn->_pending_queries);
+    zn->_query_clock = zp_clock_now();
 #endif
+#if Z_FEATURE_STATS == 1
+    _z_session_stats_reset(&zn->_stats);
+#endif  // Z_FEATURE_STATS == 1
 
 #if Z_FEATURE_MULTI_THREAD == 1
     ret = zp_mutex_init(&zn->_mutex_inner);
@@ -81,34 +116,109 @@ int8_t _z_session_init(_z_session_t *zn, _z_id_t *zid) {
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     zn->_local_zid = *zid;
-    // Note session in transport
-    switch (zn->_tp._type) {
-        case _Z_TRANSPORT_UNICAST_TYPE:
-            zn->_tp._transport._unicast._session = zn;
-            break;
-        case _Z_TRANSPORT_MULTICAST_TYPE:
-            zn->_tp._transport._multicast._session = zn;
-            break;
-        case _Z_TRANSPORT_RAWETH_TYPE:
-            zn->_tp._transport._raweth._session = zn;
-            break;
-        default:
-            break;
+    __z_session_attach_transport(zn, &zn->_tp);
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    zn->_tp_others_len = 0;
+    zn->_tp_stripe = 0;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+    return ret;
+}
+
+size_t _z_session_transports_len(const _z_session_t *zn) {
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    return zn->_tp_others_len + (size_t)1;
+#else
+    _ZP_UNUSED(zn);
+    return 1;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+}
+
+_z_transport_t *_z_session_transport(_z_session_t *zn, size_t i) {
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    return (i == (size_t)0) ? &zn->_tp : &zn->_tp_others[i - (size_t)1];
+#else
+    _ZP_UNUSED(i);
+    return &zn->_tp;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+}
+
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+int8_t _z_session_open_transport(_z_session_t *zn, char *locator, z_whatami_t mode) {
+    int8_t ret = _Z_RES_OK;
+
+    size_t i = zn->_tp_others_len;
+    if (i == (size_t)(Z_TRANSPORTS_MAX - 1)) {
+        _Z_ERROR("A session holds at most %d transports", Z_TRANSPORTS_MAX);
+        ret = _Z_ERR_TRANSPORT_OPEN_FAILED;
+    }
+
+    _z_transport_t *zt = &zn->_tp_others[i];
+    if (ret == _Z_RES_OK) {
+        ret = _z_new_transport(zt, &zn->_local_zid, locator, mode);
+    }
+    if ((ret == _Z_RES_OK) && (zt->_type != _Z_TRANSPORT_UNICAST_TYPE)) {
+        // The ids of the multicast peers key their resources, they would collide across several multicast transports
+        for (size_t j = 0; j < _z_session_transports_len(zn); j++) {
+            if (_z_session_transport(zn, j)->_type != _Z_TRANSPORT_UNICAST_TYPE) {
+                _Z_ERROR("A session holds at most one multicast transport");
+                ret = _Z_ERR_TRANSPORT_OPEN_FAILED;
+            }
+        }
+        if (ret != _Z_RES_OK) {
+            _z_transport_close(zt, _Z_CLOSE_GENERIC);
+            _z_transport_clear(zt);
+        }
     }
+
+    if (ret == _Z_RES_OK) {
+        if (zt->_type == _Z_TRANSPORT_UNICAST_TYPE) {
+            zt->_transport._unicast._mapping = (uint16_t)(_Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE - (i + (size_t)1));
+        }
+        __z_session_attach_transport(zn, zt);
+        zn->_tp_others_len = i + (size_t)1;
+    }
+
     return ret;
 }
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+
+#if Z_FEATURE_STATS == 1
+void _z_session_stats(_z_session_t *zn, _z_stats_t *stats) {
+    (void)memset(stats, 0, sizeof(_z_stats_t));
+    _z_session_stats_read(&zn->_stats, stats);
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        _z_transport_t *zt = _z_session_transport(zn, i);
+        switch (zt->_type) {
+            case _Z_TRANSPORT_UNICAST_TYPE:
+                _z_transport_stats_read(&zt->_transport._unicast._stats, stats);
+                break;
+            case _Z_TRANSPORT_MULTICAST_TYPE:
+            case _Z_TRANSPORT_RAWETH_TYPE:
+                _z_transport_stats_read(&zt->_transport._multicast._stats, stats);
+                break;
+            default:
+                break;
+        }
+    }
+}
+#endif  // Z_FEATURE_STATS == 1
 
 void _z_session_clear(_z_session_t *zn) {
     // Clear Zenoh PID
 
     // Clean up transports
-    _z_transport_clear(&zn->_tp);
+    for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+        _z_transport_clear(_z_session_transport(zn, i));
+    }
 
     // Clean up the entities
     _z_flush_resources(zn);
 #if Z_FEATURE_SUBSCRIPTION == 1
     _z_flush_subscriptions(zn);
 #endif
+#if Z_FEATURE_MATCHING == 1
+    _z_flush_matching(zn);
+#endif
 #if Z_FEATURE_QUERYABLE == 1
     _z_flush_questionables(zn);
 #endif
@@ -136,7 +246,16 @@ int8_t _z_session_close(_z_session_t *zn, uint8_t reason) {
     int8_t ret = _Z_ERR_GENERIC;
 
     if (zn != NULL) {
-        ret = _z_transport_close(&zn->_tp, reason);
+        ret = _Z_RES_OK;
+        for (size_t i = 0; i < _z_session_transports_len(zn); i++) {
+            _z_transport_t *zt = _z_session_transport(zn, i);
+            if (_z_transport_is_up(zt) == true) {
+                int8_t res = _z_transport_close(zt, reason);
+                if (ret == _Z_RES_OK) {
+                    ret = res;
+                }
+            }
+        }
     }
 
     return ret;
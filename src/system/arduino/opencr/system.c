@@ -42,18 +42,18 @@ void zp_random_fill(void *buf, size_t len) {
 }
 
 /*------------------ Memory ------------------*/
-void *zp_malloc(size_t size) {
+void *zp_sys_malloc(size_t size) {
     // return pvPortMalloc(size); // FIXME: Further investigation is required to understand
     //        why pvPortMalloc or pvPortMallocAligned are failing
     return malloc(size);
 }
 
-void *zp_realloc(void *ptr, size_t size) {
+void *zp_sys_realloc(void *ptr, size_t size) {
     // Not implemented by the platform
     return NULL;
 }
 
-void zp_free(void *ptr) {
+void zp_sys_free(void *ptr) {
     // vPortFree(ptr); // FIXME: Further investigation is required to understand
     //        why vPortFree or vPortFreeAligned are failing
     return free(ptr);
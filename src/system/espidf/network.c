@@ -242,7 +242,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
     struct sockaddr *lsockaddr = NULL;
     socklen_t addrlen = 0;
     if (rep._iptcp->ai_family == AF_INET) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in));
             addrlen = sizeof(struct sockaddr_in);
@@ -255,7 +255,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
             ret = _Z_ERR_GENERIC;
         }
     } else if (rep._iptcp->ai_family == AF_INET6) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in6));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in6));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in6));
             addrlen = sizeof(struct sockaddr_in6);
@@ -308,7 +308,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
 
             // Create laddr endpoint
             if (ret == _Z_RES_OK) {
-                struct addrinfo *laddr = (struct addrinfo *)zp_malloc(sizeof(struct addrinfo));
+                struct addrinfo *laddr = (struct addrinfo *)zp_sys_malloc(sizeof(struct addrinfo));
                 if (laddr != NULL) {
                     laddr->ai_flags = 0;
                     laddr->ai_family = rep._iptcp->ai_family;
@@ -332,7 +332,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
         }
 
         if (ret != _Z_RES_OK) {
-            zp_free(lsockaddr);
+            zp_sys_free(lsockaddr);
         }
     } else {
         ret = _Z_ERR_GENERIC;
@@ -349,7 +349,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
     struct sockaddr *lsockaddr = NULL;
     unsigned int addrlen = 0;
     if (rep._iptcp->ai_family == AF_INET) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in));
             addrlen = sizeof(struct sockaddr_in);
@@ -362,7 +362,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
             ret = _Z_ERR_GENERIC;
         }
     } else if (rep._iptcp->ai_family == AF_INET6) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in6));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in6));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in6));
             addrlen = sizeof(struct sockaddr_in6);
@@ -434,7 +434,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
             ret = _Z_ERR_GENERIC;
         }
 
-        zp_free(lsockaddr);
+        zp_sys_free(lsockaddr);
     } else {
         ret = _Z_ERR_GENERIC;
     }
@@ -39,11 +39,11 @@ uint64_t zp_random_u64(void) {
 void zp_random_fill(void *buf, size_t len) { esp_fill_random(buf, len); }
 
 /*------------------ Memory ------------------*/
-void *zp_malloc(size_t size) { return heap_caps_malloc(size, MALLOC_CAP_8BIT); }
+void *zp_sys_malloc(size_t size) { return heap_caps_malloc(size, MALLOC_CAP_8BIT); }
 
-void *zp_realloc(void *ptr, size_t size) { return heap_caps_realloc(ptr, size, MALLOC_CAP_8BIT); }
+void *zp_sys_realloc(void *ptr, size_t size) { return heap_caps_realloc(ptr, size, MALLOC_CAP_8BIT); }
 
-void zp_free(void *ptr) { heap_caps_free(ptr); }
+void zp_sys_free(void *ptr) { heap_caps_free(ptr); }
 
 #if Z_FEATURE_MULTI_THREAD == 1
 // This wrapper is only used for ESP32.
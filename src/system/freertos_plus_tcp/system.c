@@ -48,14 +48,14 @@ void zp_random_fill(void *buf, size_t len) {
 }
 
 /*------------------ Memory ------------------*/
-void *zp_malloc(size_t size) { return pvPortMalloc(size); }
+void *zp_sys_malloc(size_t size) { return pvPortMalloc(size); }
 
-void *zp_realloc(void *ptr, size_t size) {
+void *zp_sys_realloc(void *ptr, size_t size) {
     // realloc not implemented in FreeRTOS
     return NULL;
 }
 
-void zp_free(void *ptr) { vPortFree(ptr); }
+void zp_sys_free(void *ptr) { vPortFree(ptr); }
 
 #if Z_FEATURE_MULTI_THREAD == 1
 // In FreeRTOS, tasks created using xTaskCreate must end with vTaskDelete.
@@ -12,6 +12,10 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#if defined(ZENOH_LINUX) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE  // recvmmsg and sendmmsg
+#endif
+
 #include <arpa/inet.h>
 #include <errno.h>
 #include <ifaddrs.h>
@@ -20,9 +24,15 @@
 #include <netinet/in.h>
 #include <stdbool.h>
 #include <stddef.h>
+#include <stdlib.h>
 #include <string.h>
+#if defined(ZENOH_LINUX)
+#include <sys/epoll.h>
+#endif
 #include <sys/ioctl.h>
+#include <sys/socket.h>
 #include <sys/types.h>
+#include <sys/uio.h>
 #include <unistd.h>
 
 #include "zenoh-pico/collections/string.h"
@@ -31,6 +41,84 @@
 #include "zenoh-pico/utils/logging.h"
 #include "zenoh-pico/utils/pointers.h"
 
+#if Z_FEATURE_LINK_TCP == 1 || Z_FEATURE_LINK_UDP_UNICAST == 1 || Z_FEATURE_LINK_UDP_MULTICAST == 1
+/*------------------ Vectored sends ------------------*/
+static size_t __z_send_vec(int fd, const _z_bytes_t *bufs, size_t count, const struct sockaddr *addr,
+                           socklen_t addrlen, int flags) {
+    struct iovec iov[_Z_SYS_NET_SEND_VEC_MAX];
+    if (count > (size_t)_Z_SYS_NET_SEND_VEC_MAX) {
+        return SIZE_MAX;
+    }
+    for (size_t i = 0; i < count; i++) {
+        iov[i].iov_base = (void *)bufs[i].start;  // Safety: the buffers are only read by sendmsg
+        iov[i].iov_len = bufs[i].len;
+    }
+
+    struct msghdr msg;
+    (void)memset(&msg, 0, sizeof(msg));
+    msg.msg_name = (void *)addr;
+    msg.msg_namelen = addrlen;
+    msg.msg_iov = iov;
+    msg.msg_iovlen = count;
+
+    ssize_t wb = sendmsg(fd, &msg, flags);
+    return (wb < 0) ? SIZE_MAX : (size_t)wb;
+}
+#endif
+
+#ifdef _Z_SYS_NET_BATCH_MAX
+/*------------------ Batched datagrams ------------------*/
+// Blocks until the first datagram only, then takes the ones already received. raddrs may be NULL.
+static size_t __z_recv_batch(int fd, uint8_t *ptr, size_t stride, size_t count, size_t *lens,
+                             struct sockaddr_storage *raddrs) {
+    struct mmsghdr msgs[_Z_SYS_NET_BATCH_MAX];
+    struct iovec iov[_Z_SYS_NET_BATCH_MAX];
+    if (count > (size_t)_Z_SYS_NET_BATCH_MAX) {
+        count = _Z_SYS_NET_BATCH_MAX;
+    }
+    (void)memset(msgs, 0, count * sizeof(struct mmsghdr));
+    for (size_t i = 0; i < count; i++) {
+        iov[i].iov_base = &ptr[i * stride];
+        iov[i].iov_len = stride;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+        if (raddrs != NULL) {
+            msgs[i].msg_hdr.msg_name = &raddrs[i];
+            msgs[i].msg_hdr.msg_namelen = sizeof(struct sockaddr_storage);
+        }
+    }
+
+    int rn = recvmmsg(fd, msgs, (unsigned int)count, MSG_WAITFORONE, NULL);
+    size_t ret = (rn < 0) ? SIZE_MAX : (size_t)rn;
+    for (size_t i = 0; (rn > 0) && (i < ret); i++) {
+        // A truncated datagram cannot be decoded, it is dropped
+        lens[i] = ((msgs[i].msg_hdr.msg_flags & MSG_TRUNC) == 0) ? (size_t)msgs[i].msg_len : (size_t)0;
+    }
+    return ret;
+}
+
+static size_t __z_send_batch(int fd, const _z_bytes_t *bufs, size_t count, const struct sockaddr *addr,
+                             socklen_t addrlen) {
+    struct mmsghdr msgs[_Z_SYS_NET_BATCH_MAX];
+    struct iovec iov[_Z_SYS_NET_BATCH_MAX];
+    if (count > (size_t)_Z_SYS_NET_BATCH_MAX) {
+        return SIZE_MAX;
+    }
+    (void)memset(msgs, 0, count * sizeof(struct mmsghdr));
+    for (size_t i = 0; i < count; i++) {
+        iov[i].iov_base = (void *)bufs[i].start;  // Safety: the buffers are only read by sendmmsg
+        iov[i].iov_len = bufs[i].len;
+        msgs[i].msg_hdr.msg_name = (void *)addr;
+        msgs[i].msg_hdr.msg_namelen = addrlen;
+        msgs[i].msg_hdr.msg_iov = &iov[i];
+        msgs[i].msg_hdr.msg_iovlen = 1;
+    }
+
+    int sn = sendmmsg(fd, msgs, (unsigned int)count, 0);
+    return (sn < 0) ? SIZE_MAX : (size_t)sn;
+}
+#endif
+
 #if Z_FEATURE_LINK_TCP == 1
 
 /*------------------ TCP sockets ------------------*/
@@ -156,6 +244,14 @@ size_t _z_send_tcp(const _z_sys_net_socket_t sock, const uint8_t *ptr, size_t le
     return send(sock._fd, ptr, len, 0);
 #endif
 }
+
+size_t _z_send_vec_tcp(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count) {
+#if defined(ZENOH_LINUX)
+    return __z_send_vec(sock._fd, bufs, count, NULL, 0, MSG_NOSIGNAL);
+#else
+    return __z_send_vec(sock._fd, bufs, count, NULL, 0, 0);
+#endif
+}
 #endif
 
 #if Z_FEATURE_LINK_UDP_UNICAST == 1 || Z_FEATURE_LINK_UDP_MULTICAST == 1
@@ -251,6 +347,23 @@ size_t _z_send_udp_unicast(const _z_sys_net_socket_t sock, const uint8_t *ptr, s
                            const _z_sys_net_endpoint_t rep) {
     return sendto(sock._fd, ptr, len, 0, rep._iptcp->ai_addr, rep._iptcp->ai_addrlen);
 }
+
+size_t _z_send_vec_udp_unicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                               const _z_sys_net_endpoint_t rep) {
+    return __z_send_vec(sock._fd, bufs, count, rep._iptcp->ai_addr, rep._iptcp->ai_addrlen, 0);
+}
+
+#ifdef _Z_SYS_NET_BATCH_MAX
+size_t _z_read_batch_udp_unicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_t stride, size_t count,
+                                 size_t *lens) {
+    return __z_recv_batch(sock._fd, ptr, stride, count, lens, NULL);
+}
+
+size_t _z_send_batch_udp_unicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                                 const _z_sys_net_endpoint_t rep) {
+    return __z_send_batch(sock._fd, bufs, count, rep._iptcp->ai_addr, rep._iptcp->ai_addrlen);
+}
+#endif
 #endif
 
 #if Z_FEATURE_LINK_UDP_MULTICAST == 1
@@ -264,14 +377,14 @@ unsigned int __get_ip_from_iface(const char *iface, int sa_family, struct sockad
             if (_z_str_eq(tmp->ifa_name, iface) == true) {
                 if (tmp->ifa_addr->sa_family == sa_family) {
                     if (tmp->ifa_addr->sa_family == AF_INET) {
-                        *lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in));
+                        *lsockaddr = (struct sockaddr *)malloc(sizeof(struct sockaddr_in));
                         if (lsockaddr != NULL) {
                             (void)memset(*lsockaddr, 0, sizeof(struct sockaddr_in));
                             (void)memcpy(*lsockaddr, tmp->ifa_addr, sizeof(struct sockaddr_in));
                             addrlen = sizeof(struct sockaddr_in);
                         }
                     } else if (tmp->ifa_addr->sa_family == AF_INET6) {
-                        *lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in6));
+                        *lsockaddr = (struct sockaddr *)malloc(sizeof(struct sockaddr_in6));
                         if (lsockaddr != NULL) {
                             (void)memset(*lsockaddr, 0, sizeof(struct sockaddr_in6));
                             (void)memcpy(*lsockaddr, tmp->ifa_addr, sizeof(struct sockaddr_in6));
@@ -336,7 +449,8 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
 
             // Create lep endpoint
             if (ret == _Z_RES_OK) {
-                struct addrinfo *laddr = (struct addrinfo *)zp_malloc(sizeof(struct addrinfo));
+                // Released with freeaddrinfo, so the endpoint and its address are not allocated with zp_malloc
+                struct addrinfo *laddr = (struct addrinfo *)malloc(sizeof(struct addrinfo));
                 if (laddr != NULL) {
                     laddr->ai_flags = 0;
                     laddr->ai_family = rep._iptcp->ai_family;
@@ -353,7 +467,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
                     //    https://lists.debian.org/debian-glibc/2016/03/msg00241.html
                     // To avoid a fix to break zenoh-pico, we are let it leak for the moment.
                     // #if defined(ZENOH_LINUX)
-                    //    zp_free(lsockaddr);
+                    //    free(lsockaddr);
                     // #endif
                 } else {
                     ret = _Z_ERR_GENERIC;
@@ -368,7 +482,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
         }
 
         if (ret != _Z_RES_OK) {
-            zp_free(lsockaddr);
+            free(lsockaddr);
         }
     } else {
         ret = _Z_ERR_GENERIC;
@@ -480,7 +594,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
             ret = _Z_ERR_GENERIC;
         }
 
-        zp_free(lsockaddr);
+        free(lsockaddr);
     } else {
         ret = _Z_ERR_GENERIC;
     }
@@ -512,6 +626,41 @@ void _z_close_udp_multicast(_z_sys_net_socket_t *sockrecv, _z_sys_net_socket_t *
     close(socksend->_fd);
 }
 
+// Whether a datagram comes from another peer than ourselves, in which case its address is written in addr if not NULL
+static _Bool __z_udp_multicast_accept(const _z_sys_net_endpoint_t lep, const struct sockaddr_storage *raddr,
+                                      _z_bytes_t *addr) {
+    _Bool ret = false;
+    if (lep._iptcp->ai_family == AF_INET) {
+        struct sockaddr_in *a = ((struct sockaddr_in *)lep._iptcp->ai_addr);
+        const struct sockaddr_in *b = ((const struct sockaddr_in *)raddr);
+        if (!((a->sin_port == b->sin_port) && (a->sin_addr.s_addr == b->sin_addr.s_addr))) {
+            // If addr is not NULL, it means that the rep was requested by the upper-layers
+            if (addr != NULL) {
+                *addr = _z_bytes_make(sizeof(in_addr_t) + sizeof(in_port_t));
+                (void)memcpy((uint8_t *)addr->start, &b->sin_addr.s_addr, sizeof(in_addr_t));
+                (void)memcpy((uint8_t *)(addr->start + sizeof(in_addr_t)), &b->sin_port, sizeof(in_port_t));
+            }
+            ret = true;
+        }
+    } else if (lep._iptcp->ai_family == AF_INET6) {
+        struct sockaddr_in6 *a = ((struct sockaddr_in6 *)lep._iptcp->ai_addr);
+        const struct sockaddr_in6 *b = ((const struct sockaddr_in6 *)raddr);
+        if (!((a->sin6_port == b->sin6_port) &&
+              (memcmp(a->sin6_addr.s6_addr, b->sin6_addr.s6_addr, sizeof(struct in6_addr)) == 0))) {
+            // If addr is not NULL, it means that the rep was requested by the upper-layers
+            if (addr != NULL) {
+                *addr = _z_bytes_make(sizeof(struct in6_addr) + sizeof(in_port_t));
+                (void)memcpy((uint8_t *)addr->start, &b->sin6_addr.s6_addr, sizeof(struct in6_addr));
+                (void)memcpy((uint8_t *)(addr->start + sizeof(struct in6_addr)), &b->sin6_port, sizeof(in_port_t));
+            }
+            ret = true;
+        }
+    } else {
+        // FIXME: support error report on invalid packet to the upper layer
+    }
+    return ret;
+}
+
 size_t _z_read_udp_multicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_t len, const _z_sys_net_endpoint_t lep,
                              _z_bytes_t *addr) {
     struct sockaddr_storage raddr;
@@ -524,36 +673,7 @@ size_t _z_read_udp_multicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_
             rb = SIZE_MAX;
             break;
         }
-
-        if (lep._iptcp->ai_family == AF_INET) {
-            struct sockaddr_in *a = ((struct sockaddr_in *)lep._iptcp->ai_addr);
-            struct sockaddr_in *b = ((struct sockaddr_in *)&raddr);
-            if (!((a->sin_port == b->sin_port) && (a->sin_addr.s_addr == b->sin_addr.s_addr))) {
-                // If addr is not NULL, it means that the rep was requested by the upper-layers
-                if (addr != NULL) {
-                    *addr = _z_bytes_make(sizeof(in_addr_t) + sizeof(in_port_t));
-                    (void)memcpy((uint8_t *)addr->start, &b->sin_addr.s_addr, sizeof(in_addr_t));
-                    (void)memcpy((uint8_t *)(addr->start + sizeof(in_addr_t)), &b->sin_port, sizeof(in_port_t));
-                }
-                break;
-            }
-        } else if (lep._iptcp->ai_family == AF_INET6) {
-            struct sockaddr_in6 *a = ((struct sockaddr_in6 *)lep._iptcp->ai_addr);
-            struct sockaddr_in6 *b = ((struct sockaddr_in6 *)&raddr);
-            if (!((a->sin6_port == b->sin6_port) &&
-                  (memcmp(a->sin6_addr.s6_addr, b->sin6_addr.s6_addr, sizeof(struct in6_addr)) == 0))) {
-                // If addr is not NULL, it means that the rep was requested by the upper-layers
-                if (addr != NULL) {
-                    *addr = _z_bytes_make(sizeof(struct in6_addr) + sizeof(in_port_t));
-                    (void)memcpy((uint8_t *)addr->start, &b->sin6_addr.s6_addr, sizeof(struct in6_addr));
-                    (void)memcpy((uint8_t *)(addr->start + sizeof(struct in6_addr)), &b->sin6_port, sizeof(in_port_t));
-                }
-                break;
-            }
-        } else {
-            continue;  // FIXME: support error report on invalid packet to the upper layer
-        }
-    } while (1);
+    } while (__z_udp_multicast_accept(lep, &raddr, addr) == false);
 
     return rb;
 }
@@ -582,6 +702,46 @@ size_t _z_send_udp_multicast(const _z_sys_net_socket_t sock, const uint8_t *ptr,
     return sendto(sock._fd, ptr, len, 0, rep._iptcp->ai_addr, rep._iptcp->ai_addrlen);
 }
 
+size_t _z_send_vec_udp_multicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                                 const _z_sys_net_endpoint_t rep) {
+    return __z_send_vec(sock._fd, bufs, count, rep._iptcp->ai_addr, rep._iptcp->ai_addrlen, 0);
+}
+
+#ifdef _Z_SYS_NET_BATCH_MAX
+size_t _z_read_batch_udp_multicast(const _z_sys_net_socket_t sock, uint8_t *ptr, size_t stride, size_t count,
+                                   size_t *lens, const _z_sys_net_endpoint_t lep, _z_bytes_t *addrs) {
+    struct sockaddr_storage raddrs[_Z_SYS_NET_BATCH_MAX];
+
+    // Our own datagrams are dropped, wait for another batch if they were all ours
+    size_t rn = 0;
+    _Bool accepted = false;
+    while (accepted == false) {
+        rn = __z_recv_batch(sock._fd, ptr, stride, count, lens, raddrs);
+        if (rn == SIZE_MAX) {
+            break;
+        }
+        for (size_t i = 0; i < rn; i++) {
+            if (addrs != NULL) {
+                addrs[i] = _z_bytes_empty();
+            }
+            if ((lens[i] > (size_t)0) &&
+                (__z_udp_multicast_accept(lep, &raddrs[i], (addrs != NULL) ? &addrs[i] : NULL) == true)) {
+                accepted = true;
+            } else {
+                lens[i] = 0;
+            }
+        }
+    }
+
+    return rn;
+}
+
+size_t _z_send_batch_udp_multicast(const _z_sys_net_socket_t sock, const _z_bytes_t *bufs, size_t count,
+                                   const _z_sys_net_endpoint_t rep) {
+    return __z_send_batch(sock._fd, bufs, count, rep._iptcp->ai_addr, rep._iptcp->ai_addrlen);
+}
+#endif
+
 #endif
 
 #if Z_FEATURE_LINK_BLUETOOTH == 1
@@ -591,3 +751,65 @@ size_t _z_send_udp_multicast(const _z_sys_net_socket_t sock, const uint8_t *ptr,
 #if Z_FEATURE_LINK_SERIAL == 1
 #error "Serial not supported yet on Unix port of Zenoh-Pico"
 #endif
+
+#ifdef _Z_SYS_NET_POLL
+/*------------------ Poll ------------------*/
+int8_t _z_poll_init(_z_sys_net_poll_t *poll) {
+    int8_t ret = _Z_RES_OK;
+    poll->_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (poll->_fd < 0) {
+        ret = _Z_ERR_GENERIC;
+    }
+    return ret;
+}
+
+void _z_poll_clear(_z_sys_net_poll_t *poll) {
+    if (poll->_fd >= 0) {
+        close(poll->_fd);
+        poll->_fd = -1;
+    }
+}
+
+static int8_t __z_poll_ctl(_z_sys_net_poll_t *poll, int op, const _z_sys_net_socket_t *sock, void *arg) {
+    int8_t ret = _Z_RES_OK;
+    struct epoll_event ev;
+    (void)memset(&ev, 0, sizeof(ev));
+    // One shot, so that a socket is handed to a single thread at a time
+    ev.events = EPOLLIN | EPOLLRDHUP | EPOLLONESHOT;
+    ev.data.ptr = arg;
+    if (epoll_ctl(poll->_fd, op, sock->_fd, &ev) < 0) {
+        ret = _Z_ERR_GENERIC;
+    }
+    return ret;
+}
+
+int8_t _z_poll_add(_z_sys_net_poll_t *poll, const _z_sys_net_socket_t *sock, void *arg) {
+    return __z_poll_ctl(poll, EPOLL_CTL_ADD, sock, arg);
+}
+
+int8_t _z_poll_rearm(_z_sys_net_poll_t *poll, const _z_sys_net_socket_t *sock, void *arg) {
+    return __z_poll_ctl(poll, EPOLL_CTL_MOD, sock, arg);
+}
+
+int8_t _z_poll_remove(_z_sys_net_poll_t *poll, const _z_sys_net_socket_t *sock) {
+    int8_t ret = _Z_RES_OK;
+    if (epoll_ctl(poll->_fd, EPOLL_CTL_DEL, sock->_fd, NULL) < 0) {
+        ret = _Z_ERR_GENERIC;
+    }
+    return ret;
+}
+
+size_t _z_poll_wait(_z_sys_net_poll_t *poll, _z_sys_net_poll_event_t *events, size_t max, uint32_t timeout) {
+    struct epoll_event evs[Z_REACTOR_EVENTS];
+    size_t n = (max < (size_t)Z_REACTOR_EVENTS) ? max : (size_t)Z_REACTOR_EVENTS;
+    int timeout_ms = (timeout > (uint32_t)INT32_MAX) ? INT32_MAX : (int)timeout;
+
+    int rn = epoll_wait(poll->_fd, evs, (int)n, timeout_ms);
+    size_t ret = (rn > 0) ? (size_t)rn : 0;
+    for (size_t i = 0; i < ret; i++) {
+        events[i].arg = evs[i].data.ptr;
+        events[i].hangup = (evs[i].events & (uint32_t)(EPOLLRDHUP | EPOLLHUP | EPOLLERR)) != (uint32_t)0;
+    }
+    return ret;
+}
+#endif
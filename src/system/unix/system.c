@@ -93,11 +93,11 @@ void zp_random_fill(void *buf, size_t len) {
 }
 
 /*------------------ Memory ------------------*/
-void *zp_malloc(size_t size) { return malloc(size); }
+void *zp_sys_malloc(size_t size) { return malloc(size); }
 
-void *zp_realloc(void *ptr, size_t size) { return realloc(ptr, size); }
+void *zp_sys_realloc(void *ptr, size_t size) { return realloc(ptr, size); }
 
-void zp_free(void *ptr) { free(ptr); }
+void zp_sys_free(void *ptr) { free(ptr); }
 
 #if Z_FEATURE_MULTI_THREAD == 1
 /*------------------ Task ------------------*/
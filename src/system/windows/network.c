@@ -15,6 +15,7 @@
 #include <winsock2.h>
 // The following includes must come after winsock2
 #include <iphlpapi.h>
+#include <stdlib.h>
 #include <ws2tcpip.h>
 
 #include "zenoh-pico/collections/string.h"
@@ -283,14 +284,14 @@ unsigned int __get_ip_from_iface(const char *iface, int sa_family, SOCKADDR **ls
             for (IP_ADAPTER_ADDRESSES *tmp = l_ifaddr; tmp != NULL; tmp = tmp->Next) {
                 if (_z_str_eq(tmp->AdapterName, iface) == true) {
                     if (sa_family == AF_INET) {
-                        *lsockaddr = (SOCKADDR *)zp_malloc(sizeof(SOCKADDR_IN));
+                        *lsockaddr = (SOCKADDR *)malloc(sizeof(SOCKADDR_IN));
                         if (lsockaddr != NULL) {
                             (void)memset(*lsockaddr, 0, sizeof(SOCKADDR_IN));
                             (void)memcpy(*lsockaddr, tmp->FirstUnicastAddress->Address.lpSockaddr, sizeof(SOCKADDR_IN));
                             addrlen = sizeof(SOCKADDR_IN);
                         }
                     } else if (sa_family == AF_INET6) {
-                        *lsockaddr = (SOCKADDR *)zp_malloc(sizeof(SOCKADDR_IN6));
+                        *lsockaddr = (SOCKADDR *)malloc(sizeof(SOCKADDR_IN6));
                         if (lsockaddr != NULL) {
                             (void)memset(*lsockaddr, 0, sizeof(SOCKADDR_IN6));
                             (void)memcpy(*lsockaddr, tmp->FirstUnicastAddress->Address.lpSockaddr,
@@ -374,7 +375,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
 
             // Create lep endpoint
             if (ret == _Z_RES_OK) {
-                ADDRINFOA *laddr = (ADDRINFOA *)zp_malloc(sizeof(ADDRINFOA));
+                ADDRINFOA *laddr = (ADDRINFOA *)malloc(sizeof(ADDRINFOA));
                 if (laddr != NULL) {
                     laddr->ai_flags = 0;
                     laddr->ai_family = rep._ep._iptcp->ai_family;
@@ -391,7 +392,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
                     //    https://lists.debian.org/debian-glibc/2016/03/msg00241.html
                     // To avoid a fix to break zenoh-pico, we are let it leak for the moment.
                     // #if defined(ZENOH_LINUX)
-                    //    zp_free(lsockaddr);
+                    //    free(lsockaddr);
                     // #endif
                 } else {
                     ret = _Z_ERR_GENERIC;
@@ -407,7 +408,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
         }
 
         if (ret != _Z_RES_OK) {
-            zp_free(lsockaddr);
+            free(lsockaddr);
         }
     } else {
         ret = _Z_ERR_GENERIC;
@@ -497,7 +498,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
             ret = _Z_ERR_GENERIC;
         }
 
-        zp_free(lsockaddr);
+        free(lsockaddr);
     } else {
         ret = _Z_ERR_GENERIC;
     }
@@ -251,7 +251,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
     struct sockaddr *lsockaddr = NULL;
     unsigned int addrlen = 0;
     if (rep._iptcp->ai_family == AF_INET) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in));
             addrlen = sizeof(struct sockaddr_in);
@@ -264,7 +264,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
             ret = _Z_ERR_GENERIC;
         }
     } else if (rep._iptcp->ai_family == AF_INET6) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in6));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in6));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in6));
             addrlen = sizeof(struct sockaddr_in6);
@@ -303,7 +303,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
 
             // Create lep endpoint
             if (ret == _Z_RES_OK) {
-                struct addrinfo *laddr = (struct addrinfo *)zp_malloc(sizeof(struct addrinfo));
+                struct addrinfo *laddr = (struct addrinfo *)zp_sys_malloc(sizeof(struct addrinfo));
                 if (laddr != NULL) {
                     laddr->ai_flags = 0;
                     laddr->ai_family = rep._iptcp->ai_family;
@@ -327,7 +327,7 @@ int8_t _z_open_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpoin
         }
 
         if (ret != _Z_RES_OK) {
-            zp_free(lsockaddr);
+            zp_sys_free(lsockaddr);
         }
     } else {
         ret = _Z_ERR_GENERIC;
@@ -344,7 +344,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
     struct sockaddr *lsockaddr = NULL;
     unsigned int addrlen = 0;
     if (rep._iptcp->ai_family == AF_INET) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in));
             addrlen = sizeof(struct sockaddr_in);
@@ -357,7 +357,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
             ret = _Z_ERR_GENERIC;
         }
     } else if (rep._iptcp->ai_family == AF_INET6) {
-        lsockaddr = (struct sockaddr *)zp_malloc(sizeof(struct sockaddr_in6));
+        lsockaddr = (struct sockaddr *)zp_sys_malloc(sizeof(struct sockaddr_in6));
         if (lsockaddr != NULL) {
             (void)memset(lsockaddr, 0, sizeof(struct sockaddr_in6));
             addrlen = sizeof(struct sockaddr_in6);
@@ -431,7 +431,7 @@ int8_t _z_listen_udp_multicast(_z_sys_net_socket_t *sock, const _z_sys_net_endpo
             }
         }
 
-        zp_free(lsockaddr);
+        zp_sys_free(lsockaddr);
     } else {
         ret = _Z_ERR_GENERIC;
     }
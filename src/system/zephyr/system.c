@@ -46,14 +46,14 @@ uint64_t zp_random_u64(void) {
 void zp_random_fill(void *buf, size_t len) { sys_rand_get(buf, len); }
 
 /*------------------ Memory ------------------*/
-void *zp_malloc(size_t size) { return k_malloc(size); }
+void *zp_sys_malloc(size_t size) { return k_malloc(size); }
 
-void *zp_realloc(void *ptr, size_t size) {
+void *zp_sys_realloc(void *ptr, size_t size) {
     // k_realloc not implemented in Zephyr
     return NULL;
 }
 
-void zp_free(void *ptr) { k_free(ptr); }
+void zp_sys_free(void *ptr) { k_free(ptr); }
 
 #if Z_FEATURE_MULTI_THREAD == 1
 
@@ -55,3 +55,38 @@ int8_t _z_send_join(_z_transport_t *zt) {
     }
     return ret;
 }
+
+void _z_lease_start(_z_transport_t *zt) {
+    switch (zt->_type) {
+        case _Z_TRANSPORT_UNICAST_TYPE:
+            _zp_unicast_lease_start(&zt->_transport._unicast);
+            break;
+        case _Z_TRANSPORT_MULTICAST_TYPE:
+            _zp_multicast_lease_start(&zt->_transport._multicast);
+            break;
+        case _Z_TRANSPORT_RAWETH_TYPE:
+            _zp_multicast_lease_start(&zt->_transport._raweth);
+            break;
+        default:
+            break;
+    }
+}
+
+int8_t _z_lease_step(_z_transport_t *zt, _z_zint_t *interval) {
+    int8_t ret = _Z_RES_OK;
+    switch (zt->_type) {
+        case _Z_TRANSPORT_UNICAST_TYPE:
+            ret = _zp_unicast_lease_step(&zt->_transport._unicast, interval);
+            break;
+        case _Z_TRANSPORT_MULTICAST_TYPE:
+            ret = _zp_multicast_lease_step(&zt->_transport._multicast, interval);
+            break;
+        case _Z_TRANSPORT_RAWETH_TYPE:
+            ret = _zp_multicast_lease_step(&zt->_transport._raweth, interval);
+            break;
+        default:
+            ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+            break;
+    }
+    return ret;
+}
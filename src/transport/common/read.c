@@ -39,6 +39,25 @@ int8_t _z_read(_z_transport_t *zt) {
     return ret;
 }
 
+_Bool _z_read_pending(const _z_transport_t *zt) {
+    _Bool ret = false;
+    switch (zt->_type) {
+        case _Z_TRANSPORT_UNICAST_TYPE:
+            if (zt->_transport._unicast._link._cap._flow == Z_LINK_CAP_FLOW_STREAM) {
+                ret = _z_rx_stream_ready(&zt->_transport._unicast._rx_stream, &zt->_transport._unicast._zbuf);
+            }
+            break;
+        case _Z_TRANSPORT_MULTICAST_TYPE:
+            if (zt->_transport._multicast._link._cap._flow == Z_LINK_CAP_FLOW_STREAM) {
+                ret = _z_rx_stream_ready(&zt->_transport._multicast._rx_stream, &zt->_transport._multicast._zbuf);
+            }
+            break;
+        default:
+            break;
+    }
+    return ret;
+}
+
 void *_zp_read_task(void *zt_arg) {
     void *ret = NULL;
     _z_transport_t *zt = (_z_transport_t *)zt_arg;
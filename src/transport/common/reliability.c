@@ -0,0 +1,372 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/transport/common/reliability.h"
+
+#include <string.h>
+
+#include "zenoh-pico/protocol/codec/core.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/transport/utils.h"
+#include "zenoh-pico/utils/logging.h"
+#include "zenoh-pico/utils/result.h"
+
+#if Z_FEATURE_RELIABILITY == 1
+
+// The largest encoding of a header followed by a SN
+#define _Z_RELIABILITY_HEADER_MAX_SIZE (_Z_MSG_LEN_ENC_SIZE + 1 + 10)
+
+/*------------------ TX ------------------*/
+_z_reliability_window_t *_z_reliability_windows_make(size_t num) {
+    _z_reliability_window_t *windows = (_z_reliability_window_t *)zp_malloc(num * sizeof(_z_reliability_window_t));
+    if (windows != NULL) {
+        (void)memset(windows, 0, num * sizeof(_z_reliability_window_t));
+    }
+    return windows;
+}
+
+void _z_reliability_windows_free(_z_reliability_window_t **windows, size_t num) {
+    _z_reliability_window_t *ptr = *windows;
+    if (ptr != NULL) {
+        for (size_t i = 0; i < num; i++) {
+            for (size_t j = 0; j < (size_t)Z_RELIABILITY_WINDOW_SIZE; j++) {
+                zp_free(ptr[i]._slots[j]._buf);
+            }
+        }
+        zp_free(ptr);
+        *windows = NULL;
+    }
+}
+
+// Copies the first len readable bytes of the buffer
+static void __z_reliability_wbuf_copy(const _z_wbuf_t *wbf, uint8_t *dst, size_t len) {
+    size_t pos = 0;
+    for (size_t i = wbf->_r_idx; (i <= wbf->_w_idx) && (pos < len); i++) {
+        _z_iosli_t *ios = _z_wbuf_get_iosli(wbf, i);
+        size_t n = _z_iosli_readable(ios);
+        if (n > (len - pos)) {
+            n = len - pos;
+        }
+        (void)memcpy(&dst[pos], ios->_buf + ios->_r_pos, n);
+        pos = pos + n;
+    }
+}
+
+int8_t _z_reliability_window_push(_z_reliability_window_t *w, const _z_wbuf_t *wbf, uint8_t link_flow,
+                                  _z_zint_t now) {
+    int8_t ret = _Z_RES_OK;
+
+    size_t len = _z_wbuf_len(wbf);
+    size_t off = (link_flow == Z_LINK_CAP_FLOW_STREAM) ? (size_t)_Z_MSG_LEN_ENC_SIZE : (size_t)0;
+    uint8_t head[_Z_RELIABILITY_HEADER_MAX_SIZE];
+    size_t head_len = (len < sizeof(head)) ? len : sizeof(head);
+    __z_reliability_wbuf_copy(wbf, head, head_len);
+
+    _Bool is_reliable = false;
+    _z_zint_t sn = 0;
+    if (head_len > off) {
+        uint8_t header = head[off];
+        if (_Z_MID(header) == _Z_MID_T_FRAME) {
+            is_reliable = _Z_HAS_FLAG(header, _Z_FLAG_T_FRAME_R);
+        } else if (_Z_MID(header) == _Z_MID_T_FRAGMENT) {
+            is_reliable = _Z_HAS_FLAG(header, _Z_FLAG_T_FRAGMENT_R);
+        } else {
+            // Other messages are not retransmitted
+        }
+        if (is_reliable == true) {
+            _z_zbuf_t zbf = _z_zbytes_as_zbuf(_z_bytes_wrap(&head[off + 1], head_len - off - 1));
+            is_reliable = (_z_zint_decode(&sn, &zbf) == _Z_RES_OK);
+        }
+    }
+
+    if (is_reliable == true) {
+        _z_reliability_slot_t *slot = &w->_slots[sn % (_z_zint_t)Z_RELIABILITY_WINDOW_SIZE];
+        if (slot->_capacity < len) {
+            uint8_t *buf = (uint8_t *)zp_malloc(len);
+            if (buf != NULL) {
+                zp_free(slot->_buf);
+                slot->_buf = buf;
+                slot->_capacity = len;
+            } else {
+                slot->_is_used = false;
+                ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+            }
+        }
+        if (ret == _Z_RES_OK) {
+            // The oldest frame or fragment is evicted once the window is full
+            __z_reliability_wbuf_copy(wbf, slot->_buf, len);
+            slot->_len = len;
+            slot->_sn = sn;
+            slot->_sent = now;
+            slot->_is_used = true;
+        }
+    }
+
+    return ret;
+}
+
+void _z_reliability_window_ack(_z_reliability_window_t *w, _z_zint_t sn_res, _z_zint_t sn) {
+    for (size_t i = 0; i < (size_t)Z_RELIABILITY_WINDOW_SIZE; i++) {
+        _z_reliability_slot_t *slot = &w->_slots[i];
+        if ((slot->_is_used == true) && ((slot->_sn == sn) || (_z_sn_precedes(sn_res, slot->_sn, sn) == true))) {
+            slot->_is_used = false;
+        }
+    }
+}
+
+static int8_t __z_reliability_slot_resend(_z_reliability_slot_t *slot, const _z_link_t *zl, _z_zint_t now) {
+    int8_t ret = _Z_RES_OK;
+    _Z_DEBUG("Retransmitting SN %ju", (uintmax_t)slot->_sn);
+    if (zl->_write_all_f(zl, slot->_buf, slot->_len) == SIZE_MAX) {
+        ret = _Z_ERR_TRANSPORT_TX_FAILED;
+    }
+    slot->_sent = now;
+    return ret;
+}
+
+int8_t _z_reliability_window_resend(_z_reliability_window_t *w, const _z_link_t *zl, _z_zint_t sn_res, _z_zint_t sn,
+                                    _z_zint_t mask, _z_zint_t now) {
+    int8_t ret = _Z_RES_OK;
+
+    _z_zint_t cur = sn;
+    for (size_t i = 0; (i <= sizeof(_z_zint_t) * (size_t)8) && (ret == _Z_RES_OK); i++) {
+        if ((i == (size_t)0) || (((mask >> (i - (size_t)1)) & (_z_zint_t)1) == (_z_zint_t)1)) {
+            _z_reliability_slot_t *slot = &w->_slots[cur % (_z_zint_t)Z_RELIABILITY_WINDOW_SIZE];
+            if ((slot->_is_used == true) && (slot->_sn == cur)) {
+                ret = __z_reliability_slot_resend(slot, zl, now);
+            }
+        }
+        cur = _z_sn_increment(sn_res, cur);
+    }
+
+    return ret;
+}
+
+int8_t _z_reliability_window_resend_expired(_z_reliability_window_t *w, const _z_link_t *zl, _z_zint_t now,
+                                            _z_zint_t rto) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; (i < (size_t)Z_RELIABILITY_WINDOW_SIZE) && (ret == _Z_RES_OK); i++) {
+        _z_reliability_slot_t *slot = &w->_slots[i];
+        if ((slot->_is_used == true) && ((now - slot->_sent) >= rto)) {
+            ret = __z_reliability_slot_resend(slot, zl, now);
+        }
+    }
+    return ret;
+}
+
+/*------------------ RX ------------------*/
+_z_reliability_reorder_t *_z_reliability_reorders_make(size_t num) {
+    _z_reliability_reorder_t *reorders = (_z_reliability_reorder_t *)zp_malloc(num * sizeof(_z_reliability_reorder_t));
+    if (reorders != NULL) {
+        (void)memset(reorders, 0, num * sizeof(_z_reliability_reorder_t));
+    }
+    return reorders;
+}
+
+void _z_reliability_reorder_reset(_z_reliability_reorder_t *r) {
+    for (size_t i = 0; i < (size_t)Z_RELIABILITY_REORDER_SIZE; i++) {
+        zp_free(r->_slots[i]._buf);
+        r->_slots[i]._buf = NULL;
+        r->_slots[i]._is_used = false;
+    }
+    r->_len = 0;
+}
+
+void _z_reliability_reorders_free(_z_reliability_reorder_t **reorders, size_t num) {
+    _z_reliability_reorder_t *ptr = *reorders;
+    if (ptr != NULL) {
+        for (size_t i = 0; i < num; i++) {
+            _z_reliability_reorder_reset(&ptr[i]);
+        }
+        zp_free(ptr);
+        *reorders = NULL;
+    }
+}
+
+static _z_reliability_pending_t *__z_reliability_reorder_get(const _z_reliability_reorder_t *r, _z_zint_t sn) {
+    _z_reliability_pending_t *p =
+        (_z_reliability_pending_t *)&r->_slots[sn % (_z_zint_t)Z_RELIABILITY_REORDER_SIZE];
+    return ((p->_is_used == true) && (p->_sn == sn)) ? p : NULL;
+}
+
+static _z_zint_t __z_reliability_sn(const _z_transport_message_t *t_msg) {
+    return (_Z_MID(t_msg->_header) == _Z_MID_T_FRAME) ? t_msg->_body._frame._sn : t_msg->_body._fragment._sn;
+}
+
+// Consumes the network messages of a frame that is not delivered, fragments are consumed when decoded
+static void __z_reliability_skip(_z_transport_message_t *t_msg) {
+    if ((_Z_MID(t_msg->_header) == _Z_MID_T_FRAME) && (t_msg->_body._frame._payload != NULL)) {
+        _z_zbuf_t *zbf = t_msg->_body._frame._payload;
+        _z_zbuf_set_rpos(zbf, _z_zbuf_get_wpos(zbf));
+    }
+}
+
+static void __z_reliability_reorder_push(_z_reliability_reorder_t *r, _z_transport_message_t *t_msg, _z_zint_t sn) {
+    const uint8_t *start = NULL;
+    size_t len = 0;
+    _z_n_qos_t qos;
+    if (_Z_MID(t_msg->_header) == _Z_MID_T_FRAME) {
+        if (t_msg->_body._frame._payload != NULL) {
+            start = _z_zbuf_get_rptr(t_msg->_body._frame._payload);
+            len = _z_zbuf_len(t_msg->_body._frame._payload);
+        }
+        qos = t_msg->_body._frame._ext_qos;
+    } else {
+        start = t_msg->_body._fragment._payload.start;
+        len = t_msg->_body._fragment._payload.len;
+        qos = t_msg->_body._fragment._ext_qos;
+    }
+
+    uint8_t *buf = (uint8_t *)zp_malloc((len > (size_t)0) ? len : (size_t)1);
+    if (buf != NULL) {
+        _z_reliability_pending_t *p = &r->_slots[sn % (_z_zint_t)Z_RELIABILITY_REORDER_SIZE];
+        if (p->_is_used == true) {
+            zp_free(p->_buf);
+            r->_len = r->_len - (size_t)1;
+        }
+        if (len > (size_t)0) {
+            (void)memcpy(buf, start, len);
+        }
+        p->_buf = buf;
+        p->_len = len;
+        p->_sn = sn;
+        p->_qos = qos;
+        p->_header = t_msg->_header;
+        p->_is_used = true;
+        r->_len = r->_len + (size_t)1;
+    } else {
+        // Dropped as if lost, it is retransmitted once requested again
+        _Z_INFO("Unable to buffer the out of order SN %ju", (uintmax_t)sn);
+    }
+    __z_reliability_skip(t_msg);
+}
+
+// Delivers a buffered frame or fragment and releases its slot
+static int8_t __z_reliability_reorder_pop(_z_reliability_reorder_t *r, _z_reliability_pending_t *p,
+                                          _z_reliability_deliver_f deliver, void *arg) {
+    _z_transport_message_t t_msg;
+    t_msg._header = p->_header;
+    _z_zbuf_t zbf = _z_zbytes_as_zbuf(_z_bytes_wrap(p->_buf, p->_len));
+    if (_Z_MID(p->_header) == _Z_MID_T_FRAME) {
+        t_msg._body._frame = (_z_t_msg_frame_t){0};
+        t_msg._body._frame._payload = &zbf;
+        t_msg._body._frame._sn = p->_sn;
+        t_msg._body._frame._ext_qos = p->_qos;
+    } else {
+        t_msg._body._fragment._payload = _z_bytes_wrap(p->_buf, p->_len);
+        t_msg._body._fragment._sn = p->_sn;
+        t_msg._body._fragment._ext_qos = p->_qos;
+    }
+    int8_t ret = deliver(arg, &t_msg, true);
+
+    zp_free(p->_buf);
+    p->_buf = NULL;
+    p->_is_used = false;
+    r->_len = r->_len - (size_t)1;
+    r->_unacked = r->_unacked + (size_t)1;
+    return ret;
+}
+
+// Delivers the buffered frames and fragments that follow the last delivered one
+static void __z_reliability_reorder_drain(_z_reliability_reorder_t *r, _z_zint_t sn_res, _z_zint_t *last,
+                                          _z_reliability_deliver_f deliver, void *arg) {
+    _z_reliability_pending_t *p = __z_reliability_reorder_get(r, _z_sn_increment(sn_res, *last));
+    while (p != NULL) {
+        *last = p->_sn;
+        (void)__z_reliability_reorder_pop(r, p, deliver, arg);
+        p = __z_reliability_reorder_get(r, _z_sn_increment(sn_res, *last));
+    }
+}
+
+// Gives up the missing frames and fragments, delivering the buffered ones in order
+static void __z_reliability_reorder_flush(_z_reliability_reorder_t *r, _z_zint_t sn_res, _z_zint_t *last,
+                                          _z_reliability_deliver_f deliver, void *arg) {
+    _Bool gap = false;
+    _z_zint_t cur = *last;
+    for (size_t i = 0; (i < (size_t)Z_RELIABILITY_REORDER_SIZE) && (r->_len > (size_t)0); i++) {
+        cur = _z_sn_increment(sn_res, cur);
+        _z_reliability_pending_t *p = __z_reliability_reorder_get(r, cur);
+        if (p != NULL) {
+            if (gap == true) {
+                (void)deliver(arg, NULL, false);
+                gap = false;
+            }
+            *last = cur;
+            (void)__z_reliability_reorder_pop(r, p, deliver, arg);
+        } else {
+            gap = true;
+        }
+    }
+    _z_reliability_reorder_reset(r);
+}
+
+_Bool _z_reliability_reorder_missing(const _z_reliability_reorder_t *r, _z_zint_t sn_res, _z_zint_t last,
+                                     _z_zint_t upto, _z_zint_t *sn, _z_zint_t *mask) {
+    _Bool ret = _z_sn_precedes(sn_res, last, upto);
+    if (ret == true) {
+        // The SN following the last delivered one is always missing, or it would have been delivered
+        *sn = _z_sn_increment(sn_res, last);
+        *mask = 0;
+        _z_zint_t cur = *sn;
+        for (size_t i = 0; (i < sizeof(_z_zint_t) * (size_t)8) && (cur != upto); i++) {
+            cur = _z_sn_increment(sn_res, cur);
+            if (__z_reliability_reorder_get(r, cur) == NULL) {
+                *mask = *mask | ((_z_zint_t)1 << i);
+            }
+        }
+    }
+    return ret;
+}
+
+_Bool _z_reliability_reorder_recv(_z_reliability_reorder_t *r, _z_zint_t sn_res, _z_zint_t *last,
+                                  _z_transport_message_t *t_msg, _z_reliability_deliver_f deliver, void *arg,
+                                  _z_zint_t *sn, _z_zint_t *mask) {
+    _Bool nack = false;
+
+    _z_zint_t msn = __z_reliability_sn(t_msg);
+    _z_zint_t next = _z_sn_increment(sn_res, *last);
+    if (msn == next) {
+        *last = msn;
+        (void)deliver(arg, t_msg, false);
+        r->_unacked = r->_unacked + (size_t)1;
+        __z_reliability_reorder_drain(r, sn_res, last, deliver, arg);
+    } else if ((_z_sn_precedes(sn_res, *last, msn) == false) || (__z_reliability_reorder_get(r, msn) != NULL)) {
+        // A retransmission whose acknowledgment got lost, acknowledge again right away
+        _Z_DEBUG("Dropping the duplicate SN %ju", (uintmax_t)msn);
+        __z_reliability_skip(t_msg);
+        r->_unacked = _Z_RELIABILITY_ACK_THRESHOLD;
+    } else if (((msn - next) & sn_res) < (_z_zint_t)Z_RELIABILITY_REORDER_SIZE) {
+        // Only a frame or fragment that opens a new gap triggers a NACK, not the ones that follow it
+        _Bool is_new_gap = (r->_len == (size_t)0) || (_z_sn_precedes(sn_res, _z_sn_increment(sn_res, r->_high), msn));
+        if ((r->_len == (size_t)0) || (_z_sn_precedes(sn_res, r->_high, msn) == true)) {
+            r->_high = msn;
+        }
+        __z_reliability_reorder_push(r, t_msg, msn);
+        if (is_new_gap == true) {
+            nack = _z_reliability_reorder_missing(r, sn_res, *last, _z_sn_decrement(sn_res, msn), sn, mask);
+        }
+    } else {
+        // Too far ahead to wait for the missing ones
+        _Z_INFO("Giving up the SNs missing before %ju", (uintmax_t)msn);
+        __z_reliability_reorder_flush(r, sn_res, last, deliver, arg);
+        (void)deliver(arg, NULL, false);
+        *last = msn;
+        (void)deliver(arg, t_msg, false);
+        r->_unacked = r->_unacked + (size_t)1;
+    }
+
+    return nack;
+}
+
+#endif  // Z_FEATURE_RELIABILITY == 1
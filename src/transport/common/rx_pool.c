@@ -0,0 +1,220 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/transport/common/rx_pool.h"
+
+#include <string.h>
+
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/utils/logging.h"
+#include "zenoh-pico/utils/result.h"
+
+/*------------------ Pool ------------------*/
+_z_rx_pool_t *_z_rx_pool_new(size_t capacity) {
+    _z_rx_pool_t *pool = (_z_rx_pool_t *)zp_malloc(sizeof(_z_rx_pool_t));
+    if (pool != NULL) {
+        for (size_t i = 0; i < (size_t)Z_RX_POOL_SIZE; i++) {
+            pool->_batches[i]._buf = NULL;
+            pool->_batches[i]._capacity = capacity;
+            _z_atomic_store_explicit(&pool->_batches[i]._cnt, 0, _z_memory_order_relaxed);
+            pool->_batches[i]._pool = pool;
+        }
+        pool->_capacity = capacity;
+        _z_atomic_store_explicit(&pool->_cnt, 1, _z_memory_order_relaxed);
+    }
+    return pool;
+}
+
+void _z_rx_pool_release(_z_rx_pool_t **pool) {
+    _z_rx_pool_t *ptr = *pool;
+    if (ptr != NULL) {
+        unsigned int c = _z_atomic_fetch_sub_explicit(&ptr->_cnt, 1, _z_memory_order_release);
+        if (c == (unsigned int)1) {
+            _z_atomic_thread_fence(_z_memory_order_acquire);
+            for (size_t i = 0; i < (size_t)Z_RX_POOL_SIZE; i++) {
+                zp_free(ptr->_batches[i]._buf);
+            }
+            zp_free(ptr);
+        }
+        *pool = NULL;
+    }
+}
+
+int8_t _z_rx_pool_open(_z_rx_pool_t **pool, _z_rx_batch_t **batch, _z_zbuf_t *zbf, size_t capacity) {
+    int8_t ret = _Z_RES_OK;
+
+    *batch = NULL;
+    *pool = _z_rx_pool_new(capacity);
+    if (*pool != NULL) {
+        *batch = _z_rx_pool_acquire(*pool);
+    }
+    if (*batch != NULL) {
+        *zbf = _z_rx_batch_as_zbuf(*batch);
+    } else {
+        _z_rx_pool_release(pool);
+        *zbf = _z_zbytes_as_zbuf(_z_bytes_empty());
+        ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+
+    return ret;
+}
+
+void _z_rx_pool_close(_z_rx_pool_t **pool, _z_rx_batch_t **batch, _z_zbuf_t *zbf) {
+    _z_zbuf_clear(zbf);
+    _z_rx_batch_drop(batch);
+    _z_rx_pool_release(pool);
+}
+
+_z_rx_batch_t *_z_rx_pool_acquire(_z_rx_pool_t *pool) {
+    _z_rx_batch_t *ret = NULL;
+
+    // Only the transport takes the first reference of a batch, a free batch cannot be taken meanwhile
+    for (size_t i = 0; (ret == NULL) && (i < (size_t)Z_RX_POOL_SIZE); i++) {
+        _z_rx_batch_t *b = &pool->_batches[i];
+        if (_z_atomic_load_explicit(&b->_cnt, _z_memory_order_acquire) == (unsigned int)0) {
+            if (b->_buf == NULL) {
+                b->_buf = (uint8_t *)zp_malloc(b->_capacity);
+            }
+            if (b->_buf != NULL) {
+                _z_atomic_store_explicit(&b->_cnt, 1, _z_memory_order_relaxed);
+                _z_atomic_fetch_add_explicit(&pool->_cnt, 1, _z_memory_order_relaxed);
+                ret = b;
+            }
+        }
+    }
+
+    // All the batches are retained, allocate one with its buffer that is freed with its last reference
+    if (ret == NULL) {
+        _Z_DEBUG("RX pool exhausted, allocating a batch");
+        ret = (_z_rx_batch_t *)zp_malloc(sizeof(_z_rx_batch_t) + pool->_capacity);
+        if (ret != NULL) {
+            ret->_buf = (uint8_t *)&ret[1];
+            ret->_capacity = pool->_capacity;
+            _z_atomic_store_explicit(&ret->_cnt, 1, _z_memory_order_relaxed);
+            ret->_pool = NULL;
+        }
+    }
+
+    return ret;
+}
+
+int8_t _z_rx_pool_renew(_z_rx_pool_t *pool, _z_rx_batch_t **batch, _z_zbuf_t *zbf) {
+    int8_t ret = _Z_RES_OK;
+
+    if (_z_rx_batch_is_retained(*batch) == true) {
+        _z_rx_batch_t *b = _z_rx_pool_acquire(pool);
+        if (b != NULL) {
+            // Only the bytes yet to be read are moved, the retained ones stay in the previous batch
+            size_t len = _z_zbuf_len(zbf);
+            (void)memcpy(b->_buf, _z_zbuf_get_rptr(zbf), len);
+            *zbf = _z_rx_batch_as_zbuf(b);
+            _z_zbuf_set_wpos(zbf, len);
+            _z_rx_batch_drop(batch);
+            *batch = b;
+        } else {
+            ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+        }
+    }
+
+    return ret;
+}
+
+/*------------------ Batch ------------------*/
+_z_zbuf_t _z_rx_batch_as_zbuf(const _z_rx_batch_t *batch) {
+    return (_z_zbuf_t){._ios = _z_iosli_wrap(batch->_buf, batch->_capacity, 0, 0)};
+}
+
+_Bool _z_rx_batch_contains(const _z_rx_batch_t *batch, const uint8_t *start, size_t len) {
+    _Bool ret = false;
+    if ((batch != NULL) && (start != NULL)) {
+        uintptr_t base = (uintptr_t)batch->_buf;
+        uintptr_t p = (uintptr_t)start;
+        ret = (p >= base) && (len <= batch->_capacity) && ((p - base) <= (batch->_capacity - len));
+    }
+    return ret;
+}
+
+_Bool _z_rx_batch_is_retained(const _z_rx_batch_t *batch) {
+    // Acquire the reads of the payloads dropped meanwhile, before the batch is written again
+    return _z_atomic_load_explicit(&batch->_cnt, _z_memory_order_acquire) > (unsigned int)1;
+}
+
+_z_rx_batch_t *_z_rx_batch_clone(_z_rx_batch_t *batch) {
+    _z_atomic_fetch_add_explicit(&batch->_cnt, 1, _z_memory_order_relaxed);
+    return batch;
+}
+
+void _z_rx_batch_drop(_z_rx_batch_t **batch) {
+    _z_rx_batch_t *ptr = *batch;
+    if (ptr != NULL) {
+        unsigned int c = _z_atomic_fetch_sub_explicit(&ptr->_cnt, 1, _z_memory_order_release);
+        if (c == (unsigned int)1) {
+            _z_atomic_thread_fence(_z_memory_order_acquire);
+            if (ptr->_pool != NULL) {
+                // The batch is back in the pool, which may be the last user of the pool once the transport is closed
+                _z_rx_pool_t *pool = ptr->_pool;
+                _z_rx_pool_release(&pool);
+            } else {
+                zp_free(ptr);
+            }
+        }
+        *batch = NULL;
+    }
+}
+
+/*------------------ Payload ------------------*/
+int8_t _z_rx_payload_retain(_z_rx_payload_t *dst, const _z_bytes_t *payload, _z_rx_batch_t *batch) {
+    int8_t ret = _Z_RES_OK;
+
+    if ((payload->len >= (size_t)Z_RX_POOL_RETAIN_MIN_SIZE) &&
+        (_z_rx_batch_contains(batch, payload->start, payload->len) == true)) {
+        dst->_bytes = _z_bytes_wrap(payload->start, payload->len);
+        dst->_batch = _z_rx_batch_clone(batch);
+    } else {
+        // Small payloads are copied rather than keeping a whole batch from being reused
+        dst->_batch = NULL;
+        _z_bytes_copy(&dst->_bytes, payload);
+        if ((dst->_bytes.start == NULL) && (payload->len > (size_t)0)) {
+            ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+        }
+    }
+
+    return ret;
+}
+
+void _z_rx_payload_copy(_z_rx_payload_t *dst, const _z_rx_payload_t *src) {
+    if (src->_batch != NULL) {
+        dst->_bytes = _z_bytes_wrap(src->_bytes.start, src->_bytes.len);
+        dst->_batch = _z_rx_batch_clone(src->_batch);
+    } else {
+        dst->_batch = NULL;
+        _z_bytes_copy(&dst->_bytes, &src->_bytes);
+    }
+}
+
+void _z_rx_payload_clear(_z_rx_payload_t *payload) {
+    _z_bytes_clear(&payload->_bytes);
+    _z_rx_batch_drop(&payload->_batch);
+}
+
+void _z_rx_payload_free(_z_rx_payload_t **payload) {
+    _z_rx_payload_t *ptr = *payload;
+
+    if (ptr != NULL) {
+        _z_rx_payload_clear(ptr);
+
+        zp_free(ptr);
+        *payload = NULL;
+    }
+}
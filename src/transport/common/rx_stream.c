@@ -0,0 +1,94 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/transport/common/rx_stream.h"
+
+#include "zenoh-pico/protocol/definitions/core.h"
+#include "zenoh-pico/utils/result.h"
+
+void _z_rx_stream_reset(_z_rx_stream_t *rxs) {
+    rxs->_len = 0;
+    rxs->_has_len = false;
+}
+
+// Makes sure that len bytes can be held from the read position of the zbuf
+static void _z_rx_stream_reserve(_z_zbuf_t *zbf, size_t len) {
+    if (_z_zbuf_len(zbf) == (size_t)0) {
+        // Nothing is pending, start over at the beginning of the buffer without moving any byte
+        _z_zbuf_reset(zbf);
+    } else if ((_z_zbuf_get_rpos(zbf) + len) > _z_zbuf_capacity(zbf)) {
+        // Wrap around, only the bytes of the partial batch are moved
+        _z_zbuf_compact(zbf);
+    }
+}
+
+int8_t _z_rx_stream_recv(_z_rx_stream_t *rxs, const _z_link_t *link, _z_zbuf_t *zbf, _z_bytes_t *addr, size_t *len) {
+    int8_t ret = _Z_RES_OK;
+
+    // A single read per call, so that a call does not block once the link has been reported readable
+    _Bool received = false;
+    if (rxs->_has_len == false) {
+        if (_z_zbuf_len(zbf) < (size_t)_Z_MSG_LEN_ENC_SIZE) {
+            _z_rx_stream_reserve(zbf, _Z_MSG_LEN_ENC_SIZE);
+            (void)_z_link_recv_zbuf(link, zbf, addr);
+            received = true;
+        }
+        if (_z_zbuf_len(zbf) >= (size_t)_Z_MSG_LEN_ENC_SIZE) {
+            rxs->_len = 0;
+            for (uint8_t i = 0; i < (uint8_t)_Z_MSG_LEN_ENC_SIZE; i++) {
+                rxs->_len |= (size_t)_z_zbuf_read(zbf) << (i * (uint8_t)8);
+            }
+            rxs->_has_len = true;
+        } else {
+            ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
+        }
+    }
+
+    if (ret == _Z_RES_OK) {
+        if (rxs->_len > _z_zbuf_capacity(zbf)) {
+            ret = _Z_ERR_TRANSPORT_NO_SPACE;
+        } else if (_z_zbuf_len(zbf) < rxs->_len) {
+            _z_rx_stream_reserve(zbf, rxs->_len);
+            if (received == false) {
+                (void)_z_link_recv_zbuf(link, zbf, NULL);
+            }
+            if (_z_zbuf_len(zbf) < rxs->_len) {
+                ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
+            }
+        }
+    }
+
+    if (ret == _Z_RES_OK) {
+        *len = rxs->_len;
+        _z_rx_stream_reset(rxs);
+    }
+
+    return ret;
+}
+
+_Bool _z_rx_stream_ready(const _z_rx_stream_t *rxs, const _z_zbuf_t *zbf) {
+    _Bool ret = false;
+    size_t avail = _z_zbuf_len(zbf);
+    if (rxs->_has_len == true) {
+        ret = avail >= rxs->_len;
+    } else if (avail >= (size_t)_Z_MSG_LEN_ENC_SIZE) {
+        const uint8_t *prefix = _z_zbuf_get_rptr(zbf);
+        size_t len = 0;
+        for (uint8_t i = 0; i < (uint8_t)_Z_MSG_LEN_ENC_SIZE; i++) {
+            len |= (size_t)prefix[i] << (i * (uint8_t)8);
+        }
+        ret = (avail - (size_t)_Z_MSG_LEN_ENC_SIZE) >= len;
+    }
+    return ret;
+}
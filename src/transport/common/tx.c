@@ -88,6 +88,55 @@ int8_t _z_send_t_msg(_z_transport_t *zt, const _z_transport_message_t *t_msg) {
     return ret;
 }
 
+int8_t _z_flush(_z_transport_t *zt) {
+    int8_t ret = _Z_RES_OK;
+    switch (zt->_type) {
+        case _Z_TRANSPORT_UNICAST_TYPE:
+            ret = _z_unicast_flush(&zt->_transport._unicast);
+            break;
+        // Batching only applies to unicast transports
+        case _Z_TRANSPORT_MULTICAST_TYPE:
+        case _Z_TRANSPORT_RAWETH_TYPE:
+            break;
+        default:
+            ret = _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+            break;
+    }
+    return ret;
+}
+
+_z_wbuf_t *_z_tx_slots_make(const _z_link_t *zl, size_t capacity) {
+    _z_wbuf_t *slots = NULL;
+    size_t count = _z_link_batch_max(zl);
+    if (count > (size_t)1) {
+        slots = (_z_wbuf_t *)zp_malloc(count * sizeof(_z_wbuf_t));
+    }
+    if (slots != NULL) {
+        _Bool failed = false;
+        for (size_t i = 0; i < count; i++) {
+            slots[i] = _z_wbuf_make(capacity, false);
+            if (_z_wbuf_capacity(&slots[i]) != capacity) {
+                failed = true;
+            }
+        }
+        if (failed == true) {
+            _z_tx_slots_free(&slots, zl);
+        }
+    }
+    return slots;
+}
+
+void _z_tx_slots_free(_z_wbuf_t **slots, const _z_link_t *zl) {
+    _z_wbuf_t *ptr = *slots;
+    if (ptr != NULL) {
+        for (size_t i = 0; i < _z_link_batch_max(zl); i++) {
+            _z_wbuf_clear(&ptr[i]);
+        }
+        zp_free(ptr);
+        *slots = NULL;
+    }
+}
+
 int8_t _z_link_send_t_msg(const _z_link_t *zl, const _z_transport_message_t *t_msg) {
     int8_t ret = _Z_RES_OK;
 
@@ -134,7 +183,21 @@ int8_t _z_link_send_t_msg(const _z_link_t *zl, const _z_transport_message_t *t_m
     return ret;
 }
 
-int8_t __unsafe_z_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, z_reliability_t reliability, size_t sn) {
+static size_t __z_wbuf_len_refs(const _z_wbuf_t *wbf, size_t max_refs) {
+    size_t len = 0;
+    size_t refs = 0;
+    for (size_t i = wbf->_r_idx; (i <= wbf->_w_idx) && (refs < max_refs); i++) {
+        size_t readable = _z_iosli_readable(_z_wbuf_get_iosli(wbf, i));
+        if (readable > (size_t)0) {
+            len = len + readable;
+            refs = refs + (size_t)1;
+        }
+    }
+    return len;
+}
+
+int8_t __unsafe_z_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, z_reliability_t reliability, size_t sn,
+                                           _z_n_qos_t qos, size_t max_refs) {
     int8_t ret = _Z_RES_OK;
 
     // Assume first that this is not the final fragment
@@ -143,11 +206,16 @@ int8_t __unsafe_z_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, z_rel
         size_t w_pos = _z_wbuf_get_wpos(dst);  // Mark the buffer for the writing operation
 
         _z_transport_message_t f_hdr =
-            _z_t_msg_make_fragment_header(sn, reliability == Z_RELIABILITY_RELIABLE, is_final);
+            _z_t_msg_make_fragment_header(sn, reliability == Z_RELIABILITY_RELIABLE, is_final, qos);
         ret = _z_transport_message_encode(dst, &f_hdr);  // Encode the frame header
         if (ret == _Z_RES_OK) {
             size_t space_left = _z_wbuf_space_left(dst);
             size_t bytes_left = _z_wbuf_len(src);
+            if (max_refs > (size_t)0) {
+                // The fragment is also bounded by the number of slices that can be referenced
+                size_t refs_len = __z_wbuf_len_refs(src, max_refs);
+                space_left = (refs_len < space_left) ? refs_len : space_left;
+            }
 
             if ((is_final == false) && (bytes_left <= space_left)) {  // Check if it is really the final fragment
                 _z_wbuf_set_wpos(dst, w_pos);                         // Revert the buffer
@@ -156,7 +224,11 @@ int8_t __unsafe_z_serialize_zenoh_fragment(_z_wbuf_t *dst, _z_wbuf_t *src, z_rel
             }
 
             size_t to_copy = (bytes_left <= space_left) ? bytes_left : space_left;  // Compute bytes to write
-            ret = _z_wbuf_siphon(dst, src, to_copy);                                // Write the fragment
+            if (max_refs > (size_t)0) {
+                ret = _z_wbuf_siphon_ref(dst, src, to_copy);  // Reference the fragment, it is sent with a vectored write
+            } else {
+                ret = _z_wbuf_siphon(dst, src, to_copy);  // Write the fragment
+            }
         }
         break;
     } while (1);
@@ -0,0 +1,281 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/transport/common/tx_queue.h"
+
+#include <string.h>
+
+#include "zenoh-pico/protocol/codec/network.h"
+#include "zenoh-pico/protocol/iobuf.h"
+#include "zenoh-pico/utils/logging.h"
+#include "zenoh-pico/utils/pointers.h"
+#include "zenoh-pico/utils/result.h"
+
+#if Z_FEATURE_MULTI_THREAD == 1
+
+/*------------------ Entries ------------------*/
+static _z_tx_entry_t *__z_tx_entry_make(const _z_wbuf_t *wbf, z_reliability_t reliability, uint8_t lane) {
+    // The encoded message is copied right after the entry, the payloads are no longer referenced once queued
+    size_t len = _z_wbuf_len(wbf);
+    _z_tx_entry_t *e = (_z_tx_entry_t *)zp_malloc(sizeof(_z_tx_entry_t) + len);
+    if (e != NULL) {
+        e->_buf = (uint8_t *)&e[1];
+        e->_len = len;
+        e->_reliability = reliability;
+        e->_lane = lane;
+
+        size_t pos = 0;
+        for (size_t i = wbf->_r_idx; i <= wbf->_w_idx; i++) {
+            _z_iosli_t *ios = _z_wbuf_get_iosli(wbf, i);
+            size_t readable = _z_iosli_readable(ios);
+            if (readable > (size_t)0) {
+                (void)memcpy(&e->_buf[pos], _z_ptr_u8_offset(ios->_buf, (ptrdiff_t)ios->_r_pos), readable);
+                pos = pos + readable;
+            }
+        }
+    }
+    return e;
+}
+
+void _z_tx_entry_free(_z_tx_entry_t **e) {
+    zp_free(*e);
+    *e = NULL;
+}
+
+/*------------------ Queue ------------------*/
+void _z_tx_queue_null(_z_tx_queue_t *q) {
+    (void)_z_tx_entry_mpsc_init(&q->_entries, 0);
+    _z_atomic_store_explicit(&q->_bytes, (size_t)0, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&q->_congested, false, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&q->_closed, true, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&q->_task_waiting, false, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&q->_pushing, (size_t)0, _z_memory_order_relaxed);
+    q->_blocked = 0;
+#if Z_FEATURE_STATS == 1
+    q->_stats = NULL;
+#endif  // Z_FEATURE_STATS == 1
+}
+
+int8_t _z_tx_queue_open(_z_tx_queue_t *q) {
+    int8_t ret = _Z_RES_OK;
+
+    // The queue is allocated on the first opening and kept until the transport is cleared
+    if (q->_entries._slots == NULL) {
+        ret = _z_tx_entry_mpsc_init(&q->_entries, Z_TX_QUEUE_SIZE);
+        if (ret == _Z_RES_OK) {
+            ret = zp_mutex_init(&q->_mutex);
+            if (ret == _Z_RES_OK) {
+                ret = zp_condvar_init(&q->_cv_task);
+                if (ret == _Z_RES_OK) {
+                    ret = zp_condvar_init(&q->_cv_producers);
+                    if (ret != _Z_RES_OK) {
+                        zp_condvar_free(&q->_cv_task);
+                    }
+                }
+                if (ret != _Z_RES_OK) {
+                    zp_mutex_free(&q->_mutex);
+                }
+            }
+            if (ret != _Z_RES_OK) {
+                _z_tx_entry_mpsc_clear(&q->_entries);
+            }
+        }
+    }
+
+    if (ret == _Z_RES_OK) {
+        _z_atomic_store_explicit(&q->_congested, false, _z_memory_order_relaxed);
+        _z_atomic_store_explicit(&q->_closed, false, _z_memory_order_release);
+    }
+    return ret;
+}
+
+void _z_tx_queue_close(_z_tx_queue_t *q) {
+    if (q->_entries._slots != NULL) {
+        _z_atomic_store_explicit(&q->_closed, true, _z_memory_order_seq_cst);
+        // Wake up the TX task so that it drains the queue, and the blocked publishers
+        zp_mutex_lock(&q->_mutex);
+        zp_condvar_signal(&q->_cv_task);
+        if (q->_blocked > (size_t)0) {
+            zp_condvar_signal(&q->_cv_producers);
+        }
+        zp_mutex_unlock(&q->_mutex);
+    }
+}
+
+_Bool _z_tx_queue_is_closed(const _z_tx_queue_t *q) {
+    return _z_atomic_load_explicit((_z_atomic(_Bool) *)&q->_closed, _z_memory_order_seq_cst);
+}
+
+void _z_tx_queue_clear(_z_tx_queue_t *q) {
+    if (q->_entries._slots != NULL) {
+        // The TX task drains the queue before stopping, only the messages queued while it was not running are left
+        _z_tx_entry_mpsc_clear(&q->_entries);
+        zp_condvar_free(&q->_cv_producers);
+        zp_condvar_free(&q->_cv_task);
+        zp_mutex_free(&q->_mutex);
+    }
+    _z_tx_queue_null(q);
+}
+
+static _Bool __z_tx_queue_is_drained(const _z_tx_queue_t *q) {
+    size_t bytes = _z_atomic_load_explicit((_z_atomic(size_t) *)&q->_bytes, _z_memory_order_seq_cst);
+    return (bytes <= (size_t)Z_TX_QUEUE_LOW_WATERMARK) &&
+           (_z_tx_entry_mpsc_len(&q->_entries) <= (_z_tx_entry_mpsc_capacity(&q->_entries) / (size_t)2));
+}
+
+static void __z_tx_queue_decongest(_z_tx_queue_t *q) {
+    zp_mutex_lock(&q->_mutex);
+    if ((_z_atomic_load_explicit(&q->_congested, _z_memory_order_relaxed) == true) &&
+        (__z_tx_queue_is_drained(q) == true)) {
+        _z_atomic_store_explicit(&q->_congested, false, _z_memory_order_seq_cst);
+        if (q->_blocked > (size_t)0) {
+            zp_condvar_signal(&q->_cv_producers);
+        }
+    }
+    zp_mutex_unlock(&q->_mutex);
+}
+
+static void __z_tx_queue_congest(_z_tx_queue_t *q) {
+    zp_mutex_lock(&q->_mutex);
+    _z_atomic_store_explicit(&q->_congested, true, _z_memory_order_seq_cst);
+    zp_mutex_unlock(&q->_mutex);
+    // The TX task may have drained the queue before it could see the congestion
+    __z_tx_queue_decongest(q);
+}
+
+static void __z_tx_queue_wait_decongested(_z_tx_queue_t *q) {
+    zp_mutex_lock(&q->_mutex);
+    q->_blocked = q->_blocked + (size_t)1;
+    while ((_z_atomic_load_explicit(&q->_congested, _z_memory_order_seq_cst) == true) &&
+           (_z_tx_queue_is_closed(q) == false)) {
+        zp_condvar_wait(&q->_cv_producers, &q->_mutex);
+    }
+    q->_blocked = q->_blocked - (size_t)1;
+    // Only one publisher is woken up at a time, pass the wake up on to the next one
+    if (q->_blocked > (size_t)0) {
+        zp_condvar_signal(&q->_cv_producers);
+    }
+    zp_mutex_unlock(&q->_mutex);
+}
+
+static void __z_tx_queue_signal_task(_z_tx_queue_t *q) {
+    // Pairs with the fence of the TX task: either it sees the update, or we see it waiting
+    _z_atomic_thread_fence(_z_memory_order_seq_cst);
+    if (_z_atomic_load_explicit(&q->_task_waiting, _z_memory_order_relaxed) == true) {
+        zp_mutex_lock(&q->_mutex);
+        zp_condvar_signal(&q->_cv_task);
+        zp_mutex_unlock(&q->_mutex);
+    }
+}
+
+int8_t _z_tx_queue_push(_z_tx_queue_t *q, const _z_network_message_t *n_msg, z_reliability_t reliability,
+                        uint8_t lane, z_congestion_control_t cong_ctrl) {
+    int8_t ret = _Z_RES_OK;
+    // Counted before checking that the queue is open: either the TX task waits for this push, or we see it closed
+    _z_atomic_fetch_add_explicit(&q->_pushing, (size_t)1, _z_memory_order_seq_cst);
+    if (_z_tx_queue_is_closed(q) == true) {
+        ret = _Z_ERR_CONNECTION_CLOSED;
+    }
+
+    _z_tx_entry_t *e = NULL;
+    if (ret == _Z_RES_OK) {
+        // Encode the message without holding any lock, the expandable buffer references the large payloads
+        _z_wbuf_t wbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+        ret = _z_network_message_encode(&wbf, n_msg);
+        if (ret == _Z_RES_OK) {
+            e = __z_tx_entry_make(&wbf, reliability, lane);
+            if (e == NULL) {
+                ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+            }
+        }
+        _z_wbuf_clear(&wbf);
+    }
+
+    while (e != NULL) {
+        if (_z_tx_queue_is_closed(q) == true) {
+            ret = _Z_ERR_CONNECTION_CLOSED;
+            _z_tx_entry_free(&e);
+        } else if (_z_atomic_load_explicit(&q->_congested, _z_memory_order_seq_cst) == true) {
+            if (cong_ctrl == Z_CONGESTION_CONTROL_DROP) {
+                _Z_INFO("Dropping zenoh message because of congestion control");
+#if Z_FEATURE_STATS == 1
+                if (q->_stats != NULL) {
+                    _Z_STATS_INC(q->_stats, _Z_STATS_TX_CONGESTION_DROPS);
+                }
+#endif  // Z_FEATURE_STATS == 1
+                _z_tx_entry_free(&e);
+            } else {
+                __z_tx_queue_wait_decongested(q);
+            }
+        } else {
+            size_t len = e->_len;
+            e = _z_tx_entry_mpsc_push(&q->_entries, e);
+            if (e == NULL) {
+                size_t bytes = _z_atomic_fetch_add_explicit(&q->_bytes, len, _z_memory_order_seq_cst) + len;
+                if (bytes >= (size_t)Z_TX_QUEUE_HIGH_WATERMARK) {
+                    __z_tx_queue_congest(q);
+                }
+                __z_tx_queue_signal_task(q);
+            } else {
+                // All the slots are taken, the message is retried according to the congestion control
+                __z_tx_queue_congest(q);
+            }
+        }
+    }
+
+    _z_atomic_fetch_sub_explicit(&q->_pushing, (size_t)1, _z_memory_order_seq_cst);
+    if (_z_tx_queue_is_closed(q) == true) {
+        // The TX task may wait for this push to be over before stopping
+        __z_tx_queue_signal_task(q);
+    }
+
+    return ret;
+}
+
+_z_tx_entry_t *_z_tx_queue_pull(_z_tx_queue_t *q) {
+    _z_tx_entry_t *e = _z_tx_entry_mpsc_pull(&q->_entries);
+    if (e != NULL) {
+        _z_atomic_fetch_sub_explicit(&q->_bytes, e->_len, _z_memory_order_seq_cst);
+        // Pairs with the congestion of the publishers: either they see the queue drained, or we see it congested
+        _z_atomic_thread_fence(_z_memory_order_seq_cst);
+        if (_z_atomic_load_explicit(&q->_congested, _z_memory_order_seq_cst) == true) {
+            __z_tx_queue_decongest(q);
+        }
+    }
+    return e;
+}
+
+void _z_tx_queue_wait(_z_tx_queue_t *q) {
+    zp_mutex_lock(&q->_mutex);
+    _z_atomic_store_explicit(&q->_task_waiting, true, _z_memory_order_relaxed);
+    _z_atomic_thread_fence(_z_memory_order_seq_cst);
+    // Check again under the mutex, a wake up can only be signaled once we wait on the condition variable. A slot
+    // reserved by a publisher cannot be pulled until its message is published, which signals us as well.
+    if ((_z_tx_entry_mpsc_can_pull(&q->_entries) == false) &&
+        ((_z_tx_queue_is_closed(q) == false) ||
+         (_z_atomic_load_explicit(&q->_pushing, _z_memory_order_seq_cst) > (size_t)0))) {
+        zp_condvar_wait(&q->_cv_task, &q->_mutex);
+    }
+    _z_atomic_store_explicit(&q->_task_waiting, false, _z_memory_order_relaxed);
+    zp_mutex_unlock(&q->_mutex);
+}
+
+_Bool _z_tx_queue_is_done(const _z_tx_queue_t *q) {
+    // Once closed, a publisher that is not counted yet sees the queue closed and sends its message directly
+    return (_z_tx_queue_is_closed(q) == true) &&
+           (_z_atomic_load_explicit((_z_atomic(size_t) *)&q->_pushing, _z_memory_order_seq_cst) == (size_t)0) &&
+           (_z_tx_entry_mpsc_is_empty(&q->_entries) == true);
+}
+
+#endif  // Z_FEATURE_MULTI_THREAD == 1
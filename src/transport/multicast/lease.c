@@ -17,41 +17,28 @@
 #include <stddef.h>
 
 #include "zenoh-pico/config.h"
+#include "zenoh-pico/session/matching.h"
+#include "zenoh-pico/session/query.h"
+#include "zenoh-pico/session/resource.h"
 #include "zenoh-pico/session/utils.h"
 #include "zenoh-pico/transport/common/lease.h"
+#include "zenoh-pico/transport/utils.h"
 #include "zenoh-pico/utils/logging.h"
 
+_z_zint_t _zp_multicast_lease_now(_z_transport_multicast_t *ztm) {
+    return (_z_zint_t)zp_clock_elapsed_ms(&ztm->_lease_epoch);
+}
+
 #if Z_FEATURE_MULTICAST_TRANSPORT == 1 || Z_FEATURE_RAWETH_TRANSPORT == 1
 
-static _z_zint_t _z_get_minimum_lease(_z_transport_peer_entry_list_t *peers, _z_zint_t local_lease) {
+static _z_zint_t _z_get_minimum_lease(const _z_transport_peer_table_t *peers, _z_zint_t local_lease) {
     _z_zint_t ret = local_lease;
 
-    _z_transport_peer_entry_list_t *it = peers;
-    while (it != NULL) {
-        _z_transport_peer_entry_t *val = _z_transport_peer_entry_list_head(it);
-        _z_zint_t lease = val->_lease;
+    for (size_t i = 0; i < peers->_len; i++) {
+        _z_zint_t lease = peers->_by_lease[i]->_lease;
         if (lease < ret) {
             ret = lease;
         }
-
-        it = _z_transport_peer_entry_list_tail(it);
-    }
-
-    return ret;
-}
-
-static _z_zint_t _z_get_next_lease(_z_transport_peer_entry_list_t *peers) {
-    _z_zint_t ret = SIZE_MAX;
-
-    _z_transport_peer_entry_list_t *it = peers;
-    while (it != NULL) {
-        _z_transport_peer_entry_t *val = _z_transport_peer_entry_list_head(it);
-        _z_zint_t next_lease = val->_next_lease;
-        if (next_lease < ret) {
-            ret = next_lease;
-        }
-
-        it = _z_transport_peer_entry_list_tail(it);
     }
 
     return ret;
@@ -59,21 +46,122 @@ static _z_zint_t _z_get_next_lease(_z_transport_peer_entry_list_t *peers) {
 
 int8_t _zp_multicast_send_join(_z_transport_multicast_t *ztm) {
     _z_conduit_sn_list_t next_sn;
-    next_sn._is_qos = false;
-    next_sn._val._plain._best_effort = ztm->_sn_tx_best_effort;
-    next_sn._val._plain._reliable = ztm->_sn_tx_reliable;
+    _z_conduit_sn_list_copy(&next_sn, &ztm->_sn_tx_sns);
 
     _z_id_t zid = ((_z_session_t *)ztm->_session)->_local_zid;
     _z_transport_message_t jsm = _z_t_msg_make_join(Z_WHATAMI_PEER, Z_TRANSPORT_LEASE, zid, next_sn);
+#if Z_FEATURE_RELIABILITY == 1
+    if (ztm->_tx_window != NULL) {
+        jsm._body._join._ext_reliability = true;
+        _Z_SET_FLAG(jsm._header, _Z_FLAG_T_Z);
+    }
+#endif  // Z_FEATURE_RELIABILITY == 1
 
-    return ztm->_send_f(ztm, &jsm);
+    int8_t ret = ztm->_send_f(ztm, &jsm);
+    if (ret == _Z_RES_OK) {
+        // Peers only learn the key expression ids from the declarations, repeat them for the late joiners
+        ret = _z_send_resource_declarations((_z_session_t *)ztm->_session, ztm);
+    }
+    return ret;
 }
 
 int8_t _zp_multicast_send_keep_alive(_z_transport_multicast_t *ztm) {
     _z_transport_message_t t_msg = _z_t_msg_make_keep_alive();
-    return ztm->_send_f(ztm, &t_msg);
+    int8_t ret = ztm->_send_f(ztm, &t_msg);
+    if (ret == _Z_RES_OK) {
+        _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_KEEP_ALIVES);
+    }
+    return ret;
 }
 
+void _zp_multicast_lease_start(_z_transport_multicast_t *ztm) {
+    ztm->_transmitted = false;
+
+    // All the deadlines are absolute, in milliseconds on the lease clock of the transport
+    _z_zint_t now = _zp_multicast_lease_now(ztm);
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&ztm->_mutex_peer);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    ztm->_next_keep_alive =
+        now + (_z_zint_t)(_z_get_minimum_lease(&ztm->_peers, ztm->_lease) / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&ztm->_mutex_peer);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    ztm->_next_join = now + Z_JOIN_INTERVAL;
+}
+
+int8_t _zp_multicast_lease_step(_z_transport_multicast_t *ztm, _z_zint_t *interval) {
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&ztm->_mutex_peer);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    _z_zint_t now = _zp_multicast_lease_now(ztm);
+
+    // Only the peers whose lease expired are visited, in the order of their deadlines
+    _z_transport_peer_entry_t *entry = _z_transport_peer_table_next_lease(&ztm->_peers);
+    while ((entry != NULL) && (entry->_lease_deadline <= now)) {
+        if (entry->_received == true) {
+            // Reset the lease parameters
+            entry->_received = false;
+            _z_transport_peer_table_renew_lease(&ztm->_peers, entry, now + entry->_lease);
+        } else {
+            _Z_INFO("Remove peer from know list because it has expired after %zums", entry->_lease);
+#if Z_FEATURE_MATCHING == 1
+            _z_unregister_remote_subscriptions_for_peer((_z_session_t *)ztm->_session, entry->_peer_id);
+#endif
+            _z_unregister_resources_for_peer((_z_session_t *)ztm->_session, entry->_peer_id);
+            _z_transport_peer_table_remove(&ztm->_peers, entry);
+        }
+        entry = _z_transport_peer_table_next_lease(&ztm->_peers);
+    }
+
+    // The join is sent once the peers are released, the declarations following it may block on congestion
+    _Bool join = false;
+    if (ztm->_next_join <= now) {
+        join = true;
+        ztm->_transmitted = true;
+
+        // Reset the join parameters
+        ztm->_next_join = now + Z_JOIN_INTERVAL;
+    }
+
+    if (ztm->_next_keep_alive <= now) {
+        // Check if need to send a keep alive
+        if (ztm->_transmitted == false) {
+            if (_zp_multicast_send_keep_alive(ztm) < 0) {
+                // TODO: Handle retransmission or error
+            }
+        }
+
+        // Reset the keep alive parameters
+        ztm->_transmitted = false;
+        ztm->_next_keep_alive =
+            now + (_z_zint_t)(_z_get_minimum_lease(&ztm->_peers, ztm->_lease) / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
+    }
+
+    // Compute the target interval
+    _z_zint_t deadline = (ztm->_next_join < ztm->_next_keep_alive) ? ztm->_next_join : ztm->_next_keep_alive;
+    entry = _z_transport_peer_table_next_lease(&ztm->_peers);
+    if ((entry != NULL) && (entry->_lease_deadline < deadline)) {
+        deadline = entry->_lease_deadline;
+    }
+    *interval = (deadline > now) ? (deadline - now) : 0;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&ztm->_mutex_peer);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (join == true) {
+        _zp_multicast_send_join(ztm);
+    }
+
+#if Z_FEATURE_QUERY == 1
+    // Expire the pending queries and run in time for the next deadline
+    _z_process_query_timeouts((_z_session_t *)ztm->_session);
+    *interval = _z_get_next_query_timeout((_z_session_t *)ztm->_session, *interval);
+#endif  // Z_FEATURE_QUERY == 1
+
+    return _Z_RES_OK;
+}
 #else
 int8_t _zp_multicast_send_join(_z_transport_multicast_t *ztm) {
     _ZP_UNUSED(ztm);
@@ -84,99 +172,31 @@ int8_t _zp_multicast_send_keep_alive(_z_transport_multicast_t *ztm) {
     _ZP_UNUSED(ztm);
     return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
 }
+
+void _zp_multicast_lease_start(_z_transport_multicast_t *ztm) { _ZP_UNUSED(ztm); }
+
+int8_t _zp_multicast_lease_step(_z_transport_multicast_t *ztm, _z_zint_t *interval) {
+    _ZP_UNUSED(ztm);
+    _ZP_UNUSED(interval);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
 #endif  // Z_FEATURE_MULTICAST_TRANSPORT == 1 || Z_FEATURE_RAWETH_TRANSPORT == 1
 
 #if Z_FEATURE_MULTI_THREAD == 1 && (Z_FEATURE_MULTICAST_TRANSPORT == 1 || Z_FEATURE_RAWETH_TRANSPORT == 1)
 
 void *_zp_multicast_lease_task(void *ztm_arg) {
     _z_transport_multicast_t *ztm = (_z_transport_multicast_t *)ztm_arg;
-    ztm->_transmitted = false;
 
-    // From all peers, get the next lease time (minimum)
-    _z_zint_t next_lease = _z_get_minimum_lease(ztm->_peers, ztm->_lease);
-    _z_zint_t next_keep_alive = (_z_zint_t)(next_lease / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
-    _z_zint_t next_join = Z_JOIN_INTERVAL;
-
-    _z_transport_peer_entry_list_t *it = NULL;
+    _zp_multicast_lease_start(ztm);
     while (ztm->_lease_task_running == true) {
-        zp_mutex_lock(&ztm->_mutex_peer);
-
-        if (next_lease <= 0) {
-            it = ztm->_peers;
-            while (it != NULL) {
-                _z_transport_peer_entry_t *entry = _z_transport_peer_entry_list_head(it);
-                if (entry->_received == true) {
-                    // Reset the lease parameters
-                    entry->_received = false;
-                    entry->_next_lease = entry->_lease;
-                    it = _z_transport_peer_entry_list_tail(it);
-                } else {
-                    _Z_INFO("Remove peer from know list because it has expired after %zums", entry->_lease);
-                    ztm->_peers =
-                        _z_transport_peer_entry_list_drop_filter(ztm->_peers, _z_transport_peer_entry_eq, entry);
-                    it = ztm->_peers;
-                }
-            }
+        _z_zint_t interval = 0;
+        if (_zp_multicast_lease_step(ztm, &interval) != _Z_RES_OK) {
+            ztm->_lease_task_running = false;
+            break;
         }
 
-        if (next_join <= 0) {
-            _zp_multicast_send_join(ztm);
-            ztm->_transmitted = true;
-
-            // Reset the join parameters
-            next_join = Z_JOIN_INTERVAL;
-        }
-
-        if (next_keep_alive <= 0) {
-            // Check if need to send a keep alive
-            if (ztm->_transmitted == false) {
-                if (_zp_multicast_send_keep_alive(ztm) < 0) {
-                    // TODO: Handle retransmission or error
-                }
-            }
-
-            // Reset the keep alive parameters
-            ztm->_transmitted = false;
-            next_keep_alive =
-                (_z_zint_t)(_z_get_minimum_lease(ztm->_peers, ztm->_lease) / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
-        }
-
-        // Compute the target interval to sleep
-        _z_zint_t interval;
-        if (next_lease > 0) {
-            interval = next_lease;
-            if (next_keep_alive < interval) {
-                interval = next_keep_alive;
-            }
-            if (next_join < interval) {
-                interval = next_join;
-            }
-        } else {
-            interval = next_keep_alive;
-            if (next_join < interval) {
-                interval = next_join;
-            }
-        }
-
-        zp_mutex_unlock(&ztm->_mutex_peer);
-
         // The keep alive and lease intervals are expressed in milliseconds
         zp_sleep_ms(interval);
-
-        // Decrement all intervals
-        zp_mutex_lock(&ztm->_mutex_peer);
-
-        it = ztm->_peers;
-        while (it != NULL) {
-            _z_transport_peer_entry_t *entry = _z_transport_peer_entry_list_head(it);
-            entry->_next_lease = entry->_next_lease - interval;
-            it = _z_transport_peer_entry_list_tail(it);
-        }
-        next_lease = _z_get_next_lease(ztm->_peers);
-        next_keep_alive = next_keep_alive - interval;
-        next_join = next_join - interval;
-
-        zp_mutex_unlock(&ztm->_mutex_peer);
     }
     return 0;
 }
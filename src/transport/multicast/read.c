@@ -47,6 +47,52 @@ int8_t _zp_multicast_read(_z_transport_multicast_t *ztm) {
 
 #if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_MULTICAST_TRANSPORT == 1
 
+// Decodes and handles the transport messages of a batch, the address of its sender is cleared once handled
+static int8_t __z_multicast_read_batch(_z_transport_multicast_t *ztm, _z_zbuf_t *zbuf, _z_bytes_t *addr) {
+    int8_t ret = _Z_RES_OK;
+
+    while ((_z_zbuf_len(zbuf) > (size_t)0) && (ret == _Z_RES_OK)) {
+        // Decode one session message
+        _z_transport_message_t t_msg;
+        ret = _z_transport_message_decode_stream(&t_msg, zbuf);
+        if (ret == _Z_RES_OK) {
+            ret = _z_multicast_handle_transport_message(ztm, &t_msg, addr);
+            if (ret == _Z_RES_OK) {
+                _z_t_msg_clear(&t_msg);
+                _z_bytes_clear(addr);
+            }
+        } else {
+            _Z_ERROR("Connection closed due to malformed message");
+        }
+    }
+
+    return ret;
+}
+
+#if _Z_LINK_BATCH_MAX > 1
+// Receives up to _Z_LINK_BATCH_MAX datagrams in a single read, each one holding its own batch
+static int8_t __z_multicast_read_datagrams(_z_transport_multicast_t *ztm) {
+    int8_t ret = _Z_RES_OK;
+
+    size_t lens[_Z_LINK_BATCH_MAX];
+    _z_bytes_t addrs[_Z_LINK_BATCH_MAX];
+    size_t rn = _z_link_recv_batch_zbuf(&ztm->_link, &ztm->_zbuf, lens, addrs);
+    for (size_t i = 0; (i < rn) && (rn != SIZE_MAX); i++) {
+        // Our own datagrams and the truncated ones are skipped
+        if ((lens[i] > (size_t)0) && (ret == _Z_RES_OK)) {
+            _z_zbuf_set_rpos(&ztm->_zbuf, i * (size_t)Z_UDP_BATCH_IO_SLOT_SIZE);
+            _z_zbuf_t zbuf = _z_zbuf_view(&ztm->_zbuf, lens[i]);
+            _Z_STATS_RX_BATCH(&ztm->_stats, lens[i]);
+            ret = __z_multicast_read_batch(ztm, &zbuf, &addrs[i]);
+        }
+        _z_bytes_clear(&addrs[i]);
+    }
+    _z_zbuf_set_rpos(&ztm->_zbuf, _z_zbuf_get_wpos(&ztm->_zbuf));
+
+    return ret;
+}
+#endif
+
 void *_zp_multicast_read_task(void *ztm_arg) {
     _z_transport_multicast_t *ztm = (_z_transport_multicast_t *)ztm_arg;
 
@@ -55,37 +101,45 @@ void *_zp_multicast_read_task(void *ztm_arg) {
 
     // Prepare the buffer
     _z_zbuf_reset(&ztm->_zbuf);
+    _z_rx_stream_reset(&ztm->_rx_stream);
 
     _z_bytes_t addr = _z_bytes_wrap(NULL, 0);
     while (ztm->_read_task_running == true) {
+        // A retained payload pins the batch, the bytes yet to read are moved to another one
+        if (_z_rx_pool_renew(ztm->_rx_pool, &ztm->_rx_batch, &ztm->_zbuf) != _Z_RES_OK) {
+            _Z_ERROR("Connection closed due to lack of RX buffers");
+            ztm->_read_task_running = false;
+            continue;
+        }
+
         // Read bytes from socket to the main buffer
         size_t to_read = 0;
 
         switch (ztm->_link._cap._flow) {
-            case Z_LINK_CAP_FLOW_STREAM:
-                if (_z_zbuf_len(&ztm->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
-                    _z_link_recv_zbuf(&ztm->_link, &ztm->_zbuf, &addr);
-                    if (_z_zbuf_len(&ztm->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
+            case Z_LINK_CAP_FLOW_STREAM: {
+                int8_t ret = _z_rx_stream_recv(&ztm->_rx_stream, &ztm->_link, &ztm->_zbuf, &addr, &to_read);
+                if (ret == _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES) {
+                    // The address of the sender is kept with the length prefix of its batch
+                    if (ztm->_rx_stream._has_len == false) {
                         _z_bytes_clear(&addr);
-                        _z_zbuf_compact(&ztm->_zbuf);
-                        continue;
-                    }
-                }
-
-                for (uint8_t i = 0; i < _Z_MSG_LEN_ENC_SIZE; i++) {
-                    to_read |= _z_zbuf_read(&ztm->_zbuf) << (i * (uint8_t)8);
-                }
-
-                if (_z_zbuf_len(&ztm->_zbuf) < to_read) {
-                    _z_link_recv_zbuf(&ztm->_link, &ztm->_zbuf, NULL);
-                    if (_z_zbuf_len(&ztm->_zbuf) < to_read) {
-                        _z_zbuf_set_rpos(&ztm->_zbuf, _z_zbuf_get_rpos(&ztm->_zbuf) - _Z_MSG_LEN_ENC_SIZE);
-                        _z_zbuf_compact(&ztm->_zbuf);
-                        continue;
                     }
+                    continue;
+                } else if (ret != _Z_RES_OK) {
+                    _Z_ERROR("Connection closed due to a batch larger than the RX buffer");
+                    ztm->_read_task_running = false;
+                    continue;
                 }
                 break;
+            }
             case Z_LINK_CAP_FLOW_DATAGRAM:
+#if _Z_LINK_BATCH_MAX > 1
+                if (_z_link_batch_max(&ztm->_link) > (size_t)1) {
+                    if (__z_multicast_read_datagrams(ztm) != _Z_RES_OK) {
+                        ztm->_read_task_running = false;
+                    }
+                    continue;
+                }
+#endif
                 _z_zbuf_compact(&ztm->_zbuf);
                 to_read = _z_link_recv_zbuf(&ztm->_link, &ztm->_zbuf, &addr);
                 if (to_read == SIZE_MAX) {
@@ -97,28 +151,9 @@ void *_zp_multicast_read_task(void *ztm_arg) {
         }
         // Wrap the main buffer for to_read bytes
         _z_zbuf_t zbuf = _z_zbuf_view(&ztm->_zbuf, to_read);
-
-        while (_z_zbuf_len(&zbuf) > 0) {
-            int8_t ret = _Z_RES_OK;
-
-            // Decode one session message
-            _z_transport_message_t t_msg;
-            ret = _z_transport_message_decode(&t_msg, &zbuf);
-            if (ret == _Z_RES_OK) {
-                ret = _z_multicast_handle_transport_message(ztm, &t_msg, &addr);
-
-                if (ret == _Z_RES_OK) {
-                    _z_t_msg_clear(&t_msg);
-                    _z_bytes_clear(&addr);
-                } else {
-                    ztm->_read_task_running = false;
-                    continue;
-                }
-            } else {
-                _Z_ERROR("Connection closed due to malformed message");
-                ztm->_read_task_running = false;
-                continue;
-            }
+        _Z_STATS_RX_BATCH(&ztm->_stats, to_read);
+        if (__z_multicast_read_batch(ztm, &zbuf, &addr) != _Z_RES_OK) {
+            ztm->_read_task_running = false;
         }
 
         // Move the read position of the read buffer
@@ -16,6 +16,7 @@
 
 #include <stddef.h>
 #include <stdint.h>
+#include <string.h>
 
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/codec/network.h"
@@ -23,7 +24,10 @@
 #include "zenoh-pico/protocol/definitions/network.h"
 #include "zenoh-pico/protocol/definitions/transport.h"
 #include "zenoh-pico/protocol/iobuf.h"
+#include "zenoh-pico/session/matching.h"
+#include "zenoh-pico/session/resource.h"
 #include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/multicast/lease.h"
 #include "zenoh-pico/transport/utils.h"
 #include "zenoh-pico/utils/logging.h"
 
@@ -40,28 +44,14 @@ static int8_t _z_multicast_recv_t_msg_na(_z_transport_multicast_t *ztm, _z_trans
 
     size_t to_read = 0;
     do {
+        // A retained payload pins the batch, the bytes yet to read are moved to another one
+        ret = _z_rx_pool_renew(ztm->_rx_pool, &ztm->_rx_batch, &ztm->_zbuf);
+        if (ret != _Z_RES_OK) {
+            continue;
+        }
         switch (ztm->_link._cap._flow) {
             case Z_LINK_CAP_FLOW_STREAM:
-                if (_z_zbuf_len(&ztm->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
-                    _z_link_recv_zbuf(&ztm->_link, &ztm->_zbuf, addr);
-                    if (_z_zbuf_len(&ztm->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
-                        _z_zbuf_compact(&ztm->_zbuf);
-                        ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
-                        break;
-                    }
-                }
-                for (uint8_t i = 0; i < _Z_MSG_LEN_ENC_SIZE; i++) {
-                    to_read |= _z_zbuf_read(&ztm->_zbuf) << (i * (uint8_t)8);
-                }
-                if (_z_zbuf_len(&ztm->_zbuf) < to_read) {
-                    _z_link_recv_zbuf(&ztm->_link, &ztm->_zbuf, addr);
-                    if (_z_zbuf_len(&ztm->_zbuf) < to_read) {
-                        _z_zbuf_set_rpos(&ztm->_zbuf, _z_zbuf_get_rpos(&ztm->_zbuf) - _Z_MSG_LEN_ENC_SIZE);
-                        _z_zbuf_compact(&ztm->_zbuf);
-                        ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
-                        break;
-                    }
-                }
+                ret = _z_rx_stream_recv(&ztm->_rx_stream, &ztm->_link, &ztm->_zbuf, addr, &to_read);
                 break;
             // Datagram capable links
             case Z_LINK_CAP_FLOW_DATAGRAM:
@@ -77,8 +67,9 @@ static int8_t _z_multicast_recv_t_msg_na(_z_transport_multicast_t *ztm, _z_trans
     } while (false);  // The 1-iteration loop to use continue to break the entire loop on error
 
     if (ret == _Z_RES_OK) {
+        _Z_STATS_RX_BATCH(&ztm->_stats, to_read);
         _Z_DEBUG(">> \t transport_message_decode: %ju", (uintmax_t)_z_zbuf_len(&ztm->_zbuf));
-        ret = _z_transport_message_decode(t_msg, &ztm->_zbuf);
+        ret = _z_transport_message_decode_stream(t_msg, &ztm->_zbuf);
     }
 
 #if Z_FEATURE_MULTI_THREAD == 1
@@ -102,74 +93,225 @@ int8_t _z_multicast_recv_t_msg(_z_transport_multicast_t *ztm, _z_transport_messa
 
 #if Z_FEATURE_MULTICAST_TRANSPORT == 1 || Z_FEATURE_RAWETH_TRANSPORT == 1
 
-static _z_transport_peer_entry_t *_z_find_peer_entry(_z_transport_peer_entry_list_t *l, _z_bytes_t *remote_addr) {
-    _z_transport_peer_entry_t *ret = NULL;
-
-    _z_transport_peer_entry_list_t *xs = l;
-    for (; xs != NULL; xs = _z_transport_peer_entry_list_tail(xs)) {
-        _z_transport_peer_entry_t *val = _z_transport_peer_entry_list_head(xs);
-        if (val->_remote_addr.len != remote_addr->len) {
-            continue;
+// Handles the network messages of a frame, a dropped frame is still decoded so that the reading position moves past it
+static int8_t __z_multicast_handle_frame(_z_transport_multicast_t *ztm, _z_transport_peer_entry_t *entry,
+                                         _z_transport_message_t *t_msg, _z_rx_batch_t *rx_batch, _Bool drop) {
+    int8_t ret = _Z_RES_OK;
+    uint16_t mapping = (entry != NULL) ? entry->_peer_id : _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE;
+    _z_network_message_t zm;
+    _Bool end = false;
+    while (ret == _Z_RES_OK) {
+        ret = _z_frame_decode_next(&t_msg->_body._frame, &zm, &end);
+        if ((ret != _Z_RES_OK) || (end == true)) {
+            break;
+        }
+        if (drop == false) {
+            _Z_STATS_INC(&ztm->_stats, _Z_STATS_RX_N_MSGS);
+            _z_msg_fix_mapping(&zm, mapping);
+            _z_handle_network_message(ztm->_session, &zm, mapping, rx_batch);
         }
+        _z_msg_clear(&zm);
+    }
+    return ret;
+}
 
-        if (memcmp(val->_remote_addr.start, remote_addr->start, remote_addr->len) == 0) {
-            ret = val;
+static int8_t __z_multicast_handle_fragment(_z_transport_multicast_t *ztm, _z_transport_peer_entry_t *entry,
+                                            _z_transport_message_t *t_msg) {
+    int8_t ret = _Z_RES_OK;
+    _Z_STATS_INC(&ztm->_stats, _Z_STATS_RX_FRAGMENTS);
+
+    // Select the right defragmentation buffer, fragments of different conduits can be interleaved
+    uint8_t lane = _Z_TRANSPORT_LANE(
+        _z_conduit_sn_list_index(&entry->_sn_rx_sns, _z_n_qos_get_priority(t_msg->_body._fragment._ext_qos)));
+    _z_dbuf_t *dbuf = _Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_R) ? &entry->_dbuf_reliable[lane]
+                                                                        : &entry->_dbuf_best_effort[lane];
+
+    // Once the message exceeds the fragmentation size, its remaining fragments are discarded
+    (void)_z_dbuf_write_bytes(dbuf, t_msg->_body._fragment._payload.start, t_msg->_body._fragment._payload.len);
+
+    if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_M) == false) {
+        if (_z_dbuf_is_overflow(dbuf) == true) {  // Drop message if it exceeds the fragmentation size
+            _Z_INFO("Defragmented message dropped because it exceeds the fragmentation size");
+            _Z_STATS_INC(&ztm->_stats, _Z_STATS_RX_REASSEMBLY_DROPS);
+        } else {
+            _z_zbuf_t zbf = _z_dbuf_as_zbuf(dbuf);  // Decode the reassembled message in place
+
+            _z_zenoh_message_t zm;
+            ret = _z_network_message_decode(&zm, &zbf);
+            if (ret == _Z_RES_OK) {
+                _Z_STATS_INC(&ztm->_stats, _Z_STATS_RX_N_MSGS);
+                uint16_t mapping = entry->_peer_id;
+                _z_msg_fix_mapping(&zm, mapping);
+                _z_handle_network_message(ztm->_session, &zm, mapping, NULL);
+                _z_msg_clear(&zm);
+            }
         }
+
+        // Reset the defragmentation buffer
+        _z_dbuf_reset(dbuf);
+    }
+    return ret;
+}
+
+#if Z_FEATURE_RELIABILITY == 1
+typedef struct {
+    _z_transport_multicast_t *_ztm;
+    _z_transport_peer_entry_t *_entry;
+    uint8_t _lane;
+} _z_multicast_reorder_ctx_t;
+
+static int8_t __z_multicast_deliver(void *arg, _z_transport_message_t *t_msg, _Bool is_copy) {
+    int8_t ret = _Z_RES_OK;
+    _z_multicast_reorder_ctx_t *ctx = (_z_multicast_reorder_ctx_t *)arg;
+    if (t_msg == NULL) {
+        // The fragments received before the missing ones belong to a message that can no longer be reassembled
+        _z_dbuf_reset(&ctx->_entry->_dbuf_reliable[ctx->_lane]);
+    } else if (_Z_MID(t_msg->_header) == _Z_MID_T_FRAME) {
+        // A buffered frame is decoded from a copy, its payloads cannot retain the RX batch
+        ret = __z_multicast_handle_frame(ctx->_ztm, ctx->_entry, t_msg, (is_copy == true) ? NULL : ctx->_ztm->_rx_batch,
+                                         false);
+    } else {
+        ret = __z_multicast_handle_fragment(ctx->_ztm, ctx->_entry, t_msg);
     }
+    return ret;
+}
+
+/**
+ * Requests the given peer to retransmit the reliable messages of a conduit, as reported by the reorder buffer.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->_mutex_peer
+ */
+static int8_t __unsafe_z_multicast_send_nack(_z_transport_multicast_t *ztm, const _z_transport_peer_entry_t *entry,
+                                             uint8_t conduit, _z_zint_t sn, _z_zint_t mask) {
+    _Z_INFO("Sending Z_ACK_NACK(Nack) from SN %ju", (uintmax_t)sn);
+    _z_n_qos_t qos = (entry->_sn_rx_sns._is_qos == true) ? _z_n_qos_make(0, 0, conduit) : _Z_N_QOS_DEFAULT;
+    _z_transport_message_t nack = _z_t_msg_make_nack(sn, mask, entry->_remote_zid, qos);
+    return ztm->_send_f(ztm, &nack);
+}
 
+/**
+ * Delivers a reliable frame or fragment of a peer in order, requesting the missing ones.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->_mutex_peer
+ */
+static int8_t __unsafe_z_multicast_recv_reliable(_z_transport_multicast_t *ztm, _z_transport_peer_entry_t *entry,
+                                                 _z_transport_message_t *t_msg, uint8_t conduit) {
+    int8_t ret = _Z_RES_OK;
+    _z_multicast_reorder_ctx_t ctx = {._ztm = ztm, ._entry = entry, ._lane = _Z_TRANSPORT_LANE(conduit)};
+    _z_zint_t sn = 0;
+    _z_zint_t mask = 0;
+    if (_z_reliability_reorder_recv(&entry->_rx_reorder[conduit], entry->_sn_res,
+                                    &entry->_sn_rx_sns._val._qos[conduit]._reliable, t_msg, __z_multicast_deliver,
+                                    &ctx, &sn, &mask) == true) {
+        ret = __unsafe_z_multicast_send_nack(ztm, entry, conduit, sn, mask);
+    }
+    // Multicast peers are not acknowledged, the senders only keep their last messages
+    entry->_rx_reorder[conduit]._unacked = 0;
     return ret;
 }
 
+/**
+ * Reconciles the reliable SNs of a known peer with the ones announced in its JOIN, that are otherwise taken as is.
+ * The messages sent before the JOIN but not received yet are requested, unless the peer restarted or is too far
+ * ahead, in which case its SNs are taken from the JOIN.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->_mutex_peer
+ */
+static void __unsafe_z_multicast_join_reliable(_z_transport_multicast_t *ztm, _z_transport_peer_entry_t *entry,
+                                               const _z_conduit_sn_list_t *last_sns) {
+    size_t num = (entry->_sn_rx_sns._is_qos == true) ? (size_t)Z_PRIORITIES_NUM : (size_t)1;
+    for (size_t c = 0; c < num; c++) {
+        _z_zint_t announced = entry->_sn_rx_sns._val._qos[c]._reliable;
+        _z_zint_t last = last_sns->_val._qos[c]._reliable;
+        _Bool resync = (last_sns->_is_qos != entry->_sn_rx_sns._is_qos);
+        if ((resync == false) && (_z_sn_precedes(entry->_sn_res, last, announced) == true)) {
+            resync = (((announced - last) & entry->_sn_res) > (_z_zint_t)Z_RELIABILITY_REORDER_SIZE);
+        } else if ((resync == false) && (announced != last)) {
+            resync = true;  // The peer restarted
+        } else {
+            // Nothing was missed since the last JOIN
+        }
+
+        if (resync == true) {
+            _z_reliability_reorder_reset(&entry->_rx_reorder[c]);
+            _z_dbuf_reset(&entry->_dbuf_reliable[_Z_TRANSPORT_LANE(c)]);
+        } else {
+            entry->_sn_rx_sns._val._qos[c]._reliable = last;
+            _z_zint_t sn = 0;
+            _z_zint_t mask = 0;
+            if ((_z_reliability_reorder_missing(&entry->_rx_reorder[c], entry->_sn_res, last, announced, &sn, &mask) ==
+                 true) &&
+                (__unsafe_z_multicast_send_nack(ztm, entry, (uint8_t)c, sn, mask) != _Z_RES_OK)) {
+                _Z_INFO("Failed to request the missing messages");
+            }
+        }
+    }
+}
+#endif  // Z_FEATURE_RELIABILITY == 1
+
 int8_t _z_multicast_handle_transport_message(_z_transport_multicast_t *ztm, _z_transport_message_t *t_msg,
                                              _z_bytes_t *addr) {
     int8_t ret = _Z_RES_OK;
+    _Bool join = false;  // Answer a new peer once the peers are released
 #if Z_FEATURE_MULTI_THREAD == 1
     // Acquire and keep the lock
     zp_mutex_lock(&ztm->_mutex_peer);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     // Mark the session that we have received data from this peer
-    _z_transport_peer_entry_t *entry = _z_find_peer_entry(ztm->_peers, addr);
+    _z_transport_peer_entry_t *entry = _z_transport_peer_table_get(&ztm->_peers, addr);
     switch (_Z_MID(t_msg->_header)) {
         case _Z_MID_T_FRAME: {
             _Z_INFO("Received _Z_FRAME message");
+            _Bool drop = false;
             if (entry == NULL) {
-                break;
-            }
-            entry->_received = true;
-
-            // Check if the SN is correct
-            if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAME_R) == true) {
-                // @TODO: amend once reliability is in place. For the time being only
-                //        monotonic SNs are ensured
-                if (_z_sn_precedes(entry->_sn_res, entry->_sn_rx_sns._val._plain._reliable, t_msg->_body._frame._sn) ==
-                    true) {
-                    entry->_sn_rx_sns._val._plain._reliable = t_msg->_body._frame._sn;
-                } else {
-                    _z_wbuf_clear(&entry->_dbuf_reliable);
-                    _Z_INFO("Reliable message dropped because it is out of order");
-                    break;
-                }
+                drop = true;
             } else {
-                if (_z_sn_precedes(entry->_sn_res, entry->_sn_rx_sns._val._plain._best_effort,
-                                   t_msg->_body._frame._sn) == true) {
-                    entry->_sn_rx_sns._val._plain._best_effort = t_msg->_body._frame._sn;
+                entry->_received = true;
+
+                // Select the QoS conduit of the frame
+                uint8_t conduit =
+                    _z_conduit_sn_list_index(&entry->_sn_rx_sns, _z_n_qos_get_priority(t_msg->_body._frame._ext_qos));
+                _z_coundit_sn_t *sn_rx = &entry->_sn_rx_sns._val._qos[conduit];
+
+                // Check if the SN is correct
+                if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAME_R) == true) {
+#if Z_FEATURE_RELIABILITY == 1
+                    // Reliable frames are reordered and requested again if the peer retransmits them
+                    if (entry->_rx_reorder != NULL) {
+                        ret = __unsafe_z_multicast_recv_reliable(ztm, entry, t_msg, conduit);
+                        break;
+                    }
+#endif  // Z_FEATURE_RELIABILITY == 1
+                    // Only monotonic SNs are ensured if the peer does not retransmit its reliable frames
+                    if (_z_sn_precedes(entry->_sn_res, sn_rx->_reliable, t_msg->_body._frame._sn) == true) {
+                        sn_rx->_reliable = t_msg->_body._frame._sn;
+                    } else {
+                        _z_dbuf_reset(&entry->_dbuf_reliable[_Z_TRANSPORT_LANE(conduit)]);
+                        _Z_INFO("Reliable message dropped because it is out of order");
+                        _Z_STATS_INC(&ztm->_stats, _Z_STATS_RX_OUT_OF_ORDER_DROPS);
+                        drop = true;
+                    }
                 } else {
-                    _z_wbuf_clear(&entry->_dbuf_best_effort);
-                    _Z_INFO("Best effort message dropped because it is out of order");
-                    break;
+                    if (_z_sn_precedes(entry->_sn_res, sn_rx->_best_effort, t_msg->_body._frame._sn) == true) {
+                        sn_rx->_best_effort = t_msg->_body._frame._sn;
+                    } else {
+                        _z_dbuf_reset(&entry->_dbuf_best_effort[_Z_TRANSPORT_LANE(conduit)]);
+                        _Z_INFO("Best effort message dropped because it is out of order");
+                        _Z_STATS_INC(&ztm->_stats, _Z_STATS_RX_OUT_OF_ORDER_DROPS);
+                        drop = true;
+                    }
                 }
             }
 
-            // Handle all the zenoh message, one by one
-            uint16_t mapping = entry->_peer_id;
-            size_t len = _z_vec_len(&t_msg->_body._frame._messages);
-            for (size_t i = 0; i < len; i++) {
-                _z_network_message_t *zm = _z_network_message_vec_get(&t_msg->_body._frame._messages, i);
-                _z_msg_fix_mapping(zm, mapping);
-                _z_handle_network_message(ztm->_session, zm, mapping);
-            }
-
+            // Decode and handle all the zenoh messages, one by one
+            ret = __z_multicast_handle_frame(ztm, entry, t_msg, ztm->_rx_batch, drop);
             break;
         }
 
@@ -180,49 +322,52 @@ int8_t _z_multicast_handle_transport_message(_z_transport_multicast_t *ztm, _z_t
             }
             entry->_received = true;
 
-            _z_wbuf_t *dbuf = _Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_R)
-                                  ? &entry->_dbuf_reliable
-                                  : &entry->_dbuf_best_effort;  // Select the right defragmentation buffer
-
-            _Bool drop = false;
-            if ((_z_wbuf_len(dbuf) + t_msg->_body._fragment._payload.len) > Z_FRAG_MAX_SIZE) {
-                // Filling the wbuf capacity as a way to signaling the last fragment to reset the dbuf
-                // Otherwise, last (smaller) fragments can be understood as a complete message
-                _z_wbuf_write_bytes(dbuf, t_msg->_body._fragment._payload.start, 0, _z_wbuf_space_left(dbuf));
-                drop = true;
-            } else {
-                _z_wbuf_write_bytes(dbuf, t_msg->_body._fragment._payload.start, 0,
-                                    t_msg->_body._fragment._payload.len);
+#if Z_FEATURE_RELIABILITY == 1
+            if ((entry->_rx_reorder != NULL) && (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_R) == true)) {
+                uint8_t conduit = _z_conduit_sn_list_index(&entry->_sn_rx_sns,
+                                                           _z_n_qos_get_priority(t_msg->_body._fragment._ext_qos));
+                ret = __unsafe_z_multicast_recv_reliable(ztm, entry, t_msg, conduit);
+                break;
             }
+#endif  // Z_FEATURE_RELIABILITY == 1
+            ret = __z_multicast_handle_fragment(ztm, entry, t_msg);
+            break;
+        }
 
-            if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_M) == false) {
-                if (drop == true) {  // Drop message if it exceeds the fragmentation size
-                    _z_wbuf_reset(dbuf);
-                    break;
-                }
-
-                _z_zbuf_t zbf = _z_wbuf_to_zbuf(dbuf);  // Convert the defragmentation buffer into a decoding buffer
+        case _Z_MID_T_ACK_NACK: {
+            _Z_INFO("Received Z_ACK_NACK message");
+            if (entry == NULL) {
+                break;
+            }
+            entry->_received = true;
 
-                _z_zenoh_message_t zm;
-                ret = _z_network_message_decode(&zm, &zbf);
-                if (ret == _Z_RES_OK) {
-                    uint16_t mapping = entry->_peer_id;
-                    _z_msg_fix_mapping(&zm, mapping);
-                    _z_handle_network_message(ztm->_session, &zm, mapping);
-                    _z_msg_clear(&zm);  // Clear must be explicitly called for fragmented zenoh messages. Non-fragmented
-                                        // zenoh messages are released when their transport message is released.
+#if Z_FEATURE_RELIABILITY == 1
+            // Only the NACKs addressed to this node are answered, the ACKs are ignored since the other peers may
+            // still miss the acknowledged messages
+            _z_t_msg_ack_nack_t *msg = &t_msg->_body._ack_nack;
+            _z_id_t local_zid = ((_z_session_t *)ztm->_session)->_local_zid;
+            if ((ztm->_tx_window != NULL) && (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_ACK_NACK_N) == true) &&
+                (memcmp(msg->_zid.id, local_zid.id, sizeof(local_zid.id)) == 0)) {
+                uint8_t lane = _Z_TRANSPORT_LANE(
+                    _z_conduit_sn_list_index(&ztm->_sn_tx_sns, _z_n_qos_get_priority(msg->_ext_qos)));
+#if Z_FEATURE_MULTI_THREAD == 1
+                zp_mutex_lock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+                if (_z_reliability_window_resend(&ztm->_tx_window[lane], &ztm->_link, ztm->_sn_res, msg->_sn,
+                                                 msg->_mask, _zp_multicast_lease_now(ztm)) != _Z_RES_OK) {
+                    _Z_INFO("Failed to retransmit the requested messages");
                 }
-
-                // Free the decoding buffer
-                _z_zbuf_clear(&zbf);
-                // Reset the defragmentation buffer
-                _z_wbuf_reset(dbuf);
+#if Z_FEATURE_MULTI_THREAD == 1
+                zp_mutex_unlock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
             }
+#endif  // Z_FEATURE_RELIABILITY == 1
             break;
         }
 
         case _Z_MID_T_KEEP_ALIVE: {
             _Z_INFO("Received _Z_KEEP_ALIVE message");
+            _Z_STATS_INC(&ztm->_stats, _Z_STATS_RX_KEEP_ALIVES);
             if (entry == NULL) {
                 break;
             }
@@ -263,24 +408,42 @@ int8_t _z_multicast_handle_transport_message(_z_transport_multicast_t *ztm, _z_t
                     if (ret == _Z_RES_OK) {
                         entry->_remote_addr = _z_bytes_duplicate(addr);
                         entry->_remote_zid = t_msg->_body._join._zid;
+#if Z_FEATURE_RELIABILITY == 1
+                        // The reliable messages of the peer are reordered if it retransmits them
+                        entry->_rx_reorder = NULL;
+                        if ((t_msg->_body._join._ext_reliability == true) && (ztm->_link._cap._is_reliable == false)) {
+                            entry->_rx_reorder = _z_reliability_reorders_make(Z_PRIORITIES_NUM);
+                        }
+#endif  // Z_FEATURE_RELIABILITY == 1
 
                         _z_conduit_sn_list_copy(&entry->_sn_rx_sns, &t_msg->_body._join._next_sn);
                         _z_conduit_sn_list_decrement(entry->_sn_res, &entry->_sn_rx_sns);
 
+                        for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
 #if Z_FEATURE_DYNAMIC_MEMORY_ALLOCATION == 1
-                        entry->_dbuf_reliable = _z_wbuf_make(0, true);
-                        entry->_dbuf_best_effort = _z_wbuf_make(0, true);
+                            entry->_dbuf_reliable[i] = _z_dbuf_make(0, Z_FRAG_MAX_SIZE, true);
+                            entry->_dbuf_best_effort[i] = _z_dbuf_make(0, Z_FRAG_MAX_SIZE, true);
 #else
-                        entry->_dbuf_reliable = _z_wbuf_make(Z_FRAG_MAX_SIZE, false);
-                        entry->_dbuf_best_effort = _z_wbuf_make(Z_FRAG_MAX_SIZE, false);
+                            entry->_dbuf_reliable[i] = _z_dbuf_make(Z_FRAG_MAX_SIZE, Z_FRAG_MAX_SIZE, false);
+                            entry->_dbuf_best_effort[i] = _z_dbuf_make(Z_FRAG_MAX_SIZE, Z_FRAG_MAX_SIZE, false);
 #endif
+                        }
 
                         // Update lease time (set as ms during)
                         entry->_lease = t_msg->_body._join._lease;
-                        entry->_next_lease = entry->_lease;
+                        entry->_lease_deadline = _zp_multicast_lease_now(ztm) + entry->_lease;
                         entry->_received = true;
 
-                        ztm->_peers = _z_transport_peer_entry_list_insert(ztm->_peers, entry);
+                        ret = _z_transport_peer_table_insert(&ztm->_peers, entry);
+                        if (ret == _Z_RES_OK) {
+                            // Answer with our own join and declarations, so that the new peer can decode our
+                            // messages without waiting for the next join interval. Until then it does not know
+                            // the ids of the local resources.
+                            _z_reset_resource_declarations((_z_session_t *)ztm->_session);
+                            join = true;
+                        } else {
+                            _z_transport_peer_entry_elem_free((void **)&entry);
+                        }
                     } else {
                         zp_free(entry);
                     }
@@ -294,14 +457,27 @@ int8_t _z_multicast_handle_transport_message(_z_transport_multicast_t *ztm, _z_t
                 if ((t_msg->_body._join._seq_num_res != Z_SN_RESOLUTION) ||
                     (t_msg->_body._join._req_id_res != Z_REQ_RESOLUTION) ||
                     (t_msg->_body._join._batch_size != Z_BATCH_MULTICAST_SIZE)) {
-                    _z_transport_peer_entry_list_drop_filter(ztm->_peers, _z_transport_peer_entry_eq, entry);
-                    // TODO: cleanup here should also be done on mappings/subs/etc...
+#if Z_FEATURE_MATCHING == 1
+                    _z_unregister_remote_subscriptions_for_peer((_z_session_t *)ztm->_session, entry->_peer_id);
+#endif
+                    _z_unregister_resources_for_peer((_z_session_t *)ztm->_session, entry->_peer_id);
+                    _z_transport_peer_table_remove(&ztm->_peers, entry);
                     break;
                 }
 
+#if Z_FEATURE_RELIABILITY == 1
+                _z_conduit_sn_list_t last_sns;
+                _z_conduit_sn_list_copy(&last_sns, &entry->_sn_rx_sns);
+#endif  // Z_FEATURE_RELIABILITY == 1
+
                 // Update SNs
                 _z_conduit_sn_list_copy(&entry->_sn_rx_sns, &t_msg->_body._join._next_sn);
                 _z_conduit_sn_list_decrement(entry->_sn_res, &entry->_sn_rx_sns);
+#if Z_FEATURE_RELIABILITY == 1
+                if (entry->_rx_reorder != NULL) {
+                    __unsafe_z_multicast_join_reliable(ztm, entry, &last_sns);
+                }
+#endif  // Z_FEATURE_RELIABILITY == 1
 
                 // Update lease time (set as ms during)
                 entry->_lease = t_msg->_body._join._lease;
@@ -315,7 +491,11 @@ int8_t _z_multicast_handle_transport_message(_z_transport_multicast_t *ztm, _z_t
             if (entry == NULL) {
                 break;
             }
-            ztm->_peers = _z_transport_peer_entry_list_drop_filter(ztm->_peers, _z_transport_peer_entry_eq, entry);
+#if Z_FEATURE_MATCHING == 1
+            _z_unregister_remote_subscriptions_for_peer((_z_session_t *)ztm->_session, entry->_peer_id);
+#endif
+            _z_unregister_resources_for_peer((_z_session_t *)ztm->_session, entry->_peer_id);
+            _z_transport_peer_table_remove(&ztm->_peers, entry);
 
             break;
         }
@@ -330,6 +510,10 @@ int8_t _z_multicast_handle_transport_message(_z_transport_multicast_t *ztm, _z_t
     zp_mutex_unlock(&ztm->_mutex_peer);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
+    if ((join == true) && (_zp_multicast_send_join(ztm) == _Z_RES_OK)) {
+        ztm->_transmitted = true;
+    }
+
     return ret;
 }
 #else
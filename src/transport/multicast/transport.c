@@ -57,7 +57,14 @@ int8_t _z_multicast_transport_create(_z_transport_t *zt, _z_link_t *zl,
         ret = zp_mutex_init(&ztm->_mutex_rx);
         if (ret == _Z_RES_OK) {
             ret = zp_mutex_init(&ztm->_mutex_peer);
-            if (ret != _Z_RES_OK) {
+            if (ret == _Z_RES_OK) {
+                ret = _z_transport_lanes_mutex_init(ztm->_mutex_lanes);
+                if (ret != _Z_RES_OK) {
+                    zp_mutex_free(&ztm->_mutex_tx);
+                    zp_mutex_free(&ztm->_mutex_rx);
+                    zp_mutex_free(&ztm->_mutex_peer);
+                }
+            } else {
                 zp_mutex_free(&ztm->_mutex_tx);
                 zp_mutex_free(&ztm->_mutex_rx);
             }
@@ -71,20 +78,27 @@ int8_t _z_multicast_transport_create(_z_transport_t *zt, _z_link_t *zl,
     if (ret == _Z_RES_OK) {
         uint16_t mtu = (zl->_mtu < Z_BATCH_MULTICAST_SIZE) ? zl->_mtu : Z_BATCH_MULTICAST_SIZE;
         ztm->_wbuf = _z_wbuf_make(mtu, false);
-        ztm->_zbuf = _z_zbuf_make(Z_BATCH_MULTICAST_SIZE);
+        // A batched read needs one slot per datagram
+        size_t zbuf_size = Z_BATCH_MULTICAST_SIZE;
+        if (_z_link_batch_max(zl) > (size_t)1) {
+            zbuf_size = (size_t)Z_UDP_BATCH_IO_SLOT_SIZE * _z_link_batch_max(zl);
+        }
+        int8_t rx_ret = _z_rx_pool_open(&ztm->_rx_pool, &ztm->_rx_batch, &ztm->_zbuf, zbuf_size);
+        _z_rx_stream_reset(&ztm->_rx_stream);
 
         // Clean up the buffers if one of them failed to be allocated
-        if ((_z_wbuf_capacity(&ztm->_wbuf) != mtu) || (_z_zbuf_capacity(&ztm->_zbuf) != Z_BATCH_MULTICAST_SIZE)) {
+        if ((_z_wbuf_capacity(&ztm->_wbuf) != mtu) || (rx_ret != _Z_RES_OK)) {
             ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
 
 #if Z_FEATURE_MULTI_THREAD == 1
             zp_mutex_free(&ztm->_mutex_tx);
             zp_mutex_free(&ztm->_mutex_rx);
             zp_mutex_free(&ztm->_mutex_peer);
+            _z_transport_lanes_mutex_free(ztm->_mutex_lanes);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
             _z_wbuf_clear(&ztm->_wbuf);
-            _z_zbuf_clear(&ztm->_zbuf);
+            _z_rx_pool_close(&ztm->_rx_pool, &ztm->_rx_batch, &ztm->_zbuf);
         }
     }
 
@@ -93,11 +107,22 @@ int8_t _z_multicast_transport_create(_z_transport_t *zt, _z_link_t *zl,
         ztm->_sn_res = _z_sn_max(param->_seq_num_res);
 
         // The initial SN at TX side
-        ztm->_sn_tx_reliable = param->_initial_sn_tx._val._plain._reliable;
-        ztm->_sn_tx_best_effort = param->_initial_sn_tx._val._plain._best_effort;
+        _z_conduit_sn_list_copy(&ztm->_sn_tx_sns, &param->_initial_sn_tx);
+
+#if Z_FEATURE_RELIABILITY == 1
+        // Reliable messages are only retransmitted on links that may lose them, raw ethernet frames never are
+        ztm->_tx_window = NULL;
+        if ((zt->_type == _Z_TRANSPORT_MULTICAST_TYPE) && (zl->_cap._is_reliable == false)) {
+            ztm->_tx_window = _z_reliability_windows_make(_Z_TRANSPORT_LANES_NUM);
+            if (ztm->_tx_window == NULL) {
+                _Z_ERROR("Unable to allocate the retransmission buffers, reliability is disabled");
+            }
+        }
+#endif  // Z_FEATURE_RELIABILITY == 1
 
-        // Initialize peer list
-        ztm->_peers = _z_transport_peer_entry_list_new();
+        // Initialize peer table
+        _z_transport_peer_table_init(&ztm->_peers);
+        ztm->_lease_epoch = zp_clock_now();
 
 #if Z_FEATURE_MULTI_THREAD == 1
         // Tasks
@@ -105,6 +130,10 @@ int8_t _z_multicast_transport_create(_z_transport_t *zt, _z_link_t *zl,
         ztm->_read_task = NULL;
         ztm->_lease_task_running = false;
         ztm->_lease_task = NULL;
+        ztm->_tx_task_running = false;
+        ztm->_tx_task = NULL;
+        ztm->_tx_slots = NULL;
+        _z_tx_queue_null(&ztm->_tx_queue);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
         ztm->_lease = Z_TRANSPORT_LEASE;
@@ -112,6 +141,10 @@ int8_t _z_multicast_transport_create(_z_transport_t *zt, _z_link_t *zl,
         // Notifiers
         ztm->_transmitted = false;
 
+#if Z_FEATURE_STATS == 1
+        _z_transport_stats_reset(&ztm->_stats);
+#endif  // Z_FEATURE_STATS == 1
+
         // Transport link for multicast
         ztm->_link = *zl;
     }
@@ -126,13 +159,20 @@ int8_t _z_multicast_open_peer(_z_transport_multicast_establish_param_t *param, c
     zp_random_fill(&initial_sn_tx, sizeof(initial_sn_tx));
     initial_sn_tx = initial_sn_tx & !_z_sn_modulo_mask(Z_SN_RESOLUTION);
 
+    // QoS conduits are announced in the JOIN messages, raw ethernet frames are always sent on a single conduit
     _z_conduit_sn_list_t next_sn;
-    next_sn._is_qos = false;
-    next_sn._val._plain._best_effort = initial_sn_tx;
-    next_sn._val._plain._reliable = initial_sn_tx;
+    _Bool is_qos = (Z_FEATURE_PRIORITY_LANES == 1) && (zl->_cap._transport == Z_LINK_CAP_TRANSPORT_MULTICAST);
+    _z_conduit_sn_list_init(&next_sn, is_qos, initial_sn_tx);
 
     _z_id_t zid = *local_zid;
     _z_transport_message_t jsm = _z_t_msg_make_join(Z_WHATAMI_PEER, Z_TRANSPORT_LEASE, zid, next_sn);
+#if Z_FEATURE_RELIABILITY == 1
+    // The transport retransmits its reliable messages on the links that may lose them
+    if ((zl->_cap._transport == Z_LINK_CAP_TRANSPORT_MULTICAST) && (zl->_cap._is_reliable == false)) {
+        jsm._body._join._ext_reliability = true;
+        _Z_SET_FLAG(jsm._header, _Z_FLAG_T_Z);
+    }
+#endif  // Z_FEATURE_RELIABILITY == 1
 
     // Encode and send the message
     _Z_INFO("Sending Z_JOIN message");
@@ -181,7 +221,8 @@ int8_t _z_multicast_transport_close(_z_transport_multicast_t *ztm, uint8_t reaso
 void _z_multicast_transport_clear(_z_transport_t *zt) {
     _z_transport_multicast_t *ztm = &zt->_transport._multicast;
 #if Z_FEATURE_MULTI_THREAD == 1
-    // Clean up tasks
+    // Clean up tasks, the TX task sends the queued messages before stopping
+    _zp_multicast_stop_tx_task(ztm);
     if (ztm->_read_task != NULL) {
         zp_task_join(ztm->_read_task);
         zp_task_free(&ztm->_read_task);
@@ -194,14 +235,19 @@ void _z_multicast_transport_clear(_z_transport_t *zt) {
     zp_mutex_free(&ztm->_mutex_tx);
     zp_mutex_free(&ztm->_mutex_rx);
     zp_mutex_free(&ztm->_mutex_peer);
+    _z_transport_lanes_mutex_free(ztm->_mutex_lanes);
+    _z_tx_queue_clear(&ztm->_tx_queue);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     // Clean up the buffers
     _z_wbuf_clear(&ztm->_wbuf);
-    _z_zbuf_clear(&ztm->_zbuf);
+    _z_rx_pool_close(&ztm->_rx_pool, &ztm->_rx_batch, &ztm->_zbuf);
+#if Z_FEATURE_RELIABILITY == 1
+    _z_reliability_windows_free(&ztm->_tx_window, _Z_TRANSPORT_LANES_NUM);
+#endif  // Z_FEATURE_RELIABILITY == 1
 
-    // Clean up peer list
-    _z_transport_peer_entry_list_free(&ztm->_peers);
+    // Clean up peer table
+    _z_transport_peer_table_clear(&ztm->_peers);
     _z_link_clear(&ztm->_link);
 }
 
@@ -14,6 +14,8 @@
 
 #include "zenoh-pico/transport/multicast/tx.h"
 
+#include <string.h>
+
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/codec/network.h"
 #include "zenoh-pico/protocol/codec/transport.h"
@@ -26,20 +28,43 @@
 /**
  * This function is unsafe because it operates in potentially concurrent data.
  * Make sure that the following mutexes are locked before calling this function:
- *  - ztm->_mutex_inner
+ *  - ztm->_mutex_lanes[lane]
  */
-_z_zint_t __unsafe_z_multicast_get_sn(_z_transport_multicast_t *ztm, z_reliability_t reliability) {
+_z_zint_t __unsafe_z_multicast_get_sn(_z_transport_multicast_t *ztm, uint8_t lane, z_reliability_t reliability) {
+    _z_coundit_sn_t *sn_tx = &ztm->_sn_tx_sns._val._qos[lane];
     _z_zint_t sn;
     if (reliability == Z_RELIABILITY_RELIABLE) {
-        sn = ztm->_sn_tx_reliable;
-        ztm->_sn_tx_reliable = _z_sn_increment(ztm->_sn_res, ztm->_sn_tx_reliable);
+        sn = sn_tx->_reliable;
+        sn_tx->_reliable = _z_sn_increment(ztm->_sn_res, sn_tx->_reliable);
     } else {
-        sn = ztm->_sn_tx_best_effort;
-        ztm->_sn_tx_best_effort = _z_sn_increment(ztm->_sn_res, ztm->_sn_tx_best_effort);
+        sn = sn_tx->_best_effort;
+        sn_tx->_best_effort = _z_sn_increment(ztm->_sn_res, sn_tx->_best_effort);
     }
     return sn;
 }
 
+/**
+ * Keeps a finalized frame or fragment for retransmission if it is reliable.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->_mutex_tx
+ */
+static void __unsafe_z_multicast_keep(_z_transport_multicast_t *ztm, const _z_wbuf_t *wbf, uint8_t lane) {
+#if Z_FEATURE_RELIABILITY == 1
+    if (ztm->_tx_window != NULL) {
+        _z_zint_t now = (_z_zint_t)zp_clock_elapsed_ms(&ztm->_lease_epoch);
+        if (_z_reliability_window_push(&ztm->_tx_window[lane], wbf, ztm->_link._cap._flow, now) != _Z_RES_OK) {
+            _Z_INFO("Unable to keep a reliable message for retransmission");
+        }
+    }
+#else
+    _ZP_UNUSED(ztm);
+    _ZP_UNUSED(wbf);
+    _ZP_UNUSED(lane);
+#endif  // Z_FEATURE_RELIABILITY == 1
+}
+
 int8_t _z_multicast_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport_message_t *t_msg) {
     int8_t ret = _Z_RES_OK;
     _Z_DEBUG(">> send session message");
@@ -61,6 +86,7 @@ int8_t _z_multicast_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport
         ret = _z_link_send_wbuf(&ztm->_link, &ztm->_wbuf);
         if (ret == _Z_RES_OK) {
             ztm->_transmitted = true;  // Mark the session that we have transmitted data
+            _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&ztm->_wbuf));
         }
     }
 
@@ -71,86 +97,252 @@ int8_t _z_multicast_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport
     return ret;
 }
 
-int8_t _z_multicast_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg, z_reliability_t reliability,
-                               z_congestion_control_t cong_ctrl) {
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztm->_mutex_lanes[lane]
+ */
+static int8_t __unsafe_z_multicast_send_fragments(_z_transport_multicast_t *ztm, _z_wbuf_t *fbf, z_reliability_t reliability,
+                                                  uint8_t lane, _z_n_qos_t qos, _z_zint_t sn) {
     int8_t ret = _Z_RES_OK;
-    _Z_DEBUG(">> send network message");
 
-    _z_transport_multicast_t *ztm = &zn->_tp._transport._multicast;
+    // With vectored writes, the fragments reference the message instead of copying it
+    size_t max_refs = _z_link_write_vec_max(&ztm->_link);
+    max_refs = (max_refs > (size_t)1) ? max_refs - (size_t)1 : (size_t)0;
+
+    _Bool is_first = true;  // Fragment and send the message
+    while ((_z_wbuf_len(fbf) > 0) && (ret == _Z_RES_OK)) {
+        if (is_first == false) {  // Get the fragment sequence number
+            sn = __unsafe_z_multicast_get_sn(ztm, lane, reliability);
+        }
+        is_first = false;
+
+        // The TX lock is only held for one fragment, messages of the other lanes are sent in between
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    // Acquire the lock and drop the message if needed
+        // Clear the buffer for serialization
+        __unsafe_z_prepare_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
+
+        // Serialize one fragment
+        ret = __unsafe_z_serialize_zenoh_fragment(&ztm->_wbuf, fbf, reliability, sn, qos, max_refs);
+        if (ret == _Z_RES_OK) {
+            // Write the message length in the reserved space if needed
+            __unsafe_z_finalize_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
+            __unsafe_z_multicast_keep(ztm, &ztm->_wbuf, lane);
+
+            ret = _z_link_send_wbuf(&ztm->_link, &ztm->_wbuf);  // Send the wbuf on the socket
+            if (ret == _Z_RES_OK) {
+                ztm->_transmitted = true;  // Mark the session that we have transmitted data
+                _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&ztm->_wbuf));
+                _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_FRAGMENTS);
+            }
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    }
+
+    return ret;
+}
+
+static int8_t __z_multicast_send_n_msg(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msg,
+                                       z_reliability_t reliability, z_congestion_control_t cong_ctrl, uint8_t lane,
+                                       _z_n_qos_t qos) {
+    int8_t ret = _Z_RES_OK;
+
+    // Acquire the lane lock and drop the message if needed
     _Bool drop = false;
     if (cong_ctrl == Z_CONGESTION_CONTROL_BLOCK) {
 #if Z_FEATURE_MULTI_THREAD == 1
-        zp_mutex_lock(&ztm->_mutex_tx);
+        zp_mutex_lock(&ztm->_mutex_lanes[lane]);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
     } else {
 #if Z_FEATURE_MULTI_THREAD == 1
-        int8_t locked = zp_mutex_trylock(&ztm->_mutex_tx);
+        int8_t locked = zp_mutex_trylock(&ztm->_mutex_lanes[lane]);
         if (locked != (int8_t)0) {
             _Z_INFO("Dropping zenoh message because of congestion control");
             // We failed to acquire the lock, drop the message
             drop = true;
+            _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_CONGESTION_DROPS);
         }
 #endif  // Z_FEATURE_MULTI_THREAD == 1
     }
 
     if (drop == false) {
+        _Bool fragment = false;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
         // Prepare the buffer eventually reserving space for the message length
         __unsafe_z_prepare_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
 
-        _z_zint_t sn = __unsafe_z_multicast_get_sn(ztm, reliability);  // Get the next sequence number
+        _z_zint_t sn = __unsafe_z_multicast_get_sn(ztm, lane, reliability);  // Get the next sequence number
 
-        _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability);
+        _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability, qos);
         ret = _z_transport_message_encode(&ztm->_wbuf, &t_msg);  // Encode the frame header
         if (ret == _Z_RES_OK) {
             ret = _z_network_message_encode(&ztm->_wbuf, n_msg);  // Encode the network message
             if (ret == _Z_RES_OK) {
                 // Write the message length in the reserved space if needed
                 __unsafe_z_finalize_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
+                __unsafe_z_multicast_keep(ztm, &ztm->_wbuf, lane);
 
                 ret = _z_link_send_wbuf(&ztm->_link, &ztm->_wbuf);  // Send the wbuf on the socket
                 if (ret == _Z_RES_OK) {
                     ztm->_transmitted = true;  // Mark the session that we have transmitted data
+                    _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&ztm->_wbuf));
+                    _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_N_MSGS);
                 }
             } else {
                 // The message does not fit in the current batch, let's fragment it
-                // Create an expandable wbuf for fragmentation
-                _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+                fragment = true;
+            }
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+        if (fragment == true) {
+            // Encode the message on an expandable buffer, only the lane lock is held for the whole fragment train
+            _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+            ret = _z_network_message_encode(&fbf, n_msg);
+            if (ret == _Z_RES_OK) {
+                ret = __unsafe_z_multicast_send_fragments(ztm, &fbf, reliability, lane, qos, sn);
+            }
+            if (ret == _Z_RES_OK) {
+                _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_N_MSGS);
+            }
+            _z_wbuf_clear(&fbf);
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&ztm->_mutex_lanes[lane]);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    }
+
+    return ret;
+}
+
+int8_t _z_multicast_send_n_msg(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msg,
+                               z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
+    int8_t ret = _Z_ERR_CONNECTION_CLOSED;
+    _Z_DEBUG(">> send network message");
+
+    // Select the lane of the message priority, all the messages share the first lane if QoS is not announced
+    uint8_t lane = _z_conduit_sn_list_index(&ztm->_sn_tx_sns, _z_n_qos_get_priority(_z_n_msg_get_qos(n_msg)));
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    if (ztm->_tx_task_running == true) {
+        // Hand the message over to the TX task, its queue is closed if the task is being stopped
+        ret = _z_tx_queue_push(&ztm->_tx_queue, n_msg, reliability, lane, cong_ctrl);
+    }
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (ret == _Z_ERR_CONNECTION_CLOSED) {
+        _z_n_qos_t qos = (ztm->_sn_tx_sns._is_qos == true) ? _z_n_qos_make(0, 0, lane) : _Z_N_QOS_DEFAULT;
+        ret = __z_multicast_send_n_msg(ztm, n_msg, reliability, cong_ctrl, lane, qos);
+    }
+
+    return ret;
+}
+
+int8_t _z_multicast_send_n_batch(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msgs, size_t len,
+                                 z_reliability_t reliability) {
+    int8_t ret = _Z_RES_OK;
+    _Z_DEBUG(">> send network messages");
+
+    size_t i = 0;
+    uint8_t lane = 0;
+    if (len > (size_t)0) {
+        lane = _z_conduit_sn_list_index(&ztm->_sn_tx_sns, _z_n_qos_get_priority(_z_n_msg_get_qos(&n_msgs[0])));
+    }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    if (ztm->_tx_task_running == true) {
+        // The TX task packs the messages queued behind each other on a lane in the same frames
+        while ((i < len) && (ret == _Z_RES_OK)) {
+            ret = _z_tx_queue_push(&ztm->_tx_queue, &n_msgs[i], reliability, lane, Z_CONGESTION_CONTROL_BLOCK);
+            if (ret == _Z_RES_OK) {
+                i = i + (size_t)1;
+            }
+        }
+        if (ret == _Z_ERR_CONNECTION_CLOSED) {
+            ret = _Z_RES_OK;  // The task is being stopped, the remaining messages are sent directly
+        }
+    }
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if ((i < len) && (ret == _Z_RES_OK)) {
+        _z_n_qos_t qos = (ztm->_sn_tx_sns._is_qos == true) ? _z_n_qos_make(0, 0, lane) : _Z_N_QOS_DEFAULT;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&ztm->_mutex_lanes[lane]);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+        while ((i < len) && (ret == _Z_RES_OK)) {
+#if Z_FEATURE_MULTI_THREAD == 1
+            zp_mutex_lock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
 
-                ret = _z_network_message_encode(&fbf, n_msg);  // Encode the message on the expandable wbuf
+            // Prepare the buffer eventually reserving space for the message length
+            __unsafe_z_prepare_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
+
+            _z_zint_t sn = __unsafe_z_multicast_get_sn(ztm, lane, reliability);  // Get the next sequence number
+
+            _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability, qos);
+            ret = _z_transport_message_encode(&ztm->_wbuf, &t_msg);  // Encode the frame header
+
+            // Encode the messages as long as they fit in the frame
+            size_t n = 0;
+            while ((ret == _Z_RES_OK) && ((i + n) < len)) {
+                size_t w_pos = _z_wbuf_get_wpos(&ztm->_wbuf);
+                if (_z_network_message_encode(&ztm->_wbuf, &n_msgs[i + n]) != _Z_RES_OK) {
+                    _z_wbuf_set_wpos(&ztm->_wbuf, w_pos);  // Revert the buffer
+                    break;
+                }
+                n = n + (size_t)1;
+            }
+            if ((ret == _Z_RES_OK) && (n > (size_t)0)) {
+                // Write the message length in the reserved space if needed
+                __unsafe_z_finalize_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
+                __unsafe_z_multicast_keep(ztm, &ztm->_wbuf, lane);
+
+                ret = _z_link_send_wbuf(&ztm->_link, &ztm->_wbuf);  // Send the wbuf on the socket
                 if (ret == _Z_RES_OK) {
-                    _Bool is_first = true;  // Fragment and send the message
-                    while (_z_wbuf_len(&fbf) > 0) {
-                        if (is_first == false) {  // Get the fragment sequence number
-                            sn = __unsafe_z_multicast_get_sn(ztm, reliability);
-                        }
-                        is_first = false;
-
-                        // Clear the buffer for serialization
-                        __unsafe_z_prepare_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
-
-                        // Serialize one fragment
-                        ret = __unsafe_z_serialize_zenoh_fragment(&ztm->_wbuf, &fbf, reliability, sn);
-                        if (ret == _Z_RES_OK) {
-                            // Write the message length in the reserved space if needed
-                            __unsafe_z_finalize_wbuf(&ztm->_wbuf, ztm->_link._cap._flow);
-
-                            ret = _z_link_send_wbuf(&ztm->_link, &ztm->_wbuf);  // Send the wbuf on the socket
-                            if (ret == _Z_RES_OK) {
-                                ztm->_transmitted = true;  // Mark the session that we have transmitted data
-                            }
-                        }
-                    }
+                    ztm->_transmitted = true;  // Mark the session that we have transmitted data
+                    _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&ztm->_wbuf));
+                    _Z_STATS_ADD(&ztm->_stats, _Z_STATS_TX_N_MSGS, n);
                 }
+            }
 
-                // Clear the buffer as it's no longer required
+#if Z_FEATURE_MULTI_THREAD == 1
+            zp_mutex_unlock(&ztm->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+            if ((ret == _Z_RES_OK) && (n == (size_t)0)) {
+                // The message does not fit in a frame on its own, let's fragment it
+                _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+                ret = _z_network_message_encode(&fbf, &n_msgs[i]);
+                if (ret == _Z_RES_OK) {
+                    ret = __unsafe_z_multicast_send_fragments(ztm, &fbf, reliability, lane, qos, sn);
+                }
+                if (ret == _Z_RES_OK) {
+                    _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_N_MSGS);
+                }
                 _z_wbuf_clear(&fbf);
+                n = 1;
             }
+            i = i + n;
         }
 
 #if Z_FEATURE_MULTI_THREAD == 1
-        zp_mutex_unlock(&ztm->_mutex_tx);
+        zp_mutex_unlock(&ztm->_mutex_lanes[lane]);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
     }
 
@@ -164,12 +356,211 @@ int8_t _z_multicast_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport
     return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
 }
 
-int8_t _z_multicast_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg, z_reliability_t reliability,
-                               z_congestion_control_t cong_ctrl) {
-    _ZP_UNUSED(zn);
+int8_t _z_multicast_send_n_batch(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msgs, size_t len,
+                                 z_reliability_t reliability) {
+    _ZP_UNUSED(ztm);
+    _ZP_UNUSED(n_msgs);
+    _ZP_UNUSED(len);
+    _ZP_UNUSED(reliability);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+
+int8_t _z_multicast_send_n_msg(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msg,
+                               z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
+    _ZP_UNUSED(ztm);
     _ZP_UNUSED(n_msg);
     _ZP_UNUSED(reliability);
     _ZP_UNUSED(cong_ctrl);
     return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
 }
 #endif  // Z_FEATURE_MULTICAST_TRANSPORT == 1
+
+#if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_MULTICAST_TRANSPORT == 1
+
+/**
+ * Send a queued message, followed by the next queued messages of the same lane and reliability as long as they fit
+ * in the same frame. Return the first pulled message that is left to be sent, if any.
+ */
+static _z_tx_entry_t *__z_multicast_tx_task_send(_z_transport_multicast_t *ztm, _z_tx_entry_t *e) {
+    int8_t ret = _Z_RES_OK;
+    _z_tx_entry_t *next = NULL;
+    uint8_t lane = e->_lane;
+    z_reliability_t reliability = e->_reliability;
+    _z_n_qos_t qos = (ztm->_sn_tx_sns._is_qos == true) ? _z_n_qos_make(0, 0, lane) : _Z_N_QOS_DEFAULT;
+
+    // The lane lock is uncontended unless a message is sent directly while the task starts or stops
+    zp_mutex_lock(&ztm->_mutex_lanes[lane]);
+    zp_mutex_lock(&ztm->_mutex_tx);
+
+    // With batched writes, the frames of the messages queued behind on the same lane are built in the TX slots and
+    // sent together, otherwise a single frame is built in the TX buffer
+    _z_wbuf_t *wbfs = (ztm->_tx_slots != NULL) ? ztm->_tx_slots : &ztm->_wbuf;
+    size_t max = (ztm->_tx_slots != NULL) ? _z_link_batch_max(&ztm->_link) : (size_t)1;
+    size_t count = 0;
+
+    _z_zint_t sn = 0;
+    _Bool fragment = false;
+    while ((e != NULL) && (ret == _Z_RES_OK) && (fragment == false)) {
+        reliability = e->_reliability;
+
+        // Prepare the buffer eventually reserving space for the message length
+        __unsafe_z_prepare_wbuf(&wbfs[count], ztm->_link._cap._flow);
+
+        sn = __unsafe_z_multicast_get_sn(ztm, lane, reliability);  // Get the next sequence number
+
+        _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability, qos);
+        ret = _z_transport_message_encode(&wbfs[count], &t_msg);  // Encode the frame header
+        if (ret == _Z_RES_OK) {
+            if (_z_wbuf_space_left(&wbfs[count]) >= e->_len) {
+                while ((e != NULL) && (ret == _Z_RES_OK)) {
+                    ret = _z_wbuf_write_bytes(&wbfs[count], e->_buf, 0, e->_len);
+                    _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_N_MSGS);
+                    _z_tx_entry_free(&e);
+
+                    // Batch the messages already queued behind
+                    next = _z_tx_queue_pull(&ztm->_tx_queue);
+                    if ((next != NULL) && (next->_lane == lane) && (next->_reliability == reliability) &&
+                        (_z_wbuf_space_left(&wbfs[count]) >= next->_len)) {
+                        e = next;
+                        next = NULL;
+                    }
+                }
+                if (ret == _Z_RES_OK) {
+                    // Write the message length in the reserved space if needed
+                    __unsafe_z_finalize_wbuf(&wbfs[count], ztm->_link._cap._flow);
+                    __unsafe_z_multicast_keep(ztm, &wbfs[count], lane);
+                    count = count + (size_t)1;
+
+                    // Start another frame with the next message of the lane if a slot is left
+                    if ((next != NULL) && (next->_lane == lane) && (count < max)) {
+                        e = next;
+                        next = NULL;
+                    }
+                }
+            } else {
+                // The message does not fit in a frame, let's fragment it once the previous frames have been sent
+                fragment = true;
+            }
+        }
+    }
+
+    if ((ret == _Z_RES_OK) && (count > (size_t)0)) {
+        ret = _z_link_send_wbufs(&ztm->_link, wbfs, count);  // Send the frames on the socket
+        if (ret == _Z_RES_OK) {
+            ztm->_transmitted = true;  // Mark the session that we have transmitted data
+#if Z_FEATURE_STATS == 1
+            for (size_t i = 0; i < count; i++) {
+                _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&wbfs[i]));
+            }
+#endif  // Z_FEATURE_STATS == 1
+        }
+    }
+
+    zp_mutex_unlock(&ztm->_mutex_tx);
+
+    if (fragment == true) {
+        // The fragments are serialized from the queued message without copying it
+        _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+        ret = _z_wbuf_wrap_bytes(&fbf, e->_buf, 0, e->_len);
+        if (ret == _Z_RES_OK) {
+            ret = __unsafe_z_multicast_send_fragments(ztm, &fbf, reliability, lane, qos, sn);
+        }
+        if (ret == _Z_RES_OK) {
+            _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_N_MSGS);
+        }
+        _z_wbuf_clear(&fbf);
+    }
+
+    zp_mutex_unlock(&ztm->_mutex_lanes[lane]);
+
+    if (ret != _Z_RES_OK) {
+        _Z_ERROR("TX task failed to send a network message");
+    }
+    _z_tx_entry_free(&e);
+    return next;
+}
+
+void *_zp_multicast_tx_task(void *ztm_arg) {
+    _z_transport_multicast_t *ztm = (_z_transport_multicast_t *)ztm_arg;
+
+    // The queue is drained once closed, so that all the messages accepted before stopping are sent
+    _z_tx_entry_t *e = NULL;
+    _Bool running = true;
+    while (running == true) {
+        if (e == NULL) {
+            e = _z_tx_queue_pull(&ztm->_tx_queue);
+        }
+        if (e != NULL) {
+            e = __z_multicast_tx_task_send(ztm, e);
+        } else if (_z_tx_queue_is_done(&ztm->_tx_queue) == true) {
+            running = false;
+        } else {
+            // Also waits for the publishers that passed the closing of the queue to be done pushing
+            _z_tx_queue_wait(&ztm->_tx_queue);
+        }
+    }
+
+    return NULL;
+}
+
+int8_t _zp_multicast_start_tx_task(_z_transport_multicast_t *ztm, zp_task_attr_t *attr, zp_task_t *task) {
+    if (ztm->_tx_task != NULL) {
+        return _Z_ERR_GENERIC;
+    }
+    // Init memory
+    (void)memset(task, 0, sizeof(zp_task_t));
+    // Open the queue
+    int8_t ret = _z_tx_queue_open(&ztm->_tx_queue);
+    if (ret != _Z_RES_OK) {
+        return ret;
+    }
+#if Z_FEATURE_STATS == 1
+    // The messages dropped by the queue are accounted for in the transport
+    ztm->_tx_queue._stats = &ztm->_stats;
+#endif  // Z_FEATURE_STATS == 1
+    // Frames are only built in slots when the link sends several datagrams at once, the task falls back to the TX
+    // buffer if they cannot be allocated
+    ztm->_tx_slots = _z_tx_slots_make(&ztm->_link, _z_wbuf_capacity(&ztm->_wbuf));
+    // Init task
+    if (zp_task_init(task, attr, _zp_multicast_tx_task, ztm) != _Z_RES_OK) {
+        _z_tx_queue_close(&ztm->_tx_queue);
+        _z_tx_slots_free(&ztm->_tx_slots, &ztm->_link);
+        return _Z_ERR_SYSTEM_TASK_FAILED;
+    }
+    // Attach task
+    ztm->_tx_task = task;
+    ztm->_tx_task_running = true;
+    return _Z_RES_OK;
+}
+
+int8_t _zp_multicast_stop_tx_task(_z_transport_multicast_t *ztm) {
+    if (ztm->_tx_task != NULL) {
+        // New messages are sent directly, the task exits once it sent the queued ones
+        ztm->_tx_task_running = false;
+        _z_tx_queue_close(&ztm->_tx_queue);
+        zp_task_join(ztm->_tx_task);
+        zp_task_free(&ztm->_tx_task);
+        _z_tx_slots_free(&ztm->_tx_slots, &ztm->_link);
+    }
+    return _Z_RES_OK;
+}
+
+#else
+
+void *_zp_multicast_tx_task(void *ztm_arg) {
+    _ZP_UNUSED(ztm_arg);
+    return NULL;
+}
+
+int8_t _zp_multicast_start_tx_task(_z_transport_multicast_t *ztm, void *attr, void *task) {
+    _ZP_UNUSED(ztm);
+    _ZP_UNUSED(attr);
+    _ZP_UNUSED(task);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+
+int8_t _zp_multicast_stop_tx_task(_z_transport_multicast_t *ztm) {
+    _ZP_UNUSED(ztm);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+#endif  // Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_MULTICAST_TRANSPORT == 1
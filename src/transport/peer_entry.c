@@ -12,27 +12,43 @@
 //   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
 //
 
+#include <stddef.h>
+#include <string.h>
+
+#include "zenoh-pico/collections/string.h"
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/system/platform.h"
 #include "zenoh-pico/transport/transport.h"
+#include "zenoh-pico/utils/result.h"
 #include "zenoh-pico/transport/utils.h"
 
 void _z_transport_peer_entry_clear(_z_transport_peer_entry_t *src) {
-    _z_wbuf_clear(&src->_dbuf_reliable);
-    _z_wbuf_clear(&src->_dbuf_best_effort);
+    for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
+        _z_dbuf_clear(&src->_dbuf_reliable[i]);
+        _z_dbuf_clear(&src->_dbuf_best_effort[i]);
+    }
+#if Z_FEATURE_RELIABILITY == 1
+    _z_reliability_reorders_free(&src->_rx_reorder, Z_PRIORITIES_NUM);
+#endif  // Z_FEATURE_RELIABILITY == 1
 
     src->_remote_zid = _z_id_empty();
     _z_bytes_clear(&src->_remote_addr);
 }
 
 void _z_transport_peer_entry_copy(_z_transport_peer_entry_t *dst, const _z_transport_peer_entry_t *src) {
-    _z_wbuf_copy(&dst->_dbuf_reliable, &src->_dbuf_reliable);
-    _z_wbuf_copy(&dst->_dbuf_best_effort, &src->_dbuf_best_effort);
+    for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
+        _z_dbuf_copy(&dst->_dbuf_reliable[i], &src->_dbuf_reliable[i]);
+        _z_dbuf_copy(&dst->_dbuf_best_effort[i], &src->_dbuf_best_effort[i]);
+    }
 
     dst->_sn_res = src->_sn_res;
     _z_conduit_sn_list_copy(&dst->_sn_rx_sns, &src->_sn_rx_sns);
+#if Z_FEATURE_RELIABILITY == 1
+    dst->_rx_reorder = NULL;  // The copy starts over without the messages waiting to be reordered
+#endif  // Z_FEATURE_RELIABILITY == 1
 
     dst->_lease = src->_lease;
-    dst->_next_lease = src->_next_lease;
+    dst->_lease_deadline = src->_lease_deadline;
     dst->_received = src->_received;
 
     dst->_remote_zid = src->_remote_zid;
@@ -52,3 +68,228 @@ _Bool _z_transport_peer_entry_eq(const _z_transport_peer_entry_t *left, const _z
 
     return ret;
 }
+
+/*------------------ Peer table ------------------*/
+static inline size_t __z_transport_peer_addr_hash(const _z_bytes_t *remote_addr) {
+    return _z_str_hash((const char *)remote_addr->start, remote_addr->len);
+}
+
+static inline size_t __z_transport_peer_slot_index(size_t hash, size_t capacity) {
+    return (hash ^ (hash >> 16)) & (capacity - (size_t)1);
+}
+
+static void __z_transport_peer_slots_put(_z_transport_peer_slot_t *slots, size_t capacity, size_t hash,
+                                         _z_transport_peer_entry_t *entry) {
+    size_t i = __z_transport_peer_slot_index(hash, capacity);
+    while (slots[i]._entry != NULL) {
+        i = (i + (size_t)1) & (capacity - (size_t)1);
+    }
+    slots[i]._hash = hash;
+    slots[i]._entry = entry;
+}
+
+static void __z_transport_peer_slots_remove(_z_transport_peer_slot_t *slots, size_t capacity, size_t hash,
+                                            const _z_transport_peer_entry_t *entry) {
+    size_t mask = capacity - (size_t)1;
+    size_t i = __z_transport_peer_slot_index(hash, capacity);
+    while ((slots[i]._entry != NULL) && (slots[i]._entry != entry)) {
+        i = (i + (size_t)1) & mask;
+    }
+    if (slots[i]._entry == NULL) {
+        return;
+    }
+
+    // Shift back the following entries of the cluster to keep the probing sequences unbroken
+    size_t j = i;
+    while (true) {
+        j = (j + (size_t)1) & mask;
+        if (slots[j]._entry == NULL) {
+            break;
+        }
+        size_t k = __z_transport_peer_slot_index(slots[j]._hash, capacity);
+        _Bool in_place = (i <= j) ? ((i < k) && (k <= j)) : ((i < k) || (k <= j));
+        if (in_place == false) {
+            slots[i] = slots[j];
+            i = j;
+        }
+    }
+    slots[i]._hash = 0;
+    slots[i]._entry = NULL;
+}
+
+static void __z_transport_peer_heap_set(_z_transport_peer_table_t *table, size_t idx,
+                                        _z_transport_peer_entry_t *entry) {
+    table->_by_lease[idx] = entry;
+    entry->_lease_idx = idx;
+}
+
+static void __z_transport_peer_heap_sift_up(_z_transport_peer_table_t *table, size_t idx) {
+    _z_transport_peer_entry_t *entry = table->_by_lease[idx];
+    while (idx > (size_t)0) {
+        size_t parent = (idx - (size_t)1) / (size_t)2;
+        if (table->_by_lease[parent]->_lease_deadline <= entry->_lease_deadline) {
+            break;
+        }
+        __z_transport_peer_heap_set(table, idx, table->_by_lease[parent]);
+        idx = parent;
+    }
+    __z_transport_peer_heap_set(table, idx, entry);
+}
+
+static void __z_transport_peer_heap_sift_down(_z_transport_peer_table_t *table, size_t idx) {
+    _z_transport_peer_entry_t *entry = table->_by_lease[idx];
+    while (true) {
+        size_t child = (idx * (size_t)2) + (size_t)1;
+        if (child >= table->_len) {
+            break;
+        }
+        if (((child + (size_t)1) < table->_len) &&
+            (table->_by_lease[child + (size_t)1]->_lease_deadline < table->_by_lease[child]->_lease_deadline)) {
+            child = child + (size_t)1;
+        }
+        if (entry->_lease_deadline <= table->_by_lease[child]->_lease_deadline) {
+            break;
+        }
+        __z_transport_peer_heap_set(table, idx, table->_by_lease[child]);
+        idx = child;
+    }
+    __z_transport_peer_heap_set(table, idx, entry);
+}
+
+static int8_t __z_transport_peer_table_resize(_z_transport_peer_table_t *table, size_t capacity) {
+    _z_transport_peer_slot_t *by_addr =
+        (_z_transport_peer_slot_t *)zp_malloc(capacity * sizeof(_z_transport_peer_slot_t));
+    _z_transport_peer_entry_t **by_lease =
+        (_z_transport_peer_entry_t **)zp_malloc(capacity * sizeof(_z_transport_peer_entry_t *));
+    if ((by_addr == NULL) || (by_lease == NULL)) {
+        zp_free(by_addr);
+        zp_free(by_lease);
+        return _Z_ERR_SYSTEM_OUT_OF_MEMORY;
+    }
+    (void)memset(by_addr, 0, capacity * sizeof(_z_transport_peer_slot_t));
+
+    for (size_t i = 0; i < table->_capacity; i++) {
+        if (table->_by_addr[i]._entry != NULL) {
+            __z_transport_peer_slots_put(by_addr, capacity, table->_by_addr[i]._hash, table->_by_addr[i]._entry);
+        }
+    }
+    // The heap keeps its order, the positions of the entries do not change
+    if (table->_len > (size_t)0) {
+        (void)memcpy(by_lease, table->_by_lease, table->_len * sizeof(_z_transport_peer_entry_t *));
+    }
+
+    zp_free(table->_by_addr);
+    zp_free(table->_by_lease);
+    table->_by_addr = by_addr;
+    table->_by_lease = by_lease;
+    table->_capacity = capacity;
+    return _Z_RES_OK;
+}
+
+static _Bool __z_transport_peer_table_has_id(const _z_transport_peer_table_t *table, uint16_t id) {
+    _Bool ret = false;
+    for (size_t i = 0; (ret == false) && (i < table->_len); i++) {
+        ret = table->_by_lease[i]->_peer_id == id;
+    }
+    return ret;
+}
+
+void _z_transport_peer_table_init(_z_transport_peer_table_t *table) {
+    table->_by_addr = NULL;
+    table->_by_lease = NULL;
+    table->_capacity = 0;
+    table->_len = 0;
+    table->_next_peer_id = 1;
+}
+
+void _z_transport_peer_table_clear(_z_transport_peer_table_t *table) {
+    for (size_t i = 0; i < table->_len; i++) {
+        _z_transport_peer_entry_elem_free((void **)&table->_by_lease[i]);
+    }
+    zp_free(table->_by_addr);
+    zp_free(table->_by_lease);
+    _z_transport_peer_table_init(table);
+}
+
+_z_transport_peer_entry_t *_z_transport_peer_table_get(const _z_transport_peer_table_t *table,
+                                                       const _z_bytes_t *remote_addr) {
+    if (table->_len == (size_t)0) {
+        return NULL;
+    }
+    size_t hash = __z_transport_peer_addr_hash(remote_addr);
+    size_t i = __z_transport_peer_slot_index(hash, table->_capacity);
+    while (table->_by_addr[i]._entry != NULL) {
+        const _z_bytes_t *addr = &table->_by_addr[i]._entry->_remote_addr;
+        if ((table->_by_addr[i]._hash == hash) && (addr->len == remote_addr->len) &&
+            (memcmp(addr->start, remote_addr->start, remote_addr->len) == 0)) {
+            return table->_by_addr[i]._entry;
+        }
+        i = (i + (size_t)1) & (table->_capacity - (size_t)1);
+    }
+    return NULL;
+}
+
+int8_t _z_transport_peer_table_insert(_z_transport_peer_table_t *table, _z_transport_peer_entry_t *entry) {
+    // Every peer id but the local and the unicast transport mappings may be allocated
+    if ((table->_len + (size_t)1) >= (size_t)_Z_KEYEXPR_MAPPING_PEER_END) {
+        return _Z_ERR_GENERIC;
+    }
+
+    // Keep the load factor below 3/4
+    if (((table->_len + (size_t)1) * (size_t)4) > (table->_capacity * (size_t)3)) {
+        size_t capacity = (table->_capacity == (size_t)0) ? (size_t)_Z_TRANSPORT_PEER_TABLE_DEFAULT_CAPACITY
+                                                          : table->_capacity * (size_t)2;
+        int8_t ret = __z_transport_peer_table_resize(table, capacity);
+        if (ret != _Z_RES_OK) {
+            return ret;
+        }
+    }
+
+    // Peer ids key the remote resources, they are not reused before wrapping around to limit stale mappings
+    uint16_t id = table->_next_peer_id;
+    while (__z_transport_peer_table_has_id(table, id) == true) {
+        id = ((id + 1) < _Z_KEYEXPR_MAPPING_PEER_END) ? (uint16_t)(id + 1) : (uint16_t)1;
+    }
+    entry->_peer_id = id;
+    table->_next_peer_id = ((id + 1) < _Z_KEYEXPR_MAPPING_PEER_END) ? (uint16_t)(id + 1) : (uint16_t)1;
+
+    __z_transport_peer_slots_put(table->_by_addr, table->_capacity, __z_transport_peer_addr_hash(&entry->_remote_addr),
+                                 entry);
+    __z_transport_peer_heap_set(table, table->_len, entry);
+    table->_len = table->_len + (size_t)1;
+    __z_transport_peer_heap_sift_up(table, entry->_lease_idx);
+    return _Z_RES_OK;
+}
+
+void _z_transport_peer_table_remove(_z_transport_peer_table_t *table, _z_transport_peer_entry_t *entry) {
+    __z_transport_peer_slots_remove(table->_by_addr, table->_capacity,
+                                    __z_transport_peer_addr_hash(&entry->_remote_addr), entry);
+
+    // Move the last entry of the heap in place of the removed one, then restore the heap order
+    size_t idx = entry->_lease_idx;
+    table->_len = table->_len - (size_t)1;
+    if (idx < table->_len) {
+        _z_transport_peer_entry_t *last = table->_by_lease[table->_len];
+        __z_transport_peer_heap_set(table, idx, last);
+        __z_transport_peer_heap_sift_down(table, idx);
+        __z_transport_peer_heap_sift_up(table, last->_lease_idx);
+    }
+    table->_by_lease[table->_len] = NULL;
+
+    _z_transport_peer_entry_elem_free((void **)&entry);
+}
+
+_z_transport_peer_entry_t *_z_transport_peer_table_next_lease(const _z_transport_peer_table_t *table) {
+    return (table->_len > (size_t)0) ? table->_by_lease[0] : NULL;
+}
+
+void _z_transport_peer_table_renew_lease(_z_transport_peer_table_t *table, _z_transport_peer_entry_t *entry,
+                                         _z_zint_t deadline) {
+    _z_zint_t previous = entry->_lease_deadline;
+    entry->_lease_deadline = deadline;
+    if (deadline < previous) {
+        __z_transport_peer_heap_sift_up(table, entry->_lease_idx);
+    } else {
+        __z_transport_peer_heap_sift_down(table, entry->_lease_idx);
+    }
+}
@@ -81,28 +81,34 @@ int8_t _z_raweth_recv_t_msg_na(_z_transport_multicast_t *ztm, _z_transport_messa
     zp_mutex_lock(&ztm->_mutex_rx);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    // Prepare the buffer
-    _z_zbuf_reset(&ztm->_zbuf);
+    // A retained payload pins the batch, read into another one
+    ret = _z_rx_pool_renew(ztm->_rx_pool, &ztm->_rx_batch, &ztm->_zbuf);
+    if (ret == _Z_RES_OK) {
+        // Prepare the buffer
+        _z_zbuf_reset(&ztm->_zbuf);
 
-    switch (ztm->_link._cap._flow) {
-        // Datagram capable links
-        case Z_LINK_CAP_FLOW_DATAGRAM: {
-            _z_zbuf_compact(&ztm->_zbuf);
-            // Read from link
-            size_t to_read = _z_raweth_link_recv_zbuf(&ztm->_link, &ztm->_zbuf, addr);
-            if (to_read == SIZE_MAX) {
-                ret = _Z_ERR_TRANSPORT_RX_FAILED;
+        switch (ztm->_link._cap._flow) {
+            // Datagram capable links
+            case Z_LINK_CAP_FLOW_DATAGRAM: {
+                _z_zbuf_compact(&ztm->_zbuf);
+                // Read from link
+                size_t to_read = _z_raweth_link_recv_zbuf(&ztm->_link, &ztm->_zbuf, addr);
+                if (to_read == SIZE_MAX) {
+                    ret = _Z_ERR_TRANSPORT_RX_FAILED;
+                } else {
+                    _Z_STATS_RX_BATCH(&ztm->_stats, to_read);
+                }
+                break;
             }
-            break;
+            default:
+                ret = _Z_ERR_GENERIC;
+                break;
         }
-        default:
-            ret = _Z_ERR_GENERIC;
-            break;
     }
     // Decode message
     if (ret == _Z_RES_OK) {
         _Z_DEBUG(">> \t transport_message_decode: %ju", (uintmax_t)_z_zbuf_len(&ztm->_zbuf));
-        ret = _z_transport_message_decode(t_msg, &ztm->_zbuf);
+        ret = _z_transport_message_decode_stream(t_msg, &ztm->_zbuf);
     }
 
 #if Z_FEATURE_MULTI_THREAD == 1
@@ -88,13 +88,15 @@ static int8_t _zp_raweth_set_socket(const _z_keyexpr_t *keyexpr, _z_raweth_socke
  *  - ztm->_mutex_inner
  */
 static _z_zint_t __unsafe_z_raweth_get_sn(_z_transport_multicast_t *ztm, z_reliability_t reliability) {
+    // Raw ethernet frames are always sent on a single conduit
+    _z_coundit_sn_t *sn_tx = &ztm->_sn_tx_sns._val._plain;
     _z_zint_t sn;
     if (reliability == Z_RELIABILITY_RELIABLE) {
-        sn = ztm->_sn_tx_reliable;
-        ztm->_sn_tx_reliable = _z_sn_increment(ztm->_sn_res, ztm->_sn_tx_reliable);
+        sn = sn_tx->_reliable;
+        sn_tx->_reliable = _z_sn_increment(ztm->_sn_res, sn_tx->_reliable);
     } else {
-        sn = ztm->_sn_tx_best_effort;
-        ztm->_sn_tx_best_effort = _z_sn_increment(ztm->_sn_res, ztm->_sn_tx_best_effort);
+        sn = sn_tx->_best_effort;
+        sn_tx->_best_effort = _z_sn_increment(ztm->_sn_res, sn_tx->_best_effort);
     }
     return sn;
 }
@@ -211,6 +213,7 @@ int8_t _z_raweth_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport_me
     _Z_CLEAN_RETURN_IF_ERR(_z_raweth_link_send_wbuf(&ztm->_link, &ztm->_wbuf), _zp_raweth_unlock_tx_mutex(ztm));
     // Mark the session that we have transmitted data
     ztm->_transmitted = true;
+    _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&ztm->_wbuf));
 
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&ztm->_mutex_tx);
@@ -219,10 +222,9 @@ int8_t _z_raweth_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport_me
     return ret;
 }
 
-int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg, z_reliability_t reliability,
-                            z_congestion_control_t cong_ctrl) {
+int8_t _z_raweth_send_n_msg(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msg,
+                            z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
     int8_t ret = _Z_RES_OK;
-    _z_transport_multicast_t *ztm = &zn->_tp._transport._raweth;
     _Z_DEBUG(">> send network message");
 
     // Acquire the lock and drop the message if needed
@@ -232,6 +234,7 @@ int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg,
     } else {
         if (zp_mutex_trylock(&ztm->_mutex_tx) != (int8_t)0) {
             _Z_INFO("Dropping zenoh message because of congestion control");
+            _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_CONGESTION_DROPS);
             // We failed to acquire the lock, drop the message
             return ret;
         }
@@ -265,7 +268,7 @@ int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg,
     __unsafe_z_raweth_prepare_header(&ztm->_link, &ztm->_wbuf);
     // Set the frame header
     _z_zint_t sn = __unsafe_z_raweth_get_sn(ztm, reliability);
-    _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability);
+    _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability, _Z_N_QOS_DEFAULT);
     // Encode the frame header
     _Z_CLEAN_RETURN_IF_ERR(_z_transport_message_encode(&ztm->_wbuf, &t_msg), _zp_raweth_unlock_tx_mutex(ztm));
     // Encode the network message
@@ -277,6 +280,7 @@ int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg,
         _Z_CLEAN_RETURN_IF_ERR(_z_raweth_link_send_wbuf(&ztm->_link, &ztm->_wbuf), _zp_raweth_unlock_tx_mutex(ztm));
         // Mark the session that we have transmitted data
         ztm->_transmitted = true;
+        _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&ztm->_wbuf));
     } else {  // The message does not fit in the current batch, let's fragment it
         // Create an expandable wbuf for fragmentation
         _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
@@ -295,7 +299,7 @@ int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg,
             // Prepare buff
             __unsafe_z_raweth_prepare_header(&ztm->_link, &ztm->_wbuf);
             // Serialize one fragment
-            _Z_CLEAN_RETURN_IF_ERR(__unsafe_z_serialize_zenoh_fragment(&ztm->_wbuf, &fbf, reliability, sn),
+            _Z_CLEAN_RETURN_IF_ERR(__unsafe_z_serialize_zenoh_fragment(&ztm->_wbuf, &fbf, reliability, sn, _Z_N_QOS_DEFAULT, 0),
                                    _zp_raweth_unlock_tx_mutex(ztm));
             // Write the eth header
             _Z_CLEAN_RETURN_IF_ERR(__unsafe_z_raweth_write_header(&ztm->_link, &ztm->_wbuf),
@@ -304,10 +308,13 @@ int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg,
             _Z_CLEAN_RETURN_IF_ERR(_z_raweth_link_send_wbuf(&ztm->_link, &ztm->_wbuf), _zp_raweth_unlock_tx_mutex(ztm));
             // Mark the session that we have transmitted data
             ztm->_transmitted = true;
+            _Z_STATS_TX_BATCH(&ztm->_stats, _z_wbuf_len(&ztm->_wbuf));
+            _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_FRAGMENTS);
         }
         // Clear the expandable buffer
         _z_wbuf_clear(&fbf);
     }
+    _Z_STATS_INC(&ztm->_stats, _Z_STATS_TX_N_MSGS);
 #if Z_FEATURE_MULTI_THREAD == 1
     zp_mutex_unlock(&ztm->_mutex_tx);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
@@ -326,9 +333,9 @@ int8_t _z_raweth_send_t_msg(_z_transport_multicast_t *ztm, const _z_transport_me
     return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
 }
 
-int8_t _z_raweth_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg, z_reliability_t reliability,
-                            z_congestion_control_t cong_ctrl) {
-    _ZP_UNUSED(zn);
+int8_t _z_raweth_send_n_msg(_z_transport_multicast_t *ztm, const _z_network_message_t *n_msg,
+                            z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
+    _ZP_UNUSED(ztm);
     _ZP_UNUSED(n_msg);
     _ZP_UNUSED(reliability);
     _ZP_UNUSED(cong_ctrl);
@@ -66,6 +66,36 @@ void _z_transport_clear(_z_transport_t *zt) {
     }
 }
 
+const _z_link_t *_z_transport_link(const _z_transport_t *zt) {
+    const _z_link_t *link = NULL;
+    switch (zt->_type) {
+        case _Z_TRANSPORT_UNICAST_TYPE:
+            link = &zt->_transport._unicast._link;
+            break;
+        case _Z_TRANSPORT_MULTICAST_TYPE:
+            link = &zt->_transport._multicast._link;
+            break;
+        case _Z_TRANSPORT_RAWETH_TYPE:
+            link = &zt->_transport._raweth._link;
+            break;
+        default:
+            break;
+    }
+    return link;
+}
+
+_Bool _z_transport_is_up(const _z_transport_t *zt) {
+    _Bool ret = true;
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    if (zt->_type == _Z_TRANSPORT_UNICAST_TYPE) {
+        ret = (zt->_transport._unicast._is_down == false);
+    }
+#else
+    _ZP_UNUSED(zt);
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+    return ret;
+}
+
 void _z_transport_free(_z_transport_t **zt) {
     _z_transport_t *ptr = *zt;
     if (ptr == NULL) {
@@ -76,43 +106,3 @@ void _z_transport_free(_z_transport_t **zt) {
     zp_free(ptr);
     *zt = NULL;
 }
-
-/**
- * @brief Inserts an entry into `root`, allocating it a `_peer_id`
- *
- * @param root the insertion root.
- * @param entry the entry to be inserted.
- * @return _z_transport_peer_entry_list_t* the new root, after inserting the entry.
- */
-_z_transport_peer_entry_list_t *_z_transport_peer_entry_list_insert(_z_transport_peer_entry_list_t *root,
-                                                                    _z_transport_peer_entry_t *entry) {
-    if (root == NULL) {
-        entry->_peer_id = 1;
-        root = _z_transport_peer_entry_list_push(root, entry);
-    } else {
-        _z_transport_peer_entry_t *head = _z_transport_peer_entry_list_head(root);
-        if (head->_peer_id + 1 < _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE) {
-            entry->_peer_id = head->_peer_id + 1;
-            root = _z_transport_peer_entry_list_push(root, entry);
-        } else {
-            _z_transport_peer_entry_list_t *parent = root;
-            uint16_t target = head->_peer_id - 1;
-            while (parent->_tail != NULL) {
-                _z_transport_peer_entry_list_t *list = _z_transport_peer_entry_list_tail(parent);
-                head = _z_transport_peer_entry_list_head(list);
-                if (head->_peer_id < target) {
-                    entry->_peer_id = head->_peer_id + 1;
-                    parent->_tail = _z_transport_peer_entry_list_push(list, entry);
-                    return root;
-                }
-                parent = list;
-                target = head->_peer_id - 1;
-            }
-            assert(target > 0);
-            entry->_peer_id = 1;
-            parent->_tail = _z_transport_peer_entry_list_push(NULL, entry);
-            parent->_tail->_val = entry;
-        }
-    }
-    return root;
-}
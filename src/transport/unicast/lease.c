@@ -14,6 +14,8 @@
 
 #include "zenoh-pico/transport/unicast/lease.h"
 
+#include "zenoh-pico/session/query.h"
+
 #include "zenoh-pico/transport/unicast/transport.h"
 #include "zenoh-pico/transport/unicast/tx.h"
 #include "zenoh-pico/utils/logging.h"
@@ -25,44 +27,48 @@ int8_t _zp_unicast_send_keep_alive(_z_transport_unicast_t *ztu) {
 
     _z_transport_message_t t_msg = _z_t_msg_make_keep_alive();
     ret = _z_unicast_send_t_msg(ztu, &t_msg);
+    if (ret == _Z_RES_OK) {
+        _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_KEEP_ALIVES);
+    }
 
     return ret;
 }
-#else
-
-int8_t _zp_unicast_send_keep_alive(_z_transport_unicast_t *ztu) {
-    _ZP_UNUSED(ztu);
-    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
-}
-#endif  // Z_FEATURE_UNICAST_TRANSPORT == 1
-
-#if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
-
-void *_zp_unicast_lease_task(void *ztu_arg) {
-    _z_transport_unicast_t *ztu = (_z_transport_unicast_t *)ztu_arg;
 
+void _zp_unicast_lease_start(_z_transport_unicast_t *ztu) {
     ztu->_received = false;
     ztu->_transmitted = false;
 
-    _z_zint_t next_lease = ztu->_lease;
-    _z_zint_t next_keep_alive = (_z_zint_t)(ztu->_lease / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
-    while (ztu->_lease_task_running == true) {
-        if (next_lease == 0) {
-            // Check if received data
-            if (ztu->_received == true) {
-                // Reset the lease parameters
-                ztu->_received = false;
-            } else {
-                _Z_INFO("Closing session because it has expired after %zums", ztu->_lease);
-                ztu->_lease_task_running = false;
-                _z_unicast_transport_close(ztu, _Z_CLOSE_EXPIRED);
-                break;
-            }
+    // All the deadlines are absolute, in milliseconds on the lease clock of the transport
+    ztu->_lease_epoch = zp_clock_now();
+    ztu->_next_lease = ztu->_lease;
+    ztu->_next_keep_alive = (_z_zint_t)(ztu->_lease / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
+#if Z_FEATURE_BATCHING == 1
+    ztu->_batch_wake = 0;
+#endif  // Z_FEATURE_BATCHING == 1
+}
 
-            next_lease = ztu->_lease;
+int8_t _zp_unicast_lease_step(_z_transport_unicast_t *ztu, _z_zint_t *interval) {
+    int8_t ret = _Z_RES_OK;
+    _z_zint_t now = (_z_zint_t)zp_clock_elapsed_ms(&ztu->_lease_epoch);
+
+    if (ztu->_next_lease <= now) {
+        // Check if received data
+        if (ztu->_received == true) {
+            // Reset the lease parameters
+            ztu->_received = false;
+            ztu->_next_lease = now + ztu->_lease;
+        } else {
+            _Z_INFO("Closing session because it has expired after %zums", ztu->_lease);
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+            ztu->_is_down = true;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+            _z_unicast_transport_close(ztu, _Z_CLOSE_EXPIRED);
+            ret = _Z_ERR_CONNECTION_CLOSED;
         }
+    }
 
-        if (next_keep_alive <= 0) {
+    if (ret == _Z_RES_OK) {
+        if (ztu->_next_keep_alive <= now) {
             // Check if need to send a keep alive
             if (ztu->_transmitted == false) {
                 if (_zp_unicast_send_keep_alive(ztu) < 0) {
@@ -72,25 +78,82 @@ void *_zp_unicast_lease_task(void *ztu_arg) {
 
             // Reset the keep alive parameters
             ztu->_transmitted = false;
-            next_keep_alive = (_z_zint_t)(ztu->_lease / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
+            ztu->_next_keep_alive = now + (_z_zint_t)(ztu->_lease / Z_TRANSPORT_LEASE_EXPIRE_FACTOR);
         }
 
         // Compute the target interval
-        _z_zint_t interval;
-        if (next_lease == 0) {
-            interval = next_keep_alive;
-        } else {
-            interval = next_lease;
-            if (next_keep_alive < interval) {
-                interval = next_keep_alive;
+        _z_zint_t deadline = (ztu->_next_lease < ztu->_next_keep_alive) ? ztu->_next_lease : ztu->_next_keep_alive;
+        *interval = (deadline > now) ? (deadline - now) : 0;
+
+#if Z_FEATURE_RELIABILITY == 1
+        // Retransmit the reliable messages whose acknowledgment is overdue, and run in time for the next ones
+        if (ztu->_tx_window != NULL) {
+#if Z_FEATURE_MULTI_THREAD == 1
+            zp_mutex_lock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+            for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
+                if (_z_reliability_window_resend_expired(&ztu->_tx_window[i], &ztu->_link, now,
+                                                         (_z_zint_t)Z_RELIABILITY_RTO) != _Z_RES_OK) {
+                    _Z_INFO("Failed to retransmit the unacknowledged messages");
+                }
             }
+#if Z_FEATURE_MULTI_THREAD == 1
+            zp_mutex_unlock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+            if (*interval > (_z_zint_t)Z_RELIABILITY_RTO) {
+                *interval = (_z_zint_t)Z_RELIABILITY_RTO;
+            }
+        }
+#endif  // Z_FEATURE_RELIABILITY == 1
+
+#if Z_FEATURE_QUERY == 1
+        // Expire the pending queries and run in time for the next deadline
+        _z_process_query_timeouts((_z_session_t *)ztu->_session);
+        *interval = _z_get_next_query_timeout((_z_session_t *)ztu->_session, *interval);
+#endif  // Z_FEATURE_QUERY == 1
+
+#if Z_FEATURE_BATCHING == 1
+        // Flush the expired batch and run in time for the pending one
+        if (_z_unicast_batch_step(ztu, now, interval) != _Z_RES_OK) {
+            // The batch is dropped, the transport is not marked as transmitted and keeps alive on its own
+            _Z_ERROR("Failed to flush the expired batch");
+        }
+#endif  // Z_FEATURE_BATCHING == 1
+    }
+
+    return ret;
+}
+#else
+
+int8_t _zp_unicast_send_keep_alive(_z_transport_unicast_t *ztu) {
+    _ZP_UNUSED(ztu);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+
+void _zp_unicast_lease_start(_z_transport_unicast_t *ztu) { _ZP_UNUSED(ztu); }
+
+int8_t _zp_unicast_lease_step(_z_transport_unicast_t *ztu, _z_zint_t *interval) {
+    _ZP_UNUSED(ztu);
+    _ZP_UNUSED(interval);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+#endif  // Z_FEATURE_UNICAST_TRANSPORT == 1
+
+#if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
+
+void *_zp_unicast_lease_task(void *ztu_arg) {
+    _z_transport_unicast_t *ztu = (_z_transport_unicast_t *)ztu_arg;
+
+    _zp_unicast_lease_start(ztu);
+    while (ztu->_lease_task_running == true) {
+        _z_zint_t interval = 0;
+        if (_zp_unicast_lease_step(ztu, &interval) != _Z_RES_OK) {
+            ztu->_lease_task_running = false;
+            break;
         }
 
         // The keep alive and lease intervals are expressed in milliseconds
         zp_sleep_ms(interval);
-
-        next_lease = next_lease - interval;
-        next_keep_alive = next_keep_alive - interval;
     }
     return 0;
 }
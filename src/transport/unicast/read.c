@@ -19,6 +19,7 @@
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/codec/transport.h"
 #include "zenoh-pico/transport/unicast/rx.h"
+#include "zenoh-pico/transport/unicast/tx.h"
 #include "zenoh-pico/utils/logging.h"
 
 #if Z_FEATURE_UNICAST_TRANSPORT == 1
@@ -26,11 +27,18 @@
 int8_t _zp_unicast_read(_z_transport_unicast_t *ztu) {
     int8_t ret = _Z_RES_OK;
 
-    _z_transport_message_t t_msg;
-    ret = _z_unicast_recv_t_msg(ztu, &t_msg);
+#if Z_FEATURE_BATCHING == 1
+    // The read blocks until a message is received, the batch must not linger past it
+    ret = _z_unicast_flush(ztu);
+#endif  // Z_FEATURE_BATCHING == 1
+
     if (ret == _Z_RES_OK) {
-        ret = _z_unicast_handle_transport_message(ztu, &t_msg);
-        _z_t_msg_clear(&t_msg);
+        _z_transport_message_t t_msg;
+        ret = _z_unicast_recv_t_msg(ztu, &t_msg);
+        if (ret == _Z_RES_OK) {
+            ret = _z_unicast_handle_transport_message(ztu, &t_msg);
+            _z_t_msg_clear(&t_msg);
+        }
     }
 
     return ret;
@@ -45,6 +53,41 @@ int8_t _zp_unicast_read(_z_transport_unicast_t *ztu) {
 
 #if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
 
+#if _Z_LINK_BATCH_MAX > 1
+// Receives up to _Z_LINK_BATCH_MAX datagrams in a single read, each one holding a transport message
+static int8_t __z_unicast_read_datagrams(_z_transport_unicast_t *ztu) {
+    int8_t ret = _Z_RES_OK;
+
+    size_t lens[_Z_LINK_BATCH_MAX];
+    size_t rn = _z_link_recv_batch_zbuf(&ztu->_link, &ztu->_zbuf, lens, NULL);
+    for (size_t i = 0; (i < rn) && (rn != SIZE_MAX) && (ret == _Z_RES_OK); i++) {
+        // The truncated datagrams are skipped
+        if (lens[i] > (size_t)0) {
+            _z_zbuf_set_rpos(&ztu->_zbuf, i * (size_t)Z_UDP_BATCH_IO_SLOT_SIZE);
+            _z_zbuf_t zbuf = _z_zbuf_view(&ztu->_zbuf, lens[i]);
+
+            // Mark the session that we have received data
+            ztu->_received = true;
+            _Z_STATS_RX_BATCH(&ztu->_stats, lens[i]);
+
+            _z_transport_message_t t_msg;
+            ret = _z_transport_message_decode_stream(&t_msg, &zbuf);
+            if (ret == _Z_RES_OK) {
+                ret = _z_unicast_handle_transport_message(ztu, &t_msg);
+                if (ret == _Z_RES_OK) {
+                    _z_t_msg_clear(&t_msg);
+                }
+            } else {
+                _Z_ERROR("Connection closed due to malformed message");
+            }
+        }
+    }
+    _z_zbuf_set_rpos(&ztu->_zbuf, _z_zbuf_get_wpos(&ztu->_zbuf));
+
+    return ret;
+}
+#endif
+
 void *_zp_unicast_read_task(void *ztu_arg) {
     _z_transport_unicast_t *ztu = (_z_transport_unicast_t *)ztu_arg;
 
@@ -53,34 +96,39 @@ void *_zp_unicast_read_task(void *ztu_arg) {
 
     // Prepare the buffer
     _z_zbuf_reset(&ztu->_zbuf);
+    _z_rx_stream_reset(&ztu->_rx_stream);
 
     while (ztu->_read_task_running == true) {
+        // A retained payload pins the batch, the bytes yet to read are moved to another one
+        if (_z_rx_pool_renew(ztu->_rx_pool, &ztu->_rx_batch, &ztu->_zbuf) != _Z_RES_OK) {
+            _Z_ERROR("Connection closed due to lack of RX buffers");
+            ztu->_read_task_running = false;
+            continue;
+        }
+
         // Read bytes from socket to the main buffer
         size_t to_read = 0;
         switch (ztu->_link._cap._flow) {
-            case Z_LINK_CAP_FLOW_STREAM:
-                if (_z_zbuf_len(&ztu->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
-                    _z_link_recv_zbuf(&ztu->_link, &ztu->_zbuf, NULL);
-                    if (_z_zbuf_len(&ztu->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
-                        _z_zbuf_compact(&ztu->_zbuf);
-                        continue;
-                    }
-                }
-
-                for (uint8_t i = 0; i < _Z_MSG_LEN_ENC_SIZE; i++) {
-                    to_read |= _z_zbuf_read(&ztu->_zbuf) << (i * (uint8_t)8);
-                }
-
-                if (_z_zbuf_len(&ztu->_zbuf) < to_read) {
-                    _z_link_recv_zbuf(&ztu->_link, &ztu->_zbuf, NULL);
-                    if (_z_zbuf_len(&ztu->_zbuf) < to_read) {
-                        _z_zbuf_set_rpos(&ztu->_zbuf, _z_zbuf_get_rpos(&ztu->_zbuf) - _Z_MSG_LEN_ENC_SIZE);
-                        _z_zbuf_compact(&ztu->_zbuf);
-                        continue;
-                    }
+            case Z_LINK_CAP_FLOW_STREAM: {
+                int8_t ret = _z_rx_stream_recv(&ztu->_rx_stream, &ztu->_link, &ztu->_zbuf, NULL, &to_read);
+                if (ret == _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES) {
+                    continue;
+                } else if (ret != _Z_RES_OK) {
+                    _Z_ERROR("Connection closed due to a batch larger than the RX buffer");
+                    ztu->_read_task_running = false;
+                    continue;
                 }
                 break;
+            }
             case Z_LINK_CAP_FLOW_DATAGRAM:
+#if _Z_LINK_BATCH_MAX > 1
+                if (_z_link_batch_max(&ztu->_link) > (size_t)1) {
+                    if (__z_unicast_read_datagrams(ztu) != _Z_RES_OK) {
+                        ztu->_read_task_running = false;
+                    }
+                    continue;
+                }
+#endif
                 _z_zbuf_compact(&ztu->_zbuf);
                 to_read = _z_link_recv_zbuf(&ztu->_link, &ztu->_zbuf, NULL);
                 if (to_read == SIZE_MAX) {
@@ -95,10 +143,11 @@ void *_zp_unicast_read_task(void *ztu_arg) {
 
         // Mark the session that we have received data
         ztu->_received = true;
+        _Z_STATS_RX_BATCH(&ztu->_stats, to_read);
 
         // Decode one session message
         _z_transport_message_t t_msg;
-        int8_t ret = _z_transport_message_decode(&t_msg, &zbuf);
+        int8_t ret = _z_transport_message_decode_stream(&t_msg, &zbuf);
 
         if (ret == _Z_RES_OK) {
             ret = _z_unicast_handle_transport_message(ztu, &t_msg);
@@ -117,6 +166,10 @@ void *_zp_unicast_read_task(void *ztu_arg) {
         // Move the read position of the read buffer
         _z_zbuf_set_rpos(&ztu->_zbuf, _z_zbuf_get_rpos(&ztu->_zbuf) + to_read);
     }
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    // Nothing more is received, the session moves its traffic to its other transports
+    ztu->_is_down = true;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
     zp_mutex_unlock(&ztu->_mutex_rx);
     return NULL;
 }
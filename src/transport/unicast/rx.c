@@ -22,6 +22,7 @@
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/protocol/iobuf.h"
 #include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/unicast/tx.h"
 #include "zenoh-pico/transport/utils.h"
 #include "zenoh-pico/utils/logging.h"
 
@@ -37,29 +38,15 @@ int8_t _z_unicast_recv_t_msg_na(_z_transport_unicast_t *ztu, _z_transport_messag
 
     size_t to_read = 0;
     do {
+        // A retained payload pins the batch, the bytes yet to read are moved to another one
+        ret = _z_rx_pool_renew(ztu->_rx_pool, &ztu->_rx_batch, &ztu->_zbuf);
+        if (ret != _Z_RES_OK) {
+            continue;
+        }
         switch (ztu->_link._cap._flow) {
             // Stream capable links
             case Z_LINK_CAP_FLOW_STREAM:
-                if (_z_zbuf_len(&ztu->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
-                    _z_link_recv_zbuf(&ztu->_link, &ztu->_zbuf, NULL);
-                    if (_z_zbuf_len(&ztu->_zbuf) < _Z_MSG_LEN_ENC_SIZE) {
-                        _z_zbuf_compact(&ztu->_zbuf);
-                        ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
-                        continue;
-                    }
-                }
-                for (uint8_t i = 0; i < _Z_MSG_LEN_ENC_SIZE; i++) {
-                    to_read |= _z_zbuf_read(&ztu->_zbuf) << (i * (uint8_t)8);
-                }
-                if (_z_zbuf_len(&ztu->_zbuf) < to_read) {
-                    _z_link_recv_zbuf(&ztu->_link, &ztu->_zbuf, NULL);
-                    if (_z_zbuf_len(&ztu->_zbuf) < to_read) {
-                        _z_zbuf_set_rpos(&ztu->_zbuf, _z_zbuf_get_rpos(&ztu->_zbuf) - _Z_MSG_LEN_ENC_SIZE);
-                        _z_zbuf_compact(&ztu->_zbuf);
-                        ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
-                        continue;
-                    }
-                }
+                ret = _z_rx_stream_recv(&ztu->_rx_stream, &ztu->_link, &ztu->_zbuf, NULL, &to_read);
                 break;
             // Datagram capable links
             case Z_LINK_CAP_FLOW_DATAGRAM:
@@ -75,8 +62,9 @@ int8_t _z_unicast_recv_t_msg_na(_z_transport_unicast_t *ztu, _z_transport_messag
     } while (false);  // The 1-iteration loop to use continue to break the entire loop on error
 
     if (ret == _Z_RES_OK) {
+        _Z_STATS_RX_BATCH(&ztu->_stats, to_read);
         _Z_DEBUG(">> \t transport_message_decode");
-        ret = _z_transport_message_decode(t_msg, &ztu->_zbuf);
+        ret = _z_transport_message_decode_stream(t_msg, &ztu->_zbuf);
 
         // Mark the session that we have received data
         if (ret == _Z_RES_OK) {
@@ -95,88 +83,208 @@ int8_t _z_unicast_recv_t_msg(_z_transport_unicast_t *ztu, _z_transport_message_t
     return _z_unicast_recv_t_msg_na(ztu, t_msg);
 }
 
+// Hands a network message over to the session, under the mapping of the resources declared by the remote node
+static void __z_unicast_handle_network_message(_z_transport_unicast_t *ztu, _z_network_message_t *zm,
+                                               _z_rx_batch_t *rx_batch) {
+    _Z_STATS_INC(&ztu->_stats, _Z_STATS_RX_N_MSGS);
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+    _z_msg_fix_mapping(zm, ztu->_mapping);
+    _z_handle_network_message(ztu->_session, zm, ztu->_mapping, rx_batch);
+#else
+    _z_handle_network_message(ztu->_session, zm, _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE, rx_batch);
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+}
+
+// Handles the network messages of a frame, a dropped frame is still decoded so that the reading position moves past it
+static int8_t __z_unicast_handle_frame(_z_transport_unicast_t *ztu, _z_transport_message_t *t_msg,
+                                       _z_rx_batch_t *rx_batch, _Bool drop) {
+    int8_t ret = _Z_RES_OK;
+    _z_network_message_t zm;
+    _Bool end = false;
+    while (ret == _Z_RES_OK) {
+        ret = _z_frame_decode_next(&t_msg->_body._frame, &zm, &end);
+        if ((ret != _Z_RES_OK) || (end == true)) {
+            break;
+        }
+        if (drop == false) {
+            __z_unicast_handle_network_message(ztu, &zm, rx_batch);
+        }
+        _z_msg_clear(&zm);
+    }
+    return ret;
+}
+
+static void __z_unicast_handle_fragment(_z_transport_unicast_t *ztu, _z_transport_message_t *t_msg) {
+    _Z_STATS_INC(&ztu->_stats, _Z_STATS_RX_FRAGMENTS);
+
+    // Select the right defragmentation buffer, fragments of different conduits can be interleaved
+    uint8_t lane = _Z_TRANSPORT_LANE(
+        _z_conduit_sn_list_index(&ztu->_sn_rx_sns, _z_n_qos_get_priority(t_msg->_body._fragment._ext_qos)));
+    _z_dbuf_t *dbuf = _Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_R) ? &ztu->_dbuf_reliable[lane]
+                                                                        : &ztu->_dbuf_best_effort[lane];
+
+    // Once the message exceeds the fragmentation size, its remaining fragments are discarded
+    (void)_z_dbuf_write_bytes(dbuf, t_msg->_body._fragment._payload.start, t_msg->_body._fragment._payload.len);
+
+    if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_M) == false) {
+        if (_z_dbuf_is_overflow(dbuf) == true) {  // Drop message if it exceeds the fragmentation size
+            _Z_INFO("Defragmented message dropped because it exceeds the fragmentation size");
+            _Z_STATS_INC(&ztu->_stats, _Z_STATS_RX_REASSEMBLY_DROPS);
+        } else {
+            _z_zbuf_t zbf = _z_dbuf_as_zbuf(dbuf);  // Decode the reassembled message in place
+
+            _z_zenoh_message_t zm;
+            int8_t ret = _z_network_message_decode(&zm, &zbf);
+            if (ret == _Z_RES_OK) {
+                __z_unicast_handle_network_message(ztu, &zm, NULL);
+                _z_msg_clear(&zm);
+            } else {
+                _Z_DEBUG("Failed to decode defragmented message");
+            }
+        }
+
+        // Reset the defragmentation buffer
+        _z_dbuf_reset(dbuf);
+    }
+}
+
+#if Z_FEATURE_RELIABILITY == 1
+typedef struct {
+    _z_transport_unicast_t *_ztu;
+    uint8_t _lane;
+} _z_unicast_reorder_ctx_t;
+
+static int8_t __z_unicast_deliver(void *arg, _z_transport_message_t *t_msg, _Bool is_copy) {
+    int8_t ret = _Z_RES_OK;
+    _z_unicast_reorder_ctx_t *ctx = (_z_unicast_reorder_ctx_t *)arg;
+    if (t_msg == NULL) {
+        // The fragments received before the missing ones belong to a message that can no longer be reassembled
+        _z_dbuf_reset(&ctx->_ztu->_dbuf_reliable[ctx->_lane]);
+    } else if (_Z_MID(t_msg->_header) == _Z_MID_T_FRAME) {
+        // A buffered frame is decoded from a copy, its payloads cannot retain the RX batch
+        ret = __z_unicast_handle_frame(ctx->_ztu, t_msg, (is_copy == true) ? NULL : ctx->_ztu->_rx_batch, false);
+    } else {
+        __z_unicast_handle_fragment(ctx->_ztu, t_msg);
+    }
+    return ret;
+}
+
+// Delivers a reliable frame or fragment in order, requesting the missing ones and acknowledging the delivered ones
+static int8_t __z_unicast_recv_reliable(_z_transport_unicast_t *ztu, _z_transport_message_t *t_msg, uint8_t conduit,
+                                        _z_n_qos_t qos) {
+    int8_t ret = _Z_RES_OK;
+    _z_unicast_reorder_ctx_t ctx = {._ztu = ztu, ._lane = _Z_TRANSPORT_LANE(conduit)};
+    _z_reliability_reorder_t *r = &ztu->_rx_reorder[conduit];
+
+    _z_zint_t sn = 0;
+    _z_zint_t mask = 0;
+    if (_z_reliability_reorder_recv(r, ztu->_sn_res, &ztu->_sn_rx_sns._val._qos[conduit]._reliable, t_msg,
+                                    __z_unicast_deliver, &ctx, &sn, &mask) == true) {
+        _Z_INFO("Sending Z_ACK_NACK(Nack) from SN %ju", (uintmax_t)sn);
+        _z_transport_message_t nack = _z_t_msg_make_nack(sn, mask, _z_id_empty(), qos);
+        ret = _z_unicast_send_t_msg(ztu, &nack);
+    }
+    if ((ret == _Z_RES_OK) && (r->_unacked >= (size_t)_Z_RELIABILITY_ACK_THRESHOLD)) {
+        _z_transport_message_t ack = _z_t_msg_make_ack(ztu->_sn_rx_sns._val._qos[conduit]._reliable, qos);
+        ret = _z_unicast_send_t_msg(ztu, &ack);
+        r->_unacked = 0;
+    }
+    return ret;
+}
+#endif  // Z_FEATURE_RELIABILITY == 1
+
 int8_t _z_unicast_handle_transport_message(_z_transport_unicast_t *ztu, _z_transport_message_t *t_msg) {
     int8_t ret = _Z_RES_OK;
 
     switch (_Z_MID(t_msg->_header)) {
         case _Z_MID_T_FRAME: {
             _Z_INFO("Received Z_FRAME message");
+            // Select the QoS conduit of the frame
+            uint8_t conduit =
+                _z_conduit_sn_list_index(&ztu->_sn_rx_sns, _z_n_qos_get_priority(t_msg->_body._frame._ext_qos));
+            _z_coundit_sn_t *sn_rx = &ztu->_sn_rx_sns._val._qos[conduit];
+
             // Check if the SN is correct
+            _Bool drop = false;
             if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAME_R) == true) {
-                // @TODO: amend once reliability is in place. For the time being only
-                //        monotonic SNs are ensured
-                if (_z_sn_precedes(ztu->_sn_res, ztu->_sn_rx_reliable, t_msg->_body._frame._sn) == true) {
-                    ztu->_sn_rx_reliable = t_msg->_body._frame._sn;
+#if Z_FEATURE_RELIABILITY == 1
+                // Reliable frames are reordered and retransmitted if the link may lose them
+                if (ztu->_rx_reorder != NULL) {
+                    ret = __z_unicast_recv_reliable(ztu, t_msg, conduit, t_msg->_body._frame._ext_qos);
+                    break;
+                }
+#endif  // Z_FEATURE_RELIABILITY == 1
+                // Only monotonic SNs are ensured if reliability has not been negotiated
+                if (_z_sn_precedes(ztu->_sn_res, sn_rx->_reliable, t_msg->_body._frame._sn) == true) {
+                    sn_rx->_reliable = t_msg->_body._frame._sn;
                 } else {
-                    _z_wbuf_clear(&ztu->_dbuf_reliable);
+                    _z_dbuf_reset(&ztu->_dbuf_reliable[_Z_TRANSPORT_LANE(conduit)]);
                     _Z_INFO("Reliable message dropped because it is out of order");
-                    break;
+                    _Z_STATS_INC(&ztu->_stats, _Z_STATS_RX_OUT_OF_ORDER_DROPS);
+                    drop = true;
                 }
             } else {
-                if (_z_sn_precedes(ztu->_sn_res, ztu->_sn_rx_best_effort, t_msg->_body._frame._sn) == true) {
-                    ztu->_sn_rx_best_effort = t_msg->_body._frame._sn;
+                if (_z_sn_precedes(ztu->_sn_res, sn_rx->_best_effort, t_msg->_body._frame._sn) == true) {
+                    sn_rx->_best_effort = t_msg->_body._frame._sn;
                 } else {
-                    _z_wbuf_clear(&ztu->_dbuf_best_effort);
+                    _z_dbuf_reset(&ztu->_dbuf_best_effort[_Z_TRANSPORT_LANE(conduit)]);
                     _Z_INFO("Best effort message dropped because it is out of order");
-                    break;
+                    _Z_STATS_INC(&ztu->_stats, _Z_STATS_RX_OUT_OF_ORDER_DROPS);
+                    drop = true;
                 }
             }
 
-            // Handle all the zenoh message, one by one
-            size_t len = _z_vec_len(&t_msg->_body._frame._messages);
-            for (size_t i = 0; i < len; i++) {
-                _z_handle_network_message(ztu->_session,
-                                          (_z_zenoh_message_t *)_z_vec_get(&t_msg->_body._frame._messages, i),
-                                          _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE);
-            }
-
+            // Decode and handle all the zenoh messages, one by one
+            ret = __z_unicast_handle_frame(ztu, t_msg, ztu->_rx_batch, drop);
             break;
         }
 
         case _Z_MID_T_FRAGMENT: {
-            _z_wbuf_t *dbuf = _Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_R)
-                                  ? &ztu->_dbuf_reliable
-                                  : &ztu->_dbuf_best_effort;  // Select the right defragmentation buffer
-
-            _Bool drop = false;
-            if ((_z_wbuf_len(dbuf) + t_msg->_body._fragment._payload.len) > Z_FRAG_MAX_SIZE) {
-                // Filling the wbuf capacity as a way to signal the last fragment to reset the dbuf
-                // Otherwise, last (smaller) fragments can be understood as a complete message
-                _z_wbuf_write_bytes(dbuf, t_msg->_body._fragment._payload.start, 0, _z_wbuf_space_left(dbuf));
-                drop = true;
-            } else {
-                _z_wbuf_write_bytes(dbuf, t_msg->_body._fragment._payload.start, 0,
-                                    t_msg->_body._fragment._payload.len);
+#if Z_FEATURE_RELIABILITY == 1
+            if ((ztu->_rx_reorder != NULL) && (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_R) == true)) {
+                uint8_t conduit = _z_conduit_sn_list_index(&ztu->_sn_rx_sns,
+                                                           _z_n_qos_get_priority(t_msg->_body._fragment._ext_qos));
+                ret = __z_unicast_recv_reliable(ztu, t_msg, conduit, t_msg->_body._fragment._ext_qos);
+                break;
             }
+#endif  // Z_FEATURE_RELIABILITY == 1
+            __z_unicast_handle_fragment(ztu, t_msg);
+            break;
+        }
 
-            if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_FRAGMENT_M) == false) {
-                if (drop == true) {  // Drop message if it exceeds the fragmentation size
-                    _z_wbuf_reset(dbuf);
-                    break;
-                }
-
-                _z_zbuf_t zbf = _z_wbuf_to_zbuf(dbuf);  // Convert the defragmentation buffer into a decoding buffer
-
-                _z_zenoh_message_t zm;
-                int8_t ret = _z_network_message_decode(&zm, &zbf);
-                if (ret == _Z_RES_OK) {
-                    _z_handle_network_message(ztu->_session, &zm, _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE);
-                    _z_msg_clear(&zm);  // Clear must be explicitly called for fragmented zenoh messages. Non-fragmented
-                                        // zenoh messages are released when their transport message is released.
+        case _Z_MID_T_ACK_NACK: {
+            _Z_INFO("Received Z_ACK_NACK message");
+#if Z_FEATURE_RELIABILITY == 1
+            if (ztu->_tx_window != NULL) {
+                _z_t_msg_ack_nack_t *msg = &t_msg->_body._ack_nack;
+                uint8_t lane = _Z_TRANSPORT_LANE(
+                    _z_conduit_sn_list_index(&ztu->_sn_tx_sns, _z_n_qos_get_priority(msg->_ext_qos)));
+#if Z_FEATURE_MULTI_THREAD == 1
+                zp_mutex_lock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+                if (_Z_HAS_FLAG(t_msg->_header, _Z_FLAG_T_ACK_NACK_N) == true) {
+                    // The messages preceding the first missing one have been received
+                    _z_reliability_window_ack(&ztu->_tx_window[lane], ztu->_sn_res,
+                                              _z_sn_decrement(ztu->_sn_res, msg->_sn));
+                    _z_zint_t now = (_z_zint_t)zp_clock_elapsed_ms(&ztu->_lease_epoch);
+                    if (_z_reliability_window_resend(&ztu->_tx_window[lane], &ztu->_link, ztu->_sn_res, msg->_sn,
+                                                     msg->_mask, now) != _Z_RES_OK) {
+                        _Z_INFO("Failed to retransmit the requested messages");
+                    }
                 } else {
-                    _Z_DEBUG("Failed to decode defragmented message");
+                    _z_reliability_window_ack(&ztu->_tx_window[lane], ztu->_sn_res, msg->_sn);
                 }
-
-                // Free the decoding buffer
-                _z_zbuf_clear(&zbf);
-                // Reset the defragmentation buffer
-                _z_wbuf_reset(dbuf);
+#if Z_FEATURE_MULTI_THREAD == 1
+                zp_mutex_unlock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
             }
+#endif  // Z_FEATURE_RELIABILITY == 1
             break;
         }
 
         case _Z_MID_T_KEEP_ALIVE: {
             _Z_INFO("Received Z_KEEP_ALIVE message");
+            _Z_STATS_INC(&ztu->_stats, _Z_STATS_RX_KEEP_ALIVES);
             break;
         }
 
@@ -192,6 +300,9 @@ int8_t _z_unicast_handle_transport_message(_z_transport_unicast_t *ztu, _z_trans
 
         case _Z_MID_T_CLOSE: {
             _Z_INFO("Closing session as requested by the remote peer");
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+            ztu->_is_down = true;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
             ret = _Z_ERR_CONNECTION_CLOSED;
             break;
         }
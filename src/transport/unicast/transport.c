@@ -41,7 +41,13 @@ int8_t _z_unicast_transport_create(_z_transport_t *zt, _z_link_t *zl, _z_transpo
     ret = zp_mutex_init(&zt->_transport._unicast._mutex_tx);
     if (ret == _Z_RES_OK) {
         ret = zp_mutex_init(&zt->_transport._unicast._mutex_rx);
-        if (ret != _Z_RES_OK) {
+        if (ret == _Z_RES_OK) {
+            ret = _z_transport_lanes_mutex_init(zt->_transport._unicast._mutex_lanes);
+            if (ret != _Z_RES_OK) {
+                zp_mutex_free(&zt->_transport._unicast._mutex_tx);
+                zp_mutex_free(&zt->_transport._unicast._mutex_rx);
+            }
+        } else {
             zp_mutex_free(&zt->_transport._unicast._mutex_tx);
         }
     }
@@ -66,6 +72,10 @@ int8_t _z_unicast_transport_create(_z_transport_t *zt, _z_link_t *zl, _z_transpo
             default:
                 wbuf_size = mtu;
                 zbuf_size = Z_BATCH_UNICAST_SIZE;
+                // A batched read needs one slot per datagram
+                if (_z_link_batch_max(zl) > (size_t)1) {
+                    zbuf_size = (size_t)Z_UDP_BATCH_IO_SLOT_SIZE * _z_link_batch_max(zl);
+                }
                 expandable = false;
                 break;
         }
@@ -76,33 +86,39 @@ int8_t _z_unicast_transport_create(_z_transport_t *zt, _z_link_t *zl, _z_transpo
 #endif
         // Initialize tx rx buffers
         zt->_transport._unicast._wbuf = _z_wbuf_make(wbuf_size, false);
-        zt->_transport._unicast._zbuf = _z_zbuf_make(zbuf_size);
+        int8_t rx_ret = _z_rx_pool_open(&zt->_transport._unicast._rx_pool, &zt->_transport._unicast._rx_batch,
+                                        &zt->_transport._unicast._zbuf, zbuf_size);
+        _z_rx_stream_reset(&zt->_transport._unicast._rx_stream);
 
         // Initialize the defragmentation buffers
-        zt->_transport._unicast._dbuf_reliable = _z_wbuf_make(dbuf_size, expandable);
-        zt->_transport._unicast._dbuf_best_effort = _z_wbuf_make(dbuf_size, expandable);
+        _Bool dbuf_failed = false;
+        for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
+            zt->_transport._unicast._dbuf_reliable[i] = _z_dbuf_make(dbuf_size, Z_FRAG_MAX_SIZE, expandable);
+            zt->_transport._unicast._dbuf_best_effort[i] = _z_dbuf_make(dbuf_size, Z_FRAG_MAX_SIZE, expandable);
+            if ((_z_dbuf_capacity(&zt->_transport._unicast._dbuf_reliable[i]) != dbuf_size) ||
+                (_z_dbuf_capacity(&zt->_transport._unicast._dbuf_best_effort[i]) != dbuf_size)) {
+                dbuf_failed = true;
+            }
+        }
 
         // Clean up the buffers if one of them failed to be allocated
         if ((_z_wbuf_capacity(&zt->_transport._unicast._wbuf) != wbuf_size) ||
-            (_z_zbuf_capacity(&zt->_transport._unicast._zbuf) != zbuf_size) ||
-#if Z_FEATURE_DYNAMIC_MEMORY_ALLOCATION == 0
-            (_z_wbuf_capacity(&zt->_transport._unicast._dbuf_reliable) != dbuf_size) ||
-            (_z_wbuf_capacity(&zt->_transport._unicast._dbuf_best_effort) != dbuf_size)) {
-#else
-            (_z_wbuf_capacity(&zt->_transport._unicast._dbuf_reliable) != Z_IOSLICE_SIZE) ||
-            (_z_wbuf_capacity(&zt->_transport._unicast._dbuf_best_effort) != Z_IOSLICE_SIZE)) {
-#endif
+            (rx_ret != _Z_RES_OK) || (dbuf_failed == true)) {
             ret = _Z_ERR_SYSTEM_OUT_OF_MEMORY;
 
 #if Z_FEATURE_MULTI_THREAD == 1
             zp_mutex_free(&zt->_transport._unicast._mutex_tx);
             zp_mutex_free(&zt->_transport._unicast._mutex_rx);
+            _z_transport_lanes_mutex_free(zt->_transport._unicast._mutex_lanes);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
             _z_wbuf_clear(&zt->_transport._unicast._wbuf);
-            _z_zbuf_clear(&zt->_transport._unicast._zbuf);
-            _z_wbuf_clear(&zt->_transport._unicast._dbuf_reliable);
-            _z_wbuf_clear(&zt->_transport._unicast._dbuf_best_effort);
+            _z_rx_pool_close(&zt->_transport._unicast._rx_pool, &zt->_transport._unicast._rx_batch,
+                             &zt->_transport._unicast._zbuf);
+            for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
+                _z_dbuf_clear(&zt->_transport._unicast._dbuf_reliable[i]);
+                _z_dbuf_clear(&zt->_transport._unicast._dbuf_best_effort[i]);
+            }
         }
     }
 
@@ -110,14 +126,27 @@ int8_t _z_unicast_transport_create(_z_transport_t *zt, _z_link_t *zl, _z_transpo
         // Set default SN resolution
         zt->_transport._unicast._sn_res = _z_sn_max(param->_seq_num_res);
 
-        // The initial SN at TX side
-        zt->_transport._unicast._sn_tx_reliable = param->_initial_sn_tx;
-        zt->_transport._unicast._sn_tx_best_effort = param->_initial_sn_tx;
+        // The initial SN at TX side, the same for all the QoS conduits
+        _z_conduit_sn_list_init(&zt->_transport._unicast._sn_tx_sns, param->_is_qos, param->_initial_sn_tx);
 
         // The initial SN at RX side
         _z_zint_t initial_sn_rx = _z_sn_decrement(zt->_transport._unicast._sn_res, param->_initial_sn_rx);
-        zt->_transport._unicast._sn_rx_reliable = initial_sn_rx;
-        zt->_transport._unicast._sn_rx_best_effort = initial_sn_rx;
+        _z_conduit_sn_list_init(&zt->_transport._unicast._sn_rx_sns, param->_is_qos, initial_sn_rx);
+
+#if Z_FEATURE_RELIABILITY == 1
+        // Reliable messages are only retransmitted on links that may lose them
+        zt->_transport._unicast._tx_window = NULL;
+        zt->_transport._unicast._rx_reorder = NULL;
+        if ((param->_is_reliability == true) && (zl->_cap._is_reliable == false)) {
+            zt->_transport._unicast._tx_window = _z_reliability_windows_make(_Z_TRANSPORT_LANES_NUM);
+            zt->_transport._unicast._rx_reorder = _z_reliability_reorders_make(Z_PRIORITIES_NUM);
+            if ((zt->_transport._unicast._tx_window == NULL) || (zt->_transport._unicast._rx_reorder == NULL)) {
+                _Z_ERROR("Unable to allocate the retransmission buffers, reliability is disabled");
+                _z_reliability_windows_free(&zt->_transport._unicast._tx_window, _Z_TRANSPORT_LANES_NUM);
+                _z_reliability_reorders_free(&zt->_transport._unicast._rx_reorder, Z_PRIORITIES_NUM);
+            }
+        }
+#endif  // Z_FEATURE_RELIABILITY == 1
 
 #if Z_FEATURE_MULTI_THREAD == 1
         // Tasks
@@ -125,14 +154,38 @@ int8_t _z_unicast_transport_create(_z_transport_t *zt, _z_link_t *zl, _z_transpo
         zt->_transport._unicast._read_task = NULL;
         zt->_transport._unicast._lease_task_running = false;
         zt->_transport._unicast._lease_task = NULL;
+        zt->_transport._unicast._tx_task_running = false;
+        zt->_transport._unicast._tx_task = NULL;
+        zt->_transport._unicast._tx_slots = NULL;
+        _z_tx_queue_null(&zt->_transport._unicast._tx_queue);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
         // Notifiers
         zt->_transport._unicast._received = 0;
         zt->_transport._unicast._transmitted = 0;
 
-        // Transport lease
+#if Z_FEATURE_STATS == 1
+        _z_transport_stats_reset(&zt->_transport._unicast._stats);
+#endif  // Z_FEATURE_STATS == 1
+
+#if Z_FEATURE_MULTI_TRANSPORT == 1
+        // The session gives another mapping to its other unicast transports
+        zt->_transport._unicast._mapping = _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE;
+        zt->_transport._unicast._is_down = false;
+#endif  // Z_FEATURE_MULTI_TRANSPORT == 1
+
+#if Z_FEATURE_BATCHING == 1
+        // Batching
+        zt->_transport._unicast._batch_count = 0;
+        zt->_transport._unicast._batch_reliability = Z_RELIABILITY_DEFAULT;
+        zt->_transport._unicast._batch_lane = 0;
+        zt->_transport._unicast._batch_active = false;
+        zt->_transport._unicast._batch_wake = 0;
+#endif  // Z_FEATURE_BATCHING == 1
+
+        // Transport lease, its clock is restarted once the lease task starts
         zt->_transport._unicast._lease = param->_lease;
+        zt->_transport._unicast._lease_epoch = zp_clock_now();
 
         // Transport link for unicast
         zt->_transport._unicast._link = *zl;
@@ -155,6 +208,8 @@ int8_t _z_unicast_open_client(_z_transport_unicast_establish_param_t *param, con
     param->_seq_num_res = ism._body._init._seq_num_res;  // The announced sn resolution
     param->_req_id_res = ism._body._init._req_id_res;    // The announced req id resolution
     param->_batch_size = ism._body._init._batch_size;    // The announced batch size
+    param->_is_qos = ism._body._init._ext_qos;           // The announced QoS support
+    param->_is_reliability = ism._body._init._ext_reliability;  // The announced retransmission support
 
     // Encode and send the message
     _Z_INFO("Sending Z_INIT(Syn)");
@@ -188,6 +243,11 @@ int8_t _z_unicast_open_client(_z_transport_unicast_establish_param_t *param, con
                     ret = _Z_ERR_TRANSPORT_OPEN_SN_RESOLUTION;
                 }
 
+                // QoS conduits are used only if both sides support them
+                param->_is_qos = (param->_is_qos == true) && (iam._body._init._ext_qos == true);
+                // Reliable messages are retransmitted only if both sides support it
+                param->_is_reliability = (param->_is_reliability == true) && (iam._body._init._ext_reliability == true);
+
                 if (ret == _Z_RES_OK) {
                     param->_key_id_res = 0x08 << param->_key_id_res;
                     param->_req_id_res = 0x08 << param->_req_id_res;
@@ -252,9 +312,14 @@ int8_t _z_unicast_open_peer(_z_transport_unicast_establish_param_t *param, const
 
 int8_t _z_unicast_send_close(_z_transport_unicast_t *ztu, uint8_t reason, _Bool link_only) {
     int8_t ret = _Z_RES_OK;
+    // Send the batched messages before the close, which is still sent if they could not be
+    ret = _z_unicast_flush(ztu);
     // Send and clear message
     _z_transport_message_t cm = _z_t_msg_make_close(reason, link_only);
-    ret = _z_unicast_send_t_msg(ztu, &cm);
+    int8_t res = _z_unicast_send_t_msg(ztu, &cm);
+    if (ret == _Z_RES_OK) {
+        ret = res;
+    }
     _z_t_msg_clear(&cm);
     return ret;
 }
@@ -266,7 +331,8 @@ int8_t _z_unicast_transport_close(_z_transport_unicast_t *ztu, uint8_t reason) {
 void _z_unicast_transport_clear(_z_transport_t *zt) {
     _z_transport_unicast_t *ztu = &zt->_transport._unicast;
 #if Z_FEATURE_MULTI_THREAD == 1
-    // Clean up tasks
+    // Clean up tasks, the TX task sends the queued messages before stopping
+    _zp_unicast_stop_tx_task(zt);
     if (ztu->_read_task != NULL) {
         zp_task_join(ztu->_read_task);
         zp_task_free(&ztu->_read_task);
@@ -279,13 +345,21 @@ void _z_unicast_transport_clear(_z_transport_t *zt) {
     // Clean up the mutexes
     zp_mutex_free(&ztu->_mutex_tx);
     zp_mutex_free(&ztu->_mutex_rx);
+    _z_transport_lanes_mutex_free(ztu->_mutex_lanes);
+    _z_tx_queue_clear(&ztu->_tx_queue);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
     // Clean up the buffers
     _z_wbuf_clear(&ztu->_wbuf);
-    _z_zbuf_clear(&ztu->_zbuf);
-    _z_wbuf_clear(&ztu->_dbuf_reliable);
-    _z_wbuf_clear(&ztu->_dbuf_best_effort);
+    _z_rx_pool_close(&ztu->_rx_pool, &ztu->_rx_batch, &ztu->_zbuf);
+    for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
+        _z_dbuf_clear(&ztu->_dbuf_reliable[i]);
+        _z_dbuf_clear(&ztu->_dbuf_best_effort[i]);
+    }
+#if Z_FEATURE_RELIABILITY == 1
+    _z_reliability_windows_free(&ztu->_tx_window, _Z_TRANSPORT_LANES_NUM);
+    _z_reliability_reorders_free(&ztu->_rx_reorder, Z_PRIORITIES_NUM);
+#endif  // Z_FEATURE_RELIABILITY == 1
 
     // Clean up PIDs
     ztu->_remote_zid = _z_id_empty();
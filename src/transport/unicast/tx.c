@@ -15,6 +15,7 @@
 #include "zenoh-pico/transport/unicast/tx.h"
 
 #include <assert.h>
+#include <string.h>
 
 #include "zenoh-pico/config.h"
 #include "zenoh-pico/protocol/codec/network.h"
@@ -29,20 +30,136 @@
 /**
  * This function is unsafe because it operates in potentially concurrent data.
  * Make sure that the following mutexes are locked before calling this function:
- *  - ztu->_mutex_inner
+ *  - ztu->_mutex_lanes[lane]
  */
-_z_zint_t __unsafe_z_unicast_get_sn(_z_transport_unicast_t *ztu, z_reliability_t reliability) {
+_z_zint_t __unsafe_z_unicast_get_sn(_z_transport_unicast_t *ztu, uint8_t lane, z_reliability_t reliability) {
+    _z_coundit_sn_t *sn_tx = &ztu->_sn_tx_sns._val._qos[lane];
     _z_zint_t sn;
     if (reliability == Z_RELIABILITY_RELIABLE) {
-        sn = ztu->_sn_tx_reliable;
-        ztu->_sn_tx_reliable = _z_sn_increment(ztu->_sn_res, ztu->_sn_tx_reliable);
+        sn = sn_tx->_reliable;
+        sn_tx->_reliable = _z_sn_increment(ztu->_sn_res, sn_tx->_reliable);
     } else {
-        sn = ztu->_sn_tx_best_effort;
-        ztu->_sn_tx_best_effort = _z_sn_increment(ztu->_sn_res, ztu->_sn_tx_best_effort);
+        sn = sn_tx->_best_effort;
+        sn_tx->_best_effort = _z_sn_increment(ztu->_sn_res, sn_tx->_best_effort);
     }
     return sn;
 }
 
+/**
+ * Keeps a finalized frame or fragment for retransmission if it is reliable.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztu->_mutex_tx
+ */
+static void __unsafe_z_unicast_keep(_z_transport_unicast_t *ztu, const _z_wbuf_t *wbf, uint8_t lane) {
+#if Z_FEATURE_RELIABILITY == 1
+    if (ztu->_tx_window != NULL) {
+        _z_zint_t now = (_z_zint_t)zp_clock_elapsed_ms(&ztu->_lease_epoch);
+        if (_z_reliability_window_push(&ztu->_tx_window[lane], wbf, ztu->_link._cap._flow, now) != _Z_RES_OK) {
+            _Z_INFO("Unable to keep a reliable message for retransmission");
+        }
+    }
+#else
+    _ZP_UNUSED(ztu);
+    _ZP_UNUSED(wbf);
+    _ZP_UNUSED(lane);
+#endif  // Z_FEATURE_RELIABILITY == 1
+}
+
+#if Z_FEATURE_BATCHING == 1
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztu->_mutex_tx
+ */
+int8_t __unsafe_z_unicast_flush(_z_transport_unicast_t *ztu) {
+    int8_t ret = _Z_RES_OK;
+    if (ztu->_batch_count > 0) {
+        // Write the message length in the reserved space if needed
+        __unsafe_z_finalize_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+        __unsafe_z_unicast_keep(ztu, &ztu->_wbuf, ztu->_batch_lane);
+
+        ret = _z_link_send_wbuf(&ztu->_link, &ztu->_wbuf);  // Send the wbuf on the socket
+        if (ret == _Z_RES_OK) {
+            ztu->_transmitted = true;  // Mark the session that we have transmitted data
+            _Z_STATS_TX_BATCH(&ztu->_stats, _z_wbuf_len(&ztu->_wbuf));
+        }
+        ztu->_batch_count = 0;
+    }
+    return ret;
+}
+
+/**
+ * A batch is sent once it lingered for Z_BATCH_LINGER_TIME, or right away if the next lease step would run too late
+ * to flush it, e.g. the first messages sent after an idle period.
+ *
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztu->_mutex_tx
+ */
+static _Bool __unsafe_z_unicast_batch_expired(_z_transport_unicast_t *ztu) {
+    _Bool expired = (zp_clock_elapsed_ms(&ztu->_batch_time) >= (unsigned long)Z_BATCH_LINGER_TIME);
+    if (expired == false) {
+        _z_zint_t now = (_z_zint_t)zp_clock_elapsed_ms(&ztu->_lease_epoch);
+        expired = (ztu->_batch_wake > (now + (_z_zint_t)Z_BATCH_LINGER_TIME));
+    }
+    return expired;
+}
+#endif  // Z_FEATURE_BATCHING == 1
+
+int8_t _z_unicast_flush(_z_transport_unicast_t *ztu) {
+    int8_t ret = _Z_RES_OK;
+#if Z_FEATURE_BATCHING == 1
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    ret = __unsafe_z_unicast_flush(ztu);
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+#else
+    _ZP_UNUSED(ztu);
+#endif  // Z_FEATURE_BATCHING == 1
+    return ret;
+}
+
+int8_t _z_unicast_batch_step(_z_transport_unicast_t *ztu, _z_zint_t now, _z_zint_t *interval) {
+    int8_t ret = _Z_RES_OK;
+#if Z_FEATURE_BATCHING == 1
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_lock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (ztu->_batch_count > 0) {
+        // Flush the batch once expired, or run in time to do it
+        unsigned long elapsed = zp_clock_elapsed_ms(&ztu->_batch_time);
+        if (elapsed >= (unsigned long)Z_BATCH_LINGER_TIME) {
+            ret = __unsafe_z_unicast_flush(ztu);
+        } else if (*interval > (_z_zint_t)((unsigned long)Z_BATCH_LINGER_TIME - elapsed)) {
+            *interval = (_z_zint_t)((unsigned long)Z_BATCH_LINGER_TIME - elapsed);
+        }
+    }
+    // Only run often enough to hold the next batches while messages are being sent
+    if ((ztu->_batch_active == true) && (*interval > (_z_zint_t)Z_BATCH_LINGER_TIME)) {
+        *interval = (_z_zint_t)Z_BATCH_LINGER_TIME;
+    }
+    ztu->_batch_active = false;
+    ztu->_batch_wake = now + *interval;
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_unlock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+#else
+    _ZP_UNUSED(ztu);
+    _ZP_UNUSED(now);
+    _ZP_UNUSED(interval);
+#endif  // Z_FEATURE_BATCHING == 1
+    return ret;
+}
+
 int8_t _z_unicast_send_t_msg(_z_transport_unicast_t *ztu, const _z_transport_message_t *t_msg) {
     int8_t ret = _Z_RES_OK;
     _Z_DEBUG(">> send session message");
@@ -52,11 +169,18 @@ int8_t _z_unicast_send_t_msg(_z_transport_unicast_t *ztu, const _z_transport_mes
     zp_mutex_lock(&ztu->_mutex_tx);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
 
-    // Prepare the buffer eventually reserving space for the message length
-    __unsafe_z_prepare_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+#if Z_FEATURE_BATCHING == 1
+    // Flush any pending batch to preserve the message ordering
+    ret = __unsafe_z_unicast_flush(ztu);
+#endif  // Z_FEATURE_BATCHING == 1
 
-    // Encode the session message
-    ret = _z_transport_message_encode(&ztu->_wbuf, t_msg);
+    if (ret == _Z_RES_OK) {
+        // Prepare the buffer eventually reserving space for the message length
+        __unsafe_z_prepare_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+
+        // Encode the session message
+        ret = _z_transport_message_encode(&ztu->_wbuf, t_msg);
+    }
     if (ret == _Z_RES_OK) {
         // Write the message length in the reserved space if needed
         __unsafe_z_finalize_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
@@ -64,6 +188,7 @@ int8_t _z_unicast_send_t_msg(_z_transport_unicast_t *ztu, const _z_transport_mes
         ret = _z_link_send_wbuf(&ztu->_link, &ztu->_wbuf);
         if (ret == _Z_RES_OK) {
             ztu->_transmitted = true;  // Mark the session that we have transmitted data
+            _Z_STATS_TX_BATCH(&ztu->_stats, _z_wbuf_len(&ztu->_wbuf));
         }
     }
 
@@ -74,110 +199,431 @@ int8_t _z_unicast_send_t_msg(_z_transport_unicast_t *ztu, const _z_transport_mes
     return ret;
 }
 
-int8_t _z_unicast_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg, z_reliability_t reliability,
-                             z_congestion_control_t cong_ctrl) {
+/**
+ * This function is unsafe because it operates in potentially concurrent data.
+ * Make sure that the following mutexes are locked before calling this function:
+ *  - ztu->_mutex_lanes[lane]
+ */
+static int8_t __unsafe_z_unicast_send_fragments(_z_transport_unicast_t *ztu, _z_wbuf_t *fbf, z_reliability_t reliability,
+                                                uint8_t lane, _z_n_qos_t qos, _z_zint_t sn) {
     int8_t ret = _Z_RES_OK;
-    _Z_DEBUG(">> send network message");
 
-    _z_transport_unicast_t *ztu = &zn->_tp._transport._unicast;
+    // With vectored writes, the fragments reference the message instead of copying it
+    size_t max_refs = _z_link_write_vec_max(&ztu->_link);
+    max_refs = (max_refs > (size_t)1) ? max_refs - (size_t)1 : (size_t)0;
+
+    _Bool is_first = true;  // Fragment and send the message
+    while ((_z_wbuf_len(fbf) > 0) && (ret == _Z_RES_OK)) {
+        if (is_first == false) {  // Get the fragment sequence number
+            sn = __unsafe_z_unicast_get_sn(ztu, lane, reliability);
+        }
+        is_first = false;
+
+        // The TX lock is only held for one fragment, messages of the other lanes are sent in between
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+#if Z_FEATURE_BATCHING == 1
+        // Flush the batch another lane may have opened since the previous fragment
+        ret = __unsafe_z_unicast_flush(ztu);
+#endif  // Z_FEATURE_BATCHING == 1
+
+        if (ret == _Z_RES_OK) {
+            // Clear the buffer for serialization
+            __unsafe_z_prepare_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+
+            // Serialize one fragment
+            ret = __unsafe_z_serialize_zenoh_fragment(&ztu->_wbuf, fbf, reliability, sn, qos, max_refs);
+        }
+        if (ret == _Z_RES_OK) {
+            // Write the message length in the reserved space if needed
+            __unsafe_z_finalize_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+            __unsafe_z_unicast_keep(ztu, &ztu->_wbuf, lane);
+
+            ret = _z_link_send_wbuf(&ztu->_link, &ztu->_wbuf);  // Send the wbuf on the socket
+            if (ret == _Z_RES_OK) {
+                ztu->_transmitted = true;  // Mark the session that we have transmitted data
+                _Z_STATS_TX_BATCH(&ztu->_stats, _z_wbuf_len(&ztu->_wbuf));
+                _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_FRAGMENTS);
+            }
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    }
+
+    return ret;
+}
+
+static int8_t __z_unicast_send_n_msg(_z_transport_unicast_t *ztu, const _z_network_message_t *n_msg,
+                                     z_reliability_t reliability, z_congestion_control_t cong_ctrl, uint8_t lane,
+                                     _z_n_qos_t qos) {
+    int8_t ret = _Z_RES_OK;
 
-    // Acquire the lock and drop the message if needed
+    // Acquire the lane lock and drop the message if needed
     _Bool drop = false;
     if (cong_ctrl == Z_CONGESTION_CONTROL_BLOCK) {
 #if Z_FEATURE_MULTI_THREAD == 1
-        zp_mutex_lock(&ztu->_mutex_tx);
+        zp_mutex_lock(&ztu->_mutex_lanes[lane]);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
     } else {
 #if Z_FEATURE_MULTI_THREAD == 1
-        int8_t locked = zp_mutex_trylock(&ztu->_mutex_tx);
+        int8_t locked = zp_mutex_trylock(&ztu->_mutex_lanes[lane]);
         if (locked != (int8_t)0) {
             _Z_INFO("Dropping zenoh message because of congestion control");
             // We failed to acquire the lock, drop the message
             drop = true;
+            _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_CONGESTION_DROPS);
         }
 #endif  // Z_FEATURE_MULTI_THREAD == 1
     }
 
     if (drop == false) {
-        // Prepare the buffer eventually reserving space for the message length
-        __unsafe_z_prepare_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+        _Bool fragment = false;
+        _z_zint_t sn = 0;
 
-        _z_zint_t sn = __unsafe_z_unicast_get_sn(ztu, reliability);  // Get the next sequence number
-
-        _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability);
-        ret = _z_transport_message_encode(&ztu->_wbuf, &t_msg);  // Encode the frame header
-        if (ret == _Z_RES_OK) {
-            ret = _z_network_message_encode(&ztu->_wbuf, n_msg);  // Encode the network message
-            if (ret == _Z_RES_OK) {
-                // Write the message length in the reserved space if needed
-                __unsafe_z_finalize_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_lock(&ztu->_mutex_tx);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
 
-                if (ztu->_wbuf._ioss._len == 1) {
-                    ret = _z_link_send_wbuf(&ztu->_link, &ztu->_wbuf);  // Send the wbuf on the socket
+        _Bool batched = false;
+#if Z_FEATURE_BATCHING == 1
+        if (ztu->_batch_count > 0) {
+            if ((ztu->_batch_reliability == reliability) && (ztu->_batch_lane == lane)) {
+                // Try to append the network message to the frame being batched
+                size_t w_pos = _z_wbuf_get_wpos(&ztu->_wbuf);
+                if (_z_network_message_encode(&ztu->_wbuf, n_msg) == _Z_RES_OK) {
+                    ztu->_batch_count = ztu->_batch_count + (size_t)1;
+                    batched = true;
+                    _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_N_MSGS);
                 } else {
-                    // Change the MID
-
-                    // for ()
-                }
-                if (ret == _Z_RES_OK) {
-                    ztu->_transmitted = true;  // Mark the session that we have transmitted data
+                    _z_wbuf_set_wpos(&ztu->_wbuf, w_pos);  // Revert the buffer
                 }
-            } else {
-                // The message does not fit in the current batch, let's fragment it
-                // Create an expandable wbuf for fragmentation
-                _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+            }
+            if (batched == false) {
+                // The message cannot be appended to the current batch, flush it
+                ret = __unsafe_z_unicast_flush(ztu);
+            }
+        }
+#endif  // Z_FEATURE_BATCHING == 1
 
-                ret = _z_network_message_encode(&fbf, n_msg);  // Encode the message on the expandable wbuf
+        if ((batched == false) && (ret == _Z_RES_OK)) {
+            // Prepare the buffer eventually reserving space for the message length
+            __unsafe_z_prepare_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+
+            sn = __unsafe_z_unicast_get_sn(ztu, lane, reliability);  // Get the next sequence number
+
+            _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability, qos);
+            ret = _z_transport_message_encode(&ztu->_wbuf, &t_msg);  // Encode the frame header
+            if (ret == _Z_RES_OK) {
+                ret = _z_network_message_encode(&ztu->_wbuf, n_msg);  // Encode the network message
                 if (ret == _Z_RES_OK) {
-                    _Bool is_first = true;  // Fragment and send the message
-                    while (_z_wbuf_len(&fbf) > 0) {
-                        if (is_first == false) {  // Get the fragment sequence number
-                            sn = __unsafe_z_unicast_get_sn(ztu, reliability);
-                        }
-                        is_first = false;
-
-                        // Clear the buffer for serialization
-                        __unsafe_z_prepare_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
-
-                        // Serialize one fragment
-                        ret = __unsafe_z_serialize_zenoh_fragment(&ztu->_wbuf, &fbf, reliability, sn);
-                        if (ret == _Z_RES_OK) {
-                            // Write the message length in the reserved space if needed
-                            __unsafe_z_finalize_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
-
-                            ret = _z_link_send_wbuf(&ztu->_link, &ztu->_wbuf);  // Send the wbuf on the socket
-                            if (ret == _Z_RES_OK) {
-                                ztu->_transmitted = true;  // Mark the session that we have transmitted data
-                            }
-                        }
+                    _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_N_MSGS);
+#if Z_FEATURE_BATCHING == 1
+                    // Open a new batch, it will be sent once full, expired or explicitly flushed
+                    ztu->_batch_count = 1;
+                    ztu->_batch_reliability = reliability;
+                    ztu->_batch_lane = lane;
+                    ztu->_batch_time = zp_clock_now();
+#else
+                    // Write the message length in the reserved space if needed
+                    __unsafe_z_finalize_wbuf(&ztu->_wbuf, ztu->_link._cap._flow);
+                    __unsafe_z_unicast_keep(ztu, &ztu->_wbuf, lane);
+
+                    ret = _z_link_send_wbuf(&ztu->_link, &ztu->_wbuf);  // Send the wbuf on the socket
+                    if (ret == _Z_RES_OK) {
+                        ztu->_transmitted = true;  // Mark the session that we have transmitted data
+                        _Z_STATS_TX_BATCH(&ztu->_stats, _z_wbuf_len(&ztu->_wbuf));
                     }
+#endif  // Z_FEATURE_BATCHING == 1
+                } else {
+                    // The message does not fit in the current batch, let's fragment it
+                    fragment = true;
                 }
+            }
+        }
 
-                // Clear the buffer as it's no longer required
-                _z_wbuf_clear(&fbf);
+#if Z_FEATURE_BATCHING == 1
+        if ((ret == _Z_RES_OK) && (ztu->_batch_count > 0)) {
+            // Flush the batch if it has been lingering for too long, or if nothing would flush it in time
+            ztu->_batch_active = true;
+            if (__unsafe_z_unicast_batch_expired(ztu) == true) {
+                ret = __unsafe_z_unicast_flush(ztu);
             }
         }
+#endif  // Z_FEATURE_BATCHING == 1
 
 #if Z_FEATURE_MULTI_THREAD == 1
         zp_mutex_unlock(&ztu->_mutex_tx);
 #endif  // Z_FEATURE_MULTI_THREAD == 1
+
+        if (fragment == true) {
+            // Encode the message on an expandable buffer, only the lane lock is held for the whole fragment train
+            _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+            ret = _z_network_message_encode(&fbf, n_msg);
+            if (ret == _Z_RES_OK) {
+                ret = __unsafe_z_unicast_send_fragments(ztu, &fbf, reliability, lane, qos, sn);
+            }
+            if (ret == _Z_RES_OK) {
+                _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_N_MSGS);
+            }
+            _z_wbuf_clear(&fbf);
+        }
+
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_unlock(&ztu->_mutex_lanes[lane]);
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+    }
+
+    return ret;
+}
+
+int8_t _z_unicast_send_n_msg(_z_transport_unicast_t *ztu, const _z_network_message_t *n_msg,
+                             z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
+    int8_t ret = _Z_ERR_CONNECTION_CLOSED;
+    _Z_DEBUG(">> send network message");
+
+    // Select the lane of the message priority, all the messages share the first lane if QoS is not negotiated
+    uint8_t lane = _z_conduit_sn_list_index(&ztu->_sn_tx_sns, _z_n_qos_get_priority(_z_n_msg_get_qos(n_msg)));
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    if (ztu->_tx_task_running == true) {
+        // Hand the message over to the TX task, its queue is closed if the task is being stopped
+        ret = _z_tx_queue_push(&ztu->_tx_queue, n_msg, reliability, lane, cong_ctrl);
+    }
+#endif  // Z_FEATURE_MULTI_THREAD == 1
+
+    if (ret == _Z_ERR_CONNECTION_CLOSED) {
+        _z_n_qos_t qos = (ztu->_sn_tx_sns._is_qos == true) ? _z_n_qos_make(0, 0, lane) : _Z_N_QOS_DEFAULT;
+        ret = __z_unicast_send_n_msg(ztu, n_msg, reliability, cong_ctrl, lane, qos);
     }
 
     return ret;
 }
 #else
+int8_t _z_unicast_flush(_z_transport_unicast_t *ztu) {
+    _ZP_UNUSED(ztu);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+
+int8_t _z_unicast_batch_step(_z_transport_unicast_t *ztu, _z_zint_t now, _z_zint_t *interval) {
+    _ZP_UNUSED(ztu);
+    _ZP_UNUSED(now);
+    _ZP_UNUSED(interval);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+
 int8_t _z_unicast_send_t_msg(_z_transport_unicast_t *ztu, const _z_transport_message_t *t_msg) {
     _ZP_UNUSED(ztu);
     _ZP_UNUSED(t_msg);
     return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
 }
 
-int8_t _z_unicast_send_n_msg(_z_session_t *zn, const _z_network_message_t *n_msg, z_reliability_t reliability,
-                             z_congestion_control_t cong_ctrl) {
-    _ZP_UNUSED(zn);
+int8_t _z_unicast_send_n_msg(_z_transport_unicast_t *ztu, const _z_network_message_t *n_msg,
+                             z_reliability_t reliability, z_congestion_control_t cong_ctrl) {
+    _ZP_UNUSED(ztu);
     _ZP_UNUSED(n_msg);
     _ZP_UNUSED(reliability);
     _ZP_UNUSED(cong_ctrl);
     return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
 }
 #endif  // Z_FEATURE_UNICAST_TRANSPORT == 1
+
+#if Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
+
+/**
+ * Send a queued message, followed by the next queued messages of the same lane and reliability as long as they fit
+ * in the same frame. Return the first pulled message that is left to be sent, if any.
+ */
+static _z_tx_entry_t *__z_unicast_tx_task_send(_z_transport_unicast_t *ztu, _z_tx_entry_t *e) {
+    int8_t ret = _Z_RES_OK;
+    _z_tx_entry_t *next = NULL;
+    uint8_t lane = e->_lane;
+    z_reliability_t reliability = e->_reliability;
+    _z_n_qos_t qos = (ztu->_sn_tx_sns._is_qos == true) ? _z_n_qos_make(0, 0, lane) : _Z_N_QOS_DEFAULT;
+
+    // The lane lock is uncontended unless a message is sent directly while the task starts or stops
+    zp_mutex_lock(&ztu->_mutex_lanes[lane]);
+    zp_mutex_lock(&ztu->_mutex_tx);
+
+#if Z_FEATURE_BATCHING == 1
+    // Flush the batch of the messages sent directly before the task started
+    ret = __unsafe_z_unicast_flush(ztu);
+#endif  // Z_FEATURE_BATCHING == 1
+
+    // With batched writes, the frames of the messages queued behind on the same lane are built in the TX slots and
+    // sent together, otherwise a single frame is built in the TX buffer
+    _z_wbuf_t *wbfs = (ztu->_tx_slots != NULL) ? ztu->_tx_slots : &ztu->_wbuf;
+    size_t max = (ztu->_tx_slots != NULL) ? _z_link_batch_max(&ztu->_link) : (size_t)1;
+    size_t count = 0;
+
+    _z_zint_t sn = 0;
+    _Bool fragment = false;
+    while ((e != NULL) && (ret == _Z_RES_OK) && (fragment == false)) {
+        reliability = e->_reliability;
+
+        // Prepare the buffer eventually reserving space for the message length
+        __unsafe_z_prepare_wbuf(&wbfs[count], ztu->_link._cap._flow);
+
+        sn = __unsafe_z_unicast_get_sn(ztu, lane, reliability);  // Get the next sequence number
+
+        _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, reliability, qos);
+        ret = _z_transport_message_encode(&wbfs[count], &t_msg);  // Encode the frame header
+        if (ret == _Z_RES_OK) {
+            if (_z_wbuf_space_left(&wbfs[count]) >= e->_len) {
+                while ((e != NULL) && (ret == _Z_RES_OK)) {
+                    ret = _z_wbuf_write_bytes(&wbfs[count], e->_buf, 0, e->_len);
+                    _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_N_MSGS);
+                    _z_tx_entry_free(&e);
+
+                    // Batch the messages already queued behind
+                    next = _z_tx_queue_pull(&ztu->_tx_queue);
+                    if ((next != NULL) && (next->_lane == lane) && (next->_reliability == reliability) &&
+                        (_z_wbuf_space_left(&wbfs[count]) >= next->_len)) {
+                        e = next;
+                        next = NULL;
+                    }
+                }
+                if (ret == _Z_RES_OK) {
+                    // Write the message length in the reserved space if needed
+                    __unsafe_z_finalize_wbuf(&wbfs[count], ztu->_link._cap._flow);
+                    __unsafe_z_unicast_keep(ztu, &wbfs[count], lane);
+                    count = count + (size_t)1;
+
+                    // Start another frame with the next message of the lane if a slot is left
+                    if ((next != NULL) && (next->_lane == lane) && (count < max)) {
+                        e = next;
+                        next = NULL;
+                    }
+                }
+            } else {
+                // The message does not fit in a frame, let's fragment it once the previous frames have been sent
+                fragment = true;
+            }
+        }
+    }
+
+    if ((ret == _Z_RES_OK) && (count > (size_t)0)) {
+        ret = _z_link_send_wbufs(&ztu->_link, wbfs, count);  // Send the frames on the socket
+        if (ret == _Z_RES_OK) {
+            ztu->_transmitted = true;  // Mark the session that we have transmitted data
+#if Z_FEATURE_STATS == 1
+            for (size_t i = 0; i < count; i++) {
+                _Z_STATS_TX_BATCH(&ztu->_stats, _z_wbuf_len(&wbfs[i]));
+            }
+#endif  // Z_FEATURE_STATS == 1
+        }
+    }
+
+    zp_mutex_unlock(&ztu->_mutex_tx);
+
+    if (fragment == true) {
+        // The fragments are serialized from the queued message without copying it
+        _z_wbuf_t fbf = _z_wbuf_make(_Z_FRAG_BUFF_BASE_SIZE, true);
+        ret = _z_wbuf_wrap_bytes(&fbf, e->_buf, 0, e->_len);
+        if (ret == _Z_RES_OK) {
+            ret = __unsafe_z_unicast_send_fragments(ztu, &fbf, reliability, lane, qos, sn);
+        }
+        if (ret == _Z_RES_OK) {
+            _Z_STATS_INC(&ztu->_stats, _Z_STATS_TX_N_MSGS);
+        }
+        _z_wbuf_clear(&fbf);
+    }
+
+    zp_mutex_unlock(&ztu->_mutex_lanes[lane]);
+
+    if (ret != _Z_RES_OK) {
+        _Z_ERROR("TX task failed to send a network message");
+    }
+    _z_tx_entry_free(&e);
+    return next;
+}
+
+void *_zp_unicast_tx_task(void *ztu_arg) {
+    _z_transport_unicast_t *ztu = (_z_transport_unicast_t *)ztu_arg;
+
+    // The queue is drained once closed, so that all the messages accepted before stopping are sent
+    _z_tx_entry_t *e = NULL;
+    _Bool running = true;
+    while (running == true) {
+        if (e == NULL) {
+            e = _z_tx_queue_pull(&ztu->_tx_queue);
+        }
+        if (e != NULL) {
+            e = __z_unicast_tx_task_send(ztu, e);
+        } else if (_z_tx_queue_is_done(&ztu->_tx_queue) == true) {
+            running = false;
+        } else {
+            // Also waits for the publishers that passed the closing of the queue to be done pushing
+            _z_tx_queue_wait(&ztu->_tx_queue);
+        }
+    }
+
+    return NULL;
+}
+
+int8_t _zp_unicast_start_tx_task(_z_transport_t *zt, zp_task_attr_t *attr, zp_task_t *task) {
+    _z_transport_unicast_t *ztu = &zt->_transport._unicast;
+    if (ztu->_tx_task != NULL) {
+        return _Z_ERR_GENERIC;
+    }
+    // Init memory
+    (void)memset(task, 0, sizeof(zp_task_t));
+    // Open the queue
+    int8_t ret = _z_tx_queue_open(&ztu->_tx_queue);
+    if (ret != _Z_RES_OK) {
+        return ret;
+    }
+#if Z_FEATURE_STATS == 1
+    // The messages dropped by the queue are accounted for in the transport
+    ztu->_tx_queue._stats = &ztu->_stats;
+#endif  // Z_FEATURE_STATS == 1
+    // Frames are only built in slots when the link sends several datagrams at once, the task falls back to the TX
+    // buffer if they cannot be allocated
+    ztu->_tx_slots = _z_tx_slots_make(&ztu->_link, _z_wbuf_capacity(&ztu->_wbuf));
+    // Init task
+    if (zp_task_init(task, attr, _zp_unicast_tx_task, ztu) != _Z_RES_OK) {
+        _z_tx_queue_close(&ztu->_tx_queue);
+        _z_tx_slots_free(&ztu->_tx_slots, &ztu->_link);
+        return _Z_ERR_SYSTEM_TASK_FAILED;
+    }
+    // Attach task
+    ztu->_tx_task = task;
+    ztu->_tx_task_running = true;
+    return _Z_RES_OK;
+}
+
+int8_t _zp_unicast_stop_tx_task(_z_transport_t *zt) {
+    _z_transport_unicast_t *ztu = &zt->_transport._unicast;
+    if (ztu->_tx_task != NULL) {
+        // New messages are sent directly, the task exits once it sent the queued ones
+        ztu->_tx_task_running = false;
+        _z_tx_queue_close(&ztu->_tx_queue);
+        zp_task_join(ztu->_tx_task);
+        zp_task_free(&ztu->_tx_task);
+        _z_tx_slots_free(&ztu->_tx_slots, &ztu->_link);
+    }
+    return _Z_RES_OK;
+}
+
+#else
+
+void *_zp_unicast_tx_task(void *ztu_arg) {
+    _ZP_UNUSED(ztu_arg);
+    return NULL;
+}
+
+int8_t _zp_unicast_start_tx_task(_z_transport_t *zt, void *attr, void *task) {
+    _ZP_UNUSED(zt);
+    _ZP_UNUSED(attr);
+    _ZP_UNUSED(task);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+
+int8_t _zp_unicast_stop_tx_task(_z_transport_t *zt) {
+    _ZP_UNUSED(zt);
+    return _Z_ERR_TRANSPORT_NOT_AVAILABLE;
+}
+#endif  // Z_FEATURE_MULTI_THREAD == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
@@ -15,6 +15,7 @@
 #include "zenoh-pico/transport/utils.h"
 
 #include "zenoh-pico/protocol/core.h"
+#include "zenoh-pico/utils/result.h"
 
 #define U8_MAX 0xFF
 #define U16_MAX 0xFFFF
@@ -92,6 +93,14 @@ _z_zint_t _z_sn_decrement(const _z_zint_t sn_resolution, const _z_zint_t sn) {
     return (ret &= sn_resolution);
 }
 
+void _z_conduit_sn_list_init(_z_conduit_sn_list_t *sns, _Bool is_qos, _z_zint_t sn) {
+    sns->_is_qos = is_qos;
+    for (uint8_t i = 0; i < Z_PRIORITIES_NUM; i++) {
+        sns->_val._qos[i]._best_effort = sn;
+        sns->_val._qos[i]._reliable = sn;
+    }
+}
+
 void _z_conduit_sn_list_copy(_z_conduit_sn_list_t *dst, const _z_conduit_sn_list_t *src) {
     dst->_is_qos = src->_is_qos;
     if (dst->_is_qos == false) {
@@ -112,7 +121,35 @@ void _z_conduit_sn_list_decrement(const _z_zint_t sn_resolution, _z_conduit_sn_l
     } else {
         for (uint8_t i = 0; i < Z_PRIORITIES_NUM; i++) {
             sns->_val._qos[i]._best_effort = _z_sn_decrement(sn_resolution, sns->_val._qos[i]._best_effort);
-            sns->_val._qos[i]._best_effort = _z_sn_decrement(sn_resolution, sns->_val._qos[i]._reliable);
+            sns->_val._qos[i]._reliable = _z_sn_decrement(sn_resolution, sns->_val._qos[i]._reliable);
         }
     }
 }
+
+uint8_t _z_conduit_sn_list_index(const _z_conduit_sn_list_t *sns, uint8_t priority) {
+    return ((sns->_is_qos == true) && (priority < Z_PRIORITIES_NUM)) ? priority : 0;
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+int8_t _z_transport_lanes_mutex_init(zp_mutex_t *mutexes) {
+    int8_t ret = _Z_RES_OK;
+    for (size_t i = 0; (ret == _Z_RES_OK) && (i < _Z_TRANSPORT_LANES_NUM); i++) {
+        ret = zp_mutex_init(&mutexes[i]);
+        if (ret != _Z_RES_OK) {
+            // Free the mutexes initialized so far
+            while (i > 0) {
+                i = i - 1;
+                zp_mutex_free(&mutexes[i]);
+            }
+            break;
+        }
+    }
+    return ret;
+}
+
+void _z_transport_lanes_mutex_free(zp_mutex_t *mutexes) {
+    for (size_t i = 0; i < _Z_TRANSPORT_LANES_NUM; i++) {
+        zp_mutex_free(&mutexes[i]);
+    }
+}
+#endif  // Z_FEATURE_MULTI_THREAD == 1
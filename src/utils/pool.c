@@ -0,0 +1,216 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/utils/pool.h"
+
+#include <string.h>
+
+#include "zenoh-pico/collections/atomic.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/utils/result.h"
+
+#if Z_FEATURE_MEMORY_POOL == 1
+/*------------------ Memory pool ------------------*/
+// The free lists are indexed by the lower bits of their head, the upper bits are a tag against the ABA problem
+#define _Z_POOL_IDX_BITS 16
+#define _Z_POOL_IDX_MASK (((size_t)1 << _Z_POOL_IDX_BITS) - (size_t)1)
+#define _Z_POOL_TAG_INC ((size_t)1 << _Z_POOL_IDX_BITS)
+
+// The classes are laid out one after the other, the blocks of the class i are Z_MEMORY_POOL_BLOCK_SIZE << i bytes
+#define _Z_POOL_CLASS_SIZE(i) ((size_t)Z_MEMORY_POOL_BLOCKS * ((size_t)Z_MEMORY_POOL_BLOCK_SIZE << (i)))
+#define _Z_POOL_ARENA_SIZE (_Z_POOL_CLASS_SIZE(Z_MEMORY_POOL_CLASSES) - _Z_POOL_CLASS_SIZE(0))
+
+typedef struct {
+    _z_atomic(size_t) _head;  // The index + 1 of the first free block, 0 if the list is empty
+    _z_atomic(size_t) _carved;  // The blocks past this index were never allocated, they are not in the list
+    _z_atomic(size_t) _used;
+    _z_atomic(size_t) _high_watermark;
+    _z_atomic(size_t) _fallbacks;
+    _z_atomic(size_t) _next[Z_MEMORY_POOL_BLOCKS];  // The index + 1 of the next free block
+} _z_pool_class_t;
+
+// Zero initialized, all the blocks are yet to be carved: the pool needs no initialization
+static _z_pool_class_t _z_pool_classes[Z_MEMORY_POOL_CLASSES];
+static uint64_t _z_pool_arena[_Z_POOL_ARENA_SIZE / sizeof(uint64_t)];
+
+static uint8_t *__z_pool_block(size_t cls, size_t idx) {
+    return (uint8_t *)_z_pool_arena + (_Z_POOL_CLASS_SIZE(cls) - _Z_POOL_CLASS_SIZE(0)) +
+           (idx * ((size_t)Z_MEMORY_POOL_BLOCK_SIZE << cls));
+}
+
+static _Bool __z_pool_locate(const void *ptr, size_t *cls, size_t *idx) {
+    _Bool ret = false;
+    uintptr_t base = (uintptr_t)_z_pool_arena;
+    uintptr_t p = (uintptr_t)ptr;
+    if ((p >= base) && (p < (base + _Z_POOL_ARENA_SIZE))) {
+        size_t off = (size_t)(p - base);
+        size_t c = 0;
+        while (off >= (_Z_POOL_CLASS_SIZE(c + (size_t)1) - _Z_POOL_CLASS_SIZE(0))) {
+            c = c + (size_t)1;
+        }
+        *cls = c;
+        *idx = (off - (_Z_POOL_CLASS_SIZE(c) - _Z_POOL_CLASS_SIZE(0))) / ((size_t)Z_MEMORY_POOL_BLOCK_SIZE << c);
+        ret = true;
+    }
+    return ret;
+}
+
+static _Bool __z_pool_pop(_z_pool_class_t *c, size_t *idx) {
+    _Bool ret = false;
+
+    size_t head = _z_atomic_load_explicit(&c->_head, _z_memory_order_acquire);
+    while ((ret == false) && ((head & _Z_POOL_IDX_MASK) != (size_t)0)) {
+        size_t i = (head & _Z_POOL_IDX_MASK) - (size_t)1;
+        // The block may be popped by another thread meanwhile, the tag then fails the exchange
+        size_t next = _z_atomic_load_explicit(&c->_next[i], _z_memory_order_relaxed);
+        size_t tagged = ((head & ~_Z_POOL_IDX_MASK) + _Z_POOL_TAG_INC) | next;
+        if (_z_atomic_compare_exchange_strong_explicit(&c->_head, &head, tagged, _z_memory_order_acquire,
+                                                       _z_memory_order_acquire) == true) {
+            *idx = i;
+            ret = true;
+        }
+    }
+
+    // No block was freed, carve a new one
+    size_t carved = _z_atomic_load_explicit(&c->_carved, _z_memory_order_relaxed);
+    while ((ret == false) && (carved < (size_t)Z_MEMORY_POOL_BLOCKS)) {
+        if (_z_atomic_compare_exchange_strong_explicit(&c->_carved, &carved, carved + (size_t)1,
+                                                       _z_memory_order_relaxed, _z_memory_order_relaxed) == true) {
+            *idx = carved;
+            ret = true;
+        }
+    }
+
+    return ret;
+}
+
+static void __z_pool_push(_z_pool_class_t *c, size_t idx) {
+    _Bool pushed = false;
+    size_t head = _z_atomic_load_explicit(&c->_head, _z_memory_order_relaxed);
+    while (pushed == false) {
+        _z_atomic_store_explicit(&c->_next[idx], head & _Z_POOL_IDX_MASK, _z_memory_order_relaxed);
+        size_t tagged = ((head & ~_Z_POOL_IDX_MASK) + _Z_POOL_TAG_INC) | (idx + (size_t)1);
+        pushed = _z_atomic_compare_exchange_strong_explicit(&c->_head, &head, tagged, _z_memory_order_release,
+                                                            _z_memory_order_relaxed);
+    }
+}
+
+void *_z_pool_malloc(size_t size) {
+    void *ret = NULL;
+
+    size_t cls = 0;
+    while ((cls < (size_t)Z_MEMORY_POOL_CLASSES) && (((size_t)Z_MEMORY_POOL_BLOCK_SIZE << cls) < size)) {
+        cls = cls + (size_t)1;
+    }
+    if (cls < (size_t)Z_MEMORY_POOL_CLASSES) {
+        _z_pool_class_t *c = &_z_pool_classes[cls];
+        size_t idx = 0;
+        if (__z_pool_pop(c, &idx) == true) {
+            ret = __z_pool_block(cls, idx);
+
+            size_t used = _z_atomic_fetch_add_explicit(&c->_used, (size_t)1, _z_memory_order_relaxed) + (size_t)1;
+            size_t hwm = _z_atomic_load_explicit(&c->_high_watermark, _z_memory_order_relaxed);
+            while ((used > hwm) && (_z_atomic_compare_exchange_strong_explicit(&c->_high_watermark, &hwm, used,
+                                                                               _z_memory_order_relaxed,
+                                                                               _z_memory_order_relaxed) == false)) {
+                // hwm was reloaded, retry until it is at least used
+            }
+        } else {
+            _z_atomic_fetch_add_explicit(&c->_fallbacks, (size_t)1, _z_memory_order_relaxed);
+        }
+    }
+
+    return ret;
+}
+
+_Bool _z_pool_free(void *ptr) {
+    size_t cls = 0;
+    size_t idx = 0;
+    _Bool ret = __z_pool_locate(ptr, &cls, &idx);
+    if (ret == true) {
+        _z_pool_class_t *c = &_z_pool_classes[cls];
+        __z_pool_push(c, idx);
+        _z_atomic_fetch_sub_explicit(&c->_used, (size_t)1, _z_memory_order_relaxed);
+    }
+    return ret;
+}
+
+size_t _z_pool_block_size(const void *ptr) {
+    size_t ret = 0;
+    size_t cls = 0;
+    size_t idx = 0;
+    if (__z_pool_locate(ptr, &cls, &idx) == true) {
+        ret = (size_t)Z_MEMORY_POOL_BLOCK_SIZE << cls;
+    }
+    return ret;
+}
+
+int8_t _z_pool_stats(size_t cls, _z_pool_stats_t *stats) {
+    int8_t ret = _Z_RES_OK;
+    if (cls < (size_t)Z_MEMORY_POOL_CLASSES) {
+        _z_pool_class_t *c = &_z_pool_classes[cls];
+        stats->block_size = (size_t)Z_MEMORY_POOL_BLOCK_SIZE << cls;
+        stats->blocks = (size_t)Z_MEMORY_POOL_BLOCKS;
+        stats->used = _z_atomic_load_explicit(&c->_used, _z_memory_order_relaxed);
+        stats->high_watermark = _z_atomic_load_explicit(&c->_high_watermark, _z_memory_order_relaxed);
+        stats->fallbacks = _z_atomic_load_explicit(&c->_fallbacks, _z_memory_order_relaxed);
+    } else {
+        ret = _Z_ERR_GENERIC;
+    }
+    return ret;
+}
+#endif  // Z_FEATURE_MEMORY_POOL == 1
+
+/*------------------ Memory ------------------*/
+#if Z_FEATURE_MEMORY_POOL == 1
+void *zp_malloc(size_t size) {
+    void *ret = _z_pool_malloc(size);
+    if (ret == NULL) {
+        ret = zp_sys_malloc(size);
+    }
+    return ret;
+}
+
+void *zp_realloc(void *ptr, size_t size) {
+    void *ret = NULL;
+    size_t block_size = _z_pool_block_size(ptr);
+    if (ptr == NULL) {
+        ret = zp_malloc(size);
+    } else if (block_size == (size_t)0) {
+        ret = zp_sys_realloc(ptr, size);
+    } else if (size <= block_size) {
+        ret = ptr;
+    } else {
+        // The block cannot grow, move it to a larger class or to the platform allocator
+        ret = zp_malloc(size);
+        if (ret != NULL) {
+            (void)memcpy(ret, ptr, block_size);
+            (void)_z_pool_free(ptr);
+        }
+    }
+    return ret;
+}
+
+void zp_free(void *ptr) {
+    if (_z_pool_free(ptr) == false) {
+        zp_sys_free(ptr);
+    }
+}
+#else
+void *zp_malloc(size_t size) { return zp_sys_malloc(size); }
+
+void *zp_realloc(void *ptr, size_t size) { return zp_sys_realloc(ptr, size); }
+
+void zp_free(void *ptr) { zp_sys_free(ptr); }
+#endif  // Z_FEATURE_MEMORY_POOL == 1
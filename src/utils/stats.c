@@ -0,0 +1,60 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include "zenoh-pico/utils/stats.h"
+
+#if Z_FEATURE_STATS == 1
+
+void _z_transport_stats_reset(_z_transport_stats_t *stats) {
+    for (size_t i = 0; i < (size_t)_Z_STATS_TRANSPORT_NUM; i++) {
+        _z_atomic_store_explicit(&stats->_counters[i], (size_t)0, _z_memory_order_relaxed);
+    }
+}
+
+void _z_session_stats_reset(_z_session_stats_t *stats) {
+    for (size_t i = 0; i < (size_t)_Z_STATS_SESSION_NUM; i++) {
+        _z_atomic_store_explicit(&stats->_counters[i], (size_t)0, _z_memory_order_relaxed);
+    }
+}
+
+static size_t __z_stats_get(const _z_atomic(size_t) * counters, size_t counter) {
+    return _z_atomic_load_explicit(&counters[counter], _z_memory_order_relaxed);
+}
+
+void _z_transport_stats_read(const _z_transport_stats_t *stats, _z_stats_t *snapshot) {
+    snapshot->tx_n_msgs += __z_stats_get(stats->_counters, _Z_STATS_TX_N_MSGS);
+    snapshot->tx_bytes += __z_stats_get(stats->_counters, _Z_STATS_TX_BYTES);
+    snapshot->tx_batches += __z_stats_get(stats->_counters, _Z_STATS_TX_BATCHES);
+    snapshot->tx_fragments += __z_stats_get(stats->_counters, _Z_STATS_TX_FRAGMENTS);
+    snapshot->tx_keep_alives += __z_stats_get(stats->_counters, _Z_STATS_TX_KEEP_ALIVES);
+    snapshot->tx_congestion_drops += __z_stats_get(stats->_counters, _Z_STATS_TX_CONGESTION_DROPS);
+    snapshot->rx_n_msgs += __z_stats_get(stats->_counters, _Z_STATS_RX_N_MSGS);
+    snapshot->rx_bytes += __z_stats_get(stats->_counters, _Z_STATS_RX_BYTES);
+    snapshot->rx_batches += __z_stats_get(stats->_counters, _Z_STATS_RX_BATCHES);
+    snapshot->rx_fragments += __z_stats_get(stats->_counters, _Z_STATS_RX_FRAGMENTS);
+    snapshot->rx_keep_alives += __z_stats_get(stats->_counters, _Z_STATS_RX_KEEP_ALIVES);
+    snapshot->rx_out_of_order_drops += __z_stats_get(stats->_counters, _Z_STATS_RX_OUT_OF_ORDER_DROPS);
+    snapshot->rx_reassembly_drops += __z_stats_get(stats->_counters, _Z_STATS_RX_REASSEMBLY_DROPS);
+}
+
+void _z_session_stats_read(const _z_session_stats_t *stats, _z_stats_t *snapshot) {
+    snapshot->rx_declares = __z_stats_get(stats->_counters, _Z_STATS_RX_DECLARES);
+    snapshot->rx_pushes = __z_stats_get(stats->_counters, _Z_STATS_RX_PUSHES);
+    snapshot->rx_requests = __z_stats_get(stats->_counters, _Z_STATS_RX_REQUESTS);
+    snapshot->rx_responses = __z_stats_get(stats->_counters, _Z_STATS_RX_RESPONSES);
+    snapshot->rx_response_finals = __z_stats_get(stats->_counters, _Z_STATS_RX_RESPONSE_FINALS);
+    snapshot->rx_errors = __z_stats_get(stats->_counters, _Z_STATS_RX_ERRORS);
+}
+
+#endif  // Z_FEATURE_STATS == 1
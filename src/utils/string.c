@@ -18,6 +18,7 @@
 #include <string.h>
 
 #include "zenoh-pico/utils/pointers.h"
+#include "zenoh-pico/utils/simd.h"
 
 _z_str_se_t _z_bstrnew(const char *start) { return (_z_str_se_t){.start = start, .end = strchr(start, 0)}; }
 
@@ -77,6 +78,49 @@ char const *_z_strstr(char const *haystack_start, char const *haystack_end, cons
     return _z_bstrstr((_z_str_se_t){.start = haystack_start, .end = haystack_end},
                       (_z_str_se_t){.start = needle_start, .end = needle_end});
 }
+// The length of a string, the splitters may give a start past the end for an empty one
+static inline size_t __z_bstrlen(_z_str_se_t s) { return (s.start < s.end) ? (size_t)(s.end - s.start) : (size_t)0; }
+
+// The scans of _z_bstrchr and _z_rbstrchr, inlined in the splitters
+static inline char const *__z_bstrchr(char const *start, size_t len, char c) {
+    char const *result = NULL;
+    size_t i = 0;
+#ifdef _Z_SIMD_WIDTH
+    for (; (result == NULL) && ((len - i) >= (size_t)_Z_SIMD_WIDTH); i = i + (size_t)_Z_SIMD_WIDTH) {
+        uint64_t mask = _z_simd_match(_z_simd_load(&start[i]), c);
+        if (mask != (uint64_t)0) {
+            result = &start[i + _z_simd_first(mask)];
+        }
+    }
+#endif
+    if ((result == NULL) && (i < len)) {
+        result = (char const *)memchr(&start[i], c, len - i);
+    }
+    return result;
+}
+
+static inline char const *__z_rbstrchr(char const *start, size_t len, char c) {
+    char const *result = NULL;
+#ifdef _Z_SIMD_WIDTH
+    for (; (result == NULL) && (len >= (size_t)_Z_SIMD_WIDTH); len = len - (size_t)_Z_SIMD_WIDTH) {
+        uint64_t mask = _z_simd_match(_z_simd_load(&start[len - (size_t)_Z_SIMD_WIDTH]), c);
+        if (mask != (uint64_t)0) {
+            result = &start[len - (size_t)_Z_SIMD_WIDTH + _z_simd_last(mask)];
+        }
+    }
+#endif
+    for (; (result == NULL) && (len > (size_t)0); len--) {
+        if (start[len - (size_t)1] == c) {
+            result = &start[len - (size_t)1];
+        }
+    }
+    return result;
+}
+
+char const *_z_bstrchr(_z_str_se_t s, char c) { return __z_bstrchr(s.start, __z_bstrlen(s), c); }
+
+char const *_z_rbstrchr(_z_str_se_t s, char c) { return __z_rbstrchr(s.start, __z_bstrlen(s), c); }
+
 char const *_z_strstr_skipneedle(char const *haystack_start, char const *haystack_end, const char *needle_start) {
     const char *needle_end = strchr(needle_start, 0);
     return _z_bstrstr_skipneedle((_z_str_se_t){.start = haystack_start, .end = haystack_end},
@@ -94,7 +138,12 @@ char const *_z_bstrstr_skipneedle(_z_str_se_t haystack, _z_str_se_t needle) {
 _z_str_se_t _z_splitstr_next(_z_splitstr_t *str) {
     _z_str_se_t result = str->s;
     if (str->s.start != NULL) {
-        result.end = _z_strstr(result.start, result.end, str->delimiter);
+        // The key expressions are mostly split at a single character, found without comparing the needle
+        if (str->delimiter[1] == '\0') {
+            result.end = __z_bstrchr(result.start, __z_bstrlen(result), str->delimiter[0]);
+        } else {
+            result.end = _z_strstr(result.start, result.end, str->delimiter);
+        }
         if (result.end == NULL) {
             result.end = str->s.end;
         }
@@ -110,7 +159,14 @@ _z_str_se_t _z_splitstr_next(_z_splitstr_t *str) {
 _z_str_se_t _z_splitstr_nextback(_z_splitstr_t *str) {
     _z_str_se_t result = str->s;
     if (str->s.start != NULL) {
-        result.start = _z_rstrstr(result.start, result.end, str->delimiter);
+        if (str->delimiter[1] == '\0') {
+            result.start = __z_rbstrchr(result.start, __z_bstrlen(result), str->delimiter[0]);
+            if (result.start != NULL) {
+                result.start = _z_cptr_char_offset(result.start, 1);
+            }
+        } else {
+            result.start = _z_rstrstr(result.start, result.end, str->delimiter);
+        }
         if (result.start == NULL) {
             result.start = str->s.start;
         }
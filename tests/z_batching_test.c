@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/net/session.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/transport.h"
+#include "zenoh-pico/transport/unicast/lease.h"
+#include "zenoh-pico/transport/unicast/read.h"
+#include "zenoh-pico/transport/unicast/transport.h"
+#include "zenoh-pico/transport/unicast/tx.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_BATCHING == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
+
+#define MTU 512
+#define DATAGRAMS 16
+#define LEASE 10000
+
+// The link loops the datagrams written on it back to its reader, once the given number of writes failed
+static uint8_t datagrams[DATAGRAMS][MTU];
+static size_t lens[DATAGRAMS];
+static size_t head = 0;
+static size_t tail = 0;
+static size_t failures = 0;
+
+static size_t write(const _z_link_t *self, const uint8_t *ptr, size_t len) {
+    (void)(self);
+    if (failures > (size_t)0) {
+        failures--;
+        return SIZE_MAX;
+    }
+    assert((len <= (size_t)MTU) && (tail - head < (size_t)DATAGRAMS));
+    (void)memcpy(datagrams[tail % DATAGRAMS], ptr, len);
+    lens[tail % DATAGRAMS] = len;
+    tail++;
+    return len;
+}
+
+static size_t read(const _z_link_t *self, uint8_t *ptr, size_t len, _z_bytes_t *addr) {
+    (void)(self);
+    (void)(addr);
+    assert((head < tail) && (lens[head % DATAGRAMS] <= len));
+    size_t rb = lens[head % DATAGRAMS];
+    (void)memcpy(ptr, datagrams[head % DATAGRAMS], rb);
+    head++;
+    return rb;
+}
+
+static void close_link(_z_link_t *self) { (void)(self); }
+static void free_link(_z_link_t *self) { (void)(self); }
+
+static void make_session(_z_session_t *zn) {
+    _z_link_t zl;
+    (void)memset(&zl, 0, sizeof(zl));
+    zl._write_f = write;
+    zl._read_f = read;
+    zl._close_f = close_link;
+    zl._free_f = free_link;
+    zl._mtu = MTU;
+    zl._cap._transport = Z_LINK_CAP_TRANSPORT_UNICAST;
+    zl._cap._flow = Z_LINK_CAP_FLOW_DATAGRAM;
+
+    // The initial SNs let the transport receive its own frames
+    _z_transport_unicast_establish_param_t param;
+    (void)memset(&param, 0, sizeof(param));
+    param._seq_num_res = Z_SN_RESOLUTION;
+    param._batch_size = MTU;
+    param._lease = LEASE;
+
+    (void)memset(zn, 0, sizeof(_z_session_t));
+    assert(_z_unicast_transport_create(&zn->_tp, &zl, &param) == _Z_RES_OK);
+    _z_id_t zid = _z_id_empty();
+    assert(_z_session_init(zn, &zid) == _Z_RES_OK);
+    head = 0;
+    tail = 0;
+}
+
+static int8_t send(_z_session_t *zn) {
+    static uint8_t payload[8];
+    _z_keyexpr_t key = _z_rid_with_suffix(Z_RESOURCE_ID_NONE, "test/batching");
+    _z_push_body_t body = _z_push_body_null();
+    body._is_put = true;
+    body._body._put._payload = _z_bytes_wrap(payload, sizeof(payload));
+    _z_network_message_t push = _z_n_msg_make_push(&key, &body);
+    int8_t ret = _z_send_n_msg(zn, &push, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK);
+    _z_n_msg_clear(&push);
+    return ret;
+}
+
+static _z_zint_t lease_step(_z_transport_unicast_t *ztu) {
+    _z_zint_t interval = 0;
+    assert(_zp_unicast_lease_step(ztu, &interval) == _Z_RES_OK);
+    return interval;
+}
+
+// Without lease step, the messages are held until read or flushed
+void batch_test(void) {
+    _z_session_t zn;
+    make_session(&zn);
+    _z_transport_unicast_t *ztu = &zn._tp._transport._unicast;
+
+    for (size_t i = 0; i < 3; i++) {
+        assert(send(&zn) == _Z_RES_OK);
+    }
+    assert((tail == 0) && (ztu->_batch_count == 3));
+
+    // A read blocks, the batch is sent before it
+    assert(_zp_unicast_read(ztu) == _Z_RES_OK);
+    assert((tail == 1) && (head == 1) && (ztu->_batch_count == 0));
+
+    assert(send(&zn) == _Z_RES_OK);
+    assert(_zp_flush(&zn) == _Z_RES_OK);
+    assert((tail == 2) && (ztu->_batch_count == 0));
+
+    _z_session_clear(&zn);
+}
+
+// The lease step only flushes the expired batches, and only runs often while messages are sent
+void linger_test(void) {
+    _z_session_t zn;
+    make_session(&zn);
+    _z_transport_unicast_t *ztu = &zn._tp._transport._unicast;
+    _zp_unicast_lease_start(ztu);
+
+    // Nothing is sent, the step does not wake up for the batches
+    assert(lease_step(ztu) > (_z_zint_t)Z_BATCH_LINGER_TIME);
+
+    // The next step is too far to flush a batch in time, the message is sent right away
+    assert(send(&zn) == _Z_RES_OK);
+    assert((tail == 1) && (ztu->_batch_count == 0));
+
+    // Messages are being sent, the next step runs in time to flush a batch
+    assert(lease_step(ztu) <= (_z_zint_t)Z_BATCH_LINGER_TIME);
+    assert(send(&zn) == _Z_RES_OK);
+    assert(send(&zn) == _Z_RES_OK);
+    assert((tail == 1) && (ztu->_batch_count == 2));
+
+    // A pending batch is not flushed before it expires
+    assert(lease_step(ztu) <= (_z_zint_t)Z_BATCH_LINGER_TIME);
+    assert((tail == 1) && (ztu->_batch_count == 2));
+
+    // Once expired it is flushed, and as the messages stopped the step stops waking up for the batches
+    zp_sleep_ms(Z_BATCH_LINGER_TIME);
+    assert(lease_step(ztu) > (_z_zint_t)Z_BATCH_LINGER_TIME);
+    assert((tail == 2) && (ztu->_batch_count == 0));
+    assert(send(&zn) == _Z_RES_OK);
+    assert((tail == 3) && (ztu->_batch_count == 0));
+
+    _z_session_clear(&zn);
+}
+
+// The batch is sent before the close, and a failed flush is reported
+void close_test(void) {
+    _z_session_t zn;
+    make_session(&zn);
+    _z_transport_unicast_t *ztu = &zn._tp._transport._unicast;
+
+    assert(send(&zn) == _Z_RES_OK);
+    assert((tail == 0) && (ztu->_batch_count == 1));
+    assert(_z_unicast_transport_close(ztu, _Z_CLOSE_GENERIC) == _Z_RES_OK);
+    assert((tail == 2) && (lens[0] > lens[1]));
+
+    // The keep alive is not sent once the batch before it failed
+    assert(send(&zn) == _Z_RES_OK);
+    failures = 1;
+    assert(_zp_unicast_send_keep_alive(ztu) == _Z_ERR_TRANSPORT_TX_FAILED);
+    assert((tail == 2) && (ztu->_batch_count == 0));
+
+    // The close is still sent, but the failure of the batch is reported
+    assert(send(&zn) == _Z_RES_OK);
+    failures = 1;
+    assert(_z_unicast_transport_close(ztu, _Z_CLOSE_GENERIC) == _Z_ERR_TRANSPORT_TX_FAILED);
+    assert((tail == 3) && (lens[2] == lens[1]) && (ztu->_batch_count == 0));
+
+    _z_session_clear(&zn);
+}
+
+int main(void) {
+    batch_test();
+    linger_test();
+    close_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif
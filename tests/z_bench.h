@@ -0,0 +1,130 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#ifndef ZENOH_PICO_TESTS_BENCH_H
+#define ZENOH_PICO_TESTS_BENCH_H
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico.h"
+
+/**
+ * Helpers shared by the benchmarks. A benchmark records samples, e.g. the time per operation of a batch of
+ * operations or the round trip time of a message, and reports them as a JSON object with their percentiles.
+ * A run prints a single JSON document:
+ *
+ *   {"suite": ..., "version": ..., "config": {...}, "results": [{"name": ..., "param": ..., "unit": ..., ...}]}
+ */
+
+#define Z_BENCH_SAMPLES_MAX 4096
+
+typedef struct {
+    FILE *out;
+    size_t results;
+} z_bench_t;
+
+typedef struct {
+    const char *name;
+    const char *param_name;  // The name of the parameter of the benchmark, NULL if it has none
+    size_t param;
+    const char *unit;
+    size_t ops;  // The number of operations per sample, 1 if each sample is a single measure
+    size_t len;
+    double samples[Z_BENCH_SAMPLES_MAX];
+} z_bench_result_t;
+
+// Opens the output given on the command line, or the standard output
+static inline void z_bench_begin(z_bench_t *b, const char *suite, int argc, char **argv) {
+    b->out = stdout;
+    b->results = 0;
+    if (argc > 1) {
+        b->out = fopen(argv[1], "w");
+        if (b->out == NULL) {
+            printf("Unable to open %s\n", argv[1]);
+            exit(-1);
+        }
+    }
+    // The configuration the numbers depend on, runs are only comparable with the same one
+    fprintf(b->out, "{\"suite\": \"%s\", \"version\": \"%s\", \"config\": {", suite, ZENOH_PICO);
+    fprintf(b->out, "\"multi_thread\": %d, \"batching\": %d, \"priority_lanes\": %d, \"memory_pool\": %d, ",
+            Z_FEATURE_MULTI_THREAD, Z_FEATURE_BATCHING, Z_FEATURE_PRIORITY_LANES, Z_FEATURE_MEMORY_POOL);
+    fprintf(b->out, "\"udp_batch_io\": %d, \"reliability\": %d, \"batch_unicast_size\": %d, ",
+            Z_FEATURE_UDP_BATCH_IO, Z_FEATURE_RELIABILITY, Z_BATCH_UNICAST_SIZE);
+#ifdef __OPTIMIZE__
+    fprintf(b->out, "\"optimized\": true}, \"results\": [");
+#else
+    fprintf(b->out, "\"optimized\": false}, \"results\": [");
+#endif
+}
+
+static inline void z_bench_end(z_bench_t *b) {
+    fprintf(b->out, "\n]}\n");
+    if (b->out != stdout) {
+        fclose(b->out);
+    }
+}
+
+static inline void z_bench_result_init(z_bench_result_t *r, const char *name, const char *param_name, size_t param,
+                                       const char *unit) {
+    r->name = name;
+    r->param_name = param_name;
+    r->param = param;
+    r->unit = unit;
+    r->ops = 1;
+    r->len = 0;
+}
+
+static inline void z_bench_result_add(z_bench_result_t *r, double sample) {
+    if (r->len < (size_t)Z_BENCH_SAMPLES_MAX) {
+        r->samples[r->len] = sample;
+        r->len++;
+    }
+}
+
+static inline int z_bench_cmp(const void *l, const void *r) {
+    double dl = *(const double *)l;
+    double dr = *(const double *)r;
+    return (dl > dr) - (dl < dr);
+}
+
+// The nearest-rank percentile of the sorted samples
+static inline double z_bench_percentile(const z_bench_result_t *r, unsigned int p) {
+    size_t rank = ((r->len * p) + 99) / 100;
+    return r->samples[(rank > 0) ? (rank - 1) : 0];
+}
+
+static inline void z_bench_report(z_bench_t *b, z_bench_result_t *r) {
+    if (r->len == 0) {
+        return;
+    }
+    qsort(r->samples, r->len, sizeof(double), z_bench_cmp);
+    double sum = 0;
+    for (size_t i = 0; i < r->len; i++) {
+        sum += r->samples[i];
+    }
+    fprintf(b->out, "%s\n  {\"name\": \"%s\", ", (b->results > 0) ? "," : "", r->name);
+    if (r->param_name != NULL) {
+        fprintf(b->out, "\"%s\": %zu, ", r->param_name, r->param);
+    }
+    fprintf(b->out, "\"unit\": \"%s\", \"ops\": %zu, \"samples\": %zu, ", r->unit, r->ops, r->len);
+    fprintf(b->out, "\"min\": %.3f, \"p50\": %.3f, \"p90\": %.3f, \"p99\": %.3f, \"max\": %.3f, \"mean\": %.3f}",
+            r->samples[0], z_bench_percentile(r, 50), z_bench_percentile(r, 90), z_bench_percentile(r, 99),
+            r->samples[r->len - 1], sum / (double)r->len);
+    fflush(b->out);
+    b->results++;
+}
+
+#endif /* ZENOH_PICO_TESTS_BENCH_H */
@@ -0,0 +1,208 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "z_bench.h"
+
+#if Z_FEATURE_PUBLICATION == 1 && Z_FEATURE_SUBSCRIPTION == 1 && Z_FEATURE_MULTI_THREAD == 1 && \
+    Z_FEATURE_MULTICAST_TRANSPORT == 1 && Z_FEATURE_LINK_UDP_MULTICAST == 1
+
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
+// Peers only reach each other without a router over a multicast group
+#define LOCATOR "udp/224.0.0.226:7447#iface=lo"
+#define DISCOVERY_MS 10000
+#define WINDOW_MS 100
+#define WINDOWS 30
+#define PINGS 1000
+#define PINGS_WARMUP 100
+#define PING_TIMEOUT_US 100000
+
+static volatile unsigned long received = 0;
+
+static void count_handler(const z_sample_t *sample, void *arg) {
+    (void)(sample);
+    (void)(arg);
+    received++;
+}
+
+static void pong_handler(const z_sample_t *sample, void *arg) {
+    z_owned_publisher_t *pong = (z_owned_publisher_t *)arg;
+    z_publisher_put(z_loan(*pong), sample->payload.start, sample->payload.len, NULL);
+}
+
+static z_owned_session_t open_session(uint8_t key) {
+    z_owned_config_t config = z_config_default();
+    zp_config_insert(z_loan(config), Z_CONFIG_MODE_KEY, z_string_make("peer"));
+    zp_config_insert(z_loan(config), key, z_string_make(LOCATOR));
+    z_owned_session_t s = z_open(z_move(config));
+    if (!z_check(s)) {
+        printf("Unable to open session!\n");
+        exit(-1);
+    }
+    if (zp_start_read_task(z_loan(s), NULL) < 0 || zp_start_lease_task(z_loan(s), NULL) < 0) {
+        printf("Unable to start read and lease tasks\n");
+        exit(-1);
+    }
+    return s;
+}
+
+static z_owned_publisher_t declare_publisher(z_owned_session_t *s, const char *keyexpr) {
+    z_owned_publisher_t pub = z_declare_publisher(z_loan(*s), z_keyexpr(keyexpr), NULL);
+    if (!z_check(pub)) {
+        printf("Unable to declare publisher for key expression!\n");
+        exit(-1);
+    }
+    return pub;
+}
+
+static z_owned_subscriber_t declare_subscriber(z_owned_session_t *s, const char *keyexpr,
+                                               z_owned_closure_sample_t *cb) {
+    z_owned_subscriber_t sub = z_declare_subscriber(z_loan(*s), z_keyexpr(keyexpr), z_move(*cb), NULL);
+    if (!z_check(sub)) {
+        printf("Unable to declare subscriber for key expression!\n");
+        exit(-1);
+    }
+    return sub;
+}
+
+// Publishes until the messages flow from a session to the other, once the peers have discovered each other
+static void wait_discovery(z_owned_publisher_t *pub) {
+    zp_clock_t start = zp_clock_now();
+    unsigned long start_received = received;
+    while (received == start_received) {
+        if (zp_clock_elapsed_ms(&start) > (unsigned long)DISCOVERY_MS) {
+            printf("The sessions did not discover each other!\n");
+            exit(-1);
+        }
+        z_publisher_put(z_loan(*pub), (const uint8_t *)"ping", 4, NULL);
+        zp_sleep_ms(10);
+    }
+    // Let the messages in flight be received
+    zp_sleep_ms(100);
+}
+
+/**
+ * Publishes as fast as possible for WINDOWS windows of WINDOW_MS milliseconds, and reports the rate of the messages
+ * published and received in each of them. The received rate is lower once the receiver drops messages.
+ */
+void throughput_bench(z_bench_t *b, z_owned_session_t *s1, z_owned_session_t *s2) {
+    static z_bench_result_t sent_r;
+    static z_bench_result_t recv_r;
+    z_owned_closure_sample_t callback = z_closure(count_handler, NULL, NULL);
+    z_owned_subscriber_t sub = declare_subscriber(s2, "bench/thr", &callback);
+    z_owned_publisher_t pub = declare_publisher(s1, "bench/thr");
+    wait_discovery(&pub);
+
+    // The payloads fit in a datagram, fragmented messages are mostly lost at this rate
+    size_t sizes[] = {8, 64, 256, 1024};
+    uint8_t *value = (uint8_t *)zp_malloc(sizes[ARRAY_SIZE(sizes) - 1]);
+    (void)memset(value, 1, sizes[ARRAY_SIZE(sizes) - 1]);
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+        z_bench_result_init(&sent_r, "pub_throughput", "payload", sizes[i], "msg/s");
+        z_bench_result_init(&recv_r, "pub_sub_throughput", "payload", sizes[i], "msg/s");
+        for (size_t w = 0; w < WINDOWS; w++) {
+            unsigned long sent = 0;
+            unsigned long start_received = received;
+            zp_clock_t start = zp_clock_now();
+            unsigned long elapsed_us = 0;
+            while (elapsed_us < (unsigned long)WINDOW_MS * 1000) {
+                z_publisher_put(z_loan(pub), value, sizes[i], NULL);
+                sent++;
+                elapsed_us = zp_clock_elapsed_us(&start);
+            }
+            double secs = (double)elapsed_us / 1000000.0;
+            z_bench_result_add(&sent_r, (double)sent / secs);
+            z_bench_result_add(&recv_r, (double)(received - start_received) / secs);
+        }
+        z_bench_report(b, &sent_r);
+        z_bench_report(b, &recv_r);
+        // Let the receiver drain the messages of this size
+        zp_sleep_ms(WINDOW_MS);
+    }
+    zp_free(value);
+    z_undeclare_publisher(z_move(pub));
+    z_undeclare_subscriber(z_move(sub));
+}
+
+/**
+ * Sends a ping that the other session publishes back, and reports the round trip times. The answer is waited for by
+ * spinning, so that the wake up of a waiting thread is not measured, and is given up after PING_TIMEOUT_US.
+ */
+void latency_bench(z_bench_t *b, z_owned_session_t *s1, z_owned_session_t *s2) {
+    static z_bench_result_t r;
+    z_owned_publisher_t pong = declare_publisher(s2, "bench/pong");
+    z_owned_closure_sample_t pong_callback = z_closure(pong_handler, NULL, &pong);
+    z_owned_subscriber_t pong_sub = declare_subscriber(s2, "bench/ping", &pong_callback);
+    z_owned_closure_sample_t callback = z_closure(count_handler, NULL, NULL);
+    z_owned_subscriber_t sub = declare_subscriber(s1, "bench/pong", &callback);
+    z_owned_publisher_t ping = declare_publisher(s1, "bench/ping");
+    wait_discovery(&ping);
+
+    size_t sizes[] = {8, 1024};
+    uint8_t value[1024];
+    (void)memset(value, 1, sizeof(value));
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+        z_bench_result_init(&r, "ping_pong_rtt", "payload", sizes[i], "us");
+        for (size_t p = 0; p < (size_t)(PINGS_WARMUP + PINGS); p++) {
+            unsigned long expected = received + 1;
+            zp_clock_t start = zp_clock_now();
+            z_publisher_put(z_loan(ping), value, sizes[i], NULL);
+            while ((received < expected) && (zp_clock_elapsed_us(&start) < (unsigned long)PING_TIMEOUT_US)) {
+                // Spin
+            }
+            unsigned long elapsed_us = zp_clock_elapsed_us(&start);
+            if ((received >= expected) && (p >= (size_t)PINGS_WARMUP)) {
+                z_bench_result_add(&r, (double)elapsed_us);
+            }
+            // A late answer to a ping that was given up is not counted for the next one
+            received = expected;
+        }
+        z_bench_report(b, &r);
+    }
+    z_undeclare_publisher(z_move(ping));
+    z_undeclare_subscriber(z_move(sub));
+    z_undeclare_subscriber(z_move(pong_sub));
+    z_undeclare_publisher(z_move(pong));
+}
+
+int main(int argc, char **argv) {
+    z_bench_t b;
+    z_bench_begin(&b, "macro", argc, argv);
+    z_owned_session_t s1 = open_session(Z_CONFIG_LISTEN_KEY);
+    z_owned_session_t s2 = open_session(Z_CONFIG_CONNECT_KEY);
+
+    throughput_bench(&b, &s1, &s2);
+    latency_bench(&b, &s1, &s2);
+
+    zp_stop_read_task(z_loan(s1));
+    zp_stop_lease_task(z_loan(s1));
+    zp_stop_read_task(z_loan(s2));
+    zp_stop_lease_task(z_loan(s2));
+    z_close(z_move(s1));
+    z_close(z_move(s2));
+    z_bench_end(&b);
+    return 0;
+}
+
+#else
+int main(void) {
+    printf(
+        "ERROR: Zenoh pico was compiled without Z_FEATURE_SUBSCRIPTION or Z_FEATURE_PUBLICATION or "
+        "Z_FEATURE_MULTI_THREAD or Z_FEATURE_MULTICAST_TRANSPORT but this benchmark requires them.\n");
+    return -2;
+}
+#endif
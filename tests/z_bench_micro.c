@@ -0,0 +1,349 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "z_bench.h"
+#include "zenoh-pico/net/subscribe.h"
+#include "zenoh-pico/protocol/codec/core.h"
+#include "zenoh-pico/protocol/codec/network.h"
+#include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/session/utils.h"
+
+#define ARRAY_SIZE(array) (sizeof(array) / sizeof(array[0]))
+#define BATCH_US 2000  // The least duration of a sample, the number of operations per sample is calibrated on it
+#define SAMPLES 51
+
+// Keeps the results of the benchmarked operations from being optimized away
+static volatile size_t sink = 0;
+
+typedef void (*op_f)(void *arg, size_t i);
+
+static unsigned long run_batch(op_f op, void *arg, size_t ops) {
+    zp_clock_t start = zp_clock_now();
+    for (size_t i = 0; i < ops; i++) {
+        op(arg, i);
+    }
+    return zp_clock_elapsed_us(&start);
+}
+
+// Reports the time per operation of SAMPLES batches of operations, in nanoseconds
+static void bench(z_bench_t *b, const char *name, const char *param_name, size_t param, op_f op, void *arg) {
+    static z_bench_result_t r;
+    z_bench_result_init(&r, name, param_name, param, "ns/op");
+    while (run_batch(op, arg, r.ops) < (unsigned long)BATCH_US) {
+        r.ops = r.ops * 2;
+    }
+    for (size_t s = 0; s < SAMPLES; s++) {
+        unsigned long us = run_batch(op, arg, r.ops);
+        z_bench_result_add(&r, ((double)us * 1000.0) / (double)r.ops);
+    }
+    z_bench_report(b, &r);
+}
+
+/*------------------ Codec ------------------*/
+typedef struct {
+    _z_wbuf_t wbf;
+    _z_zbuf_t zbf;
+    _z_zint_t zint;
+    _z_network_message_t n_msg;
+} codec_ctx_t;
+
+static void op_zint_encode(void *arg, size_t i) {
+    (void)(i);
+    codec_ctx_t *c = (codec_ctx_t *)arg;
+    _z_wbuf_reset(&c->wbf);
+    sink += (size_t)_z_zint_encode(&c->wbf, c->zint);
+}
+
+static void op_zint_decode(void *arg, size_t i) {
+    (void)(i);
+    codec_ctx_t *c = (codec_ctx_t *)arg;
+    _z_zbuf_set_rpos(&c->zbf, 0);
+    _z_zint_t v = 0;
+    sink += (size_t)_z_zint_decode(&v, &c->zbf);
+    sink += (size_t)v;
+}
+
+static void op_n_msg_encode(void *arg, size_t i) {
+    (void)(i);
+    codec_ctx_t *c = (codec_ctx_t *)arg;
+    _z_wbuf_reset(&c->wbf);
+    sink += (size_t)_z_network_message_encode(&c->wbf, &c->n_msg);
+}
+
+static void op_n_msg_decode(void *arg, size_t i) {
+    (void)(i);
+    codec_ctx_t *c = (codec_ctx_t *)arg;
+    _z_zbuf_set_rpos(&c->zbf, 0);
+    _z_network_message_t n_msg;
+    sink += (size_t)_z_network_message_decode(&n_msg, &c->zbf);
+    _z_n_msg_clear(&n_msg);
+}
+
+void codec_bench(z_bench_t *b) {
+    codec_ctx_t c;
+    c.wbf = _z_wbuf_make(Z_BATCH_UNICAST_SIZE, false);
+
+    size_t bits[] = {7, 14, 32, 64};
+    for (size_t i = 0; i < ARRAY_SIZE(bits); i++) {
+        c.zint = (bits[i] >= (sizeof(_z_zint_t) * 8)) ? (_z_zint_t)SIZE_MAX : (((_z_zint_t)1 << bits[i]) - 1);
+        bench(b, "zint_encode", "bits", bits[i], op_zint_encode, &c);
+        c.zbf = _z_wbuf_to_zbuf(&c.wbf);
+        bench(b, "zint_decode", "bits", bits[i], op_zint_decode, &c);
+        _z_zbuf_clear(&c.zbf);
+    }
+
+    size_t sizes[] = {8, 1024, 16384};
+    uint8_t *payload = (uint8_t *)zp_malloc(sizes[ARRAY_SIZE(sizes) - 1]);
+    (void)memset(payload, 1, sizes[ARRAY_SIZE(sizes) - 1]);
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+        c.n_msg = (_z_network_message_t){
+            ._tag = _Z_N_PUSH,
+            ._body._push =
+                {
+                    ._key = _z_rname("bench/micro/codec"),
+                    ._qos = _Z_N_QOS_DEFAULT,
+                    ._timestamp = _z_timestamp_null(),
+                    ._body._is_put = true,
+                    ._body._body._put =
+                        {
+                            ._commons = {._timestamp = _z_timestamp_null(), ._source_info = _z_source_info_null()},
+                            ._payload = _z_bytes_wrap(payload, sizes[i]),
+                            ._encoding = z_encoding_default(),
+                        },
+                },
+        };
+        bench(b, "n_msg_encode", "payload", sizes[i], op_n_msg_encode, &c);
+        c.zbf = _z_wbuf_to_zbuf(&c.wbf);
+        bench(b, "n_msg_decode", "payload", sizes[i], op_n_msg_decode, &c);
+        _z_zbuf_clear(&c.zbf);
+    }
+    zp_free(payload);
+    _z_wbuf_clear(&c.wbf);
+}
+
+/*------------------ Key expressions ------------------*/
+// Pairs of canon key expressions, from exact matches to multi-chunk wildcards
+static const char *ke_pairs[][2] = {
+    {"demo/example/a", "demo/example/a"},  {"demo/example/a", "demo/example/b"}, {"demo/*/a", "demo/example/a"},
+    {"demo/**", "demo/example/a/b/c"},     {"demo/ex$*", "demo/example"},       {"demo/**/c", "demo/a/b/c"},
+    {"a/b/c/d/e/f/g", "a/b/c/d/e/f/h"},    {"**", "demo/example/a"},            {"demo/**/x/*", "demo/a/b/c"},
+    {"sensors/*/temp", "sensors/**/temp"},
+};
+
+// Key expressions to be canonized, some of them are already canon
+static const char *ke_canonize[] = {
+    "demo/**/**/a", "demo/*/**/b", "demo/**/*/c", "demo/example/a", "a/**/*/**/*/b", "sensors/**/**",
+};
+
+typedef struct {
+    size_t llen[ARRAY_SIZE(ke_pairs)];
+    size_t rlen[ARRAY_SIZE(ke_pairs)];
+    size_t clen[ARRAY_SIZE(ke_canonize)];
+    char buf[64];
+} ke_ctx_t;
+
+static void op_ke_intersects(void *arg, size_t i) {
+    ke_ctx_t *c = (ke_ctx_t *)arg;
+    size_t p = i % ARRAY_SIZE(ke_pairs);
+    sink += (size_t)_z_keyexpr_intersects(ke_pairs[p][0], c->llen[p], ke_pairs[p][1], c->rlen[p]);
+}
+
+static void op_ke_includes(void *arg, size_t i) {
+    ke_ctx_t *c = (ke_ctx_t *)arg;
+    size_t p = i % ARRAY_SIZE(ke_pairs);
+    sink += (size_t)_z_keyexpr_includes(ke_pairs[p][0], c->llen[p], ke_pairs[p][1], c->rlen[p]);
+}
+
+static void op_ke_canonize(void *arg, size_t i) {
+    ke_ctx_t *c = (ke_ctx_t *)arg;
+    size_t k = i % ARRAY_SIZE(ke_canonize);
+    size_t len = c->clen[k];
+    (void)memcpy(c->buf, ke_canonize[k], len + 1);  // Canonization may look at the terminating byte
+    sink += (size_t)_z_keyexpr_canonize(c->buf, &len);
+    sink += len;
+}
+
+void keyexpr_bench(z_bench_t *b) {
+    ke_ctx_t c;
+    for (size_t p = 0; p < ARRAY_SIZE(ke_pairs); p++) {
+        c.llen[p] = strlen(ke_pairs[p][0]);
+        c.rlen[p] = strlen(ke_pairs[p][1]);
+    }
+    for (size_t k = 0; k < ARRAY_SIZE(ke_canonize); k++) {
+        c.clen[k] = strlen(ke_canonize[k]);
+    }
+    bench(b, "keyexpr_intersects", NULL, 0, op_ke_intersects, &c);
+    bench(b, "keyexpr_includes", NULL, 0, op_ke_includes, &c);
+    bench(b, "keyexpr_canonize", NULL, 0, op_ke_canonize, &c);
+}
+
+/*------------------ Buffers ------------------*/
+typedef struct {
+    _z_wbuf_t wbf;
+    _z_zbuf_t zbf;
+    uint8_t *data;
+    size_t len;
+} iobuf_ctx_t;
+
+static void op_wbuf_write_bytes(void *arg, size_t i) {
+    (void)(i);
+    iobuf_ctx_t *c = (iobuf_ctx_t *)arg;
+    _z_wbuf_reset(&c->wbf);
+    sink += (size_t)_z_wbuf_write_bytes(&c->wbf, c->data, 0, c->len);
+}
+
+static void op_wbuf_write(void *arg, size_t i) {
+    iobuf_ctx_t *c = (iobuf_ctx_t *)arg;
+    _z_wbuf_reset(&c->wbf);
+    for (size_t j = 0; j < c->len; j++) {
+        sink += (size_t)_z_wbuf_write(&c->wbf, (uint8_t)i);
+    }
+}
+
+static void op_zbuf_read_bytes(void *arg, size_t i) {
+    (void)(i);
+    iobuf_ctx_t *c = (iobuf_ctx_t *)arg;
+    _z_zbuf_set_rpos(&c->zbf, 0);
+    _z_zbuf_read_bytes(&c->zbf, c->data, 0, c->len);
+    sink += c->data[0];
+}
+
+static void op_zbuf_read(void *arg, size_t i) {
+    (void)(i);
+    iobuf_ctx_t *c = (iobuf_ctx_t *)arg;
+    _z_zbuf_set_rpos(&c->zbf, 0);
+    for (size_t j = 0; j < c->len; j++) {
+        sink += _z_zbuf_read(&c->zbf);
+    }
+}
+
+void iobuf_bench(z_bench_t *b) {
+    size_t sizes[] = {8, 1024, 16384};
+    iobuf_ctx_t c;
+    c.data = (uint8_t *)zp_malloc(sizes[ARRAY_SIZE(sizes) - 1]);
+    (void)memset(c.data, 1, sizes[ARRAY_SIZE(sizes) - 1]);
+    c.wbf = _z_wbuf_make(sizes[ARRAY_SIZE(sizes) - 1], false);
+    c.zbf = _z_zbuf_make(sizes[ARRAY_SIZE(sizes) - 1]);
+    _z_zbuf_set_wpos(&c.zbf, sizes[ARRAY_SIZE(sizes) - 1]);
+    for (size_t i = 0; i < ARRAY_SIZE(sizes); i++) {
+        c.len = sizes[i];
+        bench(b, "wbuf_write_bytes", "len", c.len, op_wbuf_write_bytes, &c);
+        bench(b, "wbuf_write", "len", c.len, op_wbuf_write, &c);
+        bench(b, "zbuf_read_bytes", "len", c.len, op_zbuf_read_bytes, &c);
+        bench(b, "zbuf_read", "len", c.len, op_zbuf_read, &c);
+    }
+    _z_zbuf_clear(&c.zbf);
+    _z_wbuf_clear(&c.wbf);
+    zp_free(c.data);
+}
+
+/*------------------ Session lookups ------------------*/
+#define KEY_LEN 48
+#define STRIDE 7919  // A prime, so that the lookups visit all the entries in a scattered order
+
+typedef struct {
+    _z_session_t zn;
+    size_t n;
+    char (*keys)[KEY_LEN];
+} lookup_ctx_t;
+
+static void op_resource_by_id(void *arg, size_t i) {
+    lookup_ctx_t *c = (lookup_ctx_t *)arg;
+    _z_zint_t id = (_z_zint_t)((i * STRIDE) % c->n) + 1;
+    sink += (size_t)(_z_get_resource_by_id(&c->zn, _Z_KEYEXPR_MAPPING_LOCAL, id) != NULL);
+}
+
+static void op_resource_by_key(void *arg, size_t i) {
+    lookup_ctx_t *c = (lookup_ctx_t *)arg;
+    _z_keyexpr_t key = _z_rname(c->keys[(i * STRIDE) % c->n]);
+    sink += (size_t)(_z_get_resource_by_key(&c->zn, &key) != NULL);
+}
+
+#if Z_FEATURE_SUBSCRIPTION == 1
+static void op_subscriptions_by_key(void *arg, size_t i) {
+    lookup_ctx_t *c = (lookup_ctx_t *)arg;
+    _z_keyexpr_t key = _z_rname(c->keys[(i * STRIDE) % c->n]);
+    _z_subscription_sptr_list_t *subs = _z_get_subscriptions_by_key(&c->zn, _Z_RESOURCE_IS_LOCAL, &key);
+    sink += (size_t)(subs != NULL);
+    _z_subscription_sptr_list_free(&subs);
+}
+
+static void noop_handler(const _z_sample_t *sample, void *arg) {
+    (void)(sample);
+    (void)(arg);
+}
+#endif
+
+void lookup_bench(z_bench_t *b) {
+    size_t ns[] = {10, 100, 1000, 10000};
+    static lookup_ctx_t c;
+    c.keys = (char(*)[KEY_LEN])zp_malloc(ns[ARRAY_SIZE(ns) - 1] * KEY_LEN);
+    for (size_t k = 0; k < ARRAY_SIZE(ns); k++) {
+        // A session without transport, only its entity tables are used
+        (void)memset(&c.zn, 0, sizeof(c.zn));
+        _z_id_t zid = _z_id_empty();
+        if (_z_session_init(&c.zn, &zid) != _Z_RES_OK) {
+            printf("Unable to initialize the session\n");
+            exit(-1);
+        }
+        c.n = ns[k];
+        for (size_t i = 0; i < c.n; i++) {
+            (void)snprintf(c.keys[i], KEY_LEN, "bench/%zu/sensor/%zu", i % 16, i);
+            _z_register_resource(&c.zn, _z_rname(c.keys[i]), (uint16_t)(i + 1), _Z_KEYEXPR_MAPPING_LOCAL);
+#if Z_FEATURE_SUBSCRIPTION == 1
+            _z_subscription_t s;
+            s._id = (uint32_t)i;
+            s._key_id = Z_RESOURCE_ID_NONE;
+            s._key = _z_keyexpr_duplicate(_z_rname(c.keys[i]));
+            s._info = _z_subinfo_push_default();
+            s._callback = noop_handler;
+            s._dropper = NULL;
+            s._arg = NULL;
+            if (_z_register_subscription(&c.zn, _Z_RESOURCE_IS_LOCAL, &s) == NULL) {
+                _z_subscription_clear(&s);
+            }
+#endif
+        }
+
+        bench(b, "resource_by_id", "n", c.n, op_resource_by_id, &c);
+        bench(b, "resource_by_key", "n", c.n, op_resource_by_key, &c);
+#if Z_FEATURE_SUBSCRIPTION == 1
+        bench(b, "subscriptions_by_key", "n", c.n, op_subscriptions_by_key, &c);
+        _z_flush_subscriptions(&c.zn);
+#endif
+        // The session has no transport to be cleared
+        _z_flush_resources(&c.zn);
+#if Z_FEATURE_MULTI_THREAD == 1
+        zp_mutex_free(&c.zn._mutex_inner);
+#endif
+    }
+    zp_free(c.keys);
+}
+
+int main(int argc, char **argv) {
+    z_bench_t b;
+    z_bench_begin(&b, "micro", argc, argv);
+    codec_bench(&b);
+    keyexpr_bench(&b);
+    iobuf_bench(&b);
+    lookup_bench(&b);
+    z_bench_end(&b);
+    return 0;
+}
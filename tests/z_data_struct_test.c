@@ -15,41 +15,264 @@
 #include <stddef.h>
 #include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
 
+#include "zenoh-pico/collections/mpsc.h"
+#include "zenoh-pico/collections/ring.h"
 #include "zenoh-pico/collections/string.h"
 #include "zenoh-pico/protocol/core.h"
 #include "zenoh-pico/system/platform.h"
 #include "zenoh-pico/transport/transport.h"
+#include "zenoh-pico/utils/result.h"
 
 #undef NDEBUG
 #include <assert.h>
 
-void entry_list_test(void) {
-    _z_transport_peer_entry_list_t *root = _z_transport_peer_entry_list_new();
-    for (int i = 0; i < 10; i++) {
-        _z_transport_peer_entry_t *entry = (_z_transport_peer_entry_t *)zp_malloc(sizeof(_z_transport_peer_entry_t));
-        root = _z_transport_peer_entry_list_insert(root, entry);
+static _z_transport_peer_entry_t *peer_entry_new(uint8_t addr, _z_zint_t deadline) {
+    _z_transport_peer_entry_t *entry = (_z_transport_peer_entry_t *)zp_malloc(sizeof(_z_transport_peer_entry_t));
+    assert(entry != NULL);
+    memset(entry, 0, sizeof(_z_transport_peer_entry_t));
+    uint8_t bytes[4] = {0, 0, 0, addr};
+    entry->_remote_addr = _z_bytes_make(4);
+    memcpy((uint8_t *)entry->_remote_addr.start, bytes, 4);
+    entry->_lease_deadline = deadline;
+    return entry;
+}
+
+static _z_transport_peer_entry_t *peer_table_get(const _z_transport_peer_table_t *table, uint8_t addr) {
+    uint8_t bytes[4] = {0, 0, 0, addr};
+    _z_bytes_t remote_addr = _z_bytes_wrap(bytes, 4);
+    return _z_transport_peer_table_get(table, &remote_addr);
+}
+
+void peer_table_test(void) {
+    _z_transport_peer_table_t table;
+    _z_transport_peer_table_init(&table);
+    assert(peer_table_get(&table, 1) == NULL);
+    assert(_z_transport_peer_table_next_lease(&table) == NULL);
+
+    // Peers are found by address, and given increasing ids
+    for (uint8_t i = 1; i <= 100; i++) {
+        _z_zint_t deadline = (_z_zint_t)(((i * 37) % 101) + 1);
+        assert(_z_transport_peer_table_insert(&table, peer_entry_new(i, deadline)) == _Z_RES_OK);
+    }
+    assert(table._len == 100);
+    for (uint8_t i = 1; i <= 100; i++) {
+        assert(peer_table_get(&table, i)->_peer_id == i);
     }
-    _z_transport_peer_entry_list_t *list = root;
-    for (int i = 10; list != NULL; i--, list = _z_transport_peer_entry_list_tail(list)) {
-        assert(_z_transport_peer_entry_list_head(list)->_peer_id == i);
+    assert(peer_table_get(&table, 101) == NULL);
+
+    // The leases are visited in the order of their deadlines
+    _z_zint_t last = 0;
+    for (size_t i = 0; i < 50; i++) {
+        _z_transport_peer_entry_t *entry = _z_transport_peer_table_next_lease(&table);
+        assert(entry->_lease_deadline >= last);
+        last = entry->_lease_deadline;
+        if ((i % 2) == 0) {
+            _z_transport_peer_table_renew_lease(&table, entry, entry->_lease_deadline + 1000);
+        } else {
+            _z_transport_peer_table_remove(&table, entry);
+        }
+    }
+    assert(table._len == 75);
+    for (uint8_t i = 1; i <= 100; i++) {
+        _z_transport_peer_entry_t *entry = peer_table_get(&table, i);
+        if (entry != NULL) {
+            assert(table._by_lease[entry->_lease_idx] == entry);
+        }
+    }
+
+    // Ids are not reused before wrapping around
+    _z_transport_peer_entry_t *entry = peer_entry_new(200, 0);
+    assert(_z_transport_peer_table_insert(&table, entry) == _Z_RES_OK);
+    assert(entry->_peer_id == 101);
+    assert(_z_transport_peer_table_next_lease(&table) == entry);
+    table._next_peer_id = 1;
+    entry = peer_entry_new(201, 0);
+    assert(_z_transport_peer_table_insert(&table, entry) == _Z_RES_OK);
+    assert(peer_table_get(&table, (uint8_t)entry->_peer_id) == NULL);  // The id of a removed peer
+
+    _z_transport_peer_table_clear(&table);
+    assert(table._len == 0);
+}
+
+#define RING_VAL(i) ((void *)(uintptr_t)((i) + 1))
+
+void ring_test(void) {
+    _z_ring_t r;
+    assert(_z_ring_init(&r, 0) != 0);
+    assert(_z_ring_init(&r, 3) == 0);
+    assert(_z_ring_capacity(&r) == 3);
+    assert(_z_ring_is_empty(&r) == true);
+    assert(_z_ring_pull(&r) == NULL);
+
+    // Push until full, the rejected element is left to the caller
+    for (size_t i = 0; i < 3; i++) {
+        assert(_z_ring_push(&r, RING_VAL(i)) == NULL);
+    }
+    assert(_z_ring_is_full(&r) == true);
+    assert(_z_ring_push(&r, RING_VAL(3)) == RING_VAL(3));
+
+    // A forced push evicts the oldest element
+    assert(_z_ring_push_force(&r, RING_VAL(3)) == RING_VAL(0));
+    assert(_z_ring_len(&r) == 3);
+    for (size_t i = 1; i < 4; i++) {
+        assert(_z_ring_pull(&r) == RING_VAL(i));
+    }
+    assert(_z_ring_is_empty(&r) == true);
+
+    // Wrap around the slots many times
+    for (size_t i = 0; i < 100; i++) {
+        assert(_z_ring_push_force(&r, RING_VAL(i)) == NULL);
+        assert(_z_ring_pull(&r) == RING_VAL(i));
+    }
+
+    assert(_z_ring_push(&r, RING_VAL(0)) == NULL);
+    _z_ring_clear(&r, _z_noop_free);
+    assert(_z_ring_capacity(&r) == 0);
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+#define RING_SPSC_COUNT 100000
+
+static void *ring_spsc_producer(void *arg) {
+    _z_ring_t *r = (_z_ring_t *)arg;
+    for (size_t i = 0; i < RING_SPSC_COUNT; i++) {
+        (void)_z_ring_push_force(r, RING_VAL(i));
+    }
+    return NULL;
+}
+
+void ring_spsc_test(void) {
+    _z_ring_t r;
+    assert(_z_ring_init(&r, 8) == 0);
+
+    zp_task_t task;
+    assert(zp_task_init(&task, NULL, ring_spsc_producer, &r) == 0);
+
+    // The elements may be evicted, but the ones received keep their order
+    uintptr_t last = 0;
+    while (last != (uintptr_t)RING_SPSC_COUNT) {
+        void *e = _z_ring_pull(&r);
+        if (e != NULL) {
+            assert((uintptr_t)e > last);
+            last = (uintptr_t)e;
+        }
+    }
+    assert(zp_task_join(&task) == 0);
+    assert(_z_ring_is_empty(&r) == true);
+    _z_ring_clear(&r, _z_noop_free);
+}
+#endif
+
+void mpsc_test(void) {
+    _z_mpsc_t q;
+    assert(_z_mpsc_init(&q, 0) != 0);
+    assert(_z_mpsc_init(&q, 3) == 0);
+    assert(_z_mpsc_capacity(&q) == 4);  // Rounded up to a power of two
+    assert(_z_mpsc_is_empty(&q) == true);
+    assert(_z_mpsc_pull(&q) == NULL);
+
+    // Wrap around the slots a few times
+    for (size_t round = 0; round < 3; round++) {
+        for (size_t i = 0; i < 4; i++) {
+            assert(_z_mpsc_push(&q, RING_VAL(i)) == NULL);
+        }
+        assert(_z_mpsc_len(&q) == 4);
+        assert(_z_mpsc_push(&q, RING_VAL(4)) == RING_VAL(4));
+        for (size_t i = 0; i < 4; i++) {
+            assert(_z_mpsc_pull(&q) == RING_VAL(i));
+        }
+        assert(_z_mpsc_is_empty(&q) == true);
+        assert(_z_mpsc_pull(&q) == NULL);
+    }
+
+    // A reserved slot is not empty, but can only be pulled once its element is published
+    assert(_z_mpsc_can_pull(&q) == false);
+    _z_atomic_fetch_add_explicit(&q._w_idx, (size_t)1, _z_memory_order_relaxed);
+    assert((_z_mpsc_is_empty(&q) == false) && (_z_mpsc_can_pull(&q) == false));
+    _z_mpsc_slot_t *s = &q._slots[_z_atomic_load_explicit(&q._r_idx, _z_memory_order_relaxed) & q._mask];
+    s->_val = RING_VAL(0);
+    _z_atomic_fetch_add_explicit(&s->_seq, (size_t)1, _z_memory_order_release);
+    assert(_z_mpsc_can_pull(&q) == true);
+    assert(_z_mpsc_pull(&q) == RING_VAL(0));
+
+    assert(_z_mpsc_push(&q, RING_VAL(0)) == NULL);
+    assert(_z_mpsc_can_pull(&q) == true);
+    _z_mpsc_clear(&q, _z_noop_free);
+    assert(_z_mpsc_capacity(&q) == 0);
+
+    // At least two slots are needed
+    assert(_z_mpsc_init(&q, 1) == 0);
+    assert(_z_mpsc_capacity(&q) == 2);
+    _z_mpsc_clear(&q, _z_noop_free);
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+#define MPSC_PRODUCERS 4
+#define MPSC_COUNT 50000
+
+typedef struct {
+    _z_mpsc_t *q;
+    uintptr_t id;
+} mpsc_producer_arg_t;
+
+static void *mpsc_producer(void *arg) {
+    mpsc_producer_arg_t *p = (mpsc_producer_arg_t *)arg;
+    for (uintptr_t i = 0; i < (uintptr_t)MPSC_COUNT; i++) {
+        // Encode the producer in the low bits, the sequence number in the high bits
+        void *e = (void *)(((i + 1) * MPSC_PRODUCERS) + p->id);
+        while (_z_mpsc_push(p->q, e) != NULL) {
+            zp_sleep_us(1);
+        }
+    }
+    return NULL;
+}
+
+void mpsc_concurrent_test(void) {
+    _z_mpsc_t q;
+    assert(_z_mpsc_init(&q, 16) == 0);
+
+    zp_task_t tasks[MPSC_PRODUCERS];
+    mpsc_producer_arg_t args[MPSC_PRODUCERS];
+    for (uintptr_t i = 0; i < (uintptr_t)MPSC_PRODUCERS; i++) {
+        args[i].q = &q;
+        args[i].id = i;
+        assert(zp_task_init(&tasks[i], NULL, mpsc_producer, &args[i]) == 0);
     }
-    _z_transport_peer_entry_list_head(root)->_peer_id = _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE - 1;
 
-    for (int i = 0; i < 11; i++) {
-        _z_transport_peer_entry_t *entry = (_z_transport_peer_entry_t *)zp_malloc(sizeof(_z_transport_peer_entry_t));
-        root = _z_transport_peer_entry_list_insert(root, entry);
+    // Nothing is lost, and the elements of each producer keep their order
+    uintptr_t last[MPSC_PRODUCERS] = {0};
+    size_t n = 0;
+    while (n < (size_t)(MPSC_PRODUCERS * MPSC_COUNT)) {
+        void *e = _z_mpsc_pull(&q);
+        if (e != NULL) {
+            uintptr_t id = (uintptr_t)e % MPSC_PRODUCERS;
+            uintptr_t seq = (uintptr_t)e / MPSC_PRODUCERS;
+            assert(seq == last[id] + 1);
+            last[id] = seq;
+            n++;
+        }
     }
-    assert(_z_transport_peer_entry_list_head(root)->_peer_id == _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE - 1);
-    list = _z_transport_peer_entry_list_tail(root);
-    for (int i = 20; list != NULL; i--, list = _z_transport_peer_entry_list_tail(list)) {
-        assert(_z_transport_peer_entry_list_head(list)->_peer_id == i);
+    for (size_t i = 0; i < (size_t)MPSC_PRODUCERS; i++) {
+        assert(zp_task_join(&tasks[i]) == 0);
+        assert(last[i] == (uintptr_t)MPSC_COUNT);
     }
-    _z_transport_peer_entry_list_free(&root);
+    assert(_z_mpsc_is_empty(&q) == true);
+    _z_mpsc_clear(&q, _z_noop_free);
 }
+#endif
 
 int main(void) {
-    entry_list_test();
+    peer_table_test();
+    ring_test();
+#if Z_FEATURE_MULTI_THREAD == 1
+    ring_spsc_test();
+#endif
+    mpsc_test();
+#if Z_FEATURE_MULTI_THREAD == 1
+    mpsc_concurrent_test();
+#endif
     char *s = (char *)malloc(64);
     size_t len = 128;
 
@@ -0,0 +1,206 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/net/session.h"
+#include "zenoh-pico/protocol/codec/transport.h"
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/multicast/lease.h"
+#include "zenoh-pico/transport/multicast/rx.h"
+#include "zenoh-pico/transport/multicast/transport.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_MULTICAST_TRANSPORT == 1
+
+#define MTU 512
+#define DATAGRAMS 16
+#define RESOURCES 40
+
+// The link records the datagrams written on it, and whether the peers were locked while writing them
+static uint8_t datagrams[DATAGRAMS][MTU];
+static size_t lens[DATAGRAMS];
+static size_t tail = 0;
+static size_t locked_writes = 0;
+static _z_transport_multicast_t *link_ztm = NULL;
+
+static size_t write(const _z_link_t *self, const uint8_t *ptr, size_t len) {
+    (void)(self);
+    assert((len <= (size_t)MTU) && (tail < (size_t)DATAGRAMS));
+    (void)memcpy(datagrams[tail], ptr, len);
+    lens[tail] = len;
+    tail++;
+#if Z_FEATURE_MULTI_THREAD == 1
+    if (zp_mutex_trylock(&link_ztm->_mutex_peer) == 0) {
+        zp_mutex_unlock(&link_ztm->_mutex_peer);
+    } else {
+        locked_writes++;
+    }
+#endif
+    return len;
+}
+
+static void close_link(_z_link_t *self) { (void)(self); }
+static void free_link(_z_link_t *self) { (void)(self); }
+
+static void make_session(_z_session_t *zn) {
+    _z_link_t zl;
+    (void)memset(&zl, 0, sizeof(zl));
+    zl._write_f = write;
+    zl._close_f = close_link;
+    zl._free_f = free_link;
+    zl._mtu = MTU;
+    zl._cap._transport = Z_LINK_CAP_TRANSPORT_MULTICAST;
+    zl._cap._flow = Z_LINK_CAP_FLOW_DATAGRAM;
+
+    _z_transport_multicast_establish_param_t param;
+    (void)memset(&param, 0, sizeof(param));
+    param._seq_num_res = Z_SN_RESOLUTION;
+
+    (void)memset(zn, 0, sizeof(_z_session_t));
+    assert(_z_multicast_transport_create(&zn->_tp, &zl, &param) == _Z_RES_OK);
+    _z_id_t zid = _z_id_empty();
+    assert(_z_session_init(zn, &zid) == _Z_RES_OK);
+    link_ztm = &zn->_tp._transport._multicast;
+    tail = 0;
+    locked_writes = 0;
+}
+
+// Count the declarations in the recorded frames, from the given datagram
+static size_t count_declarations(size_t from) {
+    size_t ret = 0;
+    for (size_t i = from; i < tail; i++) {
+        _z_wbuf_t wbf = _z_wbuf_make(lens[i], false);
+        assert(_z_wbuf_write_bytes(&wbf, datagrams[i], 0, lens[i]) == _Z_RES_OK);
+        _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+        _z_transport_message_t t_msg;
+        assert(_z_transport_message_decode(&t_msg, &zbf) == _Z_RES_OK);
+        assert(_Z_MID(t_msg._header) == _Z_MID_T_FRAME);
+        _z_network_message_vec_t *msgs = &t_msg._body._frame._messages;
+        for (size_t j = 0; j < _z_network_message_vec_len(msgs); j++) {
+            _z_network_message_t *n_msg = _z_network_message_vec_get(msgs, j);
+            assert((n_msg->_tag == _Z_N_DECLARE) && (n_msg->_body._declare._decl._tag == _Z_DECL_KEXPR));
+            ret++;
+        }
+        _z_t_msg_clear(&t_msg);
+        _z_zbuf_clear(&zbf);
+        _z_wbuf_clear(&wbf);
+    }
+    return ret;
+}
+
+// Whether the wire key of the resource is its id, and not its full key expression
+static _Bool uses_id(_z_session_t *zn, uint16_t id) {
+    _z_keyexpr_t key = _z_rid_with_suffix(id, NULL);
+    _z_keyexpr_set_mapping(&key, _Z_KEYEXPR_MAPPING_LOCAL);
+    _z_keyexpr_t wire = _z_get_wire_key_from_key(zn, &key);
+    _Bool ret = (wire._id == id) && (wire._suffix == NULL);
+    _z_keyexpr_clear(&wire);
+    return ret;
+}
+
+// The full key expression is sent until the declaration has been repeated since the last peer joined
+void wire_key_test(void) {
+    _z_session_t zn;
+    make_session(&zn);
+    uint16_t id = (uint16_t)_z_register_resource(&zn, _z_rname("test/a"), 0, _Z_KEYEXPR_MAPPING_LOCAL);
+    assert(id != Z_RESOURCE_ID_NONE);
+
+    _z_keyexpr_t key = _z_rid_with_suffix(id, "/b");
+    _z_keyexpr_set_mapping(&key, _Z_KEYEXPR_MAPPING_LOCAL);
+    _z_keyexpr_t wire = _z_get_wire_key_from_key(&zn, &key);
+    assert((wire._id == Z_RESOURCE_ID_NONE) && (strcmp(wire._suffix, "test/a/b") == 0));
+    _z_keyexpr_clear(&wire);
+    assert(uses_id(&zn, id) == false);
+
+    assert(_zp_multicast_send_join(link_ztm) == _Z_RES_OK);
+    assert((tail == 2) && (count_declarations(1) == 1));
+    assert(uses_id(&zn, id) == true);
+    wire = _z_get_wire_key_from_key(&zn, &key);
+    assert((wire._id == id) && (wire._suffix == key._suffix));
+    _z_keyexpr_clear(&wire);
+
+    // A new peer does not know the id yet
+    _z_reset_resource_declarations(&zn);
+    assert(uses_id(&zn, id) == false);
+
+    // Keys without id and remote resources are left untouched
+    _z_keyexpr_t name = _z_rname("test/c");
+    wire = _z_get_wire_key_from_key(&zn, &name);
+    assert((wire._id == Z_RESOURCE_ID_NONE) && (wire._suffix == name._suffix));
+    _z_keyexpr_clear(&wire);
+
+    _z_session_clear(&zn);
+}
+
+// The declarations are packed in as few frames as possible
+void batch_test(void) {
+    _z_session_t zn;
+    make_session(&zn);
+    for (size_t i = 0; i < (size_t)RESOURCES; i++) {
+        char name[32];
+        (void)snprintf(name, sizeof(name), "test/declarations/%u", (unsigned int)i);
+        assert(_z_register_resource(&zn, _z_rname(name), 0, _Z_KEYEXPR_MAPPING_LOCAL) != Z_RESOURCE_ID_NONE);
+    }
+
+    assert(_zp_multicast_send_join(link_ztm) == _Z_RES_OK);
+    assert((tail > (size_t)2) && (tail < (size_t)(RESOURCES / 4)));
+    assert(count_declarations(1) == (size_t)RESOURCES);
+
+    _z_session_clear(&zn);
+}
+
+// A new peer is answered with the declarations once the peers are released
+void join_test(void) {
+    _z_session_t zn;
+    make_session(&zn);
+    uint16_t id = (uint16_t)_z_register_resource(&zn, _z_rname("test/a"), 0, _Z_KEYEXPR_MAPPING_LOCAL);
+    assert(_zp_multicast_send_join(link_ztm) == _Z_RES_OK);
+    assert(uses_id(&zn, id) == true);
+    tail = 0;
+
+    _z_id_t zid = _z_id_empty();
+    zid.id[0] = 1;
+    _z_conduit_sn_list_t next_sn;
+    (void)memset(&next_sn, 0, sizeof(next_sn));
+    _z_transport_message_t t_msg = _z_t_msg_make_join(Z_WHATAMI_PEER, Z_TRANSPORT_LEASE, zid, next_sn);
+    uint8_t addr_bytes[4] = {1, 2, 3, 4};
+    _z_bytes_t addr = _z_bytes_wrap(addr_bytes, sizeof(addr_bytes));
+    assert(_z_multicast_handle_transport_message(link_ztm, &t_msg, &addr) == _Z_RES_OK);
+    assert((tail == 2) && (count_declarations(1) == 1) && (locked_writes == 0));
+    assert(uses_id(&zn, id) == true);
+
+    // A known peer is not answered
+    assert(_z_multicast_handle_transport_message(link_ztm, &t_msg, &addr) == _Z_RES_OK);
+    assert(tail == 2);
+
+    _z_session_clear(&zn);
+}
+
+int main(void) {
+    wire_key_test();
+    batch_test();
+    join_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif
@@ -19,6 +19,8 @@
 #include <string.h>
 
 #include "zenoh-pico/protocol/iobuf.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/utils/result.h"
 
 #undef NDEBUG
 #include <assert.h>
@@ -554,6 +556,96 @@ void wbuf_add_iosli(void) {
     _z_wbuf_clear(&wbf);
 }
 
+void wbuf_siphon_ref(void) {
+    uint8_t payload[255];
+    for (size_t i = 0; i < sizeof(payload); i++) {
+        payload[i] = (uint8_t)i;
+    }
+    printf("\n>>> WBuf => Siphon by reference\n");
+
+    _z_wbuf_t dst = _z_wbuf_make(16, false);
+    for (int m = 0; m < 2; m++) {
+        _z_wbuf_t src = _z_wbuf_make(16, true);
+        _z_wbuf_write(&src, 0xAA);
+        _z_wbuf_wrap_bytes(&src, payload, 0, sizeof(payload));
+        _z_wbuf_write(&src, 0xBB);
+
+        size_t len = _z_wbuf_len(&src);
+        _z_wbuf_write(&dst, 0xCC);
+        assert(_z_wbuf_siphon_ref(&dst, &src, len) == _Z_RES_OK);
+        assert(_z_wbuf_len(&src) == 0);
+        assert(_z_wbuf_len(&dst) == len + 1);
+
+        // The payload is referenced, not copied
+        _Bool found = false;
+        for (size_t i = 1; i < _z_wbuf_len_iosli(&dst); i++) {
+            _z_iosli_t *ios = _z_wbuf_get_iosli(&dst, i);
+            assert(ios->_is_alloc == false);
+            found = found || (ios->_buf == payload);
+        }
+        assert(found == true);
+
+        _z_zbuf_t zbf = _z_wbuf_to_zbuf(&dst);
+        assert(_z_zbuf_read(&zbf) == 0xCC);
+        assert(_z_zbuf_read(&zbf) == 0xAA);
+        for (size_t i = 0; i < sizeof(payload); i++) {
+            assert(_z_zbuf_read(&zbf) == payload[i]);
+        }
+        assert(_z_zbuf_read(&zbf) == 0xBB);
+        _z_zbuf_clear(&zbf);
+
+        // Resetting drops the borrowing slices
+        _z_wbuf_reset(&dst);
+        assert(_z_wbuf_len_iosli(&dst) == 1);
+        _z_wbuf_clear(&src);
+    }
+
+    _z_wbuf_clear(&dst);
+}
+
+void dbuf_reassemble(_Bool is_expandable) {
+    size_t max = 1 + gen_size_t() % 4096;
+    _z_dbuf_t dbf = _z_dbuf_make(is_expandable ? 0 : max, max, is_expandable);
+    printf("\n>>> DBuf => Reassemble, expandable: %d, max: %zu\n", is_expandable, max);
+
+    uint8_t *frag = (uint8_t *)zp_malloc(max);
+    for (int m = 0; m < 3; m++) {
+        // Write fragments up to the maximum size
+        uint8_t counter = 0;
+        size_t written = 0;
+        while (written < max) {
+            size_t remaining = max - written;
+            size_t to_write = 1 + gen_size_t() % (remaining < 512 ? remaining : 512);
+            for (size_t i = 0; i < to_write; i++) {
+                frag[i] = counter++;
+            }
+            assert(_z_dbuf_write_bytes(&dbf, frag, to_write) == _Z_RES_OK);
+            written = written + to_write;
+        }
+        assert(_z_dbuf_len(&dbf) == max);
+        assert(_z_dbuf_is_overflow(&dbf) == false);
+
+        // The message is read in place
+        _z_zbuf_t zbf = _z_dbuf_as_zbuf(&dbf);
+        assert(_z_zbuf_start(&zbf) == dbf._ios._buf);
+        for (size_t i = 0; i < max; i++) {
+            assert(_z_zbuf_read(&zbf) == (uint8_t)i);
+        }
+
+        // Exceeding the maximum size discards the rest of the message
+        assert(_z_dbuf_write_bytes(&dbf, frag, 1) == _Z_ERR_TRANSPORT_NO_SPACE);
+        assert(_z_dbuf_is_overflow(&dbf) == true);
+        _z_dbuf_reset(&dbf);
+        assert(_z_dbuf_len(&dbf) == 0);
+        assert(_z_dbuf_is_overflow(&dbf) == false);
+        // The capacity is kept across messages
+        assert(_z_dbuf_capacity(&dbf) == max);
+    }
+
+    zp_free(frag);
+    _z_dbuf_clear(&dbf);
+}
+
 /*=============================*/
 /*            Main             */
 /*=============================*/
@@ -570,6 +662,7 @@ int main(void) {
         wbuf_writable_readable();
         wbuf_set_pos_wbuf_get_pos();
         wbuf_add_iosli();
+        wbuf_siphon_ref();
         // WBuf and ZBuf
         wbuf_write_zbuf_read();
         wbuf_write_zbuf_read_bytes();
@@ -577,5 +670,9 @@ int main(void) {
 
         // Reusable WBuf
         wbuf_reusable_write_zbuf_read();
+
+        // DBuf
+        dbuf_reassemble(true);
+        dbuf_reassemble(false);
     }
 }
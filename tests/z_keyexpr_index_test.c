@@ -0,0 +1,132 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/session/keyexpr_index.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+static _Bool count_visit(void *val, void *arg) {
+    (void)(val);
+    size_t *cnt = (size_t *)arg;
+    *cnt = *cnt + 1;
+    return true;
+}
+
+static _Bool first_visit(void *val, void *arg) {
+    *(void **)arg = val;
+    return false;
+}
+
+static size_t count(_z_keyexpr_index_t *idx, const char *key) {
+    size_t cnt = 0;
+    size_t n = _z_keyexpr_index_match(idx, key, strlen(key), count_visit, &cnt);
+    assert(n == cnt);
+    return cnt;
+}
+
+void exact_match_test(void) {
+    _z_keyexpr_index_t idx;
+    _z_keyexpr_index_init(&idx);
+    int a = 0, b = 0, c = 0;
+
+    assert(_z_keyexpr_index_insert(&idx, "demo/a", &a) == 0);
+    assert(_z_keyexpr_index_insert(&idx, "demo/b", &b) == 0);
+    assert(_z_keyexpr_index_insert(&idx, "demo/a", &c) == 0);
+
+    assert(count(&idx, "demo/a") == 2);
+    assert(count(&idx, "demo/b") == 1);
+    assert(count(&idx, "demo/c") == 0);
+    assert(count(&idx, "demo") == 0);
+
+    void *first = NULL;
+    assert(_z_keyexpr_index_match(&idx, "demo/b", strlen("demo/b"), first_visit, &first) == 1);
+    assert(first == &b);
+
+    _z_keyexpr_index_remove(&idx, "demo/a", &a);
+    assert(count(&idx, "demo/a") == 1);
+    _z_keyexpr_index_remove(&idx, "demo/a", &a);  // Removing twice is a no-op
+    assert(count(&idx, "demo/a") == 1);
+
+    _z_keyexpr_index_clear(&idx);
+    assert(count(&idx, "demo/b") == 0);
+}
+
+void wild_match_test(void) {
+    _z_keyexpr_index_t idx;
+    _z_keyexpr_index_init(&idx);
+    int a = 0, b = 0, c = 0, d = 0;
+
+    assert(_z_keyexpr_index_insert(&idx, "demo/*", &a) == 0);
+    assert(_z_keyexpr_index_insert(&idx, "demo/**", &b) == 0);
+    assert(_z_keyexpr_index_insert(&idx, "demo/ab$*", &c) == 0);
+    assert(_z_keyexpr_index_insert(&idx, "demo/abc", &d) == 0);
+
+    assert(count(&idx, "demo/abc") == 4);
+    assert(count(&idx, "demo/xyz") == 2);
+    assert(count(&idx, "demo/x/y") == 1);
+    assert(count(&idx, "demo") == 1);
+    assert(count(&idx, "other/abc") == 0);
+
+    // Wild keys are matched against both wild and non-wild entries
+    assert(count(&idx, "demo/a$*") == 4);
+    assert(count(&idx, "**") == 4);
+    assert(count(&idx, "*/abc") == 4);
+
+    _z_keyexpr_index_remove(&idx, "demo/**", &b);
+    assert(count(&idx, "demo/x/y") == 0);
+    assert(count(&idx, "demo/abc") == 3);
+
+    _z_keyexpr_index_clear(&idx);
+}
+
+void rehash_test(void) {
+    _z_keyexpr_index_t idx;
+    _z_keyexpr_index_init(&idx);
+
+    char keys[256][16];
+    for (size_t i = 0; i < 256; i++) {
+        snprintf(keys[i], sizeof(keys[i]), "demo/%zu", i);
+        assert(_z_keyexpr_index_insert(&idx, keys[i], keys[i]) == 0);
+    }
+    assert(idx._len == 256);
+    assert(idx._capacity >= 256);
+
+    for (size_t i = 0; i < 256; i++) {
+        void *first = NULL;
+        assert(_z_keyexpr_index_match(&idx, keys[i], strlen(keys[i]), first_visit, &first) == 1);
+        assert(first == keys[i]);
+    }
+    assert(count(&idx, "demo/*") == 256);
+
+    for (size_t i = 0; i < 256; i += 2) {
+        _z_keyexpr_index_remove(&idx, keys[i], keys[i]);
+    }
+    assert(idx._len == 128);
+    assert(count(&idx, "demo/*") == 128);
+    assert(count(&idx, "demo/2") == 0);
+    assert(count(&idx, "demo/3") == 1);
+
+    _z_keyexpr_index_clear(&idx);
+}
+
+int main(void) {
+    exact_match_test();
+    wild_match_test();
+    rehash_test();
+    return 0;
+}
@@ -16,6 +16,7 @@
 
 #include "zenoh-pico/api/primitives.h"
 #include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/utils/string.h"
 
 #undef NDEBUG
 #include <assert.h>
@@ -239,9 +240,46 @@ int main(void) {
     assert(zp_keyexpr_includes_null_terminated("a/**/b$*", "a/ebc") == -1);
     assert(zp_keyexpr_includes_null_terminated("a/**/$*b", "a/cbc") == -1);
 
+    // Long key expressions are scanned by blocks of several characters
+    const char *long_ke = "fleet/robot-0123/sensors/lidar/front/points";
+    assert(zp_keyexpr_intersect_null_terminated("fleet/*/sensors/**", long_ke) == 0);
+    assert(zp_keyexpr_intersect_null_terminated("**/**", long_ke) == 0);
+    assert(zp_keyexpr_intersect_null_terminated("fleet/robot-0123/sensors/lidar/front/**/points", long_ke) == 0);
+    assert(zp_keyexpr_intersect_null_terminated("fleet/robot-0123/sensors/lidar/back/**", long_ke) == -1);
+    assert(zp_keyexpr_intersect_null_terminated("fleet/robot-0123/sensors/lidar/front/$*ts", long_ke) == 0);
+    assert(zp_keyexpr_includes_null_terminated("fleet/*/sensors/lidar/*/points", long_ke) == 0);
+    assert(zp_keyexpr_includes_null_terminated("fleet/robot-0123/sensors/lidar/front/pointz", long_ke) == -1);
+    assert(zp_keyexpr_includes_null_terminated(long_ke, "fleet/*/sensors/lidar/front/points") == -1);
+
+    // The delimiters and wildcards at every position of the blocks
+    for (size_t pad = 1; pad < (size_t)70; pad++) {
+        char l[128];
+        char r[128];
+        memset(l, 'x', pad);
+        memset(r, 'x', pad);
+        strcpy(&l[pad], "/**/y");
+        strcpy(&r[pad], "/a/b/y");
+        _z_str_se_t rs = {.start = r, .end = &r[strlen(r)]};
+        assert(_z_bstrchr(rs, '/') == &r[pad]);
+        assert(_z_rbstrchr(rs, '/') == &r[pad + 4]);
+        assert(_z_bstrchr(rs, '*') == NULL);
+        assert(_z_rbstrchr(rs, '*') == NULL);
+        assert(zp_keyexpr_intersect_null_terminated(l, r) == 0);
+        assert(zp_keyexpr_includes_null_terminated(l, r) == 0);
+        assert(zp_keyexpr_includes_null_terminated(r, l) == -1);
+        r[pad + 5] = 'z';
+        assert(zp_keyexpr_intersect_null_terminated(l, r) == -1);
+        strcpy(&l[pad - 1], "$*");
+        assert(zp_keyexpr_includes_null_terminated(l, r) == -1);
+        r[pad] = '\0';
+        assert(zp_keyexpr_includes_null_terminated(l, r) == 0);
+        r[pad - 1] = '#';
+        assert(zp_keyexpr_is_canon_null_terminated(r) == Z_KEYEXPR_CANON_CONTAINS_SHARP_OR_QMARK);
+    }
+
     // clang-format off
 
-#define N 31
+#define N 35
     const char *input[N] = {"greetings/hello/there",
                             "greetings/good/*/morning",
                             "greetings/*",
@@ -272,7 +310,11 @@ int main(void) {
                             "greetings/**/*/e?",
                             "greetings/**/*/e#",
                             "greetings/**/*/e$",
-                            "greetings/**/*/$e"};
+                            "greetings/**/*/$e",
+                            "$*/a/*",
+                            "**/**/a/*",
+                            "fleet/robot-0123/**/**/sensors/lidar/front/points",
+                            "fleet/robot-0123/**/sensors/lidar/front/poi#nts"};
     const zp_keyexpr_canon_status_t expected[N] = {Z_KEYEXPR_CANON_SUCCESS,
                                                    Z_KEYEXPR_CANON_SUCCESS,
                                                    Z_KEYEXPR_CANON_SUCCESS,
@@ -303,7 +345,11 @@ int main(void) {
                                                    Z_KEYEXPR_CANON_CONTAINS_SHARP_OR_QMARK,
                                                    Z_KEYEXPR_CANON_CONTAINS_SHARP_OR_QMARK,
                                                    Z_KEYEXPR_CANON_CONTAINS_UNBOUND_DOLLAR,
-                                                   Z_KEYEXPR_CANON_CONTAINS_UNBOUND_DOLLAR};
+                                                   Z_KEYEXPR_CANON_CONTAINS_UNBOUND_DOLLAR,
+                                                   Z_KEYEXPR_CANON_SUCCESS,
+                                                   Z_KEYEXPR_CANON_SUCCESS,
+                                                   Z_KEYEXPR_CANON_SUCCESS,
+                                                   Z_KEYEXPR_CANON_CONTAINS_SHARP_OR_QMARK};
     const char *canonized[N] = {"greetings/hello/there",
                                 "greetings/good/*/morning",
                                 "greetings/*",
@@ -334,7 +380,11 @@ int main(void) {
                                 "greetings/**/*/e?",
                                 "greetings/**/*/e#",
                                 "greetings/**/*/e$",
-                                "greetings/**/*/$e"};
+                                "greetings/**/*/$e",
+                                "*/a/*",
+                                "**/a/*",
+                                "fleet/robot-0123/**/sensors/lidar/front/points",
+                                "fleet/robot-0123/**/sensors/lidar/front/poi#nts"};
 
     // clang-format on
 
@@ -0,0 +1,168 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/matching.h"
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/system/platform.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_MATCHING == 1
+
+static size_t calls = 0;
+static _Bool last_status = false;
+static size_t drops = 0;
+
+static void matching_handler(const _z_matching_status_t *status, void *arg) {
+    (void)(arg);
+    last_status = status->matching;
+    calls++;
+}
+
+static void drop_handler(void *arg) {
+    (void)(arg);
+    drops++;
+}
+
+static void session_init(_z_session_t *zn) {
+    (void)memset(zn, 0, sizeof(_z_session_t));
+    zn->_entity_id = 1;
+    _z_resource_table_init(&zn->_local_resources);
+    _z_resource_table_init(&zn->_remote_resources);
+    zn->_remote_subscriptions = NULL;
+    _z_keyexpr_index_init(&zn->_remote_subscriptions_index);
+    zn->_matching_listeners = NULL;
+    zn->_matching_gen = 1;
+#if Z_FEATURE_MULTI_THREAD == 1
+    assert(zp_mutex_init(&zn->_mutex_inner) == 0);
+#endif
+}
+
+static void session_clear(_z_session_t *zn) {
+    _z_flush_resources(zn);
+    _z_flush_matching(zn);
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_free(&zn->_mutex_inner);
+#endif
+}
+
+static _z_matching_sptr_t *listen(_z_session_t *zn, const char *key) {
+    _z_matching_t m;
+    (void)memset(&m, 0, sizeof(m));
+    m._id = _z_get_entity_id(zn);
+    m._key = _z_keyexpr_duplicate(_z_rname(key));
+    m._callback = matching_handler;
+    m._dropper = drop_handler;
+    _z_matching_sptr_t *listener = _z_register_matching(zn, &m);
+    assert(listener != NULL);
+    return listener;
+}
+
+static void subscribe(_z_session_t *zn, uint16_t peer, uint32_t id, const char *key) {
+    _z_decl_subscriber_t decl;
+    (void)memset(&decl, 0, sizeof(decl));
+    decl._id = id;
+    decl._keyexpr = _z_rname(key);
+    _z_keyexpr_set_mapping(&decl._keyexpr, peer);
+    assert(_z_register_remote_subscription(zn, peer, &decl) == _Z_RES_OK);
+}
+
+// The listener is notified when the first matching subscriber appears and when the last one disappears
+void subscribers_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+    _z_publisher_t pub;
+    (void)memset(&pub, 0, sizeof(pub));
+    pub._zn = &zn;
+    pub._key = _z_rname("test/a");
+
+    _z_matching_sptr_t *listener = listen(&zn, "test/a");
+    assert((calls == 0) && (listener->ptr->_matching == false));
+    assert(_z_publisher_is_matching(&pub) == false);
+
+    // A matching subscriber appears
+    subscribe(&zn, 1, 1, "test/**");
+    assert((calls == 1) && (last_status == true));
+    assert(_z_publisher_is_matching(&pub) == true);
+
+    // Other matching subscribers, repeated declarations, and subscribers not matching do not change the status
+    subscribe(&zn, 2, 1, "test/a");
+    subscribe(&zn, 1, 1, "test/**");
+    subscribe(&zn, 1, 2, "other/**");
+    assert(calls == 1);
+
+    // The status only changes once the last matching subscriber disappears
+    _z_unregister_remote_subscription(&zn, 1, 1);
+    assert((calls == 1) && (_z_publisher_is_matching(&pub) == true));
+    _z_unregister_remote_subscription(&zn, 2, 1);
+    assert((calls == 2) && (last_status == false));
+    assert(_z_publisher_is_matching(&pub) == false);
+    _z_unregister_remote_subscription(&zn, 2, 1);  // An unknown subscriber is ignored
+    assert(calls == 2);
+
+    // The subscribers of a peer disappear with it
+    subscribe(&zn, 3, 1, "test/*");
+    assert((calls == 3) && (last_status == true));
+    _z_unregister_remote_subscriptions_for_peer(&zn, 3);
+    assert((calls == 4) && (last_status == false));
+    _z_unregister_remote_subscriptions_for_peer(&zn, 1);
+    assert(calls == 4);
+
+    session_clear(&zn);
+    assert(drops == 1);
+}
+
+// A listener is told about the subscribers already known, and no longer notified once undeclared
+void listener_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+    calls = 0;
+    drops = 0;
+
+    subscribe(&zn, 1, 1, "test/**");
+    _z_matching_sptr_t *listener = listen(&zn, "test/b");
+    assert((calls == 1) && (last_status == true));
+    _z_matching_sptr_t *other = listen(&zn, "other/b");
+    assert((calls == 1) && (other->ptr->_matching == false));
+    assert(_z_get_matching_by_id(&zn, listener->ptr->_id) == listener);
+
+    uint32_t id = listener->ptr->_id;
+    _z_unregister_matching(&zn, listener);
+    assert((drops == 1) && (_z_get_matching_by_id(&zn, id) == NULL));
+    _z_unregister_remote_subscription(&zn, 1, 1);
+    assert(calls == 1);
+
+    // The remaining listener is still notified
+    subscribe(&zn, 1, 2, "other/*");
+    assert((calls == 2) && (last_status == true));
+
+    session_clear(&zn);
+    assert(drops == 2);
+}
+
+int main(void) {
+    subscribers_test();
+    listener_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif
@@ -110,6 +110,9 @@ void print_transport_message_type(uint8_t header) {
         case _Z_MID_T_FRAGMENT:
             printf("Frame message");
             break;
+        case _Z_MID_T_ACK_NACK:
+            printf("AckNack message");
+            break;
         default:
             assert(0);
             break;
@@ -1286,6 +1289,35 @@ void push_message(void) {
     _z_wbuf_clear(&wbf);
 }
 
+void push_prefix_message(void) {
+    printf("\n>> Push message with a pre-encoded prefix\n");
+    _z_n_msg_push_t msg = gen_push();
+
+    // The message framed from its prefix is encoded as the whole message
+    _z_wbuf_t expected = gen_wbuf(UINT16_MAX);
+    assert(_z_push_encode(&expected, &msg) == _Z_RES_OK);
+    _z_wbuf_t prefix = gen_wbuf(UINT16_MAX);
+    assert(_z_push_prefix_encode(&prefix, &msg) == _Z_RES_OK);
+    _z_zbuf_t pbf = _z_wbuf_to_zbuf(&prefix);
+    msg._prefix = _z_bytes_wrap(_z_zbuf_get_rptr(&pbf), _z_zbuf_len(&pbf));
+    _z_wbuf_t framed = gen_wbuf(UINT16_MAX);
+    assert(_z_push_encode(&framed, &msg) == _Z_RES_OK);
+
+    _z_zbuf_t ebf = _z_wbuf_to_zbuf(&expected);
+    _z_zbuf_t fbf = _z_wbuf_to_zbuf(&framed);
+    assert(_z_zbuf_len(&ebf) == _z_zbuf_len(&fbf));
+    assert(memcmp(_z_zbuf_get_rptr(&ebf), _z_zbuf_get_rptr(&fbf), _z_zbuf_len(&ebf)) == 0);
+
+    msg._prefix = _z_bytes_empty();
+    _z_n_msg_push_clear(&msg);
+    _z_zbuf_clear(&ebf);
+    _z_zbuf_clear(&fbf);
+    _z_zbuf_clear(&pbf);
+    _z_wbuf_clear(&expected);
+    _z_wbuf_clear(&prefix);
+    _z_wbuf_clear(&framed);
+}
+
 _z_n_msg_request_t gen_request(void) {
     _z_n_msg_request_t request = {
         ._rid = gen_uint64(),
@@ -1477,7 +1509,12 @@ _z_transport_message_t gen_join(void) {
         conduit._val._plain._best_effort = gen_uint64();
         conduit._val._plain._reliable = gen_uint64();
     }
-    return _z_t_msg_make_join(gen_uint8() % 3, gen_uint64(), gen_zid(), conduit);
+    _z_transport_message_t msg = _z_t_msg_make_join(gen_uint8() % 3, gen_uint64(), gen_zid(), conduit);
+    if (gen_bool()) {
+        msg._body._join._ext_reliability = true;
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
+    }
+    return msg;
 }
 void assert_eq_join(const _z_t_msg_join_t *left, const _z_t_msg_join_t *right) {
     assert(memcmp(left->_zid.id, right->_zid.id, 16) == 0);
@@ -1487,6 +1524,7 @@ void assert_eq_join(const _z_t_msg_join_t *left, const _z_t_msg_join_t *right) {
     assert(left->_req_id_res == right->_req_id_res);
     assert(left->_seq_num_res == right->_seq_num_res);
     assert(left->_version == right->_version);
+    assert(left->_ext_reliability == right->_ext_reliability);
     assert(left->_next_sn._is_qos == right->_next_sn._is_qos);
     if (left->_next_sn._is_qos) {
         for (int i = 0; i < Z_PRIORITIES_NUM; i++) {
@@ -1515,16 +1553,24 @@ void join_message(void) {
 }
 
 _z_transport_message_t gen_init(void) {
+    _z_transport_message_t msg;
     if (gen_bool()) {
-        return _z_t_msg_make_init_syn(gen_uint8() % 3, gen_zid());
+        msg = _z_t_msg_make_init_syn(gen_uint8() % 3, gen_zid());
     } else {
-        return _z_t_msg_make_init_ack(gen_uint8() % 3, gen_zid(), gen_bytes(16));
+        msg = _z_t_msg_make_init_ack(gen_uint8() % 3, gen_zid(), gen_bytes(16));
+    }
+    if (gen_bool()) {
+        msg._body._init._ext_reliability = true;
+        _Z_SET_FLAG(msg._header, _Z_FLAG_T_Z);
     }
+    return msg;
 }
 void assert_eq_init(const _z_t_msg_init_t *left, const _z_t_msg_init_t *right) {
     assert(left->_batch_size == right->_batch_size);
     assert(left->_req_id_res == right->_req_id_res);
     assert(left->_seq_num_res == right->_seq_num_res);
+    assert(left->_ext_qos == right->_ext_qos);
+    assert(left->_ext_reliability == right->_ext_reliability);
     assert_eq_bytes(&left->_cookie, &right->_cookie);
     assert(memcmp(left->_zid.id, right->_zid.id, 16) == 0);
     assert(left->_version == right->_version);
@@ -1667,10 +1713,12 @@ _z_network_message_vec_t gen_net_msgs(size_t n) {
 }
 
 _z_transport_message_t gen_frame(void) {
-    return _z_t_msg_make_frame(gen_uint(), gen_net_msgs(gen_uint8() % 16), gen_bool());
+    _z_n_qos_t qos = gen_bool() ? _z_n_qos_make(0, 0, gen_uint8() % 8) : _Z_N_QOS_DEFAULT;
+    return _z_t_msg_make_frame(gen_uint(), gen_net_msgs(gen_uint8() % 16), gen_bool(), qos);
 }
 void assert_eq_frame(const _z_t_msg_frame_t *left, const _z_t_msg_frame_t *right) {
     assert(left->_sn == right->_sn);
+    assert(left->_ext_qos._val == right->_ext_qos._val);
     assert(left->_messages._len == right->_messages._len);
     for (size_t i = 0; i < left->_messages._len; i++) {
         assert_eq_net_msg(left->_messages._val[i], right->_messages._val[i]);
@@ -1692,11 +1740,46 @@ void frame_message(void) {
     _z_wbuf_clear(&wbf);
 }
 
+void frame_stream_message(void) {
+    printf("\n>> frame message (streamed)\n");
+    _z_wbuf_t wbf = gen_wbuf(UINT16_MAX);
+    _z_transport_message_t expected = gen_frame();
+    assert(_z_transport_message_encode(&wbf, &expected) == _Z_RES_OK);
+    _z_transport_message_t decoded;
+    _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+    int8_t ret = _z_transport_message_decode_stream(&decoded, &zbf);
+    assert(_Z_RES_OK == ret);
+    assert(decoded._header == expected._header);
+    assert(decoded._body._frame._sn == expected._body._frame._sn);
+    assert(decoded._body._frame._ext_qos._val == expected._body._frame._ext_qos._val);
+    assert(decoded._body._frame._messages._len == 0);
+
+    size_t len = _z_network_message_vec_len(&expected._body._frame._messages);
+    for (size_t i = 0; i <= len; i++) {
+        _z_network_message_t nm;
+        _Bool end = false;
+        assert(_z_frame_decode_next(&decoded._body._frame, &nm, &end) == _Z_RES_OK);
+        assert(end == (i == len));
+        if (end == false) {
+            assert_eq_net_msg(_z_network_message_vec_get(&expected._body._frame._messages, i), &nm);
+            _z_n_msg_clear(&nm);
+        }
+    }
+    assert(_z_zbuf_len(&zbf) == 0);
+
+    _z_t_msg_clear(&decoded);
+    _z_t_msg_clear(&expected);
+    _z_zbuf_clear(&zbf);
+    _z_wbuf_clear(&wbf);
+}
+
 _z_transport_message_t gen_fragment(void) {
-    return _z_t_msg_make_fragment(gen_uint(), gen_bytes(gen_uint8()), gen_bool(), gen_bool());
+    _z_n_qos_t qos = gen_bool() ? _z_n_qos_make(0, 0, gen_uint8() % 8) : _Z_N_QOS_DEFAULT;
+    return _z_t_msg_make_fragment(gen_uint(), gen_bytes(gen_uint8()), gen_bool(), gen_bool(), qos);
 }
 void assert_eq_fragment(const _z_t_msg_fragment_t *left, const _z_t_msg_fragment_t *right) {
     assert(left->_sn == right->_sn);
+    assert(left->_ext_qos._val == right->_ext_qos._val);
     assert_eq_bytes(&left->_payload, &right->_payload);
 }
 void fragment_message(void) {
@@ -1715,8 +1798,38 @@ void fragment_message(void) {
     _z_wbuf_clear(&wbf);
 }
 
+_z_transport_message_t gen_ack_nack(void) {
+    _z_n_qos_t qos = gen_bool() ? _z_n_qos_make(0, 0, gen_uint8() % 8) : _Z_N_QOS_DEFAULT;
+    if (gen_bool()) {
+        return _z_t_msg_make_ack(gen_uint(), qos);
+    } else {
+        return _z_t_msg_make_nack(gen_uint(), gen_uint64(), gen_bool() ? gen_zid() : _z_id_empty(), qos);
+    }
+}
+void assert_eq_ack_nack(const _z_t_msg_ack_nack_t *left, const _z_t_msg_ack_nack_t *right) {
+    assert(left->_sn == right->_sn);
+    assert(left->_mask == right->_mask);
+    assert(memcmp(left->_zid.id, right->_zid.id, 16) == 0);
+    assert(left->_ext_qos._val == right->_ext_qos._val);
+}
+void ack_nack_message(void) {
+    printf("\n>> AckNack message\n");
+    _z_wbuf_t wbf = gen_wbuf(UINT16_MAX);
+    _z_transport_message_t expected = gen_ack_nack();
+    assert(_z_ack_nack_encode(&wbf, expected._header, &expected._body._ack_nack) == _Z_RES_OK);
+    _z_t_msg_ack_nack_t decoded;
+    _z_zbuf_t zbf = _z_wbuf_to_zbuf(&wbf);
+    int8_t ret = _z_ack_nack_decode(&decoded, &zbf, expected._header);
+    assert(_Z_RES_OK == ret);
+    assert_eq_ack_nack(&expected._body._ack_nack, &decoded);
+    _z_t_msg_ack_nack_clear(&decoded);
+    _z_t_msg_clear(&expected);
+    _z_zbuf_clear(&zbf);
+    _z_wbuf_clear(&wbf);
+}
+
 _z_transport_message_t gen_transport(void) {
-    switch (gen_uint8() % 7) {
+    switch (gen_uint8() % 8) {
         case 0: {
             return gen_join();
         };
@@ -1735,10 +1848,13 @@ _z_transport_message_t gen_transport(void) {
         case 5: {
             return gen_frame();
         };
-        case 6:
-        default: {
+        case 6: {
             return gen_fragment();
         };
+        case 7:
+        default: {
+            return gen_ack_nack();
+        };
     }
 }
 void assert_eq_transport(const _z_transport_message_t *left, const _z_transport_message_t *right) {
@@ -1765,6 +1881,9 @@ void assert_eq_transport(const _z_transport_message_t *left, const _z_transport_
         case _Z_MID_T_FRAGMENT: {
             assert_eq_fragment(&left->_body._fragment, &right->_body._fragment);
         } break;
+        case _Z_MID_T_ACK_NACK: {
+            assert_eq_ack_nack(&left->_body._ack_nack, &right->_body._ack_nack);
+        } break;
         default:
             assert(false);
     }
@@ -1859,6 +1978,7 @@ int main(void) {
 
         // Network messages
         push_message();
+        push_prefix_message();
         request_message();
         response_message();
         response_final_message();
@@ -1870,7 +1990,9 @@ int main(void) {
         close_message();
         keep_alive_message();
         frame_message();
+        frame_stream_message();
         fragment_message();
+        ack_nack_message();
         transport_message();
 
         // Scouting messages
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/net/session.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/transport.h"
+#include "zenoh-pico/transport/unicast/transport.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_MULTI_TRANSPORT == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1 && Z_TRANSPORTS_MAX >= 2
+
+// The number of batches written on the link of each transport, the ones marked failing refuse them
+static size_t written[2];
+static _Bool failing[2];
+
+static size_t write(const _z_link_t *self, const uint8_t *ptr, size_t len) {
+    (void)(ptr);
+    // The reliable link of the first transport is a stream, the other one is made of datagrams
+    size_t i = (self->_cap._flow == Z_LINK_CAP_FLOW_STREAM) ? 0 : 1;
+    size_t ret = SIZE_MAX;
+    if (failing[i] == false) {
+        written[i]++;
+        ret = len;
+    }
+    return ret;
+}
+
+static void close_link(_z_link_t *self) { (void)(self); }
+static void free_link(_z_link_t *self) { (void)(self); }
+
+static void make_transport(_z_transport_t *zt, _Bool is_reliable) {
+    _z_link_t zl;
+    (void)memset(&zl, 0, sizeof(zl));
+    zl._write_f = write;
+    zl._close_f = close_link;
+    zl._free_f = free_link;
+    zl._mtu = Z_BATCH_UNICAST_SIZE;
+    zl._cap._transport = Z_LINK_CAP_TRANSPORT_UNICAST;
+    zl._cap._flow = (is_reliable == true) ? Z_LINK_CAP_FLOW_STREAM : Z_LINK_CAP_FLOW_DATAGRAM;
+    zl._cap._is_reliable = is_reliable;
+
+    _z_transport_unicast_establish_param_t param;
+    (void)memset(&param, 0, sizeof(param));
+    param._seq_num_res = Z_SN_RESOLUTION;
+    param._batch_size = Z_BATCH_UNICAST_SIZE;
+    assert(_z_unicast_transport_create(zt, &zl, &param) == _Z_RES_OK);
+}
+
+static void send(_z_session_t *zn, _z_network_message_t *n_msg, z_reliability_t reliability, int8_t expected) {
+    written[0] = 0;
+    written[1] = 0;
+    assert(_z_send_n_msg(zn, n_msg, reliability, Z_CONGESTION_CONTROL_DROP) == expected);
+#if Z_FEATURE_BATCHING == 1
+    (void)_zp_flush(zn);
+#endif
+}
+
+static void send_to(_z_session_t *zn, uint16_t mapping, _z_network_message_t *n_msg, int8_t expected) {
+    written[0] = 0;
+    written[1] = 0;
+    assert(_z_send_n_msg_to(zn, mapping, n_msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) == expected);
+#if Z_FEATURE_BATCHING == 1
+    (void)_zp_flush(zn);
+#endif
+}
+
+static _z_network_message_t make_push(void) {
+    _z_keyexpr_t key = _z_rid_with_suffix(1, NULL);
+    _z_push_body_t body = _z_push_body_null();
+    return _z_n_msg_make_push(&key, &body);
+}
+
+void send_test(void) {
+    // A session over a reliable stream transport and a best effort datagram transport
+    _z_session_t zn;
+    (void)memset(&zn, 0, sizeof(zn));
+    make_transport(&zn._tp, true);
+    make_transport(&zn._tp_others[0], false);
+    zn._tp_others[0]._transport._unicast._mapping = (uint16_t)(_Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE - 1);
+    zn._tp_others_len = 1;
+    assert(_z_session_transports_len(&zn) == 2);
+    assert(_z_session_transport(&zn, 1) == &zn._tp_others[0]);
+
+    // The messages are sent on the transport that suits their reliability
+    _z_network_message_t push = make_push();
+    send(&zn, &push, Z_RELIABILITY_RELIABLE, _Z_RES_OK);
+    assert((written[0] == 1) && (written[1] == 0));
+    send(&zn, &push, Z_RELIABILITY_BEST_EFFORT, _Z_RES_OK);
+#if Z_TRANSPORTS_STRIPING == 1
+    // Best effort data goes to each transport in turn
+    assert(written[0] + written[1] == 1);
+    send(&zn, &push, Z_RELIABILITY_BEST_EFFORT, _Z_RES_OK);
+    assert(written[0] + written[1] == 1);
+    send(&zn, &push, Z_RELIABILITY_BEST_EFFORT, _Z_RES_OK);
+    assert(written[0] + written[1] == 1);
+#else
+    assert((written[0] == 0) && (written[1] == 1));
+#endif
+
+    // The declarations reach every transport
+    _z_network_message_t decl = _z_n_msg_make_declare(_z_make_undecl_keyexpr(1));
+    send(&zn, &decl, Z_RELIABILITY_RELIABLE, _Z_RES_OK);
+    assert((written[0] == 1) && (written[1] == 1));
+
+    // The responses only go back on the transport of the request, whatever their reliability
+    _z_network_message_t final = _z_n_msg_make_response_final(1);
+    send_to(&zn, (uint16_t)(_Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE - 1), &final, _Z_RES_OK);
+    assert((written[0] == 0) && (written[1] == 1));
+    send_to(&zn, _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE, &final, _Z_RES_OK);
+    assert((written[0] == 1) && (written[1] == 0));
+    send_to(&zn, 1, &final, _Z_ERR_TRANSPORT_NOT_AVAILABLE);  // No multicast transport holds the peer
+    assert((written[0] == 0) && (written[1] == 0));
+
+#if Z_FEATURE_BATCHING == 0
+    // A failing transport is skipped for the next one, a batched message only fails once flushed
+    failing[0] = true;
+    send(&zn, &push, Z_RELIABILITY_RELIABLE, _Z_RES_OK);
+    assert((written[0] == 0) && (written[1] == 1));
+    send(&zn, &decl, Z_RELIABILITY_RELIABLE, _Z_RES_OK);
+    assert((written[0] == 0) && (written[1] == 1));
+    failing[0] = false;
+#endif
+
+    // A transport that is down is not used anymore
+    zn._tp._transport._unicast._is_down = true;
+    assert(_z_transport_is_up(&zn._tp) == false);
+    send(&zn, &push, Z_RELIABILITY_RELIABLE, _Z_RES_OK);
+    assert((written[0] == 0) && (written[1] == 1));
+    send(&zn, &decl, Z_RELIABILITY_RELIABLE, _Z_RES_OK);
+    assert((written[0] == 0) && (written[1] == 1));
+    send_to(&zn, _Z_KEYEXPR_MAPPING_UNKNOWN_REMOTE, &final, _Z_ERR_TRANSPORT_NOT_AVAILABLE);
+    assert((written[0] == 0) && (written[1] == 0));
+
+#if Z_FEATURE_BATCHING == 0
+    // Nothing is sent once all of them failed
+    failing[1] = true;
+    send(&zn, &push, Z_RELIABILITY_RELIABLE, _Z_ERR_TRANSPORT_TX_FAILED);
+    send(&zn, &decl, Z_RELIABILITY_RELIABLE, _Z_ERR_TRANSPORT_TX_FAILED);
+    assert((written[0] == 0) && (written[1] == 0));
+    failing[1] = false;
+#endif
+
+    _z_n_msg_clear(&push);
+    _z_n_msg_clear(&decl);
+    _z_n_msg_clear(&final);
+    _z_transport_clear(&zn._tp);
+    _z_transport_clear(&zn._tp_others[0]);
+}
+
+int main(void) {
+    send_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif
@@ -0,0 +1,225 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/collections/pointer.h"
+#include "zenoh-pico/link/link.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/utils/pool.h"
+#include "zenoh-pico/utils/result.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_MEMORY_POOL == 1
+
+static zp_memory_pool_stats_t stats(size_t cls) {
+    zp_memory_pool_stats_t s;
+    assert(zp_memory_pool_stats(cls, &s) == _Z_RES_OK);
+    return s;
+}
+
+void classes_test(void) {
+    zp_memory_pool_stats_t s;
+    assert(zp_memory_pool_stats(Z_MEMORY_POOL_CLASSES, &s) < 0);
+
+    for (size_t cls = 0; cls < Z_MEMORY_POOL_CLASSES; cls++) {
+        size_t block_size = (size_t)Z_MEMORY_POOL_BLOCK_SIZE << cls;
+        assert(stats(cls).block_size == block_size);
+        assert(stats(cls).blocks == Z_MEMORY_POOL_BLOCKS);
+
+        // Each size is served by the smallest class it fits in
+        size_t used = stats(cls).used;
+        uint8_t *ptr = (uint8_t *)zp_malloc(block_size);
+        assert(_z_pool_block_size(ptr) == block_size);
+        assert(stats(cls).used == used + 1);
+        assert(stats(cls).high_watermark >= used + 1);
+        memset(ptr, 0xaa, block_size);
+        zp_free(ptr);
+        assert(stats(cls).used == used);
+
+        ptr = (uint8_t *)zp_malloc((block_size / 2) + 1);
+        assert(_z_pool_block_size(ptr) == block_size);
+        zp_free(ptr);
+    }
+
+    // Larger allocations are not served by the pool
+    size_t largest = (size_t)Z_MEMORY_POOL_BLOCK_SIZE << (Z_MEMORY_POOL_CLASSES - 1);
+    uint8_t *ptr = (uint8_t *)zp_malloc(largest + 1);
+    assert(ptr != NULL);
+    assert(_z_pool_block_size(ptr) == 0);
+    zp_free(ptr);
+}
+
+void exhaustion_test(void) {
+    size_t used = stats(0).used;
+    size_t fallbacks = stats(0).fallbacks;
+
+    void *ptrs[Z_MEMORY_POOL_BLOCKS];
+    size_t n = Z_MEMORY_POOL_BLOCKS - used;
+    for (size_t i = 0; i < n; i++) {
+        ptrs[i] = zp_malloc(1);
+        assert(_z_pool_block_size(ptrs[i]) == Z_MEMORY_POOL_BLOCK_SIZE);
+    }
+    assert(stats(0).used == Z_MEMORY_POOL_BLOCKS);
+    assert(stats(0).high_watermark == Z_MEMORY_POOL_BLOCKS);
+
+    // Once all the blocks are used, the platform allocator takes over
+    void *ptr = zp_malloc(1);
+    assert(ptr != NULL);
+    assert(_z_pool_block_size(ptr) == 0);
+    assert(stats(0).fallbacks == fallbacks + 1);
+    zp_free(ptr);
+
+    // The freed blocks are allocated again
+    zp_free(ptrs[0]);
+    ptr = zp_malloc(1);
+    assert(ptr == ptrs[0]);
+    ptrs[0] = ptr;
+
+    for (size_t i = 0; i < n; i++) {
+        zp_free(ptrs[i]);
+    }
+    assert(stats(0).used == used);
+    assert(stats(0).high_watermark == Z_MEMORY_POOL_BLOCKS);
+}
+
+void realloc_test(void) {
+    uint8_t *ptr = (uint8_t *)zp_realloc(NULL, 4);
+    assert(_z_pool_block_size(ptr) == Z_MEMORY_POOL_BLOCK_SIZE);
+    memcpy(ptr, "abcd", 4);
+
+    // Within the block, the allocation stays in place
+    assert(zp_realloc(ptr, Z_MEMORY_POOL_BLOCK_SIZE) == ptr);
+
+    // Beyond, it is moved to a larger class
+    ptr = (uint8_t *)zp_realloc(ptr, Z_MEMORY_POOL_BLOCK_SIZE + 1);
+    assert(_z_pool_block_size(ptr) == 2 * Z_MEMORY_POOL_BLOCK_SIZE);
+    assert(memcmp(ptr, "abcd", 4) == 0);
+    zp_free(ptr);
+}
+
+typedef struct {
+    uint64_t _a;
+    uint64_t _b;
+} _z_pair_t;
+static inline void _z_pair_clear(_z_pair_t *p) { (void)(p); }
+_Z_POINTER_DEFINE(_z_pair, _z_pair)
+
+void sptr_test(void) {
+    // The value and its counter take a single block
+    size_t used = stats(1).used;
+    _z_pair_sptr_t p = _z_pair_sptr_new((_z_pair_t){._a = 1, ._b = 2});
+    assert(p.ptr != NULL);
+    assert(stats(1).used == used + 1);
+
+    _z_pair_sptr_t c = _z_pair_sptr_clone(&p);
+    assert(stats(1).used == used + 1);
+    assert(_z_pair_sptr_drop(&p) == false);
+    assert(c.ptr->_b == 2);
+    assert(_z_pair_sptr_drop(&c) == true);
+    assert(stats(1).used == used);
+}
+
+#if Z_FEATURE_LINK_UDP_MULTICAST == 1
+static size_t pool_used(void) {
+    size_t used = 0;
+    for (size_t cls = 0; cls < Z_MEMORY_POOL_CLASSES; cls++) {
+        used = used + stats(cls).used;
+    }
+    return used;
+}
+
+void link_test(void) {
+    // The platform releases parts of the link endpoints itself, they must not come from the pool
+    size_t used = pool_used();
+    for (int i = 0; i < 2; i++) {
+        _z_link_t zl;
+        if (i == 0) {
+            assert(_z_open_link(&zl, "udp/224.0.0.227:7447#iface=lo") == _Z_RES_OK);
+        } else {
+            assert(_z_listen_link(&zl, "udp/224.0.0.227:7447#iface=lo") == _Z_RES_OK);
+        }
+        assert(pool_used() > used);
+        _z_link_clear(&zl);
+        assert(pool_used() == used);
+    }
+}
+#endif
+
+#if Z_FEATURE_MULTI_THREAD == 1
+#define THREADS 4
+#define ROUNDS 20000
+#define HELD 8
+
+static void *worker(void *arg) {
+    uint8_t id = (uint8_t)(uintptr_t)arg;
+    uint8_t *held[HELD] = {NULL};
+    for (size_t r = 0; r < ROUNDS; r++) {
+        size_t i = r % HELD;
+        if (held[i] != NULL) {
+            // No other thread was given the same block
+            for (size_t j = 0; j < Z_MEMORY_POOL_BLOCK_SIZE; j++) {
+                assert(held[i][j] == id);
+            }
+            zp_free(held[i]);
+        }
+        held[i] = (uint8_t *)zp_malloc(Z_MEMORY_POOL_BLOCK_SIZE);
+        assert(held[i] != NULL);
+        memset(held[i], id, Z_MEMORY_POOL_BLOCK_SIZE);
+    }
+    for (size_t i = 0; i < HELD; i++) {
+        zp_free(held[i]);
+    }
+    return NULL;
+}
+
+void concurrent_test(void) {
+    size_t used = stats(0).used;
+
+    zp_task_t tasks[THREADS];
+    for (size_t i = 0; i < THREADS; i++) {
+        assert(zp_task_init(&tasks[i], NULL, worker, (void *)(uintptr_t)(i + 1)) == 0);
+    }
+    for (size_t i = 0; i < THREADS; i++) {
+        assert(zp_task_join(&tasks[i]) == 0);
+    }
+    assert(stats(0).used == used);
+}
+#endif
+
+int main(void) {
+    classes_test();
+    exhaustion_test();
+    realloc_test();
+    sptr_test();
+#if Z_FEATURE_LINK_UDP_MULTICAST == 1
+    link_test();
+#endif
+#if Z_FEATURE_MULTI_THREAD == 1
+    concurrent_test();
+#endif
+    return 0;
+}
+
+#else
+int main(void) {
+    printf("Missing config token to build this test. This test requires: Z_FEATURE_MEMORY_POOL\n");
+    return 0;
+}
+#endif
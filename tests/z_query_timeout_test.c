@@ -0,0 +1,213 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/collections/string.h"
+#include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/query.h"
+#include "zenoh-pico/system/platform.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_QUERY == 1
+
+#define QUERIES 64
+
+static size_t errors = 0;
+static size_t drops = 0;
+static int dropped[QUERIES];
+
+static void reply_handler(_z_reply_t *reply, struct __z_reply_handler_wrapper_t *arg) {
+    (void)(arg);
+    assert(reply->_tag == Z_REPLY_TAG_ERROR);
+    assert(reply->data.sample.payload.len > (size_t)0);
+    errors = errors + 1;
+    _z_reply_free(&reply);
+}
+
+static void drop_handler(void *arg) {
+    dropped[drops] = *(int *)arg;
+    drops = drops + 1;
+}
+
+static void session_init(_z_session_t *zn) {
+    (void)memset(zn, 0, sizeof(_z_session_t));
+    zn->_query_id = 1;
+    _z_pending_query_table_init(&zn->_pending_queries);
+    zn->_query_clock = zp_clock_now();
+#if Z_FEATURE_MULTI_THREAD == 1
+    assert(zp_mutex_init(&zn->_mutex_inner) == 0);
+#endif
+}
+
+static void session_clear(_z_session_t *zn) {
+    _z_flush_pending_queries(zn);
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_free(&zn->_mutex_inner);
+#endif
+}
+
+static _z_pending_query_t *query_new(_z_session_t *zn, int *tag) {
+    _z_pending_query_t *pq = (_z_pending_query_t *)zp_malloc(sizeof(_z_pending_query_t));
+    assert(pq != NULL);
+    (void)memset(pq, 0, sizeof(_z_pending_query_t));
+    pq->_id = _z_get_query_id(zn);
+    pq->_key = _z_rname("test/timeout");
+    pq->_parameters = _z_str_clone("");
+    pq->_consolidation = Z_CONSOLIDATION_MODE_NONE;
+    pq->_callback = reply_handler;
+    pq->_dropper = drop_handler;
+    pq->_drop_arg = tag;
+    return pq;
+}
+
+static void reset(void) {
+    errors = 0;
+    drops = 0;
+}
+
+void expire_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+    reset();
+
+    int tags[3] = {0, 1, 2};
+    assert(_z_register_pending_query(&zn, query_new(&zn, &tags[0]), 200) == 0);
+    assert(_z_register_pending_query(&zn, query_new(&zn, &tags[1]), 50) == 0);
+    assert(_z_register_pending_query(&zn, query_new(&zn, &tags[2]), 0) == 0);  // Never expires
+
+    _z_process_query_timeouts(&zn);
+    assert(errors == 0);
+    assert(drops == 0);
+    assert(_z_get_next_query_timeout(&zn, 1000) <= 50);
+    assert(_z_get_next_query_timeout(&zn, 5) == 5);
+
+    zp_sleep_ms(_z_get_next_query_timeout(&zn, 1000));
+    zp_sleep_ms(5);
+    _z_process_query_timeouts(&zn);
+    assert(errors == 1);
+    assert(drops == 1);
+    assert(dropped[0] == 1);
+    assert(_z_get_pending_query_by_id(&zn, 2) == NULL);
+
+    zp_sleep_ms(200);
+    _z_process_query_timeouts(&zn);
+    assert(errors == 2);
+    assert(dropped[1] == 0);
+    assert(_z_get_next_query_timeout(&zn, 1000) == 1000);
+
+    // The query without timeout is only dropped with the session
+    assert(_z_get_pending_query_by_id(&zn, 3) != NULL);
+    session_clear(&zn);
+    assert(errors == 2);
+    assert(drops == 3);
+    assert(dropped[2] == 2);
+}
+
+void unregister_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+    reset();
+
+    int tags[2] = {0, 1};
+    _z_pending_query_t *pq = query_new(&zn, &tags[0]);
+    assert(_z_register_pending_query(&zn, pq, 10) == 0);
+    assert(_z_register_pending_query(&zn, query_new(&zn, &tags[1]), 20) == 0);
+    _z_unregister_pending_query(&zn, pq);
+    assert(drops == 1);
+
+    zp_sleep_ms(30);
+    _z_process_query_timeouts(&zn);
+    assert(errors == 1);
+    assert(drops == 2);
+    assert(dropped[1] == 1);
+
+    session_clear(&zn);
+}
+
+void order_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+    reset();
+
+    // Register the queries in a shuffled deadline order, they must expire by deadline
+    int tags[QUERIES];
+    for (int i = 0; i < QUERIES; i++) {
+        tags[i] = (i * 37) % QUERIES;
+        assert(_z_register_pending_query(&zn, query_new(&zn, &tags[i]), (uint32_t)(10 + (tags[i] * 5))) == 0);
+    }
+    assert(zn._pending_queries._len == (size_t)QUERIES);
+    assert(zn._pending_queries._timeouts_len == (size_t)QUERIES);
+
+    while (drops < (size_t)QUERIES) {
+        zp_sleep_ms(_z_get_next_query_timeout(&zn, 1000));
+        _z_process_query_timeouts(&zn);
+    }
+    assert(errors == (size_t)QUERIES);
+    for (int i = 0; i < QUERIES; i++) {
+        assert(dropped[i] == i);
+    }
+    assert(zn._pending_queries._len == (size_t)0);
+    assert(zn._pending_queries._timeouts_len == (size_t)0);
+
+    session_clear(&zn);
+}
+
+void callback_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+    reset();
+
+    // The first query to expire has its reply callback running, the later ones still expire in time
+    int tags[3] = {0, 1, 2};
+    _z_pending_query_t *pq = query_new(&zn, &tags[0]);
+    assert(_z_register_pending_query(&zn, pq, 10) == 0);
+    assert(_z_register_pending_query(&zn, query_new(&zn, &tags[1]), 20) == 0);
+    assert(_z_register_pending_query(&zn, query_new(&zn, &tags[2]), 30) == 0);
+    pq->_in_callback = true;
+
+    zp_sleep_ms(40);
+    _z_process_query_timeouts(&zn);
+    assert(errors == 2);
+    assert((drops == 2) && (dropped[0] == 1) && (dropped[1] == 2));
+    assert(_z_get_pending_query_by_id(&zn, pq->_id) == pq);
+
+    // It expires once its callback returned
+    pq->_in_callback = false;
+    zp_sleep_ms(_z_get_next_query_timeout(&zn, 1000));
+    _z_process_query_timeouts(&zn);
+    assert(errors == 3);
+    assert((drops == 3) && (dropped[2] == 0));
+    assert(zn._pending_queries._timeouts_len == (size_t)0);
+
+    session_clear(&zn);
+}
+
+int main(void) {
+    expire_test();
+    unregister_test();
+    order_test();
+    callback_test();
+    return 0;
+}
+
+#else
+int main(void) {
+    printf("Missing config token to build this test. This test requires: Z_FEATURE_QUERY\n");
+    return 0;
+}
+#endif
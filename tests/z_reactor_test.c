@@ -0,0 +1,147 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_REACTOR == 1 && Z_FEATURE_MULTICAST_TRANSPORT == 1 && Z_FEATURE_LINK_UDP_MULTICAST == 1 && \
+    Z_FEATURE_PUBLICATION == 1 && Z_FEATURE_SUBSCRIPTION == 1
+
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define LOCATOR "udp/224.0.0.225:7447#iface=lo"
+#define KEYEXPR "test/reactor"
+#define MSG 10
+#define TIMEOUT 30
+
+void poll_test(void) {
+    int fds[2];
+    assert(socketpair(AF_UNIX, SOCK_STREAM, 0, fds) == 0);
+    _z_sys_net_socket_t sock = {._fd = fds[0]};
+    _z_sys_net_poll_t poll;
+    assert(_z_poll_init(&poll) == _Z_RES_OK);
+    _z_sys_net_poll_event_t events[2];
+    int arg = 0;
+
+    // Nothing to read yet
+    assert(_z_poll_add(&poll, &sock, &arg) == _Z_RES_OK);
+    assert(_z_poll_wait(&poll, events, 2, 0) == 0);
+
+    // A readable socket is reported once, until re-armed
+    assert(write(fds[1], "a", 1) == 1);
+    assert(_z_poll_wait(&poll, events, 2, 1000) == 1);
+    assert(events[0].arg == &arg);
+    assert(events[0].hangup == false);
+    assert(_z_poll_wait(&poll, events, 2, 0) == 0);
+    assert(_z_poll_rearm(&poll, &sock, &arg) == _Z_RES_OK);
+    assert(_z_poll_wait(&poll, events, 2, 1000) == 1);
+
+    // The peer closing the connection is reported as a hangup
+    assert(_z_poll_rearm(&poll, &sock, &arg) == _Z_RES_OK);
+    close(fds[1]);
+    assert(_z_poll_wait(&poll, events, 2, 1000) == 1);
+    assert(events[0].hangup == true);
+
+    // A removed socket is not reported anymore
+    assert(_z_poll_rearm(&poll, &sock, &arg) == _Z_RES_OK);
+    assert(_z_poll_remove(&poll, &sock) == _Z_RES_OK);
+    assert(_z_poll_wait(&poll, events, 2, 0) == 0);
+
+    _z_poll_clear(&poll);
+    close(fds[0]);
+}
+
+volatile unsigned int datas = 0;
+void data_handler(const z_sample_t *sample, void *arg) {
+    (void)(arg);
+    assert(sample->payload.len == 4);
+    datas++;
+}
+
+static z_owned_session_t open_session(uint8_t key) {
+    z_owned_config_t config = z_config_default();
+    zp_config_insert(z_loan(config), Z_CONFIG_MODE_KEY, z_string_make("peer"));
+    zp_config_insert(z_loan(config), key, z_string_make(LOCATOR));
+    z_owned_session_t s = z_open(z_move(config));
+    assert(z_check(s));
+    return s;
+}
+
+// Runs the reactor until count samples have been received
+static void run_until(zp_reactor_t *reactor, unsigned int count) {
+    zp_clock_t start = zp_clock_now();
+    while (datas < count) {
+        assert(zp_clock_elapsed_s(&start) < TIMEOUT);
+        assert(zp_reactor_run(reactor, 100) == _Z_RES_OK);
+    }
+}
+
+void reactor_test(void) {
+    zp_reactor_t reactor;
+    assert(zp_reactor_init(&reactor) == _Z_RES_OK);
+
+    // Both sessions are read and kept alive by the reactor, without any task
+    z_owned_session_t s1 = open_session(Z_CONFIG_LISTEN_KEY);
+    z_owned_session_t s2 = open_session(Z_CONFIG_CONNECT_KEY);
+    assert(zp_reactor_add(&reactor, z_loan(s1)) == _Z_RES_OK);
+    assert(zp_reactor_add(&reactor, z_loan(s2)) == _Z_RES_OK);
+    assert(zp_reactor_add(&reactor, z_loan(s2)) != _Z_RES_OK);
+
+    z_owned_closure_sample_t callback = z_closure(data_handler, NULL, NULL);
+    z_owned_subscriber_t sub = z_declare_subscriber(z_loan(s2), z_keyexpr(KEYEXPR), z_move(callback), NULL);
+    assert(z_check(sub));
+
+    // Let the sessions discover each other through their joins
+    zp_clock_t start = zp_clock_now();
+    while (zp_clock_elapsed_ms(&start) < 1000) {
+        assert(zp_reactor_run(&reactor, 100) == _Z_RES_OK);
+    }
+
+    // The samples are delivered from the thread running the reactor
+    for (unsigned int i = 0; i < MSG; i++) {
+        z_put_options_t opt = z_put_options_default();
+        assert(z_put(z_loan(s1), z_keyexpr(KEYEXPR), (const uint8_t *)"data", 4, &opt) == _Z_RES_OK);
+        assert(zp_flush(z_loan(s1), NULL) == _Z_RES_OK);
+        run_until(&reactor, i + 1);
+    }
+
+    // A removed session is not read anymore
+    z_undeclare_subscriber(z_move(sub));
+    assert(zp_reactor_remove(&reactor, z_loan(s1)) == _Z_RES_OK);
+    assert(zp_reactor_remove(&reactor, z_loan(s1)) != _Z_RES_OK);
+    assert(zp_reactor_remove(&reactor, z_loan(s2)) == _Z_RES_OK);
+    assert(reactor._len == 0);
+    assert(reactor._timers_len == 0);
+
+    z_close(z_move(s1));
+    z_close(z_move(s2));
+    zp_reactor_free(&reactor);
+}
+
+int main(void) {
+    poll_test();
+    reactor_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif
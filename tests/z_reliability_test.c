@@ -0,0 +1,205 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/protocol/codec/core.h"
+#include "zenoh-pico/protocol/codec/transport.h"
+#include "zenoh-pico/transport/common/reliability.h"
+#include "zenoh-pico/transport/utils.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_RELIABILITY == 1
+
+#define SN_RES 0xFF
+#define GAP SIZE_MAX
+
+/*------------------ TX ------------------*/
+static size_t sent[64];
+static size_t sent_len = 0;
+
+// Records the SN of the frames written on the link
+static size_t write_all(const _z_link_t *self, const uint8_t *ptr, size_t len) {
+    (void)(self);
+    assert(_Z_MID(ptr[0]) == _Z_MID_T_FRAME);
+    _z_zbuf_t zbf = _z_zbytes_as_zbuf(_z_bytes_wrap(&ptr[1], len - 1));
+    _z_zint_t sn = 0;
+    assert(_z_zint_decode(&sn, &zbf) == _Z_RES_OK);
+    sent[sent_len++] = (size_t)sn;
+    return len;
+}
+
+static void push_frame(_z_reliability_window_t *w, _z_wbuf_t *wbf, _z_zint_t sn, _Bool is_reliable, _z_zint_t now) {
+    _z_wbuf_reset(wbf);
+    _z_transport_message_t t_msg = _z_t_msg_make_frame_header(sn, is_reliable, _Z_N_QOS_DEFAULT);
+    assert(_z_transport_message_encode(wbf, &t_msg) == _Z_RES_OK);
+    assert(_z_wbuf_write_bytes(wbf, (const uint8_t *)"data", 0, 4) == _Z_RES_OK);
+    assert(_z_reliability_window_push(w, wbf, Z_LINK_CAP_FLOW_DATAGRAM, now) == _Z_RES_OK);
+}
+
+void window_test(void) {
+    _z_link_t zl;
+    (void)memset(&zl, 0, sizeof(zl));
+    zl._write_all_f = write_all;
+    _z_wbuf_t wbf = _z_wbuf_make(64, false);
+    _z_reliability_window_t *w = _z_reliability_windows_make(1);
+    assert(w != NULL);
+
+    // Only the reliable frames are kept
+    for (_z_zint_t sn = 5; sn < 10; sn++) {
+        push_frame(w, &wbf, sn, true, 0);
+    }
+    push_frame(w, &wbf, 10, false, 0);
+
+    // The first missing SN is retransmitted with the ones of the mask
+    sent_len = 0;
+    assert(_z_reliability_window_resend(w, &zl, SN_RES, 5, 0x5, 10) == _Z_RES_OK);
+    assert(sent_len == 3);
+    assert((sent[0] == 5) && (sent[1] == 6) && (sent[2] == 8));
+
+    // Unknown SNs are skipped
+    sent_len = 0;
+    assert(_z_reliability_window_resend(w, &zl, SN_RES, 10, 0x1, 10) == _Z_RES_OK);
+    assert(sent_len == 0);
+
+    // The acknowledged frames are released, the others are retransmitted once expired
+    _z_reliability_window_ack(w, SN_RES, 7);
+    sent_len = 0;
+    assert(_z_reliability_window_resend_expired(w, &zl, 100, 100) == _Z_RES_OK);
+    assert(sent_len == 1);
+    assert(sent[0] == 9);
+    sent_len = 0;
+    assert(_z_reliability_window_resend_expired(w, &zl, 100, 100) == _Z_RES_OK);
+    assert(sent_len == 0);
+
+    // Once the window is full, the oldest frames are evicted
+    push_frame(w, &wbf, 8 + Z_RELIABILITY_WINDOW_SIZE, true, 100);
+    sent_len = 0;
+    assert(_z_reliability_window_resend(w, &zl, SN_RES, 8, 0x1, 100) == _Z_RES_OK);
+    assert(sent_len == 1);
+    assert(sent[0] == 9);
+
+    // Acknowledgments wrap around with the SNs
+    push_frame(w, &wbf, SN_RES, true, 100);
+    _z_reliability_window_ack(w, SN_RES, 1);
+    sent_len = 0;
+    assert(_z_reliability_window_resend_expired(w, &zl, 1000, 100) == _Z_RES_OK);
+    assert(sent_len == 2);
+
+    _z_reliability_windows_free(&w, 1);
+    assert(w == NULL);
+    _z_wbuf_clear(&wbf);
+}
+
+/*------------------ RX ------------------*/
+static size_t delivered[64];
+static size_t delivered_len = 0;
+
+// Records the SN of the delivered fragments, and GAP for the given up ones
+static int8_t deliver(void *arg, _z_transport_message_t *t_msg, _Bool is_copy) {
+    (void)(arg);
+    if (t_msg == NULL) {
+        delivered[delivered_len++] = GAP;
+    } else {
+        assert(t_msg->_body._fragment._payload.len == 1);
+        assert(t_msg->_body._fragment._payload.start[0] == (uint8_t)t_msg->_body._fragment._sn);
+        assert(is_copy == (t_msg->_body._fragment._payload.start != (const uint8_t *)arg));
+        delivered[delivered_len++] = (size_t)t_msg->_body._fragment._sn;
+    }
+    return _Z_RES_OK;
+}
+
+// Receives a reliable fragment whose single byte is its SN, returns whether a NACK is due
+static _Bool recv_fragment(_z_reliability_reorder_t *r, _z_zint_t *last, _z_zint_t sn, _z_zint_t *nsn,
+                           _z_zint_t *mask) {
+    uint8_t byte = (uint8_t)sn;
+    _z_transport_message_t t_msg;
+    t_msg._header = _Z_MID_T_FRAGMENT | _Z_FLAG_T_FRAGMENT_R;
+    t_msg._body._fragment._sn = sn;
+    t_msg._body._fragment._payload = _z_bytes_wrap(&byte, 1);
+    t_msg._body._fragment._ext_qos = _Z_N_QOS_DEFAULT;
+    return _z_reliability_reorder_recv(r, SN_RES, last, &t_msg, deliver, &byte, nsn, mask);
+}
+
+void reorder_test(void) {
+    _z_reliability_reorder_t *r = _z_reliability_reorders_make(1);
+    assert(r != NULL);
+    _z_zint_t last = 0;
+    _z_zint_t sn = 0;
+    _z_zint_t mask = 0;
+
+    // In order fragments are delivered right away
+    assert(recv_fragment(r, &last, 1, &sn, &mask) == false);
+    assert((delivered_len == 1) && (delivered[0] == 1) && (last == 1));
+
+    // A gap is reported once, the fragments received after it are buffered
+    assert(recv_fragment(r, &last, 4, &sn, &mask) == true);
+    assert((sn == 2) && (mask == 0x1));
+    assert(recv_fragment(r, &last, 5, &sn, &mask) == false);
+    assert(recv_fragment(r, &last, 7, &sn, &mask) == true);
+    assert((sn == 2) && (mask == 0x9));
+    assert((delivered_len == 1) && (last == 1));
+
+    // The buffered fragments are delivered once the missing ones are received
+    assert(recv_fragment(r, &last, 3, &sn, &mask) == false);
+    assert(delivered_len == 1);
+    assert(recv_fragment(r, &last, 2, &sn, &mask) == false);
+    assert((delivered_len == 5) && (last == 5));
+    assert((delivered[1] == 2) && (delivered[2] == 3) && (delivered[3] == 4) && (delivered[4] == 5));
+
+    // Duplicates are dropped and acknowledged right away
+    r->_unacked = 0;
+    assert(recv_fragment(r, &last, 4, &sn, &mask) == false);
+    assert(recv_fragment(r, &last, 7, &sn, &mask) == false);
+    assert(delivered_len == 5);
+    assert(r->_unacked == (size_t)_Z_RELIABILITY_ACK_THRESHOLD);
+
+    // The missing fragments are given up once a fragment does not fit in the buffer
+    _z_zint_t far = 6 + Z_RELIABILITY_REORDER_SIZE;
+    assert(recv_fragment(r, &last, far, &sn, &mask) == false);
+    assert((delivered_len == 9) && (last == far));
+    assert((delivered[5] == GAP) && (delivered[6] == 7) && (delivered[7] == GAP) && (delivered[8] == far));
+    assert(r->_len == 0);
+
+    // Missing fragments are reported up to a given SN
+    assert(_z_reliability_reorder_missing(r, SN_RES, last, last, &sn, &mask) == false);
+    assert(_z_reliability_reorder_missing(r, SN_RES, last, last + 3, &sn, &mask) == true);
+    assert((sn == last + 1) && (mask == 0x3));
+
+    // The SNs wrap around
+    last = SN_RES - 1;
+    delivered_len = 0;
+    assert(recv_fragment(r, &last, 1, &sn, &mask) == true);
+    assert((sn == SN_RES) && (mask == 0x1));
+    assert(recv_fragment(r, &last, SN_RES, &sn, &mask) == false);
+    assert(recv_fragment(r, &last, 0, &sn, &mask) == false);
+    assert((delivered_len == 3) && (delivered[0] == SN_RES) && (delivered[1] == 0) && (delivered[2] == 1));
+
+    _z_reliability_reorders_free(&r, 1);
+    assert(r == NULL);
+}
+
+int main(void) {
+    window_test();
+    reorder_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif
@@ -0,0 +1,269 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/protocol/keyexpr.h"
+#include "zenoh-pico/session/resource.h"
+#include "zenoh-pico/session/subscription.h"
+#include "zenoh-pico/system/platform.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#define PEER 1
+
+static void session_init(_z_session_t *zn) {
+    (void)memset(zn, 0, sizeof(_z_session_t));
+    zn->_entity_id = 1;
+    zn->_resource_id = 1;
+    _z_resource_table_init(&zn->_local_resources);
+    _z_resource_table_init(&zn->_remote_resources);
+#if Z_FEATURE_SUBSCRIPTION == 1
+    zn->_local_subscriptions = NULL;
+    _z_keyexpr_index_init(&zn->_local_subscriptions_index);
+#endif
+#if Z_FEATURE_SUBSCRIPTION == 1 || Z_FEATURE_MATCHING == 1
+    zn->_remote_subscriptions = NULL;
+    _z_keyexpr_index_init(&zn->_remote_subscriptions_index);
+#endif
+#if Z_FEATURE_MULTI_THREAD == 1
+    assert(zp_mutex_init(&zn->_mutex_inner) == 0);
+#endif
+}
+
+static void session_clear(_z_session_t *zn) {
+    _z_flush_resources(zn);
+#if Z_FEATURE_SUBSCRIPTION == 1
+    _z_flush_subscriptions(zn);
+#endif
+#if Z_FEATURE_MULTI_THREAD == 1
+    zp_mutex_free(&zn->_mutex_inner);
+#endif
+}
+
+// A key expression declared or referred to by a peer
+static _z_keyexpr_t peer_key(uint16_t id, const char *suffix) {
+    _z_keyexpr_t key = _z_rid_with_suffix(id, suffix);
+    _z_keyexpr_set_mapping(&key, PEER);
+    return key;
+}
+
+static void declare(_z_session_t *zn, uint16_t id, uint16_t parent, const char *suffix) {
+    assert(_z_register_resource(zn, peer_key(parent, suffix), id, PEER) == (int16_t)id);
+}
+
+#if Z_FEATURE_SUBSCRIPTION == 1
+static char last_key[64];
+static size_t samples = 0;
+
+static void data_handler(const _z_sample_t *sample, void *arg) {
+    (void)(arg);
+    assert(strlen(sample->keyexpr._suffix) < sizeof(last_key));
+    (void)strcpy(last_key, sample->keyexpr._suffix);
+    samples++;
+}
+
+static _z_subscription_sptr_t *subscribe(_z_session_t *zn, const char *key) {
+    _z_subscription_t s;
+    (void)memset(&s, 0, sizeof(s));
+    s._id = _z_get_entity_id(zn);
+    s._key = _z_keyexpr_duplicate(_z_rname(key));
+    s._callback = data_handler;
+    _z_subscription_sptr_t *sub = _z_register_subscription(zn, _Z_RESOURCE_IS_LOCAL, &s);
+    assert(sub != NULL);
+    return sub;
+}
+
+// Triggers the subscriptions with a sample only referring to the resource id, returns the key it was received on
+static const char *trigger(_z_session_t *zn, uint16_t id) {
+    size_t before = samples;
+    int8_t ret = _z_trigger_subscriptions(zn, peer_key(id, NULL), _z_bytes_empty(), z_encoding_default(),
+                                          Z_SAMPLE_KIND_PUT, _z_timestamp_null(), NULL);
+    if ((ret != _Z_RES_OK) || (samples == before)) {
+        return NULL;
+    }
+    assert(samples == before + (size_t)1);
+    return last_key;
+}
+
+// The resolution cache never returns the key or the subscriptions of a stale declaration
+void cache_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+    _z_subscription_sptr_t *sub = subscribe(&zn, "test/**");
+
+    // The resolved keys are cached
+    declare(&zn, 1, Z_RESOURCE_ID_NONE, "test/a");
+    declare(&zn, 2, 1, "/x");
+    assert(strcmp(trigger(&zn, 1), "test/a") == 0);
+    assert(strcmp(trigger(&zn, 2), "test/a/x") == 0);
+    assert(_z_get_resource_by_id(&zn, PEER, 1)->_expanded.ptr != NULL);
+    assert(strcmp(trigger(&zn, 2), "test/a/x") == 0);
+
+    // Another declaration invalidates the cache
+    declare(&zn, 3, Z_RESOURCE_ID_NONE, "test/c");
+    assert(_z_get_resource_by_id(&zn, PEER, 1)->_expanded.ptr == NULL);
+
+    // An undeclared resource is no longer resolved
+    _z_unregister_resource(&zn, 2, PEER);
+    assert(trigger(&zn, 2) == NULL);
+    assert(strcmp(trigger(&zn, 1), "test/a") == 0);
+    _z_unregister_resource(&zn, 1, PEER);
+    assert(trigger(&zn, 1) == NULL);
+
+    // A redeclared resource is resolved to its new key, whether it was undeclared before or not
+    declare(&zn, 1, Z_RESOURCE_ID_NONE, "test/b");
+    assert(strcmp(trigger(&zn, 1), "test/b") == 0);
+    declare(&zn, 1, Z_RESOURCE_ID_NONE, "test/d");
+    assert(strcmp(trigger(&zn, 1), "test/d") == 0);
+
+    // A key cloned from the cache stays valid once the resource is undeclared
+    _z_keyexpr_sptr_t cached = _z_keyexpr_sptr_clone(&_z_get_resource_by_id(&zn, PEER, 1)->_expanded);
+    _z_unregister_resource(&zn, 1, PEER);
+    assert(strcmp(cached.ptr->_suffix, "test/d") == 0);
+    _z_keyexpr_sptr_drop(&cached);
+
+    // The cached subscriptions follow the subscriptions being registered and unregistered
+    assert(strcmp(trigger(&zn, 3), "test/c") == 0);
+    _z_unregister_subscription(&zn, _Z_RESOURCE_IS_LOCAL, sub);
+    assert(trigger(&zn, 3) == NULL);
+    sub = subscribe(&zn, "test/c");
+    assert(strcmp(trigger(&zn, 3), "test/c") == 0);
+
+    // The resources of a peer are dropped with their cache
+    _z_unregister_resources_for_peer(&zn, PEER);
+    assert(trigger(&zn, 3) == NULL);
+
+    session_clear(&zn);
+}
+#endif
+
+#define RESOURCES 100
+
+static uint16_t mapping_of(_z_session_t *zn, uint16_t mapping, uint16_t id) {
+    _z_resource_t *res = _z_get_resource_by_id(zn, mapping, id);
+    assert(res != NULL);
+    return _z_keyexpr_mapping_id(&res->_key);
+}
+
+// The resources are resolved by id and by key while the tables grow, and until they are unregistered
+void table_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+
+    char names[RESOURCES][32];
+    uint16_t ids[RESOURCES];
+    for (size_t i = 0; i < RESOURCES; i++) {
+        (void)snprintf(names[i], sizeof(names[i]), "test/table/%zu", i);
+        int16_t id = _z_register_resource(&zn, _z_rname(names[i]), Z_RESOURCE_ID_NONE, _Z_KEYEXPR_MAPPING_LOCAL);
+        assert(id != Z_RESOURCE_ID_NONE);
+        ids[i] = (uint16_t)id;
+    }
+    // The tables were rehashed several times, the load factor stays below 3/4
+    assert(zn._local_resources._len == (size_t)RESOURCES);
+    assert(zn._local_resources._capacity > (size_t)_Z_RESOURCE_TABLE_DEFAULT_CAPACITY * 4);
+    assert((zn._local_resources._len * 4) <= (zn._local_resources._capacity * 3));
+    for (size_t i = 0; i < RESOURCES; i++) {
+        _z_resource_t *res = _z_get_resource_by_id(&zn, _Z_KEYEXPR_MAPPING_LOCAL, ids[i]);
+        assert((res != NULL) && (res->_id == ids[i]) && (strcmp(res->_key._suffix, names[i]) == 0));
+        _z_keyexpr_t key = _z_rname(names[i]);
+        assert(_z_get_resource_by_key(&zn, &key) == res);
+    }
+    assert(_z_get_resource_by_id(&zn, PEER, ids[0]) == NULL);
+
+    // Unregistering removes the resource from both indexes, the others are still found
+    for (size_t i = 0; i < RESOURCES; i += 2) {
+        _z_unregister_resource(&zn, ids[i], _Z_KEYEXPR_MAPPING_LOCAL);
+    }
+    _z_unregister_resource(&zn, ids[0], _Z_KEYEXPR_MAPPING_LOCAL);  // An unknown id is ignored
+    assert(zn._local_resources._len == (size_t)RESOURCES / 2);
+    for (size_t i = 0; i < RESOURCES; i++) {
+        _z_keyexpr_t key = _z_rname(names[i]);
+        _z_resource_t *res = _z_get_resource_by_id(&zn, _Z_KEYEXPR_MAPPING_LOCAL, ids[i]);
+        assert((res == NULL) == ((i % 2) == 0));
+        assert(_z_get_resource_by_key(&zn, &key) == res);
+    }
+
+    session_clear(&zn);
+}
+
+// The same id declared by several peers lands in the same slot, the probing keeps them apart
+void collision_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+
+    for (uint16_t m = 1; m <= 4; m++) {
+        _z_keyexpr_t key = _z_rname((m % 2 == 0) ? "test/even" : "test/odd");
+        _z_keyexpr_set_mapping(&key, m);
+        assert(_z_register_resource(&zn, key, m, m) == (int16_t)m);
+    }
+    assert(_z_register_resource(&zn, peer_key(Z_RESOURCE_ID_NONE, "test/other"), 17, PEER) == 17);
+    for (uint16_t m = 1; m <= 4; m++) {
+        assert(mapping_of(&zn, m, m) == m);
+        assert(_z_get_resource_by_id(&zn, m, (m % 4) + 1) == NULL);
+        _z_keyexpr_t key = _z_rname((m % 2 == 0) ? "test/even" : "test/odd");
+        _z_keyexpr_set_mapping(&key, m);
+        assert(_z_get_resource_by_key(&zn, &key) == _z_get_resource_by_id(&zn, m, m));
+    }
+
+    // Removing from the middle of the cluster shifts the next entries back
+    _z_unregister_resource(&zn, 2, 2);
+    assert(_z_get_resource_by_id(&zn, 2, 2) == NULL);
+    assert((mapping_of(&zn, 1, 1) == 1) && (mapping_of(&zn, 3, 3) == 3) && (mapping_of(&zn, 4, 4) == 4));
+    assert(mapping_of(&zn, PEER, 17) == PEER);
+    _z_unregister_resources_for_peer(&zn, 3);
+    assert(_z_get_resource_by_id(&zn, 3, 3) == NULL);
+    assert((mapping_of(&zn, 1, 1) == 1) && (mapping_of(&zn, 4, 4) == 4) && (mapping_of(&zn, PEER, 17) == PEER));
+    assert(zn._remote_resources._len == (size_t)3);
+
+    session_clear(&zn);
+}
+
+// A resource references its parent until it is unregistered, a failed declaration does not
+void refcount_test(void) {
+    _z_session_t zn;
+    session_init(&zn);
+
+    declare(&zn, 1, Z_RESOURCE_ID_NONE, "test");
+    declare(&zn, 2, 1, "/a");
+    declare(&zn, 3, 1, "/b");
+    assert(_z_get_resource_by_id(&zn, PEER, 1)->_refcount == 3);
+
+    // The parent is unknown, and the redeclaration of the same key leaves the references untouched
+    assert(_z_register_resource(&zn, peer_key(9, "/c"), 4, PEER) == Z_RESOURCE_ID_NONE);
+    declare(&zn, 2, 1, "/a");
+    assert(_z_get_resource_by_id(&zn, PEER, 1)->_refcount == 3);
+
+    _z_unregister_resource(&zn, 2, PEER);
+    _z_unregister_resource(&zn, 3, PEER);
+    assert(_z_get_resource_by_id(&zn, PEER, 1)->_refcount == 1);
+    _z_unregister_resource(&zn, 1, PEER);
+    assert(zn._remote_resources._len == (size_t)0);
+
+    session_clear(&zn);
+}
+
+int main(void) {
+#if Z_FEATURE_SUBSCRIPTION == 1
+    cache_test();
+#endif
+    table_test();
+    collision_test();
+    refcount_test();
+    return 0;
+}
@@ -0,0 +1,280 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/transport/common/rx_pool.h"
+#include "zenoh-pico/utils/result.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#define CAPACITY 1024
+
+typedef struct {
+    _z_rx_pool_t *pool;
+    _z_rx_batch_t *batch;
+    _z_zbuf_t zbuf;
+} transport_t;
+
+static void transport_open(transport_t *t) {
+    assert(_z_rx_pool_open(&t->pool, &t->batch, &t->zbuf, CAPACITY) == _Z_RES_OK);
+    assert(_z_zbuf_capacity(&t->zbuf) == CAPACITY);
+}
+
+static void transport_close(transport_t *t) {
+    _z_rx_pool_close(&t->pool, &t->batch, &t->zbuf);
+    assert(t->pool == NULL);
+    assert(t->batch == NULL);
+}
+
+// Renews the batch and writes len bytes of value into it, as the transport would before decoding them
+static const uint8_t *transport_recv(transport_t *t, uint8_t value, size_t len) {
+    assert(_z_rx_pool_renew(t->pool, &t->batch, &t->zbuf) == _Z_RES_OK);
+    _z_zbuf_compact(&t->zbuf);
+    uint8_t *start = _z_zbuf_get_wptr(&t->zbuf);
+    memset(start, value, len);
+    _z_zbuf_set_wpos(&t->zbuf, _z_zbuf_get_wpos(&t->zbuf) + len);
+    _z_zbuf_set_rpos(&t->zbuf, _z_zbuf_get_rpos(&t->zbuf) + len);
+    return start;
+}
+
+static z_sample_t sample_in(transport_t *t, const uint8_t *start, size_t len) {
+    z_sample_t s;
+    memset(&s, 0, sizeof(s));
+    s.payload = _z_bytes_wrap(start, len);
+    s._batch = (t != NULL) ? t->batch : NULL;
+    return s;
+}
+
+static void check_payload(const z_owned_payload_t *payload, uint8_t value, size_t len) {
+    z_bytes_t b = z_payload_loan(payload);
+    assert(b.len == len);
+    for (size_t i = 0; i < len; i++) {
+        assert(b.start[i] == value);
+    }
+}
+
+void renew_test(void) {
+    transport_t t;
+    transport_open(&t);
+
+    // Without retained payload the transport keeps reading into the same batch
+    _z_rx_batch_t *first = t.batch;
+    (void)transport_recv(&t, 1, CAPACITY);
+    (void)transport_recv(&t, 2, CAPACITY);
+    assert(t.batch == first);
+
+    // The bytes yet to be read follow the transport into the next batch
+    _z_rx_batch_t *retained = _z_rx_batch_clone(t.batch);
+    _z_zbuf_set_rpos(&t.zbuf, 0);
+    _z_zbuf_set_wpos(&t.zbuf, 0);
+    memcpy(_z_zbuf_get_wptr(&t.zbuf), "abcdef", 6);
+    _z_zbuf_set_wpos(&t.zbuf, 6);
+    _z_zbuf_set_rpos(&t.zbuf, 2);
+    assert(_z_rx_pool_renew(t.pool, &t.batch, &t.zbuf) == _Z_RES_OK);
+    assert(t.batch != retained);
+    assert(_z_zbuf_len(&t.zbuf) == 4);
+    assert(memcmp(_z_zbuf_get_rptr(&t.zbuf), "cdef", 4) == 0);
+    assert(memcmp(retained->_buf, "abcdef", 6) == 0);
+
+    // Once released, the batch is free to be reused
+    _z_rx_batch_drop(&retained);
+    assert(retained == NULL);
+    retained = _z_rx_batch_clone(t.batch);
+    assert(_z_rx_pool_renew(t.pool, &t.batch, &t.zbuf) == _Z_RES_OK);
+    assert(t.batch == first);
+    _z_rx_batch_drop(&retained);
+
+    transport_close(&t);
+}
+
+void retain_test(void) {
+    transport_t t;
+    transport_open(&t);
+
+    // Large payloads are retained without copy
+    const uint8_t *start = transport_recv(&t, 0x11, Z_RX_POOL_RETAIN_MIN_SIZE);
+    z_sample_t s = sample_in(&t, start, Z_RX_POOL_RETAIN_MIN_SIZE);
+    z_owned_payload_t large = z_payload_null();
+    assert(z_sample_payload_retain(&s, &large) == _Z_RES_OK);
+    assert(z_payload_check(&large) == true);
+    assert(z_payload_loan(&large).start == start);
+
+    z_owned_payload_t clone = z_payload_clone(&large);
+    assert(z_payload_loan(&clone).start == start);
+
+    // Small payloads are copied, they do not pin the batch
+    _z_rx_batch_t *pinned = t.batch;
+    start = transport_recv(&t, 0x22, 16);
+    assert(t.batch != pinned);
+    s = sample_in(&t, start, 16);
+    z_owned_payload_t small = z_payload_null();
+    assert(z_sample_payload_retain(&s, &small) == _Z_RES_OK);
+    assert(z_payload_loan(&small).start != start);
+    assert(_z_rx_batch_is_retained(t.batch) == false);
+
+    // So are the payloads that do not lie in the batch, e.g. reassembled from fragments
+    uint8_t defrag[Z_RX_POOL_RETAIN_MIN_SIZE];
+    memset(defrag, 0x33, sizeof(defrag));
+    s = sample_in(&t, defrag, sizeof(defrag));
+    z_owned_payload_t copied = z_payload_null();
+    assert(z_sample_payload_retain(&s, &copied) == _Z_RES_OK);
+    assert(z_payload_loan(&copied).start != defrag);
+    s = sample_in(NULL, defrag, sizeof(defrag));
+    z_owned_payload_t local = z_payload_null();
+    assert(z_sample_payload_retain(&s, &local) == _Z_RES_OK);
+    memset(defrag, 0, sizeof(defrag));
+
+    // The retained payloads are not overwritten by the following batches
+    for (uint8_t i = 0; i < 16; i++) {
+        (void)transport_recv(&t, i, CAPACITY);
+    }
+    check_payload(&large, 0x11, Z_RX_POOL_RETAIN_MIN_SIZE);
+    check_payload(&small, 0x22, 16);
+    check_payload(&copied, 0x33, Z_RX_POOL_RETAIN_MIN_SIZE);
+    check_payload(&local, 0x33, Z_RX_POOL_RETAIN_MIN_SIZE);
+
+    z_payload_drop(z_payload_move(&large));
+    assert(z_payload_check(&large) == false);
+    z_payload_drop(z_payload_move(&large));  // Double drop is safe
+    assert(_z_rx_batch_is_retained(pinned) == false);
+    check_payload(&clone, 0x11, Z_RX_POOL_RETAIN_MIN_SIZE);
+    z_payload_drop(z_payload_move(&clone));
+    z_payload_drop(z_payload_move(&small));
+    z_payload_drop(z_payload_move(&copied));
+    z_payload_drop(z_payload_move(&local));
+
+    transport_close(&t);
+}
+
+void exhaustion_test(void) {
+    transport_t t;
+    transport_open(&t);
+
+    // Once all the batches of the pool are retained, batches are allocated on demand
+    z_owned_payload_t payloads[Z_RX_POOL_SIZE + 2];
+    for (size_t i = 0; i < (size_t)(Z_RX_POOL_SIZE + 2); i++) {
+        const uint8_t *start = transport_recv(&t, (uint8_t)i, CAPACITY);
+        z_sample_t s = sample_in(&t, start, CAPACITY);
+        assert(z_sample_payload_retain(&s, &payloads[i]) == _Z_RES_OK);
+        assert(payloads[i]._value->_batch != NULL);
+        assert(payloads[i]._value->_batch->_pool == ((i < (size_t)Z_RX_POOL_SIZE) ? t.pool : NULL));
+    }
+    (void)transport_recv(&t, 0xff, CAPACITY);
+    assert(t.batch->_pool == NULL);
+
+    // The pool stays valid once its transport is closed, until the last payload is dropped
+    transport_close(&t);
+    for (size_t i = 0; i < (size_t)(Z_RX_POOL_SIZE + 2); i++) {
+        check_payload(&payloads[i], (uint8_t)i, CAPACITY);
+        z_payload_drop(z_payload_move(&payloads[i]));
+    }
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+#define ROUNDS 20000
+#define IN_FLIGHT 8
+
+typedef struct {
+    z_owned_payload_t payloads[IN_FLIGHT];
+    uint8_t values[IN_FLIGHT];
+    size_t head;
+    size_t tail;
+    _Bool done;
+    zp_mutex_t mutex;
+    zp_condvar_t cv;
+} channel_t;
+
+static void *consumer(void *arg) {
+    channel_t *c = (channel_t *)arg;
+    _Bool running = true;
+    while (running == true) {
+        zp_mutex_lock(&c->mutex);
+        while ((c->head == c->tail) && (c->done == false)) {
+            zp_condvar_wait(&c->cv, &c->mutex);
+        }
+        _Bool available = c->head != c->tail;
+        z_owned_payload_t p = z_payload_null();
+        uint8_t value = 0;
+        if (available == true) {
+            p = c->payloads[c->tail % IN_FLIGHT];
+            value = c->values[c->tail % IN_FLIGHT];
+            c->tail = c->tail + 1;
+            zp_condvar_signal(&c->cv);
+        } else {
+            running = false;
+        }
+        zp_mutex_unlock(&c->mutex);
+
+        if (available == true) {
+            // The transport must not have written into the batch meanwhile
+            check_payload(&p, value, CAPACITY / 2);
+            z_payload_drop(z_payload_move(&p));
+        }
+    }
+    return NULL;
+}
+
+void concurrent_test(void) {
+    channel_t c;
+    memset(&c, 0, sizeof(c));
+    assert(zp_mutex_init(&c.mutex) == _Z_RES_OK);
+    assert(zp_condvar_init(&c.cv) == _Z_RES_OK);
+    zp_task_t task;
+    assert(zp_task_init(&task, NULL, consumer, &c) == 0);
+
+    transport_t t;
+    transport_open(&t);
+    for (size_t r = 0; r < ROUNDS; r++) {
+        const uint8_t *start = transport_recv(&t, (uint8_t)r, CAPACITY / 2);
+        z_sample_t s = sample_in(&t, start, CAPACITY / 2);
+        z_owned_payload_t p;
+        assert(z_sample_payload_retain(&s, &p) == _Z_RES_OK);
+
+        zp_mutex_lock(&c.mutex);
+        while ((c.head - c.tail) == IN_FLIGHT) {
+            zp_condvar_wait(&c.cv, &c.mutex);
+        }
+        c.payloads[c.head % IN_FLIGHT] = p;
+        c.values[c.head % IN_FLIGHT] = (uint8_t)r;
+        c.head = c.head + 1;
+        zp_condvar_signal(&c.cv);
+        zp_mutex_unlock(&c.mutex);
+    }
+    transport_close(&t);
+
+    zp_mutex_lock(&c.mutex);
+    c.done = true;
+    zp_condvar_signal(&c.cv);
+    zp_mutex_unlock(&c.mutex);
+    assert(zp_task_join(&task) == 0);
+    zp_condvar_free(&c.cv);
+    zp_mutex_free(&c.mutex);
+}
+#endif
+
+int main(void) {
+    renew_test();
+    retain_test();
+    exhaustion_test();
+#if Z_FEATURE_MULTI_THREAD == 1
+    concurrent_test();
+#endif
+    return 0;
+}
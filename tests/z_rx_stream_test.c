@@ -0,0 +1,195 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/protocol/definitions/core.h"
+#include "zenoh-pico/transport/common/rx_stream.h"
+#include "zenoh-pico/utils/result.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#define CAPACITY 64
+#define WIRE_SIZE 4096
+
+// The bytes sent on the fake stream link, delivered at most chunk bytes per read
+static uint8_t wire[WIRE_SIZE];
+static size_t wire_len = 0;
+static size_t wire_pos = 0;
+static size_t chunk = 0;
+
+static size_t fake_read(const _z_link_t *self, uint8_t *ptr, size_t len, _z_bytes_t *addr) {
+    (void)(self);
+    (void)(addr);
+    size_t n = wire_len - wire_pos;
+    n = (n < len) ? n : len;
+    n = (n < chunk) ? n : chunk;
+    (void)memcpy(ptr, &wire[wire_pos], n);
+    wire_pos += n;
+    return n;
+}
+
+static _z_link_t fake_link(void) {
+    _z_link_t l;
+    (void)memset(&l, 0, sizeof(l));
+    l._read_f = fake_read;
+    l._cap._flow = Z_LINK_CAP_FLOW_STREAM;
+    return l;
+}
+
+static void wire_reset(size_t c) {
+    wire_len = 0;
+    wire_pos = 0;
+    chunk = c;
+}
+
+static void wire_send(uint8_t value, size_t len) {
+    assert(wire_len + _Z_MSG_LEN_ENC_SIZE + len <= WIRE_SIZE);
+    for (uint8_t i = 0; i < _Z_MSG_LEN_ENC_SIZE; i++) {
+        wire[wire_len++] = (uint8_t)(len >> (i * 8));
+    }
+    (void)memset(&wire[wire_len], value, len);
+    wire_len += len;
+}
+
+// Receives until a whole batch is available and checks it, returns the number of reads it took
+static size_t recv_batch(_z_rx_stream_t *rxs, const _z_link_t *l, _z_zbuf_t *zbf, uint8_t value, size_t len) {
+    size_t reads = 0;
+    size_t n = 0;
+    int8_t ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
+    while (ret == _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES) {
+        assert(reads <= WIRE_SIZE);
+        ret = _z_rx_stream_recv(rxs, l, zbf, NULL, &n);
+        reads++;
+    }
+    assert(ret == _Z_RES_OK);
+    assert(n == len);
+    for (size_t i = 0; i < len; i++) {
+        assert(_z_zbuf_read(zbf) == value);
+    }
+    return reads;
+}
+
+void split_test(void) {
+    _z_link_t l = fake_link();
+    _z_zbuf_t zbf = _z_zbuf_make(CAPACITY);
+    _z_rx_stream_t rxs;
+    _z_rx_stream_reset(&rxs);
+
+    // Batches split at every byte, including their length prefix
+    for (size_t c = 1; c <= 8; c++) {
+        wire_reset(c);
+        for (uint8_t i = 0; i < 32; i++) {
+            wire_send(i, (size_t)i % 24);
+        }
+        for (uint8_t i = 0; i < 32; i++) {
+            (void)recv_batch(&rxs, &l, &zbf, i, (size_t)i % 24);
+        }
+        assert(wire_pos == wire_len);
+        assert(_z_zbuf_len(&zbf) == 0);
+    }
+
+    // Several batches received with a single read
+    wire_reset(WIRE_SIZE);
+    wire_send(1, 10);
+    wire_send(2, 20);
+    wire_send(3, 10);
+    assert(_z_rx_stream_ready(&rxs, &zbf) == false);
+    assert(recv_batch(&rxs, &l, &zbf, 1, 10) == 1);
+    assert(_z_rx_stream_ready(&rxs, &zbf) == true);
+    assert(recv_batch(&rxs, &l, &zbf, 2, 20) == 1);
+    assert(recv_batch(&rxs, &l, &zbf, 3, 10) == 1);
+    assert(_z_rx_stream_ready(&rxs, &zbf) == false);
+    assert(wire_pos == wire_len);
+
+    _z_zbuf_clear(&zbf);
+}
+
+void in_place_test(void) {
+    _z_link_t l = fake_link();
+    _z_zbuf_t zbf = _z_zbuf_make(CAPACITY);
+    _z_rx_stream_t rxs;
+    _z_rx_stream_reset(&rxs);
+    size_t n = 0;
+
+    // A partial batch completes where it started, its prefix is only parsed once
+    wire_reset(8);
+    wire_send(0xaa, 8);
+    wire_send(0xbb, 40);
+    (void)recv_batch(&rxs, &l, &zbf, 0xaa, 8);
+    assert(_z_rx_stream_recv(&rxs, &l, &zbf, NULL, &n) == _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES);
+    assert(rxs._has_len == true);
+    assert(_z_rx_stream_ready(&rxs, &zbf) == false);
+    size_t rpos = _z_zbuf_get_rpos(&zbf);
+    int8_t ret = _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES;
+    while (ret == _Z_ERR_TRANSPORT_NOT_ENOUGH_BYTES) {
+        ret = _z_rx_stream_recv(&rxs, &l, &zbf, NULL, &n);
+        assert(_z_zbuf_get_rpos(&zbf) == rpos);
+    }
+    assert(ret == _Z_RES_OK);
+    assert(n == 40);
+    assert(*_z_zbuf_get_rptr(&zbf) == 0xbb);
+    _z_zbuf_set_rpos(&zbf, rpos + n);
+
+    // Once everything has been read, the buffer starts over without moving any byte
+    wire_reset(WIRE_SIZE);
+    wire_send(0xcc, 4);
+    (void)recv_batch(&rxs, &l, &zbf, 0xcc, 4);
+    assert(_z_zbuf_get_rpos(&zbf) == (size_t)(_Z_MSG_LEN_ENC_SIZE + 4));
+
+    _z_zbuf_clear(&zbf);
+}
+
+void wrap_test(void) {
+    _z_link_t l = fake_link();
+    _z_zbuf_t zbf = _z_zbuf_make(CAPACITY);
+    _z_rx_stream_t rxs;
+    _z_rx_stream_reset(&rxs);
+    size_t n = 0;
+
+    // The partial batch reaching the end of the buffer is moved to its start
+    wire_reset(CAPACITY);
+    wire_send(1, 40);
+    wire_send(2, 30);
+    (void)recv_batch(&rxs, &l, &zbf, 1, 40);
+    assert(_z_zbuf_get_wpos(&zbf) == CAPACITY);
+    assert(_z_rx_stream_recv(&rxs, &l, &zbf, NULL, &n) == _Z_RES_OK);
+    assert(n == 30);
+    assert(_z_zbuf_get_rpos(&zbf) == 0);
+    for (size_t i = 0; i < n; i++) {
+        assert(_z_zbuf_read(&zbf) == 2);
+    }
+
+    // A batch as large as the buffer fits once its prefix is parsed, a larger one does not
+    wire_reset(7);
+    wire_send(3, 10);
+    wire_send(4, CAPACITY);
+    (void)recv_batch(&rxs, &l, &zbf, 3, 10);
+    (void)recv_batch(&rxs, &l, &zbf, 4, CAPACITY);
+    wire_reset(WIRE_SIZE);
+    wire_send(5, CAPACITY + 1);
+    assert(_z_rx_stream_recv(&rxs, &l, &zbf, NULL, &n) == _Z_ERR_TRANSPORT_NO_SPACE);
+
+    _z_zbuf_clear(&zbf);
+}
+
+int main(void) {
+    split_test();
+    in_place_test();
+    wrap_test();
+    return 0;
+}
@@ -0,0 +1,145 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#define SAMPLES 1000
+
+static void send(z_owned_closure_sample_t *closure, uint8_t i) {
+    z_sample_t sample;
+    (void)memset(&sample, 0, sizeof(z_sample_t));
+    sample.keyexpr = _z_rname("test/ring");
+    sample.payload = _z_bytes_wrap(&i, 1);
+    sample.kind = Z_SAMPLE_KIND_PUT;
+    z_call(*closure, &sample);
+}
+
+static uint8_t recv_value(z_owned_sample_ring_t *ring) {
+    z_owned_sample_t sample = z_sample_null();
+    assert(z_sample_ring_try_recv(ring, &sample) == 0);
+    assert(z_check(sample));
+    z_sample_t s = z_loan(sample);
+    assert(s.payload.len == 1);
+    assert(strcmp(s.keyexpr._suffix, "test/ring") == 0);
+    uint8_t v = s.payload.start[0];
+    z_drop(z_move(sample));
+    return v;
+}
+
+static void assert_empty(z_owned_sample_ring_t *ring) {
+    z_owned_sample_t sample = z_sample_null();
+    assert(z_sample_ring_try_recv(ring, &sample) == 0);
+    assert(!z_check(sample));
+}
+
+void policy_test(z_sample_ring_policy_t policy) {
+    z_owned_closure_sample_t closure;
+    z_owned_sample_ring_t ring;
+    z_sample_ring_options_t opt = z_sample_ring_options_default();
+    opt.capacity = 3;
+    opt.policy = policy;
+    assert(z_sample_ring_new(&closure, &ring, &opt) == 0);
+    assert(z_check(ring));
+
+    for (uint8_t i = 0; i < 5; i++) {
+        if ((policy == Z_SAMPLE_RING_POLICY_BLOCK) && (i == 3)) {
+            break;  // Would block the test
+        }
+        send(&closure, i);
+    }
+
+    uint8_t first = (policy == Z_SAMPLE_RING_POLICY_DROP_OLDEST) ? 2 : 0;
+    for (uint8_t i = first; i < first + 3; i++) {
+        assert(recv_value(&ring) == i);
+    }
+    assert_empty(&ring);
+
+    // Dropping the closure closes the ring once it is drained
+    send(&closure, 42);
+    z_drop(z_move(closure));
+    z_owned_sample_t sample = z_sample_null();
+    assert(z_sample_ring_recv(&ring, &sample) == 0);
+    assert(z_loan(sample).payload.start[0] == 42);
+    z_drop(z_move(sample));
+    assert(z_sample_ring_recv(&ring, &sample) < 0);
+    assert(z_sample_ring_try_recv(&ring, &sample) < 0);
+    assert(!z_check(sample));
+
+    z_drop(z_move(ring));
+    assert(!z_check(ring));
+}
+
+void drop_ring_first_test(void) {
+    z_owned_closure_sample_t closure;
+    z_owned_sample_ring_t ring;
+    assert(z_sample_ring_new(&closure, &ring, NULL) == 0);
+
+    send(&closure, 1);
+    z_drop(z_move(ring));
+    send(&closure, 2);  // Discarded, nobody receives anymore
+    z_drop(z_move(closure));
+}
+
+#if Z_FEATURE_MULTI_THREAD == 1
+static void *producer(void *arg) {
+    z_owned_closure_sample_t *closure = (z_owned_closure_sample_t *)arg;
+    for (size_t i = 0; i < SAMPLES; i++) {
+        send(closure, (uint8_t)i);
+    }
+    z_drop(closure);
+    return NULL;
+}
+
+void block_test(void) {
+    z_owned_closure_sample_t closure;
+    z_owned_sample_ring_t ring;
+    z_sample_ring_options_t opt = z_sample_ring_options_default();
+    opt.capacity = 4;
+    opt.policy = Z_SAMPLE_RING_POLICY_BLOCK;
+    assert(z_sample_ring_new(&closure, &ring, &opt) == 0);
+
+    zp_task_t task;
+    assert(zp_task_init(&task, NULL, producer, &closure) == 0);
+
+    // No sample is lost with the blocking policy
+    size_t n = 0;
+    z_owned_sample_t sample = z_sample_null();
+    while (z_sample_ring_recv(&ring, &sample) == 0) {
+        assert(z_loan(sample).payload.start[0] == (uint8_t)n);
+        z_drop(z_move(sample));
+        n++;
+    }
+    assert(n == SAMPLES);
+
+    assert(zp_task_join(&task) == 0);
+    z_drop(z_move(ring));
+}
+#endif
+
+int main(void) {
+    policy_test(Z_SAMPLE_RING_POLICY_DROP_OLDEST);
+    policy_test(Z_SAMPLE_RING_POLICY_DROP_NEWEST);
+    policy_test(Z_SAMPLE_RING_POLICY_BLOCK);
+    drop_ring_first_test();
+#if Z_FEATURE_MULTI_THREAD == 1
+    block_test();
+#endif
+    return 0;
+}
@@ -0,0 +1,174 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/net/session.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/transport/transport.h"
+#include "zenoh-pico/transport/unicast/lease.h"
+#include "zenoh-pico/transport/unicast/read.h"
+#include "zenoh-pico/transport/unicast/transport.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_STATS == 1 && Z_FEATURE_UNICAST_TRANSPORT == 1
+
+#define MTU 512
+#define DATAGRAMS 16
+
+// The link loops the datagrams written on it back to its reader
+static uint8_t datagrams[DATAGRAMS][MTU];
+static size_t lens[DATAGRAMS];
+static size_t head = 0;
+static size_t tail = 0;
+static size_t written_bytes = 0;
+
+static size_t write(const _z_link_t *self, const uint8_t *ptr, size_t len) {
+    (void)(self);
+    assert((len <= (size_t)MTU) && (tail - head < (size_t)DATAGRAMS));
+    (void)memcpy(datagrams[tail % DATAGRAMS], ptr, len);
+    lens[tail % DATAGRAMS] = len;
+    tail++;
+    written_bytes += len;
+    return len;
+}
+
+static size_t read(const _z_link_t *self, uint8_t *ptr, size_t len, _z_bytes_t *addr) {
+    (void)(self);
+    (void)(addr);
+    assert((head < tail) && (lens[head % DATAGRAMS] <= len));
+    size_t rb = lens[head % DATAGRAMS];
+    (void)memcpy(ptr, datagrams[head % DATAGRAMS], rb);
+    head++;
+    return rb;
+}
+
+static void close_link(_z_link_t *self) { (void)(self); }
+static void free_link(_z_link_t *self) { (void)(self); }
+
+static void make_session(_z_session_t *zn) {
+    _z_link_t zl;
+    (void)memset(&zl, 0, sizeof(zl));
+    zl._write_f = write;
+    zl._read_f = read;
+    zl._close_f = close_link;
+    zl._free_f = free_link;
+    zl._mtu = MTU;
+    zl._cap._transport = Z_LINK_CAP_TRANSPORT_UNICAST;
+    zl._cap._flow = Z_LINK_CAP_FLOW_DATAGRAM;
+
+    // The initial SNs let the transport receive its own frames
+    _z_transport_unicast_establish_param_t param;
+    (void)memset(&param, 0, sizeof(param));
+    param._seq_num_res = Z_SN_RESOLUTION;
+    param._batch_size = MTU;
+
+    (void)memset(zn, 0, sizeof(_z_session_t));
+    assert(_z_unicast_transport_create(&zn->_tp, &zl, &param) == _Z_RES_OK);
+    _z_id_t zid = _z_id_empty();
+    assert(_z_session_init(zn, &zid) == _Z_RES_OK);
+}
+
+static void send(_z_session_t *zn, size_t payload_len, z_congestion_control_t cong_ctrl) {
+    static uint8_t payload[4 * MTU];
+    _z_keyexpr_t key = _z_rid_with_suffix(Z_RESOURCE_ID_NONE, "test/stats");
+    _z_push_body_t body = _z_push_body_null();
+    body._is_put = true;
+    body._body._put._payload = _z_bytes_wrap(payload, payload_len);
+    _z_network_message_t push = _z_n_msg_make_push(&key, &body);
+    assert(_z_send_n_msg(zn, &push, Z_RELIABILITY_RELIABLE, cong_ctrl) == _Z_RES_OK);
+#if Z_FEATURE_BATCHING == 1
+    (void)_zp_flush(zn);
+#endif
+    _z_n_msg_clear(&push);
+}
+
+static void receive_all(_z_session_t *zn) {
+    while (head < tail) {
+        assert(_zp_unicast_read(&zn->_tp._transport._unicast) == _Z_RES_OK);
+    }
+}
+
+static zp_stats_t get_stats(_z_session_t *zn) {
+    zp_stats_t stats;
+    assert(zp_stats_get((z_session_t){._val = zn}, &stats) == _Z_RES_OK);
+    return stats;
+}
+
+void stats_test(void) {
+    _z_session_t zn;
+    make_session(&zn);
+    zp_stats_t stats = get_stats(&zn);
+    assert((stats.tx_n_msgs == 0) && (stats.rx_n_msgs == 0) && (stats.rx_pushes == 0));
+
+    // A message sent in a single frame
+    send(&zn, 8, Z_CONGESTION_CONTROL_BLOCK);
+    stats = get_stats(&zn);
+    assert((stats.tx_n_msgs == 1) && (stats.tx_batches == 1) && (stats.tx_fragments == 0));
+    assert(stats.tx_bytes == written_bytes);
+    receive_all(&zn);
+    stats = get_stats(&zn);
+    assert((stats.rx_n_msgs == 1) && (stats.rx_batches == 1) && (stats.rx_bytes == written_bytes));
+    assert((stats.rx_pushes == 1) && (stats.rx_errors == 0));
+
+    // A message larger than the batches is sent in fragments
+    send(&zn, 3 * MTU, Z_CONGESTION_CONTROL_BLOCK);
+    stats = get_stats(&zn);
+    assert((stats.tx_n_msgs == 2) && (stats.tx_fragments == 4) && (stats.tx_batches == 5));
+    assert(stats.tx_bytes == written_bytes);
+    receive_all(&zn);
+    stats = get_stats(&zn);
+    assert((stats.rx_n_msgs == 2) && (stats.rx_fragments == 4) && (stats.rx_batches == 5));
+    assert((stats.rx_pushes == 2) && (stats.rx_reassembly_drops == 0));
+
+    // The keep alives
+    assert(_zp_unicast_send_keep_alive(&zn._tp._transport._unicast) == _Z_RES_OK);
+    receive_all(&zn);
+    stats = get_stats(&zn);
+    assert((stats.tx_keep_alives == 1) && (stats.rx_keep_alives == 1) && (stats.tx_batches == 6));
+    assert((stats.tx_bytes == written_bytes) && (stats.rx_bytes == written_bytes));
+
+    // A frame with the SN of the last frame received is dropped
+    _z_transport_unicast_t *ztu = &zn._tp._transport._unicast;
+    ztu->_sn_tx_sns._val._plain._reliable = ztu->_sn_rx_sns._val._plain._reliable;
+    send(&zn, 8, Z_CONGESTION_CONTROL_BLOCK);
+    receive_all(&zn);
+    stats = get_stats(&zn);
+    assert((stats.rx_out_of_order_drops == 1) && (stats.rx_n_msgs == 2) && (stats.rx_pushes == 2));
+
+#if Z_FEATURE_MULTI_THREAD == 1
+    // A droppable message is dropped while its lane is busy
+    zp_mutex_lock(&ztu->_mutex_lanes[0]);
+    send(&zn, 8, Z_CONGESTION_CONTROL_DROP);
+    zp_mutex_unlock(&ztu->_mutex_lanes[0]);
+    stats = get_stats(&zn);
+    assert((stats.tx_congestion_drops == 1) && (stats.tx_n_msgs == 3));
+#endif
+
+    _z_session_clear(&zn);
+}
+
+int main(void) {
+    stats_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif
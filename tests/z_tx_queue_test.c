@@ -0,0 +1,402 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/api/primitives.h"
+#include "zenoh-pico/net/session.h"
+#include "zenoh-pico/protocol/codec/network.h"
+#include "zenoh-pico/protocol/codec/transport.h"
+#include "zenoh-pico/protocol/iobuf.h"
+#include "zenoh-pico/session/utils.h"
+#include "zenoh-pico/system/platform.h"
+#include "zenoh-pico/transport/common/tx_queue.h"
+#include "zenoh-pico/transport/unicast/transport.h"
+#include "zenoh-pico/transport/unicast/tx.h"
+#include "zenoh-pico/utils/result.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#if Z_FEATURE_MULTI_THREAD == 1
+
+#define PAYLOAD_MAX 16384
+
+static uint8_t payload[PAYLOAD_MAX];
+
+static int8_t push(_z_tx_queue_t *q, size_t len, z_congestion_control_t cong_ctrl) {
+    _z_network_message_t msg;
+    msg = (_z_network_message_t){
+        ._tag = _Z_N_PUSH,
+        ._body._push =
+            {
+                ._key = _z_rname("test/tx"),
+                ._qos = _Z_N_QOS_DEFAULT,
+                ._timestamp = _z_timestamp_null(),
+                ._body._is_put = true,
+                ._body._body._put =
+                    {
+                        ._commons = {._timestamp = _z_timestamp_null(), ._source_info = _z_source_info_null()},
+                        ._payload = _z_bytes_wrap(payload, len),
+                        ._encoding = z_encoding_default(),
+                    },
+            },
+    };
+    return _z_tx_queue_push(q, &msg, Z_RELIABILITY_RELIABLE, 0, cong_ctrl);
+}
+
+static size_t pull(_z_tx_queue_t *q) {
+    _z_tx_entry_t *e = _z_tx_queue_pull(q);
+    assert(e != NULL);
+
+    // The queued message owns a copy of the payload
+    _z_zbuf_t zbf = _z_zbytes_as_zbuf(_z_bytes_wrap(e->_buf, e->_len));
+    _z_network_message_t msg;
+    assert(_z_network_message_decode(&msg, &zbf) == _Z_RES_OK);
+    assert(msg._tag == _Z_N_PUSH);
+    size_t len = msg._body._push._body._body._put._payload.len;
+    assert(memcmp(msg._body._push._body._body._put._payload.start, payload, len) == 0);
+    _z_n_msg_clear(&msg);
+
+    _z_tx_entry_free(&e);
+    return len;
+}
+
+static size_t queued_bytes(_z_tx_queue_t *q) { return _z_atomic_load_explicit(&q->_bytes, _z_memory_order_relaxed); }
+
+void closed_test(void) {
+    _z_tx_queue_t q;
+    _z_tx_queue_null(&q);
+    assert(_z_tx_queue_is_closed(&q) == true);
+    assert(push(&q, 8, Z_CONGESTION_CONTROL_BLOCK) == _Z_ERR_CONNECTION_CLOSED);
+
+    assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+    assert(push(&q, 8, Z_CONGESTION_CONTROL_BLOCK) == _Z_RES_OK);
+    _z_tx_queue_close(&q);
+    assert(push(&q, 8, Z_CONGESTION_CONTROL_BLOCK) == _Z_ERR_CONNECTION_CLOSED);
+
+    // The messages queued before closing are still pulled, then the queue can be reopened
+    assert(pull(&q) == 8);
+    assert(_z_tx_queue_pull(&q) == NULL);
+    assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+    assert(push(&q, 8, Z_CONGESTION_CONTROL_BLOCK) == _Z_RES_OK);
+    _z_tx_queue_clear(&q);  // Frees the message left in the queue
+}
+
+void watermark_test(void) {
+    _z_tx_queue_t q;
+    _z_tx_queue_null(&q);
+    assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+
+    // Fill the queue up to the high watermark
+    size_t n = 0;
+    while (queued_bytes(&q) < (size_t)Z_TX_QUEUE_HIGH_WATERMARK) {
+        assert(push(&q, PAYLOAD_MAX, Z_CONGESTION_CONTROL_DROP) == _Z_RES_OK);
+        n++;
+    }
+    size_t bytes = queued_bytes(&q);
+
+    // Dropped messages are not an error
+    assert(push(&q, 8, Z_CONGESTION_CONTROL_DROP) == _Z_RES_OK);
+    assert(queued_bytes(&q) == bytes);
+
+    // The congestion lasts until the queue is drained down to the low watermark
+    while (queued_bytes(&q) > (size_t)Z_TX_QUEUE_LOW_WATERMARK) {
+        assert(push(&q, 8, Z_CONGESTION_CONTROL_DROP) == _Z_RES_OK);
+        assert(_z_tx_entry_mpsc_len(&q._entries) == n);
+        assert(pull(&q) == PAYLOAD_MAX);
+        n--;
+    }
+    assert(push(&q, 8, Z_CONGESTION_CONTROL_DROP) == _Z_RES_OK);
+    assert(_z_tx_entry_mpsc_len(&q._entries) == n + 1);
+
+    _z_tx_queue_clear(&q);
+}
+
+void slots_test(void) {
+    _z_tx_queue_t q;
+    _z_tx_queue_null(&q);
+    assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+
+    // Small messages congest the queue once all the slots are taken
+    size_t slots = _z_tx_entry_mpsc_capacity(&q._entries);
+    for (size_t i = 0; i < slots; i++) {
+        assert(push(&q, 1, Z_CONGESTION_CONTROL_DROP) == _Z_RES_OK);
+    }
+    assert(_z_tx_entry_mpsc_len(&q._entries) == slots);
+    assert(push(&q, 1, Z_CONGESTION_CONTROL_DROP) == _Z_RES_OK);
+    assert(_z_tx_entry_mpsc_len(&q._entries) == slots);
+
+    // Until half of them are free again
+    for (size_t i = 0; i < slots / 2; i++) {
+        assert(pull(&q) == 1);
+    }
+    assert(push(&q, 1, Z_CONGESTION_CONTROL_DROP) == _Z_RES_OK);
+    assert(_z_tx_entry_mpsc_len(&q._entries) == (slots / 2) + 1);
+
+    _z_tx_queue_clear(&q);
+}
+
+#define BLOCK_COUNT 64
+
+static void *block_producer(void *arg) {
+    _z_tx_queue_t *q = (_z_tx_queue_t *)arg;
+    for (size_t i = 0; i < BLOCK_COUNT; i++) {
+        assert(push(q, PAYLOAD_MAX, Z_CONGESTION_CONTROL_BLOCK) == _Z_RES_OK);
+    }
+    return NULL;
+}
+
+void block_test(void) {
+    _z_tx_queue_t q;
+    _z_tx_queue_null(&q);
+    assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+
+    zp_task_t tasks[2];
+    for (size_t i = 0; i < 2; i++) {
+        assert(zp_task_init(&tasks[i], NULL, block_producer, &q) == 0);
+    }
+
+    // The queue memory stays bounded, and no message is lost with the blocking congestion control
+    size_t n = 0;
+    while (n < (size_t)(2 * BLOCK_COUNT)) {
+        assert(queued_bytes(&q) < (size_t)Z_TX_QUEUE_HIGH_WATERMARK + (size_t)(2 * PAYLOAD_MAX));
+        if (_z_tx_entry_mpsc_is_empty(&q._entries) == true) {
+            _z_tx_queue_wait(&q);
+        } else {
+            _z_tx_entry_t *e = _z_tx_queue_pull(&q);
+            if (e != NULL) {
+                _z_tx_entry_free(&e);
+                n++;
+            }
+        }
+    }
+    for (size_t i = 0; i < 2; i++) {
+        assert(zp_task_join(&tasks[i]) == 0);
+    }
+    assert(queued_bytes(&q) == 0);
+
+    _z_tx_queue_clear(&q);
+}
+
+static void *close_producer(void *arg) {
+    _z_tx_queue_t *q = (_z_tx_queue_t *)arg;
+    int8_t ret = _Z_RES_OK;
+    while (ret == _Z_RES_OK) {
+        ret = push(q, PAYLOAD_MAX, Z_CONGESTION_CONTROL_BLOCK);
+    }
+    assert(ret == _Z_ERR_CONNECTION_CLOSED);
+    return NULL;
+}
+
+void close_blocked_test(void) {
+    _z_tx_queue_t q;
+    _z_tx_queue_null(&q);
+    assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+
+    // The blocked publisher is released when the queue is closed
+    zp_task_t task;
+    assert(zp_task_init(&task, NULL, close_producer, &q) == 0);
+    while (_z_atomic_load_explicit(&q._congested, _z_memory_order_acquire) == false) {
+        zp_sleep_ms(1);
+    }
+    _z_tx_queue_close(&q);
+    assert(zp_task_join(&task) == 0);
+
+    _z_tx_queue_clear(&q);
+}
+
+#define STOP_ROUNDS 64
+#define STOP_PRODUCERS 4
+
+static _z_atomic(size_t) accepted;
+static size_t pulled = 0;
+
+static void *stop_producer(void *arg) {
+    _z_tx_queue_t *q = (_z_tx_queue_t *)arg;
+    int8_t ret = _Z_RES_OK;
+    while (ret == _Z_RES_OK) {
+        ret = push(q, 8, Z_CONGESTION_CONTROL_BLOCK);
+        if (ret == _Z_RES_OK) {
+            _z_atomic_fetch_add_explicit(&accepted, (size_t)1, _z_memory_order_relaxed);
+        }
+    }
+    assert(ret == _Z_ERR_CONNECTION_CLOSED);
+    return NULL;
+}
+
+static void *stop_consumer(void *arg) {
+    _z_tx_queue_t *q = (_z_tx_queue_t *)arg;
+    _Bool running = true;
+    while (running == true) {
+        _z_tx_entry_t *e = _z_tx_queue_pull(q);
+        if (e != NULL) {
+            _z_tx_entry_free(&e);
+            pulled++;
+        } else if (_z_tx_queue_is_done(q) == true) {
+            running = false;
+        } else {
+            _z_tx_queue_wait(q);
+        }
+    }
+    return NULL;
+}
+
+void stop_test(void) {
+    _z_tx_queue_t q;
+    _z_tx_queue_null(&q);
+
+    // A publisher that passed the check of the closing is waited for, even once the queue is empty
+    assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+    _z_atomic_fetch_add_explicit(&q._pushing, (size_t)1, _z_memory_order_seq_cst);
+    _z_tx_queue_close(&q);
+    assert(_z_tx_queue_is_done(&q) == false);
+    _z_atomic_fetch_sub_explicit(&q._pushing, (size_t)1, _z_memory_order_seq_cst);
+    assert(_z_tx_queue_is_done(&q) == true);
+
+    // Every message accepted by the queue is pulled before the consumer stops, even when pushed while closing
+    for (size_t round = 0; round < STOP_ROUNDS; round++) {
+        assert(_z_tx_queue_open(&q) == _Z_RES_OK);
+        _z_atomic_store_explicit(&accepted, (size_t)0, _z_memory_order_relaxed);
+        pulled = 0;
+        zp_task_t consumer;
+        assert(zp_task_init(&consumer, NULL, stop_consumer, &q) == 0);
+        zp_task_t producers[STOP_PRODUCERS];
+        for (size_t i = 0; i < STOP_PRODUCERS; i++) {
+            assert(zp_task_init(&producers[i], NULL, stop_producer, &q) == 0);
+        }
+
+        zp_sleep_us(round * 10);
+        _z_tx_queue_close(&q);
+        assert(zp_task_join(&consumer) == 0);
+        for (size_t i = 0; i < STOP_PRODUCERS; i++) {
+            assert(zp_task_join(&producers[i]) == 0);
+        }
+
+        assert(pulled == _z_atomic_load_explicit(&accepted, _z_memory_order_relaxed));
+        assert(_z_tx_entry_mpsc_is_empty(&q._entries) == true);
+    }
+
+    _z_tx_queue_clear(&q);
+}
+
+#if Z_FEATURE_UNICAST_TRANSPORT == 1
+#define LINK_MTU 1024
+
+// The link counts the messages in the frames written on it, the writes are serialized by the transport
+static size_t written = 0;
+
+static size_t count_write(const _z_link_t *self, const uint8_t *ptr, size_t len) {
+    (void)(self);
+    _z_zbuf_t zbf = _z_zbytes_as_zbuf(_z_bytes_wrap(ptr, len));
+    _z_transport_message_t t_msg;
+    assert(_z_transport_message_decode(&t_msg, &zbf) == _Z_RES_OK);
+    assert(_Z_MID(t_msg._header) == _Z_MID_T_FRAME);
+    written = written + _z_network_message_vec_len(&t_msg._body._frame._messages);
+    _z_t_msg_clear(&t_msg);
+    return len;
+}
+
+static void noop_link(_z_link_t *self) { (void)(self); }
+
+static _z_atomic(_Bool) sending;
+
+static void *send_producer(void *arg) {
+    _z_transport_unicast_t *ztu = (_z_transport_unicast_t *)arg;
+    _z_keyexpr_t key = _z_rid_with_suffix(Z_RESOURCE_ID_NONE, "test/tx");
+    _z_push_body_t body = _z_push_body_null();
+    body._is_put = true;
+    body._body._put._payload = _z_bytes_wrap(payload, 8);
+    _z_network_message_t msg = _z_n_msg_make_push(&key, &body);
+    while (_z_atomic_load_explicit(&sending, _z_memory_order_relaxed) == true) {
+        assert(_z_unicast_send_n_msg(ztu, &msg, Z_RELIABILITY_RELIABLE, Z_CONGESTION_CONTROL_BLOCK) == _Z_RES_OK);
+        _z_atomic_fetch_add_explicit(&accepted, (size_t)1, _z_memory_order_relaxed);
+    }
+    _z_n_msg_clear(&msg);
+    return NULL;
+}
+
+void transport_stop_test(void) {
+    _z_link_t zl;
+    (void)memset(&zl, 0, sizeof(zl));
+    zl._write_f = count_write;
+    zl._close_f = noop_link;
+    zl._free_f = noop_link;
+    zl._mtu = LINK_MTU;
+    zl._cap._transport = Z_LINK_CAP_TRANSPORT_UNICAST;
+    zl._cap._flow = Z_LINK_CAP_FLOW_DATAGRAM;
+
+    _z_transport_unicast_establish_param_t param;
+    (void)memset(&param, 0, sizeof(param));
+    param._seq_num_res = Z_SN_RESOLUTION;
+    param._batch_size = LINK_MTU;
+    param._lease = Z_TRANSPORT_LEASE;
+
+    _z_session_t zn;
+    (void)memset(&zn, 0, sizeof(zn));
+    assert(_z_unicast_transport_create(&zn._tp, &zl, &param) == _Z_RES_OK);
+    _z_id_t zid = _z_id_empty();
+    assert(_z_session_init(&zn, &zid) == _Z_RES_OK);
+    _z_transport_unicast_t *ztu = &zn._tp._transport._unicast;
+
+    // The messages sent while the TX task starts and stops all go out, either through the task or directly
+    _z_atomic_store_explicit(&accepted, (size_t)0, _z_memory_order_relaxed);
+    _z_atomic_store_explicit(&sending, true, _z_memory_order_relaxed);
+    zp_task_t producers[STOP_PRODUCERS];
+    for (size_t i = 0; i < STOP_PRODUCERS; i++) {
+        assert(zp_task_init(&producers[i], NULL, send_producer, ztu) == 0);
+    }
+    for (size_t round = 0; round < STOP_ROUNDS; round++) {
+        zp_task_t *task = (zp_task_t *)zp_malloc(sizeof(zp_task_t));  // Freed once stopped
+        assert((task != NULL) && (_zp_unicast_start_tx_task(&zn._tp, NULL, task) == _Z_RES_OK));
+        zp_sleep_us(round * 10);
+        assert(_zp_unicast_stop_tx_task(&zn._tp) == _Z_RES_OK);
+        assert(_z_tx_entry_mpsc_is_empty(&ztu->_tx_queue._entries) == true);
+    }
+    _z_atomic_store_explicit(&sending, false, _z_memory_order_relaxed);
+    for (size_t i = 0; i < STOP_PRODUCERS; i++) {
+        assert(zp_task_join(&producers[i]) == 0);
+    }
+
+    assert(_z_unicast_flush(ztu) == _Z_RES_OK);
+    assert(written == _z_atomic_load_explicit(&accepted, _z_memory_order_relaxed));
+    _z_session_clear(&zn);
+}
+#endif  // Z_FEATURE_UNICAST_TRANSPORT == 1
+
+int main(void) {
+    for (size_t i = 0; i < PAYLOAD_MAX; i++) {
+        payload[i] = (uint8_t)i;
+    }
+
+    closed_test();
+    watermark_test();
+    slots_test();
+    block_test();
+    close_blocked_test();
+    stop_test();
+#if Z_FEATURE_UNICAST_TRANSPORT == 1
+    transport_stop_test();
+#endif  // Z_FEATURE_UNICAST_TRANSPORT == 1
+    return 0;
+}
+
+#else
+int main(void) {
+    printf("Missing config token to build this test. This test requires: Z_FEATURE_MULTI_THREAD\n");
+    return 0;
+}
+#endif
@@ -0,0 +1,143 @@
+//
+// Copyright (c) 2022 ZettaScale Technology
+//
+// This program and the accompanying materials are made available under the
+// terms of the Eclipse Public License 2.0 which is available at
+// http://www.eclipse.org/legal/epl-2.0, or the Apache License, Version 2.0
+// which is available at https://www.apache.org/licenses/LICENSE-2.0.
+//
+// SPDX-License-Identifier: EPL-2.0 OR Apache-2.0
+//
+// Contributors:
+//   ZettaScale Zenoh Team, <zenoh@zettascale.tech>
+//
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#include "zenoh-pico/link/link.h"
+
+#undef NDEBUG
+#include <assert.h>
+
+#ifdef _Z_SYS_NET_BATCH_MAX
+
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#define SLOT 64
+
+// Binds a socket to an ephemeral port of the loopback interface, its port is written in port
+static _z_sys_net_socket_t open_socket(char *port, size_t len) {
+    _z_sys_net_socket_t sock = {._fd = socket(AF_INET, SOCK_DGRAM, 0)};
+    assert(sock._fd >= 0);
+    struct sockaddr_in addr;
+    (void)memset(&addr, 0, sizeof(addr));
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    assert(bind(sock._fd, (struct sockaddr *)&addr, sizeof(addr)) == 0);
+    socklen_t addrlen = sizeof(addr);
+    assert(getsockname(sock._fd, (struct sockaddr *)&addr, &addrlen) == 0);
+    (void)snprintf(port, len, "%u", (unsigned int)ntohs(addr.sin_port));
+    return sock;
+}
+
+void unicast_test(void) {
+    char tx_port[8];
+    char rx_port[8];
+    _z_sys_net_socket_t tx = open_socket(tx_port, sizeof(tx_port));
+    _z_sys_net_socket_t rx = open_socket(rx_port, sizeof(rx_port));
+    _z_sys_net_endpoint_t rep;
+    assert(_z_create_endpoint_udp(&rep, "127.0.0.1", rx_port) == _Z_RES_OK);
+
+    uint8_t data[SLOT * 2];
+    for (size_t i = 0; i < sizeof(data); i++) {
+        data[i] = (uint8_t)i;
+    }
+    uint8_t slots[_Z_SYS_NET_BATCH_MAX * SLOT];
+    size_t lens[_Z_SYS_NET_BATCH_MAX];
+
+    // The datagrams sent in a single write are received in a single read, one per slot
+    _z_bytes_t bufs[3] = {_z_bytes_wrap(data, 10), _z_bytes_wrap(data, 20), _z_bytes_wrap(data, SLOT)};
+    assert(_z_send_batch_udp_unicast(tx, bufs, 3, rep) == 3);
+    assert(_z_read_batch_udp_unicast(rx, slots, SLOT, _Z_SYS_NET_BATCH_MAX, lens) == 3);
+    for (size_t i = 0; i < 3; i++) {
+        assert(lens[i] == bufs[i].len);
+        assert(memcmp(&slots[i * SLOT], data, lens[i]) == 0);
+    }
+
+    // A datagram larger than a slot is dropped, without affecting the next ones
+    bufs[0] = _z_bytes_wrap(data, SLOT + 1);
+    bufs[1] = _z_bytes_wrap(data, 5);
+    assert(_z_send_batch_udp_unicast(tx, bufs, 2, rep) == 2);
+    assert(_z_read_batch_udp_unicast(rx, slots, SLOT, _Z_SYS_NET_BATCH_MAX, lens) == 2);
+    assert(lens[0] == 0);
+    assert(lens[1] == 5);
+
+    // More datagrams than slots are left for the next read
+    for (size_t i = 0; i < 3; i++) {
+        bufs[i] = _z_bytes_wrap(data, i + 1);
+    }
+    assert(_z_send_batch_udp_unicast(tx, bufs, 3, rep) == 3);
+    assert(_z_read_batch_udp_unicast(rx, slots, SLOT, 2, lens) == 2);
+    assert(_z_read_batch_udp_unicast(rx, slots, SLOT, 2, lens) == 1);
+    assert(lens[0] == 3);
+
+    _z_free_endpoint_udp(&rep);
+    close(tx._fd);
+    close(rx._fd);
+}
+
+void multicast_test(void) {
+    char self_port[8];
+    char peer_port[8];
+    char rx_port[8];
+    _z_sys_net_socket_t self = open_socket(self_port, sizeof(self_port));
+    _z_sys_net_socket_t peer = open_socket(peer_port, sizeof(peer_port));
+    _z_sys_net_socket_t rx = open_socket(rx_port, sizeof(rx_port));
+    _z_sys_net_endpoint_t rep;
+    assert(_z_create_endpoint_udp(&rep, "127.0.0.1", rx_port) == _Z_RES_OK);
+    _z_sys_net_endpoint_t lep;
+    assert(_z_create_endpoint_udp(&lep, "127.0.0.1", self_port) == _Z_RES_OK);
+
+    uint8_t data[8] = {0};
+    uint8_t slots[_Z_SYS_NET_BATCH_MAX * SLOT];
+    size_t lens[_Z_SYS_NET_BATCH_MAX];
+    _z_bytes_t addrs[_Z_SYS_NET_BATCH_MAX];
+
+    // Our own datagrams are dropped, the address of the other senders is reported
+    _z_bytes_t bufs[2] = {_z_bytes_wrap(data, 4), _z_bytes_wrap(data, 8)};
+    assert(_z_send_batch_udp_multicast(self, bufs, 2, rep) == 2);
+    assert(_z_send_batch_udp_multicast(peer, bufs, 1, rep) == 1);
+    assert(_z_read_batch_udp_multicast(rx, slots, SLOT, _Z_SYS_NET_BATCH_MAX, lens, lep, addrs) == 3);
+    assert(lens[0] == 0);
+    assert(lens[1] == 0);
+    assert(lens[2] == 4);
+    assert(addrs[0].len == 0);
+    assert(addrs[2].len == sizeof(in_addr_t) + sizeof(in_port_t));
+    in_port_t port;
+    (void)memcpy(&port, addrs[2].start + sizeof(in_addr_t), sizeof(in_port_t));
+    assert(ntohs(port) == (in_port_t)atoi(peer_port));
+    for (size_t i = 0; i < 3; i++) {
+        _z_bytes_clear(&addrs[i]);
+    }
+
+    _z_free_endpoint_udp(&rep);
+    _z_free_endpoint_udp(&lep);
+    close(self._fd);
+    close(peer._fd);
+    close(rx._fd);
+}
+
+int main(void) {
+    unicast_test();
+    multicast_test();
+    return 0;
+}
+
+#else
+int main(void) { return 0; }
+#endif